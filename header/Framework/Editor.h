@@ -5,6 +5,7 @@
 class Scene;
 class Model;
 class Texture;
+class ThreadPool;
 
 class Editor
 {
@@ -19,6 +20,8 @@ private:
 	void ImGuiStyleSettings();
 	void LoadModelFilePaths(std::string path, std::string originalPath);
 	void ModelSelectionWindow();
+	// 画面の (x, y) (0～1、左上が原点) を通るカメラからのレイで一番手前のモデルを選ぶ
+	void PickModel(float x, float y);
 	float deltaTime;
 	Scene* m_pScene = nullptr;
 	std::vector<std::string> m_ModelFilePaths;
@@ -27,4 +30,7 @@ private:
 	uint32_t m_CurrentModelId = 0;
 
 	Model* hierachySelectedModel = nullptr;
+	std::unique_ptr<ThreadPool> m_pThreadPool; // メッシュの BVH の構築用
+	float m_PickDistance = 0.0f;
+	double m_PickMilliseconds = 0.0;
 };
\ No newline at end of file
@@ -15,7 +15,7 @@ public:
 private:
 
 	/// <summary>
-	/// t[obt@
+	/// フレームバッファ数
 	/// </summary>
 	static const uint32_t FrameCount = 2;
 	
@@ -25,17 +25,17 @@ public:
 	template<typename T>
 	D3D12_GPU_VIRTUAL_ADDRESS AllocateConstantBuffer(const T& data, uint32_t frameIndex)
 	{
-		// RpCAT[g: T̃TCY256oCg𒴂ĂȂ`FbN
+		// コンパイル時アサート: Tのサイズが256バイトを超えていないかチェック
 		static_assert(sizeof(T) <= CBAlignment, "Constant Buffer size must be <= 256 bytes");
 
-		// obt@ӂ`FbN
+		// バッファあふれチェック
 		if (m_CurrentOffset + CBAlignment > m_pCBs[frameIndex]->GetDesc().SizeInBytes)
 		{
 			assert(false && "CB Heap Full!");
 			return 0;
 		}
 
-		// ݃|C^擾
+		// 書き込みポインタ取得
 		uint8_t* pHeap = static_cast<uint8_t*>(m_pCBs[frameIndex]->GetPtr());
 		uint8_t* pDest = pHeap + m_CurrentOffset;
 
@@ -43,7 +43,7 @@ public:
 
 		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = m_pCBs[frameIndex]->GetAddress() + m_CurrentOffset;
 
-		// ItZbgi߂
+		// オフセットを進める
 		m_CurrentOffset += CBAlignment;
 
 		return gpuAddress;
@@ -81,31 +81,31 @@ private:
 	std::unique_ptr<DX12DescriptorHeap> m_pCBV_SRV_UAV = nullptr;
 
 	/// <summary>
-	/// nbVlL[ɂďL(unique_ptr)Ǘ
+	/// ハッシュ値をキーにして所有権(unique_ptr)を管理
 	/// </summary>
 	std::unordered_map<TextureID, std::unique_ptr<Texture>> m_pTextures;
-	// ftHgeNX`
+	// デフォルトテクスチャ
 	std::unique_ptr<Texture> m_pMissingTextures;
 
 	/// <summary>
-	/// 萔obt@̍őAP[V (Xbg)
+	/// 定数バッファの最大アロケーション数 (スロット数)
 	/// </summary>
 	static const uint32_t m_MaxAllocations = 20000;
 	// <summary>
-	// CB256oCgACgK{
+	// CBは256バイトアライメント必須
 	// </summary>
 	static const uint32_t CBAlignment = 256;
 	// <summary>
-	// obt@Ŝ̃TCY (20,000 * 256byte = 5MB)
+	// バッファ全体のサイズ (20,000個 * 256byte = 約5MB)
 	// </summary>
 	static const uint32_t CBSize = m_MaxAllocations * CBAlignment;
 	// <summary>
-	// 萔obt@
+	// 定数バッファ
 	// </summary>
 	std::unique_ptr<ConstantBuffer> m_pCBs[Window::FrameCount];
 
 	// <summary>
-	// ݂̎gpʒu (oCgPʂ̃ItZbg)
+	// 現在の使用位置 (バイト単位のオフセット)
 	// </summary>
 	uint32_t m_CurrentOffset = 0;
 
@@ -113,7 +113,7 @@ private:
 	Vector3D m_OneVector3D = Vector3D(1.0f, 1.0f, 1.0f);
 	Vector3D m_ZeroVector3D = Vector3D(1.0f, 1.0f, 1.0f);
 
-	// V[֘A
+	// シーン関連
 	Scene* m_pScene = nullptr;
 	std::unique_ptr<FluidStage> m_pFluidStage = nullptr;
 
@@ -26,7 +26,7 @@ private:
 
 	Renderer* m_pRenderer = nullptr;
 
-	// J֌W
+	// カメラ関係
 	std::unique_ptr<Camera> m_pCamera = nullptr;
 	float m_CameraSpeed = 12.0f;
 	float m_CameraSpeedMultiplier = 6.0f;
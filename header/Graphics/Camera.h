@@ -9,7 +9,7 @@ public:
 	enum ProjectionMode
 	{
 		Perspective,
-		Photographic, //!< ˉe@
+		Photographic, //!< 正射影法
 	};
 
 	Camera(uint32_t width, uint32_t height);
@@ -43,22 +43,25 @@ public:
 	const float& GetNear() const { return m_Near; }
 	const float& GetFovY() const { return m_FovY; }
 	const float& GetAspect() const { return m_Aspect; }
+	const float& GetWidth() const { return m_Width; }
+	const float& GetHeight() const { return m_Height; }
+	ProjectionMode GetProjectionMode() const { return m_ProjMove; }
 	const Matrix4x4& GetView();
 	const Matrix4x4& GetProj();
 	const Matrix4x4& GetViewProj();
 	const Matrix4x4& GetViewInv();
 
 private:
-	Vector3D m_Position = Vector3D(0.0f, 5.0f, -10.0f); //!< Jʒu
-	Vector3D m_Target = Vector3D(0.0f, 0.0f, 0.0f); //!< J̒_
-	Vector3D m_Upward = Vector3D(0.0f, 1.0f, 0.0f); //!< J̏
-	Matrix4x4 m_View = Matrix4x4(); //!< r[s
-	Matrix4x4 m_ViewInv = Matrix4x4(); //!< r[s̋ts
-	Matrix4x4 m_Proj = Matrix4x4();//!< vWFNVs
-	Matrix4x4 m_cameraRotation = Matrix4x4(); //!< J̉]s
-	Vector3D m_Forward = Vector3D(0.0f, 0.0f, 1.0f); //!< J̑O
-	Vector3D m_Right = Vector3D(1.0f, 0.0f, 0.0f); //!< J̉E
-	float m_targetToPositionLen = 1.0f;	//_Ǝ_܂ŋ
+	Vector3D m_Position = Vector3D(0.0f, 5.0f, -10.0f); //!< カメラ位置
+	Vector3D m_Target = Vector3D(0.0f, 0.0f, 0.0f); //!< カメラの注視点
+	Vector3D m_Upward = Vector3D(0.0f, 1.0f, 0.0f); //!< カメラの上方向
+	Matrix4x4 m_View = Matrix4x4(); //!< ビュー行列
+	Matrix4x4 m_ViewInv = Matrix4x4(); //!< ビュー行列の逆行列
+	Matrix4x4 m_Proj = Matrix4x4();//!< プロジェクション行列
+	Matrix4x4 m_cameraRotation = Matrix4x4(); //!< カメラの回転行列
+	Vector3D m_Forward = Vector3D(0.0f, 0.0f, 1.0f); //!< カメラの前方方向
+	Vector3D m_Right = Vector3D(1.0f, 0.0f, 0.0f); //!< カメラの右方向
+	float m_targetToPositionLen = 1.0f;	//注視点と視点まで距離
 
 	float m_Near = 1.0f;
 	float m_Far = 10000.0f;
@@ -13,7 +13,7 @@ public:
 	D3D12_CONSTANT_BUFFER_VIEW_DESC GetDesc() const { return m_Desc; }
 	void CopyToVRAM(void* data);
 
-	//! @brief }bsOς݂̃|C^擾
+	//! @brief メモリマッピング済みのポインタを取得
 	template<typename T>
 	T* GetPtr()
 	{
@@ -22,9 +22,9 @@ public:
 
 private:
 	ComPtr<ID3D12Resource> m_pCB = nullptr;
-	uint32_t m_allocSize = 0;						//!< obt@̃TCY 256ɃACg
-	uint32_t m_size = 0;						//!< ACgÕTCY
-	D3D12_CONSTANT_BUFFER_VIEW_DESC m_Desc = {};	//!< 萔obt@r[̍\ݒ
-	void* m_pMappedPtr = nullptr;					//!< CPUANZX萔obt@̃AhX
+	uint32_t m_allocSize = 0;						//!< バッファのサイズ 256にアライメント
+	uint32_t m_size = 0;						//!< アライメント前のサイズ
+	D3D12_CONSTANT_BUFFER_VIEW_DESC m_Desc = {};	//!< 定数バッファビューの構成設定
+	void* m_pMappedPtr = nullptr;					//!< CPU側からアクセスする定数バッファのアドレス
 
 };
\ No newline at end of file
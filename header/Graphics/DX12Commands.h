@@ -25,32 +25,32 @@ private:
 	ID3D12Device* m_pDevice = nullptr;
 
 	/// <summary>
-	/// R}hAP[^
+	/// コマンドアロケータ
 	/// </summary>
-	std::vector<ComPtr<ID3D12CommandAllocator>> m_pCommandAllocators = { nullptr }; //!< R}hAP[^
+	std::vector<ComPtr<ID3D12CommandAllocator>> m_pCommandAllocators = { nullptr }; //!< コマンドアロケータ
 	/// <summary>
-	/// R}hXg
+	/// コマンドリスト
 	/// </summary>
 	ComPtr<ID3D12GraphicsCommandList> m_pCommandList;
 	/// <summary>
-	/// R}hL[
+	/// コマンドキュー
 	/// </summary>
 	ComPtr<ID3D12CommandQueue> m_pCommandQueue;
 	/// <summary>
-	/// tFX
+	/// フェンス
 	/// </summary>
 	ComPtr<ID3D12Fence> m_pFence;
 	/// <summary>
-	/// tFXCxg
+	/// フェンスイベント
 	/// </summary>
 	HANDLE m_FenceEvent;
 	/// <summary>
-	/// tFXJE^[
+	/// フェンスカウンター
 	/// </summary>
 	uint64_t m_FenceCounter = 0;
 
 	/// <summary>
-	/// AP[^̃CfbNX
+	/// アロケータのインデックス
 	/// </summary>
 	uint32_t m_AllocatorIndex = 0;
 };
\ No newline at end of file
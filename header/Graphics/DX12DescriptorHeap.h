@@ -12,7 +12,7 @@ public:
 		D3D12_DESCRIPTOR_HEAP_FLAGS flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE);
 
 	/// <summary>
-	/// Qb^[
+	/// ゲッター類
 	/// </summary>
 	ComPtr<ID3D12DescriptorHeap> GetHeap() { return m_pDescriptorHeap; }
 	ID3D12DescriptorHeap* GetHeapPtr() { return m_pDescriptorHeap.Get(); }
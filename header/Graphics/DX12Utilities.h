@@ -15,13 +15,13 @@ namespace DX12Utility
 {
     enum SamplerState
     {
-        PointWrap,          //!< |CgTvO - JԂ.
-        PointClamp,         //!< |CgTvO - Nv.
-        LinearWrap,         //!< gCjATvO - JԂ.
-        LinearClamp,        //!< gCjATvO - Nv.
-        AnisotropicWrap,    //!< ٕTvO - JԂ.
-        AnisotropicClamp,   //!< ٕTvO - Nv.
-		ShadowMapSampler,  //!< VhE}bvpTv[.
+        PointWrap,          //!< ポイントサンプリング - 繰り返し.
+        PointClamp,         //!< ポイントサンプリング - クランプ.
+        LinearWrap,         //!< トライリニアサンプリング - 繰り返し.
+        LinearClamp,        //!< トライリニアサンプリング - クランプ.
+        AnisotropicWrap,    //!< 異方性サンプリング - 繰り返し.
+        AnisotropicClamp,   //!< 異方性サンプリング - クランプ.
+		ShadowMapSampler,  //!< シャドウマップ用サンプラー.
     };
 
     class DX12Exception : public std::runtime_error
@@ -49,7 +49,7 @@ namespace DX12Utility
         }
     }
 
-    // 񂩂nbVl𐶐֐
+    // 文字列からハッシュ値を生成する関数
     inline constexpr TextureID StringHash(const wchar_t* str) {
         size_t hash = 14695981039346656037ULL; // FNV offset basis
         while (*str) {
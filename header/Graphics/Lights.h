@@ -18,7 +18,7 @@ struct alignas(256) ShadowLightData
 {
 	Matrix4x4 ViewProj; // 16 floats
 	Vector3D Direction; // 3 floats
-	float Padding;      // 1 float (v20 floats)
+	float Padding;      // 1 float (合計20 floats)
 };
 
 struct alignas(256) LightData
@@ -1,31 +1,37 @@
 #pragma once
 #include "pch.h"
-#include "Math/Vector2D.h"
-#include "Math/Vector3D.h"
+#include "Graphics/Vertex.h"
 #include "Graphics/DX12Utilities.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
-struct Vertex
-{
-	Vector3D m_Position; // _W
-	Vector3D m_Normal;    // @xNg
-	Vector2D m_TexCoord;    // UVW
-	Vector3D m_Tangent;    // ڐxNg
-};
-
 class Texture;
+class TriangleBVH;
+class ThreadPool;
 
 class Mesh
 {
 public:
 	Mesh(Renderer* pRenderer, const aiMesh* pSrcMesh);
+	/// <summary>
+	/// 頂点とインデックスから作成します (SurfaceExtractor で粒子から作った水面のメッシュなど)
+	/// </summary>
+	Mesh(Renderer* pRenderer, std::vector<Vertex> vertices, std::vector<uint32_t> indices, const std::string& name);
 	~Mesh();
 	D3D12_VERTEX_BUFFER_VIEW GetVBV() const { return m_VBV; }
 	D3D12_INDEX_BUFFER_VIEW GetIBV() const { return m_IBV; }
 	uint32_t GetIndexCount() const { return m_IndexCount; }
+	// CPU側に残している頂点とインデックス (SDF の焼き込みなど)
+	const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
+	const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+	/// <summary>
+	/// CPU側の頂点から三角形の BVH を作ります (ピッキングなどのレイ・最近点の問い合わせ用。頂点を変えた場合は呼び直す)
+	/// </summary>
+	const TriangleBVH& BuildBVH(ThreadPool& threadPool);
+	// BuildBVH の前は nullptr
+	const TriangleBVH* GetBVH() const { return m_pBVH.get(); }
 	uint32_t GetMaterialIndex() const { return m_MaterialIndex; }
 	void SetMaterialIndex(uint32_t index) { m_MaterialIndex = index; }
 	void SetDiffuseTex(Texture* pTexture) { m_pDiffuseTexture = pTexture; }
@@ -45,6 +51,7 @@ private:
 
 	std::vector<Vertex> m_Vertices;
 	std::vector<uint32_t> m_Indices;
+	std::unique_ptr<TriangleBVH> m_pBVH;
 	uint32_t m_MaterialIndex = -1;
 
 	Texture* m_pDiffuseTexture = nullptr;
@@ -53,7 +60,7 @@ private:
 	Texture* m_pShinessTexture = nullptr;
 	Texture* m_pSpecularTexture = nullptr;
 
-	// _ACfbNXf[^
+	// 頂点、インデックスデータ
 	ComPtr<ID3D12Resource> m_pVB = nullptr;
 	D3D12_VERTEX_BUFFER_VIEW m_VBV = {};
 
@@ -16,11 +16,11 @@ public:
 	virtual void RecordStage(ID3D12GraphicsCommandList* pCmdList, D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle);
 protected:
 	/// <summary>
-	/// [gVOl`
+	/// ルートシグネチャ
 	/// </summary>
 	std::unique_ptr<DX12RootSignature> m_pRootSignature = nullptr;
 	/// <summary>
-	/// pCvCXe[g
+	/// パイプラインステート
 	/// </summary>
 	std::unique_ptr<DX12PipelineState> m_pPSO = nullptr;
 
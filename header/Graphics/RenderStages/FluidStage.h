@@ -3,46 +3,46 @@
 #include "Graphics/RenderStage.h"
 #include "Graphics/DX12Utilities.h"
 #include "Math/Matrix4x4.h"
+#include "Simulation/SPHTypes.h"
+#include "Simulation/FluidScenario.h"
+#include "Simulation/Checkpoint.h"
+#include "Simulation/ParticleExporter.h"
+#include "Simulation/SignedDistanceField.h"
+#include "Simulation/BoundaryParticles.h"
+
+#include <random>
 
 class Scene;
 class Camera;
 class Renderer;
+class Model;
+class ThreadPool;
 
-struct Particle
+// 定数バッファ用構造体 (Vertex Shader用)
+struct alignas(256) ParticleTransform
 {
-	Vector3D Position;
-	float Density;
-	Vector3D Velocity;
-	float Pressure;
-	Vector3D Force;
-	float NearDensity;
+	Matrix4x4 World;
+	Matrix4x4 View;
+	Matrix4x4 Proj;
 };
 
-// 萔obt@p\ (Compute Shaderp)
-struct alignas(256) SimulationParam
+// SDFの障害物の構造化バッファ用構造体 (FluidSimCS.hlsl の SDFCollider と同じ並び)
+struct SDFColliderGPU
 {
-	float DeltaTime;
-	float Gravity;
-	float Stiffness;
-	float nearStiffness;
-	uint32_t ParticleCount;
-	Vector3D WallMin;
-	float RestDensity;
-	Vector3D WallMax;
-	float Viscosity;
-	float H;
-	float Mass;
-	float Padding0; // ACgp
-	Vector3D GridDim;
-	float Padding1; // ACgp
+	float InvWorld[4][4];    // モデルの World の逆行列 (行ベクトル)
+	Vector3D Origin;         // 格子点 (0, 0, 0) のローカル座標
+	float InvCellSize;
+	uint32_t Dim[3];
+	uint32_t ValueOffset;    // 値のバッファの中の先頭
+	float BandDistance;
+	float Padding[3];
 };
 
-// 萔obt@p\ (Vertex Shaderp)
-struct alignas(256) ParticleTransform
+// 境界粒子の構造化バッファ用構造体 (BoundaryParticles.hlsli の BoundaryParticle と同じ並び)
+struct BoundaryParticleGPU
 {
-	Matrix4x4 World;
-	Matrix4x4 View;
-	Matrix4x4 Proj;
+	Vector3D Position;
+	float Psi;
 };
 
 class FluidStage : public RenderStage
@@ -58,46 +58,157 @@ public:
 	void UpdateSimulation(float deltaTime);
 	void RunFluidSolver(ID3D12GraphicsCommandList* pCmdlist, DX12DescriptorHeap* CBVSRVUAVHeap);
 	void Update(float deltaTime);
+
+	/// <summary>
+	/// 粒子数を変更して初期配置し直します (バッファは容量が足りない場合のみ確保し直す)
+	/// </summary>
+	void SetParticleCount(uint32_t particleCount);
+	uint32_t GetParticleCount() const { return m_ParticleCount; }
+	/// <summary>
+	/// 粒子を末尾に追加します (エミッター用)
+	/// 容量が足りない場合は1.5倍ずつ拡張し、既存の粒子はGPU上で新しいバッファへコピーする
+	/// </summary>
+	void AddParticles(const std::vector<Particle>& particles);
+	/// <summary>
+	/// 指定したインデックスの粒子を削除し、末尾の粒子を移して詰めます (各パスは残った粒子だけを処理する)
+	/// </summary>
+	void RemoveParticles(std::vector<uint32_t> indices);
+
+	/// <summary>
+	/// 粒子バッファを読み戻して、パラメータと一緒にチェックポイントをバックグラウンドで書き込みます
+	/// (止めるのはGPUからのコピーの間だけ。CPUFluidSolver のチェックポイントと同じ形式)
+	/// </summary>
+	/// <returns>前の書き込みが終わっていない場合は false</returns>
+	bool SaveCheckpoint(const std::string& path);
+	/// <summary>
+	/// チェックポイントからパラメータと粒子を読み込みます (CPUFluidSolver で保存したファイルも読める。粒子はID順に詰める)
+	/// </summary>
+	/// <returns>開けない場合や、壁の範囲・H がバッファの想定 (MaxWallRange, MinCellSize) を超える場合は false</returns>
+	bool LoadCheckpoint(const std::string& path);
+
+	/// <summary>
+	/// モデルのメッシュから SDF を焼き込み (cache/sdf にモデルのファイルのハッシュで保存し、次回は読み込む)、障害物に加えます
+	/// 積分のパスで壁と同じペナルティで押し出す (境界粒子を使う場合は表面に並べた境界粒子で押し返す)。モデルの World は毎フレーム読むので、動かしても焼き直さない
+	/// </summary>
+	/// <returns>障害物が MaxColliders 個ある場合や、三角形のメッシュがない・焼き込みに失敗した場合は false</returns>
+	bool AddCollider(const Model* pModel);
+	void ClearColliders();
+	uint32_t GetColliderCount() const { return static_cast<uint32_t>(m_Colliders.size()); }
 private:
 	void CreateBuffers();
+	void CreateParticleBuffers(uint32_t capacity);
+	void EnsureParticleCapacity(uint32_t particleCount, bool keepParticles);
+	void UploadParticles(const std::vector<Particle>& particles, uint32_t firstIndex);
+	// 先頭から particleCount 個の粒子をGPUから読み戻す
+	void ReadbackParticles(Particle* pDst, uint32_t particleCount);
+	// リードバックバッファを bufferSize 以上にする (足りない場合のみ作り直す)
+	void EnsureReadbackBuffer(ComPtr<ID3D12Resource>& pBuffer, uint32_t& currentSize, uint32_t bufferSize);
+	// 粒子バッファからエクスポート用のリードバックバッファへのコピーを pCmdList に積む (シミュレーションのコマンドの後に呼ぶ)
+	void RecordExportCopy(ID3D12GraphicsCommandList* pCmdList);
+	// 前のフレームで積んだコピーが終わっていれば、読み戻した粒子をエクスポーターに渡す
+	void SubmitExportFrame();
+	// すべての障害物の SDF の値を1つのバッファに詰めてGPUへ送る
+	void UploadColliderValues();
+	// 今のフレームの障害物のテーブルをモデルの World から書き込む
+	void UpdateColliderTable();
+	// 障害物のバッファをルート引数に設定する (RunFluidSolver / RunFluidSolverGrid の共通設定の後に呼ぶ)
+	void BindColliders(ID3D12GraphicsCommandList* pCmdlist);
+	// pData をデフォルトヒープのバッファに作り直してコピーする (作り直す時だけ使うので、コピーの完了を待つ)
+	void UploadStaticBuffer(ComPtr<ID3D12Resource>& pBuffer, const void* pData, uint64_t bufferSize, const wchar_t* name);
+	// 壁の範囲・H・質量・静止密度・障害物が変わっていれば境界粒子を並べ直してGPUへ送る
+	void UpdateBoundaryParticles();
+	void UploadBoundaryParticles();
+	// SDFの焼き込みと境界粒子の並べ直しに使うスレッドプール (最初に使う時に作り、呼び出し毎には作らない)
+	ThreadPool& GetThreadPool();
+	// 境界粒子のバッファをルート引数に設定する (使わない場合は粒子数を0にする)
+	void BindBoundaryParticles(ID3D12GraphicsCommandList* pCmdlist);
 	void CreateBillboardMesh();
 	void CreateRootSignature(Renderer* pRenderer);
 	void CreatePipeline(Renderer* pRenderer);
 	void InitializeParticles();
 
-	// 萔
-	static const uint32_t MaxParticles = 20000;
-	// Obh֘A
-	float m_GridCellSize = 0.0f;// Obh̃ZTCY (m_HƓ)
-	Vector3D m_GridDim = Vector3D(0, 0, 0 ); // Obh̎ (X, Y, Z ꂼ̃Z)
-	uint32_t m_TotalGridCount = 0; // Obh (GridHeadobt@̃TCY)
+	// 粒子数 (シナリオから実行時に決める)
+	uint32_t m_ParticleCount = FluidScenario::DefaultParticleCount; // 有効な粒子数 (Dispatchと描画の対象)
+	uint32_t m_ParticleCapacity = 0; // ParticleBuffer/GridNextBufferの確保数
+	int m_RequestedParticleCount = FluidScenario::DefaultParticleCount; // ImGuiでの入力値
+	const uint32_t EmitParticleCount = 1000; // エミッターで1回に追加する粒子数
+	// 初期配置の乱数シード (同じシードなら CPUFluidSolver::InitializeParticles と同じ配置になる)
+	int m_RandomSeed = 1;
+	std::mt19937 m_EmitRandom; // エミッターの配置用 (InitializeParticlesでシードから作り直す)
+	// チェックポイント
+	CheckpointWriter m_CheckpointWriter;
+	char m_CheckpointPath[260] = "fluid.ckpt"; // ImGuiでの入力値
+	std::string m_CheckpointStatus;
+	uint64_t m_StepCount = 0;     // 初期配置からのステップ数
+	// エクスポート (フレーム毎のコピーは描画と同じコマンドリストに積み、次のフレームで読むので、読み戻しでGPUを待たない)
+	ParticleExporter m_Exporter;
+	ExportParam m_ExportParam;
+	char m_ExportPath[260] = "export/fluid"; // ImGuiでの入力値
+	int m_ExportInterval = 1;           // 書き出すフレームの間隔 (ImGuiでの入力値)
+	uint64_t m_ExportFrameCount = 0;    // エクスポートを開始してからのフレーム数
+	bool m_ExportCopyPending = false;   // m_pExportReadbackBuffer へのコピーを積んだ
+	uint32_t m_ExportCopyCount = 0;     // コピーした粒子数
+	double m_ExportCopyTime = 0.0;      // コピーした時点の経過時間
+	double m_SimulatedTime = 0.0; // 初期配置からの経過時間
+	// SDFの障害物 (値はすべての障害物を1つのバッファに詰め、World はフレーム毎のテーブルで渡す)
+	struct Collider
+	{
+		const Model* pModel = nullptr;
+		std::unique_ptr<SignedDistanceField> pField;
+		uint32_t ValueOffset = 0;
+	};
+	static const uint32_t MaxColliders = 16;
+	std::vector<Collider> m_Colliders;
+	float m_ColliderCellSize = SDFBakeParam().CellSize; // ImGuiでの入力値 (モデルのローカル座標)
+	std::string m_ColliderStatus;
+	std::unique_ptr<ThreadPool> m_pThreadPool;
+	// 境界粒子 (壁と障害物の表面に並べ、密度と力の計算で押し返す。CPUFluidSolver の BoundaryMode::Particles と同じ)
+	bool m_UseBoundaryParticles = false;
+	BoundaryParticles m_BoundaryParticles;
+	BoundaryParticleParam m_BoundaryParticleParam;
+	// グリッド関連
+	float m_GridCellSize = 0.0f;// グリッドのセルサイズ (m_Hと同じ)
+	Vector3D m_GridDim = Vector3D(0, 0, 0 ); // グリッドの次元数 (X, Y, Z それぞれのセル数)
+	uint32_t m_TotalGridCount = 0; // 総グリッド数 (GridHeadバッファのサイズ)
 	const Vector3D MaxWallRange = Vector3D(20.0f, 20.0f, 20.0f);
-	const float MinCellSize = 0.1f; // z肷ŏZTCYiH̍ŏlj
+	const float MinCellSize = 0.1f; // 想定する最小セルサイズ（Hの最小値）
 	uint32_t m_MaxGridCount = 0;
-	// \[X
-	ComPtr<ID3D12Resource> m_pParticleBuffer;      // q̈ʒuȂǂێobt@
-	ComPtr<ID3D12Resource> m_pParticleUploadBuffer; // p
-	ComPtr<ID3D12Resource> m_pGridHeadBuffer; // Obh̐擪ID
-	ComPtr<ID3D12Resource> m_pGridNextBuffer; // ̃p[eBNID
-	// r{[hp_obt@
+	// リソース
+	ComPtr<ID3D12Resource> m_pParticleBuffer;      // 粒子の位置などを保持するバッファ
+	ComPtr<ID3D12Resource> m_pParticleUploadBuffer; // 初期化・追加用
+	uint32_t m_UploadBufferSize = 0;
+	ComPtr<ID3D12Resource> m_pParticleReadbackBuffer; // チェックポイントの読み戻し用
+	uint32_t m_ReadbackBufferSize = 0;
+	ComPtr<ID3D12Resource> m_pExportReadbackBuffer; // エクスポートの読み戻し用
+	uint32_t m_ExportReadbackBufferSize = 0;
+	ComPtr<ID3D12Resource> m_pParticleScratchBuffer; // 削除時の詰め替え用
+	uint32_t m_ScratchBufferSize = 0;
+	ComPtr<ID3D12Resource> m_pGridHeadBuffer; // グリッドの先頭ID
+	ComPtr<ID3D12Resource> m_pGridNextBuffer; // 次のパーティクルID
+	ComPtr<ID3D12Resource> m_pColliderValueBuffer; // SDFの値 (t0。障害物がない場合も1要素は確保する)
+	ComPtr<ID3D12Resource> m_pColliderTableBuffer; // 障害物のテーブル (t1。アップロードヒープにフレーム毎に MaxColliders 個ずつ)
+	SDFColliderGPU* m_pColliderTable = nullptr;     // Map したままのポインタ
+	ComPtr<ID3D12Resource> m_pBoundaryParticleBuffer;  // 境界粒子 (t2。粒子がない場合も1要素は確保する)
+	ComPtr<ID3D12Resource> m_pBoundaryCellStartBuffer; // セル毎の境界粒子の先頭 (t3)
+	// ビルボード用頂点バッファ
 	ComPtr<ID3D12Resource> m_pBillboardVB;
 	D3D12_VERTEX_BUFFER_VIEW m_BillboardVBV = {};
 
-	// pCvC
+	// パイプライン
 	std::unique_ptr<DX12RootSignature> m_pComputeRootSignature;
 	std::unique_ptr<DX12PipelineState> m_pComputePSO;
 	std::unique_ptr<DX12PipelineState> m_pDensityPSO;
 	std::unique_ptr<DX12PipelineState> m_pForcePSO;
-	std::unique_ptr<DX12PipelineState> m_pGridBuildPSO; // Obh\zpPSO
-	std::unique_ptr<DX12PipelineState> m_pClearGridPSO; // ObhNApPSO
+	std::unique_ptr<DX12PipelineState> m_pGridBuildPSO; // グリッド構築用PSO
+	std::unique_ptr<DX12PipelineState> m_pClearGridPSO; // グリッドクリア用PSO
 
-	// fBXNv^q[ṽCfbNX
-	uint32_t m_UAVIndex = 0; // Compute Shaderݗp
-	uint32_t m_GridHeadUAVIndex = 0; // Compute Shaderݗp
-	uint32_t m_GridNextUAVIndex = 0; // Compute Shaderݗp
-	uint32_t m_SRVIndex = 0; // Vertex Shaderǂݍݗp
+	// ディスクリプタヒープのインデックス
+	uint32_t m_UAVIndex = 0; // Compute Shader書き込み用
+	uint32_t m_GridHeadUAVIndex = 0; // Compute Shader書き込み用
+	uint32_t m_GridNextUAVIndex = 0; // Compute Shader書き込み用
+	uint32_t m_SRVIndex = 0; // Vertex Shader読み込み用
 	
-	// f[^
+	// データ
 	SimulationParam m_SimParam;
 	ParticleTransform m_ParticleTransform;
 	
@@ -106,17 +217,17 @@ private:
 	Renderer* m_pRenderer = nullptr;
 
 	float m_Gravity = -9.81f;
-	float m_H = 0.16f; // e͈
-	float m_Mass = 0.5f; // 
-	float m_Viscosity = 20.0f; // SW
-	float m_RestDensity = 300.0f; // Î~x
-	float m_Stiffness = 100.0f; // ͌v
-	float m_NearStiffness = 10.0f; // ߖT͌v
-	float m_BoxWidth; // 
-	float m_MaxAllowableTimestep = 0.006f; // ԍݕ
+	float m_H = 0.16f; // 影響範囲
+	float m_Mass = 0.5f; // 質量
+	float m_Viscosity = 20.0f; // 粘性係数
+	float m_RestDensity = 300.0f; // 静止密度
+	float m_Stiffness = 100.0f; // 圧力計数
+	float m_NearStiffness = 10.0f; // 近傍圧力計数
+	float m_BoxWidth; // 初期幅
+	float m_MaxAllowableTimestep = 0.006f; // 時間刻み幅
 	float m_TimeStep = 0.0f;
-	uint32_t m_Iterations = 1; // V~[V1t[̃Ce[V
-	// ftHg̕ǂ͈̔
+	uint32_t m_Iterations = 1; // シミュレーションの1フレーム当たりのイテレーション回数
+	// デフォルトの壁の範囲
 	Vector3D m_WallMin = Vector3D(-2.0f, 0.0f, -2.0f);
 	Vector3D m_WallMax = Vector3D(2.0f, 4.0f, 2.0f);
 };
\ No newline at end of file
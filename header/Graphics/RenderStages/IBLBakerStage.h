@@ -54,13 +54,13 @@ private:
 	Renderer* m_pRenderer = nullptr;
 	DX12DescriptorHeap* SRVHeap = nullptr;
 
-	// _ACfbNXf[^
+	// 頂点、インデックスデータ
 	ComPtr<ID3D12Resource> m_pVB = nullptr;
 	D3D12_VERTEX_BUFFER_VIEW m_VBV = {};
 
-	ComPtr<ID3D12Resource> m_TexDFG; //!< DFGeNX`
-	ComPtr<ID3D12Resource> m_TexDiffuseLD; //!< DiffuseLDeNX`
-	ComPtr<ID3D12Resource> m_TexSpecularLD; //!< SpecularLDeNX`
+	ComPtr<ID3D12Resource> m_TexDFG; //!< DFGテクスチャ
+	ComPtr<ID3D12Resource> m_TexDiffuseLD; //!< DiffuseLDテクスチャ
+	ComPtr<ID3D12Resource> m_TexSpecularLD; //!< SpecularLDテクスチャ
 	std::vector<CbBake> m_BakeCBDatas;
 	uint32_t m_RTV_DFG_Index = 0;
 	std::vector<uint32_t> m_RTV_DiffuseLD_Indeies;
@@ -36,8 +36,8 @@ private:
 	float m_DepthBufferHeight = 4096;
 	D3D12_RECT m_Scissor;
 	D3D12_VIEWPORT m_Viewport;
-	float m_LightViewSize = 30.0f; // e𗎂Ƃ͈͂̍Li[gj
-	float m_LightDistance = 50.0f;// CgJƒ_̋
+	float m_LightViewSize = 30.0f; // 影を落とす範囲の広さ（メートル）
+	float m_LightDistance = 50.0f;// ライトカメラと注視点の距離
 	float lightY = -45.0f;
 	float lightX = 50.0f;
 };
\ No newline at end of file
@@ -33,7 +33,7 @@ private:
 	std::unique_ptr<Texture> m_pTestTexture = nullptr;
 	TransformBuffer m_SkydomeTranBuufer;
 
-	// _ACfbNXf[^
+	// 頂点、インデックスデータ
 	ComPtr<ID3D12Resource> m_pVB = nullptr;
 	D3D12_VERTEX_BUFFER_VIEW m_VBV = {};
 };
\ No newline at end of file
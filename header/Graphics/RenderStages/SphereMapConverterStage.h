@@ -24,12 +24,12 @@ private:
 	void DrawSphere(ID3D12GraphicsCommandList* pCmdList);
 
 	Renderer* m_pRenderer = nullptr;
-	uint32_t m_MipCount; //!< ~bvx
-	ComPtr<ID3D12Resource> m_pCubeTex; //!< L[u}bveNX`
+	uint32_t m_MipCount; //!< ミップレベル数
+	ComPtr<ID3D12Resource> m_pCubeTex; //!< キューブマップテクスチャ
 	uint32_t m_SRVIndex = 0;
 	std::vector<uint32_t> m_RTVIndeies;
 	TransformBuffer m_CBTrans[6];
-	// _ACfbNXf[^
+	// 頂点、インデックスデータ
 	ComPtr<ID3D12Resource> m_pVB = nullptr;
 	D3D12_VERTEX_BUFFER_VIEW m_VBV = {};
 
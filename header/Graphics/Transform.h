@@ -5,29 +5,29 @@
 struct alignas(256) TransformBuffer
 {
 public:
-	Matrix4x4 World = Matrix4x4::Identity(); // [hϊs
-	Matrix4x4 View = Matrix4x4::Identity();  // r[ϊs
-	Matrix4x4 Proj = Matrix4x4::Identity();  // vWFNVϊs
+	Matrix4x4 World = Matrix4x4::Identity(); // ワールド変換行列
+	Matrix4x4 View = Matrix4x4::Identity();  // ビュー変換行列
+	Matrix4x4 Proj = Matrix4x4::Identity();  // プロジェクション変換行列
 
-	// mێ256oCgEɍ킹JX^new
+	// メモリ確保時に256バイト境界に合わせるカスタムnew
 	void* operator new(size_t size)
 	{
 		return _aligned_malloc(size, 256);
 	}
 
-	// z new[]
+	// 配列版 new[]
 	void* operator new[](size_t size)
 	{
 		return _aligned_malloc(size, 256);
 	}
 
-	// p̃JX^delete
+	// メモリ解放用のカスタムdelete
 	void operator delete(void* ptr)
 	{
 		_aligned_free(ptr);
 	}
 
-	// z delete[]
+	// 配列版 delete[]
 	void operator delete[](void* ptr)
 	{
 		_aligned_free(ptr);
@@ -67,7 +67,7 @@ private:
 	Matrix4x4 m_World;
 	Matrix4x4 m_View;
 	Vector3D m_Position = Vector3D();
-	Vector3D m_Rotation = Vector3D(); // degree x
+	Vector3D m_Rotation = Vector3D(); // degree 度
 	Quaternion m_Quaternion = Quaternion();
 	Vector3D m_Scale = Vector3D(1.0f);
 
@@ -0,0 +1,13 @@
+#pragma once
+#include "pch.h"
+#include "Math/Vector2D.h"
+#include "Math/Vector3D.h"
+
+// メッシュの頂点レイアウト (DX12に依存しないので、ヘッドレスの表面抽出からも使う)
+struct Vertex
+{
+	Vector3D m_Position; // 頂点座標
+	Vector3D m_Normal;    // 法線ベクトル
+	Vector2D m_TexCoord;    // UV座標
+	Vector3D m_Tangent;    // 接線ベクトル
+};
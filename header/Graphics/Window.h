@@ -13,12 +13,12 @@ public:
 	void Resize();
 
 	/// <summary>
-	/// t[obt@
+	/// フレームバッファ数
 	/// </summary>
 	static const uint32_t FrameCount = 2;
 
 	/// <summary>
-	/// Qb^[
+	/// ゲッター類
 	/// </summary>
 	HWND GetHwnd() const { return m_hWnd; }
 	uint32_t GetWidth() const { return m_Width; }
@@ -39,52 +39,52 @@ private:
 	void UpdateScreenBuffers();
 	void UpdateDepthBuffer();
 	/// <summary>
-	/// CX^Xnh
+	/// インスタンスハンドル
 	/// </summary>
 	HINSTANCE m_HInstance;
 	/// <summary>
-	/// EBhEnh
+	/// ウィンドウハンドル
 	/// </summary>
 	HWND m_hWnd;
 	/// <summary>
-	/// EBhẺ
+	/// ウィンドウの横幅
 	/// </summary>
 	uint32_t m_Width;
 	/// <summary>
-	/// EBhȄc
+	/// ウィンドウの縦幅
 	/// </summary>
 	uint32_t m_Height;
 	/// <summary>
-	/// Xbv`F[
+	/// スワップチェーン
 	/// </summary>
 	ComPtr<IDXGISwapChain3> m_pSwapChain;
 	/// <summary>
-	/// r[|[g
+	/// ビューポート
 	/// </summary>
 	D3D12_VIEWPORT m_Viewport;
 	/// <summary>
-	/// VU[`
+	/// シザー矩形
 	/// </summary>
 	D3D12_RECT m_Scissor;
 
 	/// <summary>
-	/// EBhE̖O
+	/// ウィンドウの名前
 	/// </summary>
 	std::wstring m_WindowName;
 
 	/// <summary>
-	/// _[obt@[
+	/// レンダーバッファー
 	/// </summary>
 	uint32_t m_RenderBufferRTVs[FrameCount];
 
 	/// <summary>
-	/// XN[obt@
+	/// スクリーンバッファ
 	/// </summary>
 	std::vector<ComPtr<ID3D12Resource>> m_pScreenBuffers = {nullptr};
 	uint32_t m_pScreenBufferRTVs[FrameCount];
 
 	/// <summary>
-	/// [xobt@
+	/// 深度バッファ
 	/// </summary>
 	ComPtr<ID3D12Resource> m_pDepthBuffer;
 	uint32_t m_DepthBufferDSV;
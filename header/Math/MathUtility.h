@@ -5,7 +5,7 @@ namespace MathUtility
     static constexpr float DEG_TO_RAD = PI / 180.0f;
 
     /// <summary>
-	/// xWAɕϊ܂
+	/// 度をラジアンに変換します
     /// </summary>
     inline float DegreeToRadian(const float& deg)
     {
@@ -13,7 +13,7 @@ namespace MathUtility
     }
 
     /// <summary>
-/// xWAɕϊ܂
+/// 度をラジアンに変換します
 /// </summary>
     inline float RadianToDegree(const float& rad)
     {
@@ -7,7 +7,7 @@
 class Matrix4x4
 {
 public:
-    // RXgN^
+    // コンストラクタ
     Matrix4x4() noexcept
     {
         setIdentity();
@@ -30,7 +30,7 @@ public:
     }
 
     //// =======================
-    //// FbxAMatrix ϊ
+    //// FbxAMatrix 変換
     //// =======================
     //static Matrix4x4 ConvertMatrix(const FbxAMatrix& fbmat) noexcept
     //{
@@ -44,7 +44,7 @@ public:
     //}
 
     // =======================
-    // ]sݒ
+    // 回転行列設定
     // =======================
     void setRotationX(float x) noexcept
     {
@@ -98,7 +98,7 @@ public:
     }
 
     // =======================
-    // s񂩂xNgϊ
+    // 行列からベクトル変換
     // =======================
     static Vector3D Apply(const Matrix4x4& matrix, const Vector3D& vec) noexcept
     {
@@ -107,14 +107,14 @@ public:
         float z = vec.x * matrix.m_mat[0][2] + vec.y * matrix.m_mat[1][2] + vec.z * matrix.m_mat[2][2] + matrix.m_mat[3][2];
         float w = vec.x * matrix.m_mat[0][3] + vec.y * matrix.m_mat[1][3] + vec.z * matrix.m_mat[2][3] + matrix.m_mat[3][3];
 
-        // wŊ鏈KvȏꍇiˉeϊȂǁj͂ōs
+        // wで割る処理が必要な場合（射影変換後など）はここで行う
         // if(w != 1.0f && w != 0.0f) { x /= w; y /= w; z /= w; }
 
         return Vector3D(x, y, z);
     }
 
     // =======================
-    // r[EeEϊs
+    // ビュー・投影・変換行列
     // =======================
     static Matrix4x4 setLookAtLH(const Vector3D& pos, const Vector3D& target, const Vector3D& up) noexcept
     {
@@ -230,7 +230,7 @@ public:
 
         return det;
     }
-    // NH[^jI]s
+    // クォータニオンから回転行列
     static Matrix4x4 QuaternionToMatrix(const Quaternion& q) noexcept
     {
         Matrix4x4 mat;
@@ -267,7 +267,7 @@ public:
         return mat;
     }
 
-    // sړs
+    // 平行移動行列
     static Matrix4x4 TransitionToMatrix(const Vector3D& trans) noexcept
     {
         Matrix4x4 mat;
@@ -279,27 +279,27 @@ public:
     }
 
     // =======================
-    // Vector3D(IC[p degree)]s
-    // ] Z(Roll) -> X(Pitch) -> Y(Yaw) ƂĂ܂
+    // Vector3D(オイラー角 degree)から回転行列
+    // ※回転順序は Z(Roll) -> X(Pitch) -> Y(Yaw) としています
     // =======================
     static Matrix4x4 RotationToMatrix(const Vector3D& degree) noexcept
     {
-        // Degree -> Radian ϊ
+        // Degree -> Radian 変換
         float radX = degree.x * MathUtility::DEG_TO_RAD;
         float radY = degree.y * MathUtility::DEG_TO_RAD;
         float radZ = degree.z * MathUtility::DEG_TO_RAD;
 
         Matrix4x4 rx, ry, rz;
-        // setRotationX std::cos/sin g Radian n
+        // setRotationX等は std::cos/sin を使うため Radian を渡す
         rx.setRotationX(radX);
         ry.setRotationY(radY);
         rz.setRotationZ(radZ);
 
-        // : Z(Roll) -> X(Pitch) -> Y(Yaw)
+        // 合成順序: Z(Roll) -> X(Pitch) -> Y(Yaw)
         return rz * rx * ry;
     }
 
-    // XP[Os
+    // スケーリング行列
     static Matrix4x4 ScalingToMatrix(const Vector3D& scale) noexcept
     {
         Matrix4x4 mat;
@@ -9,7 +9,7 @@ class Quaternion
 public:
     Quaternion() noexcept = default;
     constexpr Quaternion(float v_x, float v_y, float v_z, float v_w) noexcept : x(v_x), y(v_y), z(v_z), w(v_w) {}
-    // explicit Ӑ}floatVector4D^ɕύXȂ
+    // explicit 意図せずにfloatがVector4D型に変更されないため
     explicit constexpr Quaternion(float v) noexcept : x(v), y(v), z(v), w(v) {}
     explicit constexpr Quaternion(const Vector3D& v) noexcept : x(v.x), y(v.y), z(v.z), w(1.0f) {}
 
@@ -88,7 +88,7 @@ public:
         float cz = std::cos(radZ);
         float sz = std::sin(radZ);
 
-        // Z * X * Y ̍vZ
+        // Z * X * Y の合成計算
         return Quaternion(
             sx * cy * cz + cx * sy * sz, // x
             cx * sy * cz - sx * cy * sz, // y
@@ -106,15 +106,15 @@ public:
     {
         Vector3D angles;
 
-        // X(Pitch)̌vZ
+        // X軸(Pitch)の計算
         float sinP = 2.0f * (q.w * q.x - q.y * q.z);
         if (std::abs(sinP) >= 1.0f)
-            angles.x = std::copysign(MathUtility::PI / 2.0f, sinP); // 90xŃNv
+            angles.x = std::copysign(MathUtility::PI / 2.0f, sinP); // 90度でクランプ
         else
             angles.x = std::asin(sinP);
 
-        // Y(Yaw)Z(Roll)̌vZ
-        // WobN̂ߏ򂷂ꍇ邪AasiňʂɊÂʓIȌvZ
+        // Y軸(Yaw)とZ軸(Roll)の計算
+        // ジンバルロック回避のため条件分岐する場合もあるが、asinの結果に基づく一般的な計算
         angles.y = std::atan2(2.0f * (q.w * q.y + q.x * q.z), 1.0f - 2.0f * (q.x * q.x + q.y * q.y));
         angles.z = std::atan2(2.0f * (q.w * q.z + q.x * q.y), 1.0f - 2.0f * (q.x * q.x + q.z * q.z));
 
@@ -126,10 +126,10 @@ public:
         return angles;
     }
 
-    //! @brief w肵pxƉ]NH[^jI𐶐
-    //! @param[in] angle px
-    //! @param[in] axis ]
-    //! @return NH[^jI
+    //! @brief 指定した角度と回転軸からクォータニオンを生成
+    //! @param[in] angle 角度
+    //! @param[in] axis 回転軸
+    //! @return クォータニオン
     static const Quaternion AngleAxis(float angle, const Vector3D& axis)
     {
         Vector3D normalizedAxis = axis.GetSafeNormal();
@@ -4,15 +4,15 @@
 class Vector2D
 {
 public:
-    // ftHgRXgN^i(0,0,0)ɏj
+    // デフォルトコンストラクタ（(0,0,0)に初期化）
     Vector2D() noexcept = default;
-    // XYwRXgN^
+    // XY指定コンストラクタ
     Vector2D(float x, float y) noexcept : x(x), y(y){}
-    // lXYiexplicitňÖٕϊh~j
+    // 同じ値でXY初期化（explicitで暗黙変換防止）
     explicit Vector2D(float v) noexcept : x(v), y(v){}
-    // Rs[RXgN^
+    // コピーコンストラクタ
     Vector2D(const Vector2D&) noexcept = default;
-    // Zq
+    // 代入演算子
     Vector2D& operator=(const Vector2D&) noexcept = default;
 
     Vector2D operator+(const Vector2D& vec) const noexcept
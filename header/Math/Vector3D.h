@@ -4,15 +4,15 @@
 class Vector3D
 {
 public:
-    // ftHgRXgN^i(0,0,0)ɏj
+    // デフォルトコンストラクタ（(0,0,0)に初期化）
     Vector3D() noexcept = default;
-    // XYZwRXgN^
+    // XYZ指定コンストラクタ
     Vector3D(float x, float y, float z) noexcept : x(x), y(y), z(z) {}
-    // lXYZiexplicitňÖٕϊh~j
+    // 同じ値でXYZ初期化（explicitで暗黙変換防止）
     explicit Vector3D(float v) noexcept : x(v), y(v), z(v) {}
-    // Rs[RXgN^
+    // コピーコンストラクタ
     Vector3D(const Vector3D&) noexcept = default;
-    // Zq
+    // 代入演算子
     Vector3D& operator=(const Vector3D&) noexcept = default;
 
     Vector3D operator+(const Vector3D& vec) const noexcept
@@ -5,19 +5,19 @@
 class Vector4D
 {
 public:
-    // ftHgRXgN^i(0,0,0,0)ɏj
+    // デフォルトコンストラクタ（(0,0,0,0)に初期化）
     Vector4D() noexcept = default;
 
-    // XYZWwRXgN^
+    // XYZW指定コンストラクタ
     Vector4D(float x, float y, float z, float w) noexcept : x(x), y(y), z(z), w(w) {}
 
-    // lXYZWiexplicitňÖٕϊh~j
+    // 同じ値でXYZW初期化（explicitで暗黙変換防止）
     explicit Vector4D(float v) noexcept : x(v), y(v), z(v), w(v) {}
 
-    // Rs[RXgN^
+    // コピーコンストラクタ
     Vector4D(const Vector4D&) noexcept = default;
 
-    // Zq
+    // 代入演算子
     Vector4D& operator=(const Vector4D&) noexcept = default;
 
     Vector4D operator+(const Vector4D& vec) const noexcept
@@ -0,0 +1,73 @@
+#pragma once
+#include "pch.h"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// SIMDロード用にアライメントを揃えたアロケータ
+template<typename T, size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+	using value_type = T;
+
+	template<typename U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	AlignedAllocator() noexcept = default;
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+	}
+
+	void deallocate(T* ptr, size_t) noexcept
+	{
+		::operator delete(ptr, std::align_val_t(Alignment));
+	}
+
+	template<typename U>
+	bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+	template<typename U>
+	bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// resize で要素を値初期化 (0クリア) しないアロケータ
+// トリビアルな型は確保しただけではページに書き込まないので、最初に書き込むスレッドを選べる (NUMAのファーストタッチ)
+template<typename T>
+class DefaultInitAllocator : public std::allocator<T>
+{
+public:
+	template<typename U>
+	struct rebind
+	{
+		using other = DefaultInitAllocator<U>;
+	};
+
+	DefaultInitAllocator() noexcept = default;
+	template<typename U>
+	DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+
+	template<typename U>
+	void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value)
+	{
+		::new(static_cast<void*>(ptr)) U;
+	}
+	template<typename U, typename... Args>
+	void construct(U* ptr, Args&&... args)
+	{
+		::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+	}
+};
+
+template<typename T>
+using UninitializedVector = std::vector<T, DefaultInitAllocator<T>>;
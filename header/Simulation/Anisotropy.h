@@ -0,0 +1,79 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+#include "Simulation/SPHBatchKernels.h"
+
+class ThreadPool;
+
+// 異方性カーネルの設定 (Yu & Turk 2013 の λ, k_r, N_ε, k_n)
+struct AnisotropyParam
+{
+	float NeighborRadius = 2.0f;  // 共分散を求める近傍の半径 (H に対する比。小さいと内部の粒子の共分散が乱れ、場に穴が開く)
+	float Smoothing = 0.5f;       // 中心を近傍の重み付き平均に寄せる割合 (λ。表面の粒子の凹凸をならす。論文の0.9では半径 2H の平均に寄りすぎて表面が縮む)
+	float MaxStretch = 4.0f;      // 主軸の半径の最大と最小の比の上限 (k_r)
+	uint32_t MinNeighbors = 25;   // これより近傍が少ない粒子は等方にする (N_ε。粒子間隔 H / 2 の内部の粒子は半径 2H に約270)
+	float IsolatedScale = 0.5f;   // 近傍が少ない粒子の半径の倍率 (k_n。飛沫を小さな粒にする)
+	SIMDLevel SIMD = SIMDLevel::AVX512; // 固有分解に使う命令セット (CPUが対応していない場合はより狭い実装になる)
+};
+
+// 粒子毎の楕円体のカーネル
+// 点 x の重みは等方なカーネルの半径 h に対して W(|G (x - Center)|) / (Radii[0] * Radii[1] * Radii[2])、G = Σ Axes[k] Axes[k]^T / (h * Radii[k])
+struct EllipsoidKernel
+{
+	Vector3D Center;   // 平滑化した中心
+	Vector3D Axes[3];  // 主軸 (単位ベクトル、右手系とは限らない)
+	float Radii[3];    // 各主軸の半径の倍率 (近傍が十分ある粒子は積が1になるよう正規化する)
+};
+
+// 直近の計算の統計
+struct AnisotropyStats
+{
+	uint32_t ParticleCount = 0;
+	uint32_t IsolatedCount = 0;        // 近傍が少なく等方にした粒子の数
+	float MeanNeighborCount = 0.0f;
+	double NeighborMilliseconds = 0.0; // グリッドの構築と近傍の共分散
+	double EigenMilliseconds = 0.0;    // 固有分解とカーネルの作成
+	double TotalMilliseconds = 0.0;
+};
+
+/// <summary>
+/// 粒子の近傍の分布から楕円体のカーネルを作ります (Yu & Turk 2013, "Reconstructing Surfaces of Particle-Based Fluids Using Anisotropic Kernels")
+/// 近傍はソルバーと同じ H の空間ハッシュのセルから探し、重み 1 - (r / R)^3 の共分散行列を SIMD の Jacobi 法でまとめて固有分解する
+/// 平らな水面の粒子は面に沿って広く法線方向に薄いカーネルになるので、粗い格子でも滑らかな表面を抽出できる
+/// </summary>
+class AnisotropyEstimator
+{
+public:
+	// threadCount = 0 の場合はハードウェアスレッド数を使用
+	explicit AnisotropyEstimator(uint32_t threadCount = 0);
+	// threadPool を共有する (threadPool は AnisotropyEstimator より長く生存すること)
+	explicit AnisotropyEstimator(ThreadPool& threadPool);
+	AnisotropyEstimator(const AnisotropyEstimator&) = delete;
+	AnisotropyEstimator& operator=(const AnisotropyEstimator&) = delete;
+	~AnisotropyEstimator();
+
+	void SetParam(const AnisotropyParam& param) { m_Param = param; }
+	const AnisotropyParam& GetParam() const { return m_Param; }
+
+	/// <summary>
+	/// particles と同じ順番で kernels にカーネルを書きます
+	/// </summary>
+	void Compute(const std::vector<Particle>& particles, const SimulationParam& simParam, std::vector<EllipsoidKernel>& kernels);
+
+	const AnisotropyStats& GetStats() const { return m_Stats; }
+
+private:
+	std::unique_ptr<ThreadPool> m_pOwnedThreadPool;
+	ThreadPool* m_pThreadPool = nullptr;
+	AnisotropyParam m_Param;
+	AnisotropyStats m_Stats;
+	// 計算毎に使い回す作業領域
+	std::vector<uint32_t> m_ParticleBucket;  // 粒子毎のハッシュのバケット
+	std::vector<uint32_t> m_BucketStart;     // バケット毎の粒子の範囲 (m_SortedPositions の先頭)
+	std::vector<Vector3D> m_SortedPositions; // バケット順に並べた粒子の位置
+	std::vector<uint32_t> m_SortedIndices;   // バケット順の粒子の元の番号
+	std::vector<uint32_t> m_NeighborCounts;  // 粒子毎の近傍の数 (自分を含まない)
+	std::vector<float> m_Covariance[6];      // 粒子毎の共分散行列 (xx, xy, xz, yy, yz, zz)
+	std::vector<float> m_EigenValues[3];
+	std::vector<float> m_EigenVectors[9];
+};
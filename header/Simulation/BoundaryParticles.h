@@ -0,0 +1,131 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+#include "Simulation/SPHCommon.h"
+#include "Simulation/SPHKernels.h"
+#include "Simulation/SignedDistanceField.h"
+
+class ThreadPool;
+
+// 境界粒子の設定
+struct BoundaryParticleParam
+{
+	float Spacing = 0.0f; // 表面に並べる間隔 (0 の場合は流体の静止時の粒子間隔 (Mass / RestDensity)^(1/3))
+};
+
+// 直近の構築の統計
+struct BoundaryParticleStats
+{
+	uint32_t WallParticleCount = 0;
+	uint32_t ColliderParticleCount = 0;
+	float Spacing = 0.0f;
+	float MinPsi = 0.0f; // Ψ の範囲 (流体粒子の質量と比べると、並びの疎密を補正した量がわかる)
+	float MaxPsi = 0.0f;
+	double BuildMilliseconds = 0.0;
+};
+
+/// <summary>
+/// 壁と障害物の表面に並べた境界粒子 (Akinci et al. 2012, "Versatile Rigid-Fluid Coupling for Incompressible SPH")
+/// 流体粒子の密度に Σ Ψb W、圧力に -Σ Ψb (p / ρ) ∇W (境界粒子の圧力と密度は流体粒子と同じとみなす) を加えて壁から押し返す
+/// 粘性は境界粒子の速度を0として Σ Ψb (0 - v) ∇^2W / ρ を加える
+/// Ψb = ρ0 / Σk W(xb - xk) は境界粒子同士の密度の逆数から求める体積に ρ0 を掛けた値で、角や障害物の表面の並びの疎密を補正する
+/// 壁は箱の外側に間隔の半分だけずらした殻に格子状に並べ、障害物は SDF の帯の中の格子点を表面の内側 (間隔の半分) に射影する
+/// 粒子は流体のグリッドと同じセル (壁の範囲と H から決まる) で1回だけカウンティングソートしておくので、ステップ毎の構築はいらない
+/// </summary>
+class BoundaryParticles
+{
+public:
+	// Ψ を求める密度のカーネル (CPUFluidSolver::Kernels と FluidDensityCS の密度のカーネルと同じである必要がある)
+	using DensityKernel = SPHKernels::DefaultKernelSet::Density;
+
+	BoundaryParticles() = default;
+
+	/// <summary>
+	/// param の壁の範囲・H・質量・静止密度と colliders から並べ直します
+	/// 障害物の表面の点は SDF と間隔毎に覚えておき、World だけが変わった場合は座標の変換と並べ替えだけを行う
+	/// </summary>
+	/// <returns>H や間隔が0以下の場合は false (粒子は空になる)</returns>
+	bool Build(const SimulationParam& param, const std::vector<SDFCollider>& colliders, const BoundaryParticleParam& boundaryParam, ThreadPool& threadPool);
+	/// <summary>
+	/// 直近の Build と同じ入力 (壁の範囲・H・質量・静止密度・間隔・障害物の SDF と World) かどうか
+	/// </summary>
+	bool IsUpToDate(const SimulationParam& param, const std::vector<SDFCollider>& colliders, const BoundaryParticleParam& boundaryParam) const;
+	/// <summary>
+	/// 粒子と障害物の表面の点を捨てます (SDF はアドレスで見分けるので、障害物の SDF を作り直した場合は次の Build の前に呼ぶ)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// position を含むセルと周囲26セルの境界粒子の番号を順に func(index) へ渡します
+	/// (セルは x, y, z の順に並んでいるので、x方向の3セルずつ連続した範囲を読む)
+	/// </summary>
+	template<typename Func>
+	void ForEachNeighbor(const Vector3D& position, Func&& func) const
+	{
+		if (m_Positions.empty())
+		{
+			return;
+		}
+		SPHCommon::GridPos gridPos = SPHCommon::GetGridPos(position, m_WallMin, m_CellSize);
+		int minX = std::max(gridPos.x - 1, 0);
+		int maxX = std::min(gridPos.x + 1, m_GridDim.x - 1);
+		if (minX > maxX)
+		{
+			return;
+		}
+		for (int z = std::max(gridPos.z - 1, 0); z <= std::min(gridPos.z + 1, m_GridDim.z - 1); ++z)
+		{
+			for (int y = std::max(gridPos.y - 1, 0); y <= std::min(gridPos.y + 1, m_GridDim.y - 1); ++y)
+			{
+				int rowIndex = (z * m_GridDim.y + y) * m_GridDim.x;
+				uint32_t end = m_CellStart[rowIndex + maxX + 1];
+				for (uint32_t index = m_CellStart[rowIndex + minX]; index < end; ++index)
+				{
+					func(index);
+				}
+			}
+		}
+	}
+
+	bool IsEmpty() const { return m_Positions.empty(); }
+	uint32_t GetCount() const { return static_cast<uint32_t>(m_Positions.size()); }
+	// セル順に並べた位置と Ψ
+	const std::vector<Vector3D>& GetPositions() const { return m_Positions; }
+	const std::vector<float>& GetPsi() const { return m_Psi; }
+	// セル c の粒子は [GetCellStart()[c], GetCellStart()[c + 1]) (要素数はセル数 + 1)
+	const std::vector<uint32_t>& GetCellStart() const { return m_CellStart; }
+	const SPHCommon::GridPos& GetGridDim() const { return m_GridDim; }
+	const BoundaryParticleStats& GetStats() const { return m_Stats; }
+
+	// param と boundaryParam から決まる間隔
+	static float GetSpacing(const SimulationParam& param, const BoundaryParticleParam& boundaryParam);
+
+private:
+	// 壁の殻の格子点 (ワールド座標)
+	void SampleWalls(const SimulationParam& param, float spacing, std::vector<Vector3D>& points) const;
+	// 障害物の表面の点 (SDF のローカル座標)。同じ SDF と間隔の点は使い回す
+	const std::vector<Vector3D>& SampleCollider(const SignedDistanceField& field, float localSpacing, ThreadPool& threadPool);
+
+	Vector3D m_WallMin = Vector3D(0.0f, 0.0f, 0.0f);
+	float m_CellSize = 0.0f;
+	SPHCommon::GridPos m_GridDim;
+	std::vector<Vector3D> m_Positions;
+	std::vector<float> m_Psi;
+	std::vector<uint32_t> m_CellStart;
+
+	// 直近の Build の入力 (IsUpToDate で比べる)
+	SimulationParam m_BuiltParam = {};
+	float m_BuiltSpacing = 0.0f;
+	std::vector<SDFCollider> m_BuiltColliders;
+
+	// SDF 毎の表面の点
+	struct ColliderSamples
+	{
+		const SignedDistanceField* pField = nullptr;
+		float LocalSpacing = 0.0f;
+		std::vector<Vector3D> Positions;
+	};
+	std::vector<ColliderSamples> m_ColliderSamples;
+
+	BoundaryParticleStats m_Stats;
+};
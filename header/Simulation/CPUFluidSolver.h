@@ -0,0 +1,789 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+#include "Simulation/SPHCommon.h"
+#include "Simulation/SPHKernels.h"
+#include "Simulation/ParticleSoA.h"
+#include "Simulation/SPHBatchKernels.h"
+#include "Simulation/CompactParticle.h"
+#include "Simulation/AlignedAllocator.h"
+#include "Simulation/NumaTopology.h"
+#include "Simulation/SignedDistanceField.h"
+#include "Simulation/BoundaryParticles.h"
+
+#include <atomic>
+#include <functional>
+
+class ThreadPool;
+struct CheckpointSnapshot;
+class CheckpointFile;
+
+// グリッド構築方式
+enum class GridBuildMode
+{
+	LinkedList,   // FluidGridBuildCS と同じ GridHead/GridNext のリンクリスト
+	CountingSort, // カウント -> プレフィックスサム -> スキャッタで粒子をセル順に並べ替える
+	SpatialHash,  // セル座標のハッシュでバケット分けする。メモリとクリアは粒子数に比例し、壁の外の粒子も探索できる
+};
+
+// 密度・力のパスの粒子のスレッドへの割り当て方
+enum class WorkSchedule
+{
+	Dynamic,         // GroupSize 粒子のチャンクを、空いたスレッドからスロット順に取る
+	Static,          // スロットをスレッド数で等分し、1スレッドが1区間を処理する (比較用)
+	MortonPartition, // Morton順に並べたセルを (粒子数 × 計測したコスト) でスレッド数の区間に分け、1スレッドが1区間を処理する
+};
+
+// 直近のステップの密度・力のパスのスレッド毎の負荷
+struct LoadBalanceStats
+{
+	float Imbalance = 1.0f;         // スレッド毎の処理時間の 最大 / 平均 (1で均等)
+	float ParticleImbalance = 1.0f; // スレッド毎の処理した粒子数の 最大 / 平均
+	// スレッド毎の処理時間 (ミリ秒、Linuxではスレッドの CPU 時間なので、コアより多いスレッドの待ち時間を含まない)
+	std::vector<double> ThreadMilliseconds;
+	std::vector<uint32_t> ThreadParticles; // 密度・力の2パスの合計
+};
+
+// ソルバーの粒子毎の配列 (resize で0クリアしないので、NUMA配置では持ち主のスレッドが最初にページへ書き込める)
+using ParticleArray = UninitializedVector<Particle>;
+
+// パス毎の処理時間 (ミリ秒, 直近のStep)
+struct CPUSolverTimings
+{
+	double GridClear = 0.0;
+	double GridBuild = 0.0;
+	double Density = 0.0;
+	double Force = 0.0;
+	double Integrate = 0.0;
+	double Reorder = 0.0; // Morton順の並べ替え (実行したステップのみ)
+	double NeighborList = 0.0; // 近傍リストの構築 (作り直したステップのみ。そのステップの密度計算を含む)
+	double DivergenceSolve = 0.0; // DFSPHの速度発散の反復 (DFSPHのみ)
+	double PressureSolve = 0.0;   // DFSPHの密度一定の反復、PBFの拘束の反復 (DFSPH/PBFのみ)
+
+	double Total() const { return GridClear + GridBuild + Density + Force + Integrate + Reorder + NeighborList + DivergenceSolve + PressureSolve; }
+};
+
+// 圧力の求め方
+enum class PressureSolverMode
+{
+	WCSPH, // 状態方程式 Pressure = Stiffness * (density - RestDensity) (FluidDensityCS と同じ)
+	DFSPH, // Divergence-Free SPH: 密度一定と速度発散0の条件を反復で解く
+	PBF,   // Position Based Fluids: 密度の拘束を満たすよう予測位置を反復で動かす
+};
+
+// 壁と障害物の扱い (WCSPHのみ。DFSPH・PBFは壁の積分と位置の射影を使う)
+enum class BoundaryMode
+{
+	Penalty,   // めり込んだ深さ × 壁の剛性の加速度で押し戻す (FluidSimCS と同じ)
+	Particles, // 表面に並べた境界粒子を密度と圧力・粘性の総和に含める (Akinci et al. 2012)
+};
+
+// DFSPHの設定 (誤差は静止密度に対する比)
+struct DFSPHParam
+{
+	float DensityTolerance = 0.001f;   // 平均の圧縮率 (ρ/ρ0 - 1) がこれ以下になるまで反復する
+	float DivergenceTolerance = 0.001f; // 1ステップ当たりの密度変化率 ((Dρ/Dt) / ρ0 * dt) の平均の許容値
+	uint32_t MinIterations = 2;
+	uint32_t MaxIterations = 100;
+	uint32_t MaxDivergenceIterations = 100;
+	uint32_t MinDivergenceNeighbors = 20; // 近傍がこれより少ない粒子 (表面など) は速度発散を修正しない
+	bool DivergenceSolve = true;
+	bool WarmStart = true; // 前のステップの圧力 (κ) から反復を始める
+};
+
+// DFSPHの直近のステップの反復回数と残差
+struct DFSPHStats
+{
+	uint32_t DensityIterations = 0;
+	uint32_t DivergenceIterations = 0;
+	float DensityError = 0.0f;
+	float DivergenceError = 0.0f;
+};
+
+// PBFの設定
+struct PBFParam
+{
+	uint32_t Iterations = 4;      // 拘束の反復回数 (1回 = 近傍の走査2回)
+	float Relaxation = 1.0f;      // λの分母に加える ε (H^-2 単位)。大きいほど柔らかく安定する
+	float XSPHViscosity = 0.05f;  // XSPH粘性の係数 c (v += c Σ (m/ρj)(vj - vi) W)
+	float TensileStrength = 0.003f; // 人工圧力 s_corr = -k (W(r) / W(Δq))^n の k (H^2 単位, 0で無効)
+	float TensileDeltaQ = 0.2f;   // Δq (H単位)
+	float TensileExponent = 4.0f; // n
+};
+
+// PBFの直近のステップの統計
+struct PBFStats
+{
+	uint32_t Iterations = 0;
+	float DensityError = 0.0f; // 最後の反復の前の平均圧縮率 (max(ρ/ρ0 - 1, 0) の平均)
+};
+
+// 適応時間刻みの条件 (どの条件で dt が決まったか)
+enum class TimestepLimit
+{
+	Fixed,       // 適応時間刻みが無効 (SimulationParam::DeltaTime)
+	CFL,         // dt <= CFLNumber * H / |v|max
+	Force,       // dt <= ForceNumber * sqrt(H / |a|max)
+	Viscosity,   // dt <= ViscosityNumber * H^2 / ν
+	MinTimestep, // 条件が MinTimestep より小さい (不安定になる可能性がある)
+	MaxTimestep,
+	FrameEnd,    // フレームの残り時間
+	Count,
+};
+
+// 適応時間刻みの設定
+struct AdaptiveTimestepParam
+{
+	float CFLNumber = 0.4f;
+	float ForceNumber = 0.25f;
+	float ViscosityNumber = 0.125f; // ν = Viscosity / RestDensity
+	float MinTimestep = 1.0e-4f;
+	float MaxTimestep = 0.01f;
+	uint32_t MaxSubsteps = 64; // 1フレーム当たりの上限 (超えた分の時間は進めない)
+};
+
+// 時間刻みの統計 (AdvanceFrame 毎にリセット)
+struct TimestepStats
+{
+	float DeltaTime = 0.0f; // 直近のサブステップのdt
+	float MinDeltaTime = 0.0f;
+	float MaxDeltaTime = 0.0f;
+	float SimulatedTime = 0.0f; // フレーム内で進めた時間
+	uint32_t Substeps = 0;
+	float MaxSpeed = 0.0f;        // 直近のサブステップの |v|max (適応時間刻み有効時のみ)
+	float MaxAcceleration = 0.0f; // 直近のサブステップの |a|max (適応時間刻み有効時のみ)
+	TimestepLimit Limit = TimestepLimit::Fixed;
+	uint32_t LimitCounts[static_cast<int>(TimestepLimit::Count)] = {}; // 条件毎のサブステップ数
+};
+
+// FluidStage::RunFluidSolverGrid と同じパイプラインをCPUで実行するソルバー
+// (グリッドクリア -> グリッド構築 -> 密度 -> 力 -> 積分)
+// ウィンドウやGPUを必要としないので、ヘッドレス環境でのプロファイルに使う
+class CPUFluidSolver
+{
+public:
+	// threadCount = 0 の場合はハードウェアスレッド数を使用
+	explicit CPUFluidSolver(uint32_t threadCount = 0);
+	CPUFluidSolver(const CPUFluidSolver&) = delete;
+	CPUFluidSolver& operator=(const CPUFluidSolver&) = delete;
+	~CPUFluidSolver();
+
+	/// <summary>
+	/// シミュレーションパラメータを設定します (GridDimはH と壁の範囲から再計算)
+	/// </summary>
+	void SetSimulationParam(const SimulationParam& param);
+	const SimulationParam& GetSimulationParam() const { return m_SimParam; }
+
+	/// <summary>
+	/// FluidStage::InitializeParticles と同じ方法で壁の内側に粒子をランダム配置します
+	/// </summary>
+	void InitializeParticles(uint32_t particleCount, uint32_t seed);
+	void SetParticles(const std::vector<Particle>& particles);
+	/// <summary>
+	/// 粒子を末尾に追加します (エミッター用)。追加した粒子には戻り値から連番のIDが振られる
+	/// </summary>
+	uint32_t AddParticles(const std::vector<Particle>& particles);
+	/// <summary>
+	/// 粒子を削除し、残りの粒子を順番を保ったまま詰めます (以降のパスは残った粒子だけを処理する)
+	/// 削除した粒子のIDは再利用しない
+	/// </summary>
+	void RemoveParticles(const std::vector<uint32_t>& particleIds);
+	// 格納順 (スロット順) の粒子。並べ替えが有効な場合、順番はステップ毎に変わる
+	const ParticleArray& GetParticles() const { return m_Particles; }
+	uint32_t GetParticleCount() const { return static_cast<uint32_t>(m_Particles.size()); }
+
+	// 確保済みの粒子数 (足りなくなると1.5倍ずつ拡張する)
+	uint32_t GetParticleCapacity() const { return m_ParticleCapacity; }
+	uint32_t GetParticleReallocationCount() const { return m_ParticleReallocationCount; }
+
+	// 粒子ID (SetParticles/InitializeParticles時のインデックス、AddParticlesで追加した粒子はその続き) とスロットの対応
+	static const uint32_t InvalidSlot = 0xffffffff; // 削除済みの粒子
+	uint32_t GetParticleId(uint32_t slot) const { return m_ParticleIds[slot]; }
+	uint32_t GetParticleSlot(uint32_t particleId) const { return (particleId < m_IdToSlot.size()) ? m_IdToSlot[particleId] : InvalidSlot; }
+	const Particle& GetParticleById(uint32_t particleId) const { return m_Particles[m_IdToSlot[particleId]]; }
+	/// <summary>
+	/// 残っている粒子をID順に書き出します (エクスポートやGPUバッファへのアップロード用)
+	/// </summary>
+	void CopyParticlesInIdOrder(std::vector<Particle>& dst) const;
+	/// <summary>
+	/// 残っている粒子をID順に並べたバイト列のハッシュ (FNV-1a 64bit) を返します
+	/// 決定的モードでは、パラメータ・初期配置・ステップ数が同じならスレッド数に関係なく同じ値になる (結果のキャッシュのキーや比較に使う)
+	/// </summary>
+	uint64_t ComputeStateHash() const;
+	/// <summary>
+	/// チェックポイント用に SimulationParam・粒子 (スロット順)・粒子ID・ステップ数・経過時間・DFSPHのκを snapshot に写します
+	/// (CheckpointWriter がステップの間に呼び、書き込みはこのコピーの後にバックグラウンドで行う)
+	/// </summary>
+	void CaptureCheckpoint(CheckpointSnapshot& snapshot) const;
+	/// <summary>
+	/// マップしたチェックポイントから状態を復元します (SimulationParam も置き換え、ソルバーの設定はそのまま)
+	/// 粒子毎の配列へはマップしたページから直接並列にコピーし、スロットの順番も保存した時のままにする
+	/// 決定的モードで近傍リストを使わない場合、続きのステップは保存せずに進めた場合とビット単位で一致する
+	/// </summary>
+	void RestoreCheckpoint(const CheckpointFile& file);
+
+	/// <summary>
+	/// 1サブステップ進めます (RunFluidSolverGrid 相当)
+	/// </summary>
+	void Step();
+
+	/// <summary>
+	/// 圧力の求め方を切り替えます
+	/// DFSPHはグリッドを毎ステップ構築し (近傍リスト・SoAカーネルは使わない)、カーネルには3次スプラインを使う
+	/// 壁は外側が一様に詰まっているとみなして密度と圧力に含める。近傍数が足りないと速度発散の反復は行わないので、Hは粒子間隔の2倍程度にする
+	/// </summary>
+	void SetPressureSolver(PressureSolverMode mode) { m_PressureSolver = mode; }
+	PressureSolverMode GetPressureSolver() const { return m_PressureSolver; }
+	void SetDFSPHParam(const DFSPHParam& param) { m_DFSPHParam = param; }
+	const DFSPHParam& GetDFSPHParam() const { return m_DFSPHParam; }
+	const DFSPHStats& GetDFSPHStats() const { return m_DFSPHStats; }
+	/// <summary>
+	/// PBFの設定。PBFは SimulationParam::DeltaTime で進め (AdvanceFrameのフレームの残り時間だけは守る)、CFL等の条件と速度クランプは使わない
+	/// 1ステップのコストは おおよそ (2 * Iterations + 2) 回の近傍走査
+	/// </summary>
+	void SetPBFParam(const PBFParam& param) { m_PBFParam = param; }
+	const PBFParam& GetPBFParam() const { return m_PBFParam; }
+	const PBFStats& GetPBFStats() const { return m_PBFStats; }
+
+	/// <summary>
+	/// SDFの障害物を設定します (動かす場合は World を変えて毎フレーム設定し直す。SDFは焼き直さない)
+	/// WCSPHの積分では壁と同じペナルティ (めり込んだ深さ × 壁の剛性) の加速度で押し出し (BoundaryMode::Particles では表面の境界粒子で押し返す)、
+	/// DFSPH・PBFでは壁と同じく位置を表面に戻して表面に向かう速度を消す
+	/// </summary>
+	void SetColliders(const std::vector<SDFCollider>& colliders) { m_Colliders = colliders; }
+	const std::vector<SDFCollider>& GetColliders() const { return m_Colliders; }
+
+	/// <summary>
+	/// WCSPHの壁と障害物の扱いを切り替えます
+	/// Particles では壁と障害物の表面に並べた境界粒子を流体と同じセルの別のリストに1回だけ並べておき、密度と圧力・粘性の総和に含める
+	/// (境界粒子の速度は0とみなすので、壁に当たった粒子の勢いは粘性で落ちる。壁にめり込まず、床に粒子が積み重ならない)
+	/// 境界粒子は壁の範囲・H・質量・静止密度・障害物の World が変わった次のステップで並べ直す (障害物を毎フレーム動かすと毎フレーム並べ直す)
+	/// 積分では壁と障害物のペナルティの代わりに、DFSPH と同じく位置を壁と表面に戻す
+	/// </summary>
+	void SetBoundaryMode(BoundaryMode mode) { m_BoundaryMode = mode; }
+	BoundaryMode GetBoundaryMode() const { return m_BoundaryMode; }
+	// BoundaryMode::Penalty の壁と障害物の剛性 (めり込んだ深さに掛ける加速度。既定値は FluidSimCS の wallStiffness と同じ)
+	void SetWallStiffness(float stiffness) { m_WallStiffness = stiffness; }
+	float GetWallStiffness() const { return m_WallStiffness; }
+	void SetBoundaryParticleParam(const BoundaryParticleParam& param) { m_BoundaryParticleParam = param; }
+	const BoundaryParticleParam& GetBoundaryParticleParam() const { return m_BoundaryParticleParam; }
+	// 直近のステップで使った境界粒子 (Particles の間だけ)
+	const BoundaryParticles& GetBoundaryParticles() const { return m_BoundaryParticles; }
+
+	/// <summary>
+	/// frameTime 分だけ時間を進めます
+	/// 固定時間刻みでは DeltaTime のステップを frameTime / DeltaTime 回 (最低1回)、
+	/// 適応時間刻みではステップ毎にCFL・力・粘性の条件から dt を選び、frameTime に達するまで繰り返す
+	/// </summary>
+	/// <returns>実行したサブステップ数</returns>
+	uint32_t AdvanceFrame(float frameTime);
+
+	/// <summary>
+	/// 速度・加速度の最大値からステップ毎に dt を選びます
+	/// 有効な間は FluidSimCS の速度クランプ (maxSpeed) を行わない
+	/// </summary>
+	void SetAdaptiveTimestepEnabled(bool enabled) { m_UseAdaptiveTimestep = enabled; }
+	bool GetAdaptiveTimestepEnabled() const { return m_UseAdaptiveTimestep; }
+	void SetAdaptiveTimestepParam(const AdaptiveTimestepParam& param) { m_AdaptiveTimestepParam = param; }
+	const AdaptiveTimestepParam& GetAdaptiveTimestepParam() const { return m_AdaptiveTimestepParam; }
+	const TimestepStats& GetTimestepStats() const { return m_TimestepStats; }
+	// SetParticles/InitializeParticles からの経過時間
+	double GetSimulatedTime() const { return m_SimulatedTime; }
+
+	const CPUSolverTimings& GetTimings() const { return m_Timings; }
+	uint32_t GetThreadCount() const;
+
+	/// <summary>
+	/// グリッド構築の方法を指定します
+	/// </summary>
+	/// <returns>有効な設定をこのグリッドで使えるか (IsGridBuildModeCompatible)</returns>
+	bool SetGridBuildMode(GridBuildMode mode) { m_GridBuildMode = mode; return IsGridBuildModeCompatible(); }
+	GridBuildMode GetGridBuildMode() const { return m_GridBuildMode; }
+	/// <summary>
+	/// 有効な設定がグリッド構築の方法と組み合わせられるかを返します
+	/// SoAカーネル・対称な力の計算・MortonPartition・NUMA配置はカウンティングソート、決定的モードはリンクリスト以外が必要で、決定的モードでは対称な力の計算は使えない
+	/// 組み合わせられない設定は Step で使われないので、設定の関数はこの結果を返し、Step は assert で止める
+	/// </summary>
+	bool IsGridBuildModeCompatible() const { return GetGridBuildModeConflict() == nullptr; }
+	// 組み合わせられない設定の説明 (組み合わせられる場合は nullptr)
+	const char* GetGridBuildModeConflict() const;
+	// グリッド (セル・バケットと粒子毎のリンク/キー) に確保しているメモリ量
+	size_t GetGridMemoryBytes() const;
+
+	/// <summary>
+	/// intervalステップ毎に粒子の格納順をセルのMorton順に並べ替えます (0で無効)
+	/// </summary>
+	void SetReorderInterval(uint32_t interval) { m_ReorderInterval = interval; }
+	uint32_t GetReorderInterval() const { return m_ReorderInterval; }
+
+	/// <summary>
+	/// 密度・力のパスをSoA + SIMDバッチカーネルで計算します
+	/// セル内の粒子が連続している必要があるため、カウンティングソートのグリッドの時だけ使う
+	/// </summary>
+	/// <returns>今のグリッドで使えるか (IsGridBuildModeCompatible)</returns>
+	bool SetSoAKernelsEnabled(bool enabled) { m_UseSoAKernels = enabled; return IsGridBuildModeCompatible(); }
+	bool GetSoAKernelsEnabled() const { return m_UseSoAKernels; }
+
+	/// <summary>
+	/// 力のパスで粒子ペアを1回だけ評価します (自セルと前方13セルの半分のステンシル)
+	/// ペアの圧力・粘性は両方の粒子に逆向きに加え、スレッド毎のバッファに積算してから合計する
+	/// セル内の粒子が連続している必要があるため、カウンティングソートのグリッドの時だけ使う
+	/// SoAカーネルより優先され、近傍リストが有効な間は使わない
+	/// </summary>
+	/// <returns>今のグリッド・決定的モードの設定で使えるか (IsGridBuildModeCompatible)</returns>
+	bool SetSymmetricForceEnabled(bool enabled) { m_UseSymmetricForce = enabled; return IsGridBuildModeCompatible(); }
+	bool GetSymmetricForceEnabled() const { return m_UseSymmetricForce; }
+
+	/// <summary>
+	/// 位置・速度を CompactParticle (16byte) に量子化して持ち、密度・力のパスは近傍をそこから読みます
+	/// 計算はfloatのまま行い、グリッド構築の後に量子化して (floatの粒子も量子化した値に揃える)、近傍を読む時に戻す
+	/// 近傍1個当たりの読み込みは 密度パスで 48 -> 16byte、力のパスで 48 -> 24byte (密度は CompactDensity から読む)
+	/// SoAカーネル・近傍リストが有効な間は使わない (対称な力の計算が有効な場合は密度パスだけ)
+	/// 既定は無効。デコードの分だけ計算が増えるため、メモリ帯域が律速になる多コアの実行向け
+	/// </summary>
+	void SetCompactStorageEnabled(bool enabled) { m_UseCompactStorage = enabled; }
+	bool GetCompactStorageEnabled() const { return m_UseCompactStorage; }
+	// 直近のステップで量子化した粒子 (スロット順)
+	const std::vector<CompactParticle>& GetCompactParticles() const { return m_CompactParticles; }
+	const CompactParticleCodec& GetCompactParticleCodec() const { return m_CompactCodec; }
+
+	/// <summary>
+	/// 密度・力のパス (AoS・量子化の版) の粒子のスレッドへの割り当て方を指定します
+	/// MortonPartition はグリッド構築の後に毎ステップ区間を引き直す。区間毎の粒子1個当たりの処理時間を前のステップから引き継ぎ、
+	/// 粒子が密集して近傍の多いセルは重く数える。セル内の粒子が連続している必要があるため、カウンティングソートのグリッドの時だけ使う (それ以外は Dynamic と同じ)
+	/// </summary>
+	/// <returns>今のグリッドで使えるか (IsGridBuildModeCompatible)</returns>
+	bool SetWorkSchedule(WorkSchedule schedule) { m_WorkSchedule = schedule; return IsGridBuildModeCompatible(); }
+	WorkSchedule GetWorkSchedule() const { return m_WorkSchedule; }
+	const LoadBalanceStats& GetLoadBalanceStats() const { return m_LoadBalanceStats; }
+
+	/// <summary>
+	/// 結果がビット単位で再現する決定的モードにします (スレッド数・スケジュールを変えても粒子の状態が一致する)
+	/// グリッド構築後にセル (空間ハッシュではバケット) 内の粒子を粒子ID順に並べ直すので、近傍の総和の順番は位置とIDだけで決まる
+	/// リンクリストのグリッドではセル内の順番がスレッドの実行順で変わるので、有効にした時にリンクリストならカウンティングソートに切り替える
+	/// スレッド毎のバッファを合計する対称な力の計算とは組み合わせられない
+	/// (リダクションは ThreadPool::ParallelReduce がスレッド数によらない順番で畳み込む)
+	/// </summary>
+	/// <returns>今のグリッド・対称な力の計算の設定で使えるか (IsGridBuildModeCompatible)</returns>
+	bool SetDeterministicEnabled(bool enabled);
+	bool GetDeterministicEnabled() const { return m_Deterministic; }
+
+	/// <summary>
+	/// NUMAノードを考慮してスレッドとメモリを配置します
+	/// スレッドはノード毎に連続した番号のブロックで論理CPUに固定し、スロットを GroupSize 粒子のチャンク単位でスレッド数に等分した区間を各スレッドの持ち分にする
+	/// 粒子毎の配列 (粒子・ID・セル・近傍リスト) は、確保し直した後に持ち主のスレッドが最初に書き込んでそのノードにページを置く
+	/// スロットがセル順に並んでいる必要があるため、カウンティングソートのグリッドの時だけ使える。持ち分はセル順に連続したセルの塊になり、
+	/// グリッドのセルの配列も、持ち分の粒子が入っているセルの範囲を持ち主のスレッドが書き込む (最初のグリッド構築の前はセル数で等分し、構築後に置き直す)
+	/// スロット毎のパス (グリッド構築・密度・力・積分・近傍リスト) は持ち分の区間だけを処理する
+	/// 保証されないこと: 持ち分はセルの行優先の順で粒子数を等分するだけなので、塊の境界の近傍は他のノードのメモリを読み、
+	/// その量が境界の粒子 (ハロー) だけに収まるような空間の分割はしていない。複数ソケットでの帯域の改善も測定していない
+	/// 有効な間は SetWorkSchedule の割り当てより優先される
+	/// </summary>
+	/// <returns>今のグリッドで使えるか (IsGridBuildModeCompatible)</returns>
+	bool SetNumaPlacementEnabled(bool enabled);
+	bool GetNumaPlacementEnabled() const { return m_UseNumaPlacement; }
+	const NumaTopology& GetNumaTopology() const { return m_NumaTopology; }
+	// スレッドのノード (NumaTopology のインデックス。NUMA配置が無効な場合は0)
+	uint32_t GetThreadNode(uint32_t threadIndex) const { return m_UseNumaPlacement ? m_ThreadNodes[threadIndex] : 0; }
+	/// <summary>
+	/// スレッド毎に、持ち分の区間の粒子のページのうちスレッドのノードに置かれている割合を求めます (Linuxのみ)
+	/// </summary>
+	/// <returns>全スレッドの割合 (ページの問い合わせができない場合は負の値)</returns>
+	float MeasureLocalPageFraction(std::vector<float>& threadFractions) const;
+
+	/// <summary>
+	/// SoAカーネルの命令セットを指定します (既定はDetectSIMDLevel、CPUが未対応なら下げる)
+	/// </summary>
+	void SetSIMDLevel(SIMDLevel level) { m_pBatchKernels = &GetSPHBatchKernels(level); }
+	SIMDLevel GetSIMDLevel() const { return m_pBatchKernels->Level; }
+
+	/// <summary>
+	/// 半径 H + skin の近傍リスト (Verletリスト) を使います (0で無効)
+	/// リストは粒子が skin/2 より動くまで使い回し、その間はグリッドの構築とセル走査を省略する
+	/// 有効な間はSoAカーネルより優先される
+	/// </summary>
+	void SetNeighborListSkin(float skin);
+	float GetNeighborListSkin() const { return m_NeighborListSkin; }
+	// これまでに近傍リストを構築した回数
+	uint32_t GetNeighborListBuildCount() const { return m_NeighborListBuildCount; }
+
+private:
+	void ReserveParticleCapacity(uint32_t particleCount);
+	// 粒子毎の作業配列を m_Particles の数に合わせる
+	void ResizeParticleArrays();
+	void UpdateGridDim();
+	void EnsureGridCapacity();
+	void ClearGrid();
+	void ClearCellCount(uint32_t bucketCount);
+	void BuildGrid();
+	void BuildGridLinkedList();
+	void BuildGridCountingSort();
+	void BuildGridSpatialHash();
+	void UpdateCellMortonRank();
+	/// <summary>
+	/// Morton順のセルの (粒子数 × m_CellCost) の合計をスレッド数で等分する位置で、区間 m_PartitionStart を引き直します
+	/// </summary>
+	void UpdateWorkPartitions();
+	/// <summary>
+	/// [0, 粒子数) を m_WorkSchedule に従ってスレッドに分けて func(begin, end) を実行し、スレッド毎の処理時間と粒子数を積算します
+	/// </summary>
+	void ParallelForParticles(const std::function<void(uint32_t, uint32_t)>& func);
+	// 積算したスレッド毎の処理時間から LoadBalanceStats を求め、区間毎の処理時間をセルのコストに反映する
+	void UpdateLoadBalanceStats();
+	// NUMA配置でのスレッドの持ち分 (count 個のスロットを GroupSize のチャンク単位で等分した区間)
+	void GetOwnedSlotRange(uint32_t threadIndex, uint32_t count, uint32_t& begin, uint32_t& end) const;
+	/// <summary>
+	/// ParallelFor(0, count, GroupSize, func) と同じ GroupSize 粒子のチャンクで func(begin, end) を実行します
+	/// NUMA配置では各スレッドが持ち分の区間のチャンクだけを処理する
+	/// </summary>
+	void ParallelForSlots(uint32_t count, const std::function<void(uint32_t, uint32_t)>& func);
+	// 粒子毎の配列とセルの配列が確保し直されていたら、持ち主のスレッドが書き込んだ配列に置き換える
+	void UpdateNumaPlacement();
+	/// <summary>
+	/// array を書き込まずに確保した配列へ、スレッド毎に持ち分の区間をコピーして置き換えます (容量は capacity にする)
+	/// 持ち分は要素数を GetOwnedSlotRange で分けた区間 (pOwnedStart を渡した場合はスレッド t の区間が [pOwnedStart[t], pOwnedStart[t + 1]))、
+	/// 要素数を超えた容量の部分はスレッド数で等分する
+	/// </summary>
+	template<typename Array>
+	void PlaceArray(Array& array, size_t capacity, const std::vector<uint32_t>* pOwnedStart = nullptr);
+	// NUMA配置でのセルの持ち分 m_OwnedCellStart を、持ち分のスロットの粒子が入っているセルの範囲から求める
+	void UpdateOwnedCells(uint32_t cellCount, bool followSlots);
+	void ReorderParticles();
+
+	/// <summary>
+	/// bucketOf(slot) のバケット毎に粒子をカウンティングソートし、IDとスロットの対応も更新します
+	/// m_CellCount は0クリア済みであること。結果のバケット開始位置は m_CellStart に入る
+	/// </summary>
+	template<typename BucketFunc>
+	void CountingSortParticles(uint32_t bucketCount, BucketFunc&& bucketOf);
+	// 決定的モード: バケット内の粒子を粒子ID順に並べ直す (カウントのアトミック操作で決まった順番を消す)
+	void SortBucketsById(uint32_t bucketCount);
+	void ComputeDensity();
+	void ComputeForce();
+	void ComputeDensitySoA();
+	void ComputeForceSoA();
+	void ComputeForceSymmetric();
+	// 粒子を量子化して m_CompactParticles に保存し、floatの位置・速度を量子化後の値にする
+	void StoreCompactParticles();
+	void ComputeDensityCompact();
+	void ComputeForceCompact();
+	bool NeedsNeighborListRebuild() const;
+	/// <summary>
+	/// グリッドを1回走査して近傍リストを作り、同時に密度・圧力も求めます
+	/// </summary>
+	void BuildNeighborList();
+	void StoreDensity(uint32_t slot, float density, float nearDensity);
+	void ComputeDensityNeighborList();
+	void ComputeForceNeighborList();
+	/// <summary>
+	/// 粒子の速度・加速度の最大値 (並列リダクション) から、このステップの dt を求めます
+	/// </summary>
+	float ComputeAdaptiveTimestep();
+	void Integrate(float deltaTime);
+	// 障害物の中に入った位置を表面に戻し、pVelocity があれば表面に向かう速度成分を消す (SPHCommon::ClampToWalls の障害物版)
+	void ProjectOutOfColliders(Vector3D& position, Vector3D* pVelocity) const;
+	// 入力が変わっていれば境界粒子を並べ直す
+	void UpdateBoundaryParticles();
+	/// <summary>
+	/// 密度のパスの後に境界粒子の密度を加えて圧力を求め直します (SoA・量子化の密度の配列も更新する)
+	/// </summary>
+	void AddBoundaryDensity(bool useSoA, bool useCompact);
+	// 力のパスの後に境界粒子からの圧力を加える
+	void AddBoundaryForce();
+	void RecordTimestep(float deltaTime);
+	/// <summary>
+	/// グリッドから半径H以内の近傍 (自分を除く) を m_StepNeighbors に列挙します
+	/// </summary>
+	void BuildStepNeighborList();
+
+	// DFSPH (CPUFluidSolverDFSPH.cpp)
+	/// <summary>
+	/// DFSPHで1ステップ進め、使った時間刻みを返します
+	/// </summary>
+	float StepDFSPH();
+	/// <summary>
+	/// 近傍を列挙して V * ∇W を求め、密度比と係数 α = -1 / (|Σ V∇W|^2 + Σ |V∇W|^2) を求めます
+	/// </summary>
+	void BuildDFSPHNeighbors();
+	void ComputeDFSPHNonPressureForce();
+	// 速度発散 (divergence = true) または予測密度 (false) の反復
+	void SolveDFSPH(float deltaTime, bool divergence);
+	// 現在の速度から m_DensityAdv を求め、誤差の平均を返す
+	float ComputeDFSPHDensityAdvection(float deltaTime, bool divergence);
+	// m_DFSPHStiffness (κ) による圧力で速度を修正する
+	void ApplyDFSPHPressure(float deltaTime);
+	void IntegrateDFSPH(float deltaTime);
+
+	// PBF (CPUFluidSolverPBF.cpp)
+	/// <summary>
+	/// PBFで1ステップ進め、使った時間刻みを返します
+	/// </summary>
+	float StepPBF();
+	/// <summary>
+	/// 予測位置の密度から λ = -C / (Σ|∇C|^2 + ε) を求め、平均の圧縮率を返します
+	/// </summary>
+	float ComputePBFLambda();
+	// Δp = (m/ρ0) Σ (λi + λj + s_corr) ∇W を求めて予測位置に加える
+	void ApplyPBFDelta();
+	// 位置の変化から速度を求め、XSPH粘性を加える
+	void UpdatePBFVelocity(float deltaTime);
+
+	/// <summary>
+	/// gridPos周囲27セルに登録されている粒子IDを順に func(neighborId) へ渡します
+	/// </summary>
+	template<typename Func>
+	void ForEachNeighbor(const SPHCommon::GridPos& gridPos, Func&& func) const
+	{
+		if (m_GridBuildMode == GridBuildMode::SpatialHash)
+		{
+			ForEachNeighborHashed(gridPos, func);
+			return;
+		}
+		for (int z = -1; z <= 1; ++z)
+		{
+			for (int y = -1; y <= 1; ++y)
+			{
+				for (int x = -1; x <= 1; ++x)
+				{
+					SPHCommon::GridPos neighborGridPos = { gridPos.x + x, gridPos.y + y, gridPos.z + z };
+					int gridIndex = SPHCommon::GetGridIndex(neighborGridPos, m_GridDim);
+					if (gridIndex == -1)
+					{
+						continue;
+					}
+					if (m_GridBuildMode == GridBuildMode::CountingSort)
+					{
+						// セル内の粒子は連続しているので順番に読むだけ
+						uint32_t cellEnd = m_CellStart[gridIndex + 1];
+						for (uint32_t neighborId = m_CellStart[gridIndex]; neighborId < cellEnd; ++neighborId)
+						{
+							func(static_cast<int>(neighborId));
+						}
+					}
+					else
+					{
+						for (int neighborId = m_GridHead[gridIndex].load(std::memory_order_relaxed);
+							neighborId != -1; neighborId = m_GridNext[neighborId])
+						{
+							func(neighborId);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// 空間ハッシュ版の ForEachNeighbor (壁の範囲に関係なく27セルを探索する)
+	/// </summary>
+	template<typename Func>
+	void ForEachNeighborHashed(const SPHCommon::GridPos& gridPos, Func&& func) const
+	{
+		for (int z = -1; z <= 1; ++z)
+		{
+			for (int y = -1; y <= 1; ++y)
+			{
+				for (int x = -1; x <= 1; ++x)
+				{
+					SPHCommon::GridPos neighborGridPos = { gridPos.x + x, gridPos.y + y, gridPos.z + z };
+					uint32_t bucket = SPHCommon::HashGridPos(neighborGridPos, m_HashBucketCount);
+					uint64_t cellKey = SPHCommon::GetCellKey(neighborGridPos);
+					// 同じバケットに入った別のセルの粒子は飛ばす
+					uint32_t bucketEnd = m_CellStart[bucket + 1];
+					for (uint32_t neighborId = m_CellStart[bucket]; neighborId < bucketEnd; ++neighborId)
+					{
+						if (m_ParticleCellKey[neighborId] == cellKey)
+						{
+							func(static_cast<int>(neighborId));
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// gridPos周囲27セルを、x方向に隣接する3セルずつ連続したスロット範囲 func(begin, end) として渡します
+	/// カウンティングソート後はセルがx, y, zの順に並んでいるので、3セル分が1つの範囲になる
+	/// </summary>
+	template<typename Func>
+	void ForEachNeighborRow(const SPHCommon::GridPos& gridPos, Func&& func) const
+	{
+		int minX = std::max(gridPos.x - 1, 0);
+		int maxX = std::min(gridPos.x + 1, m_GridDim.x - 1);
+		if (minX > maxX)
+		{
+			return;
+		}
+		for (int z = gridPos.z - 1; z <= gridPos.z + 1; ++z)
+		{
+			for (int y = gridPos.y - 1; y <= gridPos.y + 1; ++y)
+			{
+				if (y < 0 || y >= m_GridDim.y || z < 0 || z >= m_GridDim.z)
+				{
+					continue;
+				}
+				int rowIndex = (z * m_GridDim.y + y) * m_GridDim.x;
+				uint32_t begin = m_CellStart[rowIndex + minX];
+				uint32_t end = m_CellStart[rowIndex + maxX + 1];
+				if (begin < end)
+				{
+					func(begin, end);
+				}
+			}
+		}
+	}
+
+	// 密度・力のパスで使うカーネルの組み合わせ (コンパイル時に差し替える)
+	using Kernels = SPHKernels::DefaultKernelSet;
+	// DFSPHの密度と勾配のカーネル (同じカーネルを使う必要がある)
+	using DFSPHKernel = SPHKernels::CubicSpline;
+
+	// ParallelForの分割単位 (Compute Shaderの numthreads(256, 1, 1) に合わせる)
+	static const uint32_t GroupSize = 256;
+
+	std::unique_ptr<ThreadPool> m_pThreadPool;
+
+	SimulationParam m_SimParam = {};
+	SPHCommon::GridPos m_GridDim;
+	uint32_t m_TotalGridCount = 0;
+	float m_GridCellSize = 0.0f; // H (近傍リスト使用時は H + skin)
+
+	ParticleArray m_Particles;
+	uint32_t m_ParticleCapacity = 0;
+	uint32_t m_ParticleReallocationCount = 0;
+	std::unique_ptr<std::atomic<int32_t>[]> m_GridHead; // グリッドの先頭ID
+	uint32_t m_GridHeadCapacity = 0;
+	UninitializedVector<int32_t> m_GridNext; // 次のパーティクルID
+
+	// カウンティングソート用
+	// セルcの粒子は [m_CellStart[c], m_CellStart[c + 1]) の範囲 (cellEnd = 次のセルのcellStart)
+	// 末尾のセル(m_TotalGridCount)はグリッド外に出た粒子用
+	GridBuildMode m_GridBuildMode = GridBuildMode::LinkedList;
+	std::unique_ptr<std::atomic<uint32_t>[]> m_CellCount;
+	uint32_t m_CellCountCapacity = 0;
+	UninitializedVector<uint32_t> m_CellStart;
+	UninitializedVector<uint32_t> m_ParticleCell; // 粒子毎のセルインデックス
+	UninitializedVector<uint32_t> m_ParticleRank; // セル内での書き込み位置
+	ParticleArray m_SortedParticles; // スキャッタ先 (構築後にm_Particlesと入れ替える)
+
+	// 空間ハッシュ用 (バケットbの粒子は [m_CellStart[b], m_CellStart[b + 1]) の範囲)
+	uint32_t m_HashBucketCount = 0;
+	std::vector<uint64_t> m_ParticleCellKey; // スロット毎のセルキー
+
+	// 粒子IDとスロットの対応
+	UninitializedVector<uint32_t> m_ParticleIds; // スロット -> ID
+	std::vector<uint32_t> m_IdToSlot;    // ID -> スロット (削除済みはInvalidSlot)
+	UninitializedVector<uint32_t> m_SortedIds;
+
+	// Morton順の並べ替え
+	uint32_t m_ReorderInterval = 0;
+	uint64_t m_StepCount = 0;
+	std::vector<uint32_t> m_CellMortonRank; // セル -> Morton順での順位
+	std::vector<uint32_t> m_MortonCells;    // Morton順での順位 -> セル
+	SPHCommon::GridPos m_MortonGridDim;     // m_CellMortonRankを作成した時のグリッド次元
+
+	// スレッドへの割り当て (スレッドpの区間はMorton順の [m_PartitionStart[p], m_PartitionStart[p + 1]))
+	WorkSchedule m_WorkSchedule = WorkSchedule::Dynamic;
+	bool m_UsedWorkPartitions = false; // このステップの密度・力のパスで区間を使った
+	std::vector<uint32_t> m_PartitionStart;
+	std::vector<float> m_CellCost; // Morton順のセル毎の粒子1個当たりの相対コスト (平均1)
+	std::vector<double> m_ThreadWorkMilliseconds;
+	std::vector<uint32_t> m_ThreadWorkParticles;
+	LoadBalanceStats m_LoadBalanceStats;
+
+	bool m_Deterministic = false;
+
+	// NUMA配置
+	bool m_UseNumaPlacement = false;
+	NumaTopology m_NumaTopology;
+	std::vector<uint32_t> m_ThreadNodes;
+	const void* m_pPlacedParticles = nullptr; // 最後に配置した時の m_Particles の先頭 (確保し直されたら配置し直す)
+	uint32_t m_PlacedParticleCount = 0;
+	const void* m_pPlacedCells = nullptr;
+	// スレッド t のセルの持ち分は [m_OwnedCellStart[t], m_OwnedCellStart[t + 1]) (セルの配列を置いた時に求める)
+	std::vector<uint32_t> m_OwnedCellStart;
+	bool m_CellsFollowSlots = false; // 持ち分をソート済みのセルの並びから求めたか (false ならセル数の等分)
+	uint32_t m_SortedBucketCount = 0; // 最後にカウンティングソートした時のバケット数
+
+	// SoA + SIMDバッチカーネル
+	bool m_UseSoAKernels = false;
+	const SPHBatchKernels* m_pBatchKernels = nullptr;
+	ParticleSoA m_SoA;
+
+	// 対称な力の計算 (スレッド毎の力の積算バッファ。合計する時に0に戻す)
+	bool m_UseSymmetricForce = false;
+	std::vector<std::vector<Vector3D>> m_ThreadForces;
+	std::vector<uint8_t> m_ThreadForceUsed; // このステップで書き込んだスレッド
+
+	// 量子化した粒子 (スロット順、密度パスの最初に作り直す)
+	bool m_UseCompactStorage = false;
+	CompactParticleCodec m_CompactCodec;
+	std::vector<CompactParticle> m_CompactParticles;
+	std::vector<CompactDensity> m_CompactDensity;
+
+	// 近傍リスト (粒子slotの近傍は m_NeighborSlots[m_NeighborStart[slot] .. m_NeighborStart[slot + 1]))
+	float m_NeighborListSkin = 0.0f;
+	bool m_NeighborListValid = false;
+	uint32_t m_NeighborListBuildCount = 0;
+	UninitializedVector<uint32_t> m_NeighborStart;
+	UninitializedVector<uint32_t> m_NeighborSlots;
+	UninitializedVector<float> m_NeighborDistance; // 密度パスで求めた距離 (力のパスで再利用)
+	std::vector<Vector3D> m_NeighborListPositions; // 構築時の位置
+	// 構築中のParallelForのチャンク (GroupSize粒子) 毎の一時バッファ
+	struct NeighborChunk
+	{
+		std::vector<uint32_t> Slots;
+		std::vector<float> Distance;
+	};
+	std::vector<NeighborChunk> m_NeighborChunks;
+
+	// 適応時間刻み
+	bool m_UseAdaptiveTimestep = false;
+	AdaptiveTimestepParam m_AdaptiveTimestepParam;
+	TimestepStats m_TimestepStats;
+	float m_StepTimeLimit = 0.0f; // AdvanceFrame中のフレームの残り時間 (0で制限なし)
+	double m_SimulatedTime = 0.0;
+
+	// DFSPH/PBFでステップ毎に作る半径Hの近傍 (粒子slotの近傍は m_StepNeighbors[m_StepNeighborStart[slot] .. m_StepNeighborStart[slot + 1]))
+	// 反復中は同じ近傍を使い回す
+	std::vector<uint32_t> m_StepNeighborStart;
+	std::vector<uint32_t> m_StepNeighbors;
+
+	// DFSPH
+	PressureSolverMode m_PressureSolver = PressureSolverMode::WCSPH;
+	DFSPHParam m_DFSPHParam;
+	DFSPHStats m_DFSPHStats;
+	float m_PrevDeltaTime = 0.0f; // 速度発散の反復は前のステップの時間刻みで行う
+	std::vector<Vector3D> m_DFSPHGradients; // V * ∇W(x_i - x_j)
+	std::vector<Vector3D> m_DFSPHWallGradients; // 壁の ∇∫W dV (スロット毎、6面の合計)
+	SPHKernels::WallIntegralTable<DFSPHKernel> m_DFSPHWallTable; // Hが変わった時に作り直す
+	std::vector<float> m_DFSPHDensity;      // ρ/ρ0 (スロット毎)
+	std::vector<float> m_DFSPHFactor;       // α (スロット毎)
+	std::vector<float> m_DensityAdv;        // 予測密度比 (圧力の反復) または密度変化率 (速度発散の反復)
+	std::vector<float> m_DFSPHStiffness;    // 反復中のκ (スロット毎)
+	// 次のステップのウォームスタート用のκ * dt^2 (速度発散はκ * dt)。並べ替えに影響されないよう粒子ID毎に持つ
+	std::vector<float> m_DFSPHKappa;
+	std::vector<float> m_DFSPHKappaV;
+
+	// PBF
+	PBFParam m_PBFParam;
+	PBFStats m_PBFStats;
+	std::vector<Vector3D> m_PBFPreviousPositions; // ステップ開始時の位置 (グリッド構築で並べ替わるので粒子ID毎)
+	std::vector<float> m_PBFLambda;     // スロット毎
+	std::vector<Vector3D> m_PBFDelta;   // Δp、XSPHの速度 (スロット毎)
+	std::vector<Vector3D> m_PBFWallGradients; // 壁による ∇C (スロット毎)
+	SPHKernels::WallIntegralTable<Kernels::Density> m_PBFWallTable;
+
+	// SDFの障害物 (SDF本体は呼び出し側が持つ)
+	std::vector<SDFCollider> m_Colliders;
+
+	// 境界粒子
+	BoundaryMode m_BoundaryMode = BoundaryMode::Penalty;
+	float m_WallStiffness = 6000.0f;
+	BoundaryParticleParam m_BoundaryParticleParam;
+	BoundaryParticles m_BoundaryParticles;
+	static_assert(std::is_same<Kernels::Density, BoundaryParticles::DensityKernel>::value, "boundary Psi must use the density kernel");
+
+	CPUSolverTimings m_Timings;
+};
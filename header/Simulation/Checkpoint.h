@@ -0,0 +1,132 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+#include "Simulation/AlignedAllocator.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+class CPUFluidSolver;
+
+// チェックポイントファイルの先頭 (ファイルのバイト列をそのまま読むので、書いた環境と構造体のレイアウトが同じである必要がある)
+// 配列はそれぞれ CheckpointPageSize に揃えたオフセットに置き、マップしたページをそのままポインタとして使える
+struct CheckpointHeader
+{
+	char Magic[8];           // CheckpointMagic
+	uint32_t Version;        // CheckpointVersion
+	uint32_t HeaderSize;     // sizeof(CheckpointHeader)
+	uint32_t ParticleSize;   // sizeof(Particle)
+	uint32_t ParticleCount;
+	uint32_t IdCount;        // 振った粒子IDの数 (削除済みを含む)
+	uint32_t KappaCount;     // DFSPHのウォームスタート用のκの数 (IdCount または 0)
+	uint64_t StepCount;      // Morton順の並べ替えの間隔を数えるステップ数
+	double SimulatedTime;
+	float PrevDeltaTime;     // DFSPHの速度発散の反復に使う前のステップの時間刻み
+	uint32_t Reserved;
+	uint64_t ParticleOffset;   // 粒子 (スロット順)
+	uint64_t ParticleIdOffset; // スロット -> 粒子ID
+	uint64_t KappaOffset;      // κ * dt^2 (粒子ID毎)
+	uint64_t KappaVOffset;     // κ * dt (粒子ID毎)
+	uint64_t FileSize;       // 途中で切れたファイルを検出する
+	SimulationParam Param;   // 壁の範囲 (WallMin/WallMax) を含む
+};
+
+static const char CheckpointMagic[8] = { 'T', 'F', 'S', 'C', 'K', 'P', 'T', '\0' };
+static const uint32_t CheckpointVersion = 1;
+static const uint64_t CheckpointPageSize = 4096;
+
+// ソルバーから写したチェックポイントの内容 (オフセットとファイルサイズは書き込み時に埋める)
+struct CheckpointSnapshot
+{
+	CheckpointHeader Header = {};
+	UninitializedVector<Particle> Particles;
+	UninitializedVector<uint32_t> ParticleIds;
+	std::vector<float> Kappa;
+	std::vector<float> KappaV;
+};
+
+/// <summary>
+/// チェックポイントをバックグラウンドのスレッドで書き込みます
+/// ソルバーを止めるのは状態を CheckpointSnapshot に写す間だけで、ファイルへの書き込みはステップと並行して進む
+/// 書き込みは path.tmp に行い、書き終えてから path に置き換えるので、途中で落ちても前のチェックポイントは残る
+/// </summary>
+class CheckpointWriter
+{
+public:
+	CheckpointWriter() = default;
+	CheckpointWriter(const CheckpointWriter&) = delete;
+	CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+	~CheckpointWriter();
+
+	/// <summary>
+	/// solver の状態を写して、path への書き込みを始めます (ステップの間に呼ぶ)
+	/// </summary>
+	/// <returns>前の書き込みが終わっていない場合は何もせず false</returns>
+	bool WriteAsync(const CPUFluidSolver& solver, const std::string& path);
+	/// <summary>
+	/// capture(snapshot) で状態を写して書き込みを始めます (GPUのバッファを読み戻す場合など、ソルバー以外から書く場合に使う)
+	/// </summary>
+	bool WriteAsync(const std::function<void(CheckpointSnapshot&)>& capture, const std::string& path);
+	bool IsBusy() const { return m_Busy.load(std::memory_order_acquire); }
+	/// <summary>
+	/// 書き込み中なら終わるまで待ちます
+	/// </summary>
+	/// <returns>最後の書き込みに成功した (または書き込んでいない) 場合は true</returns>
+	bool Wait();
+
+	// 直近の書き込みの、状態を写した時間 (ソルバーを止めた時間) とファイルへの書き込みの時間 (ミリ秒)
+	double GetCaptureMilliseconds() const { return m_CaptureMilliseconds; }
+	double GetWriteMilliseconds() const { return m_WriteMilliseconds; }
+
+	/// <summary>
+	/// snapshot を path に書き込みます (呼び出したスレッドで書き終えるまで戻らない)
+	/// </summary>
+	static bool Write(CheckpointSnapshot& snapshot, const std::string& path);
+
+private:
+	CheckpointSnapshot m_Snapshot; // 書き込み中はバックグラウンドのスレッドだけが読む
+	std::thread m_Thread;
+	std::atomic<bool> m_Busy{ false };
+	bool m_Result = true;
+	double m_CaptureMilliseconds = 0.0;
+	double m_WriteMilliseconds = 0.0;
+};
+
+/// <summary>
+/// チェックポイントファイルを読み取り専用でメモリにマップします (Windowsは CreateFileMapping、それ以外は mmap)
+/// 配列はファイルのページを指すポインタで返し、読み込み用のバッファにはコピーしない
+/// </summary>
+class CheckpointFile
+{
+public:
+	CheckpointFile() = default;
+	CheckpointFile(const CheckpointFile&) = delete;
+	CheckpointFile& operator=(const CheckpointFile&) = delete;
+	~CheckpointFile() { Close(); }
+
+	/// <summary>
+	/// ファイルをマップし、ヘッダー (マジック・バージョン・構造体のサイズ・配列の範囲) と粒子のID (範囲と重複) を検証します
+	/// </summary>
+	/// <returns>開けない場合や形式が違う場合は false</returns>
+	bool Open(const std::string& path);
+	void Close();
+	bool IsOpen() const { return m_pData != nullptr; }
+
+	const CheckpointHeader& GetHeader() const { return *reinterpret_cast<const CheckpointHeader*>(m_pData); }
+	const Particle* GetParticles() const { return reinterpret_cast<const Particle*>(m_pData + GetHeader().ParticleOffset); }
+	const uint32_t* GetParticleIds() const { return reinterpret_cast<const uint32_t*>(m_pData + GetHeader().ParticleIdOffset); }
+	// κが保存されていない場合は nullptr
+	const float* GetKappa() const { return GetHeader().KappaCount > 0 ? reinterpret_cast<const float*>(m_pData + GetHeader().KappaOffset) : nullptr; }
+	const float* GetKappaV() const { return GetHeader().KappaCount > 0 ? reinterpret_cast<const float*>(m_pData + GetHeader().KappaVOffset) : nullptr; }
+
+private:
+	bool Validate() const;
+
+	const uint8_t* m_pData = nullptr;
+	size_t m_Size = 0;
+#if defined(_WIN32)
+	HANDLE m_File = INVALID_HANDLE_VALUE;
+	HANDLE m_Mapping = nullptr;
+#endif
+};
@@ -0,0 +1,188 @@
+#pragma once
+#include "pch.h"
+#include "Math/Vector3D.h"
+
+// 半精度浮動小数点 (IEEE 754 binary16) との変換
+// 速度の保存用なので、範囲外は最大値 (±65504) に飽和させ、Inf/NaNは扱わない
+namespace HalfFloat
+{
+	// 最近接偶数丸め
+	inline uint16_t FromFloat(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		uint32_t sign = (bits >> 16) & 0x8000;
+		uint32_t absBits = bits & 0x7fffffff;
+
+		// 65520以上は丸めるとInfになるので最大値にする
+		if (absBits >= 0x477ff000)
+		{
+			return static_cast<uint16_t>(sign | 0x7bff);
+		}
+		// 2^-14 未満は非正規化数
+		if (absBits < 0x38800000)
+		{
+			// 2^-25 以下は0に丸める
+			if (absBits <= 0x33000000)
+			{
+				return static_cast<uint16_t>(sign);
+			}
+			uint32_t exponent = absBits >> 23;
+			uint32_t mantissa = (absBits & 0x7fffff) | 0x800000;
+			uint32_t shift = 126 - exponent;
+			uint32_t half = mantissa >> shift;
+			uint32_t remainder = mantissa & ((1u << shift) - 1);
+			uint32_t halfway = 1u << (shift - 1);
+			if (remainder > halfway || (remainder == halfway && (half & 1)))
+			{
+				++half; // 繰り上がって最小の正規化数になる場合もそのままで正しい
+			}
+			return static_cast<uint16_t>(sign | half);
+		}
+		// 指数のバイアスを 127 -> 15 に付け替え、仮数の下位13bitを丸める
+		uint32_t half = (absBits - 0x38000000) >> 13;
+		uint32_t remainder = absBits & 0x1fff;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+		{
+			++half;
+		}
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	// 指数と仮数をfloatの位置へずらし、指数のバイアスを 15 -> 127 に付け替える
+	// 非正規化数は 2^-14 を足した正規化数から 2^-14 を引いて戻す (floatの非正規化数の演算は遅いので避ける)
+	inline float ToFloat(uint16_t half)
+	{
+		uint32_t bits = ((static_cast<uint32_t>(half) & 0x7fff) << 13) + 0x38000000;
+		float value;
+		if ((half & 0x7c00) == 0)
+		{
+			bits += 0x00800000;
+			std::memcpy(&value, &bits, sizeof(value));
+			value -= 6.103515625e-05f; // 2^-14
+			std::memcpy(&bits, &value, sizeof(bits));
+		}
+		bits |= (static_cast<uint32_t>(half) & 0x8000) << 16;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+// 量子化した粒子の保存形式 (16byte、Particle の1/3)
+// 位置はセル座標 (各軸10bit) とセル内の16bit固定小数点、速度は半精度
+// 密度・圧力・力は毎ステップ計算し直すので持たない
+struct CompactParticle
+{
+	uint32_t Cell;        // x | y << 10 | z << 20 (各軸 CompactParticleCodec::CellBias だけずらす)
+	uint16_t Offset[3];   // セル内の位置 (セルの幅を65536等分した区間の番号)
+	uint16_t Velocity[3]; // 半精度
+};
+static_assert(sizeof(CompactParticle) == 16, "CompactParticle must be 16 bytes");
+
+// 力のパスで近傍から読む密度 (圧力は密度から求め直す)
+struct CompactDensity
+{
+	float Density;
+	float NearDensity;
+};
+
+/// <summary>
+/// CompactParticle と float の位置・速度の変換
+/// セルは origin から cellSize 間隔の格子で、各軸 -CellBias ～ CellBias - 1 個目のセルまで表せる (範囲外は端のセルに寄せる)
+/// 位置の誤差は最大 cellSize / 131072 (区間の中央に戻す)、速度の相対誤差は最大 2^-11
+/// </summary>
+class CompactParticleCodec
+{
+public:
+	static const int CellBits = 10;
+	static const int CellBias = 1 << (CellBits - 1);
+	static const uint32_t CellMask = (1u << CellBits) - 1;
+
+	// セル座標とセル内の位置をつなげた固定小数点の座標 (各軸26bit、1 = cellSize / 65536)
+	struct FixedPosition
+	{
+		int32_t x;
+		int32_t y;
+		int32_t z;
+	};
+
+	CompactParticleCodec() = default;
+	CompactParticleCodec(const Vector3D& origin, float cellSize)
+		: m_Origin(origin), m_CellSize(cellSize), m_InvCellSize(1.0 / cellSize), m_Quantum(cellSize / 65536.0f)
+	{
+	}
+
+	CompactParticle Encode(const Vector3D& position, const Vector3D& velocity) const
+	{
+		CompactParticle result;
+		uint32_t cellX = EncodeAxis(position.x, m_Origin.x, result.Offset[0]);
+		uint32_t cellY = EncodeAxis(position.y, m_Origin.y, result.Offset[1]);
+		uint32_t cellZ = EncodeAxis(position.z, m_Origin.z, result.Offset[2]);
+		result.Cell = cellX | (cellY << CellBits) | (cellZ << (CellBits * 2));
+		result.Velocity[0] = HalfFloat::FromFloat(velocity.x);
+		result.Velocity[1] = HalfFloat::FromFloat(velocity.y);
+		result.Velocity[2] = HalfFloat::FromFloat(velocity.z);
+		return result;
+	}
+
+	Vector3D DecodePosition(const CompactParticle& particle) const
+	{
+		return Vector3D(
+			DecodeAxis(particle.Cell & CellMask, particle.Offset[0], m_Origin.x),
+			DecodeAxis((particle.Cell >> CellBits) & CellMask, particle.Offset[1], m_Origin.y),
+			DecodeAxis((particle.Cell >> (CellBits * 2)) & CellMask, particle.Offset[2], m_Origin.z));
+	}
+
+	Vector3D DecodeVelocity(const CompactParticle& particle) const
+	{
+		return Vector3D(
+			HalfFloat::ToFloat(particle.Velocity[0]),
+			HalfFloat::ToFloat(particle.Velocity[1]),
+			HalfFloat::ToFloat(particle.Velocity[2]));
+	}
+
+	FixedPosition ToFixed(const CompactParticle& particle) const
+	{
+		return {
+			static_cast<int32_t>(((particle.Cell & CellMask) << 16) | particle.Offset[0]),
+			static_cast<int32_t>((((particle.Cell >> CellBits) & CellMask) << 16) | particle.Offset[1]),
+			static_cast<int32_t>((((particle.Cell >> (CellBits * 2)) & CellMask) << 16) | particle.Offset[2]) };
+	}
+
+	/// <summary>
+	/// 位置の差 a - b を返します (整数で引くので、原点から遠いセルでも桁落ちしない)
+	/// </summary>
+	Vector3D Difference(const FixedPosition& a, const CompactParticle& b) const
+	{
+		FixedPosition fixedB = ToFixed(b);
+		return Vector3D(
+			static_cast<float>(a.x - fixedB.x) * m_Quantum,
+			static_cast<float>(a.y - fixedB.y) * m_Quantum,
+			static_cast<float>(a.z - fixedB.z) * m_Quantum);
+	}
+
+	float GetCellSize() const { return m_CellSize; }
+
+private:
+	// セル座標 (バイアス込み) を返し、セル内の位置を offset に書き込む
+	// 原点から遠いセルでもfloatの桁落ちで区間を間違えないよう、doubleで計算する
+	uint32_t EncodeAxis(float position, float origin, uint16_t& offset) const
+	{
+		double local = (static_cast<double>(position) - origin) * m_InvCellSize;
+		int cell = std::clamp(static_cast<int>(std::floor(local)), -CellBias, CellBias - 1);
+		double fraction = (local - cell) * 65536.0;
+		offset = static_cast<uint16_t>(std::clamp(fraction, 0.0, 65535.0));
+		return static_cast<uint32_t>(cell + CellBias);
+	}
+
+	float DecodeAxis(uint32_t cell, uint16_t offset, float origin) const
+	{
+		float local = static_cast<float>(static_cast<int>(cell) - CellBias) + (offset + 0.5f) * (1.0f / 65536.0f);
+		return origin + local * m_CellSize;
+	}
+
+	Vector3D m_Origin = Vector3D(0.0f);
+	float m_CellSize = 1.0f;
+	double m_InvCellSize = 1.0;
+	float m_Quantum = 1.0f / 65536.0f;
+};
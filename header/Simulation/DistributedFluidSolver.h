@@ -0,0 +1,110 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/CPUFluidSolver.h"
+#include "Simulation/DomainDecomposition.h"
+#include "Simulation/HaloTransport.h"
+
+// 分割したソルバーの直近のステップの処理時間 (ミリ秒) と通信量
+struct DistributedTimings
+{
+	double Pack = 0.0;     // 送る粒子の振り分けとバッファへの書き込み
+	double Exchange = 0.0; // HaloTransport::Exchange (他のrankを待つ時間を含む)
+	double Unpack = 0.0;
+	double Solve = 0.0;    // 部分領域のソルバーの1ステップ
+	uint32_t MigratedCount = 0; // 部分領域を出て他のrankへ移した粒子数
+	uint32_t GhostCount = 0;    // 受け取った (と自分で残した) ゴースト粒子数
+	uint64_t SentBytes = 0;
+
+	double Total() const { return Pack + Exchange + Unpack + Solve; }
+};
+
+/// <summary>
+/// 壁の範囲を DomainDecomposition で分割し、rank 毎に自分の部分領域の粒子だけを CPUFluidSolver で進めます
+/// 全rankが同じ順番で呼ぶこと (Step / GatherParticles / AllGather は集団操作)
+///
+/// 通信はステップの前に1回だけ行う
+/// (1) 部分領域を出た粒子を持ち主のrankへ移す (2) 部分領域から HaloWidth 以内の粒子をゴーストとして隣のrankへ送る
+/// ゴーストは密度・力のパスの近傍としてだけ使い、ステップ後に捨てる
+/// HaloWidth = 2H なので境界から H 以内のゴーストは近傍が全て揃っていて密度が正しく、自分の粒子の力は分割しない場合と同じになる
+/// (幅 H のハローでは、密度のパスの後にゴーストの密度をもう1回交換する必要がある)
+///
+/// WCSPH・固定時間刻みのみ対応 (DFSPH/PBFは反復毎の交換、適応時間刻みは全rankの最小値が必要なため)
+/// </summary>
+class DistributedFluidSolver
+{
+public:
+	// threadCount は部分領域のソルバーのスレッド数
+	explicit DistributedFluidSolver(HaloTransport& transport, uint32_t threadCount = 1);
+	DistributedFluidSolver(const DistributedFluidSolver&) = delete;
+	DistributedFluidSolver& operator=(const DistributedFluidSolver&) = delete;
+
+	/// <summary>
+	/// シミュレーションパラメータを設定し、壁の範囲を rank 数で分割します
+	/// </summary>
+	void SetSimulationParam(const SimulationParam& param, DecompositionMode mode);
+	const SimulationParam& GetSimulationParam() const { return m_SimParam; }
+
+	/// <summary>
+	/// 全体の粒子を渡し、自分の部分領域にある粒子だけを持ちます (全rankに同じ配列を渡す。粒子IDは配列のインデックス)
+	/// </summary>
+	void SetParticles(const std::vector<Particle>& particles);
+
+	/// <summary>
+	/// 粒子の移動・ゴーストの交換をしてから、部分領域のソルバーを1ステップ進めます
+	/// </summary>
+	/// <returns>通信に失敗した場合は false</returns>
+	bool Step();
+
+	// 自分が持っている粒子とその粒子ID
+	const std::vector<Particle>& GetOwnedParticles() const { return m_OwnedParticles; }
+	const std::vector<uint32_t>& GetOwnedParticleIds() const { return m_OwnedIds; }
+
+	/// <summary>
+	/// 全rankの粒子を rank 0 にID順で集めます (rank 0 以外の dst は空になる)
+	/// </summary>
+	bool GatherParticles(std::vector<Particle>& dst);
+	/// <summary>
+	/// 全rankの value を rank 順に values に集めます (全rankで同じ結果になる)
+	/// </summary>
+	bool AllGather(double value, std::vector<double>& values);
+
+	uint32_t GetRank() const { return m_Transport.GetRank(); }
+	uint32_t GetRankCount() const { return m_Transport.GetRankCount(); }
+	const DomainDecomposition& GetDecomposition() const { return m_Decomposition; }
+	// ゴーストを送る幅 (2H)
+	float GetHaloWidth() const { return 2.0f * m_SimParam.H; }
+	const DistributedTimings& GetTimings() const { return m_Timings; }
+	double GetSimulatedTime() const { return m_SimulatedTime; }
+
+	// 部分領域のソルバー (グリッドの方式などの設定用。粒子は Step 毎に入れ直す)
+	CPUFluidSolver& GetLocalSolver() { return m_LocalSolver; }
+
+private:
+	// rank毎の送信バッファに粒子を振り分ける
+	void PackParticles();
+	// 受け取った粒子を自分の粒子とゴーストに追加する
+	void UnpackParticles();
+
+	HaloTransport& m_Transport;
+	CPUFluidSolver m_LocalSolver;
+	SimulationParam m_SimParam = {};
+	DomainDecomposition m_Decomposition;
+	DistributedTimings m_Timings;
+	double m_SimulatedTime = 0.0;
+
+	std::vector<Particle> m_OwnedParticles;
+	std::vector<uint32_t> m_OwnedIds;
+	std::vector<Particle> m_GhostParticles;
+
+	// rank毎の送信データ (Pack中の作業用)
+	struct OutgoingParticles
+	{
+		std::vector<uint32_t> MigrantIds;
+		std::vector<Particle> Migrants;
+		std::vector<Particle> Ghosts;
+	};
+	std::vector<OutgoingParticles> m_Outgoing;
+	std::vector<std::vector<uint8_t>> m_SendBuffers;
+	std::vector<std::vector<uint8_t>> m_ReceiveBuffers;
+	std::vector<Particle> m_StepParticles; // 自分の粒子 + ゴースト (ID順)
+};
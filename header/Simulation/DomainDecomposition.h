@@ -0,0 +1,79 @@
+#pragma once
+#include "pch.h"
+#include "Math/Vector3D.h"
+#include "Simulation/SPHCommon.h"
+
+// 領域の分け方
+enum class DecompositionMode
+{
+	Slab,  // 一番長い軸だけを rankCount 等分する (隣の部分領域は最大2つ)
+	Brick, // rankCount = nx * ny * nz のうち、部分領域の境界面の合計が最小になる分け方
+};
+
+/// <summary>
+/// 壁の範囲 (WallMin..WallMax) を同じ大きさの直方体 (部分領域) に分割し、rank に割り当てます
+/// rank = (z * ny + y) * nx + x。壁の外の位置は一番近い部分領域に含める
+/// </summary>
+class DomainDecomposition
+{
+public:
+	DomainDecomposition() = default;
+	DomainDecomposition(const Vector3D& wallMin, const Vector3D& wallMax, uint32_t rankCount, DecompositionMode mode);
+
+	uint32_t GetRankCount() const { return static_cast<uint32_t>(m_Dims.x * m_Dims.y * m_Dims.z); }
+	// 各軸の分割数
+	const SPHCommon::GridPos& GetDims() const { return m_Dims; }
+
+	uint32_t GetRank(const Vector3D& position) const
+	{
+		return ToRank(GetIndex(position));
+	}
+	void GetBounds(uint32_t rank, Vector3D& boundsMin, Vector3D& boundsMax) const;
+
+	/// <summary>
+	/// position の各軸 ±width の範囲に掛かる部分領域のうち、excludeRank 以外の rank を func(rank) に渡します (ゴースト粒子の送り先)
+	/// </summary>
+	template<typename Func>
+	void ForEachHaloRank(const Vector3D& position, float width, uint32_t excludeRank, Func&& func) const
+	{
+		SPHCommon::GridPos lower = GetIndex(position - Vector3D(width));
+		SPHCommon::GridPos upper = GetIndex(position + Vector3D(width));
+		for (int z = lower.z; z <= upper.z; ++z)
+		{
+			for (int y = lower.y; y <= upper.y; ++y)
+			{
+				for (int x = lower.x; x <= upper.x; ++x)
+				{
+					uint32_t rank = ToRank({ x, y, z });
+					if (rank != excludeRank)
+					{
+						func(rank);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	// 位置を含む部分領域の各軸の番号
+	SPHCommon::GridPos GetIndex(const Vector3D& position) const
+	{
+		auto axisIndex = [](float value, float wallMin, float invSize, int count)
+		{
+			return std::clamp(static_cast<int>(std::floor((value - wallMin) * invSize)), 0, count - 1);
+		};
+		return {
+			axisIndex(position.x, m_WallMin.x, m_InvSubdomainSize.x, m_Dims.x),
+			axisIndex(position.y, m_WallMin.y, m_InvSubdomainSize.y, m_Dims.y),
+			axisIndex(position.z, m_WallMin.z, m_InvSubdomainSize.z, m_Dims.z) };
+	}
+	uint32_t ToRank(const SPHCommon::GridPos& index) const
+	{
+		return static_cast<uint32_t>((index.z * m_Dims.y + index.y) * m_Dims.x + index.x);
+	}
+
+	Vector3D m_WallMin = Vector3D(0.0f);
+	Vector3D m_SubdomainSize = Vector3D(1.0f);
+	Vector3D m_InvSubdomainSize = Vector3D(1.0f);
+	SPHCommon::GridPos m_Dims = { 1, 1, 1 };
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+
+// ヘッドレス実行用のシナリオ設定
+namespace FluidScenario
+{
+	// FluidStageのデフォルト値と同じパラメータ
+	inline SimulationParam MakeDefaultParam()
+	{
+		SimulationParam param = {};
+		param.DeltaTime = 0.006f;
+		param.Gravity = -9.81f;
+		param.Stiffness = 100.0f;
+		param.nearStiffness = 10.0f;
+		param.RestDensity = 300.0f;
+		param.Viscosity = 20.0f;
+		param.H = 0.16f;
+		param.Mass = 0.5f;
+		param.WallMin = Vector3D(-2.0f, 0.0f, -2.0f);
+		param.WallMax = Vector3D(2.0f, 4.0f, 2.0f);
+		return param;
+	}
+
+	// 基準の粒子数 (FluidStage の初期粒子数)
+	static const uint32_t DefaultParticleCount = 20000;
+
+	// デフォルトと同じ粒子密度になるように箱を相似拡大したパラメータ
+	// (100万粒子でも1セル当たりの近傍数がデフォルトと同程度になる)
+	inline SimulationParam MakeScaledParam(uint32_t particleCount)
+	{
+		SimulationParam param = MakeDefaultParam();
+		float scale = std::cbrt(static_cast<float>(particleCount) / DefaultParticleCount);
+		param.WallMin = param.WallMin * scale;
+		param.WallMax = param.WallMax * scale;
+		return param;
+	}
+
+	// ダムブレイク: 箱の隅に積んだ水柱を崩す
+	// 粒子間隔は H/2 (近傍が30個程度になる) で、質量は静止密度と粒子間隔から決める
+	inline SimulationParam MakeDamBreakParam(uint32_t particleCount)
+	{
+		SimulationParam param = MakeScaledParam(particleCount);
+		float spacing = param.H * 0.5f;
+		param.Mass = param.RestDensity * spacing * spacing * spacing;
+		return param;
+	}
+
+	// 幅:高さ:奥行き = 1:1.25:2 の水柱を格子状に並べる (粒子数は particleCount 以下になる)
+	inline std::vector<Particle> MakeDamBreakParticles(const SimulationParam& param, uint32_t particleCount)
+	{
+		float spacing = param.H * 0.5f;
+		Vector3D range = param.WallMax - param.WallMin;
+		uint32_t countX = std::max(1u, static_cast<uint32_t>(std::cbrt(particleCount / 2.5f)));
+		uint32_t countY = std::min(static_cast<uint32_t>(countX * 1.25f), static_cast<uint32_t>(range.y / spacing) - 1);
+		uint32_t countZ = std::min(countX * 2, static_cast<uint32_t>(range.z / spacing) - 1);
+
+		std::vector<Particle> particles;
+		particles.reserve(countX * countY * countZ);
+		for (uint32_t z = 0; z < countZ; ++z)
+		{
+			for (uint32_t y = 0; y < countY; ++y)
+			{
+				for (uint32_t x = 0; x < countX; ++x)
+				{
+					Particle particle = {};
+					particle.Position = param.WallMin + Vector3D(x + 0.5f, y + 0.5f, z + 0.5f) * spacing;
+					particles.push_back(particle);
+				}
+			}
+		}
+		return particles;
+	}
+}
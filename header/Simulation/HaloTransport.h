@@ -0,0 +1,104 @@
+#pragma once
+#include "pch.h"
+
+#include <condition_variable>
+#include <mutex>
+
+// 領域分割したソルバー (rank) 間のデータのやり取り
+// DistributedFluidSolver はこのインターフェースだけを使うので、通信の方法は差し替えられる
+class HaloTransport
+{
+public:
+	virtual ~HaloTransport() = default;
+
+	virtual uint32_t GetRank() const = 0;
+	virtual uint32_t GetRankCount() const = 0;
+
+	/// <summary>
+	/// sendBuffers[r] を rank r へ送り、rank r から届いたデータを receiveBuffers[r] に入れます
+	/// 全rankが同じ順番で呼ぶ集団操作で、全員の分が揃うまで戻らない (空のバッファも送る。自分宛はコピー)
+	/// </summary>
+	/// <returns>通信に失敗した場合は false</returns>
+	virtual bool Exchange(const std::vector<std::vector<uint8_t>>& sendBuffers,
+		std::vector<std::vector<uint8_t>>& receiveBuffers) = 0;
+};
+
+class LocalHaloTransport;
+
+/// <summary>
+/// 同じプロセスの rankCount 個のスレッドで、共有メモリのメールボックスを介してやり取りするグループ
+/// 1台での動作確認や、プロセスを分けずに分割の効果を見る場合に使う (スレッド毎に GetTransport(rank) を渡す)
+/// </summary>
+class LocalHaloGroup
+{
+public:
+	explicit LocalHaloGroup(uint32_t rankCount);
+	LocalHaloGroup(const LocalHaloGroup&) = delete;
+	LocalHaloGroup& operator=(const LocalHaloGroup&) = delete;
+	~LocalHaloGroup();
+
+	HaloTransport& GetTransport(uint32_t rank);
+
+private:
+	friend class LocalHaloTransport;
+	// 全rankが到着するまで待つ
+	void Barrier();
+
+	uint32_t m_RankCount = 0;
+	std::vector<std::unique_ptr<LocalHaloTransport>> m_Transports;
+	std::vector<std::vector<std::vector<uint8_t>>> m_Mailboxes; // [送信元][送信先]
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	uint32_t m_ArrivedCount = 0;
+	uint64_t m_Generation = 0; // Barrier毎に増える世代番号
+};
+
+class LocalHaloTransport : public HaloTransport
+{
+public:
+	LocalHaloTransport(LocalHaloGroup& group, uint32_t rank) : m_Group(group), m_Rank(rank) {}
+
+	uint32_t GetRank() const override { return m_Rank; }
+	uint32_t GetRankCount() const override { return m_Group.m_RankCount; }
+	bool Exchange(const std::vector<std::vector<uint8_t>>& sendBuffers,
+		std::vector<std::vector<uint8_t>>& receiveBuffers) override;
+
+private:
+	LocalHaloGroup& m_Group;
+	uint32_t m_Rank = 0;
+};
+
+/// <summary>
+/// 同じマシンの別プロセスと Unix ドメインソケットでやり取りします
+/// rank r は "socketPath.r" で待ち受けて自分より大きい rank からの接続を受け、自分より小さい rank へ接続する (全rankの組で1本ずつ)
+/// Linuxのみ対応。その他のOSや、timeoutSeconds 以内に全rankと接続できなかった場合は IsConnected() が false を返す
+/// </summary>
+class SocketHaloTransport : public HaloTransport
+{
+public:
+	SocketHaloTransport(uint32_t rank, uint32_t rankCount, const std::string& socketPath, double timeoutSeconds = 30.0);
+	SocketHaloTransport(const SocketHaloTransport&) = delete;
+	SocketHaloTransport& operator=(const SocketHaloTransport&) = delete;
+	~SocketHaloTransport() override;
+
+	bool IsConnected() const { return m_IsConnected; }
+
+	uint32_t GetRank() const override { return m_Rank; }
+	uint32_t GetRankCount() const override { return m_RankCount; }
+	/// <summary>
+	/// 全ての相手への送信と受信を poll で同時に進めます (相手の受信待ちで互いに送信が詰まらないように)
+	/// 1メッセージは 8byte のサイズ + データ
+	/// </summary>
+	bool Exchange(const std::vector<std::vector<uint8_t>>& sendBuffers,
+		std::vector<std::vector<uint8_t>>& receiveBuffers) override;
+
+private:
+	void CloseSockets();
+
+	uint32_t m_Rank = 0;
+	uint32_t m_RankCount = 1;
+	double m_TimeoutSeconds = 30.0;
+	bool m_IsConnected = false;
+	std::vector<int> m_PeerSockets; // rank毎のソケット (自分は -1)
+};
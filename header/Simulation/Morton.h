@@ -0,0 +1,25 @@
+#pragma once
+#include "pch.h"
+
+// 3次元Morton (Zオーダー) 符号
+// 空間的に近いセルがメモリ上でも近くなるように並べるために使う
+namespace Morton
+{
+	// 下位21bitを3bit間隔に広げる
+	inline uint64_t ExpandBits(uint32_t v)
+	{
+		uint64_t x = v & 0x1fffff;
+		x = (x | (x << 32)) & 0x1f00000000ffffULL;
+		x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+		x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+		x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+		x = (x | (x << 2)) & 0x1249249249249249ULL;
+		return x;
+	}
+
+	// 各軸21bitまで
+	inline uint64_t Encode3D(uint32_t x, uint32_t y, uint32_t z)
+	{
+		return ExpandBits(x) | (ExpandBits(y) << 1) | (ExpandBits(z) << 2);
+	}
+}
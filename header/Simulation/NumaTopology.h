@@ -0,0 +1,33 @@
+#pragma once
+#include "pch.h"
+
+// NUMAノードと論理CPUの対応
+// Linuxは /sys/devices/system/node、Windowsは GetNumaNodeProcessorMaskEx から読み、取得できない場合は全CPUを1ノードとする
+// Linuxではプロセスに許可されていない CPU (taskset / cgroup の cpuset) は含めない
+class NumaTopology
+{
+public:
+	static NumaTopology Detect();
+
+	uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_NodeCpus.size()); }
+	const std::vector<uint32_t>& GetNodeCpus(uint32_t node) const { return m_NodeCpus[node]; }
+	// OSのノード番号 (CPUのないノードを飛ばすので、インデックスと一致するとは限らない)
+	uint32_t GetNodeId(uint32_t node) const { return m_NodeIds[node]; }
+
+	/// <summary>
+	/// threadCount 個のスレッドを番号の連続したブロックでノードに割り当て、スレッド毎の論理CPUとノード (インデックス) を返します
+	/// (スレッド t のノードは t * ノード数 / threadCount。隣り合う番号のスレッドが同じノードになる)
+	/// ノードのCPUより多いスレッドは、同じノードのCPUに重ねて割り当てる
+	/// </summary>
+	void AssignThreads(uint32_t threadCount, std::vector<uint32_t>& threadCpus, std::vector<uint32_t>& threadNodes) const;
+
+	/// <summary>
+	/// ページが置かれているOSのノード番号を pNodes[i] に返します (まだ書き込まれていないページや取得できない場合は -1)
+	/// Linuxのみ対応 (move_pages で問い合わせるだけでページは移動しない)
+	/// </summary>
+	static void QueryPageNodes(const void* const* pPages, size_t count, int* pNodes);
+
+private:
+	std::vector<std::vector<uint32_t>> m_NodeCpus; // ノード毎の論理CPU番号
+	std::vector<uint32_t> m_NodeIds;
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class CPUFluidSolver;
+
+// 書き出すファイルの形式
+enum class ExportFormat
+{
+	VTK, // レガシーVTK (バイナリ、POLYDATA の点 + 1つの頂点セル)。ParaView / VisIt で開ける
+	PLY, // バイナリ (リトルエンディアン) のPLY。頂点に属性を並べる
+	CSV, // 1行1粒子のテキスト (書き込みは遅いので少ない粒子数向け)
+};
+
+// 空きバッファがない (ディスクが遅く、書き込みが追いつかない) 場合の扱い
+enum class ExportDropPolicy
+{
+	SkipNewest,    // 新しいフレームを書かない (書き出すフレームの間隔は不揃いになるが、古いフレームから順に残る)
+	ReplaceOldest, // まだ書き始めていない一番古いフレームを捨てて新しいフレームを入れる (常に最新に近い状態を書く)
+};
+
+// 書き出しの設定
+struct ExportParam
+{
+	ExportFormat Format = ExportFormat::VTK;
+	// 位置以外に書き出す属性
+	bool Density = true;
+	bool Pressure = true;
+	bool Velocity = true;
+	uint32_t BufferCount = 2; // 粒子を写すバッファの数 (書き込み中の1つ + 待ち。1 以上)
+	ExportDropPolicy DropPolicy = ExportDropPolicy::SkipNewest;
+};
+
+// 書き出しの統計
+struct ExportStats
+{
+	uint32_t SubmittedFrames = 0;  // Submit を呼んだフレーム数
+	uint32_t CapturedFrames = 0;   // バッファに写したフレーム数
+	uint32_t WrittenFrames = 0;
+	uint32_t DroppedFrames = 0;    // バッファが空かずに捨てたフレーム数 (ReplaceOldest で置き換えられたフレームを含む)
+	uint32_t FailedFrames = 0;     // ファイルを開けない・書けなかったフレーム数
+	uint64_t WrittenBytes = 0;
+	double CaptureMilliseconds = 0.0; // 粒子をバッファに写した時間の合計 (ステップを止めた時間)
+	double WriteMilliseconds = 0.0;   // バックグラウンドのスレッドでの整形と書き込みの時間の合計
+};
+
+/// <summary>
+/// 粒子の状態を使い回すバッファに写し、バックグラウンドのスレッドで VTK / PLY / CSV のファイルに書き出します
+/// 呼び出し側 (ソルバーのステップ) を止めるのはバッファに写す間だけで、空きバッファがない場合は待たずに DropPolicy でフレームを捨てる
+/// ファイルは「pathPrefix_フレーム番号(6桁).拡張子」に1フレーム1ファイルで書く
+/// </summary>
+class ParticleExporter
+{
+public:
+	ParticleExporter() = default;
+	ParticleExporter(const ParticleExporter&) = delete;
+	ParticleExporter& operator=(const ParticleExporter&) = delete;
+	~ParticleExporter();
+
+	/// <summary>
+	/// バッファを確保して書き込みのスレッドを開始します (pathPrefix のディレクトリがなければ作る)
+	/// </summary>
+	bool Open(const std::string& pathPrefix, const ExportParam& param = ExportParam());
+	/// <summary>
+	/// 待っているフレームを書き終えてからスレッドを止めます
+	/// </summary>
+	void Close();
+	bool IsOpen() const { return m_Thread.joinable(); }
+
+	/// <summary>
+	/// solver の粒子をID順に写して、frame 番号のファイルへの書き込みを予約します (ステップの間に呼ぶ)
+	/// </summary>
+	/// <returns>空きバッファがなくフレームを捨てた場合は false (ReplaceOldest では古いフレームを捨てて true)</returns>
+	bool Submit(const CPUFluidSolver& solver, uint64_t frame);
+	/// <summary>
+	/// capture(particles) で粒子を写して書き込みを予約します (GPUのバッファを読み戻す場合など、ソルバー以外から書く場合に使う)
+	/// </summary>
+	bool Submit(const std::function<void(std::vector<Particle>&)>& capture, uint64_t frame, double time);
+	/// <summary>
+	/// 予約したフレームを全て書き終えるまで待ちます
+	/// </summary>
+	void Flush();
+
+	ExportStats GetStats() const;
+	const ExportParam& GetParam() const { return m_Param; }
+	std::string GetFramePath(uint64_t frame) const;
+
+	/// <summary>
+	/// particles を path に書き込みます (呼び出したスレッドで書き終えるまで戻らない)
+	/// </summary>
+	/// <returns>書き込んだバイト数 (失敗した場合は 0)</returns>
+	static uint64_t WriteFile(const std::vector<Particle>& particles, double time, const std::string& path, const ExportParam& param);
+
+private:
+	struct Frame
+	{
+		std::vector<Particle> Particles;
+		uint64_t Index = 0;
+		double Time = 0.0;
+	};
+
+	void WriterThread();
+
+	ExportParam m_Param;
+	std::string m_PathPrefix;
+	std::vector<std::unique_ptr<Frame>> m_Frames; // バッファ (確保したまま使い回す)
+	std::vector<Frame*> m_FreeFrames;
+	std::deque<Frame*> m_PendingFrames; // 書き込み待ち (古い順)
+	bool m_Writing = false;             // 書き込みのスレッドがフレームを持っている
+	bool m_Stop = false;
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_PendingCondition; // 書き込み待ちが増えた・止める
+	std::condition_variable m_IdleCondition;    // 書き込みが終わった
+	std::thread m_Thread;
+	ExportStats m_Stats;
+};
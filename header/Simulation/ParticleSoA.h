@@ -0,0 +1,45 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+#include "Simulation/AlignedAllocator.h"
+
+// Particle (AoS) の各メンバを別々の配列に持つ粒子コンテナ
+// 近傍ループで必要なメンバだけを連続して読めるので、SIMDでまとめて処理できる
+struct ParticleSoA
+{
+	// 変換するメンバの指定
+	enum FieldMask : uint32_t
+	{
+		FieldPosition = 1 << 0,
+		FieldVelocity = 1 << 1,
+		FieldForce = 1 << 2,
+		FieldDensity = 1 << 3,     // Density, NearDensity
+		FieldPressure = 1 << 4,
+		FieldAll = 0xffffffff,
+	};
+
+	void Resize(uint32_t count);
+	uint32_t Size() const { return static_cast<uint32_t>(PositionX.size()); }
+
+	/// <summary>
+	/// pSrc[begin, end) を同じインデックスに読み込みます (スレッド毎に範囲を分けて呼べる)
+	/// </summary>
+	void LoadFromAoS(const Particle* pSrc, uint32_t begin, uint32_t end, uint32_t fields = FieldAll);
+	/// <summary>
+	/// [begin, end) を pDst の同じインデックスに書き出します (GPUの構造化バッファ用)
+	/// </summary>
+	void StoreToAoS(Particle* pDst, uint32_t begin, uint32_t end, uint32_t fields = FieldAll) const;
+
+	AlignedVector<float> PositionX;
+	AlignedVector<float> PositionY;
+	AlignedVector<float> PositionZ;
+	AlignedVector<float> VelocityX;
+	AlignedVector<float> VelocityY;
+	AlignedVector<float> VelocityZ;
+	AlignedVector<float> ForceX;
+	AlignedVector<float> ForceY;
+	AlignedVector<float> ForceZ;
+	AlignedVector<float> Density;
+	AlignedVector<float> NearDensity;
+	AlignedVector<float> Pressure;
+};
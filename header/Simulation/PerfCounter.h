@@ -0,0 +1,30 @@
+#pragma once
+#include "pch.h"
+
+// ハードウェアカウンタ (キャッシュミス等) の計測
+// Linuxの perf_event_open のみ対応。権限がない環境やその他のOSでは IsAvailable() が false を返す
+// 生成したスレッドと、生成後に作られたスレッドが計測対象になるので、ThreadPoolより先に生成すること
+class PerfCounter
+{
+public:
+	enum class Event
+	{
+		CacheMisses,     // LLCミス
+		CacheReferences, // LLC参照
+		L1DReadMisses,   // L1データキャッシュの読み込みミス
+	};
+
+	explicit PerfCounter(Event event);
+	PerfCounter(const PerfCounter&) = delete;
+	PerfCounter& operator=(const PerfCounter&) = delete;
+	~PerfCounter();
+
+	bool IsAvailable() const { return m_FileDescriptor >= 0; }
+
+	void Start();
+	// Startからの計測値 (計測できない場合は0)
+	uint64_t Stop();
+
+private:
+	int m_FileDescriptor = -1;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+#include "Simulation/ParticleSoA.h"
+
+// SoAの連続した近傍範囲に対して、Poly6/Spiky/Viscosityカーネルを8個(AVX2)または16個(AVX-512)ずつ評価する
+// (表面抽出の異方性カーネル用に、対称3x3行列の固有分解も同じ幅でまとめて行う)
+// 実行時にCPUの対応命令を調べて実装を選ぶ。x86以外や未対応CPUではスカラー実装を使う
+
+enum class SIMDLevel
+{
+	Scalar,
+	AVX2,   // AVX2 + FMA, 8レーン
+	AVX512, // AVX-512F, 16レーン
+};
+
+const char* ToString(SIMDLevel level);
+
+// カーネルの正規化係数 (ステップ毎に1回だけ計算する)
+struct SPHBatchCoefficients
+{
+	float H = 0.0f;
+	float H2 = 0.0f;
+	float Mass = 0.0f;
+	float NearStiffness = 0.0f;
+	float Poly6 = 0.0f;              // 315 / (64 * pi * h^9)
+	float NearDensity = 0.0f;        // 15 / (pi * h^6)
+	float Spiky = 0.0f;              // -45 / (pi * h^6)
+	float NearSpiky = 0.0f;          // -15 / (pi * h^5)
+	float ViscosityLaplacian = 0.0f; // 45 / (pi * h^6)
+
+	static SPHBatchCoefficients Create(const SimulationParam& param);
+};
+
+struct SPHBatchKernels
+{
+	SIMDLevel Level = SIMDLevel::Scalar;
+
+	/// <summary>
+	/// soa[begin, end) の粒子から位置(px, py, pz)での密度・近傍密度を加算します (FluidDensityCS の内側のループ)
+	/// </summary>
+	void (*AccumulateDensity)(const ParticleSoA& soa, uint32_t begin, uint32_t end,
+		float px, float py, float pz, const SPHBatchCoefficients& coef,
+		float& density, float& nearDensity) = nullptr;
+
+	/// <summary>
+	/// soa[begin, end) の粒子から粒子selfへの圧力・粘性項を加算します (FluidForceCS の内側のループ)
+	/// self自身は距離0なので r2 < 0.00001 の判定で除外される
+	/// </summary>
+	void (*AccumulateForce)(const ParticleSoA& soa, uint32_t begin, uint32_t end,
+		uint32_t self, const SPHBatchCoefficients& coef,
+		Vector3D& pressureForce, Vector3D& viscosityForce) = nullptr;
+
+	/// <summary>
+	/// count 個の対称3x3行列 (matrix[0..5] = xx, xy, xz, yy, yz, zz の SoA) を巡回 Jacobi 法で固有分解します (異方性カーネルの共分散行列用)
+	/// eigenvalues[k] に k 番目の固有値、eigenvectors[3 * k + c] にその固有ベクトル (単位長) の c 成分を書く (固有値は整列しない)
+	/// SIMD版は固定回数の回転を分岐なしで行う (非対角成分が0のレーンは回転角0にする)
+	/// </summary>
+	void (*DecomposeSymmetric3x3)(const float* const matrix[6], float* const eigenvalues[3], float* const eigenvectors[9], uint32_t count) = nullptr;
+};
+
+// DecomposeSymmetric3x3 の巡回の回数 (1回で3つの非対角成分を順に消す。float の精度では4回で収束する)
+constexpr uint32_t JacobiSweepCount = 5;
+
+// このCPUで使える最も広いSIMD命令セット
+SIMDLevel DetectSIMDLevel();
+
+// levelに対応する実装 (ビルドやCPUが対応していない場合はより狭い実装にフォールバック)
+const SPHBatchKernels& GetSPHBatchKernels(SIMDLevel level);
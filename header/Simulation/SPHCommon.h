@@ -0,0 +1,167 @@
+#pragma once
+#include "pch.h"
+#include "Math/Vector3D.h"
+#include "Math/MathUtility.h"
+
+// SPHCommon.hlsli のCPU移植
+// シェーダーと同じ式を使うことで、CPUソルバーの結果をGPU版と比較できるようにする
+namespace SPHCommon
+{
+	struct GridPos
+	{
+		int x = 0;
+		int y = 0;
+		int z = 0;
+	};
+
+	// 密度を計算する用のカーネル関数(重み)
+	// W(r, h) = (315 / (64 * pi * h^9)) * (h^2 - r^2)^3   (0 <= r <= h の場合)
+	inline float Poly6Kernel(float r, float h)
+	{
+		if (r < h)
+		{
+			float h2 = h * h;
+			float r2 = r * r;
+			float term = h2 - r2;
+			float coef = 315.0f / (64.0f * MathUtility::PI * std::pow(h, 9.0f));
+			return coef * term * term * term;
+		}
+		return 0.0f;
+	}
+
+	// 近傍密度を計算する用のカーネル関数(重み)
+	inline float NearDensityKernel(float r, float h)
+	{
+		if (r < h)
+		{
+			float term = h - r;
+			float coef = 15.0f / (MathUtility::PI * std::pow(h, 6.0f));
+			return coef * term * term * term;
+		}
+		return 0.0f;
+	}
+
+	// 近傍圧力計算用のカーネル関数
+	inline float SpikyKernelGradient(float r, float h)
+	{
+		if (r <= h)
+		{
+			float term = h - r;
+			float coef = -45.0f / (MathUtility::PI * std::pow(h, 6.0f));
+			return coef * term * term;
+		}
+		return 0.0f;
+	}
+
+	// 圧力計算用のカーネル関数
+	inline float NearSpikyKernelGradient(float r, float h)
+	{
+		if (r <= h)
+		{
+			float term = h - r;
+			float coef = -15.0f / (MathUtility::PI * std::pow(h, 5.0f));
+			return coef * term;
+		}
+		return 0.0f;
+	}
+
+	// 粘性計算用のカーネル（Laplacian）
+	// ∇^2W(r, h) = (45 / (pi * h^6)) * (h - r)
+	inline float ViscosityKernelLaplacian(float r, float h)
+	{
+		if (r < h)
+		{
+			float coef = 45.0f / (MathUtility::PI * std::pow(h, 6.0f));
+			return coef * (h - r);
+		}
+		return 0.0f;
+	}
+
+	inline GridPos GetGridPos(const Vector3D& pos, const Vector3D& wallMin, float H)
+	{
+		Vector3D localPos = pos - wallMin;
+		GridPos gridPos;
+		gridPos.x = static_cast<int>(std::floor(localPos.x / H)) + 1;
+		gridPos.y = static_cast<int>(std::floor(localPos.y / H)) + 1;
+		gridPos.z = static_cast<int>(std::floor(localPos.z / H)) + 1;
+		return gridPos;
+	}
+
+	// 座標からグリッドのインデックスを取得
+	inline int GetGridIndex(const GridPos& gridPos, const GridPos& gridDim)
+	{
+		if (gridPos.x < 0 || gridPos.x >= gridDim.x ||
+			gridPos.y < 0 || gridPos.y >= gridDim.y ||
+			gridPos.z < 0 || gridPos.z >= gridDim.z)
+		{
+			return -1; // 無効値
+		}
+		return gridPos.x + (gridPos.y * gridDim.x) + (gridPos.z * gridDim.x * gridDim.y);
+	}
+
+	// 空間ハッシュ用のセルキー (各軸21bitに折り返して64bitに詰める)
+	inline uint64_t GetCellKey(const GridPos& gridPos)
+	{
+		const uint64_t mask = (1ull << 21) - 1;
+		return (static_cast<uint64_t>(gridPos.x) & mask) |
+			((static_cast<uint64_t>(gridPos.y) & mask) << 21) |
+			((static_cast<uint64_t>(gridPos.z) & mask) << 42);
+	}
+
+	// セル座標 -> ハッシュバケット (Teschner et al. 2003, bucketCountは2のべき乗)
+	inline uint32_t HashGridPos(const GridPos& gridPos, uint32_t bucketCount)
+	{
+		uint32_t hash = (static_cast<uint32_t>(gridPos.x) * 73856093u) ^
+			(static_cast<uint32_t>(gridPos.y) * 19349663u) ^
+			(static_cast<uint32_t>(gridPos.z) * 83492791u);
+		return hash & (bucketCount - 1);
+	}
+
+	// 壁の範囲とセルサイズからグリッドの次元数を計算(切り上げ) +2は範囲外アクセス防止用のマージン
+	inline Vector3D ComputeGridDim(const Vector3D& wallMin, const Vector3D& wallMax, float cellSize)
+	{
+		Vector3D range = wallMax - wallMin;
+		return Vector3D(
+			std::ceil(range.x / cellSize) + 2,
+			std::ceil(range.y / cellSize) + 2,
+			std::ceil(range.z / cellSize) + 2);
+	}
+
+	inline GridPos ToGridPos(const Vector3D& gridDim)
+	{
+		GridPos gridPos;
+		gridPos.x = static_cast<int>(gridDim.x);
+		gridPos.y = static_cast<int>(gridDim.y);
+		gridPos.z = static_cast<int>(gridDim.z);
+		return gridPos;
+	}
+
+	// 壁の外に出た位置を壁の上に戻し、壁に向かう速度成分を消す
+	inline void ClampToWalls(Vector3D& position, Vector3D& velocity, const Vector3D& wallMin, const Vector3D& wallMax)
+	{
+		auto clampAxis = [](float& position, float& velocity, float minValue, float maxValue)
+		{
+			if (position < minValue)
+			{
+				position = minValue;
+				velocity = std::max(velocity, 0.0f);
+			}
+			else if (position > maxValue)
+			{
+				position = maxValue;
+				velocity = std::min(velocity, 0.0f);
+			}
+		};
+		clampAxis(position.x, velocity.x, wallMin.x, wallMax.x);
+		clampAxis(position.y, velocity.y, wallMin.y, wallMax.y);
+		clampAxis(position.z, velocity.z, wallMin.z, wallMax.z);
+	}
+
+	inline Vector3D ClampToWalls(const Vector3D& position, const Vector3D& wallMin, const Vector3D& wallMax)
+	{
+		return Vector3D(
+			std::clamp(position.x, wallMin.x, wallMax.x),
+			std::clamp(position.y, wallMin.y, wallMax.y),
+			std::clamp(position.z, wallMin.z, wallMax.z));
+	}
+}
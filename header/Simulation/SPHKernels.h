@@ -0,0 +1,442 @@
+#pragma once
+#include "pch.h"
+#include "Math/MathUtility.h"
+#include "Math/Vector3D.h"
+
+#include <array>
+
+// SPHのカーネル関数ライブラリ
+// カーネルの種類はポリシー (Poly6, Spiky, ...) としてテンプレート引数で選ぶので、差し替えても粒子ペア毎の分岐や関数ポインタは発生しない
+// 正規化係数 (hのべき乗を含む) は Kernel の生成時 (ステップ毎に1回) に計算し、ペア毎には std::pow を呼ばない
+namespace SPHKernels
+{
+	// ステップ毎に1回だけ計算する係数
+	struct Coefficients
+	{
+		float H = 0.0f;
+		float H2 = 0.0f;
+		float InvH = 0.0f;
+		float Value = 0.0f;     // W の正規化係数
+		float Gradient = 0.0f;  // dW/dr の係数
+		float Laplacian = 0.0f; // ∇^2W の係数
+	};
+
+	// 各ポリシーの関数
+	//   Prepare(h)              : 係数の計算
+	//   Value(c, r)             : W(r)        (r >= h では0)
+	//   ValueSquared(c, r2)     : W(r^2)      (r^2 から直接求められるカーネルはsqrtを使わない)
+	//   Gradient(c, r)          : dW/dr       (∇W = Gradient * diff / r)
+	//   Laplacian(c, r)         : ∇^2W        (Viscosityのみ)
+
+	// W(r, h) = (315 / (64 * pi * h^9)) * (h^2 - r^2)^3
+	struct Poly6
+	{
+		static Coefficients Prepare(float h)
+		{
+			float h3 = h * h * h;
+			float h9 = h3 * h3 * h3;
+			Coefficients c;
+			c.H = h;
+			c.H2 = h * h;
+			c.InvH = 1.0f / h;
+			c.Value = 315.0f / (64.0f * MathUtility::PI * h9);
+			c.Gradient = -6.0f * c.Value;
+			return c;
+		}
+		static float ValueSquared(const Coefficients& c, float r2)
+		{
+			if (r2 < c.H2)
+			{
+				float term = c.H2 - r2;
+				return c.Value * term * term * term;
+			}
+			return 0.0f;
+		}
+		static float Value(const Coefficients& c, float r)
+		{
+			return ValueSquared(c, r * r);
+		}
+		static float Gradient(const Coefficients& c, float r)
+		{
+			if (r < c.H)
+			{
+				float term = c.H2 - r * r;
+				return c.Gradient * r * term * term;
+			}
+			return 0.0f;
+		}
+	};
+
+	// W(r, h) = (15 / (pi * h^6)) * (h - r)^3
+	// 値は近傍密度 (NearDensityKernel)、勾配は圧力 (SpikyKernelGradient) に使う
+	struct Spiky
+	{
+		static Coefficients Prepare(float h)
+		{
+			float h3 = h * h * h;
+			Coefficients c;
+			c.H = h;
+			c.H2 = h * h;
+			c.InvH = 1.0f / h;
+			c.Value = 15.0f / (MathUtility::PI * h3 * h3);
+			c.Gradient = -3.0f * c.Value;
+			return c;
+		}
+		static float Value(const Coefficients& c, float r)
+		{
+			if (r < c.H)
+			{
+				float term = c.H - r;
+				return c.Value * term * term * term;
+			}
+			return 0.0f;
+		}
+		static float ValueSquared(const Coefficients& c, float r2)
+		{
+			return Value(c, std::sqrt(r2));
+		}
+		static float Gradient(const Coefficients& c, float r)
+		{
+			if (r < c.H)
+			{
+				float term = c.H - r;
+				return c.Gradient * term * term;
+			}
+			return 0.0f;
+		}
+	};
+
+	// W(r, h) = (15 / (2 * pi * h^5)) * (h - r)^2
+	// 勾配が近傍圧力 (NearSpikyKernelGradient) になる
+	struct SpikyQuadratic
+	{
+		static Coefficients Prepare(float h)
+		{
+			float h5 = h * h * h * h * h;
+			Coefficients c;
+			c.H = h;
+			c.H2 = h * h;
+			c.InvH = 1.0f / h;
+			c.Value = 15.0f / (2.0f * MathUtility::PI * h5);
+			c.Gradient = -2.0f * c.Value;
+			return c;
+		}
+		static float Value(const Coefficients& c, float r)
+		{
+			if (r < c.H)
+			{
+				float term = c.H - r;
+				return c.Value * term * term;
+			}
+			return 0.0f;
+		}
+		static float ValueSquared(const Coefficients& c, float r2)
+		{
+			return Value(c, std::sqrt(r2));
+		}
+		static float Gradient(const Coefficients& c, float r)
+		{
+			if (r < c.H)
+			{
+				return c.Gradient * (c.H - r);
+			}
+			return 0.0f;
+		}
+	};
+
+	// 粘性計算用のカーネル (Laplacianのみ使用)
+	// ∇^2W(r, h) = (45 / (pi * h^6)) * (h - r)
+	struct ViscosityLaplacian
+	{
+		static Coefficients Prepare(float h)
+		{
+			float h3 = h * h * h;
+			Coefficients c;
+			c.H = h;
+			c.H2 = h * h;
+			c.InvH = 1.0f / h;
+			c.Value = 15.0f / (2.0f * MathUtility::PI * h3);
+			c.Laplacian = 45.0f / (MathUtility::PI * h3 * h3);
+			return c;
+		}
+		// W(r, h) = (15 / (2 * pi * h^3)) * (-q^3 / 2 + q^2 + 1 / (2q) - 1)   (q = r / h)
+		static float Value(const Coefficients& c, float r)
+		{
+			if (r < c.H && r > 0.0f)
+			{
+				float q = r * c.InvH;
+				return c.Value * (-0.5f * q * q * q + q * q + 0.5f / q - 1.0f);
+			}
+			return 0.0f;
+		}
+		static float ValueSquared(const Coefficients& c, float r2)
+		{
+			return Value(c, std::sqrt(r2));
+		}
+		static float Laplacian(const Coefficients& c, float r)
+		{
+			if (r < c.H)
+			{
+				return c.Laplacian * (c.H - r);
+			}
+			return 0.0f;
+		}
+	};
+
+	// 3次スプライン (Monaghan, サポート半径 h)
+	// W = (8 / (pi * h^3)) * (6(q^3 - q^2) + 1)   (q <= 1/2)
+	//     (8 / (pi * h^3)) * 2(1 - q)^3          (1/2 < q < 1)
+	struct CubicSpline
+	{
+		static Coefficients Prepare(float h)
+		{
+			Coefficients c;
+			c.H = h;
+			c.H2 = h * h;
+			c.InvH = 1.0f / h;
+			c.Value = 8.0f / (MathUtility::PI * h * h * h);
+			c.Gradient = c.Value * c.InvH;
+			return c;
+		}
+		static float Value(const Coefficients& c, float r)
+		{
+			float q = r * c.InvH;
+			if (q <= 0.5f)
+			{
+				return c.Value * (6.0f * (q * q * q - q * q) + 1.0f);
+			}
+			if (q < 1.0f)
+			{
+				float term = 1.0f - q;
+				return c.Value * 2.0f * term * term * term;
+			}
+			return 0.0f;
+		}
+		static float ValueSquared(const Coefficients& c, float r2)
+		{
+			return Value(c, std::sqrt(r2));
+		}
+		static float Gradient(const Coefficients& c, float r)
+		{
+			float q = r * c.InvH;
+			if (q <= 0.5f)
+			{
+				return c.Gradient * 6.0f * q * (3.0f * q - 2.0f);
+			}
+			if (q < 1.0f)
+			{
+				float term = 1.0f - q;
+				return c.Gradient * -6.0f * term * term;
+			}
+			return 0.0f;
+		}
+	};
+
+	// Wendland C2 (3次元, サポート半径 h)
+	// W = (21 / (2 * pi * h^3)) * (1 - q)^4 * (1 + 4q)
+	struct WendlandC2
+	{
+		static Coefficients Prepare(float h)
+		{
+			Coefficients c;
+			c.H = h;
+			c.H2 = h * h;
+			c.InvH = 1.0f / h;
+			c.Value = 21.0f / (2.0f * MathUtility::PI * h * h * h);
+			c.Gradient = -20.0f * c.Value * c.InvH;
+			return c;
+		}
+		static float Value(const Coefficients& c, float r)
+		{
+			float q = r * c.InvH;
+			if (q < 1.0f)
+			{
+				float term = 1.0f - q;
+				float term2 = term * term;
+				return c.Value * term2 * term2 * (1.0f + 4.0f * q);
+			}
+			return 0.0f;
+		}
+		static float ValueSquared(const Coefficients& c, float r2)
+		{
+			return Value(c, std::sqrt(r2));
+		}
+		static float Gradient(const Coefficients& c, float r)
+		{
+			float q = r * c.InvH;
+			if (q < 1.0f)
+			{
+				float term = 1.0f - q;
+				return c.Gradient * q * term * term * term;
+			}
+			return 0.0f;
+		}
+	};
+
+	// 係数を保持したカーネル (ステップ毎に生成し、ペア毎にはインライン展開された式だけが残る)
+	template<typename Policy>
+	class Kernel
+	{
+	public:
+		Kernel() = default;
+		explicit Kernel(float h) : m_Coef(Policy::Prepare(h)) {}
+
+		float Value(float r) const { return Policy::Value(m_Coef, r); }
+		float ValueSquared(float r2) const { return Policy::ValueSquared(m_Coef, r2); }
+		float Gradient(float r) const { return Policy::Gradient(m_Coef, r); }
+		float Laplacian(float r) const { return Policy::Laplacian(m_Coef, r); }
+
+		float GetRadius() const { return m_Coef.H; }
+		const Coefficients& GetCoefficients() const { return m_Coef; }
+
+	private:
+		Coefficients m_Coef;
+	};
+
+	/// <summary>
+	/// W(r^2) を [0, h^2] で等間隔にサンプリングしたテーブル (線形補間)
+	/// r^2 のまま引けるので、sqrtが必要なカーネルでもsqrtを省ける
+	/// </summary>
+	template<typename Policy, uint32_t TableSize = 1024>
+	class TabulatedKernel
+	{
+	public:
+		TabulatedKernel() = default;
+		explicit TabulatedKernel(float h)
+		{
+			Coefficients coef = Policy::Prepare(h);
+			m_H2 = coef.H2;
+			m_Scale = TableSize / coef.H2;
+			for (uint32_t i = 0; i < TableSize; ++i)
+			{
+				m_Table[i] = Policy::ValueSquared(coef, coef.H2 * i / TableSize);
+			}
+			// r = h ではどのカーネルも0
+			m_Table[TableSize] = 0.0f;
+		}
+
+		float ValueSquared(float r2) const
+		{
+			if (r2 >= m_H2)
+			{
+				return 0.0f;
+			}
+			float x = r2 * m_Scale;
+			uint32_t index = std::min(static_cast<uint32_t>(x), TableSize - 1);
+			float t = x - static_cast<float>(index);
+			return m_Table[index] + t * (m_Table[index + 1] - m_Table[index]);
+		}
+
+	private:
+		float m_H2 = 0.0f;
+		float m_Scale = 0.0f;
+		std::array<float, TableSize + 1> m_Table = {};
+	};
+
+	/// <summary>
+	/// 平らな壁の外側が静止密度で一様に詰まっているとみなした時の、壁の外側の半空間の ∫W dV のテーブル
+	/// 壁からの距離 d (0 ～ h を等分) に対する ∫W dV と、その変化率 -d/dd ∫W dV (壁の平面上の ∫W dA) を持つ
+	/// </summary>
+	template<typename Policy, uint32_t TableSize = 64>
+	class WallIntegralTable
+	{
+	public:
+		WallIntegralTable() = default;
+		explicit WallIntegralTable(float h)
+		{
+			Coefficients coef = Policy::Prepare(h);
+			m_H = h;
+			m_Scale = (TableSize - 1) / h;
+
+			// 壁から z の距離にある平面上の ∫W dA = 2π ∫[z, h] W(r) r dr を細かく積分しておく
+			const uint32_t sampleCount = 1024;
+			const float step = h / sampleCount;
+			std::vector<double> planeIntegral(sampleCount + 1, 0.0);
+			for (uint32_t i = sampleCount; i > 0; --i)
+			{
+				float r0 = (i - 1) * step;
+				float r1 = i * step;
+				double area = 0.5 * (Policy::Value(coef, r0) * r0 + Policy::Value(coef, r1) * r1) * step;
+				planeIntegral[i - 1] = planeIntegral[i] + 2.0 * MathUtility::PI * area;
+			}
+			// 距離 d の粒子から見た壁の外側の ∫W dV = ∫[d, h] planeIntegral(z) dz
+			std::vector<double> volumeIntegral(sampleCount + 1, 0.0);
+			for (uint32_t i = sampleCount; i > 0; --i)
+			{
+				volumeIntegral[i - 1] = volumeIntegral[i] + 0.5 * (planeIntegral[i - 1] + planeIntegral[i]) * step;
+			}
+
+			for (uint32_t i = 0; i < TableSize; ++i)
+			{
+				uint32_t sample = std::min(sampleCount, static_cast<uint32_t>(std::lround(static_cast<double>(i) * sampleCount / (TableSize - 1))));
+				m_Volume[i] = static_cast<float>(volumeIntegral[sample]);
+				m_Slope[i] = static_cast<float>(planeIntegral[sample]);
+			}
+		}
+
+		float GetRadius() const { return m_H; }
+
+		/// <summary>
+		/// 壁からの距離 distance の ∫W dV を volume に、粒子を動かした時の勾配 (壁の方向を向く) を gradient に加えます
+		/// </summary>
+		void AddWall(float distance, const Vector3D& inwardNormal, float& volume, Vector3D& gradient) const
+		{
+			if (distance >= m_H)
+			{
+				return;
+			}
+			float x = std::max(distance, 0.0f) * m_Scale;
+			uint32_t index = std::min(static_cast<uint32_t>(x), TableSize - 2);
+			float t = x - index;
+			volume += m_Volume[index] + t * (m_Volume[index + 1] - m_Volume[index]);
+			float slope = m_Slope[index] + t * (m_Slope[index + 1] - m_Slope[index]);
+			gradient -= inwardNormal * slope;
+		}
+
+		/// <summary>
+		/// 箱 [wallMin, wallMax] の6面の壁の寄与を加えます
+		/// </summary>
+		void AddBoxWalls(const Vector3D& position, const Vector3D& wallMin, const Vector3D& wallMax, float& volume, Vector3D& gradient) const
+		{
+			AddWall(position.x - wallMin.x, Vector3D(1.0f, 0.0f, 0.0f), volume, gradient);
+			AddWall(wallMax.x - position.x, Vector3D(-1.0f, 0.0f, 0.0f), volume, gradient);
+			AddWall(position.y - wallMin.y, Vector3D(0.0f, 1.0f, 0.0f), volume, gradient);
+			AddWall(wallMax.y - position.y, Vector3D(0.0f, -1.0f, 0.0f), volume, gradient);
+			AddWall(position.z - wallMin.z, Vector3D(0.0f, 0.0f, 1.0f), volume, gradient);
+			AddWall(wallMax.z - position.z, Vector3D(0.0f, 0.0f, -1.0f), volume, gradient);
+		}
+
+	private:
+		float m_H = 0.0f;
+		float m_Scale = 0.0f;
+		std::array<float, TableSize> m_Volume = {};
+		std::array<float, TableSize> m_Slope = {};
+	};
+
+	// FluidStageのシェーダーと同じ組み合わせ (SPHCommon.hlsli)
+	// 別のカーネルを試す場合は、同じメンバを持つ構造体を作って CPUFluidSolver::Kernels を差し替える
+	struct DefaultKernelSet
+	{
+		using Density = Poly6;
+		using NearDensity = Spiky;
+		using Pressure = Spiky;
+		using NearPressure = SpikyQuadratic;
+		using Viscosity = ViscosityLaplacian;
+	};
+
+	// KernelSetの各カーネルをまとめて生成する
+	template<typename KernelSet>
+	struct KernelEvaluator
+	{
+		explicit KernelEvaluator(float h)
+			: Density(h), NearDensity(h), Pressure(h), NearPressure(h), Viscosity(h)
+		{
+		}
+
+		Kernel<typename KernelSet::Density> Density;
+		Kernel<typename KernelSet::NearDensity> NearDensity;
+		Kernel<typename KernelSet::Pressure> Pressure;
+		Kernel<typename KernelSet::NearPressure> NearPressure;
+		Kernel<typename KernelSet::Viscosity> Viscosity;
+	};
+}
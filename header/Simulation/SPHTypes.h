@@ -0,0 +1,35 @@
+#pragma once
+#include "pch.h"
+#include "Math/Vector3D.h"
+
+// GPU (StructuredBuffer) と CPUソルバーで共有する粒子レイアウト
+// SPHCommon.hlsli の Particle と同じ並び (48byte)
+struct Particle
+{
+	Vector3D Position;
+	float Density;
+	Vector3D Velocity;
+	float Pressure;
+	Vector3D Force;
+	float NearDensity;
+};
+static_assert(sizeof(Particle) == 48, "Particle must match the HLSL layout");
+
+// 定数バッファ用構造体 (Compute Shader用)
+struct alignas(256) SimulationParam
+{
+	float DeltaTime;
+	float Gravity;
+	float Stiffness;
+	float nearStiffness;
+	uint32_t ParticleCount;
+	Vector3D WallMin;
+	float RestDensity;
+	Vector3D WallMax;
+	float Viscosity;
+	float H;
+	float Mass;
+	float Padding0; // アライメント調整用
+	Vector3D GridDim;
+	float Padding1; // アライメント調整用
+};
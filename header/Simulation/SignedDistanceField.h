@@ -0,0 +1,138 @@
+#pragma once
+#include "pch.h"
+#include "Math/Vector3D.h"
+#include "Math/Matrix4x4.h"
+
+class ThreadPool;
+
+// SDFの焼き込みの設定 (長さはメッシュのローカル座標)
+struct SDFBakeParam
+{
+	float CellSize = 0.05f;     // 格子点の間隔
+	uint32_t BandCells = 4;     // 三角形までの距離を正確に求める帯の幅 (格子数。帯の外は ±BandCells * CellSize に切り詰める)
+	uint32_t PaddingCells = 2;  // メッシュの範囲の外側に帯とは別に足す格子数
+};
+
+// 直近の焼き込み (または読み込み) の統計
+struct SDFBakeStats
+{
+	uint32_t TriangleCount = 0;
+	uint64_t SampleCount = 0;
+	uint64_t BandSampleCount = 0;  // 帯の中 (正確な距離を持つ) の格子点の数
+	bool FromCache = false;        // キャッシュから読み込んだ (焼き込みの時間は0)
+	double DistanceMilliseconds = 0.0; // 帯の中の三角形までの距離
+	double SignMilliseconds = 0.0;     // 内外の判定 (z方向のレイと三角形の交差の偶奇)
+	double TotalMilliseconds = 0.0;
+};
+
+/// <summary>
+/// 三角形メッシュの符号付き距離場 (内側が負) を格子点に持ち、3重線形補間で引きます
+/// 距離は三角形の近くの帯 (narrow band) だけ正確に求め、帯の外は帯の幅に切り詰める。内外は格子点の列毎に z 方向のレイが
+/// 三角形を横切る回数の偶奇で決めるので、メッシュは閉じている必要がある (穴があるとその列の内外が反転する)
+/// 焼き込みは z の層 (距離) と y の行 (内外) 毎に並列に行い、三角形を担当する範囲に振り分けてから処理するので、原子操作は使わない
+/// </summary>
+class SignedDistanceField
+{
+public:
+	SignedDistanceField() = default;
+
+	/// <summary>
+	/// positions と三角形のインデックス indices から焼き込みます
+	/// </summary>
+	/// <returns>三角形がない場合や、格子点が多すぎる (2^31 以上) 場合は false</returns>
+	bool Bake(const std::vector<Vector3D>& positions, const std::vector<uint32_t>& indices, const SDFBakeParam& param, ThreadPool& threadPool);
+	/// <summary>
+	/// メッシュ (positions / indices) と sourcePath の絶対パスと param のハッシュをキーに cacheDirectory のキャッシュを探し、あれば読み込み、なければ焼き込んで保存します
+	/// キーは読み込んだ後の頂点から求めるので、.gltf の .bin のようにメッシュが別のファイルにあっても変更に気付く
+	/// (sourcePath はキーとキャッシュのファイル名だけに使い、読まない。キャッシュに書けない場合も焼き込んだ結果は使える)
+	/// </summary>
+	bool BakeCached(const std::string& sourcePath, const std::string& cacheDirectory,
+		const std::vector<Vector3D>& positions, const std::vector<uint32_t>& indices, const SDFBakeParam& param, ThreadPool& threadPool);
+
+	/// <summary>
+	/// key と一緒にバイナリで書き込みます (Load で同じ key を渡した場合だけ読める)
+	/// </summary>
+	bool Save(const std::string& path, uint64_t key) const;
+	/// <returns>開けない場合や形式・key が違う場合は false (元の内容は変えない)</returns>
+	bool Load(const std::string& path, uint64_t key);
+
+	/// <summary>
+	/// 頂点の位置と三角形のインデックスのハッシュ (FNV-1a 64bit)
+	/// </summary>
+	static uint64_t HashMesh(const std::vector<Vector3D>& positions, const std::vector<uint32_t>& indices);
+	// キャッシュのキー (メッシュのハッシュに、sourcePath の絶対パスと焼き込みの設定を混ぜる。別のディレクトリの同じ名前のモデルは別のキーになる)
+	static uint64_t MakeCacheKey(uint64_t meshHash, const std::string& sourcePath, const SDFBakeParam& param);
+
+	/// <summary>
+	/// ローカル座標 position の距離と勾配 (3重線形補間。格子の外は帯の幅と0を返す)
+	/// </summary>
+	float Sample(const Vector3D& position, Vector3D* pGradient = nullptr) const;
+
+	bool IsEmpty() const { return m_Values.empty(); }
+	const Vector3D& GetOrigin() const { return m_Origin; }
+	float GetCellSize() const { return m_CellSize; }
+	const uint32_t* GetDim() const { return m_Dim; }
+	float GetBandDistance() const { return m_BandDistance; }
+	// 格子点の値 (x が最も速く変わる順)
+	const std::vector<float>& GetValues() const { return m_Values; }
+	const SDFBakeStats& GetStats() const { return m_Stats; }
+
+private:
+	Vector3D m_Origin = Vector3D(0.0f, 0.0f, 0.0f); // 格子点 (0, 0, 0) の位置
+	float m_CellSize = 0.0f;
+	uint32_t m_Dim[3] = {};
+	float m_BandDistance = 0.0f;
+	std::vector<float> m_Values;
+	SDFBakeStats m_Stats;
+};
+
+/// <summary>
+/// ワールドに置いた SDF の障害物 (キネマティック: World を毎フレーム変えても焼き直さない)
+/// 位置は World の逆行列でSDFのローカル座標に移して引き、距離と法線は勾配をワールドに戻して近似する (拡大縮小を含んでもよい)
+/// </summary>
+struct SDFCollider
+{
+	const SignedDistanceField* pField = nullptr; // SDFCollider より長く生存すること
+	Matrix4x4 World;     // モデルの TransformBuffer::World と同じ行ベクトルの変換
+	Matrix4x4 InvWorld;
+	float LocalToWorldScale = 1.0f; // ローカルの長さをワールドの長さにする倍率 (軸毎に拡大縮小が違う場合は体積の比の3乗根で近似する)
+
+	SDFCollider() = default;
+	SDFCollider(const SignedDistanceField* pSrcField, const Matrix4x4& world) : pField(pSrcField) { SetWorld(world); }
+	void SetWorld(const Matrix4x4& world)
+	{
+		World = world;
+		InvWorld = Matrix4x4::inverse(world);
+		const float (&m)[4][4] = world.m_mat;
+		float determinant = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+			- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+			+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+		LocalToWorldScale = std::cbrt(std::abs(determinant));
+	}
+
+	/// <summary>
+	/// ワールドの position の障害物の表面からの距離 (内側が負) と外向きの法線
+	/// </summary>
+	/// <returns>帯の中 (法線が求まる) 場合は true。帯より深く入り込んだ粒子は法線が求まらないので押し出せない</returns>
+	bool Query(const Vector3D& position, float& distance, Vector3D& normal) const
+	{
+		Vector3D localGradient;
+		float localDistance = pField->Sample(Matrix4x4::Apply(InvWorld, position), &localGradient);
+		// ローカルの勾配 g に対するワールドの勾配は InvWorld の 3x3 部分 × g。長さはワールドの1に対するローカルの長さの比
+		const float (&m)[4][4] = InvWorld.m_mat;
+		Vector3D gradient(
+			m[0][0] * localGradient.x + m[0][1] * localGradient.y + m[0][2] * localGradient.z,
+			m[1][0] * localGradient.x + m[1][1] * localGradient.y + m[1][2] * localGradient.z,
+			m[2][0] * localGradient.x + m[2][1] * localGradient.y + m[2][2] * localGradient.z);
+		float length = gradient.length();
+		if (localDistance >= pField->GetBandDistance() || length <= 0.0f)
+		{
+			distance = localDistance * LocalToWorldScale;
+			normal = Vector3D(0.0f, 0.0f, 0.0f);
+			return false;
+		}
+		distance = localDistance * localGradient.length() / length;
+		normal = gradient * (1.0f / length);
+		return true;
+	}
+};
@@ -0,0 +1,106 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+#include "Simulation/Anisotropy.h"
+#include "Graphics/Vertex.h"
+
+class ThreadPool;
+
+// 表面抽出の設定 (長さは SimulationParam::H に対する比)
+struct SurfaceParam
+{
+	float CellScale = 0.5f;   // マーチングキューブの格子の間隔
+	float RadiusScale = 1.0f; // 密度を格子に配るカーネルの半径
+	float IsoValue = 0.5f;    // 表面とする正規化した密度 (粒子の体積 × W の総和。流体の内部で約1、外で0)
+	uint32_t BlockSize = 8;   // ブロックの1辺の格子数 (カーネルの半径より小さい場合は広げる)
+	bool Anisotropic = false; // 粒子毎の楕円体のカーネルで配る (格子を2～4倍粗くしても表面が滑らか)
+	AnisotropyParam Anisotropy;
+};
+
+// 粒子から作った水面のメッシュ (Mesh と同じ頂点レイアウト、三角形のインデックス)
+// 三角形は外側 (密度の低い方) から見て、左手系では時計回り (右手系では反時計回り) に並ぶ
+struct SurfaceMesh
+{
+	std::vector<Vertex> Vertices;
+	std::vector<uint32_t> Indices;
+};
+
+// 直近の抽出の統計
+struct SurfaceStats
+{
+	uint32_t ParticleCount = 0;
+	uint32_t BlockCount = 0;       // 値を持つブロック (粒子のあるブロックとその隣) の数
+	uint64_t SampleCount = 0;      // 値を持つブロックの格子点の数
+	uint64_t DenseSampleCount = 0; // 同じ範囲を密な格子にした場合の格子点の数
+	uint32_t VertexCount = 0;
+	uint32_t TriangleCount = 0;
+	double AnisotropyMilliseconds = 0.0; // 楕円体のカーネルの計算 (Anisotropic の場合)
+	double BinMilliseconds = 0.0;    // ブロックの列挙と粒子の振り分け
+	double SplatMilliseconds = 0.0;  // 格子点の密度
+	double MarchMilliseconds = 0.0;  // 頂点の作成と三角形の生成
+	double TotalMilliseconds = 0.0;
+};
+
+/// <summary>
+/// 粒子の密度場の等値面をマーチングキューブで三角形メッシュにします (ヘッドレスでも使える)
+/// 格子は BlockSize^3 のブロックに分け、粒子のあるブロックとその隣だけを確保して、粒子の体積 (質量 / 密度) × Poly6 を
+/// ブロック毎に並列に集める (近傍の粒子から読むだけなので、原子操作は使わない)
+/// 頂点は格子の辺毎に1つだけ作り、隣の格子・ブロックの三角形と共有する (溶接済みのインデックス付きメッシュ)
+/// </summary>
+class SurfaceExtractor
+{
+public:
+	// threadCount = 0 の場合はハードウェアスレッド数を使用
+	explicit SurfaceExtractor(uint32_t threadCount = 0);
+	SurfaceExtractor(const SurfaceExtractor&) = delete;
+	SurfaceExtractor& operator=(const SurfaceExtractor&) = delete;
+	~SurfaceExtractor();
+
+	void SetParam(const SurfaceParam& param) { m_Param = param; }
+	const SurfaceParam& GetParam() const { return m_Param; }
+
+	/// <summary>
+	/// particles の表面を mesh に抽出します (粒子の順番は問わない)
+	/// </summary>
+	/// <returns>粒子の範囲を覆うブロックが多すぎる (2^27 以上) 場合は false</returns>
+	bool Extract(const std::vector<Particle>& particles, const SimulationParam& simParam, SurfaceMesh& mesh);
+
+	const SurfaceStats& GetStats() const { return m_Stats; }
+	// 直近の抽出で使った楕円体のカーネル (Anisotropic の場合。粒子と同じ順番)
+	const std::vector<EllipsoidKernel>& GetKernels() const { return m_Kernels; }
+	const AnisotropyStats& GetAnisotropyStats() const { return m_Anisotropy.GetStats(); }
+
+	/// <summary>
+	/// mesh をバイナリのPLY (位置・法線・三角形) で書き込みます
+	/// </summary>
+	static bool WritePLY(const SurfaceMesh& mesh, const std::string& path);
+
+private:
+	// 楕円体のカーネルの形 (x^T Shape x < 1 の範囲に届く) と、届く範囲を囲む箱の半分の大きさ
+	struct KernelShape
+	{
+		float Shape[6]; // xx, xy, xz, yy, yz, zz
+		Vector3D Extent;
+	};
+
+	std::unique_ptr<ThreadPool> m_pThreadPool;
+	AnisotropyEstimator m_Anisotropy;
+	SurfaceParam m_Param;
+	SurfaceStats m_Stats;
+	std::vector<EllipsoidKernel> m_Kernels;
+	// 抽出毎に使い回す作業領域
+	std::vector<int32_t> m_BlockTable;       // 粒子の範囲を覆うブロック毎の、確保したブロックの番号 (ない場合は -1。格子点の値は持たない)
+	std::vector<uint32_t> m_BlockCoords;     // 確保したブロックの m_BlockTable での位置 (昇順)
+	std::vector<uint32_t> m_ParticleBlock;   // 粒子毎の m_BlockTable での位置
+	std::vector<uint32_t> m_BlockStart;      // ブロック毎の粒子の範囲 (m_SortedPositions の先頭)
+	std::vector<Vector3D> m_SortedPositions; // ブロック順に並べた粒子の位置
+	std::vector<float> m_SortedVolumes;
+	std::vector<KernelShape> m_SortedShapes; // Anisotropic の場合のみ
+	std::vector<int32_t> m_Neighbors;        // ブロック毎の 3x3x3 の隣のブロックの番号 (ない場合は -1)
+	std::vector<float> m_Samples;            // ブロック毎の BlockSize^3 の格子点の値
+	std::vector<int32_t> m_EdgeVertices;     // ブロック毎の 格子点 × 3軸 の辺の頂点 (ブロック内の番号、ない場合は -1)
+	std::vector<std::vector<Vertex>> m_BlockVertices;
+	std::vector<std::vector<uint32_t>> m_BlockIndices;
+	std::vector<uint32_t> m_VertexOffsets;
+	std::vector<std::vector<float>> m_PaddedSamples; // スレッド毎の、隣のブロックの値を1格子分含めた (BlockSize + 3)^3 の格子点
+};
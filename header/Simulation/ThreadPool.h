@@ -0,0 +1,153 @@
+#pragma once
+#include "pch.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// CPUソルバー用の固定サイズスレッドプール
+// Dispatchは全スレッド(呼び出しスレッドを含む)で同じ関数を実行し、完了まで待機する
+class ThreadPool
+{
+public:
+	// threadCount = 0 の場合はハードウェアスレッド数を使用
+	explicit ThreadPool(uint32_t threadCount = 0);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool();
+
+	uint32_t GetThreadCount() const { return m_ThreadCount; }
+
+	/// <summary>
+	/// スレッド i を論理CPU cpus[i] に固定します (スレッド0の呼び出しスレッドも固定される)
+	/// cpus が空の場合は固定を解除し、全てのCPUで動けるようにする
+	/// </summary>
+	/// <returns>全スレッドの設定に成功した場合は true (Linux・Windows以外は false)</returns>
+	bool PinThreads(const std::vector<uint32_t>& cpus);
+
+	/// <summary>
+	/// 全スレッドで func(threadIndex) を1回ずつ実行します (threadIndex 0 は呼び出しスレッド)
+	/// </summary>
+	void Dispatch(const std::function<void(uint32_t)>& func);
+
+	/// <summary>
+	/// [begin, end) を grainSize 単位のチャンクに分割し、空いたスレッドから順に func(chunkBegin, chunkEnd) を実行します
+	/// </summary>
+	void ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize,
+		const std::function<void(uint32_t, uint32_t)>& func);
+
+	/// <summary>
+	/// ParallelFor と同じくチャンクに分割し、実行しているスレッドの番号と合わせて func(threadIndex, chunkBegin, chunkEnd) を実行します
+	/// (スレッド毎のバッファに書き込んで後で合計する場合に使う)
+	/// </summary>
+	void ParallelForWithThreadIndex(uint32_t begin, uint32_t end, uint32_t grainSize,
+		const std::function<void(uint32_t, uint32_t, uint32_t)>& func);
+
+	/// <summary>
+	/// pOutput[i] = input(0) + ... + input(i - 1) となる排他的プレフィックスサムを並列に計算し、総和を返します
+	/// (スレッド毎のブロック和 -> ブロック和の走査 -> ブロック内の走査 の2パス)
+	/// </summary>
+	template<typename Input>
+	uint32_t ExclusiveScan(uint32_t count, Input&& input, uint32_t* pOutput)
+	{
+		uint32_t blockCount = std::min(m_ThreadCount, std::max(1u, count / 4096));
+		uint32_t blockSize = (count + blockCount - 1) / std::max(1u, blockCount);
+		std::vector<uint32_t> blockSums(blockCount + 1, 0);
+
+		auto runBlocks = [&](const std::function<void(uint32_t, uint32_t, uint32_t)>& func)
+		{
+			if (blockCount <= 1)
+			{
+				func(0, 0, count);
+				return;
+			}
+			Dispatch([&](uint32_t threadIndex)
+			{
+				if (threadIndex < blockCount)
+				{
+					uint32_t begin = std::min(count, threadIndex * blockSize);
+					func(threadIndex, begin, std::min(count, begin + blockSize));
+				}
+			});
+		};
+
+		// ブロック毎の合計
+		runBlocks([&](uint32_t block, uint32_t begin, uint32_t end)
+		{
+			uint32_t sum = 0;
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				sum += input(i);
+			}
+			blockSums[block + 1] = sum;
+		});
+		for (uint32_t block = 0; block < blockCount; ++block)
+		{
+			blockSums[block + 1] += blockSums[block];
+		}
+		// ブロック先頭のオフセットから走査
+		runBlocks([&](uint32_t block, uint32_t begin, uint32_t end)
+		{
+			uint32_t sum = blockSums[block];
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				uint32_t value = input(i);
+				pOutput[i] = sum;
+				sum += value;
+			}
+		});
+		return blockSums[blockCount];
+	}
+
+	/// <summary>
+	/// value = combine(value, map(i)) を [0, count) で並列に畳み込みます (max・総和などのリダクション)
+	/// ReduceBlockSize 個ずつのブロックの部分結果を、最後にブロック順で畳み込む
+	/// ブロックの区切りと畳み込む順番はスレッド数によらないので、浮動小数点の総和もスレッド数に関係なく同じ値になる
+	/// </summary>
+	template<typename T, typename Map, typename Combine>
+	T ParallelReduce(uint32_t count, T identity, Map&& map, Combine&& combine)
+	{
+		uint32_t blockCount = std::max(1u, (count + ReduceBlockSize - 1) / ReduceBlockSize);
+		std::vector<T> blockResults(blockCount, identity);
+
+		ParallelFor(0, blockCount, 1, [&](uint32_t beginBlock, uint32_t endBlock)
+		{
+			for (uint32_t block = beginBlock; block < endBlock; ++block)
+			{
+				T value = identity;
+				uint32_t end = std::min(count, (block + 1) * ReduceBlockSize);
+				for (uint32_t i = block * ReduceBlockSize; i < end; ++i)
+				{
+					value = combine(value, map(i));
+				}
+				blockResults[block] = value;
+			}
+		});
+
+		T result = identity;
+		for (const T& value : blockResults)
+		{
+			result = combine(result, value);
+		}
+		return result;
+	}
+
+	// ParallelReduce のブロックの大きさ
+	static const uint32_t ReduceBlockSize = 4096;
+
+private:
+	void WorkerLoop(uint32_t threadIndex);
+
+	uint32_t m_ThreadCount = 1;
+	std::vector<std::thread> m_Workers;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_StartCondition;
+	std::condition_variable m_FinishCondition;
+	const std::function<void(uint32_t)>* m_pJob = nullptr;
+	uint64_t m_Generation = 0; // Dispatch毎に増える世代番号
+	uint32_t m_PendingWorkers = 0;
+	bool m_IsShutdown = false;
+};
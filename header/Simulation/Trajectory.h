@@ -0,0 +1,139 @@
+#pragma once
+#include "pch.h"
+#include "Simulation/SPHTypes.h"
+
+#include <cstdio>
+
+class ThreadPool;
+
+// 軌跡ファイルの設定
+struct TrajectoryParam
+{
+	uint32_t PositionBits = 16;      // 位置の成分毎のビット数 (壁の範囲 + WallMargin を 2^bits - 1 等分、1 .. 24)
+	float WallMargin = 0.0625f;      // 壁を少し突き抜けた粒子も丸めずに表せるよう、位置の範囲を壁の範囲のこの割合だけ両側に広げる
+	uint32_t VelocityBits = 12;      // 速度の成分毎のビット数 (1 .. 24)
+	float VelocityRange = 16.0f;     // 速度の成分の範囲 [-VelocityRange, VelocityRange] (超えた値は丸める)
+	uint32_t KeyframeInterval = 32;  // キーフレーム (前のフレームとの差分ではなく値そのもの) を置く間隔 (フレーム数)
+	uint32_t ChunkSize = 32768;      // エントロピー符号化の単位の粒子数 (チャンク毎に並列に符号化する)
+};
+
+// 書き込んだフレームの統計
+struct TrajectoryStats
+{
+	uint32_t FrameCount = 0;
+	uint32_t KeyframeCount = 0;
+	uint64_t RawBytes = 0;     // 同じフレームを Particle (48byte) のまま書いた場合のバイト数
+	uint64_t EncodedBytes = 0; // フレームのヘッダーを含む書き込んだバイト数
+	double EncodeMilliseconds = 0.0; // 量子化・差分・符号化の時間 (ファイルへの書き込みを除く)
+
+	double CompressionRatio() const { return EncodedBytes > 0 ? static_cast<double>(RawBytes) / EncodedBytes : 0.0; }
+};
+
+// 読み込んだ1フレーム (粒子ID順)
+struct TrajectoryFrame
+{
+	double Time = 0.0;
+	std::vector<Vector3D> Positions;
+	std::vector<Vector3D> Velocities;
+};
+
+/// <summary>
+/// 粒子の位置・速度の軌跡を圧縮して書き込みます
+/// 位置は壁の範囲 (WallMin/WallMax)、速度は ±VelocityRange に対して成分毎に量子化し、前のフレームの量子化値との差分を
+/// zigzag + 可変長整数にしてから、ChunkSize 粒子のチャンク毎に rANS (0次のバイト頻度) で符号化する
+/// KeyframeInterval フレーム毎と粒子が減ったフレームはキーフレームにして、途中のフレームから読めるようにする
+/// 差分は量子化した値同士で取るので、フレームを重ねても誤差は量子化の刻みの半分から増えない
+/// </summary>
+class TrajectoryWriter
+{
+public:
+	// threadCount = 0 の場合はハードウェアスレッド数を使用
+	explicit TrajectoryWriter(uint32_t threadCount = 0);
+	TrajectoryWriter(const TrajectoryWriter&) = delete;
+	TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+	~TrajectoryWriter();
+
+	bool Open(const std::string& path, const Vector3D& wallMin, const Vector3D& wallMax, const TrajectoryParam& param = TrajectoryParam());
+	/// <summary>
+	/// 1フレームを書き込みます。particles は粒子ID順 (CPUFluidSolver::CopyParticlesInIdOrder)
+	/// 粒子が増えた場合、増えた粒子は0からの差分にする
+	/// </summary>
+	bool WriteFrame(const std::vector<Particle>& particles, double time);
+	/// <summary>
+	/// フレームの索引を書いて閉じます (閉じずに終わったファイルも、読む時にフレームを先頭から辿って開ける)
+	/// </summary>
+	bool Close();
+	bool IsOpen() const { return m_pFile != nullptr; }
+
+	const TrajectoryStats& GetStats() const { return m_Stats; }
+
+private:
+	struct IndexEntry
+	{
+		uint64_t Offset;
+		uint32_t Flags;
+		uint32_t ParticleCount;
+	};
+
+	std::unique_ptr<ThreadPool> m_pThreadPool;
+	std::FILE* m_pFile = nullptr;
+	uint64_t m_FileOffset = 0;
+	TrajectoryParam m_Param;
+	Vector3D m_WallMin;
+	Vector3D m_WallMax;
+	std::vector<uint32_t> m_Quantized;     // 今のフレームの量子化値 (粒子毎に6成分)
+	std::vector<uint32_t> m_PrevQuantized; // 前のフレームの量子化値
+	std::vector<std::vector<uint8_t>> m_Chunks; // チャンク毎の符号化結果
+	std::vector<IndexEntry> m_Index;
+	TrajectoryStats m_Stats;
+};
+
+/// <summary>
+/// TrajectoryWriter で書いたファイルを読みます
+/// 任意のフレームは直前のキーフレームから差分を足して復元する (順番に読む場合は前のフレームから1フレーム分だけ復号する)
+/// </summary>
+class TrajectoryReader
+{
+public:
+	explicit TrajectoryReader(uint32_t threadCount = 0);
+	TrajectoryReader(const TrajectoryReader&) = delete;
+	TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+	~TrajectoryReader();
+
+	bool Open(const std::string& path);
+	void Close();
+
+	uint32_t GetFrameCount() const { return static_cast<uint32_t>(m_Index.size()); }
+	const TrajectoryParam& GetParam() const { return m_Param; }
+	const Vector3D& GetWallMin() const { return m_WallMin; }
+	const Vector3D& GetWallMax() const { return m_WallMax; }
+	bool IsKeyframe(uint32_t frameIndex) const;
+
+	/// <summary>
+	/// frameIndex のフレームを復元します
+	/// </summary>
+	/// <returns>ファイルが壊れている場合は false</returns>
+	bool ReadFrame(uint32_t frameIndex, TrajectoryFrame& frame);
+
+private:
+	struct IndexEntry
+	{
+		uint64_t Offset;
+		uint32_t Flags;
+		uint32_t ParticleCount;
+	};
+
+	// frameIndex のフレームの差分を m_Quantized に足す (キーフレームでは置き換える)
+	bool DecodeFrame(uint32_t frameIndex, double& time);
+
+	std::unique_ptr<ThreadPool> m_pThreadPool;
+	std::FILE* m_pFile = nullptr;
+	TrajectoryParam m_Param;
+	Vector3D m_WallMin;
+	Vector3D m_WallMax;
+	std::vector<IndexEntry> m_Index;
+	std::vector<uint32_t> m_Quantized;
+	int64_t m_DecodedFrame = -1; // m_Quantized が表しているフレーム
+	double m_DecodedTime = 0.0;
+	std::vector<uint8_t> m_Payload;
+};
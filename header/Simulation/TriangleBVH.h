@@ -0,0 +1,133 @@
+#pragma once
+#include "pch.h"
+#include "Math/Vector3D.h"
+
+#include <cfloat>
+
+class ThreadPool;
+
+// CPU側の三角形メッシュ (位置と三角形毎に3つのインデックス)
+struct TriangleMesh
+{
+	std::vector<Vector3D> Positions;
+	std::vector<uint32_t> Indices;
+
+	uint32_t GetTriangleCount() const { return static_cast<uint32_t>(Indices.size() / 3); }
+	/// <summary>
+	/// OBJ の頂点と面を読みます (多角形は扇形に三角形化し、法線・UV は読まない)
+	/// </summary>
+	/// <returns>開けない場合や三角形がない・範囲外の番号がある場合は false</returns>
+	bool LoadOBJ(const std::string& path);
+};
+
+// 点 p に最も近い三角形 abc 上の点 (Ericson, "Real-Time Collision Detection" 5.1.5)
+Vector3D ClosestPointOnTriangle(const Vector3D& p, const Vector3D& a, const Vector3D& b, const Vector3D& c);
+
+// BVHのノード (32byte。2つの子は並べて置くので左の子の番号だけを持つ)
+struct BVHNode
+{
+	Vector3D BoundsMin;
+	uint32_t LeftOrFirst = 0;   // 内部ノードは左の子 (右の子は +1)、葉は並べ替えた三角形の先頭
+	Vector3D BoundsMax;
+	uint32_t TriangleCount = 0; // 0 なら内部ノード
+
+	bool IsLeaf() const { return TriangleCount > 0; }
+};
+static_assert(sizeof(BVHNode) == 32, "BVHNode must be 32 bytes");
+
+// BVHの構築の設定
+struct BVHBuildParam
+{
+	uint32_t BinCount = 16;             // SAH を評価する軸毎のビンの数 (最大 MaxBinCount)
+	uint32_t MaxLeafSize = 8;           // 葉の三角形の上限 (分けない方が SAH のコストが低くても、これより多ければ分ける)
+	float TraversalCost = 1.0f;         // 三角形1つとの交差判定に対する、ノード1つを辿るコストの比
+	uint32_t ParallelThreshold = 16384; // これより三角形の多いノードはビン分けを並列に行い、少ない部分木はまとめてスレッドに配る
+
+	static const uint32_t MaxBinCount = 64;
+};
+
+// 直近の構築の統計
+struct BVHBuildStats
+{
+	uint32_t TriangleCount = 0;
+	uint32_t NodeCount = 0;
+	uint32_t LeafCount = 0;
+	uint32_t MaxDepth = 0;
+	float SAHCost = 0.0f;             // 根の表面積に対する期待コスト (三角形1つとの交差判定を1とする)
+	double BuildMilliseconds = 0.0;
+};
+
+struct BVHRay
+{
+	Vector3D Origin;
+	Vector3D Direction;           // 正規化しなくてよい (距離は Direction の長さを単位にする)
+	float MaxDistance = FLT_MAX;
+};
+
+struct BVHRayHit
+{
+	float Distance = FLT_MAX;        // 交点は Origin + Direction * Distance
+	uint32_t Triangle = UINT32_MAX;  // 元のインデックスでの三角形の番号 (当たらなかった場合は UINT32_MAX)
+	float U = 0.0f;                  // 重心座標 (交点 = (1 - U - V) * a + U * b + V * c)
+	float V = 0.0f;
+
+	bool IsHit() const { return Triangle != UINT32_MAX; }
+};
+
+struct BVHClosestHit
+{
+	Vector3D Position;               // 三角形上の最も近い点
+	float Distance = FLT_MAX;
+	uint32_t Triangle = UINT32_MAX;  // maxDistance 以内に三角形がなかった場合は UINT32_MAX
+
+	bool IsHit() const { return Triangle != UINT32_MAX; }
+};
+
+/// <summary>
+/// 三角形メッシュの BVH (ビン分けした SAH で2分割し、レイと最近点の問い合わせを O(log 三角形数) 程度で行います)
+/// 三角形の多い上の方のノードはビン分けを並列に行い、下の方の部分木はスレッド毎にまとめて作る
+/// 三角形は葉の順に並べ替えて頂点と辺をまとめて持つので、構築後は元の positions / indices を参照しない
+/// </summary>
+class TriangleBVH
+{
+public:
+	TriangleBVH() = default;
+
+	/// <returns>三角形がない場合や範囲外のインデックスがある場合は false</returns>
+	bool Build(const std::vector<Vector3D>& positions, const std::vector<uint32_t>& indices, const BVHBuildParam& param, ThreadPool& threadPool);
+	bool Build(const TriangleMesh& mesh, const BVHBuildParam& param, ThreadPool& threadPool) { return Build(mesh.Positions, mesh.Indices, param, threadPool); }
+
+	/// <summary>
+	/// ray と最も近くで交わる三角形 (裏面も当たる)
+	/// </summary>
+	bool Raycast(const BVHRay& ray, BVHRayHit& hit) const;
+	/// <summary>
+	/// position から maxDistance 以内で最も近い三角形上の点
+	/// </summary>
+	bool FindClosestPoint(const Vector3D& position, float maxDistance, BVHClosestHit& hit) const;
+
+	// 多数の問い合わせをスレッドに分けて行う (pHits[i] が i 番目の結果)
+	void RaycastBatch(const BVHRay* pRays, uint32_t count, BVHRayHit* pHits, ThreadPool& threadPool) const;
+	void FindClosestPointBatch(const Vector3D* pPositions, uint32_t count, float maxDistance, BVHClosestHit* pHits, ThreadPool& threadPool) const;
+
+	bool IsEmpty() const { return m_Nodes.empty(); }
+	const std::vector<BVHNode>& GetNodes() const { return m_Nodes; }
+	const BVHBuildStats& GetStats() const { return m_Stats; }
+
+	// 辿る時のスタックの深さ (構築はこれを超えないよう深いノードを中央で分ける)
+	static const uint32_t MaxStackDepth = 96;
+
+private:
+	// 葉の順に並べた三角形 (交差判定の形のまま持つ)
+	struct Triangle
+	{
+		Vector3D V0;
+		Vector3D Edge1; // V1 - V0
+		Vector3D Edge2; // V2 - V0
+	};
+
+	std::vector<BVHNode> m_Nodes;
+	std::vector<Triangle> m_Triangles;
+	std::vector<uint32_t> m_TriangleIds; // 並べ替えた三角形の元の番号
+	BVHBuildStats m_Stats;
+};
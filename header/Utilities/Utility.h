@@ -38,7 +38,7 @@ namespace Utility
         return erasePath;
     }
 
-    //! @brief eNX`t@Ĉݎo
+    //! @brief テクスチャファイル名のみ取り出す
     inline std::wstring FileOnlyName(const std::wstring& path)
     {
         auto idx = path.rfind(L'/');
@@ -1,13 +1,13 @@
 #pragma once
 
 #if defined(DEBUG) || defined(_DEBUG)
+#if defined(_WIN32)
 #define _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
 #endif
+#endif
 
 #include <iostream>
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
 #include <cstdint>
 #include <cassert>
 #include <cmath>
@@ -17,6 +17,16 @@
 #include <chrono>
 #include <filesystem>
 #include <unordered_map>
+#include <vector>
+#include <memory>
+
+#define SMALL_NUMBER 1.e-8f
+
+// DirectX 12関連はWindowsビルドのみ (ヘッドレスのCPUシミュレーションはLinuxでもビルドする)
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX // std::min/std::maxとの衝突回避
+#include <Windows.h>
 #include <d3d12.h>
 #include <dxgi1_4.h>
 #include <DirectXTex.h>
@@ -24,7 +34,6 @@
 #include <wrl/client.h>
 
 template<typename T> using ComPtr = Microsoft::WRL::ComPtr<T>;
-#define SMALL_NUMBER 1.e-8f
 
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -32,9 +41,10 @@ template<typename T> using ComPtr = Microsoft::WRL::ComPtr<T>;
 #pragma comment(lib, "d3dcompiler.lib")
 #pragma comment(lib, "DirectXTex.lib")
 #ifdef _DEBUG
-// Debug\̂Ƃ ( 'd' Ƃ)
+// Debug構成のとき (末尾に 'd' がつくことが多い)
 #pragma comment(lib, "assimp-vc143-mtd.lib")
 #else
-// Release\̂Ƃ
+// Release構成のとき
 #pragma comment(lib, "assimp-vc143-mt.lib")
+#endif
 #endif
\ No newline at end of file
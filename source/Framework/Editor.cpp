@@ -2,6 +2,10 @@
 #include "Framework/Scene.h"
 
 #include "Graphics/Model.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/Camera.h"
+#include "Simulation/TriangleBVH.h"
+#include "Simulation/ThreadPool.h"
 
 #include <imgui.h>
 
@@ -22,9 +26,74 @@ void Editor::Update(float deltaTime)
 	ImGui::Begin("FPS");
 
 	ImGui::Text("FPS: %f", 1 / deltaTime);
+	// ImGuiのウィンドウの上以外をクリックした場合はモデルを選ぶ
+	ImGuiIO& io = ImGui::GetIO();
+	if (m_pScene != nullptr && ImGui::IsMouseClicked(0) && !io.WantCaptureMouse && io.DisplaySize.x > 0.0f && io.DisplaySize.y > 0.0f)
+	{
+		PickModel(io.MousePos.x / io.DisplaySize.x, io.MousePos.y / io.DisplaySize.y);
+	}
+	if (hierachySelectedModel != nullptr)
+	{
+		ImGui::Text("Selected: %s (distance %.2f, %.3f ms)", hierachySelectedModel->GetName().c_str(), m_PickDistance, m_PickMilliseconds);
+	}
 	ImGui::End();
 }
 
+void Editor::PickModel(float x, float y)
+{
+	auto pickStart = std::chrono::high_resolution_clock::now();
+	if (m_pThreadPool == nullptr)
+	{
+		m_pThreadPool = std::make_unique<ThreadPool>();
+	}
+	// ビュー空間のレイ (左手系で +z が前)
+	Camera* pCamera = m_pScene->GetCamera();
+	const float ndcX = 2.0f * x - 1.0f;
+	const float ndcY = 1.0f - 2.0f * y;
+	Vector3D viewOrigin(0.0f, 0.0f, 0.0f);
+	Vector3D viewPoint;
+	if (pCamera->GetProjectionMode() == Camera::Perspective)
+	{
+		// 視点から z = 1 の面の点を通る
+		const float tanHalfFov = std::tan(pCamera->GetFovY() * 0.5f);
+		viewPoint = Vector3D(ndcX * tanHalfFov * pCamera->GetAspect(), ndcY * tanHalfFov, 1.0f);
+	}
+	else
+	{
+		// 正射影は幅・高さの面のクリックした点から +z に平行に飛ばす
+		viewOrigin = Vector3D(ndcX * pCamera->GetWidth() * 0.5f, ndcY * pCamera->GetHeight() * 0.5f, 0.0f);
+		viewPoint = viewOrigin + Vector3D(0.0f, 0.0f, 1.0f);
+	}
+	const Matrix4x4& viewInv = pCamera->GetViewInv();
+	const Vector3D origin = Matrix4x4::Apply(viewInv, viewOrigin);
+	const Vector3D target = Matrix4x4::Apply(viewInv, viewPoint);
+
+	// モデル毎にレイをローカル座標に移して引く (アフィン変換なのでレイのパラメータ t はワールドと同じ)
+	hierachySelectedModel = nullptr;
+	float bestDistance = FLT_MAX;
+	for (const auto& pModel : m_pScene->GetModels())
+	{
+		const Matrix4x4 invWorld = Matrix4x4::inverse(pModel->GetTransform().World);
+		BVHRay ray;
+		ray.Origin = Matrix4x4::Apply(invWorld, origin);
+		ray.Direction = Matrix4x4::Apply(invWorld, target) - ray.Origin;
+		for (const auto& pMesh : pModel->GetMeshes())
+		{
+			// BVH は最初にピッキングした時に作る
+			const TriangleBVH& bvh = (pMesh->GetBVH() != nullptr) ? *pMesh->GetBVH() : pMesh->BuildBVH(*m_pThreadPool);
+			ray.MaxDistance = bestDistance;
+			BVHRayHit hit;
+			if (bvh.Raycast(ray, hit))
+			{
+				bestDistance = hit.Distance;
+				hierachySelectedModel = pModel.get();
+			}
+		}
+	}
+	m_PickDistance = (hierachySelectedModel != nullptr) ? bestDistance * (target - origin).length() : 0.0f;
+	m_PickMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - pickStart).count();
+}
+
 void Editor::SetScene(Scene* newScene)
 {
 	m_pScene = newScene;
@@ -36,7 +105,7 @@ void Editor::ImGuiStyleSettings()
 	io.Fonts->AddFontDefault();
 	io.Fonts->Build();
 
-	// X^C
+	// スタイル
 	ImGuiStyle& style = ImGui::GetStyle();
 	style.ScrollbarRounding = 2;
 	style.ScrollbarSize = 12;
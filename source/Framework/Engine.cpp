@@ -22,10 +22,10 @@ namespace EngineInternal
 using namespace EngineInternal;
 
 /// <summary>
-/// RXgN^
+/// コンストラクタ
 /// </summary>
-/// <param name="width"> EBhẺ </param>
-/// <param name="height"> EBhȄc </param>
+/// <param name="width"> ウィンドウの横幅 </param>
+/// <param name="height"> ウィンドウの縦幅 </param>
 Engine::Engine(uint32_t width, uint32_t height)
 {
 	RegisterWindowClass();
@@ -41,7 +41,7 @@ Engine::Engine(uint32_t width, uint32_t height)
 }
 
 /// <summary>
-/// fXgN^
+/// デストラクタ
 /// </summary>
 Engine::~Engine()
 {
@@ -51,7 +51,7 @@ Engine::~Engine()
 }
 
 /// <summary>
-/// s܂D
+/// 実行します．
 /// </summary>
 void Engine::Run()
 {
@@ -61,31 +61,31 @@ void Engine::Run()
 
 void Engine::RegisterWindowClass()
 {
-	// EBhE̐ݒ
+	// ウィンドウの設定
 	WNDCLASSEX wc = {};
-	wc.cbSize = sizeof(WNDCLASSEX); // WNDCLASSEX\̂̃TCYݒ
-	wc.style = CS_HREDRAW | CS_VREDRAW; // EBhẼX^Cݒ
-	wc.lpfnWndProc = WindowProc; // EBhEvV[W̊֐|C^ݒ
-	wc.hIcon = LoadIcon(nullptr, IDI_APPLICATION); // AvP[ṼACRݒ
-	wc.hbrBackground = GetSysColorBrush(COLOR_BACKGROUND); // wiFݒ
-	wc.lpszMenuName = nullptr; // j[ݒ肵Ȃ
-	wc.lpszClassName = Utility::windowClassName.c_str(); // EBhENXݒ
-	wc.hIconSm = LoadIcon(nullptr, IDI_APPLICATION); // ACRݒ
-
-	// EBhENX̓o^
+	wc.cbSize = sizeof(WNDCLASSEX); // WNDCLASSEX構造体のサイズを設定
+	wc.style = CS_HREDRAW | CS_VREDRAW; // ウィンドウのスタイルを設定
+	wc.lpfnWndProc = WindowProc; // ウィンドウプロシージャの関数ポインタを設定
+	wc.hIcon = LoadIcon(nullptr, IDI_APPLICATION); // アプリケーションのアイコンを設定
+	wc.hbrBackground = GetSysColorBrush(COLOR_BACKGROUND); // 背景色を設定
+	wc.lpszMenuName = nullptr; // メニュー名を設定しない
+	wc.lpszClassName = Utility::windowClassName.c_str(); // ウィンドウクラス名を設定
+	wc.hIconSm = LoadIcon(nullptr, IDI_APPLICATION); // 小さいアイコンを設定
+
+	// ウィンドウクラスの登録
 	static auto atom = RegisterClassEx(&wc);
 	assert(atom > 0);
 }
 
 /// <summary>
-/// AvIs܂D
+/// アプリ終了処理を行います．
 /// </summary>
 void Engine::TermApplication()
 {
 }
 
 /// <summary>
-/// C[vł.
+/// メインループです.
 /// </summary>
 void Engine::MainLoop()
 {
@@ -94,9 +94,9 @@ void Engine::MainLoop()
 	{
 		if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE) == TRUE)
 		{
-			// bZ[Wϊ
+			// メッセージを変換
 			TranslateMessage(&msg);
-			// bZ[WfBXpb`
+			// メッセージをディスパッチ
 			DispatchMessage(&msg);
 		}
 		else
@@ -141,12 +141,12 @@ void Engine::Render()
 }
 
 /// <summary>
-/// EBhEvV[WłD
+/// ウィンドウプロシージャです．
 /// </summary>
-/// <param name="hWnd"> EBhEnh </param>
-/// <param name="message"> bZ[W </param>
-/// <param name="wParam"> ǉ̃bZ[W </param>
-/// <param name="lParam"> ǉ̃bZ[W </param>
+/// <param name="hWnd"> ウィンドウハンドル </param>
+/// <param name="message"> メッセージ </param>
+/// <param name="wParam"> 追加のメッセージ情報 </param>
+/// <param name="lParam"> 追加のメッセージ情報 </param>
 /// <returns></returns>
 LRESULT Engine::WindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
@@ -154,7 +154,7 @@ LRESULT Engine::WindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 	{
 		case WM_DESTROY:
 		{
-			PostQuitMessage(0); // AvP[V̏Iʒm
+			PostQuitMessage(0); // アプリケーションの終了を通知
 			break;
 		}
 		case WM_SIZE:
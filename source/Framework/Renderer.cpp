@@ -28,35 +28,35 @@
 #include <backends/imgui_impl_dx12.h>
 
 /// <summary>
-/// RXgN^
+/// コンストラクタ
 /// </summary>
-/// <param name="width"> EBhẺ </param>
-/// <param name="height"> EBhȄc </param>
+/// <param name="width"> ウィンドウの横幅 </param>
+/// <param name="height"> ウィンドウの縦幅 </param>
 Renderer::Renderer(uint32_t width, uint32_t height)
 {
-	// foCX̐
+	// デバイスの生成
 	m_pDevice = std::make_unique<DX12Device>();
 	auto pDevice = m_pDevice->GetDevice().Get();
-	// fBXNv^q[v̐
+	// ディスクリプタヒープの生成
 	m_pRTVHeap = std::make_unique<DX12DescriptorHeap>(pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, "RTVHeap", 128);
 	m_pDSVHeap = std::make_unique<DX12DescriptorHeap>(pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, "DSVHeap", 8);
 	m_pCBV_SRV_UAV = std::make_unique<DX12DescriptorHeap>(pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, "CBV_SRV_UAVHeap", 5000, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
-	// R}h̐
+	// コマンドの生成
 	m_pDirectCommand = std::make_unique<DX12Commands>(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT);
 	m_pCopyCommand = std::make_unique<DX12Commands>(pDevice, D3D12_COMMAND_LIST_TYPE_COPY);
 
-	// EBhE̍쐬
+	// ウィンドウの作成
 	m_pWindow = std::make_unique<Window>(this, Utility::windowClassName, width, height);
 	m_Width = width;
 	m_Height = height;
 
-	// ~bVOpeNX`̍쐬
+	// ミッシング用テクスチャの作成
 	m_pMissingTextures = std::make_unique<Texture>(this, Utility::GetCurrentDir() + L"/assets/textures/White_Missing.png");
 	CreateConstantBuffer();
 
 	InitializeImGui();
 
-	// _[Xe[W̍쐬
+	// レンダーステージの作成
 	m_pFluidStage = std::make_unique<FluidStage>(this);
 }
 
@@ -66,24 +66,24 @@ Renderer::~Renderer()
 
 void Renderer::NewFrame()
 {
-	// t[Ƃ̏
+	// フレームごとの初期化処理
 	m_CurrentOffset = 0;
 }
 
 /// <summary>
-/// `揈
+/// 描画処理
 /// </summary>
 void Renderer::Render()
 {
-	// R}hXg擾
+	// コマンドリストを取得
 	auto pCommandList = m_pDirectCommand->GetGraphicsCommandList().Get();
-	// R}h̋L^JnƃZbg
+	// コマンドの記録を開始とリセット
 	m_pDirectCommand->ResetCommand();
 
 	//pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	//pCommandList->SetDescriptorHeaps(1, m_pCBV_SRV_UAV->GetHeap().GetAddressOf());
 
-	// \[XoA̐ݒ
+	// リソースバリアの設定
 	TransitionResource(m_pWindow->GetCurrentScreenBuffer(),
 		D3D12_RESOURCE_STATE_PRESENT,
 		D3D12_RESOURCE_STATE_RENDER_TARGET);
@@ -91,30 +91,30 @@ void Renderer::Render()
 	m_pFluidStage->RecordStage(pCommandList);
 	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), pCommandList);
 
-	// \[XoA̐ݒ
+	// リソースバリアの設定
 	TransitionResource(m_pWindow->GetCurrentScreenBuffer(),
 		D3D12_RESOURCE_STATE_RENDER_TARGET,
 		D3D12_RESOURCE_STATE_PRESENT);
-	// R}hXg̎s
+	// コマンドリストの実行
 	m_pDirectCommand->ExecuteCommandList();
 
-	// ʂɕ\
+	// 画面に表示
 	m_pWindow->Present(1);
 
-	// GPȔҋ@
+	// GPUの処理完了を待機
 	m_pDirectCommand->WaitGpu(INFINITE);
 }
 
 void Renderer::Update(float deltaTime)
 {
 	m_pFluidStage->Update(deltaTime);
-	// R}h̋L^JnƃZbg
+	// コマンドの記録を開始とリセット
 	m_pDirectCommand->ResetCommand();
 
 	m_pFluidStage->UpdateSimulationGrid(deltaTime);
 	//m_pFluidStage->UpdateSimulation(deltaTime);
 
-	// R}hXg̎s
+	// コマンドリストの実行
 	m_pDirectCommand->ExecuteCommandList();
 
 }
@@ -170,7 +170,7 @@ void Renderer::TransitionResource(ID3D12Resource* resource,
 	D3D12_RESOURCE_STATES afterState)
 {
 	ID3D12GraphicsCommandList* pCmdList = m_pDirectCommand->GetGraphicsCommandList().Get();
-	// \[XoA̐ݒ
+	// リソースバリアの設定
 	D3D12_RESOURCE_BARRIER barrior = {};
 	barrior.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 	barrior.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
@@ -179,7 +179,7 @@ void Renderer::TransitionResource(ID3D12Resource* resource,
 	barrior.Transition.StateAfter = afterState;
 	barrior.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
 
-	// \[XoA
+	// リソースバリア
 	pCmdList->ResourceBarrier(1, &barrior);
 }
 
@@ -10,8 +10,8 @@ Scene::Scene(Renderer* pRenderer, uint32_t width, uint32_t height)
 {
 	m_pCamera = std::make_unique<Camera>(width, height);
 	m_pRenderer = pRenderer;
-	// _OJnOɃCgobt@K؂ɍXV悤ɂ邽
-	// ftHgł͂trueɐݒ
+	// レンダリングを開始する前にライトバッファが適切に更新されるようにするため
+	// デフォルトではこれをtrueに設定
 	m_IsEditedLight = true;
 }
 
@@ -24,7 +24,7 @@ void Scene::Update(float deltaTime)
 	m_SceneRuntime += deltaTime;
 	if (m_IsEditedLight)
 	{
-		// Cgobt@̍XV
+		// ライトバッファの更新処理
 		m_IsEditedLight = false;
 	}
 
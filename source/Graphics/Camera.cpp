@@ -15,30 +15,30 @@ Camera::~Camera()
 
 void Camera::Update()
 {
-	// vWFNVšvZ
+	// プロジェクション行列の計算
 	if (m_ProjMove == ProjectionMode::Perspective)
 		m_Proj = Matrix4x4::setPerspectiveFovLH(m_FovY, m_Aspect, m_Near, m_Far);
 	else
 		m_Proj = Matrix4x4::setOrthoLH(m_Width, m_Height, m_Near, m_Far);
 
-	// r[švZ
+	// ビュー行列の計算
 	m_View = Matrix4x4::setLookAtLH(m_Position, m_Target, m_Upward);
-	// r[tšvZ
+	// ビュー逆行列の計算
 	m_ViewInv = Matrix4x4::inverse(m_View);
 
-	// JǑvZ
+	// カメラ前方方向の計算
 	m_Forward = Vector3D(m_ViewInv.m_mat[2][0], m_ViewInv.m_mat[2][1], m_ViewInv.m_mat[2][2]);
-	// JE
+	// カメラ右方向
 	m_Right = Vector3D(m_ViewInv.m_mat[0][0], m_ViewInv.m_mat[0][1], m_ViewInv.m_mat[0][2]);
 
-	// J̉]s擾
+	// カメラの回転行列を取得
 	m_cameraRotation = m_ViewInv;
 	m_cameraRotation.m_mat[3][0] = 0.0f;
 	m_cameraRotation.m_mat[3][1] = 0.0f;
 	m_cameraRotation.m_mat[3][2] = 0.0f;
 	m_cameraRotation.m_mat[3][3] = 1.0f;
 
-	// _Ǝ_܂ł̋vZ
+	// 注視点と視点までの距離を計算
 	Vector3D toPos;
 	toPos = m_Position - m_Target;
 	m_targetToPositionLen = toPos.length();
@@ -46,14 +46,14 @@ void Camera::Update()
 	m_IsDirty = false;
 }
 
-//! @brief __ƂăJ]
-//! @param[in] ]NH[^jI
+//! @brief 注視点を原点としてカメラを回転させる
+//! @param[in] 回転させるクォータニオン
 void Camera::RotateOriginTarget(const Quaternion& qRot)
 {
 }
 
-//! @brief J𓮂
-//! @param[in] ړ
+//! @brief カメラを動かす
+//! @param[in] 移動量
 void Camera::Move(const Vector3D& move)
 {
 	m_Position += move;
@@ -61,23 +61,23 @@ void Camera::Move(const Vector3D& move)
 	m_IsDirty = true;
 }
 
-//! @brief _𓮂
-//! @param[in] ړ
+//! @brief 注視点を動かす
+//! @param[in] 移動量
 void Camera::MoveTarget(const Vector3D& move)
 {
 	m_Target += move;
 	m_IsDirty = true;
 }
 
-//! @brief _𓮂
-//! @param[in] ړ
+//! @brief 視点を動かす
+//! @param[in] 移動量
 void Camera::MovePosition(const Vector3D& move)
 {
 	m_Position += move;
 	m_IsDirty = true;
 }
 
-//! @brief J̑OɈړ
+//! @brief カメラの前方方向に移動
 void Camera::MoveForward(float moveForward)
 {
 	auto forward = m_Forward * moveForward;
@@ -101,7 +101,7 @@ void Camera::Reset()
 	SetPositionAndTarget(Vector3D(0.0f, 0.0f, -5.0f), Vector3D(0.0f, 0.0f, 0.0f));
 }
 
-//! @brief J̈ʒuݒ
+//! @brief カメラの位置を設定
 void Camera::SetPosition(const Vector3D& pos)
 {
 	m_Position = pos;
@@ -11,18 +11,18 @@ ConstantBuffer::~ConstantBuffer()
 {
 }
 
-//! @brief CB̍쐬
-//! @param[in] pDevice  foCX
-//! @param[in] size		f[^̃TCY
-//! @param[in] name		CB̖O
-//! @param[in] srcData  }bsOobt@̃|C^
-//! @return CB̍쐬ɐ
+//! @brief CBの作成
+//! @param[in] pDevice  デバイス
+//! @param[in] size		データのサイズ
+//! @param[in] name		CBの名前
+//! @param[in] srcData  マッピングするバッファのポインタ
+//! @return CBの作成に成功したか
 void ConstantBuffer::Init(ID3D12Device* pDevice, uint32_t size, const std::string& name, void* srcData)
 {
 	if (pDevice == nullptr || size == 0)
-		assert(false && "RX^gobt@̃TCY0ł.");
+		assert(false && "コンスタントバッファのサイズが0です.");
 
-	// q[vvpeB
+	// ヒーププロパティ
 	D3D12_HEAP_PROPERTIES prop = {};
 	prop.Type = D3D12_HEAP_TYPE_UPLOAD;
 	prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
@@ -30,11 +30,11 @@ void ConstantBuffer::Init(ID3D12Device* pDevice, uint32_t size, const std::strin
 	prop.CreationNodeMask = 1;
 	prop.VisibleNodeMask = 1;
 
-	//萔obt@256oCgACgv̂ŁA256̔{ɐ؂グ
+	//定数バッファは256バイトアライメントが要求されるので、256の倍数に切り上げる
 	m_size = size;
 	m_allocSize = (size + 256) & 0xFFFFFF00;
 
-	// \[X̐ݒ
+	// リソースの設定
 	D3D12_RESOURCE_DESC resDesc = {};
 	resDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
 	resDesc.Alignment = 0;
@@ -48,7 +48,7 @@ void ConstantBuffer::Init(ID3D12Device* pDevice, uint32_t size, const std::strin
 	resDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 	resDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-	// 萔obt@̍쐬
+	// 定数バッファの作成
 	auto hr = pDevice->CreateCommittedResource(
 		&prop,
 		D3D12_HEAP_FLAG_NONE,
@@ -59,8 +59,8 @@ void ConstantBuffer::Init(ID3D12Device* pDevice, uint32_t size, const std::strin
 	ThrowFailed(hr);
 	m_pCB->SetName(Utility::StringToWString(name).c_str());
 
-	//萔obt@CPUANZX\ȉzAhXԂɃ}bsO
-	D3D12_RANGE	readRange = { 0, 0 };		// CPUobt@ǂݍ܂Ȃݒ
+	//定数バッファをCPUからアクセス可能な仮想アドレス空間にマッピングする
+	D3D12_RANGE	readRange = { 0, 0 };		// CPUからバッファを読み込まない設定
 	hr = m_pCB->Map(0, &readRange, &m_pMappedPtr);
 	ThrowFailed(hr);
 	if (srcData != nullptr)
@@ -72,8 +72,8 @@ void ConstantBuffer::Init(ID3D12Device* pDevice, uint32_t size, const std::strin
 	m_Desc.SizeInBytes = static_cast<UINT>(m_allocSize);
 }
 
-//! @brief CB̂Ł[VRAMɃRs[if[^̍\̂炩߂킩ĂȂp
-//! @data CBdata
+//! @brief CBのでーたをVRAMにコピー（データの構造体があらかじめわかっていない時用
+//! @data CBのdata
 void ConstantBuffer::CopyToVRAM(void* data)
 {
 	std::memcpy(m_pMappedPtr, data, m_size);
@@ -13,19 +13,19 @@ DX12Commands::DX12Commands(ID3D12Device* pDevice, D3D12_COMMAND_LIST_TYPE type)
 	ID3D12CommandList* ppCmdLists[] = { m_pCommandList.Get() };
 	m_pCommandQueue->ExecuteCommandLists(_countof(ppCmdLists), ppCmdLists);
 
-	WaitGpu(INFINITE); // ҂
+	WaitGpu(INFINITE); // 完了を待つ
 }
 
 DX12Commands::~DX12Commands()
 {
-	// nh.
+	// ハンドルを閉じる.
 	if (m_FenceEvent != nullptr)
 	{
 		CloseHandle(m_FenceEvent);
 		m_FenceEvent = nullptr;
 	}
 
-	// tFXIuWFNgj.
+	// フェンスオブジェクトを破棄.
 	m_pFence.Reset();
 
 	m_pCommandList.Reset();
@@ -45,7 +45,7 @@ void DX12Commands::ExecuteCommandList()
 {
 	ThrowFailed(m_pCommandList->Close());
 
-	// R}h̎s
+	// コマンドの実行
 	ID3D12CommandList* ppCmdLists[] = { m_pCommandList.Get() };
 	m_pCommandQueue->ExecuteCommandLists(_countof(ppCmdLists), ppCmdLists);
 }
@@ -64,23 +64,23 @@ void DX12Commands::WaitGpu(uint32_t timeout)
 	assert(m_pFence.Get() != nullptr);
 	assert(m_FenceEvent != nullptr);
 
-	const auto fenceValue = m_FenceCounter; //! ݂̃t[̃tFXJE^[擾
+	const auto fenceValue = m_FenceCounter; //! 現在のフレームのフェンスカウンターを取得
 
-	// VOi
+	// シグナル処理
 	auto hr = m_pCommandQueue->Signal(m_pFence.Get(), fenceValue);
 	ThrowFailed(hr);
 
-	// JE^[𑝂₷
+	// カウンターを増やす
 	m_FenceCounter++;
 
-	// ̃t[`揈܂łΑҋ@
+	// 次のフレーム描画処理がまだであれば待機
 	if (m_pFence->GetCompletedValue() < fenceValue)
 	{
-		// ɃCxgݒ
+		// 完了時にイベントを設定
 		auto hr = m_pFence->SetEventOnCompletion(fenceValue, m_FenceEvent);
 		ThrowFailed(hr);
 
-		// ҋ@
+		// 待機処理
 		if (WAIT_OBJECT_0 != WaitForSingleObjectEx(m_FenceEvent, timeout, FALSE))
 		{
 			return;
@@ -89,7 +89,7 @@ void DX12Commands::WaitGpu(uint32_t timeout)
 }
 
 /// <summary>
-/// R}hL[쐬܂B
+/// コマンドキューを作成します。
 /// </summary>
 void DX12Commands::CreateCommandQueue(D3D12_COMMAND_LIST_TYPE type)
 {
@@ -97,7 +97,7 @@ void DX12Commands::CreateCommandQueue(D3D12_COMMAND_LIST_TYPE type)
 	desc.Type = type;
 	desc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
 	desc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
-	// GPU1OɂĂ邽0
+	// GPUが1つを前提にしているため0
 	desc.NodeMask = 0;
 
 	auto hr = m_pDevice->CreateCommandQueue(&desc, IID_PPV_ARGS(m_pCommandQueue.GetAddressOf()));
@@ -105,7 +105,7 @@ void DX12Commands::CreateCommandQueue(D3D12_COMMAND_LIST_TYPE type)
 }
 
 /// <summary>
-/// R}hXg쐬܂B
+/// コマンドリストを作成します。
 /// </summary>
 void DX12Commands::CreateCommandList(D3D12_COMMAND_LIST_TYPE type)
 {
@@ -122,11 +122,11 @@ void DX12Commands::CreateCommandList(D3D12_COMMAND_LIST_TYPE type)
 }
 
 /// <summary>
-/// R}hAP[^쐬܂B
+/// コマンドアロケータを作成します。
 /// </summary>
 void DX12Commands::CreateCommandAllocators(D3D12_COMMAND_LIST_TYPE type)
 {
-	m_pCommandAllocators.resize(Window::FrameCount); // AP[^̐TCY
+	m_pCommandAllocators.resize(Window::FrameCount); // アロケータの数分リサイズ
 	for (auto i = 0u; i < Window::FrameCount; ++i)
 	{
 		auto hr = m_pDevice->CreateCommandAllocator(
@@ -138,11 +138,11 @@ void DX12Commands::CreateCommandAllocators(D3D12_COMMAND_LIST_TYPE type)
 }
 
 /// <summary>
-/// tFX쐬܂B
+/// フェンスを作成します。
 /// </summary>
 void DX12Commands::CreateFence()
 {
-	// tFX̐
+	// フェンスの生成
 	auto hr = m_pDevice->CreateFence(
 		0,
 		D3D12_FENCE_FLAG_NONE,
@@ -150,10 +150,10 @@ void DX12Commands::CreateFence()
 	);
 	ThrowFailed(hr);
 
-	// JE^[ݒ
+	// カウンター設定
 	m_FenceCounter = 1;
 
-	// Cxg̐
+	// イベントの生成
 	m_FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 	assert(m_FenceEvent != nullptr && "Failed to create Fence Event");
 }
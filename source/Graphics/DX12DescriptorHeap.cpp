@@ -6,14 +6,14 @@ DX12DescriptorHeap::DX12DescriptorHeap(ID3D12Device* pDevice, D3D12_DESCRIPTOR_H
 	: m_NumDescriptors(numDescriptors)
 {
 	ID3D12Device* device = pDevice;
-	// fBXNv^q[v̐ݒ
+	// ディスクリプタヒープの設定
 	D3D12_DESCRIPTOR_HEAP_DESC desc = {};
 	desc.NumDescriptors = m_NumDescriptors;
 	desc.Type = type;
 	desc.Flags = flags;
 	desc.NodeMask = 0;
 
-	// fBXNv^q[v̐
+	// ディスクリプタヒープの生成
 	auto hr = device->CreateDescriptorHeap(
 		&desc,
 		IID_PPV_ARGS(m_pDescriptorHeap.GetAddressOf()));
@@ -36,7 +36,7 @@ uint32_t DX12DescriptorHeap::GetNextAvailableIndex()
 {
 	if (m_CurrentdescriptorIndex >= m_NumDescriptors)
 	{
-		assert(false && "fBXNv^q[v̏ɒB܂D");
+		assert(false && "ディスクリプタヒープの上限に達しました．");
 		return 0;
 	}
 
@@ -3,10 +3,10 @@
 
 DX12Device::DX12Device()
 {
-	// fobOC[L
+	// デバッグレイヤーを有効化
 	DegugLayer();
 
-	// foCX̐
+	// デバイスの生成
 	auto hr = D3D12CreateDevice(
 		nullptr,
 		D3D_FEATURE_LEVEL_11_0,
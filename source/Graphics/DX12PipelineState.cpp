@@ -3,7 +3,7 @@
 
 DX12PipelineState::DX12PipelineState(ID3D12Device* pDevice, const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc)
 {
-	// pCvCXe[g̐
+	// パイプラインステートの生成
 	auto hr = pDevice->CreateGraphicsPipelineState(
 		pDesc,
 		IID_PPV_ARGS(m_pPipelineState.GetAddressOf()));
@@ -12,7 +12,7 @@ DX12PipelineState::DX12PipelineState(ID3D12Device* pDevice, const D3D12_GRAPHICS
 
 DX12PipelineState::DX12PipelineState(ID3D12Device* pDevice, const D3D12_COMPUTE_PIPELINE_STATE_DESC* pDesc)
 {
-	// pCvCXe[g̐
+	// パイプラインステートの生成
 	auto hr = pDevice->CreateComputePipelineState(
 		pDesc,
 		IID_PPV_ARGS(m_pPipelineState.GetAddressOf()));
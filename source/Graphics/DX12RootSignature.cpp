@@ -6,7 +6,7 @@ DX12RootSignature::DX12RootSignature(ID3D12Device* pDevice, const D3D12_ROOT_SIG
 	ComPtr<ID3DBlob> pBlob = nullptr;
 	ComPtr<ID3DBlob> pErrorBlob = nullptr;
 
-	// VACY
+	// シリアライズ
 	auto hr = D3D12SerializeRootSignature(
 		pDesc,
 		D3D_ROOT_SIGNATURE_VERSION_1_0,
@@ -15,7 +15,7 @@ DX12RootSignature::DX12RootSignature(ID3D12Device* pDevice, const D3D12_ROOT_SIG
 	);
 	ThrowFailed(hr);
 
-	// [gVOl`̐
+	// ルートシグネチャの生成
 	hr = pDevice->CreateRootSignature(
 		0,
 		pBlob->GetBufferPointer(),
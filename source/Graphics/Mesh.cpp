@@ -2,6 +2,7 @@
 #include "Graphics/DX12Utilities.h"
 #include "Graphics/DX12Device.h"
 #include "Framework/Renderer.h"
+#include "Simulation/TriangleBVH.h"
 
 Mesh::Mesh(Renderer* pRenderer, const aiMesh* pSrcMesh)
 {
@@ -38,13 +39,13 @@ Mesh::Mesh(Renderer* pRenderer, const aiMesh* pSrcMesh)
 		}
 	}
 
-	// CfbNXz̍쐬
+	// インデックス配列の作成
 	m_Indices.shrink_to_fit();;
 	m_Indices.resize(pSrcMesh->mNumFaces * 3);
 	for (auto i = 0u; i < pSrcMesh->mNumFaces; ++i)
 	{
 		auto pFace = &(pSrcMesh->mFaces[i]);
-		assert(pFace->mNumIndices == 3); // Op`Ă͂Ȃ̂3ł邱ƂmF
+		assert(pFace->mNumIndices == 3); // 三角形化しているはずなので3であることを確認
 		m_Indices[i * 3 + 0] = pFace->mIndices[0];
 		m_Indices[i * 3 + 1] = pFace->mIndices[1];
 		m_Indices[i * 3 + 2] = pFace->mIndices[2];
@@ -53,26 +54,52 @@ Mesh::Mesh(Renderer* pRenderer, const aiMesh* pSrcMesh)
 	UploadBuffers(pRenderer->GetDevice().Get());
 }
 
+Mesh::Mesh(Renderer* pRenderer, std::vector<Vertex> vertices, std::vector<uint32_t> indices, const std::string& name)
+{
+	m_Name = name;
+	m_pRenderer = pRenderer;
+	m_Vertices = std::move(vertices);
+	m_Indices = std::move(indices);
+	assert(m_Indices.size() % 3 == 0);
+
+	UploadBuffers(pRenderer->GetDevice().Get());
+}
+
 Mesh::~Mesh()
 {
 }
 
+const TriangleBVH& Mesh::BuildBVH(ThreadPool& threadPool)
+{
+	std::vector<Vector3D> positions(m_Vertices.size());
+	for (size_t i = 0; i < m_Vertices.size(); ++i)
+	{
+		positions[i] = m_Vertices[i].m_Position;
+	}
+	if (m_pBVH == nullptr)
+	{
+		m_pBVH = std::make_unique<TriangleBVH>();
+	}
+	m_pBVH->Build(positions, m_Indices, BVHBuildParam(), threadPool);
+	return *m_pBVH;
+}
+
 void Mesh::UploadBuffers(ID3D12Device* pDevice)
 {
 	auto vertSize = m_Vertices.size() * sizeof(Vertex);
-	// q[vvpeB
+	// ヒーププロパティ
 	D3D12_HEAP_PROPERTIES vertProp = {};
-	vertProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPU珑݉\ȃq[v
+	vertProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPUから書き込み可能なヒープ
 	vertProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
 	vertProp.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
 	vertProp.CreationNodeMask = 1;
 	vertProp.VisibleNodeMask = 1;
 
-	// \[X̐ݒ
+	// リソースの設定
 	D3D12_RESOURCE_DESC vertDesc = {};
 	vertDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
 	vertDesc.Alignment = 0;
-	vertDesc.Width = static_cast<uint64_t>(vertSize); // _f[^̃TCY
+	vertDesc.Width = static_cast<uint64_t>(vertSize); // 頂点データのサイズ
 	vertDesc.Height = 1;
 	vertDesc.DepthOrArraySize = 1;
 	vertDesc.MipLevels = 1;
@@ -82,7 +109,7 @@ void Mesh::UploadBuffers(ID3D12Device* pDevice)
 	vertDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 	vertDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-	// \[X𐶐
+	// リソースを生成
 	auto hr = pDevice->CreateCommittedResource(
 		&vertProp,
 		D3D12_HEAP_FLAG_NONE,
@@ -91,38 +118,38 @@ void Mesh::UploadBuffers(ID3D12Device* pDevice)
 		nullptr,
 		IID_PPV_ARGS(m_pVB.GetAddressOf())
 	);
-	ThrowFailed(hr, "_obt@̐Ɏs܂");
-	// }bsO
+	ThrowFailed(hr, "頂点バッファの生成に失敗しました");
+	// マッピング
 	void* ptr = nullptr;
 	hr = m_pVB->Map(0, nullptr, &ptr);
-	ThrowFailed(hr, "_obt@̃}bsOɎs܂");
-	// _f[^}bsOɐݒ
+	ThrowFailed(hr, "頂点バッファのマッピングに失敗しました");
+	// 頂点データをマッピング先に設定
 	if(m_Vertices.data())
 	memcpy(ptr, m_Vertices.data(), vertSize);
 
-	// }bsO
+	// マッピング解除
 	m_pVB->Unmap(0, nullptr);
 
-	// _obt@r[̐ݒ
+	// 頂点バッファビューの設定
 	m_VBV.BufferLocation = m_pVB->GetGPUVirtualAddress();
 	m_VBV.SizeInBytes = static_cast<UINT>(vertSize);
 	m_VBV.StrideInBytes = static_cast<UINT>(sizeof(Vertex));
 
 	auto indicesSize = sizeof(uint32_t) * m_Indices.size();
 
-	// q[vvpeB
+	// ヒーププロパティ
 	D3D12_HEAP_PROPERTIES indicesProp = {};
-	indicesProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPU珑݉\ȃq[v
+	indicesProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPUから書き込み可能なヒープ
 	indicesProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
 	indicesProp.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
 	indicesProp.CreationNodeMask = 1;
 	indicesProp.VisibleNodeMask = 1;
 
-	// \[X̐ݒ
+	// リソースの設定
 	D3D12_RESOURCE_DESC indicesDesc = {};
 	indicesDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
 	indicesDesc.Alignment = 0;
-	indicesDesc.Width = static_cast<uint64_t>(indicesSize); // CfbNXf[^̃TCY
+	indicesDesc.Width = static_cast<uint64_t>(indicesSize); // インデックスデータのサイズ
 	indicesDesc.Height = 1;
 	indicesDesc.DepthOrArraySize = 1;
 	indicesDesc.MipLevels = 1;
@@ -132,7 +159,7 @@ void Mesh::UploadBuffers(ID3D12Device* pDevice)
 	indicesDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 	indicesDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-	// \[X𐶐
+	// リソースを生成
 	hr = pDevice->CreateCommittedResource(
 		&indicesProp,
 		D3D12_HEAP_FLAG_NONE,
@@ -141,19 +168,19 @@ void Mesh::UploadBuffers(ID3D12Device* pDevice)
 		nullptr,
 		IID_PPV_ARGS(m_pIB.GetAddressOf())
 	);
-	ThrowFailed(hr, "CfbNXobt@̐Ɏs܂");
-	// }bsO
+	ThrowFailed(hr, "インデックスバッファの生成に失敗しました");
+	// マッピング
 	ptr = nullptr;
 	hr = m_pIB->Map(0, nullptr, &ptr);
-	ThrowFailed(hr, "CfbNXobt@̃}bsOɎs܂");
+	ThrowFailed(hr, "インデックスバッファのマッピングに失敗しました");
 
-	// CfbNXf[^}bsOɐݒ
+	// インデックスデータをマッピング先に設定
 	memcpy(ptr, m_Indices.data(), indicesSize);
 
-	// }bsO
+	// マッピング解除
 	m_pIB->Unmap(0, nullptr);
 
-	// CfbNXobt@r[̐ݒ
+	// インデックスバッファビューの設定
 	m_IBV.BufferLocation = m_pIB->GetGPUVirtualAddress();
 	m_IBV.Format = DXGI_FORMAT_R32_UINT;
 	m_IBV.SizeInBytes = static_cast<UINT>(indicesSize);
@@ -14,31 +14,31 @@ Model::Model(Renderer* pRenderer, const std::wstring& filePath)
 	m_Name = Utility::WStringToString(filePath);
 	if (filePath.c_str() == nullptr)
 	{
-		assert(false && "t@Cnullptrł");
+		assert(false && "ファイル名がnullptrです");
 		return;
 	}
 
-	// wchar_t  char ւ̕ϊ
+	// wchar_t から char への変換
 	auto path = Utility::WStringToString(filePath);
 
 	Assimp::Importer importer;
 	int flag = 0;
-	flag |= aiProcess_Triangulate;            // Op`
-	flag |= aiProcess_PreTransformVertices;  // ϊ̓Kp
-	flag |= aiProcess_CalcTangentSpace;    // ڐԂ̌vZ
-	flag |= aiProcess_GenSmoothNormals;   // X[YVF[fBO̖@
-	flag |= aiProcess_RemoveRedundantMaterials; // 璷ȃ}eA̍폜
-	flag |= aiProcess_OptimizeMeshes;       // bV̍œK
-	flag |= aiProcess_MakeLeftHanded;      // nɕϊ
-	flag |= aiProcess_FlipUVs;              // UV]
-
-	// f[^̓ǂݍ
+	flag |= aiProcess_Triangulate;            // 三角形化
+	flag |= aiProcess_PreTransformVertices;  // 変換の適用
+	flag |= aiProcess_CalcTangentSpace;    // 接線空間の計算
+	flag |= aiProcess_GenSmoothNormals;   // スムーズシェーディングの法線生成
+	flag |= aiProcess_RemoveRedundantMaterials; // 冗長なマテリアルの削除
+	flag |= aiProcess_OptimizeMeshes;       // メッシュの最適化
+	flag |= aiProcess_MakeLeftHanded;      // 左手系に変換
+	flag |= aiProcess_FlipUVs;              // UV反転
+
+	// データの読み込み
 	auto pScene = importer.ReadFile(path, flag);
 
-	// `FbN
+	// チェック
 	if (pScene == nullptr)
 	{
-		assert(false && "bVf[^̓ǂݍ݂Ɏs܂");
+		assert(false && "メッシュデータの読み込みに失敗しました");
 		return;
 	}
 
@@ -91,7 +91,7 @@ void Model::Draw(const Matrix4x4& viewMat, const Matrix4x4& projMat)
 {
 	if (m_pCommandList == nullptr)
 	{
-		assert(false && "R}hXgnullptrł");
+		assert(false && "コマンドリストがnullptrです");
 		return;
 	}
 	auto backBufferIndex = m_pWindow->GetCurrentBackBufferIndex();
@@ -157,7 +157,7 @@ void Model::PerseMaterial(const aiMaterial* pSrcMat, Material& dstMat)
 {
 	aiColor3D color(0.f, 0.f, 0.f);
 
-	// fBt[YF̎擾
+	// ディフューズ色の取得
 	if (pSrcMat->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS)
 	{
 		dstMat.m_Diffuse = Vector3D(color.r, color.g, color.b);
@@ -167,7 +167,7 @@ void Model::PerseMaterial(const aiMaterial* pSrcMat, Material& dstMat)
 		dstMat.m_Diffuse = Vector3D(0.5f, 0.5f, 0.5f);
 	}
 
-	// XyL[F̎擾
+	// スペキュラー色の取得
 	if (pSrcMat->Get(AI_MATKEY_COLOR_SPECULAR, color) == AI_SUCCESS)
 	{
 		dstMat.m_Specular = Vector3D(color.r, color.g, color.b);
@@ -177,7 +177,7 @@ void Model::PerseMaterial(const aiMaterial* pSrcMat, Material& dstMat)
 		dstMat.m_Specular = Vector3D(0.5f, 0.5f, 0.5f);
 	}
 
-	// ʔˋx̎擾
+	// 鏡面反射強度の取得
 	auto shininess = 0.0f;
 	if (pSrcMat->Get(AI_MATKEY_SHININESS, shininess) != AI_SUCCESS)
 	{
@@ -188,16 +188,16 @@ void Model::PerseMaterial(const aiMaterial* pSrcMat, Material& dstMat)
 		dstMat.m_Shininess = 0.0f;
 	}
 
-	// fBt[YeNX`̎擾
+	// ディフューズテクスチャの取得
 	aiString texturePath;
 	SetTextureId(pSrcMat, texturePath, aiTextureType_DIFFUSE, dstMat.m_DiffuseTexId);
-	// m[}eNX`̎擾
+	// ノーマルテクスチャの取得
 	SetTextureId(pSrcMat, texturePath, aiTextureType_NORMALS, dstMat.m_NormalTexId);
-	// XyLeNX`̎擾
+	// スペキュラテクスチャの取得
 	SetTextureId(pSrcMat, texturePath, aiTextureType_SPECULAR, dstMat.m_SpecularTexId);
-	// ^bNeNX`̎擾
+	// メタリックテクスチャの取得
 	SetTextureId(pSrcMat, texturePath, aiTextureType_GLTF_METALLIC_ROUGHNESS, dstMat.m_GLTFMetaricRoughnessTexId);
-	// VClXeNX`̎擾
+	// シャイネステクスチャの取得
 	SetTextureId(pSrcMat, texturePath, aiTextureType_SHININESS, dstMat.m_ShininessTexId);
 }
 
@@ -4,12 +4,16 @@
 #include "Graphics/DX12PipelineState.h"
 #include "Graphics/Window.h"
 #include "Graphics/Camera.h"
+#include "Graphics/Model.h"
+#include "Graphics/Mesh.h"
 #include "Framework/Renderer.h"
 #include "Framework/Scene.h"
 #include "Math/Vector2D.h"
+#include "Simulation/ThreadPool.h"
 #include "Utilities/Utility.h"
 
 #include <imgui.h>
+#include <functional>
 
 FluidStage::FluidStage(Renderer* pRenderer) : RenderStage(pRenderer)
 {
@@ -32,11 +36,11 @@ void FluidStage::SetScene(Scene* newScene)
 
 void FluidStage::RecordStage(ID3D12GraphicsCommandList* pCmdList)
 {
-	// oA
+	// バリア
 	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
 		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
 
-	// NAJ[̐ݒ
+	// クリアカラーの設定
 	float clearColor[] = { 0.6f, 0.6f, 0.6f, 1.0f };
 	auto rtv = m_pWindow->GetCurrentScreenRTV();
 	auto dsv = m_pWindow->GetDepthDSV();
@@ -47,10 +51,10 @@ void FluidStage::RecordStage(ID3D12GraphicsCommandList* pCmdList)
 	auto CBVSRVUAVHeap = m_pRenderer->GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	pCmdList->SetDescriptorHeaps(1, CBVSRVUAVHeap->GetHeap().GetAddressOf());
 
-	// SRVݒ
+	// SRV設定
 	pCmdList->SetGraphicsRootDescriptorTable(0, CBVSRVUAVHeap->GetGpuHandle(m_SRVIndex));
 
-	// JXV
+	// カメラ情報更新
 	auto pCamera = m_pScene->GetCamera();
 	m_ParticleTransform.View = pCamera->GetView();
 	m_ParticleTransform.Proj = pCamera->GetProj();
@@ -64,12 +68,12 @@ void FluidStage::RecordStage(ID3D12GraphicsCommandList* pCmdList)
 	auto cbGPUHandle = m_pRenderer->AllocateConstantBuffer(m_ParticleTransform, m_pRenderer->GetWindow()->GetCurrentBackBufferIndex());
 	pCmdList->SetGraphicsRootConstantBufferView(1, cbGPUHandle);
 
-	// r{[h`
+	// ビルボード描画
 	pCmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
 	pCmdList->IASetVertexBuffers(0, 1, &m_BillboardVBV);
-	pCmdList->DrawInstanced(4, MaxParticles, 0, 0);
+	pCmdList->DrawInstanced(4, m_ParticleCount, 0, 0);
 
-	// oA
+	// バリア
 	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
 		D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COMMON);
 
@@ -82,85 +86,91 @@ void FluidStage::UpdateSimulationGrid(float deltaTime)
 
 	m_GridCellSize = m_H;
 	Vector3D range = m_WallMax - m_WallMin;
-	// ẽObhvZ(؂グ) +2͔͈͊OANZXh~p̃}[W
+	// 各軸のグリッド数を計算(切り上げ) +2は範囲外アクセス防止用のマージン
 	m_GridDim.x = ceil(range.x / m_GridCellSize) + 2;
 	m_GridDim.y = ceil(range.y / m_GridCellSize) + 2;
 	m_GridDim.z = ceil(range.z / m_GridCellSize) + 2;
 
 	m_TotalGridCount = m_GridDim.x * m_GridDim.y * m_GridDim.z;
-	// 萔obt@̍XV
+	// 定数バッファの更新
 	m_SimParam.DeltaTime = m_MaxAllowableTimestep;
 	m_SimParam.Gravity = m_Gravity;
 	m_SimParam.Stiffness = m_Stiffness;
 	m_SimParam.RestDensity = m_RestDensity;
 	m_SimParam.nearStiffness = m_NearStiffness;
-	m_SimParam.ParticleCount = MaxParticles;
+	m_SimParam.ParticleCount = m_ParticleCount;
 	m_SimParam.Viscosity = m_Viscosity;
 	m_SimParam.H = m_H;
 	m_SimParam.Mass = m_Mass;
 	m_SimParam.GridDim = m_GridDim;
 	m_SimParam.WallMin = m_WallMin;
 	m_SimParam.WallMax = m_WallMax;
+	UpdateColliderTable();
 
 	for (int i = 0; i < m_Iterations; ++i)
 	{
 		RunFluidSolverGrid(pCmdlist, CBVSRVUAVHeap);
+		++m_StepCount;
+		m_SimulatedTime += m_SimParam.DeltaTime;
 	}
+	RecordExportCopy(pCmdlist);
 }
 
 void FluidStage::RunFluidSolverGrid(ID3D12GraphicsCommandList* pCmdlist, DX12DescriptorHeap* CBVSRVUAVHeap)
 {
-	// oAݒ: JnO Common -> UAV ֑J
+	// バリア設定: 処理開始前に Common -> UAV へ遷移
 	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 	m_pRenderer->TransitionResource(m_pGridHeadBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 	m_pRenderer->TransitionResource(m_pGridNextBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 
-	// ʐݒ
+	// 共通設定
 	auto cbGPUHandle = m_pRenderer->AllocateConstantBuffer(m_SimParam, m_pRenderer->GetWindow()->GetCurrentBackBufferIndex());
 	pCmdlist->SetComputeRootSignature(m_pComputeRootSignature->GetRootSignaturePtr());
 	pCmdlist->SetDescriptorHeaps(1, CBVSRVUAVHeap->GetHeap().GetAddressOf());
 	pCmdlist->SetComputeRootDescriptorTable(0, CBVSRVUAVHeap->GetGpuHandle(m_UAVIndex));
 	pCmdlist->SetComputeRootConstantBufferView(1, cbGPUHandle);
+	BindColliders(pCmdlist);
+	BindBoundaryParticles(pCmdlist);
 
-	// VF[_[ԓpUAVoA
+	// シェーダー間同期用のUAVバリア
 	D3D12_RESOURCE_BARRIER uavBarrier = {};
 	uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
 	uavBarrier.UAV.pResource = nullptr;
 
-	// Obh̏ head -1ɐݒ
+	// グリッドの初期化 headを -1に設定
 	pCmdlist->SetPipelineState(m_pClearGridPSO->GetPipelineStatePtr());
 	pCmdlist->Dispatch((m_TotalGridCount + 255) / 256, 1, 1);
 
-	// oA: ObhNÅ҂
+	// バリア: グリッドクリアの完了待ち
 	pCmdlist->ResourceBarrier(1, &uavBarrier);
 
-	// Obh̍\z
-	uint32_t particleGroups = (MaxParticles + 255) / 256;
+	// グリッドの構築
+	uint32_t particleGroups = (m_ParticleCount + 255) / 256;
 	pCmdlist->SetPipelineState(m_pGridBuildPSO->GetPipelineStatePtr());
 	pCmdlist->Dispatch(particleGroups, 1, 1);
 
-	// oA: Obh\z̊҂
+	// バリア: グリッド構築の完了待ち
 	pCmdlist->ResourceBarrier(1, &uavBarrier);
 
-	// Density Calculation (xvZ)
+	// Density Calculation (密度計算)
 	pCmdlist->SetPipelineState(m_pDensityPSO->GetPipelineStatePtr());
 	pCmdlist->Dispatch(particleGroups, 1, 1);
 
-	// oA: xvZ̊҂
+	// バリア: 密度計算の完了待ち
 	pCmdlist->ResourceBarrier(1, &uavBarrier);
 
-	// Force Calculation (́E͌vZ)
+	// Force Calculation (圧力・力計算)
 	pCmdlist->SetPipelineState(m_pForcePSO->GetPipelineStatePtr());
 	pCmdlist->Dispatch(particleGroups, 1, 1);
 
-	// oA: ͌vZ̊҂
+	// バリア: 力計算の完了待ち
 	pCmdlist->ResourceBarrier(1, &uavBarrier);
 
-	// Integration (ʒuExXVEՓ)
+	// Integration (位置・速度更新・衝突)
 	pCmdlist->SetPipelineState(m_pComputePSO->GetPipelineStatePtr());
 	pCmdlist->Dispatch(particleGroups, 1, 1);
 
-	// oAݒ:  UAV -> Common (Vertex Shaderp) ֖߂
+	// バリア設定: 処理完了後に UAV -> Common (Vertex Shader用) へ戻す
 	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
 	m_pRenderer->TransitionResource(m_pGridHeadBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
 	m_pRenderer->TransitionResource(m_pGridNextBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
@@ -171,19 +181,20 @@ void FluidStage::UpdateSimulation(float deltaTime)
 	auto pCmdlist = m_pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT)->GetGraphicsCommandList().Get();
 	auto CBVSRVUAVHeap = m_pRenderer->GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
-	// 萔obt@̍XV
+	// 定数バッファの更新
 	m_SimParam.DeltaTime = m_MaxAllowableTimestep;
 	m_SimParam.Gravity = m_Gravity;
 	m_SimParam.Stiffness = m_Stiffness;
 	m_SimParam.RestDensity = m_RestDensity;
 	m_SimParam.nearStiffness = m_NearStiffness;
-	m_SimParam.ParticleCount = MaxParticles;
+	m_SimParam.ParticleCount = m_ParticleCount;
 	m_SimParam.Viscosity = m_Viscosity;
 	m_SimParam.H = m_H;
 	m_SimParam.Mass = m_Mass;
 	m_SimParam.GridDim = m_GridDim;
 	m_SimParam.WallMin = m_WallMin;
 	m_SimParam.WallMax = m_WallMax;
+	UpdateColliderTable();
 
 	for (int i = 0; i < m_Iterations; ++i)
 	{
@@ -193,52 +204,58 @@ void FluidStage::UpdateSimulation(float deltaTime)
 
 void FluidStage::RunFluidSolver(ID3D12GraphicsCommandList* pCmdlist, DX12DescriptorHeap* CBVSRVUAVHeap)
 {
-	// oAݒ: JnO Common -> UAV ֑J
+	// バリア設定: 処理開始前に Common -> UAV へ遷移
 	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 
-	// ʐݒ
+	// 共通設定
 	auto cbGPUHandle = m_pRenderer->AllocateConstantBuffer(m_SimParam, m_pRenderer->GetWindow()->GetCurrentBackBufferIndex());
 	pCmdlist->SetComputeRootSignature(m_pComputeRootSignature->GetRootSignaturePtr());
 	pCmdlist->SetDescriptorHeaps(1, CBVSRVUAVHeap->GetHeap().GetAddressOf());
 	pCmdlist->SetComputeRootDescriptorTable(0, CBVSRVUAVHeap->GetGpuHandle(m_UAVIndex));
 	pCmdlist->SetComputeRootConstantBufferView(1, cbGPUHandle);
+	BindColliders(pCmdlist);
+	BindBoundaryParticles(pCmdlist);
 
-	// VF[_[ԓpUAVoA
+	// シェーダー間同期用のUAVバリア
 	D3D12_RESOURCE_BARRIER uavBarrier = {};
 	uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
 	uavBarrier.UAV.pResource = m_pParticleBuffer.Get();
 
-	// Density Calculation (xvZ)
-	uint32_t particleGroups = (MaxParticles + 255) / 256;
+	// Density Calculation (密度計算)
+	uint32_t particleGroups = (m_ParticleCount + 255) / 256;
 	pCmdlist->SetPipelineState(m_pDensityPSO->GetPipelineStatePtr());
 	pCmdlist->Dispatch(particleGroups, 1, 1);
 
-	// oA: xvZ̊҂
+	// バリア: 密度計算の完了待ち
 	pCmdlist->ResourceBarrier(1, &uavBarrier);
 
-	// Force Calculation (́E͌vZ)
+	// Force Calculation (圧力・力計算)
 	pCmdlist->SetPipelineState(m_pForcePSO->GetPipelineStatePtr());
 	pCmdlist->Dispatch(particleGroups, 1, 1);
 
-	// oA: ͌vZ̊҂
+	// バリア: 力計算の完了待ち
 	pCmdlist->ResourceBarrier(1, &uavBarrier);
 
-	// Integration (ʒuExXVEՓ)
+	// Integration (位置・速度更新・衝突)
 	pCmdlist->SetPipelineState(m_pComputePSO->GetPipelineStatePtr());
 	pCmdlist->Dispatch(particleGroups, 1, 1);
 
-	// oAݒ:  UAV -> Common (Vertex Shaderp) ֖߂
+	// バリア設定: 処理完了後に UAV -> Common (Vertex Shader用) へ戻す
 	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
 }
 
 void FluidStage::Update(float deltaTime)
 {
+	SubmitExportFrame();
+
 	ImGui::Begin("Fluid Simulation Settings");
 
 	if (ImGui::Button("Reset Particles"))
 	{
 		InitializeParticles();
 	}
+	ImGui::SameLine();
+	ImGui::InputInt("Random Seed", &m_RandomSeed);
 	ImGui::SliderFloat("Gravity", &m_Gravity, -20.0f, 0.0f);
 	ImGui::SliderFloat("Mass", &m_Mass, 0.0f, 10.0f);
 	ImGui::SliderFloat("smoothRadius", &m_H, 0.01f, 0.5f);
@@ -251,8 +268,129 @@ void FluidStage::Update(float deltaTime)
 		m_WallMin.x = -m_BoxWidth / 2;
 		m_WallMax.x = m_BoxWidth / 2;
 	}
-	ImGui::Text("Particle Count: %d", MaxParticles);
+	ImGui::Text("Particle Count: %d (Capacity: %d)", m_ParticleCount, m_ParticleCapacity);
+	ImGui::InputInt("New Particle Count", &m_RequestedParticleCount, 1000, 10000);
+	if (ImGui::Button("Apply Particle Count") && m_RequestedParticleCount > 0)
+	{
+		SetParticleCount(static_cast<uint32_t>(m_RequestedParticleCount));
+	}
+	if (ImGui::Button("Emit Particles"))
+	{
+		// 箱の上部中央から落とす
+		std::vector<Particle> particles(EmitParticleCount);
+		Vector3D center((m_WallMin.x + m_WallMax.x) * 0.5f, m_WallMax.y - 0.5f, (m_WallMin.z + m_WallMax.z) * 0.5f);
+		std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+		for (auto& particle : particles)
+		{
+			float rX = dist(m_EmitRandom);
+			float rY = dist(m_EmitRandom);
+			float rZ = dist(m_EmitRandom);
+			particle = {};
+			particle.Position = center + Vector3D(rX, rY, rZ) * 0.5f;
+		}
+		AddParticles(particles);
+	}
+	// 落ち着くまで進めた状態を保存しておき、Reset Particles の代わりに読み込む
+	ImGui::InputText("Checkpoint", m_CheckpointPath, sizeof(m_CheckpointPath));
+	if (ImGui::Button("Save Checkpoint"))
+	{
+		m_CheckpointStatus = SaveCheckpoint(m_CheckpointPath) ? "saving..." : "previous save is still running";
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Load Checkpoint"))
+	{
+		m_CheckpointStatus = LoadCheckpoint(m_CheckpointPath) ? "loaded" : "failed to load";
+	}
+	if (!m_CheckpointStatus.empty())
+	{
+		if (m_CheckpointStatus == "saving..." && !m_CheckpointWriter.IsBusy())
+		{
+			m_CheckpointStatus = m_CheckpointWriter.Wait() ? "saved" : "failed to save";
+		}
+		ImGui::Text("%s (%.2f s simulated)", m_CheckpointStatus.c_str(), m_SimulatedTime);
+	}
+	// シーンのモデルを障害物にする (モデル毎の SDF はキャッシュがあれば読み込むだけ)
+	ImGui::InputFloat("Collider Cell Size", &m_ColliderCellSize, 0.01f, 0.05f);
+	m_ColliderCellSize = std::max(0.005f, m_ColliderCellSize);
+	if (ImGui::Button("Bake Colliders From Scene") && m_pScene != nullptr)
+	{
+		ClearColliders();
+		uint32_t failedCount = 0;
+		for (const auto& pModel : m_pScene->GetModels())
+		{
+			failedCount += AddCollider(pModel.get()) ? 0 : 1;
+		}
+		m_ColliderStatus = std::to_string(m_Colliders.size()) + " colliders, " + std::to_string(failedCount) + " failed";
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Clear Colliders"))
+	{
+		ClearColliders();
+		m_ColliderStatus.clear();
+	}
+	if (!m_ColliderStatus.empty())
+	{
+		ImGui::Text("%s", m_ColliderStatus.c_str());
+		for (const Collider& collider : m_Colliders)
+		{
+			const SDFBakeStats& stats = collider.pField->GetStats();
+			ImGui::Text("  %s: %u triangles, %s %.1f ms", collider.pModel->GetName().c_str(), stats.TriangleCount,
+				stats.FromCache ? "cache" : "baked", stats.TotalMilliseconds);
+		}
+	}
+	// 壁と障害物を表面に並べた境界粒子で押し返す (ペナルティより壁にめり込まず、床に粒子が積み重ならない)
+	ImGui::Checkbox("Boundary Particles", &m_UseBoundaryParticles);
+	if (m_UseBoundaryParticles)
+	{
+		const BoundaryParticleStats& stats = m_BoundaryParticles.GetStats();
+		if (m_BoundaryParticles.IsEmpty())
+		{
+			ImGui::Text("  spacing must be smaller than smoothRadius (using penalty)");
+		}
+		else
+		{
+			ImGui::Text("  %u wall + %u collider, spacing %.3f, psi %.3f..%.3f, %.1f ms", stats.WallParticleCount, stats.ColliderParticleCount,
+				stats.Spacing, stats.MinPsi, stats.MaxPsi, stats.BuildMilliseconds);
+		}
+	}
+	// フレーム毎の粒子を VTK / PLY / CSV に書き出す (ディスクが遅い場合はフレームを捨て、シミュレーションは止めない)
+	if (!m_Exporter.IsOpen())
+	{
+		ImGui::InputText("Export Prefix", m_ExportPath, sizeof(m_ExportPath));
+		int format = static_cast<int>(m_ExportParam.Format);
+		ImGui::Combo("Export Format", &format, "VTK\0PLY\0CSV\0");
+		m_ExportParam.Format = static_cast<ExportFormat>(format);
+		ImGui::Checkbox("Density", &m_ExportParam.Density);
+		ImGui::SameLine();
+		ImGui::Checkbox("Pressure", &m_ExportParam.Pressure);
+		ImGui::SameLine();
+		ImGui::Checkbox("Velocity", &m_ExportParam.Velocity);
+		bool replaceOldest = m_ExportParam.DropPolicy == ExportDropPolicy::ReplaceOldest;
+		ImGui::Checkbox("Drop Oldest When Busy", &replaceOldest);
+		m_ExportParam.DropPolicy = replaceOldest ? ExportDropPolicy::ReplaceOldest : ExportDropPolicy::SkipNewest;
+		ImGui::InputInt("Export Interval", &m_ExportInterval);
+		m_ExportInterval = std::max(1, m_ExportInterval);
+		if (ImGui::Button("Start Export"))
+		{
+			m_ExportFrameCount = 0;
+			m_Exporter.Open(m_ExportPath, m_ExportParam);
+		}
+	}
+	else if (ImGui::Button("Stop Export"))
+	{
+		m_ExportCopyPending = false;
+		m_Exporter.Close();
+	}
+	if (m_Exporter.GetStats().SubmittedFrames > 0)
+	{
+		const ExportStats stats = m_Exporter.GetStats();
+		ImGui::Text("Export: %u written, %u dropped, %u failed (%.1f MB)", stats.WrittenFrames, stats.DroppedFrames, stats.FailedFrames,
+			stats.WrittenBytes / (1024.0 * 1024.0));
+	}
 	ImGui::End();
+
+	// スライダーで変えた壁の範囲や H、動かした障害物に合わせる (シミュレーションのコマンドを積む前に送り終える)
+	UpdateBoundaryParticles();
 }
 
 void FluidStage::CreateBuffers()
@@ -265,8 +403,86 @@ void FluidStage::CreateBuffers()
 	uint32_t maxDimZ = ceil(MaxWallRange.z / MinCellSize) + 2;
 
 	m_MaxGridCount = maxDimX * maxDimY * maxDimZ;
+
+	// ---------------------------------------------------------
+	// ディスクリプタの確保 (u0 ～ u2 は連続している必要がある)
+	// ---------------------------------------------------------
+	m_UAVIndex = CBVSRVUAVHeap->GetNextAvailableIndex();         // u0
+	m_GridHeadUAVIndex = CBVSRVUAVHeap->GetNextAvailableIndex(); // u1
+	m_GridNextUAVIndex = CBVSRVUAVHeap->GetNextAvailableIndex(); // u2
+	m_SRVIndex = CBVSRVUAVHeap->GetNextAvailableIndex();         // t0
+
 	// ---------------------------------------------------------
-	// \[Xiobt@{́j̍쐬
+	// GridHead Buffer (グリッド数で決まるので粒子数が変わっても作り直さない)
+	// ---------------------------------------------------------
+	D3D12_HEAP_PROPERTIES heapProps = {};
+	heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+	D3D12_RESOURCE_DESC bufferDesc = {};
+	bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	bufferDesc.Height = 1;
+	bufferDesc.DepthOrArraySize = 1;
+	bufferDesc.MipLevels = 1;
+	bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+	bufferDesc.SampleDesc.Count = 1;
+	bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+	bufferDesc.Width = m_MaxGridCount * sizeof(int32_t);
+
+	ThrowFailed(pDevice->CreateCommittedResource(
+		&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+		D3D12_RESOURCE_STATE_COMMON, nullptr,
+		IID_PPV_ARGS(m_pGridHeadBuffer.GetAddressOf())
+	));
+	m_pGridHeadBuffer->SetName(L"GridHeadBuffer");
+
+	// --- GridHead Buffer UAV (u1) ---
+	D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+	uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+	uavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+	uavDesc.Buffer.FirstElement = 0;
+	uavDesc.Buffer.NumElements = m_MaxGridCount;
+	uavDesc.Buffer.StructureByteStride = sizeof(int32_t);
+	uavDesc.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_NONE;
+
+	pDevice->CreateUnorderedAccessView(
+		m_pGridHeadBuffer.Get(),
+		nullptr,
+		&uavDesc,
+		CBVSRVUAVHeap->GetCpuHandle(m_GridHeadUAVIndex)
+	);
+
+	// ---------------------------------------------------------
+	// SDFの障害物のテーブル (CPUから毎フレーム書き込むので Map したままにする)
+	// ---------------------------------------------------------
+	D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+	uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+	bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+	bufferDesc.Width = Window::FrameCount * MaxColliders * sizeof(SDFColliderGPU);
+	ThrowFailed(pDevice->CreateCommittedResource(
+		&uploadHeapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+		IID_PPV_ARGS(m_pColliderTableBuffer.GetAddressOf())
+	));
+	m_pColliderTableBuffer->SetName(L"ColliderTableBuffer");
+	ThrowFailed(m_pColliderTableBuffer->Map(0, nullptr, reinterpret_cast<void**>(&m_pColliderTable)));
+	// 障害物がない間もルート引数に設定できるよう、値のバッファも作っておく
+	UploadColliderValues();
+	// 境界粒子も使わない間からルート引数に設定するので、空のバッファを作っておく
+	UploadBoundaryParticles();
+
+	// 粒子数に比例するバッファ
+	CreateParticleBuffers(m_ParticleCount);
+}
+
+void FluidStage::CreateParticleBuffers(uint32_t capacity)
+{
+	auto pDevice = m_pRenderer->GetDevice().Get();
+	auto CBVSRVUAVHeap = m_pRenderer->GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	m_ParticleCapacity = std::max(capacity, 1u);
+
+	// ---------------------------------------------------------
+	// リソース（バッファ本体）の作成
 	// ---------------------------------------------------------
 	D3D12_HEAP_PROPERTIES heapProps = {};
 	heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
@@ -284,58 +500,40 @@ void FluidStage::CreateBuffers()
 	// 1. Particle Buffer
 	{
 		uint32_t stride = sizeof(Particle);
-		uint32_t bufferSize = MaxParticles * stride;
+		uint32_t bufferSize = m_ParticleCapacity * stride;
 		bufferDesc.Width = bufferSize;
 
 		ThrowFailed(pDevice->CreateCommittedResource(
 			&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
 			D3D12_RESOURCE_STATE_COMMON, nullptr,
-			IID_PPV_ARGS(m_pParticleBuffer.GetAddressOf())
+			IID_PPV_ARGS(m_pParticleBuffer.ReleaseAndGetAddressOf())
 		));
 		m_pParticleBuffer->SetName(L"ParticleBuffer");
 	}
 
-	// 2. GridHead Buffer
-	{
-		uint32_t stride = sizeof(int32_t);
-		uint32_t bufferSize = m_MaxGridCount * stride;
-		bufferDesc.Width = bufferSize;
-
-		ThrowFailed(pDevice->CreateCommittedResource(
-			&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
-			D3D12_RESOURCE_STATE_COMMON, nullptr,
-			IID_PPV_ARGS(m_pGridHeadBuffer.GetAddressOf())
-		));
-		m_pGridHeadBuffer->SetName(L"GridHeadBuffer");
-	}
-
-	// 3. GridNext Buffer
+	// 2. GridNext Buffer
 	{
 		uint32_t stride = sizeof(int32_t);
-		uint32_t bufferSize = MaxParticles * stride;
+		uint32_t bufferSize = m_ParticleCapacity * stride;
 		bufferDesc.Width = bufferSize;
 
 		ThrowFailed(pDevice->CreateCommittedResource(
 			&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
 			D3D12_RESOURCE_STATE_COMMON, nullptr,
-			IID_PPV_ARGS(m_pGridNextBuffer.GetAddressOf())
+			IID_PPV_ARGS(m_pGridNextBuffer.ReleaseAndGetAddressOf())
 		));
 		m_pGridNextBuffer->SetName(L"GridNextBuffer");
 	}
 
 	// ---------------------------------------------------------
-	// r[ifBXNv^j̍쐬
+	// ビュー（ディスクリプタ）の作成 (確保し直した場合も同じインデックスに上書きする)
 	// ---------------------------------------------------------
-	m_UAVIndex = CBVSRVUAVHeap->GetNextAvailableIndex();         // u0
-	m_GridHeadUAVIndex = CBVSRVUAVHeap->GetNextAvailableIndex(); // u1
-	m_GridNextUAVIndex = CBVSRVUAVHeap->GetNextAvailableIndex(); // u2
-
 	// --- 1. Particle Buffer UAV (u0) ---
 	D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
 	uavDesc.Format = DXGI_FORMAT_UNKNOWN;
 	uavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
 	uavDesc.Buffer.FirstElement = 0;
-	uavDesc.Buffer.NumElements = MaxParticles;
+	uavDesc.Buffer.NumElements = m_ParticleCapacity;
 	uavDesc.Buffer.StructureByteStride = sizeof(Particle);
 
 	uavDesc.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_NONE;
@@ -347,13 +545,12 @@ void FluidStage::CreateBuffers()
 	);
 
 	// --- Particle Buffer SRV (t0) ---
-	m_SRVIndex = CBVSRVUAVHeap->GetNextAvailableIndex();
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 	srvDesc.Format = DXGI_FORMAT_UNKNOWN;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.Buffer.FirstElement = 0;
-	srvDesc.Buffer.NumElements = MaxParticles;
+	srvDesc.Buffer.NumElements = m_ParticleCapacity;
 	srvDesc.Buffer.StructureByteStride = sizeof(Particle);
 
 	srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
@@ -363,19 +560,8 @@ void FluidStage::CreateBuffers()
 		CBVSRVUAVHeap->GetCpuHandle(m_SRVIndex)
 	);
 
-	// --- 2. GridHead Buffer UAV (u1) ---
-	uavDesc.Buffer.NumElements = m_MaxGridCount;
-	uavDesc.Buffer.StructureByteStride = sizeof(int32_t);
-
-	pDevice->CreateUnorderedAccessView(
-		m_pGridHeadBuffer.Get(),
-		nullptr,
-		&uavDesc,
-		CBVSRVUAVHeap->GetCpuHandle(m_GridHeadUAVIndex)
-	);
-
-	// --- 3. GridNext Buffer UAV (u2) ---
-	uavDesc.Buffer.NumElements = MaxParticles;
+	// --- 2. GridNext Buffer UAV (u2) ---
+	uavDesc.Buffer.NumElements = m_ParticleCapacity;
 	uavDesc.Buffer.StructureByteStride = sizeof(int32_t);
 
 	pDevice->CreateUnorderedAccessView(
@@ -386,22 +572,612 @@ void FluidStage::CreateBuffers()
 	);
 }
 
+void FluidStage::EnsureParticleCapacity(uint32_t particleCount, bool keepParticles)
+{
+	if (particleCount <= m_ParticleCapacity)
+	{
+		return;
+	}
+	// エミッターで少しずつ増える場合も確保し直しが O(log n) 回で済むよう、1.5倍ずつ拡張する
+	uint32_t capacity = std::max(particleCount, m_ParticleCapacity + m_ParticleCapacity / 2);
+
+	// 古いバッファはコピーが終わるまで保持
+	ComPtr<ID3D12Resource> pOldParticleBuffer = m_pParticleBuffer;
+	CreateParticleBuffers(capacity);
+	if (!keepParticles || m_ParticleCount == 0)
+	{
+		return;
+	}
+
+	auto pCmd = m_pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT);
+	auto pCmdList = pCmd->GetGraphicsCommandList().Get();
+	pCmd->ResetCommand();
+
+	m_pRenderer->TransitionResource(pOldParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+	pCmdList->CopyBufferRegion(m_pParticleBuffer.Get(), 0, pOldParticleBuffer.Get(), 0, m_ParticleCount * sizeof(Particle));
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
+
+	pCmd->ExecuteCommandList();
+	pCmd->WaitGpu(INFINITE);
+}
+
+void FluidStage::UploadParticles(const std::vector<Particle>& particles, uint32_t firstIndex)
+{
+	if (particles.empty())
+	{
+		return;
+	}
+	auto pDevice = m_pRenderer->GetDevice().Get();
+	uint32_t bufferSize = static_cast<uint32_t>(particles.size() * sizeof(Particle));
+
+	// アップロードバッファは足りない場合のみ作り直す
+	if (bufferSize > m_UploadBufferSize)
+	{
+		D3D12_HEAP_PROPERTIES heapProps = {};
+		heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+		D3D12_RESOURCE_DESC bufferDesc = {};
+		bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		bufferDesc.Width = bufferSize;
+		bufferDesc.Height = 1;
+		bufferDesc.DepthOrArraySize = 1;
+		bufferDesc.MipLevels = 1;
+		bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+		bufferDesc.SampleDesc.Count = 1;
+		bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+		ThrowFailed(pDevice->CreateCommittedResource(
+			&heapProps,
+			D3D12_HEAP_FLAG_NONE,
+			&bufferDesc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(m_pParticleUploadBuffer.ReleaseAndGetAddressOf())
+		));
+		m_UploadBufferSize = bufferSize;
+	}
+
+	void* ptr = nullptr;
+	m_pParticleUploadBuffer->Map(0, nullptr, &ptr);
+	memcpy(ptr, particles.data(), bufferSize);
+	m_pParticleUploadBuffer->Unmap(0, nullptr);
+
+	// コピーコマンド
+	auto pCmd = m_pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT);
+	auto pCmdList = pCmd->GetGraphicsCommandList().Get();
+
+	pCmd->ResetCommand();
+
+	// UploadからDefaultの firstIndex 以降へコピー
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+	pCmdList->CopyBufferRegion(m_pParticleBuffer.Get(), firstIndex * sizeof(Particle), m_pParticleUploadBuffer.Get(), 0, bufferSize);
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
+
+	pCmd->ExecuteCommandList();
+	pCmd->WaitGpu(INFINITE);
+}
+
+void FluidStage::ReadbackParticles(Particle* pDst, uint32_t particleCount)
+{
+	if (particleCount == 0)
+	{
+		return;
+	}
+	uint32_t bufferSize = particleCount * sizeof(Particle);
+	EnsureReadbackBuffer(m_pParticleReadbackBuffer, m_ReadbackBufferSize, bufferSize);
+
+	// DefaultからReadbackへコピー
+	auto pCmd = m_pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT);
+	auto pCmdList = pCmd->GetGraphicsCommandList().Get();
+
+	pCmd->ResetCommand();
+
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	pCmdList->CopyBufferRegion(m_pParticleReadbackBuffer.Get(), 0, m_pParticleBuffer.Get(), 0, bufferSize);
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COMMON);
+
+	pCmd->ExecuteCommandList();
+	pCmd->WaitGpu(INFINITE);
+
+	void* ptr = nullptr;
+	D3D12_RANGE readRange = { 0, bufferSize };
+	m_pParticleReadbackBuffer->Map(0, &readRange, &ptr);
+	memcpy(pDst, ptr, bufferSize);
+	D3D12_RANGE writtenRange = { 0, 0 };
+	m_pParticleReadbackBuffer->Unmap(0, &writtenRange);
+}
+
+void FluidStage::EnsureReadbackBuffer(ComPtr<ID3D12Resource>& pBuffer, uint32_t& currentSize, uint32_t bufferSize)
+{
+	if (bufferSize > currentSize)
+	{
+		auto pDevice = m_pRenderer->GetDevice().Get();
+		D3D12_HEAP_PROPERTIES heapProps = {};
+		heapProps.Type = D3D12_HEAP_TYPE_READBACK;
+
+		D3D12_RESOURCE_DESC bufferDesc = {};
+		bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		bufferDesc.Width = bufferSize;
+		bufferDesc.Height = 1;
+		bufferDesc.DepthOrArraySize = 1;
+		bufferDesc.MipLevels = 1;
+		bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+		bufferDesc.SampleDesc.Count = 1;
+		bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+		ThrowFailed(pDevice->CreateCommittedResource(
+			&heapProps,
+			D3D12_HEAP_FLAG_NONE,
+			&bufferDesc,
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			nullptr,
+			IID_PPV_ARGS(pBuffer.ReleaseAndGetAddressOf())
+		));
+		currentSize = bufferSize;
+	}
+}
+
+void FluidStage::RecordExportCopy(ID3D12GraphicsCommandList* pCmdList)
+{
+	if (!m_Exporter.IsOpen() || m_ParticleCount == 0 || (m_ExportFrameCount++ % m_ExportInterval) != 0)
+	{
+		return;
+	}
+	uint32_t bufferSize = m_ParticleCount * sizeof(Particle);
+	EnsureReadbackBuffer(m_pExportReadbackBuffer, m_ExportReadbackBufferSize, bufferSize);
+
+	// Render の最後に GPU を待つので、次のフレームの Update ではコピーが終わっている
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	pCmdList->CopyBufferRegion(m_pExportReadbackBuffer.Get(), 0, m_pParticleBuffer.Get(), 0, bufferSize);
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COMMON);
+	m_ExportCopyPending = true;
+	m_ExportCopyCount = m_ParticleCount;
+	m_ExportCopyTime = m_SimulatedTime;
+}
+
+void FluidStage::SubmitExportFrame()
+{
+	if (!m_ExportCopyPending)
+	{
+		return;
+	}
+	m_ExportCopyPending = false;
+	// 空きバッファがなければ、マップせずにこのフレームは捨てられる
+	m_Exporter.Submit([&](std::vector<Particle>& particles)
+	{
+		uint32_t bufferSize = m_ExportCopyCount * sizeof(Particle);
+		particles.resize(m_ExportCopyCount);
+		void* ptr = nullptr;
+		D3D12_RANGE readRange = { 0, bufferSize };
+		m_pExportReadbackBuffer->Map(0, &readRange, &ptr);
+		memcpy(particles.data(), ptr, bufferSize);
+		D3D12_RANGE writtenRange = { 0, 0 };
+		m_pExportReadbackBuffer->Unmap(0, &writtenRange);
+	}, m_StepCount, m_ExportCopyTime);
+}
+
+bool FluidStage::SaveCheckpoint(const std::string& path)
+{
+	return m_CheckpointWriter.WriteAsync([&](CheckpointSnapshot& snapshot)
+	{
+		// GPU版は並べ替えないので、バッファのインデックスがそのまま粒子IDになる
+		CheckpointHeader& header = snapshot.Header;
+		header.Param = m_SimParam;
+		header.IdCount = m_ParticleCount;
+		header.StepCount = m_StepCount;
+		header.SimulatedTime = m_SimulatedTime;
+		header.PrevDeltaTime = m_SimParam.DeltaTime;
+		snapshot.Particles.resize(m_ParticleCount);
+		snapshot.ParticleIds.resize(m_ParticleCount);
+		for (uint32_t i = 0; i < m_ParticleCount; ++i)
+		{
+			snapshot.ParticleIds[i] = i;
+		}
+		snapshot.Kappa.clear();
+		snapshot.KappaV.clear();
+		ReadbackParticles(snapshot.Particles.data(), m_ParticleCount);
+	}, path);
+}
+
+bool FluidStage::LoadCheckpoint(const std::string& path)
+{
+	CheckpointFile checkpoint;
+	if (!checkpoint.Open(path))
+	{
+		return false;
+	}
+	const CheckpointHeader& header = checkpoint.GetHeader();
+	const SimulationParam& param = header.Param;
+	// グリッドのバッファは MaxWallRange と MinCellSize から確保しているので、それを超える設定は読み込めない
+	Vector3D range = param.WallMax - param.WallMin;
+	if (range.x > MaxWallRange.x || range.y > MaxWallRange.y || range.z > MaxWallRange.z || param.H < MinCellSize || header.ParticleCount == 0)
+	{
+		return false;
+	}
+
+	// 削除済みのIDを飛ばして、ID順に詰める
+	const Particle* pParticles = checkpoint.GetParticles();
+	const uint32_t* pParticleIds = checkpoint.GetParticleIds();
+	const uint32_t invalidSlot = 0xffffffff;
+	std::vector<uint32_t> idToSlot(header.IdCount, invalidSlot);
+	for (uint32_t slot = 0; slot < header.ParticleCount; ++slot)
+	{
+		idToSlot[pParticleIds[slot]] = slot;
+	}
+	std::vector<Particle> particles;
+	particles.reserve(header.ParticleCount);
+	for (uint32_t slot : idToSlot)
+	{
+		if (slot != invalidSlot)
+		{
+			particles.push_back(pParticles[slot]);
+		}
+	}
+
+	m_Gravity = param.Gravity;
+	m_Mass = param.Mass;
+	m_H = param.H;
+	m_Viscosity = param.Viscosity;
+	m_RestDensity = param.RestDensity;
+	m_Stiffness = param.Stiffness;
+	m_NearStiffness = param.nearStiffness;
+	m_MaxAllowableTimestep = param.DeltaTime;
+	m_WallMin = param.WallMin;
+	m_WallMax = param.WallMax;
+	m_BoxWidth = m_WallMax.x - m_WallMin.x;
+	m_StepCount = header.StepCount;
+	m_SimulatedTime = header.SimulatedTime;
+
+	EnsureParticleCapacity(static_cast<uint32_t>(particles.size()), false);
+	m_ParticleCount = static_cast<uint32_t>(particles.size());
+	m_RequestedParticleCount = static_cast<int>(m_ParticleCount);
+	UploadParticles(particles, 0);
+	return true;
+}
+
+void FluidStage::SetParticleCount(uint32_t particleCount)
+{
+	// 初期配置し直すので既存の粒子はコピーしない
+	EnsureParticleCapacity(particleCount, false);
+	m_ParticleCount = particleCount;
+	InitializeParticles();
+}
+
+void FluidStage::AddParticles(const std::vector<Particle>& particles)
+{
+	uint32_t firstIndex = m_ParticleCount;
+	EnsureParticleCapacity(m_ParticleCount + static_cast<uint32_t>(particles.size()), true);
+	UploadParticles(particles, firstIndex);
+	m_ParticleCount += static_cast<uint32_t>(particles.size());
+}
+
+void FluidStage::RemoveParticles(std::vector<uint32_t> indices)
+{
+	// 大きいインデックスから順に、末尾の (まだ削除されていない) 粒子を移して詰める
+	std::sort(indices.begin(), indices.end(), std::greater<uint32_t>());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+	std::vector<std::pair<uint32_t, uint32_t>> moves; // (移動先, 移動元)
+	uint32_t particleCount = m_ParticleCount;
+	for (uint32_t index : indices)
+	{
+		if (index >= particleCount)
+		{
+			continue;
+		}
+		uint32_t last = particleCount - 1;
+		if (index != last)
+		{
+			moves.push_back({ index, last });
+		}
+		--particleCount;
+	}
+	m_ParticleCount = particleCount;
+	if (moves.empty())
+	{
+		return;
+	}
+
+	// 同じバッファ内のコピーはできないので、一度スクラッチバッファへ退避してから書き戻す
+	uint32_t scratchSize = static_cast<uint32_t>(moves.size() * sizeof(Particle));
+	if (scratchSize > m_ScratchBufferSize)
+	{
+		auto pDevice = m_pRenderer->GetDevice().Get();
+		D3D12_HEAP_PROPERTIES heapProps = {};
+		heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+		D3D12_RESOURCE_DESC bufferDesc = {};
+		bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		bufferDesc.Width = scratchSize;
+		bufferDesc.Height = 1;
+		bufferDesc.DepthOrArraySize = 1;
+		bufferDesc.MipLevels = 1;
+		bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+		bufferDesc.SampleDesc.Count = 1;
+		bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+		ThrowFailed(pDevice->CreateCommittedResource(
+			&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+			D3D12_RESOURCE_STATE_COMMON, nullptr,
+			IID_PPV_ARGS(m_pParticleScratchBuffer.ReleaseAndGetAddressOf())
+		));
+		m_pParticleScratchBuffer->SetName(L"ParticleScratchBuffer");
+		m_ScratchBufferSize = scratchSize;
+	}
+
+	auto pCmd = m_pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT);
+	auto pCmdList = pCmd->GetGraphicsCommandList().Get();
+	pCmd->ResetCommand();
+
+	// 移動元 -> スクラッチ
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	m_pRenderer->TransitionResource(m_pParticleScratchBuffer.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+	for (size_t i = 0; i < moves.size(); ++i)
+	{
+		pCmdList->CopyBufferRegion(m_pParticleScratchBuffer.Get(), i * sizeof(Particle),
+			m_pParticleBuffer.Get(), moves[i].second * sizeof(Particle), sizeof(Particle));
+	}
+
+	// スクラッチ -> 移動先
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+	m_pRenderer->TransitionResource(m_pParticleScratchBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	for (size_t i = 0; i < moves.size(); ++i)
+	{
+		pCmdList->CopyBufferRegion(m_pParticleBuffer.Get(), moves[i].first * sizeof(Particle),
+			m_pParticleScratchBuffer.Get(), i * sizeof(Particle), sizeof(Particle));
+	}
+
+	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
+	m_pRenderer->TransitionResource(m_pParticleScratchBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COMMON);
+
+	pCmd->ExecuteCommandList();
+	pCmd->WaitGpu(INFINITE);
+}
+
+bool FluidStage::AddCollider(const Model* pModel)
+{
+	if (pModel == nullptr || m_Colliders.size() >= MaxColliders)
+	{
+		return false;
+	}
+	// モデルのすべてのメッシュを1つのメッシュとして焼き込む
+	std::vector<Vector3D> positions;
+	std::vector<uint32_t> indices;
+	for (const auto& pMesh : pModel->GetMeshes())
+	{
+		const uint32_t firstVertex = static_cast<uint32_t>(positions.size());
+		for (const Vertex& vertex : pMesh->GetVertices())
+		{
+			positions.push_back(vertex.m_Position);
+		}
+		for (uint32_t index : pMesh->GetIndices())
+		{
+			indices.push_back(firstVertex + index);
+		}
+	}
+	Collider collider;
+	collider.pModel = pModel;
+	collider.pField = std::make_unique<SignedDistanceField>();
+	SDFBakeParam param;
+	param.CellSize = m_ColliderCellSize;
+	if (!collider.pField->BakeCached(pModel->GetName(), "cache/sdf", positions, indices, param, GetThreadPool()))
+	{
+		return false;
+	}
+	m_Colliders.push_back(std::move(collider));
+	UploadColliderValues();
+	return true;
+}
+
+void FluidStage::ClearColliders()
+{
+	m_Colliders.clear();
+	// 境界粒子は SDF をアドレスで覚えているので、次に焼いた SDF と取り違えないよう捨てる
+	m_BoundaryParticles.Clear();
+	UploadColliderValues();
+}
+
+void FluidStage::UploadColliderValues()
+{
+	// 障害物毎の値を続けて詰める (空の場合もバッファを作れるよう1要素は入れる)
+	std::vector<float> values;
+	for (Collider& collider : m_Colliders)
+	{
+		const std::vector<float>& fieldValues = collider.pField->GetValues();
+		collider.ValueOffset = static_cast<uint32_t>(values.size());
+		values.insert(values.end(), fieldValues.begin(), fieldValues.end());
+	}
+	if (values.empty())
+	{
+		values.push_back(0.0f);
+	}
+	UploadStaticBuffer(m_pColliderValueBuffer, values.data(), values.size() * sizeof(float), L"ColliderValueBuffer");
+}
+
+void FluidStage::UploadStaticBuffer(ComPtr<ID3D12Resource>& pBuffer, const void* pData, uint64_t bufferSize, const wchar_t* name)
+{
+	auto pDevice = m_pRenderer->GetDevice().Get();
+
+	D3D12_HEAP_PROPERTIES heapProps = {};
+	heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+	D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+	uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+	D3D12_RESOURCE_DESC bufferDesc = {};
+	bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	bufferDesc.Width = bufferSize;
+	bufferDesc.Height = 1;
+	bufferDesc.DepthOrArraySize = 1;
+	bufferDesc.MipLevels = 1;
+	bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+	bufferDesc.SampleDesc.Count = 1;
+	bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+	ThrowFailed(pDevice->CreateCommittedResource(
+		&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+		D3D12_RESOURCE_STATE_COMMON, nullptr,
+		IID_PPV_ARGS(pBuffer.ReleaseAndGetAddressOf())
+	));
+	pBuffer->SetName(name);
+
+	// 作り直すのは障害物や境界粒子が変わった時だけなので、アップロードバッファはコピーの間だけ持つ
+	ComPtr<ID3D12Resource> pUploadBuffer;
+	ThrowFailed(pDevice->CreateCommittedResource(
+		&uploadHeapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+		IID_PPV_ARGS(pUploadBuffer.GetAddressOf())
+	));
+	void* ptr = nullptr;
+	pUploadBuffer->Map(0, nullptr, &ptr);
+	memcpy(ptr, pData, bufferSize);
+	pUploadBuffer->Unmap(0, nullptr);
+
+	auto pCmd = m_pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT);
+	auto pCmdList = pCmd->GetGraphicsCommandList().Get();
+	pCmd->ResetCommand();
+
+	m_pRenderer->TransitionResource(pBuffer.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+	pCmdList->CopyBufferRegion(pBuffer.Get(), 0, pUploadBuffer.Get(), 0, bufferSize);
+	m_pRenderer->TransitionResource(pBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
+
+	pCmd->ExecuteCommandList();
+	pCmd->WaitGpu(INFINITE);
+}
+
+void FluidStage::UpdateColliderTable()
+{
+	SDFColliderGPU* pTable = m_pColliderTable + m_pRenderer->GetWindow()->GetCurrentBackBufferIndex() * MaxColliders;
+	for (size_t i = 0; i < m_Colliders.size(); ++i)
+	{
+		const Collider& collider = m_Colliders[i];
+		const SignedDistanceField& field = *collider.pField;
+		SDFColliderGPU& entry = pTable[i];
+		const Matrix4x4 invWorld = Matrix4x4::inverse(collider.pModel->GetTransform().World);
+		memcpy(entry.InvWorld, invWorld.m_mat, sizeof(entry.InvWorld));
+		entry.Origin = field.GetOrigin();
+		entry.InvCellSize = 1.0f / field.GetCellSize();
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			entry.Dim[axis] = field.GetDim()[axis];
+		}
+		entry.ValueOffset = collider.ValueOffset;
+		entry.BandDistance = field.GetBandDistance();
+	}
+}
+
+void FluidStage::BindColliders(ID3D12GraphicsCommandList* pCmdlist)
+{
+	const uint32_t frameIndex = m_pRenderer->GetWindow()->GetCurrentBackBufferIndex();
+	pCmdlist->SetComputeRoot32BitConstant(2, static_cast<uint32_t>(m_Colliders.size()), 0);
+	pCmdlist->SetComputeRootShaderResourceView(3, m_pColliderValueBuffer->GetGPUVirtualAddress());
+	pCmdlist->SetComputeRootShaderResourceView(4,
+		m_pColliderTableBuffer->GetGPUVirtualAddress() + frameIndex * MaxColliders * sizeof(SDFColliderGPU));
+}
+
+void FluidStage::UpdateBoundaryParticles()
+{
+	if (!m_UseBoundaryParticles)
+	{
+		return;
+	}
+	SimulationParam param = {};
+	param.WallMin = m_WallMin;
+	param.WallMax = m_WallMax;
+	param.H = m_H;
+	param.Mass = m_Mass;
+	param.RestDensity = m_RestDensity;
+	std::vector<SDFCollider> colliders;
+	for (const Collider& collider : m_Colliders)
+	{
+		colliders.emplace_back(collider.pField.get(), collider.pModel->GetTransform().World);
+	}
+	if (m_BoundaryParticles.IsUpToDate(param, colliders, m_BoundaryParticleParam))
+	{
+		return;
+	}
+	// 間隔が H 以上 (質量が大きい・H が小さい) の場合は並べず、ペナルティに戻す
+	if (BoundaryParticles::GetSpacing(param, m_BoundaryParticleParam) >= m_H)
+	{
+		if (!m_BoundaryParticles.IsEmpty())
+		{
+			m_BoundaryParticles.Clear();
+		}
+		return;
+	}
+	m_BoundaryParticles.Build(param, colliders, m_BoundaryParticleParam, GetThreadPool());
+	UploadBoundaryParticles();
+}
+
+ThreadPool& FluidStage::GetThreadPool()
+{
+	if (m_pThreadPool == nullptr)
+	{
+		m_pThreadPool = std::make_unique<ThreadPool>();
+	}
+	return *m_pThreadPool;
+}
+
+void FluidStage::UploadBoundaryParticles()
+{
+	// 空の場合もバッファを作れるよう1要素は入れる (シェーダーは粒子数が0なら読まない)
+	const std::vector<Vector3D>& positions = m_BoundaryParticles.GetPositions();
+	const std::vector<float>& psi = m_BoundaryParticles.GetPsi();
+	std::vector<BoundaryParticleGPU> particles(std::max<size_t>(positions.size(), 1));
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		particles[i] = { positions[i], psi[i] };
+	}
+	std::vector<uint32_t> cellStart = m_BoundaryParticles.GetCellStart();
+	if (cellStart.empty())
+	{
+		cellStart.push_back(0);
+	}
+	UploadStaticBuffer(m_pBoundaryParticleBuffer, particles.data(), particles.size() * sizeof(BoundaryParticleGPU), L"BoundaryParticleBuffer");
+	UploadStaticBuffer(m_pBoundaryCellStartBuffer, cellStart.data(), cellStart.size() * sizeof(uint32_t), L"BoundaryCellStartBuffer");
+}
+
+void FluidStage::BindBoundaryParticles(ID3D12GraphicsCommandList* pCmdlist)
+{
+	const uint32_t count = m_UseBoundaryParticles ? m_BoundaryParticles.GetCount() : 0;
+	pCmdlist->SetComputeRoot32BitConstant(5, count, 0);
+	pCmdlist->SetComputeRootShaderResourceView(6, m_pBoundaryParticleBuffer->GetGPUVirtualAddress());
+	pCmdlist->SetComputeRootShaderResourceView(7, m_pBoundaryCellStartBuffer->GetGPUVirtualAddress());
+}
+
 void FluidStage::CreateBillboardMesh()
 {
-	// PȎlp`
+	// 単純な四角形
 	struct Vertex {
 		Vector3D Position;
 		Vector2D TexCoord;
 	};
 
 	Vertex vertices[] = {
-		{ Vector3D(-0.5f,  0.5f, 0.0f), Vector2D(0.0f, 0.0f) }, // 
-		{ Vector3D(0.5f,  0.5f, 0.0f), Vector2D(1.0f, 0.0f) }, // E
-		{ Vector3D(-0.5f, -0.5f, 0.0f), Vector2D(0.0f, 1.0f) }, // 
-		{ Vector3D(0.5f, -0.5f, 0.0f), Vector2D(1.0f, 1.0f) }, // E
+		{ Vector3D(-0.5f,  0.5f, 0.0f), Vector2D(0.0f, 0.0f) }, // 左上
+		{ Vector3D(0.5f,  0.5f, 0.0f), Vector2D(1.0f, 0.0f) }, // 右上
+		{ Vector3D(-0.5f, -0.5f, 0.0f), Vector2D(0.0f, 1.0f) }, // 左下
+		{ Vector3D(0.5f, -0.5f, 0.0f), Vector2D(1.0f, 1.0f) }, // 右下
 	};
 
-	// Pstrip4_𑗂
+	// 単純なstripで4頂点を送る
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	uint32_t size = sizeof(vertices);
 
@@ -430,7 +1206,7 @@ void FluidStage::CreateBillboardMesh()
 	));
 	m_pBillboardVB->SetName(L"BillboardVB");
 
-	// f[^]
+	// データ転送
 	void* ptr = nullptr;
 	m_pBillboardVB->Map(0, nullptr, &ptr);
 	memcpy(ptr, vertices, size);
@@ -443,48 +1219,25 @@ void FluidStage::CreateBillboardMesh()
 
 void FluidStage::InitializeParticles()
 {
-	auto pDevice = m_pRenderer->GetDevice().Get();
-	uint32_t bufferSize = MaxParticles * sizeof(Particle);
-
-	D3D12_HEAP_PROPERTIES heapProps = {};
-	heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-
-	D3D12_RESOURCE_DESC bufferDesc = {};
-	bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	bufferDesc.Width = bufferSize;
-	bufferDesc.Height = 1;
-	bufferDesc.DepthOrArraySize = 1;
-	bufferDesc.MipLevels = 1;
-	bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
-	bufferDesc.SampleDesc.Count = 1;
-	bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-	ThrowFailed(pDevice->CreateCommittedResource(
-		&heapProps,
-		D3D12_HEAP_FLAG_NONE,
-		&bufferDesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(m_pParticleUploadBuffer.GetAddressOf())
-	));
-
-	std::vector<Particle> particles(MaxParticles);
+	std::vector<Particle> particles(m_ParticleCount);
 	float margin = 0.1f;
 	Vector3D spawnMin = m_WallMin + Vector3D(margin, margin, margin);
 	Vector3D spawnMax = m_WallMax - Vector3D(margin, margin, margin);
 	Vector3D spawnRange = spawnMax - spawnMin;
 
-	// V[h
-	srand((unsigned int)time(nullptr));
+	// 乱数シード初期化 (実行毎に同じ配置になるよう、時刻ではなく m_RandomSeed を使う)
+	std::mt19937 engine(static_cast<uint32_t>(m_RandomSeed));
+	std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+	m_EmitRandom.seed(static_cast<uint32_t>(m_RandomSeed) + 1);
 
-	for (uint32_t i = 0; i < MaxParticles; ++i)
+	for (uint32_t i = 0; i < m_ParticleCount; ++i)
 	{
-		// 0.0 ` 1.0 ̗
-		float rX = (float)rand() / RAND_MAX;
-		float rY = (float)rand() / RAND_MAX;
-		float rZ = (float)rand() / RAND_MAX;
+		// 0.0 ～ 1.0 の乱数生成
+		float rX = dist(engine);
+		float rY = dist(engine);
+		float rZ = dist(engine);
 
-		// ͈͓ɔzu
+		// 範囲内に配置
 		float posX = spawnMin.x + rX * spawnRange.x;
 		float posY = spawnMin.y + rY * spawnRange.y;
 		float posZ = spawnMin.z + rZ * spawnRange.z;
@@ -497,40 +1250,23 @@ void FluidStage::InitializeParticles()
 		particles[i].NearDensity = 0.0f;
 	}
 	m_BoxWidth = m_WallMax.x - m_WallMin.x;
+	m_StepCount = 0;
+	m_SimulatedTime = 0.0;
 
-	void* ptr = nullptr;
-	m_pParticleUploadBuffer->Map(0, nullptr, &ptr);
-	memcpy(ptr, particles.data(), bufferSize);
-	m_pParticleUploadBuffer->Unmap(0, nullptr);
-
-	// Rs[R}h
-	auto pCmd = m_pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT);
-	auto pCmdList = pCmd->GetGraphicsCommandList().Get();
-
-	pCmd->ResetCommand();
-
-	// UploadDefaultփRs[
-	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
-		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
-	pCmdList->CopyResource(m_pParticleBuffer.Get(), m_pParticleUploadBuffer.Get());
-	m_pRenderer->TransitionResource(m_pParticleBuffer.Get(),
-		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
-
-	pCmd->ExecuteCommandList();
-	pCmd->WaitGpu(INFINITE);
+	UploadParticles(particles, 0);
 }
 
 void FluidStage::CreateRootSignature(Renderer* pRenderer)
 {
 	auto pDevice = pRenderer->GetDevice().Get();
 
-	// Rs[g[gVOl`
+	// コンピュートルートシグネチャ
 	D3D12_DESCRIPTOR_RANGE uavRange = {};
 	uavRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
 	uavRange.NumDescriptors = 3;
 	uavRange.BaseShaderRegister = 0; // u0
 
-	D3D12_ROOT_PARAMETER params[2] = {};
+	D3D12_ROOT_PARAMETER params[8] = {};
 	// u0 RWStructuredBuffer
 	params[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
 	params[0].DescriptorTable.NumDescriptorRanges = 1;
@@ -540,6 +1276,28 @@ void FluidStage::CreateRootSignature(Renderer* pRenderer)
 	params[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
 	params[1].Descriptor.ShaderRegister = 0;
 
+	// b1 ColliderCount
+	params[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	params[2].Constants.ShaderRegister = 1;
+	params[2].Constants.Num32BitValues = 1;
+
+	// t0 SDFの値、t1 障害物のテーブル
+	params[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	params[3].Descriptor.ShaderRegister = 0;
+	params[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	params[4].Descriptor.ShaderRegister = 1;
+
+	// b2 BoundaryParticleCount
+	params[5].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	params[5].Constants.ShaderRegister = 2;
+	params[5].Constants.Num32BitValues = 1;
+
+	// t2 境界粒子、t3 セル毎の境界粒子の先頭
+	params[6].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	params[6].Descriptor.ShaderRegister = 2;
+	params[7].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	params[7].Descriptor.ShaderRegister = 3;
+
 	D3D12_ROOT_SIGNATURE_DESC rootSigDesc = {};
 	rootSigDesc.NumParameters = _countof(params);
 	rootSigDesc.pParameters = params;
@@ -547,7 +1305,7 @@ void FluidStage::CreateRootSignature(Renderer* pRenderer)
 
 	m_pComputeRootSignature = std::make_unique<DX12RootSignature>(pDevice, &rootSigDesc);
 
-	// _[[gVOl`
+	// レンダールートシグネチャ
 	D3D12_DESCRIPTOR_RANGE srvRange = {};
 	srvRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
 	srvRange.NumDescriptors = 1;
@@ -577,7 +1335,7 @@ void FluidStage::CreatePipeline(Renderer* pRenderer)
 	auto pDevice = pRenderer->GetDevice().Get();
 	std::wstring shaderPath = Utility::GetCurrentDir() + L"/assets/shaders/";
 	
-	// Obh\zppCvC
+	// グリッド構築用パイプライン
 	ComPtr<ID3DBlob> gridBuildCSBlob;
 	ThrowFailed(D3DReadFileToBlob((shaderPath + L"FluidGridBuildCS.cso").c_str(), gridBuildCSBlob.GetAddressOf()));
 	D3D12_COMPUTE_PIPELINE_STATE_DESC gridBuildComputePsoDesc = {};
@@ -586,7 +1344,7 @@ void FluidStage::CreatePipeline(Renderer* pRenderer)
 	{ gridBuildCSBlob->GetBufferPointer(), gridBuildCSBlob->GetBufferSize() };
 	m_pGridBuildPSO = std::make_unique<DX12PipelineState>(pDevice, &gridBuildComputePsoDesc);
 
-	//ObhNAppCvC
+	//グリッドクリア用パイプライン
 	ComPtr<ID3DBlob> gridClearCsBlob;
 	ThrowFailed(D3DReadFileToBlob((shaderPath + L"FluidGridClearCS.cso").c_str(), gridClearCsBlob.GetAddressOf()));
 	D3D12_COMPUTE_PIPELINE_STATE_DESC gridClearComputePsoDesc = {};
@@ -595,7 +1353,7 @@ void FluidStage::CreatePipeline(Renderer* pRenderer)
 	{ gridClearCsBlob->GetBufferPointer(), gridClearCsBlob->GetBufferSize() };
 	m_pClearGridPSO = std::make_unique<DX12PipelineState>(pDevice, &gridClearComputePsoDesc);
 
-	// xvZpCvC
+	// 密度計算パイプライン
 	ComPtr<ID3DBlob> densityCsBlob;
 	ThrowFailed(D3DReadFileToBlob((shaderPath + L"FluidDensityCS.cso").c_str(), densityCsBlob.GetAddressOf()));
 	D3D12_COMPUTE_PIPELINE_STATE_DESC densityComputePsoDesc = {};
@@ -604,7 +1362,7 @@ void FluidStage::CreatePipeline(Renderer* pRenderer)
 	{ densityCsBlob->GetBufferPointer(), densityCsBlob->GetBufferSize() };
 	m_pDensityPSO = std::make_unique<DX12PipelineState>(pDevice, &densityComputePsoDesc);
 
-	// ͌vZpCvC
+	// 力計算パイプライン
 	ComPtr<ID3DBlob> forceCsBlob;
 	ThrowFailed(D3DReadFileToBlob((shaderPath + L"FluidForceCS.cso").c_str(), forceCsBlob.GetAddressOf()));
 	D3D12_COMPUTE_PIPELINE_STATE_DESC forceComputePsoDesc = {};
@@ -613,7 +1371,7 @@ void FluidStage::CreatePipeline(Renderer* pRenderer)
 	{ forceCsBlob->GetBufferPointer(), forceCsBlob->GetBufferSize() };
 	m_pForcePSO = std::make_unique<DX12PipelineState>(pDevice, &forceComputePsoDesc);
 
-	// Rs[gpCvC
+	// コンピュートパイプライン
 	ComPtr<ID3DBlob> csBlob;
 	ThrowFailed(D3DReadFileToBlob((shaderPath + L"FluidSimCS.cso").c_str(), csBlob.GetAddressOf()));
 	D3D12_COMPUTE_PIPELINE_STATE_DESC computePsoDesc = {};
@@ -623,7 +1381,7 @@ void FluidStage::CreatePipeline(Renderer* pRenderer)
 
 	m_pComputePSO = std::make_unique<DX12PipelineState>(pDevice, &computePsoDesc);
 
-	// _[pCvC
+	// レンダーパイプライン
 	ComPtr<ID3DBlob> vsBlob;
 	ComPtr<ID3DBlob> psBlob;
 	ThrowFailed(D3DReadFileToBlob((shaderPath + L"ParticleVS.cso").c_str(), vsBlob.GetAddressOf()));
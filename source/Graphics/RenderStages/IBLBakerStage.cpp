@@ -49,19 +49,19 @@ void IBLBakerStage::CreateVBV()
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	auto vertCount = static_cast<uint32_t>(sizeof(vertices) / sizeof(vertices[0]));
 	auto vertSize = vertCount * sizeof(Vertex);
-	// q[vvpeB
+	// ヒーププロパティ
 	D3D12_HEAP_PROPERTIES vertProp = {};
-	vertProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPU珑݉\ȃq[v
+	vertProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPUから書き込み可能なヒープ
 	vertProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
 	vertProp.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
 	vertProp.CreationNodeMask = 1;
 	vertProp.VisibleNodeMask = 1;
 
-	// \[X̐ݒ
+	// リソースの設定
 	D3D12_RESOURCE_DESC vertDesc = {};
 	vertDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
 	vertDesc.Alignment = 0;
-	vertDesc.Width = static_cast<uint64_t>(vertSize); // _f[^̃TCY
+	vertDesc.Width = static_cast<uint64_t>(vertSize); // 頂点データのサイズ
 	vertDesc.Height = 1;
 	vertDesc.DepthOrArraySize = 1;
 	vertDesc.MipLevels = 1;
@@ -71,7 +71,7 @@ void IBLBakerStage::CreateVBV()
 	vertDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 	vertDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-	// \[X𐶐
+	// リソースを生成
 	auto hr = pDevice->CreateCommittedResource(
 		&vertProp,
 		D3D12_HEAP_FLAG_NONE,
@@ -80,18 +80,18 @@ void IBLBakerStage::CreateVBV()
 		nullptr,
 		IID_PPV_ARGS(m_pVB.GetAddressOf())
 	);
-	ThrowFailed(hr, "_obt@̐Ɏs܂");
-	// }bsO
+	ThrowFailed(hr, "頂点バッファの生成に失敗しました");
+	// マッピング
 	void* ptr = nullptr;
 	hr = m_pVB->Map(0, nullptr, &ptr);
-	ThrowFailed(hr, "_obt@̃}bsOɎs܂");
-	// _f[^}bsOɐݒ
+	ThrowFailed(hr, "頂点バッファのマッピングに失敗しました");
+	// 頂点データをマッピング先に設定
 	memcpy(ptr, vertices, vertSize);
 
-	// }bsO
+	// マッピング解除
 	m_pVB->Unmap(0, nullptr);
 
-	// _obt@r[̐ݒ
+	// 頂点バッファビューの設定
 	m_VBV.BufferLocation = m_pVB->GetGPUVirtualAddress();
 	m_VBV.SizeInBytes = static_cast<UINT>(vertSize);
 	m_VBV.StrideInBytes = static_cast<UINT>(sizeof(Vertex));
@@ -317,7 +317,7 @@ void IBLBakerStage::RecordStage(ID3D12GraphicsCommandList* pCmdList)
 }
 
 /// <summary>
-/// DFGϕ܂
+/// DFG項を積分します
 /// </summary>
 void IBLBakerStage::IntegrateDFG(ID3D12GraphicsCommandList* pCmdList)
 {
@@ -356,7 +356,7 @@ void IBLBakerStage::IntegrateDFG(ID3D12GraphicsCommandList* pCmdList)
 }
 
 /// <summary>
-/// LDϕ܂
+/// LD項を積分します
 /// </summary>
 void IBLBakerStage::IntegrateLD(ID3D12GraphicsCommandList* pCmdList,
 	uint32_t mapSize,
@@ -365,20 +365,20 @@ void IBLBakerStage::IntegrateLD(ID3D12GraphicsCommandList* pCmdList,
 {
 	auto idx = 0;
 
-	// o̓eNX`̃~bv}bvŊăXebv߂.
-	//  ̓eNX`TCYɂ mipCount != MipCount ƂȂ邱Ƃɒ.
+	// 出力テクスチャのミップマップ数で割ってステップ数を求める.
+	// ※ 入力テクスチャサイズによって mipCount != MipCount となることに注意.
 	const auto RoughnessStep = 1.0f / (MipCount - 1);
 
 	for (auto i = 0; i < 6; ++i)
 	{
 		auto roughness = 0.0f;
 
-		// o̓eNX`̃~bv}bv[v.
+		// 出力テクスチャのミップマップ数分ループする.
 		for (auto m = 0; m < MipCount; ++m)
 		{
 			m_BakeCBDatas[idx].FaceIndex = i;
-			m_BakeCBDatas[idx].MipCount = float(mipCount - 1);  // ̓eNX`̃~bv}bv.
-			m_BakeCBDatas[idx].Width = float(mapSize);       // ̓eNX`̃TCY.
+			m_BakeCBDatas[idx].MipCount = float(mipCount - 1);  // 入力テクスチャのミップマップ数.
+			m_BakeCBDatas[idx].Width = float(mapSize);       // 入力テクスチャのサイズ.
 			m_BakeCBDatas[idx].Roughness = roughness * roughness;
 
 			idx++;
@@ -386,13 +386,13 @@ void IBLBakerStage::IntegrateLD(ID3D12GraphicsCommandList* pCmdList,
 		}
 	}
 
-	// [gVOj`ݒ.
+	// ルートシグニチャを設定.
 	pCmdList->SetGraphicsRootSignature(m_pLDRootSignature->GetRootSignaturePtr());
 
-	// Diffuse LDϕ܂.
+	// Diffuse LD項を積分します.
 	IntegrateDiffuseLD(pCmdList, handleCubeMap);
 
-	// Speclar LDϕ܂.
+	// Speclar LD項を積分します.
 	IntegrateSpecularLD(pCmdList, handleCubeMap);
 }
 
@@ -572,20 +572,20 @@ void IBLBakerStage::CreateDFGRootSignature(Renderer* pRenderer)
 		pErrorBlob.GetAddressOf());
 	ThrowFailed(hr);
 
-	// [gVOl`̐
+	// ルートシグネチャの生成
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	m_pRootSignature = std::make_unique<DX12RootSignature>(pDevice, &sigDesc);
 }
 
 void IBLBakerStage::CreateDFGPipeline(Renderer* pRenderer)
 {
-	// ̓CAEg̐ݒ (POSITION + TEXCOORD)
+	// 入力レイアウトの設定 (POSITION + TEXCOORD)
 	D3D12_INPUT_ELEMENT_DESC elements[] = {
 		{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
 
-	// X^CU[Xe[g (CullNone)
+	// ラスタライザーステート (CullNone)
 	D3D12_RASTERIZER_DESC descRS = {};
 	descRS.FillMode = D3D12_FILL_MODE_SOLID;
 	descRS.CullMode = D3D12_CULL_MODE_NONE;
@@ -599,7 +599,7 @@ void IBLBakerStage::CreateDFGPipeline(Renderer* pRenderer)
 	descRS.ForcedSampleCount = 0;
 	descRS.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
 
-	// _[^[Qbg̃uhݒ (Opaque)
+	// レンダーターゲットのブレンド設定 (Opaque)
 	D3D12_RENDER_TARGET_BLEND_DESC descRTBS = {
 		FALSE, FALSE,
 		D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
@@ -619,7 +619,7 @@ void IBLBakerStage::CreateDFGPipeline(Renderer* pRenderer)
 	ComPtr<ID3DBlob> vsBlob;
 	ComPtr<ID3DBlob> psBlob;
 
-	// VF[_[ǂݍ
+	// シェーダー読み込み
 	static const std::wstring ShaderFilePathName = Utility::GetCurrentDir() + L"/assets/shaders/";
 
 	auto hr = D3DReadFileToBlob((ShaderFilePathName + L"QuadVS.cso").c_str(), vsBlob.GetAddressOf());
@@ -628,7 +628,7 @@ void IBLBakerStage::CreateDFGPipeline(Renderer* pRenderer)
 	hr = D3DReadFileToBlob((ShaderFilePathName + L"IntegrateDFG_PS.cso").c_str(), psBlob.GetAddressOf());
 	ThrowFailed(hr, "IntegrateDFG_PS.cso read failed");
 
-	// [xXeVXe[g (DepthNone)
+	// 深度ステンシルステート (DepthNone相当)
 	D3D12_DEPTH_STENCIL_DESC descDSS = {};
 	descDSS.DepthEnable = FALSE;
 	descDSS.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
@@ -645,7 +645,7 @@ void IBLBakerStage::CreateDFGPipeline(Renderer* pRenderer)
 	descDSS.FrontFace = defaultStencilOp;
 	descDSS.BackFace = defaultStencilOp;
 
-	// pCvCXe[g̐ݒ
+	// パイプラインステートの設定
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout = { elements, _countof(elements) };
 	desc.pRootSignature = m_pRootSignature->GetRootSignaturePtr();
@@ -724,20 +724,20 @@ void IBLBakerStage::CreateLDRootSignature(Renderer* pRenderer)
 		pErrorBlob.GetAddressOf());
 	ThrowFailed(hr);
 
-	// [gVOl`̐
+	// ルートシグネチャの生成
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	m_pLDRootSignature = std::make_unique<DX12RootSignature>(pDevice, &sigDesc);
 }
 
 void IBLBakerStage::CreateDiffuseLDPipeline(Renderer* pRenderer)
 {
-	// ̓CAEg̐ݒ (POSITION + TEXCOORD)
+	// 入力レイアウトの設定 (POSITION + TEXCOORD)
 	D3D12_INPUT_ELEMENT_DESC elements[] = {
 		{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
 
-	// X^CU[Xe[g (CullNone)
+	// ラスタライザーステート (CullNone)
 	D3D12_RASTERIZER_DESC descRS = {};
 	descRS.FillMode = D3D12_FILL_MODE_SOLID;
 	descRS.CullMode = D3D12_CULL_MODE_NONE;
@@ -751,7 +751,7 @@ void IBLBakerStage::CreateDiffuseLDPipeline(Renderer* pRenderer)
 	descRS.ForcedSampleCount = 0;
 	descRS.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
 
-	// _[^[Qbg̃uhݒ (Opaque)
+	// レンダーターゲットのブレンド設定 (Opaque)
 	D3D12_RENDER_TARGET_BLEND_DESC descRTBS = {
 		FALSE, FALSE,
 		D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
@@ -771,7 +771,7 @@ void IBLBakerStage::CreateDiffuseLDPipeline(Renderer* pRenderer)
 	ComPtr<ID3DBlob> vsBlob;
 	ComPtr<ID3DBlob> psBlob;
 
-	// VF[_[ǂݍ
+	// シェーダー読み込み
 	static const std::wstring ShaderFilePathName = Utility::GetCurrentDir() + L"/assets/shaders/";
 
 	auto hr = D3DReadFileToBlob((ShaderFilePathName + L"QuadVS.cso").c_str(), vsBlob.GetAddressOf());
@@ -780,7 +780,7 @@ void IBLBakerStage::CreateDiffuseLDPipeline(Renderer* pRenderer)
 	hr = D3DReadFileToBlob((ShaderFilePathName + L"IntegrateDiffuseLD_PS.cso").c_str(), psBlob.GetAddressOf());
 	ThrowFailed(hr, "IntegrateDiffuseLD_PS.cso read failed");
 
-	// [xXeVXe[g (DepthNone)
+	// 深度ステンシルステート (DepthNone相当)
 	D3D12_DEPTH_STENCIL_DESC descDSS = {};
 	descDSS.DepthEnable = FALSE;
 	descDSS.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
@@ -797,7 +797,7 @@ void IBLBakerStage::CreateDiffuseLDPipeline(Renderer* pRenderer)
 	descDSS.FrontFace = defaultStencilOp;
 	descDSS.BackFace = defaultStencilOp;
 
-	// pCvCXe[g̐ݒ
+	// パイプラインステートの設定
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout = { elements, _countof(elements) };
 	desc.pRootSignature = m_pLDRootSignature->GetRootSignaturePtr();
@@ -821,13 +821,13 @@ void IBLBakerStage::CreateDiffuseLDPipeline(Renderer* pRenderer)
 
 void IBLBakerStage::CreateSpecularLDPipeline(Renderer* pRenderer)
 {
-	// ̓CAEg̐ݒ (POSITION + TEXCOORD)
+	// 入力レイアウトの設定 (POSITION + TEXCOORD)
 	D3D12_INPUT_ELEMENT_DESC elements[] = {
 		{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
 
-	// X^CU[Xe[g (CullNone)
+	// ラスタライザーステート (CullNone)
 	D3D12_RASTERIZER_DESC descRS = {};
 	descRS.FillMode = D3D12_FILL_MODE_SOLID;
 	descRS.CullMode = D3D12_CULL_MODE_NONE;
@@ -841,7 +841,7 @@ void IBLBakerStage::CreateSpecularLDPipeline(Renderer* pRenderer)
 	descRS.ForcedSampleCount = 0;
 	descRS.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
 
-	// _[^[Qbg̃uhݒ (Opaque)
+	// レンダーターゲットのブレンド設定 (Opaque)
 	D3D12_RENDER_TARGET_BLEND_DESC descRTBS = {
 		FALSE, FALSE,
 		D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
@@ -861,7 +861,7 @@ void IBLBakerStage::CreateSpecularLDPipeline(Renderer* pRenderer)
 	ComPtr<ID3DBlob> vsBlob;
 	ComPtr<ID3DBlob> psBlob;
 
-	// VF[_[ǂݍ
+	// シェーダー読み込み
 	static const std::wstring ShaderFilePathName = Utility::GetCurrentDir() + L"/assets/shaders/";
 
 	auto hr = D3DReadFileToBlob((ShaderFilePathName + L"QuadVS.cso").c_str(), vsBlob.GetAddressOf());
@@ -870,7 +870,7 @@ void IBLBakerStage::CreateSpecularLDPipeline(Renderer* pRenderer)
 	hr = D3DReadFileToBlob((ShaderFilePathName + L"IntegrateSpecularLD_PS.cso").c_str(), psBlob.GetAddressOf());
 	ThrowFailed(hr, "IntegrateSpecularLD_PS.cso read failed");
 
-	// [xXeVXe[g (DepthNone)
+	// 深度ステンシルステート (DepthNone相当)
 	D3D12_DEPTH_STENCIL_DESC descDSS = {};
 	descDSS.DepthEnable = FALSE;
 	descDSS.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
@@ -887,7 +887,7 @@ void IBLBakerStage::CreateSpecularLDPipeline(Renderer* pRenderer)
 	descDSS.FrontFace = defaultStencilOp;
 	descDSS.BackFace = defaultStencilOp;
 
-	// pCvCXe[g̐ݒ
+	// パイプラインステートの設定
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout = { elements, _countof(elements) };
 	desc.pRootSignature = m_pLDRootSignature->GetRootSignaturePtr();
@@ -40,14 +40,14 @@ void SceneStage::RecordStage(ID3D12GraphicsCommandList* pCmdList)
 {
 	if (m_pScene == nullptr)
 	{
-		assert(false && "V[nullł");
+		assert(false && "シーンがnullです");
 		return;
 	}
 
 	pCmdList->SetGraphicsRootSignature(m_pRootSignature->GetRootSignaturePtr());
 	pCmdList->SetPipelineState(m_pPSO->GetPipelineStatePtr());
 
-	// NAJ[̐ݒ
+	// クリアカラーの設定
 	float clearColor[] = { 0.25f, 0.25f, 0.25f, 1.0f };
 	auto rtv = m_pWindow->GetCurrentScreenRTV();
 	auto dsv = m_pWindow->GetDepthDSV();
@@ -63,7 +63,7 @@ void SceneStage::RecordStage(ID3D12GraphicsCommandList* pCmdList)
 	pCmdList->SetGraphicsRootDescriptorTable(9, m_IBLBakerStage->GetHandleGPU_SpecularLD());
 	pCmdList->SetGraphicsRootDescriptorTable(10, m_pShadowStage->GetDepthBuffer()->GetSRV());
 
-	// Cgs
+	// ライト行列
 	m_ShadowLightData.ViewProj = m_pShadowStage->GetVPMat();
 	m_ShadowLightData.Direction = m_pShadowStage->GetLightDir();
 	m_ShadowLightData.Padding = 0.0f;
@@ -83,7 +83,7 @@ void SceneStage::CreateRootSignature(Renderer* pRenderer)
 	flag |= D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS;
 	flag |= D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
 
-	// [gp[^̐ݒ
+	// ルートパラメータの設定
 	D3D12_DESCRIPTOR_RANGE BaseColorRange = {};
 	// t0 basecolor
 	BaseColorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
@@ -140,7 +140,7 @@ void SceneStage::CreateRootSignature(Renderer* pRenderer)
 	shadowRange.RegisterSpace = 0;
 	shadowRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
-	// [gp[^
+	// ルートパラメータ
 	D3D12_ROOT_PARAMETER param[11] = {};
 
 	// Transform CB : RootCBV
@@ -153,7 +153,7 @@ void SceneStage::CreateRootSignature(Renderer* pRenderer)
 	param[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
 	param[1].Constants.ShaderRegister = 1;  // b1
 	param[1].Constants.RegisterSpace = 0;
-	param[1].Constants.Num32BitValues = 4; // float4
+	param[1].Constants.Num32BitValues = 4; // float4つ
 	param[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
 
 	// Material CB : RootCBV
@@ -162,7 +162,7 @@ void SceneStage::CreateRootSignature(Renderer* pRenderer)
 	param[2].Descriptor.RegisterSpace = 0;
 	param[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
-	// LIghtMat // VhE}bvvZp
+	// LIghtMat // シャドウマップ計算用
 	param[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
 	param[3].Constants.ShaderRegister = 3;  // b3
 	param[3].Constants.RegisterSpace = 0;
@@ -206,7 +206,7 @@ void SceneStage::CreateRootSignature(Renderer* pRenderer)
 	param[10].DescriptorTable.pDescriptorRanges = &shadowRange;
 	param[10].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
-	// X^eBbNTv[̐ݒ
+	// スタティックサンプラーの設定
 	D3D12_STATIC_SAMPLER_DESC samplerDesc[7] = {};
 	samplerDesc[0] = SetStaticSamplerDesc(DX12Utility::SamplerState::LinearWrap, 0);
 	samplerDesc[1] = SetStaticSamplerDesc(DX12Utility::SamplerState::LinearWrap, 1);
@@ -216,7 +216,7 @@ void SceneStage::CreateRootSignature(Renderer* pRenderer)
 	samplerDesc[5] = SetStaticSamplerDesc(DX12Utility::SamplerState::LinearWrap, 5);
 	samplerDesc[6] = SetStaticSamplerDesc(DX12Utility::SamplerState::ShadowMapSampler, 6);
 
-	// [gVOl`̐ݒ
+	// ルートシグネチャの設定
 	D3D12_ROOT_SIGNATURE_DESC desc = {};
 	desc.NumParameters = _countof(param);
 	desc.pParameters = param;
@@ -224,7 +224,7 @@ void SceneStage::CreateRootSignature(Renderer* pRenderer)
 	desc.pStaticSamplers = samplerDesc;
 	desc.Flags = flag;
 
-	// [gVOl`̐
+	// ルートシグネチャの生成
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	m_pRootSignature = std::make_unique<DX12RootSignature>(pDevice, &desc);
 }
@@ -311,7 +311,7 @@ D3D12_STATIC_SAMPLER_DESC& SceneStage::SetStaticSamplerDesc(DX12Utility::Sampler
 	break;
 	default:
 	{
-		assert(false && "Ή̃Tv[Xe[gł");
+		assert(false && "未対応のサンプラーステートです");
 	}
 	break;
 	}
@@ -321,7 +321,7 @@ D3D12_STATIC_SAMPLER_DESC& SceneStage::SetStaticSamplerDesc(DX12Utility::Sampler
 
 void SceneStage::CreatePipeline(Renderer* pRenderer)
 {
-	// ̓CAEg̐ݒ
+	// 入力レイアウトの設定
 	D3D12_INPUT_ELEMENT_DESC elements[4];
 	elements[0].SemanticName = "POSITION";
 	elements[0].SemanticIndex = 0;
@@ -355,7 +355,7 @@ void SceneStage::CreatePipeline(Renderer* pRenderer)
 	elements[3].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
 	elements[3].InstanceDataStepRate = 0;
 
-	// X^CU[Xe[g̐ݒ
+	// ラスタライザーステートの設定
 	D3D12_RASTERIZER_DESC descRS;
 	descRS.FillMode = D3D12_FILL_MODE_SOLID;
 	descRS.CullMode = D3D12_CULL_MODE_NONE;
@@ -369,7 +369,7 @@ void SceneStage::CreatePipeline(Renderer* pRenderer)
 	descRS.ForcedSampleCount = 0;
 	descRS.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
 
-	// _[^[Qbg̃uhݒ
+	// レンダーターゲットのブレンド設定
 	D3D12_RENDER_TARGET_BLEND_DESC descRTBS = {
 		FALSE, FALSE,
 		D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
@@ -378,7 +378,7 @@ void SceneStage::CreatePipeline(Renderer* pRenderer)
 		D3D12_COLOR_WRITE_ENABLE_ALL
 	};
 
-	// uhXe[g̐ݒ
+	// ブレンドステートの設定
 	D3D12_BLEND_DESC descBS;
 	descBS.AlphaToCoverageEnable = FALSE;
 	descBS.IndependentBlendEnable = FALSE;
@@ -390,23 +390,23 @@ void SceneStage::CreatePipeline(Renderer* pRenderer)
 	ComPtr<ID3DBlob> vsBlob;
 	ComPtr<ID3DBlob> psBlob;
 
-	// _VF[_[ǂݍ
+	// 頂点シェーダー読み込み
 	static const std::wstring ShaderFilePathName = Utility::GetCurrentDir() + L"/assets/shaders/";
 	auto hr = D3DReadFileToBlob((ShaderFilePathName + L"DefaultVS.cso").c_str(), vsBlob.GetAddressOf());
 	ThrowFailed(hr);
 
-	// sNZVF[_[ǂݍ
+	// ピクセルシェーダー読み込み
 	hr = D3DReadFileToBlob((ShaderFilePathName + L"DefaultPS.cso").c_str(), psBlob.GetAddressOf());
 	ThrowFailed(hr);
 
-	// [xXeVXe[g̐ݒ
+	// 深度ステンシルステートの設定
 	D3D12_DEPTH_STENCIL_DESC descDSS = {};
 	descDSS.DepthEnable = TRUE;
 	descDSS.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
 	descDSS.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
 	descDSS.StencilEnable = FALSE;
 
-	// pCvCXe[g̐ݒ
+	// パイプラインステートの設定
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout = { elements, _countof(elements) };
 	desc.pRootSignature = m_pRootSignature->GetRootSignaturePtr();
@@ -423,7 +423,7 @@ void SceneStage::CreatePipeline(Renderer* pRenderer)
 	desc.SampleDesc.Count = 1;
 	desc.SampleDesc.Quality = 0;
 
-	// pCvCXe[g̐
+	// パイプラインステートの生成
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	m_pPSO = std::make_unique<DX12PipelineState>(pDevice, &desc);
 }
@@ -15,7 +15,7 @@
 ShadowStage::ShadowStage(Renderer* pRenderer) : RenderStage(pRenderer)
 {
 	m_pDepthBuffer = std::make_unique<DepthBuffer>(pRenderer, m_DepthBufferWidth, m_DepthBufferHeight);
-	// r[|[gƃVU[`̐ݒ
+	// ビューポートとシザー矩形の設定
 	m_Viewport.TopLeftX = 0.0f;
 	m_Viewport.TopLeftY = 0.0f;
 	m_Viewport.Width = static_cast<float>(m_DepthBufferWidth);
@@ -60,7 +60,7 @@ void ShadowStage::RecordStage(ID3D12GraphicsCommandList* pCmdList)
 {
 	if (m_pScene == nullptr)
 	{
-		assert(false && "V[ZbgĂ܂");
+		assert(false && "シーンがセットされていません");
 		return;
 	}
 
@@ -120,7 +120,7 @@ void ShadowStage::CreateRootSignature(Renderer* pRenderer)
 	flag |= D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS;
 	flag |= D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
 
-	// [gp[^
+	// ルートパラメータ
 	D3D12_ROOT_PARAMETER param[1] = {};
 
 	// Light Model Matrix CB : 32bitconst
@@ -130,7 +130,7 @@ void ShadowStage::CreateRootSignature(Renderer* pRenderer)
 	param[0].Constants.RegisterSpace = 0;
 	param[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
 
-	// [gVOl`̐ݒ
+	// ルートシグネチャの設定
 	D3D12_ROOT_SIGNATURE_DESC desc = {};
 	desc.NumParameters = _countof(param);
 	desc.NumStaticSamplers = 0;
@@ -138,14 +138,14 @@ void ShadowStage::CreateRootSignature(Renderer* pRenderer)
 	desc.pStaticSamplers = nullptr;
 	desc.Flags = flag;
 
-	// [gVOl`̐
+	// ルートシグネチャの生成
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	m_pRootSignature = std::make_unique<DX12RootSignature>(pDevice, &desc);
 }
 
 void ShadowStage::CreatePipeline(Renderer* pRenderer)
 {
-	// ̓CAEg̐ݒ
+	// 入力レイアウトの設定
 	D3D12_INPUT_ELEMENT_DESC elements[1];
 	elements[0].SemanticName = "POSITION";
 	elements[0].SemanticIndex = 0;
@@ -155,7 +155,7 @@ void ShadowStage::CreatePipeline(Renderer* pRenderer)
 	elements[0].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
 	elements[0].InstanceDataStepRate = 0;
 
-	// X^CU[Xe[g̐ݒ
+	// ラスタライザーステートの設定
 	D3D12_RASTERIZER_DESC descRS;
 	descRS.FillMode = D3D12_FILL_MODE_SOLID;
 	descRS.CullMode = D3D12_CULL_MODE_FRONT;
@@ -169,7 +169,7 @@ void ShadowStage::CreatePipeline(Renderer* pRenderer)
 	descRS.ForcedSampleCount = 0;
 	descRS.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
 
-	// _[^[Qbg̃uhݒ
+	// レンダーターゲットのブレンド設定
 	D3D12_RENDER_TARGET_BLEND_DESC descRTBS = {
 		FALSE, FALSE,
 		D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
@@ -178,7 +178,7 @@ void ShadowStage::CreatePipeline(Renderer* pRenderer)
 		D3D12_COLOR_WRITE_ENABLE_ALL
 	};
 
-	// uhXe[g̐ݒ
+	// ブレンドステートの設定
 	D3D12_BLEND_DESC descBS;
 	descBS.AlphaToCoverageEnable = FALSE;
 	descBS.IndependentBlendEnable = FALSE;
@@ -189,24 +189,24 @@ void ShadowStage::CreatePipeline(Renderer* pRenderer)
 
 	ComPtr<ID3DBlob> vsBlob;
 
-	// _VF[_[ǂݍ
+	// 頂点シェーダー読み込み
 	static const std::wstring ShaderFilePathName = Utility::GetCurrentDir() + L"/assets/shaders/";
 	auto hr = D3DReadFileToBlob((ShaderFilePathName + L"ShadowVS.cso").c_str(), vsBlob.GetAddressOf());
 	ThrowFailed(hr);
 
-	// [xXeVXe[g̐ݒ
+	// 深度ステンシルステートの設定
 	D3D12_DEPTH_STENCIL_DESC descDSS = {};
 	descDSS.DepthEnable = TRUE;
 	descDSS.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
 	descDSS.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
 	descDSS.StencilEnable = FALSE;
 
-	// pCvCXe[g̐ݒ
+	// パイプラインステートの設定
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout = { elements, _countof(elements) };
 	desc.pRootSignature = m_pRootSignature->GetRootSignaturePtr();
 	desc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
-	desc.PS = { nullptr, 0 }; // VhE}bvɐF͕sv
+	desc.PS = { nullptr, 0 }; // シャドウマップ生成に色は不要
 	desc.RasterizerState = descRS;
 	desc.BlendState = descBS;
 	desc.DepthStencilState = descDSS;
@@ -218,7 +218,7 @@ void ShadowStage::CreatePipeline(Renderer* pRenderer)
 	desc.SampleDesc.Count = 1;
 	desc.SampleDesc.Quality = 0;
 
-	// pCvCXe[g̐
+	// パイプラインステートの生成
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	m_pPSO = std::make_unique<DX12PipelineState>(pDevice, &desc);
 }
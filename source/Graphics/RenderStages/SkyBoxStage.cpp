@@ -29,7 +29,7 @@ void SkyBoxStage::RecordStage(ID3D12GraphicsCommandList* pCmdList, D3D12_GPU_DES
 {
 	if (m_pScene == nullptr)
 	{
-		assert(false && "V[nullł");
+		assert(false && "シーンがnullです");
 		return;
 	}
 	auto backBufferIndex = m_pWindow->GetCurrentBackBufferIndex();
@@ -86,19 +86,19 @@ void SkyBoxStage::CreateSkyBoxMesh()
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	auto vertCount = static_cast<uint32_t>(sizeof(vertices) / sizeof(vertices[0]));
 	auto vertSize = vertCount * sizeof(Vector3D);
-	// q[vvpeB
+	// ヒーププロパティ
 	D3D12_HEAP_PROPERTIES vertProp = {};
-	vertProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPU珑݉\ȃq[v
+	vertProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPUから書き込み可能なヒープ
 	vertProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
 	vertProp.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
 	vertProp.CreationNodeMask = 1;
 	vertProp.VisibleNodeMask = 1;
 
-	// \[X̐ݒ
+	// リソースの設定
 	D3D12_RESOURCE_DESC vertDesc = {};
 	vertDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
 	vertDesc.Alignment = 0;
-	vertDesc.Width = static_cast<uint64_t>(vertSize); // _f[^̃TCY
+	vertDesc.Width = static_cast<uint64_t>(vertSize); // 頂点データのサイズ
 	vertDesc.Height = 1;
 	vertDesc.DepthOrArraySize = 1;
 	vertDesc.MipLevels = 1;
@@ -108,7 +108,7 @@ void SkyBoxStage::CreateSkyBoxMesh()
 	vertDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 	vertDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-	// \[X𐶐
+	// リソースを生成
 	auto hr = pDevice->CreateCommittedResource(
 		&vertProp,
 		D3D12_HEAP_FLAG_NONE,
@@ -117,18 +117,18 @@ void SkyBoxStage::CreateSkyBoxMesh()
 		nullptr,
 		IID_PPV_ARGS(m_pVB.GetAddressOf())
 	);
-	ThrowFailed(hr, "_obt@̐Ɏs܂");
-	// }bsO
+	ThrowFailed(hr, "頂点バッファの生成に失敗しました");
+	// マッピング
 	void* ptr = nullptr;
 	hr = m_pVB->Map(0, nullptr, &ptr);
-	ThrowFailed(hr, "_obt@̃}bsOɎs܂");
-	// _f[^}bsOɐݒ
+	ThrowFailed(hr, "頂点バッファのマッピングに失敗しました");
+	// 頂点データをマッピング先に設定
 	memcpy(ptr, vertices, vertSize);
 
-	// }bsO
+	// マッピング解除
 	m_pVB->Unmap(0, nullptr);
 
-	// _obt@r[̐ݒ
+	// 頂点バッファビューの設定
 	m_VBV.BufferLocation = m_pVB->GetGPUVirtualAddress();
 	m_VBV.SizeInBytes = static_cast<UINT>(vertSize);
 	m_VBV.StrideInBytes = static_cast<UINT>(sizeof(Vector3D));
@@ -141,7 +141,7 @@ void SkyBoxStage::CreateRootSignature(Renderer* pRenderer)
 	flag |= D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS;
 	flag |= D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
 
-	// [gp[^̐ݒ
+	// ルートパラメータの設定
 	D3D12_DESCRIPTOR_RANGE range = {};
 	range.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
 	range.NumDescriptors = 1;
@@ -149,7 +149,7 @@ void SkyBoxStage::CreateRootSignature(Renderer* pRenderer)
 	range.RegisterSpace = 0;
 	range.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
-	// [gp[^
+	// ルートパラメータ
 	D3D12_ROOT_PARAMETER param[2] = {};
 
 	// hdri tex
@@ -166,7 +166,7 @@ void SkyBoxStage::CreateRootSignature(Renderer* pRenderer)
 	param[1].Constants.Num32BitValues = 48; // matrix4x4 * 3
 	param[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
 
-	// X^eBbNTv[̐ݒ
+	// スタティックサンプラーの設定
 	D3D12_STATIC_SAMPLER_DESC samplerDesc = {};
 	samplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
 	samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
@@ -182,7 +182,7 @@ void SkyBoxStage::CreateRootSignature(Renderer* pRenderer)
 	samplerDesc.RegisterSpace = 0;
 	samplerDesc.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
-	// [gVOl`̐ݒ
+	// ルートシグネチャの設定
 	D3D12_ROOT_SIGNATURE_DESC desc = {};
 	desc.NumParameters = _countof(param);
 	desc.NumStaticSamplers = 1;
@@ -190,14 +190,14 @@ void SkyBoxStage::CreateRootSignature(Renderer* pRenderer)
 	desc.pStaticSamplers = &samplerDesc;
 	desc.Flags = flag;
 
-	// [gVOl`̐
+	// ルートシグネチャの生成
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	m_pRootSignature = std::make_unique<DX12RootSignature>(pDevice, &desc);
 }
 
 void SkyBoxStage::CreatePipeline(Renderer* pRenderer)
 {
-	// ̓CAEg̐ݒ
+	// 入力レイアウトの設定
 	D3D12_INPUT_ELEMENT_DESC elements[1];
 	elements[0].SemanticName = "POSITION";
 	elements[0].SemanticIndex = 0;
@@ -207,7 +207,7 @@ void SkyBoxStage::CreatePipeline(Renderer* pRenderer)
 	elements[0].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
 	elements[0].InstanceDataStepRate = 0;
 
-	// X^CU[Xe[g̐ݒ
+	// ラスタライザーステートの設定
 	D3D12_RASTERIZER_DESC descRS;
 	descRS.FillMode = D3D12_FILL_MODE_SOLID;
 	descRS.CullMode = D3D12_CULL_MODE_NONE;
@@ -221,7 +221,7 @@ void SkyBoxStage::CreatePipeline(Renderer* pRenderer)
 	descRS.ForcedSampleCount = 0;
 	descRS.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
 
-	// _[^[Qbg̃uhݒ
+	// レンダーターゲットのブレンド設定
 	D3D12_RENDER_TARGET_BLEND_DESC descRTBS = {
 		FALSE, FALSE,
 		D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
@@ -230,7 +230,7 @@ void SkyBoxStage::CreatePipeline(Renderer* pRenderer)
 		D3D12_COLOR_WRITE_ENABLE_ALL
 	};
 
-	// uhXe[g̐ݒ
+	// ブレンドステートの設定
 	D3D12_BLEND_DESC descBS;
 	descBS.AlphaToCoverageEnable = FALSE;
 	descBS.IndependentBlendEnable = FALSE;
@@ -242,23 +242,23 @@ void SkyBoxStage::CreatePipeline(Renderer* pRenderer)
 	ComPtr<ID3DBlob> vsBlob;
 	ComPtr<ID3DBlob> psBlob;
 
-	// _VF[_[ǂݍ
+	// 頂点シェーダー読み込み
 	static const std::wstring ShaderFilePathName = Utility::GetCurrentDir() + L"/assets/shaders/";
 	auto hr = D3DReadFileToBlob((ShaderFilePathName + L"SkyBoxVS.cso").c_str(), vsBlob.GetAddressOf());
 	ThrowFailed(hr);
 
-	// sNZVF[_[ǂݍ
+	// ピクセルシェーダー読み込み
 	hr = D3DReadFileToBlob((ShaderFilePathName + L"SkyBoxPS.cso").c_str(), psBlob.GetAddressOf());
 	ThrowFailed(hr);
 
-	// [xXeVXe[g̐ݒ
+	// 深度ステンシルステートの設定
 	D3D12_DEPTH_STENCIL_DESC descDSS = {};
 	descDSS.DepthEnable = TRUE;
 	descDSS.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
 	descDSS.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
 	descDSS.StencilEnable = FALSE;
 
-	// pCvCXe[g̐ݒ
+	// パイプラインステートの設定
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout = { elements, _countof(elements) };
 	desc.pRootSignature = m_pRootSignature->GetRootSignaturePtr();
@@ -275,7 +275,7 @@ void SkyBoxStage::CreatePipeline(Renderer* pRenderer)
 	desc.SampleDesc.Count = 1;
 	desc.SampleDesc.Quality = 0;
 
-	// pCvCXe[g̐
+	// パイプラインステートの生成
 	auto pDevice = m_pRenderer->GetDevice().Get();
 	m_pPSO = std::make_unique<DX12PipelineState>(pDevice, &desc);
 }
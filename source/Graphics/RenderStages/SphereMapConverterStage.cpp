@@ -117,7 +117,7 @@ void SphereMapConverterStage::DrawSphere(ID3D12GraphicsCommandList* pCmdList)
 
 void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMapDesc)
 {
-    // bTCY߂
+    // 暫定サイズを求める
     auto tempSize = sphereMapDesc.Width / 4;
 
     uint32_t currSize = 1;
@@ -126,10 +126,10 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
     uint32_t size = 0;
     uint32_t mipLevels = 0;
 
-    // [vȂԋ߂2ׂ̂T
+    // ループしながら一番近い2のべき乗を探す
     for (;;)
     {
-        // bTCY܂܂邩ǂ
+        // 暫定サイズが含まれるかどうか判定
         if (prevSize < tempSize && tempSize <= currSize)
         {
             size = currSize;
@@ -137,13 +137,13 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
             break;
         }
 
-        // ÕTCYXV
+        // 前のサイズを更新
         prevSize = currSize;
 
-        // eNX`TCYQ{
+        // テクスチャサイズを２倍
         currSize <<= 1;
 
-        // ݂ՃxJEgAbv
+        // みっぷレベルをカウントアップ
         currMipLevels++;
     }
 
@@ -183,7 +183,7 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
         IID_PPV_ARGS(m_pCubeTex.GetAddressOf()));
     ThrowFailed(hr);
 
-    // SRV̍쐬
+    // SRVの作成
     auto SRVHeap = m_pRenderer->GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
     m_SRVIndex = SRVHeap->GetNextAvailableIndex();
 
@@ -201,7 +201,7 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
         SRVHeap->GetCpuHandle(m_SRVIndex)
     );
 
-    // RTV̍쐬
+    // RTVの作成
     auto RTVHeap = m_pRenderer->GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
     m_RTVIndeies.resize(m_MipCount * 6);
     auto idx = 0;
@@ -225,15 +225,15 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
         }
     }
 
-    // ϊobt@̐
+    // 変換バッファの生成
     auto pos = Vector3D(0.0f, 0.0f, 0.0f);
     Vector3D target[6] = {
             Vector3D(1.0f,  0.0f,  0.0f),  // +X
             Vector3D(-1.0f,  0.0f,  0.0f), // -X
             Vector3D(0.0f,  1.0f,  0.0f),  // +Y
             Vector3D(0.0f, -1.0f,  0.0f),  // -Y
-            Vector3D(0.0f,  0.0f,  1.0f),  // +Z (DXn̑O) 
-            Vector3D(0.0f,  0.0f, -1.0f),  // -Z (DXň)
+            Vector3D(0.0f,  0.0f,  1.0f),  // +Z (DX左手系の前方) 
+            Vector3D(0.0f,  0.0f, -1.0f),  // -Z (DX左手系の後方)
     };
 
     Vector3D upward[6] = {
@@ -261,16 +261,16 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
     std::vector<Vertex>   vertices;
     std::vector<uint32_t> indices;
 
-    // 
+    // 分割数
     auto tessellation = 20u;
 
     uint32_t verticalSegments = tessellation * 2;
     uint32_t horizontalSegments = tessellation * 2;
 
-    // ̔a.
+    // 球の半径.
     float radius = 10.0f;
 
-    // _W߂
+    // 頂点座標を求める
     for (size_t i = 0; i <= verticalSegments; i++)
     {
         float v = 1 - (float)i / verticalSegments;
@@ -283,7 +283,7 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
         {
             float u = (float)j / horizontalSegments;
 
-            // C1F PI / 2 ł͂ȂAPI * 2.0f (360x) ɕύX
+            // ★修正1： PI / 2 ではなく、PI * 2.0f (360度) に変更
             float longitude = j * MathUtility::PI * 2.0f / horizontalSegments;
 
             float dx = sinf(longitude);
@@ -305,15 +305,15 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
 
     uint32_t stride = horizontalSegments + 1;
 
-    // _CfbNX߂.
-    // C2F j <= ... ł͂ȂA j < ... ɕύXĖʂȏkރ|Sh
+    // 頂点インデックスを求める.
+    // ★修正2： j <= ... ではなく、 j < ... に変更して無駄な縮退ポリゴンを防ぐ
     for (auto i = 0u; i < verticalSegments; i++)
     {
         for (auto j = 0u; j < horizontalSegments; j++)
         {
             auto nextI = i + 1;
-            // j < horizontalSegments Ȃ̂ŁA% stride ȂĂzOQƂɂ͂Ȃ܂񂪁A
-            // SƂĎcĂ肠܂i͕ς܂j
+            // j < horizontalSegments なので、% stride をしなくても配列外参照にはなりませんが、
+            // 安全策として残しても問題ありません（挙動は変わりません）
             auto nextJ = j + 1;
 
             indices.push_back(i * stride + j);
@@ -327,19 +327,19 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
     }
 
     auto vertSize = vertices.size() * sizeof(Vertex);
-    // q[vvpeB
+    // ヒーププロパティ
     D3D12_HEAP_PROPERTIES vertProp = {};
-    vertProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPU珑݉\ȃq[v
+    vertProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPUから書き込み可能なヒープ
     vertProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
     vertProp.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
     vertProp.CreationNodeMask = 1;
     vertProp.VisibleNodeMask = 1;
 
-    // \[X̐ݒ
+    // リソースの設定
     D3D12_RESOURCE_DESC vertDesc = {};
     vertDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
     vertDesc.Alignment = 0;
-    vertDesc.Width = static_cast<uint64_t>(vertSize); // _f[^̃TCY
+    vertDesc.Width = static_cast<uint64_t>(vertSize); // 頂点データのサイズ
     vertDesc.Height = 1;
     vertDesc.DepthOrArraySize = 1;
     vertDesc.MipLevels = 1;
@@ -349,7 +349,7 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
     vertDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
     vertDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-    // \[X𐶐
+    // リソースを生成
     hr = pDevice->CreateCommittedResource(
         &vertProp,
         D3D12_HEAP_FLAG_NONE,
@@ -358,38 +358,38 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
         nullptr,
         IID_PPV_ARGS(m_pVB.GetAddressOf())
     );
-    ThrowFailed(hr, "_obt@̐Ɏs܂");
-    // }bsO
+    ThrowFailed(hr, "頂点バッファの生成に失敗しました");
+    // マッピング
     void* ptr = nullptr;
     hr = m_pVB->Map(0, nullptr, &ptr);
-    ThrowFailed(hr, "_obt@̃}bsOɎs܂");
-    // _f[^}bsOɐݒ
+    ThrowFailed(hr, "頂点バッファのマッピングに失敗しました");
+    // 頂点データをマッピング先に設定
     if (vertices.data())
         memcpy(ptr, vertices.data(), vertSize);
 
-    // }bsO
+    // マッピング解除
     m_pVB->Unmap(0, nullptr);
 
-    // _obt@r[̐ݒ
+    // 頂点バッファビューの設定
     m_VBV.BufferLocation = m_pVB->GetGPUVirtualAddress();
     m_VBV.SizeInBytes = static_cast<UINT>(vertSize);
     m_VBV.StrideInBytes = static_cast<UINT>(sizeof(Vertex));
 
     auto indicesSize = sizeof(uint32_t) * indices.size();
 
-    // q[vvpeB
+    // ヒーププロパティ
     D3D12_HEAP_PROPERTIES indicesProp = {};
-    indicesProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPU珑݉\ȃq[v
+    indicesProp.Type = D3D12_HEAP_TYPE_UPLOAD; // CPUから書き込み可能なヒープ
     indicesProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
     indicesProp.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
     indicesProp.CreationNodeMask = 1;
     indicesProp.VisibleNodeMask = 1;
 
-    // \[X̐ݒ
+    // リソースの設定
     D3D12_RESOURCE_DESC indicesDesc = {};
     indicesDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
     indicesDesc.Alignment = 0;
-    indicesDesc.Width = static_cast<uint64_t>(indicesSize); // CfbNXf[^̃TCY
+    indicesDesc.Width = static_cast<uint64_t>(indicesSize); // インデックスデータのサイズ
     indicesDesc.Height = 1;
     indicesDesc.DepthOrArraySize = 1;
     indicesDesc.MipLevels = 1;
@@ -399,7 +399,7 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
     indicesDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
     indicesDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-    // \[X𐶐
+    // リソースを生成
     hr = pDevice->CreateCommittedResource(
         &indicesProp,
         D3D12_HEAP_FLAG_NONE,
@@ -408,19 +408,19 @@ void SphereMapConverterStage::CreateTexture(const D3D12_RESOURCE_DESC& sphereMap
         nullptr,
         IID_PPV_ARGS(m_pIB.GetAddressOf())
     );
-    ThrowFailed(hr, "CfbNXobt@̐Ɏs܂");
-    // }bsO
+    ThrowFailed(hr, "インデックスバッファの生成に失敗しました");
+    // マッピング
     ptr = nullptr;
     hr = m_pIB->Map(0, nullptr, &ptr);
-    ThrowFailed(hr, "CfbNXobt@̃}bsOɎs܂");
+    ThrowFailed(hr, "インデックスバッファのマッピングに失敗しました");
 
-    // CfbNXf[^}bsOɐݒ
+    // インデックスデータをマッピング先に設定
     memcpy(ptr, indices.data(), indicesSize);
 
-    // }bsO
+    // マッピング解除
     m_pIB->Unmap(0, nullptr);
 
-    // CfbNXobt@r[̐ݒ
+    // インデックスバッファビューの設定
     m_IBV.BufferLocation = m_pIB->GetGPUVirtualAddress();
     m_IBV.Format = DXGI_FORMAT_R32_UINT;
     m_IBV.SizeInBytes = static_cast<UINT>(indicesSize);
@@ -437,31 +437,31 @@ void SphereMapConverterStage::CreateRootSignature(Renderer* pRenderer)
     flag |= D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS;
     flag |= D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
 
-    // W̐ݒ
+    // レンジの設定
     D3D12_DESCRIPTOR_RANGE range[1] = {};
-    // range[1]: SRV (t0) -> SphereMapeNX`p
+    // range[1]: SRV (t0) -> SphereMapテクスチャ用
     range[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
     range[0].NumDescriptors = 1;
     range[0].BaseShaderRegister = 0;
     range[0].RegisterSpace = 0;
     range[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
-    // [gp[^̐ݒ
+    // ルートパラメータの設定
     D3D12_ROOT_PARAMETER param[2] = {};
-    // param[0]: Vertex Shaderp (CBV)
+    // param[0]: Vertex Shader用 (CBV)
     param[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
     param[0].Constants.ShaderRegister = 0;  // b0
     param[0].Constants.RegisterSpace = 0;
     param[0].Constants.Num32BitValues = 48; // matrix4x4 * 3
     param[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
 
-    // param[1]: Pixel Shaderp (SRV)
+    // param[1]: Pixel Shader用 (SRV)
     param[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
     param[1].DescriptorTable.NumDescriptorRanges = 1;
     param[1].DescriptorTable.pDescriptorRanges = range;
     param[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
-    // X^eBbNTv[̐ݒ
+    // スタティックサンプラーの設定
     D3D12_STATIC_SAMPLER_DESC sampler = {};
     sampler.Filter = D3D12_FILTER_ANISOTROPIC;
     sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
@@ -477,7 +477,7 @@ void SphereMapConverterStage::CreateRootSignature(Renderer* pRenderer)
     sampler.RegisterSpace = 0;
     sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
-    // [gVOl`Lqq̐ݒ
+    // ルートシグネチャ記述子の設定
     D3D12_ROOT_SIGNATURE_DESC desc = {};
     desc.NumParameters = _countof(param);
     desc.NumStaticSamplers = 1;
@@ -485,20 +485,20 @@ void SphereMapConverterStage::CreateRootSignature(Renderer* pRenderer)
     desc.pStaticSamplers = &sampler;
     desc.Flags = flag;
 
-    // [gVOl`̐
+    // ルートシグネチャの生成
     auto pDevice = m_pRenderer->GetDevice().Get();
     m_pRootSignature = std::make_unique<DX12RootSignature>(pDevice, &desc);
 }
 
 void SphereMapConverterStage::CreatePipeline(Renderer* pRenderer)
 {
-    // ̓CAEg̐ݒ (POSITION + TEXCOORD)
+    // 入力レイアウトの設定 (POSITION + TEXCOORD)
     D3D12_INPUT_ELEMENT_DESC elements[] = {
         { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
         { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
     };
 
-    // X^CU[Xe[g (CullNone)
+    // ラスタライザーステート (CullNone)
     D3D12_RASTERIZER_DESC descRS = {};
     descRS.FillMode = D3D12_FILL_MODE_SOLID;
     descRS.CullMode = D3D12_CULL_MODE_NONE;
@@ -512,7 +512,7 @@ void SphereMapConverterStage::CreatePipeline(Renderer* pRenderer)
     descRS.ForcedSampleCount = 0;
     descRS.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
 
-    // _[^[Qbg̃uhݒ (Opaque)
+    // レンダーターゲットのブレンド設定 (Opaque)
     D3D12_RENDER_TARGET_BLEND_DESC descRTBS = {
         FALSE, FALSE,
         D3D12_BLEND_ONE, D3D12_BLEND_ZERO, D3D12_BLEND_OP_ADD,
@@ -532,7 +532,7 @@ void SphereMapConverterStage::CreatePipeline(Renderer* pRenderer)
     ComPtr<ID3DBlob> vsBlob;
     ComPtr<ID3DBlob> psBlob;
 
-    // VF[_[ǂݍ
+    // シェーダー読み込み
     static const std::wstring ShaderFilePathName = Utility::GetCurrentDir() + L"/assets/shaders/";
 
     auto hr = D3DReadFileToBlob((ShaderFilePathName + L"SphereToCubeVS.cso").c_str(), vsBlob.GetAddressOf());
@@ -541,7 +541,7 @@ void SphereMapConverterStage::CreatePipeline(Renderer* pRenderer)
     hr = D3DReadFileToBlob((ShaderFilePathName + L"SphereToCubePS.cso").c_str(), psBlob.GetAddressOf());
     ThrowFailed(hr, "SphereToCubePS.cso read failed");
 
-    // [xXeVXe[g (DepthNone)
+    // 深度ステンシルステート (DepthNone相当)
     D3D12_DEPTH_STENCIL_DESC descDSS = {};
     descDSS.DepthEnable = FALSE;
     descDSS.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
@@ -558,7 +558,7 @@ void SphereMapConverterStage::CreatePipeline(Renderer* pRenderer)
     descDSS.FrontFace = defaultStencilOp;
     descDSS.BackFace = defaultStencilOp;
 
-    // pCvCXe[g̐ݒ
+    // パイプラインステートの設定
     D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
     desc.InputLayout = { elements, _countof(elements) };
     desc.pRootSignature = m_pRootSignature->GetRootSignaturePtr();
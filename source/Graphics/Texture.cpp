@@ -6,7 +6,7 @@
 namespace {
 
     //-----------------------------------------------------------------------------
-    //      SRGBtH[}bgɕϊ܂.
+    //      SRGBフォーマットに変換します.
     //-----------------------------------------------------------------------------
     DXGI_FORMAT ConvertToSRGB(DXGI_FORMAT format)
     {
@@ -57,7 +57,7 @@ Texture::Texture(Renderer* pRenderer, const std::wstring& filePath, D3D12_RESOUR
     DirectX::ScratchImage image = {};
     std::vector<D3D12_SUBRESOURCE_DATA> subResources;
 
-    // 1. 摜t@C̓ǂݍ
+    // 1. 画像ファイルの読み込み
     std::wstring fileName = ExChangeFileExtension(filePath);
     auto ext = FileExtension(fileName);
     HRESULT hr = S_FALSE;
@@ -84,15 +84,15 @@ Texture::Texture(Renderer* pRenderer, const std::wstring& filePath, D3D12_RESOUR
     }
     else
     {
-        assert(false && "Ή̉摜tH[}bgł");
+        assert(false && "未対応の画像フォーマットです");
     }
 
     DXGI_FORMAT resourceFormat = ConvertToSRGB(metaData.format);
 
-    // Abv[hpf[^̏
+    // アップロード用データの準備
     DirectX::PrepareUpload(pDevice, image.GetImages(), image.GetImageCount(), metaData, subResources);
 
-    // 2. eNX`\[X (Default Heap) ̍쐬
+    // 2. テクスチャリソース (Default Heap) の作成
     D3D12_HEAP_PROPERTIES textureProp = {};
     textureProp.Type = D3D12_HEAP_TYPE_DEFAULT;
     textureProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
@@ -102,7 +102,7 @@ Texture::Texture(Renderer* pRenderer, const std::wstring& filePath, D3D12_RESOUR
 
     D3D12_RESOURCE_DESC desc = {};
     desc.MipLevels = static_cast<UINT16>(metaData.mipLevels);
-    desc.Format = resourceFormat; // SRGBϊ̃tH[}bggp
+    desc.Format = resourceFormat; // SRGB変換後のフォーマットを使用
     desc.Width = static_cast<UINT>(metaData.width);
     desc.Height = static_cast<UINT>(metaData.height);
     desc.Flags = flag;
@@ -115,13 +115,13 @@ Texture::Texture(Renderer* pRenderer, const std::wstring& filePath, D3D12_RESOUR
         &textureProp,
         D3D12_HEAP_FLAG_NONE,
         &desc,
-        D3D12_RESOURCE_STATE_COPY_DEST, // Ԃ̓Rs[
+        D3D12_RESOURCE_STATE_COPY_DEST, // 初期状態はコピー先
         nullptr,
         IID_PPV_ARGS(m_pResource.GetAddressOf())
     );
     ThrowFailed(hr);
 
-    // 3. Abv[hpobt@ (Upload Heap) ̍쐬
+    // 3. アップロード用バッファ (Upload Heap) の作成
     const uint64_t texBufferSize = GetRequiredIntermediateSize(m_pResource.Get(), 0, subResources.size());
 
     D3D12_HEAP_PROPERTIES uploadProp = {};
@@ -144,7 +144,7 @@ Texture::Texture(Renderer* pRenderer, const std::wstring& filePath, D3D12_RESOUR
     uploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
     uploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-    // ꎞ\[XȂ̂ŃX}[g|C^ŊǗA֐I(WaitGpu)ɔj
+    // 一時リソースなのでスマートポインタで管理し、関数終了時(WaitGpu後)に破棄させる
     ComPtr<ID3D12Resource> uploadResource;
 
     hr = pDevice->CreateCommittedResource(
@@ -163,11 +163,11 @@ Texture::Texture(Renderer* pRenderer, const std::wstring& filePath, D3D12_RESOUR
     hr = pDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(tempAllocator.GetAddressOf()));
     ThrowFailed(hr);
 
-    // CreateCommandList Open ԂȂ̂ Reset sv
+    // CreateCommandListした直後は Open 状態なので Reset 不要
     hr = pDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, tempAllocator.Get(), nullptr, IID_PPV_ARGS(tempCommandList.GetAddressOf()));
     ThrowFailed(hr);
 
-    // Tu\[X̍XVR}hL^
+    // サブリソースの更新コマンドを記録
     UpdateSubresources(
         tempCommandList.Get(),
         m_pResource.Get(),
@@ -177,7 +177,7 @@ Texture::Texture(Renderer* pRenderer, const std::wstring& filePath, D3D12_RESOUR
         subResources.data()
     );
 
-    // \[XoA (COPY_DEST -> PIXEL_SHADER_RESOURCE)
+    // リソースバリア (COPY_DEST -> PIXEL_SHADER_RESOURCE)
     D3D12_RESOURCE_BARRIER barrier = {};
     barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
     barrier.Transition.pResource = m_pResource.Get();
@@ -186,18 +186,18 @@ Texture::Texture(Renderer* pRenderer, const std::wstring& filePath, D3D12_RESOUR
     barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
     tempCommandList->ResourceBarrier(1, &barrier);
 
-    // R}hL^I
+    // コマンド記録終了
     tempCommandList->Close();
 
-    // s (L[Renderer̂̂gp)
+    // 実行 (キューはRendererのものを使用)
     ID3D12CommandQueue* pQueue = pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT)->GetCommandQueue().Get();
     ID3D12CommandList* ppCommandLists[] = { tempCommandList.Get() };
     pQueue->ExecuteCommandLists(1, ppCommandLists);
 
-    // ]܂őҋ@
+    // 転送完了まで待機
     pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT)->WaitGpu(INFINITE);
 
-    // 5. VF[_[\[Xr[ (SRV) ̍쐬
+    // 5. シェーダーリソースビュー (SRV) の作成
     SRVHeap = pRenderer->GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
     srvIndex = SRVHeap->GetNextAvailableIndex();
     D3D12_SHADER_RESOURCE_VIEW_DESC viewDesc = GetViewDesc(desc);
@@ -234,7 +234,7 @@ D3D12_SHADER_RESOURCE_VIEW_DESC Texture::GetViewDesc(D3D12_RESOURCE_DESC desc)
     {
     case D3D12_RESOURCE_DIMENSION_BUFFER:
     {
-        assert("obt@͑ΏۊO");
+        assert("バッファは対象外");
     }
     break;
 
@@ -315,8 +315,8 @@ D3D12_SHADER_RESOURCE_VIEW_DESC Texture::GetViewDesc(D3D12_RESOURCE_DESC desc)
 
     default:
     {
-        // zO
-        assert("zÕeNX`ł.");
+        // 想定外
+        assert("想定外のテクスチャです.");
     }
     break;
     }
@@ -119,19 +119,19 @@ void Transform::Update()
 	auto pos = Matrix4x4::TransitionToMatrix(m_Position);
 	m_World = scale * rot * pos;
 
-	// 0s: Right (X)
+	// 0行目: Right (X軸)
 	m_Right.x = m_World.m_mat[0][0];
 	m_Right.y = m_World.m_mat[0][1];
 	m_Right.z = m_World.m_mat[0][2];
 	m_Right.GetSafeNormal();
 
-	// 1s: Up (Y)
+	// 1行目: Up (Y軸)
 	m_Up.x = m_World.m_mat[1][0];
 	m_Up.y = m_World.m_mat[1][1];
 	m_Up.z = m_World.m_mat[1][2];
 	m_Up.GetSafeNormal();
 
-	// 2s: Forward (Z)
+	// 2行目: Forward (Z軸)
 	m_Forward.x = m_World.m_mat[2][0];
 	m_Forward.y = m_World.m_mat[2][1];
 	m_Forward.z = m_World.m_mat[2][2];
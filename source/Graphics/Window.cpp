@@ -12,7 +12,7 @@ Window::Window(Renderer* pRenderer, const std::wstring& applicationName, uint32_
 	m_pDevice = pRenderer->GetDevice().Get();
 	m_pRTVHeap = pRenderer->GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 	m_pDSVHeap = pRenderer->GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
-	// RTVCfbNX̎擾
+	// RTVインデックスの取得
 	for (int i = 0; i < FrameCount; i++)
 	{
 		m_pScreenBufferRTVs[i] = m_pRTVHeap->GetNextAvailableIndex();
@@ -27,7 +27,7 @@ Window::Window(Renderer* pRenderer, const std::wstring& applicationName, uint32_
 	UpdateScreenBuffers();
 	UpdateDepthBuffer();
 
-	// r[|[gƃVU[`̐ݒ
+	// ビューポートとシザー矩形の設定
 	m_Viewport.TopLeftX = 0.0f;
 	m_Viewport.TopLeftY = 0.0f;
 	m_Viewport.Width = static_cast<float>(m_Width);
@@ -40,17 +40,17 @@ Window::Window(Renderer* pRenderer, const std::wstring& applicationName, uint32_
 	m_Scissor.top = 0;
 	m_Scissor.bottom = static_cast<LONG>(m_Height);
 
-	// EBhE\
+	// ウィンドウを表示
 	ShowWindow(m_hWnd, SW_SHOWNORMAL);
-	// EBhEXV
+	// ウィンドウを更新
 	UpdateWindow(m_hWnd);
-	// EBhEɃtH[JXݒ
+	// ウィンドウにフォーカスを設定
 	SetFocus(m_hWnd);
 }
 
 Window::~Window()
 {
-	// EBhE̓o^
+	// ウィンドウの登録を解除
 	if (m_HInstance != nullptr)
 	{
 		UnregisterClass(m_WindowName.c_str(), m_HInstance);
@@ -61,12 +61,12 @@ Window::~Window()
 }
 
 /// <summary>
-/// ʂɕ\Ãt[̏s܂D
+/// 画面に表示し、次のフレームの準備を行います．
 /// </summary>
-/// <param name="interval"> fBXvC̐ƃt[̕\𓯊@ 0 : Ȃ 1 : </param>
+/// <param name="interval"> ディスプレイの垂直同期とフレームの表示を同期する方法 0 : 同期なし 1 : 同期あり</param>
 void Window::Present(uint32_t interval)
 {
-	// ʂɕ\
+	// 画面に表示
 	m_pSwapChain->Present(interval, 0);
 }
 
@@ -122,24 +122,24 @@ uint32_t Window::GetCurrentBackBufferIndex() const
 
 void Window::SetupWindow()
 {
-	// CX^Xnh擾
+	// インスタンスハンドルを取得
 	auto hInst = GetModuleHandle(nullptr);
 	assert(hInst != nullptr);
 
-	// CX^Xnh̐ݒ
+	// インスタンスハンドルの設定
 	m_HInstance = hInst;
 
-	// EBhẼTCYݒ
+	// ウィンドウのサイズを設定
 	RECT rect = {};
 	rect.right = static_cast<LONG>(m_Width);
 	rect.bottom = static_cast<LONG>(m_Height);
 
-	// EBhETCY𒲐
+	// ウィンドウサイズを調整
 	auto style = WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU;
 	style = WS_OVERLAPPEDWINDOW;
 	AdjustWindowRect(&rect, style, FALSE);
 
-	// EBhE𐶐
+	// ウィンドウを生成
 	m_hWnd = CreateWindowEx(
 		0,
 		m_WindowName.c_str(),
@@ -161,12 +161,12 @@ void Window::SetupWindow()
 
 void Window::CreateSwapChain(Renderer* pRenderer)
 {
-	// DXGIt@Ng[̐
+	// DXGIファクトリーの生成
 	ComPtr<IDXGIFactory4> pFactory = nullptr;
 	auto hr = CreateDXGIFactory1(IID_PPV_ARGS(pFactory.GetAddressOf()));
 	ThrowFailed(hr);
 
-	// Xbv`F[̐ݒ
+	// スワップチェーンの設定
 	DXGI_SWAP_CHAIN_DESC desc = {};
 	desc.BufferDesc.Width = m_Width;
 	desc.BufferDesc.Height = m_Height;
@@ -184,13 +184,13 @@ void Window::CreateSwapChain(Renderer* pRenderer)
 	desc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 	desc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
 
-	// Xbv`F[̐
+	// スワップチェーンの生成
 	ComPtr<IDXGISwapChain> pSwapChain = nullptr;
 	ID3D12CommandQueue* pCommandQueue = pRenderer->GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT)->GetCommandQueue().Get();
 	hr = pFactory->CreateSwapChain(pCommandQueue, &desc, pSwapChain.GetAddressOf());
 	ThrowFailed(hr);
 
-	// IDXGISwapChain3擾
+	// IDXGISwapChain3を取得
 	hr = pSwapChain->QueryInterface(IID_PPV_ARGS(m_pSwapChain.GetAddressOf()));
 	ThrowFailed(hr);
 }
@@ -201,31 +201,31 @@ void Window::UpdateRenderBuffers()
 
 void Window::UpdateScreenBuffers()
 {
-	// ̉ʃobt@
+	// 既存の画面バッファを解放
 	for (uint32_t i = 0; i < FrameCount; ++i)
 	{
 		m_pScreenBuffers[i].Reset();
 	}
 
-	// Xbv`F[̃TCY
+	// スワップチェーンのリサイズ
 	DXGI_SWAP_CHAIN_DESC desc = {};
 	ThrowFailed(m_pSwapChain->GetDesc(&desc));
 	ThrowFailed(m_pSwapChain->ResizeBuffers(FrameCount, m_Width, m_Height, desc.BufferDesc.Format, desc.Flags));
 
-	// RTV̍쐬
+	// RTVの作成
 	for (uint32_t i = 0; i < FrameCount; ++i)
 	{
-		// Xbv`F[ʃobt@擾
+		// スワップチェーンから画面バッファを取得
 		ThrowFailed(m_pSwapChain->GetBuffer(i, IID_PPV_ARGS(m_pScreenBuffers[i].GetAddressOf())));
 
-		// RTV̐ݒ
+		// RTVの設定
 		D3D12_RENDER_TARGET_VIEW_DESC rtvDesc = {};
 		rtvDesc.Format = desc.BufferDesc.Format;
 		rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
 		rtvDesc.Texture2D.MipSlice = 0;
 		rtvDesc.Texture2D.PlaneSlice = 0;
 
-		// RTV̍쐬
+		// RTVの作成
 		m_pDevice->CreateRenderTargetView(
 			m_pScreenBuffers[i].Get(),
 			&rtvDesc,
@@ -270,7 +270,7 @@ void Window::UpdateDepthBuffer()
 	clearValue.DepthStencil.Depth = 1.0f;
 	clearValue.DepthStencil.Stencil = 0;
 
-	// DSV̍쐬
+	// DSVの作成
 	auto hr = m_pDevice->CreateCommittedResource(
 		&prop,
 		D3D12_HEAP_FLAG_NONE,
@@ -0,0 +1,812 @@
+#include "pch.h"
+#include "Simulation/CPUFluidSolver.h"
+#include "Simulation/DistributedFluidSolver.h"
+#include "Simulation/FluidScenario.h"
+#include "Simulation/Checkpoint.h"
+#include "Simulation/Trajectory.h"
+#include "Simulation/ParticleExporter.h"
+#include "Simulation/SurfaceExtractor.h"
+#include "Simulation/SignedDistanceField.h"
+#include "Simulation/TriangleBVH.h"
+#include "Simulation/ThreadPool.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+// GPU/ウィンドウなしでCPUソルバーを実行し、パス毎の処理時間を出力するツール
+// 使い方は PrintUsage (--help)
+// --restart はチェックポイントから粒子とパラメータを読み込んで続きから進める (--particles, --scene, --seed は使わない)
+// --checkpoint は N ステップ毎 (0 は最後だけ) にバックグラウンドでチェックポイントを書き込む
+// --trajectory は毎ステップの粒子の位置・速度を圧縮した軌跡ファイルに記録する (記録の時間はパス毎の処理時間に含まない)
+// --export は N ステップ毎に粒子を PREFIX_フレーム番号.vtk などに書き出す。書き込みはバックグラウンドで行い、
+//          バッファが空いていない場合は待たずにフレームを捨てる (skip は新しいフレーム、replace は書き込み待ちの古いフレームを捨てる)
+// --surface は N ステップ毎 (0 は最後だけ) に密度場の等値面をマーチングキューブでメッシュにして PREFIX_フレーム番号.ply に書き込む
+//           (S は格子の間隔の H に対する比。抽出と書き込みの時間はパス毎の処理時間に含まない)
+//           anisotropic は粒子の近傍の分布から楕円体のカーネルを作って配る (粗い格子でも水面が滑らか)
+// --collider は閉じた三角形メッシュ (OBJ) からSDFを焼き込んで障害物にする。焼き込んだSDFは DIR (既定は cache/sdf) に
+//           ファイルのハッシュをキーに保存し、次回は読み込むだけにする (S はモデルの座標での格子の間隔)
+//           --collider-velocity を指定すると、焼き直さずに World の平行移動だけを毎ステップ変えて動かす
+// --boundary particles は WCSPH の壁と障害物をペナルティの代わりに表面に並べた境界粒子で押し返す
+// --ranks を指定した場合は領域分割した1つの rank として動き、同じ --socket の他の rank のプロセスと Unix ドメインソケットで通信する
+namespace HeadlessInternal
+{
+	struct Options
+	{
+		uint32_t ParticleCount = 20000;
+		uint32_t StepCount = 200;
+		uint32_t ThreadCount = 0;
+		uint32_t Seed = 1;
+		GridBuildMode GridMode = GridBuildMode::LinkedList;
+		bool GridModeSpecified = false;
+		uint32_t ReorderInterval = 0;
+		bool UseSoAKernels = false;
+		SIMDLevel SIMD = SIMDLevel::Scalar;
+		float NeighborListSkin = 0.0f;
+		bool AdaptiveTimestep = false;
+		PressureSolverMode Solver = PressureSolverMode::WCSPH;
+		bool DamBreak = false;
+		uint32_t PBFIterations = PBFParam().Iterations;
+		bool SymmetricForce = false;
+		bool CompactStorage = false;
+		WorkSchedule Schedule = WorkSchedule::Dynamic;
+		bool NumaPlacement = false;
+		bool Deterministic = false;
+		std::string RestartPath;
+		std::string CheckpointPath;
+		uint32_t CheckpointInterval = 0;
+		std::string TrajectoryPath;
+		std::string ExportPath;
+		ExportParam Export;
+		uint32_t ExportInterval = 1;
+		std::string SurfacePath;
+		uint32_t SurfaceInterval = 0;
+		float SurfaceCellScale = SurfaceParam().CellScale;
+		bool SurfaceAnisotropic = false;
+		std::string ColliderPath;
+		std::string ColliderCacheDirectory = "cache/sdf";
+		float ColliderCellSize = SDFBakeParam().CellSize;
+		Vector3D ColliderPosition = Vector3D(0.0f, 0.0f, 0.0f);
+		float ColliderScale = 1.0f;
+		Vector3D ColliderVelocity = Vector3D(0.0f, 0.0f, 0.0f);
+		BoundaryMode Boundary = BoundaryMode::Penalty;
+		uint32_t RankCount = 1;
+		uint32_t Rank = 0;
+		std::string SocketPath = "/tmp/FluidHeadless";
+		DecompositionMode Decomposition = DecompositionMode::Brick;
+		bool ShowHelp = false;
+	};
+
+	void PrintUsage(FILE* pFile)
+	{
+		std::fprintf(pFile,
+			"usage: FluidHeadless [--particles N] [--steps N] [--threads N] [--seed N] [--grid linked|sorted|hash] [--reorder N]\n"
+			"       [--simd off|scalar|avx2|avx512] [--skin S] [--timestep fixed|adaptive] [--solver wcsph|dfsph|pbf] [--scene default|dambreak]\n"
+			"       [--pbf-iterations N] [--force full|symmetric] [--storage float|compact] [--schedule static|dynamic|morton]\n"
+			"       [--placement default|numa] [--deterministic on|off] [--boundary penalty|particles]\n"
+			"       [--restart PATH] [--checkpoint PATH [--checkpoint-interval N]] [--trajectory PATH]\n"
+			"       [--export PREFIX [--export-format vtk|ply|csv] [--export-attributes density,pressure,velocity|none]\n"
+			"                        [--export-interval N] [--export-buffers N] [--export-policy skip|replace]]\n"
+			"       [--surface PREFIX [--surface-interval N] [--surface-cell S] [--surface-kernel isotropic|anisotropic]]\n"
+			"       [--collider PATH.obj [--collider-cell S] [--collider-position X,Y,Z] [--collider-scale S] [--collider-velocity X,Y,Z] [--collider-cache DIR]]\n"
+			"       [--ranks N --rank R [--socket PATH] [--decomposition slab|brick]]\n");
+	}
+
+	// valueStr を names の中から探して value に入れる (見つからない場合はエラーを出力して false)
+	template<typename T>
+	bool ParseEnum(const std::string& arg, const std::string& valueStr, std::initializer_list<std::pair<const char*, T>> names, T& value)
+	{
+		for (const auto& name : names)
+		{
+			if (valueStr == name.first)
+			{
+				value = name.second;
+				return true;
+			}
+		}
+		std::fprintf(stderr, "unknown value %s for %s (expected", valueStr.c_str(), arg.c_str());
+		for (const auto& name : names)
+		{
+			std::fprintf(stderr, " %s", name.first);
+		}
+		std::fprintf(stderr, ")\n");
+		return false;
+	}
+
+	// "x,y,z" を読む
+	Vector3D ParseVector3(const std::string& valueStr)
+	{
+		Vector3D value(0.0f, 0.0f, 0.0f);
+		std::sscanf(valueStr.c_str(), "%f,%f,%f", &value.x, &value.y, &value.z);
+		return value;
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "--help" || arg == "-h")
+			{
+				options.ShowHelp = true;
+				return true;
+			}
+			if (i + 1 >= argc)
+			{
+				std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+				return false;
+			}
+			std::string valueStr = argv[++i];
+			if (arg == "--grid")
+			{
+				if (!ParseEnum(arg, valueStr, { { "linked", GridBuildMode::LinkedList }, { "sorted", GridBuildMode::CountingSort }, { "hash", GridBuildMode::SpatialHash } }, options.GridMode))
+				{
+					return false;
+				}
+				options.GridModeSpecified = true;
+				continue;
+			}
+			if (arg == "--simd")
+			{
+				if (!ParseEnum(arg, valueStr, { { "off", SIMDLevel::Scalar }, { "scalar", SIMDLevel::Scalar }, { "avx2", SIMDLevel::AVX2 }, { "avx512", SIMDLevel::AVX512 } }, options.SIMD))
+				{
+					return false;
+				}
+				options.UseSoAKernels = (valueStr != "off");
+				continue;
+			}
+			if (arg == "--timestep")
+			{
+				if (!ParseEnum(arg, valueStr, { { "fixed", false }, { "adaptive", true } }, options.AdaptiveTimestep))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--solver")
+			{
+				if (!ParseEnum(arg, valueStr, { { "wcsph", PressureSolverMode::WCSPH }, { "dfsph", PressureSolverMode::DFSPH }, { "pbf", PressureSolverMode::PBF } }, options.Solver))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--boundary")
+			{
+				if (!ParseEnum(arg, valueStr, { { "penalty", BoundaryMode::Penalty }, { "particles", BoundaryMode::Particles } }, options.Boundary))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--force")
+			{
+				if (!ParseEnum(arg, valueStr, { { "full", false }, { "symmetric", true } }, options.SymmetricForce))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--storage")
+			{
+				if (!ParseEnum(arg, valueStr, { { "float", false }, { "compact", true } }, options.CompactStorage))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--schedule")
+			{
+				if (!ParseEnum(arg, valueStr, { { "static", WorkSchedule::Static }, { "dynamic", WorkSchedule::Dynamic }, { "morton", WorkSchedule::MortonPartition } }, options.Schedule))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--deterministic")
+			{
+				if (!ParseEnum(arg, valueStr, { { "off", false }, { "on", true } }, options.Deterministic))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--placement")
+			{
+				if (!ParseEnum(arg, valueStr, { { "default", false }, { "numa", true } }, options.NumaPlacement))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--socket")
+			{
+				options.SocketPath = valueStr;
+				continue;
+			}
+			if (arg == "--decomposition")
+			{
+				if (!ParseEnum(arg, valueStr, { { "slab", DecompositionMode::Slab }, { "brick", DecompositionMode::Brick } }, options.Decomposition))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--restart")
+			{
+				options.RestartPath = valueStr;
+				continue;
+			}
+			if (arg == "--checkpoint")
+			{
+				options.CheckpointPath = valueStr;
+				continue;
+			}
+			if (arg == "--trajectory")
+			{
+				options.TrajectoryPath = valueStr;
+				continue;
+			}
+			if (arg == "--export")
+			{
+				options.ExportPath = valueStr;
+				continue;
+			}
+			if (arg == "--export-format")
+			{
+				if (!ParseEnum(arg, valueStr, { { "vtk", ExportFormat::VTK }, { "ply", ExportFormat::PLY }, { "csv", ExportFormat::CSV } }, options.Export.Format))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--export-attributes")
+			{
+				options.Export.Density = valueStr.find("density") != std::string::npos;
+				options.Export.Pressure = valueStr.find("pressure") != std::string::npos;
+				options.Export.Velocity = valueStr.find("velocity") != std::string::npos;
+				continue;
+			}
+			if (arg == "--export-policy")
+			{
+				if (!ParseEnum(arg, valueStr, { { "skip", ExportDropPolicy::SkipNewest }, { "replace", ExportDropPolicy::ReplaceOldest } }, options.Export.DropPolicy))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--surface")
+			{
+				options.SurfacePath = valueStr;
+				continue;
+			}
+			if (arg == "--surface-cell")
+			{
+				options.SurfaceCellScale = std::strtof(valueStr.c_str(), nullptr);
+				continue;
+			}
+			if (arg == "--surface-kernel")
+			{
+				if (!ParseEnum(arg, valueStr, { { "isotropic", false }, { "anisotropic", true } }, options.SurfaceAnisotropic))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--collider")
+			{
+				options.ColliderPath = valueStr;
+				continue;
+			}
+			if (arg == "--collider-cache")
+			{
+				options.ColliderCacheDirectory = valueStr;
+				continue;
+			}
+			if (arg == "--collider-cell")
+			{
+				options.ColliderCellSize = std::strtof(valueStr.c_str(), nullptr);
+				continue;
+			}
+			if (arg == "--collider-position")
+			{
+				options.ColliderPosition = ParseVector3(valueStr);
+				continue;
+			}
+			if (arg == "--collider-scale")
+			{
+				options.ColliderScale = std::strtof(valueStr.c_str(), nullptr);
+				continue;
+			}
+			if (arg == "--collider-velocity")
+			{
+				options.ColliderVelocity = ParseVector3(valueStr);
+				continue;
+			}
+			if (arg == "--scene")
+			{
+				if (!ParseEnum(arg, valueStr, { { "default", false }, { "dambreak", true } }, options.DamBreak))
+				{
+					return false;
+				}
+				continue;
+			}
+			if (arg == "--skin")
+			{
+				options.NeighborListSkin = std::strtof(valueStr.c_str(), nullptr);
+				continue;
+			}
+			uint32_t value = static_cast<uint32_t>(std::strtoul(valueStr.c_str(), nullptr, 10));
+			if (arg == "--particles") options.ParticleCount = value;
+			else if (arg == "--steps") options.StepCount = value;
+			else if (arg == "--threads") options.ThreadCount = value;
+			else if (arg == "--seed") options.Seed = value;
+			else if (arg == "--reorder") options.ReorderInterval = value;
+			else if (arg == "--pbf-iterations") options.PBFIterations = value;
+			else if (arg == "--checkpoint-interval") options.CheckpointInterval = value;
+			else if (arg == "--export-interval") options.ExportInterval = std::max(1u, value);
+			else if (arg == "--export-buffers") options.Export.BufferCount = std::max(1u, value);
+			else if (arg == "--surface-interval") options.SurfaceInterval = value;
+			else if (arg == "--ranks") options.RankCount = std::max(1u, value);
+			else if (arg == "--rank") options.Rank = value;
+			else
+			{
+				std::fprintf(stderr, "unknown option %s (see --help)\n", arg.c_str());
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// --grid を指定した場合はそのグリッドにし、指定していない場合は設定に合わなければカウンティングソートにします
+	/// 指定したグリッドと組み合わせられない設定はエラーにする
+	/// </summary>
+	bool ApplyGridBuildMode(const Options& options, CPUFluidSolver& solver)
+	{
+		if (options.GridModeSpecified)
+		{
+			solver.SetGridBuildMode(options.GridMode);
+		}
+		else if (!solver.IsGridBuildModeCompatible())
+		{
+			solver.SetGridBuildMode(GridBuildMode::CountingSort);
+		}
+		const char* conflict = solver.GetGridBuildModeConflict();
+		if (conflict != nullptr)
+		{
+			std::fprintf(stderr, "%s\n", conflict);
+			std::fprintf(stderr, "--simd, --force symmetric, --schedule morton and --placement numa need --grid sorted, and --deterministic on needs --grid sorted or hash without --force symmetric\n");
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 領域分割した1つの rank として実行し、rank 0 が全rankの最大の処理時間を出力します (WCSPH・固定時間刻みのみ)
+	/// </summary>
+	int RunDistributed(const Options& options)
+	{
+		SocketHaloTransport transport(options.Rank, options.RankCount, options.SocketPath);
+		if (!transport.IsConnected())
+		{
+			std::fprintf(stderr, "rank %u: failed to connect %u ranks at %s\n", options.Rank, options.RankCount, options.SocketPath.c_str());
+			return 1;
+		}
+
+		DistributedFluidSolver solver(transport, options.ThreadCount);
+		CPUFluidSolver& localSolver = solver.GetLocalSolver();
+		localSolver.SetSoAKernelsEnabled(options.UseSoAKernels);
+		localSolver.SetSymmetricForceEnabled(options.SymmetricForce);
+		localSolver.SetCompactStorageEnabled(options.CompactStorage);
+		localSolver.SetSIMDLevel(options.SIMD);
+		if (!ApplyGridBuildMode(options, localSolver))
+		{
+			return 1;
+		}
+		if (options.DamBreak)
+		{
+			SimulationParam param = FluidScenario::MakeDamBreakParam(options.ParticleCount);
+			solver.SetSimulationParam(param, options.Decomposition);
+			solver.SetParticles(FluidScenario::MakeDamBreakParticles(param, options.ParticleCount));
+		}
+		else
+		{
+			// 全rankが同じシードで全体の粒子を作り、自分の部分領域の分だけを持つ
+			CPUFluidSolver generator(1);
+			generator.SetSimulationParam(FluidScenario::MakeDefaultParam());
+			generator.InitializeParticles(options.ParticleCount, options.Seed);
+			std::vector<Particle> particles;
+			generator.CopyParticlesInIdOrder(particles);
+			solver.SetSimulationParam(FluidScenario::MakeDefaultParam(), options.Decomposition);
+			solver.SetParticles(particles);
+		}
+
+		DistributedTimings total;
+		for (uint32_t step = 0; step < options.StepCount; ++step)
+		{
+			if (!solver.Step())
+			{
+				std::fprintf(stderr, "rank %u: exchange failed at step %u\n", options.Rank, step);
+				return 1;
+			}
+			const DistributedTimings& timings = solver.GetTimings();
+			total.Pack += timings.Pack;
+			total.Exchange += timings.Exchange;
+			total.Unpack += timings.Unpack;
+			total.Solve += timings.Solve;
+			total.GhostCount += timings.GhostCount;
+			total.MigratedCount += timings.MigratedCount;
+		}
+
+		double steps = std::max(1u, options.StepCount);
+		std::vector<double> owned, pack, exchange, unpack, solve, ghosts;
+		if (!solver.AllGather(static_cast<double>(solver.GetOwnedParticles().size()), owned) ||
+			!solver.AllGather(total.Pack / steps, pack) ||
+			!solver.AllGather(total.Exchange / steps, exchange) ||
+			!solver.AllGather(total.Unpack / steps, unpack) ||
+			!solver.AllGather(total.Solve / steps, solve) ||
+			!solver.AllGather(total.GhostCount / steps, ghosts))
+		{
+			return 1;
+		}
+		if (options.Rank != 0)
+		{
+			return 0;
+		}
+		const SPHCommon::GridPos& dims = solver.GetDecomposition().GetDims();
+		std::printf("ranks=%u (%d x %d x %d) steps=%u threads/rank=%u\n",
+			options.RankCount, dims.x, dims.y, dims.z, options.StepCount, localSolver.GetThreadCount());
+		std::printf("%-5s %10s %10s %10s %12s %10s %10s\n", "rank", "particles", "ghosts", "pack ms", "exchange ms", "unpack ms", "solve ms");
+		for (uint32_t rank = 0; rank < options.RankCount; ++rank)
+		{
+			std::printf("%-5u %10.0f %10.0f %10.3f %12.3f %10.3f %10.3f\n",
+				rank, owned[rank], ghosts[rank], pack[rank], exchange[rank], unpack[rank], solve[rank]);
+		}
+		std::printf("simulated %.4f s\n", solver.GetSimulatedTime());
+		return 0;
+	}
+}
+using namespace HeadlessInternal;
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+	if (options.ShowHelp)
+	{
+		PrintUsage(stdout);
+		return 0;
+	}
+	if (options.RankCount > 1)
+	{
+		return RunDistributed(options);
+	}
+
+	CPUFluidSolver solver(options.ThreadCount);
+	solver.SetReorderInterval(options.ReorderInterval);
+	solver.SetSoAKernelsEnabled(options.UseSoAKernels);
+	solver.SetSymmetricForceEnabled(options.SymmetricForce);
+	solver.SetCompactStorageEnabled(options.CompactStorage);
+	solver.SetWorkSchedule(options.Schedule);
+	solver.SetNumaPlacementEnabled(options.NumaPlacement);
+	solver.SetDeterministicEnabled(options.Deterministic);
+	solver.SetSIMDLevel(options.SIMD);
+	solver.SetNeighborListSkin(options.NeighborListSkin);
+	solver.SetAdaptiveTimestepEnabled(options.AdaptiveTimestep);
+	solver.SetPressureSolver(options.Solver);
+	solver.SetBoundaryMode(options.Boundary);
+	if (!ApplyGridBuildMode(options, solver))
+	{
+		return 1;
+	}
+	PBFParam pbfParam;
+	pbfParam.Iterations = options.PBFIterations;
+	solver.SetPBFParam(pbfParam);
+	if (!options.RestartPath.empty())
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		CheckpointFile checkpoint;
+		if (!checkpoint.Open(options.RestartPath))
+		{
+			std::fprintf(stderr, "failed to open checkpoint %s (missing, truncated, wrong format or invalid particle IDs)\n", options.RestartPath.c_str());
+			return 1;
+		}
+		solver.RestoreCheckpoint(checkpoint);
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		std::printf("restarted from %s at %.4f s (%.3f ms)\n", options.RestartPath.c_str(), solver.GetSimulatedTime(), milliseconds);
+	}
+	else if (options.DamBreak)
+	{
+		SimulationParam param = FluidScenario::MakeDamBreakParam(options.ParticleCount);
+		solver.SetSimulationParam(param);
+		solver.SetParticles(FluidScenario::MakeDamBreakParticles(param, options.ParticleCount));
+	}
+	else
+	{
+		solver.SetSimulationParam(FluidScenario::MakeDefaultParam());
+		solver.InitializeParticles(options.ParticleCount, options.Seed);
+	}
+
+	std::printf("particles=%u steps=%u threads=%u kernels=%s\n",
+		solver.GetParticleCount(), options.StepCount, solver.GetThreadCount(),
+		solver.GetSoAKernelsEnabled() ? ToString(solver.GetSIMDLevel()) : "AoS");
+
+	CPUSolverTimings total;
+	float minDeltaTime = 0.0f;
+	float maxDeltaTime = 0.0f;
+	double imbalance = 0.0;
+	double particleImbalance = 0.0;
+	CheckpointWriter checkpointWriter;
+	TrajectoryWriter trajectoryWriter(options.ThreadCount);
+	std::vector<Particle> trajectoryParticles;
+	if (!options.TrajectoryPath.empty() &&
+		!trajectoryWriter.Open(options.TrajectoryPath, solver.GetSimulationParam().WallMin, solver.GetSimulationParam().WallMax))
+	{
+		std::fprintf(stderr, "failed to open trajectory %s\n", options.TrajectoryPath.c_str());
+		return 1;
+	}
+	ParticleExporter exporter;
+	if (!options.ExportPath.empty() && !exporter.Open(options.ExportPath, options.Export))
+	{
+		std::fprintf(stderr, "failed to create export directory for %s\n", options.ExportPath.c_str());
+		return 1;
+	}
+	SurfaceExtractor surfaceExtractor(options.ThreadCount);
+	SurfaceMesh surfaceMesh;
+	std::vector<Particle> surfaceParticles;
+	SurfaceStats surfaceTotal;
+	uint32_t surfaceFrameCount = 0;
+	uint32_t surfaceFailedCount = 0;
+	if (!options.SurfacePath.empty())
+	{
+		SurfaceParam surfaceParam;
+		surfaceParam.CellScale = options.SurfaceCellScale;
+		surfaceParam.Anisotropic = options.SurfaceAnisotropic;
+		surfaceExtractor.SetParam(surfaceParam);
+		std::error_code error;
+		std::filesystem::path directory = std::filesystem::path(options.SurfacePath).parent_path();
+		if (!directory.empty() && !std::filesystem::exists(directory, error) && !std::filesystem::create_directories(directory, error))
+		{
+			std::fprintf(stderr, "failed to create surface directory for %s\n", options.SurfacePath.c_str());
+			return 1;
+		}
+	}
+	SignedDistanceField colliderField;
+	Matrix4x4 colliderWorld = Matrix4x4::ScalingToMatrix(Vector3D(options.ColliderScale, options.ColliderScale, options.ColliderScale));
+	if (!options.ColliderPath.empty())
+	{
+		TriangleMesh mesh;
+		if (!mesh.LoadOBJ(options.ColliderPath))
+		{
+			std::fprintf(stderr, "failed to load collider %s\n", options.ColliderPath.c_str());
+			return 1;
+		}
+		SDFBakeParam bakeParam;
+		bakeParam.CellSize = options.ColliderCellSize;
+		ThreadPool bakeThreadPool(options.ThreadCount);
+		if (!colliderField.BakeCached(options.ColliderPath, options.ColliderCacheDirectory, mesh.Positions, mesh.Indices, bakeParam, bakeThreadPool))
+		{
+			std::fprintf(stderr, "failed to bake collider %s\n", options.ColliderPath.c_str());
+			return 1;
+		}
+		const SDFBakeStats& stats = colliderField.GetStats();
+		const uint32_t* dim = colliderField.GetDim();
+		std::printf("collider %s: %u triangles, %u x %u x %u samples (%llu in band), %s %.2f ms (distance %.2f ms, sign %.2f ms)\n",
+			options.ColliderPath.c_str(), stats.TriangleCount, dim[0], dim[1], dim[2], static_cast<unsigned long long>(stats.BandSampleCount),
+			stats.FromCache ? "loaded from cache in" : "baked in", stats.TotalMilliseconds, stats.DistanceMilliseconds, stats.SignMilliseconds);
+		colliderWorld.setTranslation(options.ColliderPosition);
+		solver.SetColliders({ SDFCollider(&colliderField, colliderWorld) });
+	}
+	const bool movingCollider = !options.ColliderPath.empty() && options.ColliderVelocity.dot(options.ColliderVelocity) > 0.0f;
+	// --restart ではチェックポイントの時刻から始まる (障害物の移動と平均の dt はこの実行で進めた時間で求める)
+	const double startTime = solver.GetSimulatedTime();
+	uint32_t checkpointCount = 0;
+	uint32_t skippedCheckpointCount = 0;
+	double checkpointCaptureMilliseconds = 0.0;
+	for (uint32_t step = 0; step < options.StepCount; ++step)
+	{
+		if (movingCollider)
+		{
+			colliderWorld.setTranslation(options.ColliderPosition + options.ColliderVelocity * static_cast<float>(solver.GetSimulatedTime() - startTime));
+			solver.SetColliders({ SDFCollider(&colliderField, colliderWorld) });
+		}
+		solver.Step();
+		if (trajectoryWriter.IsOpen())
+		{
+			solver.CopyParticlesInIdOrder(trajectoryParticles);
+			trajectoryWriter.WriteFrame(trajectoryParticles, solver.GetSimulatedTime());
+		}
+		if (exporter.IsOpen() && (step + 1) % options.ExportInterval == 0)
+		{
+			exporter.Submit(solver, step + 1);
+		}
+		// 前の書き込みが終わっていなければ、ステップを止めずにその回は飛ばす
+		bool isLastStep = (step + 1 == options.StepCount);
+		if (!options.SurfacePath.empty() && (isLastStep || (options.SurfaceInterval > 0 && (step + 1) % options.SurfaceInterval == 0)))
+		{
+			solver.CopyParticlesInIdOrder(surfaceParticles);
+			char suffix[32];
+			std::snprintf(suffix, sizeof(suffix), "_%06u.ply", step + 1);
+			if (surfaceExtractor.Extract(surfaceParticles, solver.GetSimulationParam(), surfaceMesh) &&
+				SurfaceExtractor::WritePLY(surfaceMesh, options.SurfacePath + suffix))
+			{
+				const SurfaceStats& stats = surfaceExtractor.GetStats();
+				surfaceTotal.BlockCount = stats.BlockCount;
+				surfaceTotal.VertexCount = stats.VertexCount;
+				surfaceTotal.TriangleCount = stats.TriangleCount;
+				surfaceTotal.AnisotropyMilliseconds += stats.AnisotropyMilliseconds;
+				surfaceTotal.BinMilliseconds += stats.BinMilliseconds;
+				surfaceTotal.SplatMilliseconds += stats.SplatMilliseconds;
+				surfaceTotal.MarchMilliseconds += stats.MarchMilliseconds;
+				surfaceTotal.TotalMilliseconds += stats.TotalMilliseconds;
+				++surfaceFrameCount;
+			}
+			else
+			{
+				++surfaceFailedCount;
+			}
+		}
+		if (!options.CheckpointPath.empty() && !isLastStep && options.CheckpointInterval > 0 && (step + 1) % options.CheckpointInterval == 0)
+		{
+			if (checkpointWriter.WriteAsync(solver, options.CheckpointPath))
+			{
+				++checkpointCount;
+				checkpointCaptureMilliseconds += checkpointWriter.GetCaptureMilliseconds();
+			}
+			else
+			{
+				++skippedCheckpointCount;
+			}
+		}
+		imbalance += solver.GetLoadBalanceStats().Imbalance;
+		particleImbalance += solver.GetLoadBalanceStats().ParticleImbalance;
+		float deltaTime = solver.GetTimestepStats().DeltaTime;
+		minDeltaTime = (step == 0) ? deltaTime : std::min(minDeltaTime, deltaTime);
+		maxDeltaTime = std::max(maxDeltaTime, deltaTime);
+		const auto& timings = solver.GetTimings();
+		total.GridClear += timings.GridClear;
+		total.GridBuild += timings.GridBuild;
+		total.Density += timings.Density;
+		total.Force += timings.Force;
+		total.Integrate += timings.Integrate;
+		total.Reorder += timings.Reorder;
+		total.NeighborList += timings.NeighborList;
+		total.DivergenceSolve += timings.DivergenceSolve;
+		total.PressureSolve += timings.PressureSolve;
+	}
+
+	// 最後の状態は前の書き込みを待ってから必ず書く
+	if (!options.CheckpointPath.empty())
+	{
+		bool succeeded = checkpointWriter.Wait() && checkpointWriter.WriteAsync(solver, options.CheckpointPath) && checkpointWriter.Wait();
+		if (!succeeded)
+		{
+			std::fprintf(stderr, "failed to write checkpoint %s\n", options.CheckpointPath.c_str());
+			return 1;
+		}
+		++checkpointCount;
+		checkpointCaptureMilliseconds += checkpointWriter.GetCaptureMilliseconds();
+	}
+
+	// 1ステップ当たりの平均 (ms) と 1粒子当たり (ns)
+	double steps = std::max(1u, options.StepCount);
+	double nsPerParticle = 1.0e6 / (steps * std::max(1u, solver.GetParticleCount()));
+	auto report = [&](const char* name, double ms)
+	{
+		std::printf("%-12s %9.3f ms/step %9.2f ns/particle\n", name, ms / steps, ms * nsPerParticle);
+	};
+	report("GridClear", total.GridClear);
+	report("GridBuild", total.GridBuild);
+	report("Density", total.Density);
+	report("Force", total.Force);
+	report("Integrate", total.Integrate);
+	report("Reorder", total.Reorder);
+	report("NeighborList", total.NeighborList);
+	report("Divergence", total.DivergenceSolve);
+	report("Pressure", total.PressureSolve);
+	report("Total", total.Total());
+	// 密度・力のパスのスレッド毎の負荷 (最大 / 平均)
+	std::printf("load imbalance: time %.3f particles %.3f (mean over steps)\n", imbalance / steps, particleImbalance / steps);
+	const LoadBalanceStats& loadBalance = solver.GetLoadBalanceStats();
+	for (size_t thread = 0; thread < loadBalance.ThreadMilliseconds.size() && solver.GetThreadCount() > 1; ++thread)
+	{
+		std::printf("  thread %zu: %8.3f ms %8u particles (last step)\n", thread, loadBalance.ThreadMilliseconds[thread], loadBalance.ThreadParticles[thread]);
+	}
+	if (options.NumaPlacement)
+	{
+		std::vector<float> threadFractions;
+		float localFraction = solver.MeasureLocalPageFraction(threadFractions);
+		std::printf("numa: %u node(s), particle pages on the owning thread's node: ", solver.GetNumaTopology().GetNodeCount());
+		if (localFraction < 0.0f)
+		{
+			std::printf("n/a\n");
+		}
+		else
+		{
+			std::printf("%.1f%%\n", localFraction * 100.0f);
+		}
+	}
+	if (options.NeighborListSkin > 0.0f)
+	{
+		std::printf("neighbor list rebuilds: %u / %u steps\n", solver.GetNeighborListBuildCount(), options.StepCount);
+	}
+	if (options.Solver == PressureSolverMode::DFSPH)
+	{
+		const DFSPHStats& stats = solver.GetDFSPHStats();
+		std::printf("DFSPH last step: %u density iterations (error %.4f%%), %u divergence iterations\n",
+			stats.DensityIterations, stats.DensityError * 100.0f, stats.DivergenceIterations);
+	}
+	if (options.Solver == PressureSolverMode::PBF)
+	{
+		const PBFStats& stats = solver.GetPBFStats();
+		std::printf("PBF last step: %u iterations (error %.4f%%)\n", stats.Iterations, stats.DensityError * 100.0f);
+	}
+	std::printf("simulated %.4f s, dt min %.5f max %.5f mean %.5f\n",
+		solver.GetSimulatedTime(), minDeltaTime, maxDeltaTime, (solver.GetSimulatedTime() - startTime) / steps);
+	if (options.Boundary == BoundaryMode::Particles && options.Solver == PressureSolverMode::WCSPH)
+	{
+		const BoundaryParticleStats& stats = solver.GetBoundaryParticles().GetStats();
+		std::printf("boundary particles: %u wall + %u collider, spacing %.4f, psi %.4f .. %.4f (fluid mass %.4f), built in %.2f ms\n",
+			stats.WallParticleCount, stats.ColliderParticleCount, stats.Spacing, stats.MinPsi, stats.MaxPsi,
+			solver.GetSimulationParam().Mass, stats.BuildMilliseconds);
+	}
+	if (!options.CheckpointPath.empty())
+	{
+		std::printf("checkpoint %s: %u written, %u skipped (busy), capture %.3f ms mean, last write %.3f ms\n",
+			options.CheckpointPath.c_str(), checkpointCount, skippedCheckpointCount,
+			checkpointCaptureMilliseconds / checkpointCount, checkpointWriter.GetWriteMilliseconds());
+	}
+	if (exporter.IsOpen())
+	{
+		// 書き込み待ちのフレームを書き終えてから集計する
+		exporter.Close();
+		const ExportStats stats = exporter.GetStats();
+		std::printf("export %s: %u / %u frames written, %u dropped, %u failed, %.2f MB, capture %.3f ms mean, write %.3f ms mean (%.0f MB/s)\n",
+			options.ExportPath.c_str(), stats.WrittenFrames, stats.SubmittedFrames, stats.DroppedFrames, stats.FailedFrames,
+			stats.WrittenBytes / (1024.0 * 1024.0), stats.CaptureMilliseconds / std::max(1u, stats.CapturedFrames),
+			stats.WriteMilliseconds / std::max(1u, stats.WrittenFrames + stats.FailedFrames),
+			stats.WrittenBytes / (1024.0 * 1024.0) * 1000.0 / std::max(stats.WriteMilliseconds, 1.0e-3));
+	}
+	if (!options.SurfacePath.empty())
+	{
+		const double frames = std::max(1u, surfaceFrameCount);
+		std::printf("surface %s: %u frames written, %u failed, last %u blocks / %u vertices / %u triangles, "
+			"anisotropy %.2f ms, bin %.2f ms, splat %.2f ms, march %.2f ms, total %.2f ms mean\n",
+			options.SurfacePath.c_str(), surfaceFrameCount, surfaceFailedCount, surfaceTotal.BlockCount, surfaceTotal.VertexCount,
+			surfaceTotal.TriangleCount, surfaceTotal.AnisotropyMilliseconds / frames, surfaceTotal.BinMilliseconds / frames, surfaceTotal.SplatMilliseconds / frames,
+			surfaceTotal.MarchMilliseconds / frames, surfaceTotal.TotalMilliseconds / frames);
+	}
+	if (!options.ColliderPath.empty())
+	{
+		// 表面から H の1%より深く残っている粒子 (ペナルティの押し出しでは少しめり込む。射影では丸め誤差程度)
+		const float tolerance = 0.01f * solver.GetSimulationParam().H;
+		uint32_t insideCount = 0;
+		float deepest = 0.0f;
+		const SDFCollider& collider = solver.GetColliders()[0];
+		for (const Particle& p : solver.GetParticles())
+		{
+			float distance;
+			Vector3D normal;
+			collider.Query(p.Position, distance, normal);
+			insideCount += (distance < -tolerance) ? 1 : 0;
+			deepest = std::min(deepest, distance);
+		}
+		std::printf("collider: %u particles deeper than 0.01 H at the end, deepest %.4f (H = %.3f)\n", insideCount, 0.0f - deepest, solver.GetSimulationParam().H);
+	}
+	if (trajectoryWriter.IsOpen())
+	{
+		trajectoryWriter.Close();
+		const TrajectoryStats& stats = trajectoryWriter.GetStats();
+		std::printf("trajectory %s: %u frames (%u keyframes), %.2f MB, %.1fx smaller than raw particles, encode %.0f MB/s\n",
+			options.TrajectoryPath.c_str(), stats.FrameCount, stats.KeyframeCount, stats.EncodedBytes / (1024.0 * 1024.0),
+			stats.CompressionRatio(), stats.RawBytes / (1024.0 * 1024.0) * 1000.0 / std::max(stats.EncodeMilliseconds, 1.0e-3));
+	}
+	// 決定的モードではスレッド数を変えても同じ値になる
+	std::printf("state hash %016llx%s\n", static_cast<unsigned long long>(solver.ComputeStateHash()),
+		options.Deterministic ? " (deterministic)" : "");
+	return 0;
+}
@@ -10,12 +10,12 @@
 // Constant Values.
 //-----------------------------------------------------------------------------
 #ifndef F_PI
-#define F_PI        3.14159265358979323f   // ~.
+#define F_PI        3.14159265358979323f   // 円周率.
 #endif//F_PI
 
 
 //-----------------------------------------------------------------------------
-//      Schlickɂtl̋ߎ.
+//      Schlickによるフレネル項の近似式.
 //-----------------------------------------------------------------------------
 float3 SchlickFresnel(float3 specular, float VH)
 {
@@ -23,13 +23,13 @@ float3 SchlickFresnel(float3 specular, float VH)
 }
 
 //-----------------------------------------------------------------------------
-//      GGXɂ@z֐.
+//      GGXによる法線分布関数.
 //-----------------------------------------------------------------------------
 float D_GGX(float a, float NH)
 {
     // Eric Heiz, "Understanding the Masking-Shadowing Function in Microfacet-Based BRDFs",
     // Journal of Computer Graphics Techiniques Vol.3, No.2, 2014.
-    // (71) Q.
+    // 式(71) 参照.
     float a2 = a * a;
     float NH2 = NH * NH;
     float f = (NH2 * ((a2 - 1) * NH + 1));
@@ -37,7 +37,7 @@ float D_GGX(float a, float NH)
 }
 
 //-----------------------------------------------------------------------------
-//      Height Correlated Smithɂ􉽌.
+//      Height Correlated Smithによる幾何減衰項.
 //-----------------------------------------------------------------------------
 float G2_Smith(float NL, float NV, float a)
 {
@@ -53,7 +53,7 @@ float G2_Smith(float NL, float NV, float a)
 }
 
 //-----------------------------------------------------------------------------
-//      Lambert BRDFvZ܂.
+//      Lambert BRDFを計算します.
 //-----------------------------------------------------------------------------
 float3 ComputeLambert(float3 Kd)
 {
@@ -61,7 +61,7 @@ float3 ComputeLambert(float3 Kd)
 }
 
 //-----------------------------------------------------------------------------
-//      Phong BRDFvZ܂.
+//      Phong BRDFを計算します.
 //-----------------------------------------------------------------------------
 float3 ComputePhong
 (
@@ -74,7 +74,7 @@ float3 ComputePhong
 }
 
 //-----------------------------------------------------------------------------
-//      GGX BRDFvZ܂.
+//      GGX BRDFを計算します.
 //-----------------------------------------------------------------------------
 float3 ComputeGGX
 (
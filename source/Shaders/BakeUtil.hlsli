@@ -5,17 +5,17 @@ static const uint SampleCount = 256;
 #endif//ENABLE_MIPMAP_FILTERING
 
 #ifndef F_PI
-#define F_PI        3.14159265358979323f   // ~.
+#define F_PI        3.14159265358979323f   // 円周率.
 #endif//F_PI
 
-// Hammersley_QTv܂
+// Hammersley点群をサンプルします
 float2 Hammersley(uint i , uint N)
 {
     float ri = reversebits(i) * 2.3283064365386963e-10f;
     return float2(float(i) / float(N), ri);
 }
 
-// L[u}bṽtFb`߂܂
+// キューブマップのフェッチ方向を求めます
 float3 CalcDirection(float2 uv, const int faceIndex)
 {
     float3 dir = 0;
@@ -24,25 +24,25 @@ float3 CalcDirection(float2 uv, const int faceIndex)
     switch (faceIndex)
     {
 case 0: // +X Face (Right)
-            // n: EʂZ̑O(+Z)(-Z)U
+            // 左手系: 右面はZ軸の前方向(+Z)から後ろ方向(-Z)へUが走る
             dir = float3(1.0f, pos.y, -pos.x);
             break;
         case 1: // -X Face (Left)
-            // n: ʂŽ(-Z)O(+Z)U
+            // 左手系: 左面はZ軸の後ろ方向(-Z)から前方向(+Z)へUが走る
             dir = float3(-1.0f, pos.y, pos.x);
             break;
         case 2: // +Y Face (Up)
-            dir = float3(pos.x, 1.0f, pos.y); // Z+Forward
+            dir = float3(pos.x, 1.0f, pos.y); // Z+がForward
             break;
         case 3: // -Y Face (Down)
             dir = float3(pos.x, -1.0f, -pos.y);
             break;
         case 4: // +Z Face (Front/Forward)
-            // n: (+Z)
+            // 左手系: 正面(+Z)
             dir = float3(pos.x, pos.y, 1.0f);
             break;
         case 5: // -Z Face (Back/Backward)
-            // n: w(-Z)
+            // 左手系: 背面(-Z)
             dir = float3(-pos.x, pos.y, -1.0f);
             break;
     };
@@ -51,14 +51,14 @@ case 0: // +X Face (Right)
 };
 
 //-----------------------------------------------------------------------------
-//      K߂܂.
+//      正規直交基底を求めます.
 //-----------------------------------------------------------------------------
 void TangentSpace(float3 N, out float3 T, out float3 B)
 {
     // Tom Duff, James Burgess, Per Christensen, Christophe Hery, Andrew Kensler, Max Liani, and Ryusuke Villemin
     // "Building an Orthonormal Bais, Revisited",
     // Journal of Computer Graphics Techniques Vol.6, No.1, 2017.
-    // Listing 3.Q.
+    // Listing 3.参照.
     float s = (N.z >= 0.0f) ? 1.0f : -1.0f;
     float a = -1.0f / (s + N.z);
     float b = N.x * N.y * a;
@@ -67,7 +67,7 @@ void TangentSpace(float3 N, out float3 T, out float3 B)
 }
 
 //-----------------------------------------------------------------------------
-//      Lambert BRDF̌`ɊÂTvOs܂.
+//      Lambert BRDFの形状に基づくサンプリングを行います.
 //-----------------------------------------------------------------------------
 float3 SampleLambert(float2 u, float3 N)
 {
@@ -86,7 +86,7 @@ float3 SampleLambert(float2 u, float3 N)
 }
 
 //-----------------------------------------------------------------------------
-//      GGX BRDF̌`ɂƂÂTvOs܂.
+//      GGX BRDFの形状にもとづくサンプリングを行います.
 //-----------------------------------------------------------------------------
 float3 SampleGGX(float2 u, float a, float3 N)
 {
@@ -0,0 +1,106 @@
+#ifndef BOUNDARY_PARTICLES_HLSLI
+#define BOUNDARY_PARTICLES_HLSLI
+
+#include "SPHCommon.hlsli"
+
+// 壁と障害物の表面の境界粒子 (FluidStage.h の BoundaryParticleGPU と同じ並び)
+// CPU側の BoundaryParticles と同じく、流体のグリッドと同じセルの順に並べてある
+struct BoundaryParticle
+{
+    float3 Position;
+    float Psi; // 質量の代わりに使う ρ0 / Σ W (並びの疎密を補正した量)
+};
+
+StructuredBuffer<BoundaryParticle> BoundaryParticles : register(t2);
+// セル c の粒子は [BoundaryCellStart[c], BoundaryCellStart[c + 1])
+StructuredBuffer<uint> BoundaryCellStart : register(t3);
+
+cbuffer BoundaryParam : register(b2)
+{
+    uint BoundaryParticleCount; // 0 なら境界粒子を使わない (壁と障害物はペナルティで押し返す)
+}
+
+// 周囲27セルの境界粒子の Σ Ψ W を密度と近傍密度に加える
+void AddBoundaryDensity(float3 position, int3 gridPos, int3 gridDim, float h, inout float density, inout float nearDensity)
+{
+    int minX = max(gridPos.x - 1, 0);
+    int maxX = min(gridPos.x + 1, gridDim.x - 1);
+    for (int z = max(gridPos.z - 1, 0); z <= min(gridPos.z + 1, gridDim.z - 1); ++z)
+    {
+        for (int y = max(gridPos.y - 1, 0); y <= min(gridPos.y + 1, gridDim.y - 1); ++y)
+        {
+            // x方向の3セルは連続した範囲になる
+            int rowIndex = (z * gridDim.y + y) * gridDim.x;
+            uint end = BoundaryCellStart[rowIndex + maxX + 1];
+            for (uint index = BoundaryCellStart[rowIndex + minX]; index < end; ++index)
+            {
+                BoundaryParticle boundary = BoundaryParticles[index];
+                float r = length(position - boundary.Position);
+                density += boundary.Psi * Poly6Kernel(r, h);
+                nearDensity += boundary.Psi * NearDensityKernel(r, h);
+            }
+        }
+    }
+}
+
+// 境界粒子から受ける圧力と粘性の力 (CPUFluidSolver::AddBoundaryForce と同じ)
+// 境界粒子の圧力と密度は自分と同じ、速度は0とみなす。負の圧力で壁に吸い付かないよう、押し返す向きだけにする
+float3 BoundaryForce(float3 position, float3 velocity, int3 gridPos, int3 gridDim, float h, float density, float pressure,
+    float nearDensity, float nearPressure, float viscosity)
+{
+    float3 pressureForce = float3(0, 0, 0);
+    float3 viscosityForce = float3(0, 0, 0);
+    if (density == 0.0f || nearDensity == 0.0f)
+    {
+        return pressureForce;
+    }
+    pressure = max(pressure, 0.0f);
+    float h2 = h * h;
+    int minX = max(gridPos.x - 1, 0);
+    int maxX = min(gridPos.x + 1, gridDim.x - 1);
+    for (int z = max(gridPos.z - 1, 0); z <= min(gridPos.z + 1, gridDim.z - 1); ++z)
+    {
+        for (int y = max(gridPos.y - 1, 0); y <= min(gridPos.y + 1, gridDim.y - 1); ++y)
+        {
+            int rowIndex = (z * gridDim.y + y) * gridDim.x;
+            uint end = BoundaryCellStart[rowIndex + maxX + 1];
+            for (uint index = BoundaryCellStart[rowIndex + minX]; index < end; ++index)
+            {
+                BoundaryParticle boundary = BoundaryParticles[index];
+                float3 diff = position - boundary.Position;
+                float r2 = dot(diff, diff);
+                // 影響範囲外チェック
+                if (r2 >= h2 || r2 < 0.00001f)
+                {
+                    continue;
+                }
+                float r = sqrt(r2);
+                float3 dir = diff / r;
+                pressureForce += -boundary.Psi * pressure * dir * SpikyKernelGradient(r, h) / density;
+                pressureForce += -boundary.Psi * nearPressure * dir * NearSpikyKernelGradient(r, h) / nearDensity;
+                viscosityForce += -boundary.Psi * velocity * ViscosityKernelLaplacian(r, h) / density;
+            }
+        }
+    }
+    return pressureForce + viscosityForce * viscosity;
+}
+
+// 壁の外に出た粒子を壁の上に戻し、外向きの速度を消す (境界粒子の殻をすり抜けた粒子の後始末)
+void ClampToWalls(inout float3 position, inout float3 velocity, float3 wallMin, float3 wallMax)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (position[axis] < wallMin[axis])
+        {
+            position[axis] = wallMin[axis];
+            velocity[axis] = max(velocity[axis], 0.0f);
+        }
+        else if (position[axis] > wallMax[axis])
+        {
+            position[axis] = wallMax[axis];
+            velocity[axis] = min(velocity[axis], 0.0f);
+        }
+    }
+}
+
+#endif // BOUNDARY_PARTICLES_HLSLI
@@ -5,7 +5,7 @@ struct VSOutput
     float3 ray : VECTOR;
     float4 tPos : TPOS;
     float3 WorldPos : WORLD_POS;
-    float3x3 InvTangentBasis : INV_TANGENT_BASIS; // ڐԂւ̊ϊs̋ts
+    float3x3 InvTangentBasis : INV_TANGENT_BASIS; // 接線空間への基底変換行列の逆行列
 };
 
 struct PSOutput
@@ -45,7 +45,7 @@ TextureCube DiffuseLDMap : register(t4);
 TextureCube SpecularLDMap : register(t5);
 Texture2D ShadowMap : register(t6);
 
-// XyL[̎xzIȕ߂܂
+// スペキュラーの支配的な方向を求めます
 float3 GetSpecularDomiantDir(float3 N, float3 R, float roughness)
 {
     float smoothness = saturate(1.0f - roughness);
@@ -53,41 +53,41 @@ float3 GetSpecularDomiantDir(float3 N, float3 R, float roughness)
     return lerp(N, R, lerpFactor);
 }
 
-// fBt[YIBL]܂.
+// ディフューズIBLを評価します.
 float3 EvaluateIBLDiffuse(float3 N)
 {
-    // Lambert BRDFDFG͐ϕ1.0ƂȂ̂ŁCLD݂̂ԋpΗǂ
+    // Lambert BRDFはDFG項は積分すると1.0となるので，LD項のみを返却すれば良い
     return DiffuseLDMap.Sample(DiffuseLDSmp, N).rgb;
 }
 
-// `tlX~bvx߂܂.
+// 線形ラフネスからミップレベルを求めます.
 float RoughnessToMipLevel(float linearRoughness, float mipCount)
 {
     return (mipCount - 1) * linearRoughness;
 }
 
-// XyL[IBL]܂.
+// スペキュラーIBLを評価します.
 float3 EvaluateIBLSpecular
 (
-    float NdotV, // @xNgƎxNg̓.
-    float3 N, // @xNg.
-    float3 R, // ˃xNg.
-    float3 f0, // tl
-    float roughness, // `tlX.
-    float textureSize, // eNX`TCY.
-    float mipCount // ~bvx.
+    float NdotV, // 法線ベクトルと視線ベクトルの内積.
+    float3 N, // 法線ベクトル.
+    float3 R, // 反射ベクトル.
+    float3 f0, // フレネル項
+    float roughness, // 線形ラフネス.
+    float textureSize, // テクスチャサイズ.
+    float mipCount // ミップレベル数.
 )
 {
     float a = roughness * roughness;
     float3 dominantR = GetSpecularDomiantDir(N, R, a);
 
-    // ֐č\z.
+    // 関数を再構築.
     // L * D * (f0 * Gvis * (1 - Fc) + Gvis * Fc) * cosTheta / (4 * NdotL * NdotV).
-    NdotV = max(NdotV, 0.5f / textureSize); // [ZȂ悤ɂ.
+    NdotV = max(NdotV, 0.5f / textureSize); // ゼロ除算が発生しないようにする.
     float mipLevel = RoughnessToMipLevel(roughness, mipCount);
     float3 preLD = SpecularLDMap.SampleLevel(SpecularLDSmp, dominantR, mipLevel).xyz;
     
-    // OϕDFGTv.
+    // 事前積分したDFGをサンプルする.
     // Fc = ( 1 - HdotL )^5
     // PreIntegratedDFG.r = Gvis * (1 - Fc)
     // PreIntegratedDFG.g = Gvis * Fc
@@ -19,7 +19,7 @@ struct VSOutput
     float3 ray : VECTOR;
     float4 tPos : TPOS;
     float3 WorldPos : WORLD_POS;
-    float3x3 InvTangentBasis : INV_TANGENT_BASIS; // ڐԂւ̊ϊs̋ts
+    float3x3 InvTangentBasis : INV_TANGENT_BASIS; // 接線空間への基底変換行列の逆行列
 };
 
 cbuffer Transform : register(b0)
@@ -51,7 +51,7 @@ VSOutput main(VSInput input)
     output.ray = normalize(worldPos.xyz - CameraPos);
     output.WorldPos = worldPos.xyz;
     
-    // xNg
+    // 基底ベクトル
     float3 N = normalize(mul((float3x3) World, input.Normal));
     float3 T = normalize(mul((float3x3) World, input.Tangent));
     float3 B = normalize(cross(N, T));
@@ -1,4 +1,5 @@
 #include "SPHCommon.hlsli"
+#include "BoundaryParticles.hlsli"
 
 RWStructuredBuffer<Particle> Particles : register(u0);
 RWStructuredBuffer<int> GridHead : register(u1);
@@ -29,14 +30,14 @@ void main(uint3 DTid : SV_DispatchThreadID)
     if (id >= ParticleCount)
         return;
     
-    // g̍W
+    // 自身の座標
     float3 myPosition = Particles[id].Position;
     int3 myGridPos = GetGridPos(myPosition, WallMin, H);
-    // x
+    // 初期密度
     float density = 0.0f;
     float nearDensity = 0.0f;
     float h2 = H * H;
-    // ߖTT
+    // 近傍探索
     for(int z = -1; z <= 1; ++z)
     {
         for (int y = -1; y <= 1; ++y)
@@ -54,8 +55,8 @@ void main(uint3 DTid : SV_DispatchThreadID)
                 {
                     float3 otherPosition = Particles[neighborId].Position;
                     float3 diff = myPosition - otherPosition;
-                    float r2 = dot(diff, diff); // 2
-                    float r = sqrt(r2); // Kvȏꍇ̂݃[gvZ
+                    float r2 = dot(diff, diff); // 距離の2乗
+                    float r = sqrt(r2); // 必要な場合のみルート計算
                     float W = Poly6Kernel(r, H);
                     float nearW = NearDensityKernel(r, H);
                     density += Mass * W;
@@ -66,6 +67,11 @@ void main(uint3 DTid : SV_DispatchThreadID)
             }
         }
     }
+    // 壁と障害物の境界粒子 (Ψ を質量の代わりに使う)
+    if (BoundaryParticleCount > 0)
+    {
+        AddBoundaryDensity(myPosition, myGridPos, int3(GridDim), H, density, nearDensity);
+    }
     if(density == 0.0f)
     {
         density = 0.0000001f;
@@ -73,7 +79,7 @@ void main(uint3 DTid : SV_DispatchThreadID)
     Particles[id].Density = density;
     Particles[id].NearDensity = nearDensity;
     
-    //  ԕ
+    // 圧力 状態方程式
     float densityError = density - RestDensity;
     Particles[id].Pressure = Stiffness * densityError;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "SPHCommon.hlsli"
+#include "BoundaryParticles.hlsli"
 
 RWStructuredBuffer<Particle> Particles : register(u0);
 RWStructuredBuffer<int> GridHead : register(u1);
@@ -36,7 +37,7 @@ void main(uint3 DTid : SV_DispatchThreadID)
     float myNearDensity = Particles[id].NearDensity;
     float myNearPressure = nearStiffness * myNearDensity;
     int3 myGridPos = GetGridPos(myPosition, WallMin, H);
-    // ͍AŠvZ
+    // 圧力項、粘性項の計算
     for (int z = -1; z <= 1; ++z)
     {
         for (int y = -1; y <= 1; ++y)
@@ -61,7 +62,7 @@ void main(uint3 DTid : SV_DispatchThreadID)
                     float3 diff = myPosition - otherPos;
                     float r2 = dot(diff, diff);
                     float3 dir = normalize(diff);
-                    // e͈͊O`FbN
+                    // 影響範囲外チェック
                     float h2 = H * H;
                     if (r2 >= h2 || r2 < 0.00001f)
                     {
@@ -79,15 +80,15 @@ void main(uint3 DTid : SV_DispatchThreadID)
                         neighborId = GridNext[neighborId];
                         continue;
                     }
-                    // ͍
+                    // 圧力項
                     float sharedPressure = (myPressure + otherPressure) / 2.0f;
                     pressureForce += -Mass * sharedPressure * dir * SpikyKernelGradient(r, H) / otherDensity;
         
-                    // S
+                    // 粘性項
                     float3 relativeSpeed = otherVelocity - myVelocity;
                     viscosityForce += Mass * relativeSpeed * ViscosityKernelLaplacian(r, H) / otherDensity;
 
-                    // ߖT
+                    // 近傍圧力
                     float otherNearPressure = nearStiffness * otherNearDensity;
                     float sharedNearPressure = (myNearPressure + otherNearPressure) / 2.0f;
                     pressureForce += -Mass * sharedNearPressure * dir * NearSpikyKernelGradient(r, H) / otherNearDensity;
@@ -98,10 +99,16 @@ void main(uint3 DTid : SV_DispatchThreadID)
         }
     }
 
-    // ͂̍
+    // 力の合成
     float3 gravityVec = float3(0.0f, Gravity, 0.0f);
     float3 externalForce = float3(0.0f, 0.0f, 0.0f);
     externalForce = Particles[id].Density * gravityVec;
     viscosityForce *= Viscosity;
     Particles[id].Force = pressureForce + viscosityForce + externalForce;
+    // 壁と障害物の境界粒子
+    if (BoundaryParticleCount > 0)
+    {
+        Particles[id].Force += BoundaryForce(myPosition, myVelocity, myGridPos, int3(GridDim), H, Particles[id].Density, myPressure,
+            myNearDensity, myNearPressure, Viscosity);
+    }
 }
\ No newline at end of file
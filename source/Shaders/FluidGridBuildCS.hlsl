@@ -22,7 +22,7 @@ cbuffer SimulationParam : register(b0)
     float Padding1;
 }
 
-// pass2 p[eBNObhɓo^
+// pass2 パーティクルをグリッドに登録
 [numthreads(256, 1, 1)]
 void main(uint3 DTid : SV_DispatchThreadID)
 {
@@ -30,17 +30,17 @@ void main(uint3 DTid : SV_DispatchThreadID)
     if (id >= ParticleCount) return;
     
     float3 pos = Particles[id].Position;
-    // ǂ̃Obhɂ邩ǂvZ
+    // 自分がどのグリッドにいるかどうか計算
     int3 gridPos = GetGridPos(pos, WallMin, H);
     int gridIndex = GetGridIndex(gridPos, GridDim);
     
-    // NXgւ̑}
+    // リンクリストへの挿入
     if(gridIndex != -1)
     {
         int oldHead;
-        // GridHead[gridIndex]Ɏgid݁AÂloldHeadɎ󂯎
+        // GridHead[gridIndex]に自身のidを書き込み、古い値をoldHeadに受け取る
         InterlockedExchange(GridHead[gridIndex], id, oldHead);
-        // Âheadnextɐݒ
+        // 古いheadを自分のnextに設定
         GridNext[id] = oldHead;
     }
     else
@@ -22,7 +22,7 @@ cbuffer SimulationParam : register(b0)
     float Padding1;
 }
 
-// Obh̃Zbg
+// グリッドのリセット
 [numthreads(256, 1, 1)]
 void main(uint3 DTid : SV_DispatchThreadID)
 {
@@ -30,6 +30,6 @@ void main(uint3 DTid : SV_DispatchThreadID)
     uint totalGridCount = uint(GridDim.x * GridDim.y * GridDim.z);
     if (id >= totalGridCount)
         return;
-    // -1ŏ
+    // -1で初期化
     GridHead[id] = -1;
 }
\ No newline at end of file
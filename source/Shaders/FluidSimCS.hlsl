@@ -1,4 +1,6 @@
 #include "SPHCommon.hlsli"
+#include "SDFCollider.hlsli"
+#include "BoundaryParticles.hlsli"
 
 RWStructuredBuffer<Particle> Particles : register(u0);
 RWStructuredBuffer<int> GridHead : register(u1);
@@ -34,11 +36,11 @@ void main( uint3 DTid : SV_DispatchThreadID )
     if (myDensity != 0.0f)
     {
         acceleration = Particles[id].Force / myDensity;
-            // 1. {bNX́ũTCYvƁuSWvvZ
+            // 1. ボックスの「半分のサイズ」と「中心座標」を計算
         float3 halfRealBoxSize = (WallMax - WallMin) / 2.0f;
         float3 boxCenter = (WallMax + WallMin) / 2.0f;
 
-        // 2. q̍Wu{bNXS̑΍Wvɕϊ
+        // 2. 粒子の座標を「ボックス中心からの相対座標」に変換
         float3 localPos = Particles[id].Position - boxCenter;
 
         float xPlusDist = halfRealBoxSize.x - localPos.x;
@@ -49,19 +51,27 @@ void main( uint3 DTid : SV_DispatchThreadID )
         float zMinusDist = halfRealBoxSize.z + localPos.z;
 
         float wallStiffness = 6000.0f;
+        // 境界粒子を使う場合は密度と力の計算で押し返すので、壁と障害物のペナルティは使わない
+        if (BoundaryParticleCount > 0)
+        {
+            wallStiffness = 0.0f;
+        }
 
         float3 force = float3(0, 0, 0);
-        // X
-        force.x += 1.0f * wallStiffness * min(xPlusDist, 0); // Eǂ̔()
-        force.x += -1.0f * wallStiffness * min(xMinusDist, 0); // ǂ̔(E)
+        // X軸
+        force.x += 1.0f * wallStiffness * min(xPlusDist, 0); // 右壁からの反発(左へ)
+        force.x += -1.0f * wallStiffness * min(xMinusDist, 0); // 左壁からの反発(右へ)
 
-        // Y
+        // Y軸
         force.y += 1.0f * wallStiffness * min(yPlusDist, 0);
         force.y += -1.0f * wallStiffness * min(yMinusDist, 0);
 
-        // Z
+        // Z軸
         force.z += 1.0f * wallStiffness * min(zPlusDist, 0);
         force.z += -1.0f * wallStiffness * min(zMinusDist, 0);
+
+        // SDFの障害物 (壁と同じ硬さで押し出す)
+        force += SDFColliderAcceleration(Particles[id].Position, wallStiffness);
        
         acceleration += force;
         Particles[id].Velocity += acceleration * DeltaTime;
@@ -72,5 +82,15 @@ void main( uint3 DTid : SV_DispatchThreadID )
             Particles[id].Velocity = normalize(Particles[id].Velocity) * maxSpeed;
         }
         Particles[id].Position += Particles[id].Velocity * DeltaTime;
+        // 1層の境界粒子の殻は速い粒子がすり抜けることがあるので、壁と障害物の表面に戻す
+        if (BoundaryParticleCount > 0)
+        {
+            float3 position = Particles[id].Position;
+            float3 velocity = Particles[id].Velocity;
+            ClampToWalls(position, velocity, WallMin, WallMax);
+            ProjectOutOfSDFColliders(position, velocity);
+            Particles[id].Position = position;
+            Particles[id].Velocity = velocity;
+        }
     }
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ StructuredBuffer<Particle> Particles : register(t0);
 
 cbuffer Transform : register(b0)
 {
-    float4x4 Billboard; // r{[hsiView̋ts̉]j
+    float4x4 Billboard; // ビルボード行列（Viewの逆行列の回転成分）
     float4x4 View;
     float4x4 Proj;
 };
@@ -33,13 +33,13 @@ struct VSOutput
 VSOutput main(VSInput input, uint instanceID : SV_InstanceID)
 {
     VSOutput output = (VSOutput) 0;
-    // p[eBN̈ʒu擾
+    // パーティクルの位置を取得
     float3 particlePos = Particles[instanceID].Position;
     
-    // q̃TCY
+    // 粒子のサイズ
     float particleSize = 0.1f;
     
-    // r{[hvZ
+    // ビルボード計算
     float3 worldPos = particlePos + mul((float3x3) Billboard, input.Position) * particleSize;
     float4 viewPos = mul(View, float4(worldPos, 1.0f));
     output.Position = mul(Proj, viewPos);
@@ -48,13 +48,13 @@ VSOutput main(VSInput input, uint instanceID : SV_InstanceID)
     
     float speed = length(Particles[instanceID].Velocity);
     
-// fobOp: x
+// デバッグ用: 密度可視化
     float density = Particles[instanceID].Density;
 
-    float targetDensity = 1000.0f; // C++RestDensityƍ킹
-    float nDensity = saturate((density - targetDensity) / 200.0f); // ͈͂L
+    float targetDensity = 1000.0f; // C++のRestDensityと合わせる
+    float nDensity = saturate((density - targetDensity) / 200.0f); // 範囲を広げる
 
-    // (ᖧx) -> (x)
+    // 青(低密度) -> 赤(高密度)
     output.Color = float4(lerp(float3(0, 0.5, 1), float3(1, 0, 0), nDensity), 1.0f);
     return output;
 
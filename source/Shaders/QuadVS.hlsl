@@ -1,7 +1,7 @@
 struct VSInput
 {
-    float2 Position : POSITION; // ʒuWł.
-    float2 TexCoord : TEXCOORD; // eNX`Wł.
+    float2 Position : POSITION; // 位置座標です.
+    float2 TexCoord : TEXCOORD; // テクスチャ座標です.
 };
 
 struct VSOutput
@@ -0,0 +1,110 @@
+#ifndef SDF_COLLIDER_HLSLI
+#define SDF_COLLIDER_HLSLI
+
+// SDFの障害物 (FluidStage.h の SDFColliderGPU と同じ並び)
+struct SDFCollider
+{
+    float4 InvWorld0; // モデルの World の逆行列の各行 (行ベクトル)
+    float4 InvWorld1;
+    float4 InvWorld2;
+    float4 InvWorld3;
+    float3 Origin;    // 格子点 (0, 0, 0) のローカル座標
+    float InvCellSize;
+    uint3 Dim;
+    uint ValueOffset; // SDFValues の中の先頭
+    float BandDistance;
+    float3 Padding;
+};
+
+StructuredBuffer<float> SDFValues : register(t0);
+StructuredBuffer<SDFCollider> SDFColliders : register(t1);
+
+cbuffer ColliderParam : register(b1)
+{
+    uint ColliderCount;
+}
+
+inline float SDFValue(SDFCollider collider, uint3 cell)
+{
+    return SDFValues[collider.ValueOffset + (cell.z * collider.Dim.y + cell.y) * collider.Dim.x + cell.x];
+}
+
+// ワールドの position の障害物の表面からの距離 (内側が負) と外向きの法線
+// CPU側の SDFCollider::Query と同じく、ローカルの勾配を逆行列の 3x3 部分でワールドに戻す。帯の外や法線が求まらない場合は false
+bool QuerySDFCollider(SDFCollider collider, float3 position, out float distance, out float3 normal)
+{
+    distance = collider.BandDistance;
+    normal = float3(0, 0, 0);
+    float3 localPos = position.x * collider.InvWorld0.xyz + position.y * collider.InvWorld1.xyz + position.z * collider.InvWorld2.xyz + collider.InvWorld3.xyz;
+    float3 g = (localPos - collider.Origin) * collider.InvCellSize;
+    if (any(g < 0.0f) || any(g > float3(collider.Dim - 1)))
+    {
+        return false;
+    }
+    uint3 cell = min(uint3(g), collider.Dim - 2);
+    float3 f = g - float3(cell);
+
+    float v000 = SDFValue(collider, cell);
+    float v100 = SDFValue(collider, cell + uint3(1, 0, 0));
+    float v010 = SDFValue(collider, cell + uint3(0, 1, 0));
+    float v110 = SDFValue(collider, cell + uint3(1, 1, 0));
+    float v001 = SDFValue(collider, cell + uint3(0, 0, 1));
+    float v101 = SDFValue(collider, cell + uint3(1, 0, 1));
+    float v011 = SDFValue(collider, cell + uint3(0, 1, 1));
+    float v111 = SDFValue(collider, cell + uint3(1, 1, 1));
+    // x, y, z の順に補間する
+    float v00 = lerp(v000, v100, f.x);
+    float v10 = lerp(v010, v110, f.x);
+    float v01 = lerp(v001, v101, f.x);
+    float v11 = lerp(v011, v111, f.x);
+    float v0 = lerp(v00, v10, f.y);
+    float v1 = lerp(v01, v11, f.y);
+    float localDistance = lerp(v0, v1, f.z);
+
+    float dx0 = lerp(v100 - v000, v110 - v010, f.y);
+    float dx1 = lerp(v101 - v001, v111 - v011, f.y);
+    float3 localGradient = float3(lerp(dx0, dx1, f.z), lerp(v10 - v00, v11 - v01, f.z), v1 - v0) * collider.InvCellSize;
+    float3 gradient = float3(dot(collider.InvWorld0.xyz, localGradient), dot(collider.InvWorld1.xyz, localGradient), dot(collider.InvWorld2.xyz, localGradient));
+    float gradientLength = length(gradient);
+    if (localDistance >= collider.BandDistance || gradientLength <= 0.0f)
+    {
+        distance = localDistance;
+        return false;
+    }
+    distance = localDistance * length(localGradient) / gradientLength;
+    normal = gradient / gradientLength;
+    return true;
+}
+
+// すべての障害物から押し出す加速度 (壁と同じく、めり込んだ深さに比例するペナルティ)
+float3 SDFColliderAcceleration(float3 position, float stiffness)
+{
+    float3 acceleration = float3(0, 0, 0);
+    for (uint i = 0; i < ColliderCount; ++i)
+    {
+        float distance;
+        float3 normal;
+        if (QuerySDFCollider(SDFColliders[i], position, distance, normal) && distance < 0.0f)
+        {
+            acceleration -= normal * (stiffness * distance);
+        }
+    }
+    return acceleration;
+}
+
+// 障害物の内側に入った粒子を表面に戻し、内向きの速度を消す (CPU側の ProjectOutOfColliders と同じ)
+void ProjectOutOfSDFColliders(inout float3 position, inout float3 velocity)
+{
+    for (uint i = 0; i < ColliderCount; ++i)
+    {
+        float distance;
+        float3 normal;
+        if (QuerySDFCollider(SDFColliders[i], position, distance, normal) && distance < 0.0f)
+        {
+            position -= normal * distance;
+            velocity -= normal * min(dot(velocity, normal), 0.0f);
+        }
+    }
+}
+
+#endif // SDF_COLLIDER_HLSLI
\ No newline at end of file
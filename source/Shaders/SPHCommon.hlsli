@@ -1,7 +1,7 @@
 #ifndef SPH_COMMON_HLSLI
 #define SPH_COMMON_HLSLI
 
-// 萔
+// 物理定数
 static const float PI = 3.14159265359f;
 
 struct Particle
@@ -14,9 +14,9 @@ struct Particle
     float NearDensity;
 };
 
-// xvZp̃J[l֐(d)
-// W(r, h) = (315 / (64 * pi * h^9)) * (h^2 - r^2)^3   (0 <= r <= h ̏ꍇ)
-// W(r, h) = 0                                         (r > h ̏ꍇ)
+// 密度を計算する用のカーネル関数(重み)
+// W(r, h) = (315 / (64 * pi * h^9)) * (h^2 - r^2)^3   (0 <= r <= h の場合)
+// W(r, h) = 0                                         (r > h の場合)
 inline float Poly6Kernel(float r, float h)
 {
     if(r < h)
@@ -31,7 +31,7 @@ inline float Poly6Kernel(float r, float h)
     return 0.0f;
 }
 
-// ߖTxvZp̃J[l֐(d)
+// 近傍密度を計算する用のカーネル関数(重み)
 inline float NearDensityKernel(float r, float h)
 {   
     if (r < h)
@@ -44,7 +44,7 @@ inline float NearDensityKernel(float r, float h)
     return 0.0f;
 }
 
-// ߖT͌vZp̃J[l֐
+// 近傍圧力計算用のカーネル関数
 inline float SpikyKernelGradient(float r, float h)
 {
     if (r <= h)
@@ -56,7 +56,7 @@ inline float SpikyKernelGradient(float r, float h)
     return 0.0f;
 }
 
-// ͌vZp̃J[l֐
+// 圧力計算用のカーネル関数
 inline float NearSpikyKernelGradient(float r, float h)
 {   
     if (r <= h)
@@ -68,8 +68,8 @@ inline float NearSpikyKernelGradient(float r, float h)
     return 0.0f;
 }
 
-// SvZp̃J[liLaplacianj
-// ^2W(r, h) = (45 / (pi * h^6)) * (h - r)
+// 粘性計算用のカーネル（Laplacian）
+// ∇^2W(r, h) = (45 / (pi * h^6)) * (h - r)
 inline float ViscosityKernelLaplacian(float r, float h)
 {
     if(r < h)
@@ -86,14 +86,14 @@ inline int3 GetGridPos(float3 pos, float3 wallMin, float H)
     return (int3)floor(localPos / H) + 1;
 }
 
-// WObh̃CfbNX擾
+// 座標からグリッドのインデックスを取得
 inline int GetGridIndex(int3 gridPos, int3 gridDim)
 {
     if (gridPos.x < 0 || gridPos.x >= gridDim.x ||
         gridPos.y < 0 || gridPos.y >= gridDim.y ||
         gridPos.z < 0 || gridPos.z >= gridDim.z)
     {
-        return -1; // l
+        return -1; // 無効値
     }
     return gridPos.x + (gridPos.y * gridDim.x) + (gridPos.z * gridDim.x * gridDim.y);
 }
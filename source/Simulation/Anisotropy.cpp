@@ -0,0 +1,269 @@
+#include "Simulation/Anisotropy.h"
+#include "Simulation/SPHCommon.h"
+#include "Simulation/ThreadPool.h"
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// 周りの (2 * range + 1)^3 のセルのバケット (ハッシュが衝突したセルを2回数えないよう重複を除く)
+	uint32_t GatherNeighborBuckets(const SPHCommon::GridPos& gridPos, int range, uint32_t bucketCount, uint32_t* buckets)
+	{
+		uint32_t count = 0;
+		for (int dz = -range; dz <= range; ++dz)
+		{
+			for (int dy = -range; dy <= range; ++dy)
+			{
+				for (int dx = -range; dx <= range; ++dx)
+				{
+					SPHCommon::GridPos neighbor = { gridPos.x + dx, gridPos.y + dy, gridPos.z + dz };
+					buckets[count++] = SPHCommon::HashGridPos(neighbor, bucketCount);
+				}
+			}
+		}
+		std::sort(buckets, buckets + count);
+		return static_cast<uint32_t>(std::unique(buckets, buckets + count) - buckets);
+	}
+}
+
+AnisotropyEstimator::AnisotropyEstimator(uint32_t threadCount)
+	: m_pOwnedThreadPool(std::make_unique<ThreadPool>(threadCount))
+{
+	m_pThreadPool = m_pOwnedThreadPool.get();
+}
+
+AnisotropyEstimator::AnisotropyEstimator(ThreadPool& threadPool)
+	: m_pThreadPool(&threadPool)
+{
+}
+
+AnisotropyEstimator::~AnisotropyEstimator() = default;
+
+void AnisotropyEstimator::Compute(const std::vector<Particle>& particles, const SimulationParam& simParam, std::vector<EllipsoidKernel>& kernels)
+{
+	auto totalStart = Clock::now();
+	m_Stats = AnisotropyStats();
+	const uint32_t particleCount = static_cast<uint32_t>(particles.size());
+	m_Stats.ParticleCount = particleCount;
+	kernels.resize(particleCount);
+	if (particleCount == 0)
+	{
+		return;
+	}
+
+	// ソルバーの SpatialHash と同じ、H のセルのハッシュで粒子を並べる (壁の外の粒子も同じ式で扱える)
+	auto neighborStart = Clock::now();
+	const float H = simParam.H;
+	uint32_t bucketCount = 1024;
+	while (bucketCount < particleCount * 2)
+	{
+		bucketCount *= 2;
+	}
+	m_ParticleBucket.resize(particleCount);
+	m_pThreadPool->ParallelFor(0, particleCount, 4096, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			m_ParticleBucket[i] = SPHCommon::HashGridPos(SPHCommon::GetGridPos(particles[i].Position, simParam.WallMin, H), bucketCount);
+		}
+	});
+	m_BucketStart.assign(bucketCount + 1, 0);
+	for (uint32_t i = 0; i < particleCount; ++i)
+	{
+		++m_BucketStart[m_ParticleBucket[i] + 1];
+	}
+	for (uint32_t bucket = 0; bucket < bucketCount; ++bucket)
+	{
+		m_BucketStart[bucket + 1] += m_BucketStart[bucket];
+	}
+	m_SortedPositions.resize(particleCount);
+	m_SortedIndices.resize(particleCount);
+	{
+		std::vector<uint32_t> cursor(m_BucketStart.begin(), m_BucketStart.end() - 1);
+		for (uint32_t i = 0; i < particleCount; ++i)
+		{
+			uint32_t slot = cursor[m_ParticleBucket[i]]++;
+			m_SortedPositions[slot] = particles[i].Position;
+			m_SortedIndices[slot] = i;
+		}
+	}
+
+	// 近傍の重み付き平均と共分散 (自分からの差で足し込み、平均を引く時の桁落ちを抑える)
+	// 半径 R の近傍は H のセルを range 周分見る。バケット順に回り、同じセルの粒子が続く間は周りのセルの粒子 (候補) の一覧を使い回す
+	m_NeighborCounts.resize(particleCount);
+	for (auto& covariance : m_Covariance)
+	{
+		covariance.resize(particleCount);
+	}
+	const float neighborRadius = H * std::max(0.01f, m_Param.NeighborRadius);
+	const int range = static_cast<int>(std::ceil(neighborRadius / H));
+	const float invRadius = 1.0f / neighborRadius;
+	const float radius2 = neighborRadius * neighborRadius;
+	m_pThreadPool->ParallelFor(0, particleCount, 1024, [&](uint32_t begin, uint32_t end)
+	{
+		std::vector<uint32_t> buckets((2 * range + 1) * (2 * range + 1) * (2 * range + 1));
+		std::vector<float> candidates[3];
+		std::vector<float> distances2;
+		std::vector<uint32_t> accepted;
+		bool hasLastGridPos = false;
+		SPHCommon::GridPos lastGridPos;
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			const uint32_t i = m_SortedIndices[slot];
+			const Vector3D position = m_SortedPositions[slot];
+			const SPHCommon::GridPos gridPos = SPHCommon::GetGridPos(position, simParam.WallMin, H);
+			if (!hasLastGridPos || gridPos.x != lastGridPos.x || gridPos.y != lastGridPos.y || gridPos.z != lastGridPos.z)
+			{
+				const uint32_t bucketCountAround = GatherNeighborBuckets(gridPos, range, bucketCount, buckets.data());
+				for (auto& axis : candidates)
+				{
+					axis.clear();
+				}
+				for (uint32_t b = 0; b < bucketCountAround; ++b)
+				{
+					for (uint32_t j = m_BucketStart[buckets[b]]; j < m_BucketStart[buckets[b] + 1]; ++j)
+					{
+						candidates[0].push_back(m_SortedPositions[j].x);
+						candidates[1].push_back(m_SortedPositions[j].y);
+						candidates[2].push_back(m_SortedPositions[j].z);
+					}
+				}
+				distances2.resize(candidates[0].size());
+				accepted.resize(candidates[0].size());
+				lastGridPos = gridPos;
+				hasLastGridPos = true;
+			}
+			// 候補の3/4近くは半径の外なので、先に距離を (SIMD化できる形で) まとめて求め、半径内の候補だけを分岐なしで詰めてから重みを計算する
+			const uint32_t candidateCount = static_cast<uint32_t>(distances2.size());
+			const float* pX = candidates[0].data();
+			const float* pY = candidates[1].data();
+			const float* pZ = candidates[2].data();
+			float* pDistances2 = distances2.data();
+			for (uint32_t c = 0; c < candidateCount; ++c)
+			{
+				const float dx = pX[c] - position.x;
+				const float dy = pY[c] - position.y;
+				const float dz = pZ[c] - position.z;
+				pDistances2[c] = dx * dx + dy * dy + dz * dz;
+			}
+			uint32_t neighborCount = 0;
+			for (uint32_t c = 0; c < candidateCount; ++c)
+			{
+				accepted[neighborCount] = c;
+				neighborCount += (pDistances2[c] < radius2) ? 1 : 0;
+			}
+			float sumW = 0.0f;
+			Vector3D sumD(0.0f, 0.0f, 0.0f);
+			float sumDD[6] = {};
+			for (uint32_t n = 0; n < neighborCount; ++n)
+			{
+				const uint32_t c = accepted[n];
+				const Vector3D d(pX[c] - position.x, pY[c] - position.y, pZ[c] - position.z);
+				const float q = std::sqrt(pDistances2[c]) * invRadius;
+				const float w = 1.0f - q * q * q;
+				sumW += w;
+				sumD += d * w;
+				sumDD[0] += w * d.x * d.x;
+				sumDD[1] += w * d.x * d.y;
+				sumDD[2] += w * d.x * d.z;
+				sumDD[3] += w * d.y * d.y;
+				sumDD[4] += w * d.y * d.z;
+				sumDD[5] += w * d.z * d.z;
+			}
+			// 自分自身 (距離0) は必ず含まれるので sumW >= 1
+			const float invW = 1.0f / sumW;
+			const Vector3D mean = sumD * invW;
+			m_NeighborCounts[i] = neighborCount - 1;
+			m_Covariance[0][i] = sumDD[0] * invW - mean.x * mean.x;
+			m_Covariance[1][i] = sumDD[1] * invW - mean.x * mean.y;
+			m_Covariance[2][i] = sumDD[2] * invW - mean.x * mean.z;
+			m_Covariance[3][i] = sumDD[3] * invW - mean.y * mean.y;
+			m_Covariance[4][i] = sumDD[4] * invW - mean.y * mean.z;
+			m_Covariance[5][i] = sumDD[5] * invW - mean.z * mean.z;
+			kernels[i].Center = position + mean * m_Param.Smoothing;
+		}
+	});
+	m_Stats.NeighborMilliseconds = ElapsedMilliseconds(neighborStart);
+
+	// 固有分解はチャンク毎に SoA のままSIMDでまとめて行う
+	auto eigenStart = Clock::now();
+	for (auto& values : m_EigenValues)
+	{
+		values.resize(particleCount);
+	}
+	for (auto& vectors : m_EigenVectors)
+	{
+		vectors.resize(particleCount);
+	}
+	const SPHBatchKernels& batchKernels = GetSPHBatchKernels(m_Param.SIMD);
+	const float maxStretch = std::max(1.0f, m_Param.MaxStretch);
+	std::vector<uint32_t> isolatedCounts(m_pThreadPool->GetThreadCount(), 0);
+	m_pThreadPool->ParallelForWithThreadIndex(0, particleCount, 4096, [&](uint32_t threadIndex, uint32_t begin, uint32_t end)
+	{
+		const float* matrix[6];
+		float* eigenValues[3];
+		float* eigenVectors[9];
+		for (uint32_t e = 0; e < 6; ++e)
+		{
+			matrix[e] = m_Covariance[e].data() + begin;
+		}
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			eigenValues[k] = m_EigenValues[k].data() + begin;
+		}
+		for (uint32_t k = 0; k < 9; ++k)
+		{
+			eigenVectors[k] = m_EigenVectors[k].data() + begin;
+		}
+		batchKernels.DecomposeSymmetric3x3(matrix, eigenValues, eigenVectors, end - begin);
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			EllipsoidKernel& kernel = kernels[i];
+			float sigma[3];
+			float sigmaMax = 0.0f;
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				sigma[k] = std::max(0.0f, m_EigenValues[k][i]);
+				sigmaMax = std::max(sigmaMax, sigma[k]);
+			}
+			if (m_NeighborCounts[i] < m_Param.MinNeighbors || sigmaMax <= 0.0f)
+			{
+				kernel.Axes[0] = Vector3D(1.0f, 0.0f, 0.0f);
+				kernel.Axes[1] = Vector3D(0.0f, 1.0f, 0.0f);
+				kernel.Axes[2] = Vector3D(0.0f, 0.0f, 1.0f);
+				kernel.Radii[0] = kernel.Radii[1] = kernel.Radii[2] = m_Param.IsolatedScale;
+				++isolatedCounts[threadIndex];
+				continue;
+			}
+			// 細い主軸を太くして比を MaxStretch までにし、体積 (半径の積) を等方なカーネルに揃える (論文の k_s の代わり)
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				sigma[k] = std::max(sigma[k], sigmaMax / maxStretch);
+			}
+			const float scale = 1.0f / std::cbrt(sigma[0] * sigma[1] * sigma[2]);
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				kernel.Axes[k] = Vector3D(m_EigenVectors[3 * k + 0][i], m_EigenVectors[3 * k + 1][i], m_EigenVectors[3 * k + 2][i]).GetSafeNormal();
+				kernel.Radii[k] = sigma[k] * scale;
+			}
+		}
+	});
+	uint64_t neighborSum = 0;
+	for (uint32_t count : m_NeighborCounts)
+	{
+		neighborSum += count;
+	}
+	for (uint32_t count : isolatedCounts)
+	{
+		m_Stats.IsolatedCount += count;
+	}
+	m_Stats.MeanNeighborCount = static_cast<float>(static_cast<double>(neighborSum) / particleCount);
+	m_Stats.EigenMilliseconds = ElapsedMilliseconds(eigenStart);
+	m_Stats.TotalMilliseconds = ElapsedMilliseconds(totalStart);
+}
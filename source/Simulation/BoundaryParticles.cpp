@@ -0,0 +1,251 @@
+#include "Simulation/BoundaryParticles.h"
+#include "Simulation/ThreadPool.h"
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	bool SameVector(const Vector3D& a, const Vector3D& b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+
+	bool SameWorld(const Matrix4x4& a, const Matrix4x4& b)
+	{
+		return std::memcmp(a.m_mat, b.m_mat, sizeof(a.m_mat)) == 0;
+	}
+}
+
+float BoundaryParticles::GetSpacing(const SimulationParam& param, const BoundaryParticleParam& boundaryParam)
+{
+	if (boundaryParam.Spacing > 0.0f)
+	{
+		return boundaryParam.Spacing;
+	}
+	if (param.Mass <= 0.0f || param.RestDensity <= 0.0f)
+	{
+		return 0.0f;
+	}
+	return std::cbrt(param.Mass / param.RestDensity);
+}
+
+bool BoundaryParticles::IsUpToDate(const SimulationParam& param, const std::vector<SDFCollider>& colliders, const BoundaryParticleParam& boundaryParam) const
+{
+	if (m_CellSize <= 0.0f || colliders.size() != m_BuiltColliders.size())
+	{
+		return false;
+	}
+	const SimulationParam& built = m_BuiltParam;
+	if (!SameVector(param.WallMin, built.WallMin) || !SameVector(param.WallMax, built.WallMax) || param.H != built.H ||
+		param.Mass != built.Mass || param.RestDensity != built.RestDensity || GetSpacing(param, boundaryParam) != m_BuiltSpacing)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < colliders.size(); ++i)
+	{
+		if (colliders[i].pField != m_BuiltColliders[i].pField || !SameWorld(colliders[i].World, m_BuiltColliders[i].World))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void BoundaryParticles::Clear()
+{
+	m_CellSize = 0.0f;
+	m_Positions.clear();
+	m_Psi.clear();
+	m_CellStart.clear();
+	m_BuiltColliders.clear();
+	m_ColliderSamples.clear();
+	m_Stats = BoundaryParticleStats();
+}
+
+void BoundaryParticles::SampleWalls(const SimulationParam& param, float spacing, std::vector<Vector3D>& points) const
+{
+	// 流体は壁の上に止まるので、間隔の半分だけ外側の殻に並べて壁の上の粒子との距離を保つ
+	const Vector3D shellMin = param.WallMin - Vector3D(spacing * 0.5f);
+	const Vector3D shellMax = param.WallMax + Vector3D(spacing * 0.5f);
+	const Vector3D extent = shellMax - shellMin;
+	// 各軸を間隔に近い等分にする (格子点は 0 .. count)
+	const uint32_t countX = std::max(1u, static_cast<uint32_t>(std::lround(extent.x / spacing)));
+	const uint32_t countY = std::max(1u, static_cast<uint32_t>(std::lround(extent.y / spacing)));
+	const uint32_t countZ = std::max(1u, static_cast<uint32_t>(std::lround(extent.z / spacing)));
+	const Vector3D step(extent.x / countX, extent.y / countY, extent.z / countZ);
+
+	for (uint32_t z = 0; z <= countZ; ++z)
+	{
+		for (uint32_t y = 0; y <= countY; ++y)
+		{
+			// z, y が殻の面の上なら行全体、そうでなければ x の両端だけ
+			const bool wholeRow = (z == 0 || z == countZ || y == 0 || y == countY);
+			const uint32_t xStep = wholeRow ? 1 : countX;
+			for (uint32_t x = 0; x <= countX; x += xStep)
+			{
+				points.push_back(shellMin + Vector3D(x * step.x, y * step.y, z * step.z));
+			}
+		}
+	}
+}
+
+const std::vector<Vector3D>& BoundaryParticles::SampleCollider(const SignedDistanceField& field, float localSpacing, ThreadPool& threadPool)
+{
+	for (const ColliderSamples& samples : m_ColliderSamples)
+	{
+		if (samples.pField == &field && samples.LocalSpacing == localSpacing)
+		{
+			return samples.Positions;
+		}
+	}
+
+	// SDF の範囲を間隔の格子で走査し、表面から間隔の半分以内の格子点を表面の内側へ射影する
+	// (帯の厚さが間隔なので、表面の面積 A に対しておおよそ A / 間隔^2 個の点になる。疎密は Ψ で補正する)
+	const uint32_t* dim = field.GetDim();
+	const Vector3D origin = field.GetOrigin();
+	const float cellSize = field.GetCellSize();
+	const Vector3D extent(cellSize * (dim[0] - 1), cellSize * (dim[1] - 1), cellSize * (dim[2] - 1));
+	const uint32_t countX = static_cast<uint32_t>(extent.x / localSpacing) + 1;
+	const uint32_t countY = static_cast<uint32_t>(extent.y / localSpacing) + 1;
+	const uint32_t countZ = static_cast<uint32_t>(extent.z / localSpacing) + 1;
+	const float halfSpacing = localSpacing * 0.5f;
+
+	// z の層毎に集めてから層の順に繋げる (スレッド数に関係なく同じ順番になる)
+	std::vector<std::vector<Vector3D>> layers(countZ);
+	threadPool.ParallelFor(0, countZ, 1, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t z = begin; z < end; ++z)
+		{
+			std::vector<Vector3D>& layer = layers[z];
+			for (uint32_t y = 0; y < countY; ++y)
+			{
+				for (uint32_t x = 0; x < countX; ++x)
+				{
+					Vector3D position = origin + Vector3D(x * localSpacing, y * localSpacing, z * localSpacing);
+					Vector3D gradient;
+					float distance = field.Sample(position, &gradient);
+					float length = gradient.length();
+					if (std::abs(distance) >= halfSpacing || length <= 0.0f)
+					{
+						continue;
+					}
+					layer.push_back(position - gradient * ((distance + halfSpacing) / length));
+				}
+			}
+		}
+	});
+
+	ColliderSamples samples;
+	samples.pField = &field;
+	samples.LocalSpacing = localSpacing;
+	for (const std::vector<Vector3D>& layer : layers)
+	{
+		samples.Positions.insert(samples.Positions.end(), layer.begin(), layer.end());
+	}
+	m_ColliderSamples.push_back(std::move(samples));
+	return m_ColliderSamples.back().Positions;
+}
+
+bool BoundaryParticles::Build(const SimulationParam& param, const std::vector<SDFCollider>& colliders, const BoundaryParticleParam& boundaryParam, ThreadPool& threadPool)
+{
+	auto start = Clock::now();
+	const float spacing = GetSpacing(param, boundaryParam);
+	m_Positions.clear();
+	m_Psi.clear();
+	m_CellStart.clear();
+	m_Stats = BoundaryParticleStats();
+	m_CellSize = 0.0f;
+	if (param.H <= 0.0f || spacing <= 0.0f)
+	{
+		return false;
+	}
+	assert(spacing < param.H && "boundary spacing must be smaller than H");
+
+	// 今の障害物で使わなくなった SDF の表面の点は捨てる
+	m_ColliderSamples.erase(std::remove_if(m_ColliderSamples.begin(), m_ColliderSamples.end(), [&](const ColliderSamples& samples)
+	{
+		return std::none_of(colliders.begin(), colliders.end(), [&](const SDFCollider& collider) { return collider.pField == samples.pField; });
+	}), m_ColliderSamples.end());
+
+	std::vector<Vector3D> points;
+	SampleWalls(param, spacing, points);
+	m_Stats.WallParticleCount = static_cast<uint32_t>(points.size());
+	for (const SDFCollider& collider : colliders)
+	{
+		// ワールドで spacing の間隔になるよう、ローカルの間隔は拡大縮小で割る
+		const std::vector<Vector3D>& localPoints = SampleCollider(*collider.pField, spacing / collider.LocalToWorldScale, threadPool);
+		for (const Vector3D& localPoint : localPoints)
+		{
+			points.push_back(Matrix4x4::Apply(collider.World, localPoint));
+		}
+	}
+
+	// 流体のグリッドと同じセルでカウンティングソートする (グリッドの外の点は流体から見えないので捨てる)
+	m_WallMin = param.WallMin;
+	m_CellSize = param.H;
+	m_GridDim = SPHCommon::ToGridPos(SPHCommon::ComputeGridDim(param.WallMin, param.WallMax, param.H));
+	const uint32_t cellCount = static_cast<uint32_t>(m_GridDim.x * m_GridDim.y * m_GridDim.z);
+	std::vector<int> pointCells(points.size());
+	m_CellStart.assign(cellCount + 1, 0);
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		pointCells[i] = SPHCommon::GetGridIndex(SPHCommon::GetGridPos(points[i], m_WallMin, m_CellSize), m_GridDim);
+		if (pointCells[i] != -1)
+		{
+			++m_CellStart[pointCells[i] + 1];
+		}
+	}
+	for (uint32_t cell = 0; cell < cellCount; ++cell)
+	{
+		m_CellStart[cell + 1] += m_CellStart[cell];
+	}
+	m_Positions.resize(m_CellStart[cellCount]);
+	std::vector<uint32_t> cursor(m_CellStart.begin(), m_CellStart.end() - 1);
+	uint32_t keptWallCount = 0;
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		if (pointCells[i] != -1)
+		{
+			m_Positions[cursor[pointCells[i]]++] = points[i];
+			keptWallCount += (i < m_Stats.WallParticleCount) ? 1 : 0;
+		}
+	}
+	m_Stats.WallParticleCount = keptWallCount;
+	m_Stats.ColliderParticleCount = GetCount() - keptWallCount;
+
+	// Ψb = ρ0 / Σk W(xb - xk) (自分自身を含む境界粒子だけの和)
+	const SPHKernels::Kernel<DensityKernel> kernel(param.H);
+	m_Psi.resize(m_Positions.size());
+	threadPool.ParallelFor(0, GetCount(), 256, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t index = begin; index < end; ++index)
+		{
+			const Vector3D position = m_Positions[index];
+			float weight = 0.0f;
+			ForEachNeighbor(position, [&](uint32_t other)
+			{
+				Vector3D diff = position - m_Positions[other];
+				weight += kernel.Value(std::sqrt(diff.dot(diff)));
+			});
+			m_Psi[index] = param.RestDensity / weight;
+		}
+	});
+	if (!m_Psi.empty())
+	{
+		auto range = std::minmax_element(m_Psi.begin(), m_Psi.end());
+		m_Stats.MinPsi = *range.first;
+		m_Stats.MaxPsi = *range.second;
+	}
+
+	m_BuiltParam = param;
+	m_BuiltSpacing = spacing;
+	m_BuiltColliders = colliders;
+	m_Stats.Spacing = spacing;
+	m_Stats.BuildMilliseconds = ElapsedMilliseconds(start);
+	return true;
+}
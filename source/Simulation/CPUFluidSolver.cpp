@@ -0,0 +1,2272 @@
+#include "Simulation/CPUFluidSolver.h"
+#include "Simulation/ThreadPool.h"
+#include "Simulation/Morton.h"
+#include "Simulation/Checkpoint.h"
+
+#include <random>
+
+#if defined(__linux__)
+#include <ctime>
+#endif
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// 負荷の計測用の時刻 (ミリ秒)
+	// Linuxでは呼び出したスレッドのCPU時間を使い、スレッド数がコア数より多くても他のスレッドの実行待ちを含めない
+	double WorkMilliseconds()
+	{
+#if defined(__linux__)
+		timespec time;
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+		return time.tv_sec * 1.0e3 + time.tv_nsec * 1.0e-6;
+#else
+		return std::chrono::duration<double, std::milli>(Clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	// FluidSimCS.hlsl の壁と障害物からの反発 (めり込んだ分だけ押し戻す。境界粒子を使う場合は無効にする)
+	struct WallPenalty
+	{
+		WallPenalty(const SimulationParam& param, const std::vector<SDFCollider>& colliders, bool enabled, float stiffness)
+			// ボックスの「半分のサイズ」と「中心座標」
+			: HalfSize((param.WallMax - param.WallMin) * 0.5f)
+			, Center((param.WallMax + param.WallMin) * 0.5f)
+			, Colliders(colliders)
+			, Enabled(enabled)
+			, Stiffness(stiffness)
+		{
+		}
+
+		Vector3D Acceleration(const Vector3D& position) const
+		{
+			if (!Enabled)
+			{
+				return Vector3D(0.0f);
+			}
+			// 粒子の座標を「ボックス中心からの相対座標」に変換
+			Vector3D localPos = position - Center;
+
+			Vector3D force(0.0f);
+			force.x += Stiffness * std::min(HalfSize.x - localPos.x, 0.0f);
+			force.x -= Stiffness * std::min(HalfSize.x + localPos.x, 0.0f);
+			force.y += Stiffness * std::min(HalfSize.y - localPos.y, 0.0f);
+			force.y -= Stiffness * std::min(HalfSize.y + localPos.y, 0.0f);
+			force.z += Stiffness * std::min(HalfSize.z - localPos.z, 0.0f);
+			force.z -= Stiffness * std::min(HalfSize.z + localPos.z, 0.0f);
+
+			// 障害物は表面からの距離が負の間、法線の向きに押し戻す
+			for (const SDFCollider& collider : Colliders)
+			{
+				float distance;
+				Vector3D normal;
+				if (collider.Query(position, distance, normal) && distance < 0.0f)
+				{
+					force -= normal * (Stiffness * distance);
+				}
+			}
+			return force;
+		}
+
+		Vector3D HalfSize;
+		Vector3D Center;
+		const std::vector<SDFCollider>& Colliders;
+		const bool Enabled;
+		const float Stiffness;
+	};
+}
+
+CPUFluidSolver::CPUFluidSolver(uint32_t threadCount)
+{
+	m_pThreadPool = std::make_unique<ThreadPool>(threadCount);
+	m_pBatchKernels = &GetSPHBatchKernels(DetectSIMDLevel());
+}
+
+CPUFluidSolver::~CPUFluidSolver()
+{
+}
+
+uint32_t CPUFluidSolver::GetThreadCount() const
+{
+	return m_pThreadPool->GetThreadCount();
+}
+
+size_t CPUFluidSolver::GetGridMemoryBytes() const
+{
+	size_t bytes = 0;
+	bytes += m_GridHeadCapacity * sizeof(int32_t);
+	bytes += m_GridNext.size() * sizeof(int32_t);
+	bytes += m_CellCountCapacity * sizeof(uint32_t);
+	bytes += m_CellStart.size() * sizeof(uint32_t);
+	bytes += m_ParticleCellKey.size() * sizeof(uint64_t);
+	return bytes;
+}
+
+const char* CPUFluidSolver::GetGridBuildModeConflict() const
+{
+	// セル内の粒子が連続している必要がある
+	if (m_GridBuildMode != GridBuildMode::CountingSort)
+	{
+		if (m_UseSoAKernels)
+		{
+			return "SoA kernels need the counting sort grid";
+		}
+		if (m_UseSymmetricForce)
+		{
+			return "symmetric force needs the counting sort grid";
+		}
+		if (m_WorkSchedule == WorkSchedule::MortonPartition)
+		{
+			return "Morton work partitioning needs the counting sort grid";
+		}
+		if (m_UseNumaPlacement)
+		{
+			return "NUMA placement needs the counting sort grid";
+		}
+	}
+	if (m_Deterministic)
+	{
+		// リンクリストはセル内の順番がスレッドの実行順で変わる
+		if (m_GridBuildMode == GridBuildMode::LinkedList)
+		{
+			return "deterministic mode needs the counting sort or spatial hash grid";
+		}
+		// スレッド毎のバッファの合計はスレッド数で順番が変わる
+		if (m_UseSymmetricForce)
+		{
+			return "symmetric force cannot be used in deterministic mode";
+		}
+	}
+	return nullptr;
+}
+
+void CPUFluidSolver::SetSimulationParam(const SimulationParam& param)
+{
+	m_SimParam = param;
+	m_SimParam.ParticleCount = GetParticleCount();
+	UpdateGridDim();
+}
+
+void CPUFluidSolver::SetNeighborListSkin(float skin)
+{
+	m_NeighborListSkin = std::max(skin, 0.0f);
+	UpdateGridDim();
+}
+
+void CPUFluidSolver::UpdateGridDim()
+{
+	// 近傍リストは H + skin 以内の粒子を集めるので、セルもその大きさにする
+	m_GridCellSize = m_SimParam.H + m_NeighborListSkin;
+	m_SimParam.GridDim = SPHCommon::ComputeGridDim(m_SimParam.WallMin, m_SimParam.WallMax, m_GridCellSize);
+
+	m_GridDim = SPHCommon::ToGridPos(m_SimParam.GridDim);
+	m_TotalGridCount = static_cast<uint32_t>(m_GridDim.x * m_GridDim.y * m_GridDim.z);
+	m_NeighborListValid = false;
+}
+
+void CPUFluidSolver::InitializeParticles(uint32_t particleCount, uint32_t seed)
+{
+	std::vector<Particle> particles(particleCount);
+	float margin = 0.1f;
+	Vector3D spawnMin = m_SimParam.WallMin + Vector3D(margin, margin, margin);
+	Vector3D spawnMax = m_SimParam.WallMax - Vector3D(margin, margin, margin);
+	Vector3D spawnRange = spawnMax - spawnMin;
+
+	std::mt19937 engine(seed);
+	std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+	for (uint32_t i = 0; i < particleCount; ++i)
+	{
+		// 範囲内に配置
+		float posX = spawnMin.x + dist(engine) * spawnRange.x;
+		float posY = spawnMin.y + dist(engine) * spawnRange.y;
+		float posZ = spawnMin.z + dist(engine) * spawnRange.z;
+
+		particles[i].Position = Vector3D(posX, posY, posZ);
+		particles[i].Velocity = Vector3D(0, 0, 0);
+		particles[i].Density = 0.0f;
+		particles[i].Pressure = 0.0f;
+		particles[i].Force = Vector3D(0, 0, 0);
+		particles[i].NearDensity = 0.0f;
+	}
+	SetParticles(particles);
+}
+
+void CPUFluidSolver::SetParticles(const std::vector<Particle>& particles)
+{
+	ReserveParticleCapacity(static_cast<uint32_t>(particles.size()));
+	m_Particles.assign(particles.begin(), particles.end());
+	ResizeParticleArrays();
+	std::fill(m_GridNext.begin(), m_GridNext.end(), -1);
+
+	// 渡された順番をそのまま粒子IDにする
+	m_IdToSlot.resize(m_Particles.size());
+	for (uint32_t i = 0; i < GetParticleCount(); ++i)
+	{
+		m_ParticleIds[i] = i;
+		m_IdToSlot[i] = i;
+	}
+	m_StepCount = 0;
+	m_SimulatedTime = 0.0;
+	m_PrevDeltaTime = 0.0f;
+	m_DFSPHKappa.clear();
+	m_DFSPHKappaV.clear();
+	m_NeighborListValid = false;
+}
+
+uint32_t CPUFluidSolver::AddParticles(const std::vector<Particle>& particles)
+{
+	uint32_t firstSlot = GetParticleCount();
+	uint32_t firstId = static_cast<uint32_t>(m_IdToSlot.size());
+	uint32_t addCount = static_cast<uint32_t>(particles.size());
+	ReserveParticleCapacity(firstSlot + addCount);
+
+	// 末尾に追加し、まだ使われていないIDを振る
+	m_Particles.insert(m_Particles.end(), particles.begin(), particles.end());
+	ResizeParticleArrays();
+	m_IdToSlot.resize(firstId + addCount);
+	for (uint32_t i = 0; i < addCount; ++i)
+	{
+		m_ParticleIds[firstSlot + i] = firstId + i;
+		m_IdToSlot[firstId + i] = firstSlot + i;
+	}
+	m_NeighborListValid = false;
+	return firstId;
+}
+
+void CPUFluidSolver::RemoveParticles(const std::vector<uint32_t>& particleIds)
+{
+	if (particleIds.empty())
+	{
+		return;
+	}
+
+	// 削除する粒子のスロットに印を付ける (m_ParticleCellを一時的に使う)
+	const uint32_t particleCount = GetParticleCount();
+	std::fill(m_ParticleCell.begin(), m_ParticleCell.end(), 1u);
+	for (uint32_t particleId : particleIds)
+	{
+		uint32_t slot = GetParticleSlot(particleId);
+		if (slot != InvalidSlot)
+		{
+			m_ParticleCell[slot] = 0;
+			m_IdToSlot[particleId] = InvalidSlot;
+		}
+	}
+
+	// 残る粒子の書き込み先 (順番は保ったまま詰める)
+	uint32_t aliveCount = m_pThreadPool->ExclusiveScan(particleCount,
+		[&](uint32_t slot) { return m_ParticleCell[slot]; },
+		m_ParticleRank.data());
+	m_pThreadPool->ParallelFor(0, particleCount, GroupSize * 16, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			if (m_ParticleCell[slot] == 0)
+			{
+				continue;
+			}
+			uint32_t dst = m_ParticleRank[slot];
+			uint32_t particleId = m_ParticleIds[slot];
+			m_SortedParticles[dst] = m_Particles[slot];
+			m_SortedIds[dst] = particleId;
+			m_IdToSlot[particleId] = dst;
+		}
+	});
+	m_Particles.swap(m_SortedParticles);
+	m_ParticleIds.swap(m_SortedIds);
+
+	// 容量はそのままで、以降のパスは生きている粒子だけを処理する
+	m_Particles.resize(aliveCount);
+	ResizeParticleArrays();
+	m_NeighborListValid = false;
+}
+
+void CPUFluidSolver::ReserveParticleCapacity(uint32_t particleCount)
+{
+	if (particleCount <= m_ParticleCapacity)
+	{
+		return;
+	}
+	// エミッターで少しずつ増える場合も確保し直しが O(log n) 回で済むよう、1.5倍ずつ拡張する
+	uint32_t capacity = std::max(particleCount, m_ParticleCapacity + m_ParticleCapacity / 2);
+	m_Particles.reserve(capacity);
+	m_SortedParticles.reserve(capacity);
+	m_GridNext.reserve(capacity);
+	m_ParticleCell.reserve(capacity);
+	m_ParticleRank.reserve(capacity);
+	m_ParticleIds.reserve(capacity);
+	m_SortedIds.reserve(capacity);
+	m_ParticleCapacity = capacity;
+	++m_ParticleReallocationCount;
+}
+
+void CPUFluidSolver::ResizeParticleArrays()
+{
+	const uint32_t particleCount = GetParticleCount();
+	m_GridNext.resize(particleCount, -1);
+	m_ParticleCell.resize(particleCount);
+	m_ParticleRank.resize(particleCount);
+	m_SortedParticles.resize(particleCount);
+	m_ParticleIds.resize(particleCount);
+	m_SortedIds.resize(particleCount);
+	m_SoA.Resize(particleCount);
+	m_SimParam.ParticleCount = particleCount;
+}
+
+void CPUFluidSolver::CopyParticlesInIdOrder(std::vector<Particle>& dst) const
+{
+	dst.resize(m_Particles.size());
+	const uint32_t idCount = static_cast<uint32_t>(m_IdToSlot.size());
+	if (idCount == GetParticleCount())
+	{
+		// 削除された粒子がない場合はIDがそのまま書き込み先になる
+		m_pThreadPool->ParallelFor(0, idCount, GroupSize * 16, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t id = begin; id < end; ++id)
+			{
+				dst[id] = m_Particles[m_IdToSlot[id]];
+			}
+		});
+		return;
+	}
+
+	// 削除済みのIDを飛ばして詰める
+	std::vector<uint32_t> dstIndex(idCount);
+	m_pThreadPool->ExclusiveScan(idCount,
+		[&](uint32_t id) { return m_IdToSlot[id] != InvalidSlot ? 1u : 0u; },
+		dstIndex.data());
+	m_pThreadPool->ParallelFor(0, idCount, GroupSize * 16, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			if (m_IdToSlot[id] != InvalidSlot)
+			{
+				dst[dstIndex[id]] = m_Particles[m_IdToSlot[id]];
+			}
+		}
+	});
+}
+
+uint64_t CPUFluidSolver::ComputeStateHash() const
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (uint32_t slot : m_IdToSlot)
+	{
+		if (slot == InvalidSlot)
+		{
+			continue;
+		}
+		const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(&m_Particles[slot]);
+		for (size_t i = 0; i < sizeof(Particle); ++i)
+		{
+			hash = (hash ^ pBytes[i]) * 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+void CPUFluidSolver::CaptureCheckpoint(CheckpointSnapshot& snapshot) const
+{
+	const uint32_t count = GetParticleCount();
+	CheckpointHeader& header = snapshot.Header;
+	header.Param = m_SimParam;
+	header.IdCount = static_cast<uint32_t>(m_IdToSlot.size());
+	header.StepCount = m_StepCount;
+	header.SimulatedTime = m_SimulatedTime;
+	header.PrevDeltaTime = m_PrevDeltaTime;
+
+	// 並べ替えの順番 (スロット順) のまま写し、ID -> スロットは読み込む時に作り直す
+	snapshot.Particles.resize(count);
+	snapshot.ParticleIds.resize(count);
+	m_pThreadPool->ParallelFor(0, count, GroupSize * 16, [&](uint32_t begin, uint32_t end)
+	{
+		std::copy(m_Particles.begin() + begin, m_Particles.begin() + end, snapshot.Particles.begin() + begin);
+		std::copy(m_ParticleIds.begin() + begin, m_ParticleIds.begin() + end, snapshot.ParticleIds.begin() + begin);
+	});
+
+	// ウォームスタートのκは、前のステップ以降に粒子が追加されていない場合だけ保存する
+	if (m_PressureSolver == PressureSolverMode::DFSPH && m_DFSPHKappa.size() == header.IdCount && m_DFSPHKappaV.size() == header.IdCount)
+	{
+		snapshot.Kappa.assign(m_DFSPHKappa.begin(), m_DFSPHKappa.end());
+		snapshot.KappaV.assign(m_DFSPHKappaV.begin(), m_DFSPHKappaV.end());
+	}
+	else
+	{
+		snapshot.Kappa.clear();
+		snapshot.KappaV.clear();
+	}
+}
+
+void CPUFluidSolver::RestoreCheckpoint(const CheckpointFile& file)
+{
+	assert(file.IsOpen());
+	const CheckpointHeader& header = file.GetHeader();
+	const uint32_t count = header.ParticleCount;
+	const Particle* pParticles = file.GetParticles();
+	const uint32_t* pParticleIds = file.GetParticleIds();
+
+	// resize は書き込まないので、最初に書き込むのは下のコピー (NUMA配置では持ち主のスレッド)
+	ReserveParticleCapacity(count);
+	m_Particles.resize(count);
+	ResizeParticleArrays();
+	SetSimulationParam(header.Param);
+	ParallelForSlots(count, [&](uint32_t begin, uint32_t end)
+	{
+		std::copy(pParticles + begin, pParticles + end, m_Particles.begin() + begin);
+		std::copy(pParticleIds + begin, pParticleIds + end, m_ParticleIds.begin() + begin);
+		std::fill(m_GridNext.begin() + begin, m_GridNext.begin() + end, -1);
+	});
+
+	// ID の範囲と重複は CheckpointFile::Open で検証済み
+	// assign は値を参照で受けるので、定義のない static const のメンバーを直接渡さない (最適化なしのビルドでリンクできない)
+	const uint32_t invalidSlot = InvalidSlot;
+	m_IdToSlot.assign(header.IdCount, invalidSlot);
+	for (uint32_t slot = 0; slot < count; ++slot)
+	{
+		assert(pParticleIds[slot] < header.IdCount);
+		m_IdToSlot[pParticleIds[slot]] = slot;
+	}
+
+	m_StepCount = header.StepCount;
+	m_SimulatedTime = header.SimulatedTime;
+	m_PrevDeltaTime = header.PrevDeltaTime;
+	if (header.KappaCount > 0)
+	{
+		m_DFSPHKappa.assign(file.GetKappa(), file.GetKappa() + header.KappaCount);
+		m_DFSPHKappaV.assign(file.GetKappaV(), file.GetKappaV() + header.KappaCount);
+	}
+	else
+	{
+		m_DFSPHKappa.clear();
+		m_DFSPHKappaV.clear();
+	}
+	m_NeighborListValid = false;
+}
+
+void CPUFluidSolver::Step()
+{
+	assert(IsGridBuildModeCompatible() && "settings are not usable with this grid (see GetGridBuildModeConflict)");
+	EnsureGridCapacity();
+	if (m_UseNumaPlacement)
+	{
+		UpdateNumaPlacement();
+	}
+
+	// 近傍リストは粒子が skin/2 以上動いた時だけ作り直す
+	bool useNeighborList = m_NeighborListSkin > 0.0f;
+	bool rebuildNeighborList = useNeighborList && NeedsNeighborListRebuild();
+
+	auto start = Clock::now();
+	m_Timings.Reorder = 0.0;
+	if (m_ReorderInterval != 0 && m_StepCount % m_ReorderInterval == 0)
+	{
+		ReorderParticles();
+		m_Timings.Reorder = ElapsedMilliseconds(start);
+		// スロットが変わるのでリストも作り直す
+		rebuildNeighborList = useNeighborList;
+	}
+	++m_StepCount;
+
+	if (m_PressureSolver == PressureSolverMode::DFSPH)
+	{
+		RecordTimestep(StepDFSPH());
+		return;
+	}
+	if (m_PressureSolver == PressureSolverMode::PBF)
+	{
+		RecordTimestep(StepPBF());
+		return;
+	}
+	m_Timings.DivergenceSolve = 0.0;
+	m_Timings.PressureSolve = 0.0;
+
+	m_Timings.GridClear = 0.0;
+	m_Timings.GridBuild = 0.0;
+	m_Timings.NeighborList = 0.0;
+	if (!useNeighborList || rebuildNeighborList)
+	{
+		start = Clock::now();
+		ClearGrid();
+		m_Timings.GridClear = ElapsedMilliseconds(start);
+
+		// 区間の引き直しはグリッド構築の時間に含める
+		start = Clock::now();
+		BuildGrid();
+		if (m_WorkSchedule == WorkSchedule::MortonPartition && m_GridBuildMode == GridBuildMode::CountingSort)
+		{
+			UpdateWorkPartitions();
+		}
+		m_Timings.GridBuild = ElapsedMilliseconds(start);
+	}
+	// 境界粒子の並べ直し (入力が変わった時だけ) もグリッド構築の時間に含める
+	if (m_BoundaryMode == BoundaryMode::Particles)
+	{
+		start = Clock::now();
+		UpdateBoundaryParticles();
+		m_Timings.GridBuild += ElapsedMilliseconds(start);
+	}
+	if (rebuildNeighborList)
+	{
+		// 密度もリスト構築と同じ走査で求める
+		start = Clock::now();
+		BuildNeighborList();
+		m_Timings.NeighborList = ElapsedMilliseconds(start);
+	}
+
+	// SoAカーネルと対称な力の計算はセル内の粒子が連続している時だけ使える
+	bool useSoA = !useNeighborList && m_UseSoAKernels && m_GridBuildMode == GridBuildMode::CountingSort;
+	bool useSymmetricForce = !useNeighborList && m_UseSymmetricForce && !m_Deterministic && m_GridBuildMode == GridBuildMode::CountingSort;
+	bool useCompact = !useNeighborList && !useSoA && m_UseCompactStorage;
+
+	m_ThreadWorkMilliseconds.assign(GetThreadCount(), 0.0);
+	m_ThreadWorkParticles.assign(GetThreadCount(), 0);
+	m_UsedWorkPartitions = false;
+
+	m_Timings.Density = 0.0;
+	start = Clock::now();
+	if (rebuildNeighborList)
+	{
+		// BuildNeighborList で計算済み
+	}
+	else if (useNeighborList)
+	{
+		ComputeDensityNeighborList();
+	}
+	else if (useSoA)
+	{
+		ComputeDensitySoA();
+	}
+	else if (useCompact)
+	{
+		ComputeDensityCompact();
+	}
+	else
+	{
+		ComputeDensity();
+	}
+	if (m_BoundaryMode == BoundaryMode::Particles)
+	{
+		AddBoundaryDensity(useSoA, useCompact);
+	}
+	m_Timings.Density = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	if (useNeighborList)
+	{
+		ComputeForceNeighborList();
+	}
+	else if (useSymmetricForce)
+	{
+		ComputeForceSymmetric();
+	}
+	else if (useSoA)
+	{
+		ComputeForceSoA();
+	}
+	else if (useCompact)
+	{
+		ComputeForceCompact();
+	}
+	else
+	{
+		ComputeForce();
+	}
+	if (m_BoundaryMode == BoundaryMode::Particles)
+	{
+		AddBoundaryForce();
+	}
+	m_Timings.Force = ElapsedMilliseconds(start);
+	UpdateLoadBalanceStats();
+
+	// 適応時間刻みのリダクションは積分の時間に含める
+	start = Clock::now();
+	float deltaTime = m_UseAdaptiveTimestep ? ComputeAdaptiveTimestep() : m_SimParam.DeltaTime;
+	Integrate(deltaTime);
+	m_Timings.Integrate = ElapsedMilliseconds(start);
+
+	RecordTimestep(deltaTime);
+}
+
+void CPUFluidSolver::RecordTimestep(float deltaTime)
+{
+	m_SimulatedTime += deltaTime;
+	m_TimestepStats.DeltaTime = deltaTime;
+	m_TimestepStats.MinDeltaTime = (m_TimestepStats.Substeps == 0) ? deltaTime : std::min(m_TimestepStats.MinDeltaTime, deltaTime);
+	m_TimestepStats.MaxDeltaTime = std::max(m_TimestepStats.MaxDeltaTime, deltaTime);
+	m_TimestepStats.SimulatedTime += deltaTime;
+	++m_TimestepStats.Substeps;
+	if (!m_UseAdaptiveTimestep)
+	{
+		m_TimestepStats.Limit = TimestepLimit::Fixed;
+	}
+	++m_TimestepStats.LimitCounts[static_cast<int>(m_TimestepStats.Limit)];
+}
+
+uint32_t CPUFluidSolver::AdvanceFrame(float frameTime)
+{
+	m_TimestepStats = {};
+	if (!m_UseAdaptiveTimestep)
+	{
+		// FluidStage と同じく固定の DeltaTime で進める
+		uint32_t stepCount = std::max(1u, static_cast<uint32_t>(std::lround(frameTime / m_SimParam.DeltaTime)));
+		for (uint32_t i = 0; i < stepCount; ++i)
+		{
+			Step();
+		}
+		return stepCount;
+	}
+
+	// 最後のステップで丁度 frameTime になるよう、残り時間を dt の上限にする
+	const float epsilon = frameTime * 1.0e-5f;
+	float remaining = frameTime;
+	while (remaining > epsilon && m_TimestepStats.Substeps < m_AdaptiveTimestepParam.MaxSubsteps)
+	{
+		m_StepTimeLimit = remaining;
+		Step();
+		remaining -= m_TimestepStats.DeltaTime;
+	}
+	m_StepTimeLimit = 0.0f;
+	return m_TimestepStats.Substeps;
+}
+
+void CPUFluidSolver::EnsureGridCapacity()
+{
+	// Hが小さくなった場合のみ確保し直す (FluidStageのm_MaxGridCountと同じ考え方)
+	if (m_GridBuildMode == GridBuildMode::LinkedList)
+	{
+		if (m_TotalGridCount > m_GridHeadCapacity)
+		{
+			m_GridHead = std::make_unique<std::atomic<int32_t>[]>(m_TotalGridCount);
+			m_GridHeadCapacity = m_TotalGridCount;
+		}
+	}
+
+	uint32_t bucketCount = 0;
+	if (m_GridBuildMode == GridBuildMode::CountingSort || m_ReorderInterval != 0)
+	{
+		// 末尾にグリッド外の粒子用セルを1つ追加
+		bucketCount = m_TotalGridCount + 1;
+	}
+	if (m_GridBuildMode == GridBuildMode::SpatialHash)
+	{
+		// 空のセルにはバケットを割り当てないので、テーブルは粒子数の2倍 (2のべき乗) あれば衝突は少ない
+		uint32_t hashBucketCount = 64;
+		while (hashBucketCount < GetParticleCount() * 2)
+		{
+			hashBucketCount *= 2;
+		}
+		m_HashBucketCount = hashBucketCount;
+		m_ParticleCellKey.resize(GetParticleCount());
+		bucketCount = std::max(bucketCount, m_HashBucketCount);
+	}
+	if (bucketCount > m_CellCountCapacity)
+	{
+		m_CellCount = std::make_unique<std::atomic<uint32_t>[]>(bucketCount);
+		m_CellCountCapacity = bucketCount;
+	}
+	if (bucketCount + 1 > m_CellStart.size())
+	{
+		m_CellStart.resize(bucketCount + 1);
+	}
+}
+
+// FluidGridClearCS.hlsl
+void CPUFluidSolver::ClearGrid()
+{
+	if (m_GridBuildMode == GridBuildMode::CountingSort)
+	{
+		ClearCellCount(m_TotalGridCount + 1);
+		return;
+	}
+	if (m_GridBuildMode == GridBuildMode::SpatialHash)
+	{
+		// 箱の体積ではなく粒子数に比例
+		ClearCellCount(m_HashBucketCount);
+		return;
+	}
+
+	m_pThreadPool->ParallelFor(0, m_TotalGridCount, GroupSize * 64, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			m_GridHead[i].store(-1, std::memory_order_relaxed);
+		}
+	});
+}
+
+void CPUFluidSolver::ClearCellCount(uint32_t bucketCount)
+{
+	if (m_UseNumaPlacement && !m_OwnedCellStart.empty())
+	{
+		// ページを置いた時と同じ持ち分を書き込む
+		m_pThreadPool->Dispatch([&](uint32_t threadIndex)
+		{
+			uint32_t end = std::min(m_OwnedCellStart[threadIndex + 1], bucketCount);
+			for (uint32_t i = std::min(m_OwnedCellStart[threadIndex], bucketCount); i < end; ++i)
+			{
+				m_CellCount[i].store(0, std::memory_order_relaxed);
+			}
+		});
+		return;
+	}
+	m_pThreadPool->ParallelFor(0, bucketCount, GroupSize * 64, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			m_CellCount[i].store(0, std::memory_order_relaxed);
+		}
+	});
+}
+
+void CPUFluidSolver::BuildGrid()
+{
+	if (m_GridBuildMode == GridBuildMode::CountingSort)
+	{
+		BuildGridCountingSort();
+	}
+	else if (m_GridBuildMode == GridBuildMode::SpatialHash)
+	{
+		BuildGridSpatialHash();
+	}
+	else
+	{
+		BuildGridLinkedList();
+	}
+}
+
+// FluidGridBuildCS.hlsl
+void CPUFluidSolver::BuildGridLinkedList()
+{
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			// 自分がどのグリッドにいるかどうか計算
+			auto gridPos = SPHCommon::GetGridPos(m_Particles[id].Position, m_SimParam.WallMin, m_GridCellSize);
+			int gridIndex = SPHCommon::GetGridIndex(gridPos, m_GridDim);
+
+			// リンクリストへの挿入 (InterlockedExchange 相当)
+			if (gridIndex != -1)
+			{
+				m_GridNext[id] = m_GridHead[gridIndex].exchange(static_cast<int32_t>(id), std::memory_order_relaxed);
+			}
+			else
+			{
+				m_GridNext[id] = -1;
+			}
+		}
+	});
+}
+
+template<typename BucketFunc>
+void CPUFluidSolver::CountingSortParticles(uint32_t bucketCount, BucketFunc&& bucketOf)
+{
+	// 1. カウント: バケット毎の粒子数と、バケット内での自分の順番を記録
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			uint32_t bucket = bucketOf(slot);
+			m_ParticleCell[slot] = bucket;
+			m_ParticleRank[slot] = m_CellCount[bucket].fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	// 2. プレフィックスサム: バケットの開始位置
+	m_CellStart[bucketCount] = m_pThreadPool->ExclusiveScan(bucketCount,
+		[&](uint32_t bucket) { return m_CellCount[bucket].load(std::memory_order_relaxed); },
+		m_CellStart.data());
+	m_SortedBucketCount = bucketCount;
+
+	// 3. スキャッタ: バケット順に並べ替え、IDの対応も移す
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			uint32_t dst = m_CellStart[m_ParticleCell[slot]] + m_ParticleRank[slot];
+			uint32_t particleId = m_ParticleIds[slot];
+			m_SortedParticles[dst] = m_Particles[slot];
+			m_SortedIds[dst] = particleId;
+			m_IdToSlot[particleId] = dst;
+		}
+	});
+	m_Particles.swap(m_SortedParticles);
+	m_ParticleIds.swap(m_SortedIds);
+
+	if (m_Deterministic)
+	{
+		SortBucketsById(bucketCount);
+	}
+}
+
+void CPUFluidSolver::SortBucketsById(uint32_t bucketCount)
+{
+	m_pThreadPool->ParallelFor(0, bucketCount, GroupSize * 16, [&](uint32_t beginBucket, uint32_t endBucket)
+	{
+		std::vector<uint32_t> order;
+		for (uint32_t bucket = beginBucket; bucket < endBucket; ++bucket)
+		{
+			const uint32_t begin = m_CellStart[bucket];
+			const uint32_t end = m_CellStart[bucket + 1];
+			if (end - begin <= 32)
+			{
+				// セル内の粒子は少ないので挿入ソート (前のステップと同じ順番なら入れ替えは起きない)
+				for (uint32_t slot = begin + 1; slot < end; ++slot)
+				{
+					const Particle particle = m_Particles[slot];
+					const uint32_t particleId = m_ParticleIds[slot];
+					uint32_t dst = slot;
+					while (dst > begin && m_ParticleIds[dst - 1] > particleId)
+					{
+						m_Particles[dst] = m_Particles[dst - 1];
+						m_ParticleIds[dst] = m_ParticleIds[dst - 1];
+						--dst;
+					}
+					m_Particles[dst] = particle;
+					m_ParticleIds[dst] = particleId;
+				}
+			}
+			else
+			{
+				// グリッド外の粒子のバケットなどは大きくなりうるので、IDの順番を求めてからスキャッタ先経由で並べる
+				order.resize(end - begin);
+				for (uint32_t i = 0; i < end - begin; ++i)
+				{
+					order[i] = begin + i;
+				}
+				std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return m_ParticleIds[a] < m_ParticleIds[b]; });
+				for (uint32_t i = 0; i < end - begin; ++i)
+				{
+					m_SortedParticles[begin + i] = m_Particles[order[i]];
+					m_SortedIds[begin + i] = m_ParticleIds[order[i]];
+				}
+				std::copy(m_SortedParticles.begin() + begin, m_SortedParticles.begin() + end, m_Particles.begin() + begin);
+				std::copy(m_SortedIds.begin() + begin, m_SortedIds.begin() + end, m_ParticleIds.begin() + begin);
+			}
+			for (uint32_t slot = begin; slot < end; ++slot)
+			{
+				m_IdToSlot[m_ParticleIds[slot]] = slot;
+			}
+		}
+	});
+}
+
+void CPUFluidSolver::BuildGridCountingSort()
+{
+	// セル毎のカウントはClearGridで0にしてあるので、ここではそのまま並べ替える
+	const uint32_t outsideCell = m_TotalGridCount;
+	CountingSortParticles(m_TotalGridCount + 1, [&](uint32_t slot)
+	{
+		auto gridPos = SPHCommon::GetGridPos(m_Particles[slot].Position, m_SimParam.WallMin, m_GridCellSize);
+		int gridIndex = SPHCommon::GetGridIndex(gridPos, m_GridDim);
+		return (gridIndex == -1) ? outsideCell : static_cast<uint32_t>(gridIndex);
+	});
+}
+
+void CPUFluidSolver::BuildGridSpatialHash()
+{
+	// バケット毎のカウントはClearGridで0にしてある
+	CountingSortParticles(m_HashBucketCount, [&](uint32_t slot)
+	{
+		auto gridPos = SPHCommon::GetGridPos(m_Particles[slot].Position, m_SimParam.WallMin, m_GridCellSize);
+		return SPHCommon::HashGridPos(gridPos, m_HashBucketCount);
+	});
+
+	// 並べ替え後のスロット順にセルキーを記録 (同じバケットに入った別のセルの粒子を区別する)
+	m_pThreadPool->ParallelFor(0, GetParticleCount(), GroupSize * 16, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			auto gridPos = SPHCommon::GetGridPos(m_Particles[slot].Position, m_SimParam.WallMin, m_GridCellSize);
+			m_ParticleCellKey[slot] = SPHCommon::GetCellKey(gridPos);
+		}
+	});
+}
+
+void CPUFluidSolver::UpdateCellMortonRank()
+{
+	if (m_CellMortonRank.size() == m_TotalGridCount &&
+		m_MortonGridDim.x == m_GridDim.x && m_MortonGridDim.y == m_GridDim.y && m_MortonGridDim.z == m_GridDim.z)
+	{
+		return;
+	}
+
+	// グリッドの次元が変わった時だけ、全セルをMorton符号でソートして順位を作り直す
+	std::vector<std::pair<uint64_t, uint32_t>> codes(m_TotalGridCount);
+	m_pThreadPool->ParallelFor(0, m_TotalGridCount, GroupSize * 64, [&](uint32_t begin, uint32_t end)
+	{
+		uint32_t sliceSize = static_cast<uint32_t>(m_GridDim.x * m_GridDim.y);
+		for (uint32_t cell = begin; cell < end; ++cell)
+		{
+			uint32_t x = cell % m_GridDim.x;
+			uint32_t y = (cell % sliceSize) / m_GridDim.x;
+			uint32_t z = cell / sliceSize;
+			codes[cell] = { Morton::Encode3D(x, y, z), cell };
+		}
+	});
+	std::sort(codes.begin(), codes.end());
+
+	m_CellMortonRank.resize(m_TotalGridCount);
+	m_MortonCells.resize(m_TotalGridCount);
+	for (uint32_t rank = 0; rank < m_TotalGridCount; ++rank)
+	{
+		m_CellMortonRank[codes[rank].second] = rank;
+		m_MortonCells[rank] = codes[rank].second;
+	}
+	m_MortonGridDim = m_GridDim;
+	m_CellCost.assign(m_TotalGridCount, 1.0f);
+}
+
+void CPUFluidSolver::UpdateWorkPartitions()
+{
+	UpdateCellMortonRank();
+	const uint32_t partitionCount = GetThreadCount();
+	const uint32_t cellCount = m_TotalGridCount;
+	auto cellWeight = [&](uint32_t rank)
+	{
+		uint32_t cell = m_MortonCells[rank];
+		return (m_CellStart[cell + 1] - m_CellStart[cell]) * static_cast<double>(m_CellCost[rank]);
+	};
+
+	double totalWeight = 0.0;
+	for (uint32_t rank = 0; rank < cellCount; ++rank)
+	{
+		totalWeight += cellWeight(rank);
+	}
+
+	// 重みの累積が p / partitionCount を超えたセルの次から区間pを始める
+	m_PartitionStart.assign(partitionCount + 1, cellCount);
+	m_PartitionStart[0] = 0;
+	uint32_t partition = 1;
+	double accumulated = 0.0;
+	for (uint32_t rank = 0; rank < cellCount && partition < partitionCount; ++rank)
+	{
+		accumulated += cellWeight(rank);
+		while (partition < partitionCount && accumulated >= totalWeight * partition / partitionCount)
+		{
+			m_PartitionStart[partition++] = rank + 1;
+		}
+	}
+}
+
+void CPUFluidSolver::ParallelForParticles(const std::function<void(uint32_t, uint32_t)>& func)
+{
+	const uint32_t particleCount = GetParticleCount();
+	bool usePartitions = m_WorkSchedule == WorkSchedule::MortonPartition &&
+		m_GridBuildMode == GridBuildMode::CountingSort &&
+		m_PartitionStart.size() == GetThreadCount() + 1;
+	if (m_UseNumaPlacement || m_WorkSchedule == WorkSchedule::Static)
+	{
+		m_pThreadPool->Dispatch([&](uint32_t threadIndex)
+		{
+			uint32_t threadCount = GetThreadCount();
+			uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(particleCount) * threadIndex / threadCount);
+			uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(particleCount) * (threadIndex + 1) / threadCount);
+			if (m_UseNumaPlacement)
+			{
+				// NUMA配置では持ち分の区間 (ページを置いたノードのスレッドが処理する)
+				GetOwnedSlotRange(threadIndex, particleCount, begin, end);
+			}
+			double start = WorkMilliseconds();
+			if (begin < end)
+			{
+				func(begin, end);
+			}
+			m_ThreadWorkMilliseconds[threadIndex] += WorkMilliseconds() - start;
+			m_ThreadWorkParticles[threadIndex] += end - begin;
+		});
+		return;
+	}
+	if (!usePartitions)
+	{
+		m_pThreadPool->ParallelForWithThreadIndex(0, particleCount, GroupSize, [&](uint32_t threadIndex, uint32_t begin, uint32_t end)
+		{
+			double start = WorkMilliseconds();
+			func(begin, end);
+			m_ThreadWorkMilliseconds[threadIndex] += WorkMilliseconds() - start;
+			m_ThreadWorkParticles[threadIndex] += end - begin;
+		});
+		return;
+	}
+
+	m_UsedWorkPartitions = true;
+	m_pThreadPool->Dispatch([&](uint32_t threadIndex)
+	{
+		double start = WorkMilliseconds();
+		uint32_t processedCount = 0;
+		auto run = [&](uint32_t begin, uint32_t end)
+		{
+			if (begin < end)
+			{
+				func(begin, end);
+				processedCount += end - begin;
+			}
+		};
+
+		// 区間のセルを順に渡す (スロットが前のセルから続いている場合はまとめる)
+		uint32_t rangeBegin = 0;
+		uint32_t rangeEnd = 0;
+		for (uint32_t rank = m_PartitionStart[threadIndex]; rank < m_PartitionStart[threadIndex + 1]; ++rank)
+		{
+			uint32_t cell = m_MortonCells[rank];
+			uint32_t cellBegin = m_CellStart[cell];
+			uint32_t cellEnd = m_CellStart[cell + 1];
+			if (cellBegin == cellEnd)
+			{
+				continue;
+			}
+			if (cellBegin != rangeEnd)
+			{
+				run(rangeBegin, rangeEnd);
+				rangeBegin = cellBegin;
+			}
+			rangeEnd = cellEnd;
+		}
+		run(rangeBegin, rangeEnd);
+		// グリッド外の粒子は最後のスレッドが処理する
+		if (threadIndex + 2 == m_PartitionStart.size())
+		{
+			run(m_CellStart[m_TotalGridCount], particleCount);
+		}
+
+		m_ThreadWorkMilliseconds[threadIndex] += WorkMilliseconds() - start;
+		m_ThreadWorkParticles[threadIndex] += processedCount;
+	});
+}
+
+void CPUFluidSolver::UpdateLoadBalanceStats()
+{
+	LoadBalanceStats& stats = m_LoadBalanceStats;
+	stats.ThreadMilliseconds = m_ThreadWorkMilliseconds;
+	stats.ThreadParticles = m_ThreadWorkParticles;
+	double totalMilliseconds = 0.0;
+	double maxMilliseconds = 0.0;
+	uint64_t totalParticles = 0;
+	uint32_t maxParticles = 0;
+	for (size_t thread = 0; thread < m_ThreadWorkMilliseconds.size(); ++thread)
+	{
+		totalMilliseconds += m_ThreadWorkMilliseconds[thread];
+		maxMilliseconds = std::max(maxMilliseconds, m_ThreadWorkMilliseconds[thread]);
+		totalParticles += m_ThreadWorkParticles[thread];
+		maxParticles = std::max(maxParticles, m_ThreadWorkParticles[thread]);
+	}
+	const double threadCount = static_cast<double>(std::max<size_t>(1, m_ThreadWorkMilliseconds.size()));
+	stats.Imbalance = (totalMilliseconds > 0.0) ? static_cast<float>(maxMilliseconds * threadCount / totalMilliseconds) : 1.0f;
+	stats.ParticleImbalance = (totalParticles > 0) ? static_cast<float>(maxParticles * threadCount / totalParticles) : 1.0f;
+
+	if (!m_UsedWorkPartitions || totalParticles == 0 || totalMilliseconds <= 0.0)
+	{
+		return;
+	}
+	// 区間毎の粒子1個当たりの時間の平均との比を、区間内のセルのコストに半分ずつ混ぜる (計測のばらつきで区切りが振動しないように)
+	const double meanRate = totalMilliseconds / totalParticles;
+	for (uint32_t partition = 0; partition + 1 < m_PartitionStart.size(); ++partition)
+	{
+		if (m_ThreadWorkParticles[partition] == 0)
+		{
+			continue;
+		}
+		double rate = m_ThreadWorkMilliseconds[partition] / m_ThreadWorkParticles[partition];
+		float relativeCost = static_cast<float>(std::clamp(rate / meanRate, 0.25, 4.0));
+		for (uint32_t rank = m_PartitionStart[partition]; rank < m_PartitionStart[partition + 1]; ++rank)
+		{
+			m_CellCost[rank] = 0.5f * (m_CellCost[rank] + relativeCost);
+		}
+	}
+}
+
+bool CPUFluidSolver::SetDeterministicEnabled(bool enabled)
+{
+	m_Deterministic = enabled;
+	// リンクリストのままでは決定的にならない (後からリンクリストを指定した場合は SetGridBuildMode が false を返す)
+	if (enabled && m_GridBuildMode == GridBuildMode::LinkedList)
+	{
+		m_GridBuildMode = GridBuildMode::CountingSort;
+	}
+	return IsGridBuildModeCompatible();
+}
+
+bool CPUFluidSolver::SetNumaPlacementEnabled(bool enabled)
+{
+	if (enabled)
+	{
+		m_NumaTopology = NumaTopology::Detect();
+		std::vector<uint32_t> threadCpus;
+		m_NumaTopology.AssignThreads(GetThreadCount(), threadCpus, m_ThreadNodes);
+		m_pThreadPool->PinThreads(threadCpus);
+		// 今の配列のページは呼び出しスレッドが書き込んだものなので、次のステップで置き直す
+		m_pPlacedParticles = nullptr;
+		m_pPlacedCells = nullptr;
+	}
+	else if (m_UseNumaPlacement)
+	{
+		m_pThreadPool->PinThreads({});
+	}
+	m_UseNumaPlacement = enabled;
+	return IsGridBuildModeCompatible();
+}
+
+void CPUFluidSolver::GetOwnedSlotRange(uint32_t threadIndex, uint32_t count, uint32_t& begin, uint32_t& end) const
+{
+	const uint64_t chunkCount = (count + GroupSize - 1) / GroupSize;
+	const uint32_t threadCount = GetThreadCount();
+	begin = static_cast<uint32_t>(std::min<uint64_t>(count, chunkCount * threadIndex / threadCount * GroupSize));
+	end = static_cast<uint32_t>(std::min<uint64_t>(count, chunkCount * (threadIndex + 1) / threadCount * GroupSize));
+}
+
+void CPUFluidSolver::ParallelForSlots(uint32_t count, const std::function<void(uint32_t, uint32_t)>& func)
+{
+	if (!m_UseNumaPlacement)
+	{
+		m_pThreadPool->ParallelFor(0, count, GroupSize, func);
+		return;
+	}
+	m_pThreadPool->Dispatch([&](uint32_t threadIndex)
+	{
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		GetOwnedSlotRange(threadIndex, count, begin, end);
+		for (uint32_t chunkBegin = begin; chunkBegin < end; chunkBegin += GroupSize)
+		{
+			func(chunkBegin, std::min(end, chunkBegin + GroupSize));
+		}
+	});
+}
+
+template<typename Array>
+void CPUFluidSolver::PlaceArray(Array& array, size_t capacity, const std::vector<uint32_t>* pOwnedStart)
+{
+	const uint32_t size = static_cast<uint32_t>(array.size());
+	capacity = std::max(capacity, array.size());
+	Array placed;
+	placed.reserve(capacity);
+	placed.resize(capacity); // 要素はトリビアルな型なので、まだページに書き込まない
+
+	const uint32_t threadCount = GetThreadCount();
+	m_pThreadPool->Dispatch([&](uint32_t threadIndex)
+	{
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		if (pOwnedStart != nullptr)
+		{
+			begin = std::min((*pOwnedStart)[threadIndex], size);
+			end = (threadIndex + 1 == threadCount) ? size : std::min((*pOwnedStart)[threadIndex + 1], size);
+		}
+		else
+		{
+			GetOwnedSlotRange(threadIndex, size, begin, end);
+		}
+		std::copy(array.begin() + begin, array.begin() + end, placed.begin() + begin);
+		// 要素数より後ろの容量 (粒子が増えた時に使う) も等分して書き込んでおく
+		size_t spare = capacity - size;
+		size_t spareBegin = size + spare * threadIndex / threadCount;
+		size_t spareEnd = size + spare * (threadIndex + 1) / threadCount;
+		std::fill(placed.begin() + spareBegin, placed.begin() + spareEnd, typename Array::value_type());
+	});
+	placed.resize(size);
+	array.swap(placed);
+}
+
+void CPUFluidSolver::UpdateNumaPlacement()
+{
+	// m_Particles と m_SortedParticles はグリッド構築毎に入れ替わるので、どちらの順でも置いた時と同じ組なら確保し直されていない
+	const uint32_t particleCount = GetParticleCount();
+	const void* pParticles = std::min<const void*>(m_Particles.data(), m_SortedParticles.data());
+	uint32_t drift = (particleCount > m_PlacedParticleCount) ? particleCount - m_PlacedParticleCount : m_PlacedParticleCount - particleCount;
+	// 粒子数が置いた時から1/8以上変わった場合も、持ち分の区間がずれるので置き直す
+	bool placeParticles = pParticles != m_pPlacedParticles || drift * 8 > m_PlacedParticleCount;
+	if (placeParticles)
+	{
+		PlaceArray(m_Particles, m_ParticleCapacity);
+		PlaceArray(m_SortedParticles, m_ParticleCapacity);
+		PlaceArray(m_GridNext, m_ParticleCapacity);
+		PlaceArray(m_ParticleCell, m_ParticleCapacity);
+		PlaceArray(m_ParticleRank, m_ParticleCapacity);
+		PlaceArray(m_ParticleIds, m_ParticleCapacity);
+		PlaceArray(m_SortedIds, m_ParticleCapacity);
+		if (!m_NeighborStart.empty())
+		{
+			PlaceArray(m_NeighborStart, m_ParticleCapacity + 1);
+			m_NeighborListValid = false; // 近傍の配列も持ち主のスレッドの書き込みで作り直す
+		}
+		m_pPlacedParticles = std::min<const void*>(m_Particles.data(), m_SortedParticles.data());
+		m_PlacedParticleCount = particleCount;
+	}
+
+	// セルの配列は持ち分の粒子が入っているセルの範囲を持ち主のスレッドが書き込む
+	// 最初のカウンティングソートの前はセルの並びが分からないので等分し、ソートの後と粒子を置き直した時に置き直す
+	const uint32_t bucketCount = m_TotalGridCount + 1;
+	bool followSlots = particleCount > 0 && m_SortedBucketCount == bucketCount && m_CellStart[bucketCount] == particleCount;
+	if (m_CellCountCapacity > 0 && (m_CellCount.get() != m_pPlacedCells || placeParticles || followSlots != m_CellsFollowSlots))
+	{
+		const uint32_t cellCount = m_CellCountCapacity;
+		UpdateOwnedCells(cellCount, followSlots);
+		PlaceArray(m_CellStart, m_CellStart.size(), &m_OwnedCellStart);
+		m_CellCount.reset(new std::atomic<uint32_t>[cellCount]); // デフォルト初期化なので書き込まない
+		m_pThreadPool->Dispatch([&](uint32_t threadIndex)
+		{
+			for (uint32_t cell = m_OwnedCellStart[threadIndex]; cell < m_OwnedCellStart[threadIndex + 1]; ++cell)
+			{
+				m_CellCount[cell].store(0, std::memory_order_relaxed);
+			}
+		});
+		m_pPlacedCells = m_CellCount.get();
+	}
+}
+
+void CPUFluidSolver::UpdateOwnedCells(uint32_t cellCount, bool followSlots)
+{
+	const uint32_t threadCount = GetThreadCount();
+	m_OwnedCellStart.assign(threadCount + 1, 0);
+	for (uint32_t threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+	{
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		if (followSlots)
+		{
+			// ソート後はセル c の粒子がスロット [m_CellStart[c], m_CellStart[c + 1]) にあるので、持ち分の先頭のスロット以降に始まるセルから持つ
+			GetOwnedSlotRange(threadIndex, GetParticleCount(), begin, end);
+			const uint32_t bucketCount = m_SortedBucketCount;
+			begin = static_cast<uint32_t>(std::lower_bound(m_CellStart.begin(), m_CellStart.begin() + bucketCount, begin) - m_CellStart.begin());
+		}
+		else
+		{
+			GetOwnedSlotRange(threadIndex, cellCount, begin, end);
+		}
+		m_OwnedCellStart[threadIndex] = std::max(begin, m_OwnedCellStart[threadIndex - 1]);
+	}
+	m_OwnedCellStart[threadCount] = cellCount;
+	m_CellsFollowSlots = followSlots;
+}
+
+float CPUFluidSolver::MeasureLocalPageFraction(std::vector<float>& threadFractions) const
+{
+	// NUMA配置が無効な場合も、有効にした場合と同じスレッドのノードで比べる
+	const uint32_t threadCount = GetThreadCount();
+	std::vector<uint32_t> threadNodes = m_ThreadNodes;
+	NumaTopology topology = m_UseNumaPlacement ? m_NumaTopology : NumaTopology::Detect();
+	if (!m_UseNumaPlacement)
+	{
+		std::vector<uint32_t> threadCpus;
+		topology.AssignThreads(threadCount, threadCpus, threadNodes);
+	}
+
+	const size_t pageSize = 4096;
+	threadFractions.assign(threadCount, -1.0f);
+	uint64_t totalPages = 0;
+	uint64_t localPages = 0;
+	std::vector<const void*> pages;
+	std::vector<int> nodes;
+	for (uint32_t thread = 0; thread < threadCount; ++thread)
+	{
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		GetOwnedSlotRange(thread, GetParticleCount(), begin, end);
+		if (begin >= end)
+		{
+			continue;
+		}
+		uintptr_t first = reinterpret_cast<uintptr_t>(m_Particles.data() + begin) & ~(pageSize - 1);
+		uintptr_t last = reinterpret_cast<uintptr_t>(m_Particles.data() + end - 1);
+		pages.clear();
+		for (uintptr_t page = first; page <= last; page += pageSize)
+		{
+			pages.push_back(reinterpret_cast<const void*>(page));
+		}
+		nodes.resize(pages.size());
+		NumaTopology::QueryPageNodes(pages.data(), pages.size(), nodes.data());
+		if (nodes[0] < 0)
+		{
+			return -1.0f;
+		}
+		const int threadNode = static_cast<int>(topology.GetNodeId(threadNodes[thread]));
+		uint64_t local = static_cast<uint64_t>(std::count(nodes.begin(), nodes.end(), threadNode));
+		threadFractions[thread] = static_cast<float>(local) / pages.size();
+		totalPages += pages.size();
+		localPages += local;
+	}
+	return (totalPages > 0) ? static_cast<float>(localPages) / totalPages : -1.0f;
+}
+
+void CPUFluidSolver::ReorderParticles()
+{
+	UpdateCellMortonRank();
+	ClearCellCount(m_TotalGridCount + 1);
+
+	const uint32_t outsideBucket = m_TotalGridCount;
+	CountingSortParticles(m_TotalGridCount + 1, [&](uint32_t slot)
+	{
+		auto gridPos = SPHCommon::GetGridPos(m_Particles[slot].Position, m_SimParam.WallMin, m_GridCellSize);
+		int gridIndex = SPHCommon::GetGridIndex(gridPos, m_GridDim);
+		return (gridIndex == -1) ? outsideBucket : m_CellMortonRank[gridIndex];
+	});
+}
+
+// FluidDensityCS.hlsl
+void CPUFluidSolver::ComputeDensity()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float mass = m_SimParam.Mass;
+
+	ParallelForParticles([&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			// 自身の座標
+			Vector3D myPosition = m_Particles[id].Position;
+			auto myGridPos = SPHCommon::GetGridPos(myPosition, m_SimParam.WallMin, m_GridCellSize);
+			float density = 0.0f;
+			float nearDensity = 0.0f;
+
+			// 近傍探索
+			ForEachNeighbor(myGridPos, [&](int neighborId)
+			{
+				Vector3D diff = myPosition - m_Particles[neighborId].Position;
+				float r = std::sqrt(diff.dot(diff));
+				density += mass * kernels.Density.Value(r);
+				nearDensity += mass * kernels.NearDensity.Value(r);
+			});
+			if (density == 0.0f)
+			{
+				density = 0.0000001f;
+			}
+			m_Particles[id].Density = density;
+			m_Particles[id].NearDensity = nearDensity;
+
+			// 圧力 状態方程式
+			float densityError = density - m_SimParam.RestDensity;
+			m_Particles[id].Pressure = m_SimParam.Stiffness * densityError;
+		}
+	});
+}
+
+// FluidForceCS.hlsl
+void CPUFluidSolver::ComputeForce()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float h2 = H * H;
+	const float mass = m_SimParam.Mass;
+	const float nearStiffness = m_SimParam.nearStiffness;
+
+	ParallelForParticles([&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			const Particle& me = m_Particles[id];
+			Vector3D pressureForce(0.0f);
+			Vector3D viscosityForce(0.0f);
+			float myNearPressure = nearStiffness * me.NearDensity;
+			auto myGridPos = SPHCommon::GetGridPos(me.Position, m_SimParam.WallMin, m_GridCellSize);
+
+			// 圧力項、粘性項の計算
+			ForEachNeighbor(myGridPos, [&](int neighborId)
+			{
+				if (static_cast<int>(id) == neighborId)
+				{
+					return;
+				}
+				const Particle& other = m_Particles[neighborId];
+				Vector3D diff = me.Position - other.Position;
+				float r2 = diff.dot(diff);
+				// 影響範囲外チェック
+				if (r2 >= h2 || r2 < 0.00001f)
+				{
+					return;
+				}
+				if (other.Density == 0.0f || other.NearDensity == 0.0f)
+				{
+					return;
+				}
+				float r = std::sqrt(r2);
+				Vector3D dir = diff * (1.0f / r);
+
+				// 圧力項
+				float sharedPressure = (me.Pressure + other.Pressure) / 2.0f;
+				pressureForce += dir * (-mass * sharedPressure * kernels.Pressure.Gradient(r) / other.Density);
+
+				// 粘性項
+				Vector3D relativeSpeed = other.Velocity - me.Velocity;
+				viscosityForce += relativeSpeed * (mass * kernels.Viscosity.Laplacian(r) / other.Density);
+
+				// 近傍圧力
+				float otherNearPressure = nearStiffness * other.NearDensity;
+				float sharedNearPressure = (myNearPressure + otherNearPressure) / 2.0f;
+				pressureForce += dir * (-mass * sharedNearPressure * kernels.NearPressure.Gradient(r) / other.NearDensity);
+			});
+
+			// 力の合成
+			Vector3D externalForce = Vector3D(0.0f, m_SimParam.Gravity, 0.0f) * me.Density;
+			viscosityForce *= m_SimParam.Viscosity;
+			m_Particles[id].Force = pressureForce + viscosityForce + externalForce;
+		}
+	});
+}
+
+// FluidForceCS.hlsl (ペア毎に1回だけ評価する版)
+// ペア (i, j) の力は i から見た値を1回計算し、j には向きを逆にして相手の密度で割り直した値を加える
+// j のセルは別のスレッドが処理している場合があるので、スレッド毎のバッファに積算して最後に合計する
+void CPUFluidSolver::ComputeForceSymmetric()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float h2 = H * H;
+	const float mass = m_SimParam.Mass;
+	const float nearStiffness = m_SimParam.nearStiffness;
+	const float viscosity = m_SimParam.Viscosity;
+	const uint32_t particleCount = GetParticleCount();
+
+	// i が j から受ける力を forceI に、j が i から受ける力を forceJ に返す (影響範囲外ならfalse)
+	auto pairForce = [&](const Particle& a, const Particle& b, Vector3D& forceI, Vector3D& forceJ)
+	{
+		Vector3D diff = a.Position - b.Position;
+		float r2 = diff.dot(diff);
+		// 影響範囲外チェック
+		if (r2 >= h2 || r2 < 0.00001f)
+		{
+			return false;
+		}
+		if (a.Density == 0.0f || a.NearDensity == 0.0f || b.Density == 0.0f || b.NearDensity == 0.0f)
+		{
+			return false;
+		}
+		float r = std::sqrt(r2);
+		Vector3D dir = diff * (1.0f / r);
+
+		// 圧力項・近傍圧力 (相手の密度で割る前の値)
+		float sharedPressure = (a.Pressure + b.Pressure) / 2.0f;
+		float pressureTerm = -mass * sharedPressure * kernels.Pressure.Gradient(r);
+		float sharedNearPressure = nearStiffness * (a.NearDensity + b.NearDensity) / 2.0f;
+		float nearPressureTerm = -mass * sharedNearPressure * kernels.NearPressure.Gradient(r);
+
+		// 粘性項
+		Vector3D viscosityTerm = (b.Velocity - a.Velocity) * (mass * viscosity * kernels.Viscosity.Laplacian(r));
+
+		forceI = dir * (pressureTerm / b.Density + nearPressureTerm / b.NearDensity) + viscosityTerm * (1.0f / b.Density);
+		forceJ = dir * -(pressureTerm / a.Density + nearPressureTerm / a.NearDensity) - viscosityTerm * (1.0f / a.Density);
+		return true;
+	};
+
+	const uint32_t threadCount = m_pThreadPool->GetThreadCount();
+	m_ThreadForces.resize(threadCount);
+	m_ThreadForceUsed.assign(threadCount, 0);
+	for (auto& forces : m_ThreadForces)
+	{
+		// 合計した後は0に戻しているので、増えた分だけ0で埋める
+		forces.resize(particleCount, Vector3D(0.0f));
+	}
+
+	const int dimX = m_GridDim.x;
+	const int dimY = m_GridDim.y;
+	const int dimZ = m_GridDim.z;
+	m_pThreadPool->ParallelForWithThreadIndex(0, m_TotalGridCount, GroupSize, [&](uint32_t threadIndex, uint32_t begin, uint32_t end)
+	{
+		Vector3D* pForces = m_ThreadForces[threadIndex].data();
+		m_ThreadForceUsed[threadIndex] = 1;
+		for (uint32_t cell = begin; cell < end; ++cell)
+		{
+			uint32_t cellBegin = m_CellStart[cell];
+			uint32_t cellEnd = m_CellStart[cell + 1];
+			if (cellBegin == cellEnd)
+			{
+				continue;
+			}
+			int x = static_cast<int>(cell) % dimX;
+			int y = (static_cast<int>(cell) / dimX) % dimY;
+			int z = static_cast<int>(cell) / (dimX * dimY);
+
+			// 自セルの後ろの粒子と x + 1 のセルは連続している
+			uint32_t homeEnd = (x + 1 < dimX) ? m_CellStart[cell + 2] : cellEnd;
+
+			// 前方の残り12セル: (y + 1, z) と (y - 1 ～ y + 1, z + 1) の x - 1 ～ x + 1 の行
+			uint32_t rowBegin[4];
+			uint32_t rowEnd[4];
+			uint32_t rowCount = 0;
+			const int minX = std::max(x - 1, 0);
+			const int maxX = std::min(x + 1, dimX - 1);
+			auto addRow = [&](int rowY, int rowZ)
+			{
+				if (rowY < 0 || rowY >= dimY || rowZ >= dimZ)
+				{
+					return;
+				}
+				int rowIndex = (rowZ * dimY + rowY) * dimX;
+				rowBegin[rowCount] = m_CellStart[rowIndex + minX];
+				rowEnd[rowCount] = m_CellStart[rowIndex + maxX + 1];
+				if (rowBegin[rowCount] < rowEnd[rowCount])
+				{
+					++rowCount;
+				}
+			};
+			addRow(y + 1, z);
+			addRow(y - 1, z + 1);
+			addRow(y, z + 1);
+			addRow(y + 1, z + 1);
+
+			for (uint32_t i = cellBegin; i < cellEnd; ++i)
+			{
+				const Particle& me = m_Particles[i];
+				Vector3D myForce(0.0f);
+				auto visit = [&](uint32_t j)
+				{
+					Vector3D forceI;
+					Vector3D forceJ;
+					if (pairForce(me, m_Particles[j], forceI, forceJ))
+					{
+						myForce += forceI;
+						pForces[j] += forceJ;
+					}
+				};
+				for (uint32_t j = i + 1; j < homeEnd; ++j)
+				{
+					visit(j);
+				}
+				for (uint32_t row = 0; row < rowCount; ++row)
+				{
+					for (uint32_t j = rowBegin[row]; j < rowEnd[row]; ++j)
+					{
+						visit(j);
+					}
+				}
+				pForces[i] += myForce;
+			}
+		}
+	});
+
+	// スレッド毎の力を合計して外力を加える (グリッドの外の粒子は後で片側だけ求める)
+	const uint32_t outsideBegin = m_CellStart[m_TotalGridCount];
+	m_pThreadPool->ParallelFor(0, outsideBegin, GroupSize, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& p = m_Particles[slot];
+			Vector3D force = Vector3D(0.0f, m_SimParam.Gravity, 0.0f) * p.Density;
+			for (uint32_t thread = 0; thread < threadCount; ++thread)
+			{
+				if (m_ThreadForceUsed[thread])
+				{
+					force += m_ThreadForces[thread][slot];
+					m_ThreadForces[thread][slot] = Vector3D(0.0f);
+				}
+			}
+			p.Force = force;
+		}
+	});
+
+	// グリッドの外の粒子はどのセルにも登録されていないので、ComputeForce と同じく自分から見た力だけを求める
+	m_pThreadPool->ParallelFor(outsideBegin, particleCount, GroupSize, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& me = m_Particles[slot];
+			Vector3D force(0.0f);
+			ForEachNeighbor(SPHCommon::GetGridPos(me.Position, m_SimParam.WallMin, m_GridCellSize), [&](int neighborId)
+			{
+				Vector3D forceI;
+				Vector3D forceJ;
+				if (pairForce(me, m_Particles[neighborId], forceI, forceJ))
+				{
+					force += forceI;
+				}
+			});
+			me.Force = force + Vector3D(0.0f, m_SimParam.Gravity, 0.0f) * me.Density;
+		}
+	});
+}
+
+bool CPUFluidSolver::NeedsNeighborListRebuild() const
+{
+	if (!m_NeighborListValid || m_NeighborListPositions.size() != m_Particles.size())
+	{
+		return true;
+	}
+
+	// 構築時の位置から skin/2 より動いた粒子が1つでもあれば作り直す
+	// (2粒子が互いに近づいても合計で skin を超えないので、H 以内の組は必ずリストに含まれる)
+	const float halfSkin = m_NeighborListSkin * 0.5f;
+	const float maxMove2 = halfSkin * halfSkin;
+	std::atomic<bool> exceeded(false);
+	m_pThreadPool->ParallelFor(0, GetParticleCount(), GroupSize * 16, [&](uint32_t begin, uint32_t end)
+	{
+		if (exceeded.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Vector3D move = m_Particles[slot].Position - m_NeighborListPositions[slot];
+			if (move.dot(move) > maxMove2)
+			{
+				exceeded.store(true, std::memory_order_relaxed);
+				return;
+			}
+		}
+	});
+	return exceeded.load();
+}
+
+void CPUFluidSolver::BuildNeighborList()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float mass = m_SimParam.Mass;
+	const float radius2 = m_GridCellSize * m_GridCellSize;
+	const uint32_t particleCount = GetParticleCount();
+	m_NeighborStart.resize(particleCount + 1);
+	m_NeighborListPositions.resize(particleCount);
+	m_NeighborChunks.resize((particleCount + GroupSize - 1) / GroupSize);
+
+	// 1. セルを1回だけ走査し、近傍をチャンク (GroupSize 粒子) 毎のバッファに集めながら密度も求める
+	// ParallelForSlots の区間は NUMA配置では複数のチャンクにまたがるので、区間の中のチャンク毎に別のバッファを使う
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		assert(begin % GroupSize == 0 && (end % GroupSize == 0 || end == particleCount) && "ranges must be whole chunks");
+		for (uint32_t chunkBegin = begin; chunkBegin < end; chunkBegin += GroupSize)
+		{
+			const uint32_t chunkEnd = std::min<uint32_t>(chunkBegin + GroupSize, end);
+			NeighborChunk& chunk = m_NeighborChunks[chunkBegin / GroupSize];
+			chunk.Slots.clear();
+			chunk.Distance.clear();
+			for (uint32_t slot = chunkBegin; slot < chunkEnd; ++slot)
+			{
+				Vector3D myPosition = m_Particles[slot].Position;
+				auto myGridPos = SPHCommon::GetGridPos(myPosition, m_SimParam.WallMin, m_GridCellSize);
+				size_t listBegin = chunk.Slots.size();
+				float density = 0.0f;
+				float nearDensity = 0.0f;
+
+				ForEachNeighbor(myGridPos, [&](int neighborId)
+				{
+					Vector3D diff = myPosition - m_Particles[neighborId].Position;
+					float r2 = diff.dot(diff);
+					if (r2 >= radius2)
+					{
+						return;
+					}
+					float r = std::sqrt(r2);
+					density += mass * kernels.Density.Value(r);
+					nearDensity += mass * kernels.NearDensity.Value(r);
+					// 自分自身はリストに含めない
+					if (static_cast<uint32_t>(neighborId) != slot)
+					{
+						chunk.Slots.push_back(static_cast<uint32_t>(neighborId));
+						chunk.Distance.push_back(r);
+					}
+				});
+				m_NeighborStart[slot] = static_cast<uint32_t>(chunk.Slots.size() - listBegin);
+				m_NeighborListPositions[slot] = myPosition;
+				StoreDensity(slot, density, nearDensity);
+			}
+		}
+	});
+
+	// 2. プレフィックスサムでリストの開始位置を決める
+	uint32_t pairCount = m_pThreadPool->ExclusiveScan(particleCount,
+		[&](uint32_t slot) { return m_NeighborStart[slot]; },
+		m_NeighborStart.data());
+	m_NeighborStart[particleCount] = pairCount;
+	if (pairCount > m_NeighborSlots.capacity())
+	{
+		// 古い内容は使わないので、確保し直す時にコピーしない (新しいページは次のコピーで各チャンクのスレッドが最初に書き込む)
+		m_NeighborSlots.clear();
+		m_NeighborDistance.clear();
+	}
+	m_NeighborSlots.resize(pairCount);
+	m_NeighborDistance.resize(pairCount);
+
+	// 3. チャンク毎のバッファを連続した配列へコピー (書き込む範囲はチャンク毎に別なので、区間の分け方が 1. と違っても競合しない)
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		assert(begin % GroupSize == 0 && (end % GroupSize == 0 || end == particleCount) && "ranges must be whole chunks");
+		for (uint32_t chunkBegin = begin; chunkBegin < end; chunkBegin += GroupSize)
+		{
+			const NeighborChunk& chunk = m_NeighborChunks[chunkBegin / GroupSize];
+			assert(chunk.Slots.size() == m_NeighborStart[std::min<uint32_t>(chunkBegin + GroupSize, end)] - m_NeighborStart[chunkBegin]);
+			std::copy(chunk.Slots.begin(), chunk.Slots.end(), m_NeighborSlots.begin() + m_NeighborStart[chunkBegin]);
+			std::copy(chunk.Distance.begin(), chunk.Distance.end(), m_NeighborDistance.begin() + m_NeighborStart[chunkBegin]);
+		}
+	});
+
+	m_NeighborListValid = true;
+	++m_NeighborListBuildCount;
+}
+
+void CPUFluidSolver::BuildStepNeighborList()
+{
+	const float H = m_SimParam.H;
+	const float h2 = H * H;
+	const uint32_t particleCount = GetParticleCount();
+
+	// 近傍数を数えて書き込み位置を決める (m_ParticleRankはグリッド構築後は使わないので借りる)
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			const Vector3D position = m_Particles[slot].Position;
+			uint32_t count = 0;
+			ForEachNeighbor(SPHCommon::GetGridPos(position, m_SimParam.WallMin, m_GridCellSize), [&](int neighbor)
+			{
+				Vector3D diff = position - m_Particles[neighbor].Position;
+				if (static_cast<uint32_t>(neighbor) != slot && diff.dot(diff) < h2)
+				{
+					++count;
+				}
+			});
+			m_ParticleRank[slot] = count;
+		}
+	});
+	m_StepNeighborStart.resize(particleCount + 1);
+	uint32_t neighborCount = m_pThreadPool->ExclusiveScan(particleCount,
+		[&](uint32_t slot) { return m_ParticleRank[slot]; },
+		m_StepNeighborStart.data());
+	m_StepNeighborStart[particleCount] = neighborCount;
+	m_StepNeighbors.resize(neighborCount);
+
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			const Vector3D position = m_Particles[slot].Position;
+			uint32_t index = m_StepNeighborStart[slot];
+			ForEachNeighbor(SPHCommon::GetGridPos(position, m_SimParam.WallMin, m_GridCellSize), [&](int neighbor)
+			{
+				Vector3D diff = position - m_Particles[neighbor].Position;
+				if (static_cast<uint32_t>(neighbor) != slot && diff.dot(diff) < h2)
+				{
+					m_StepNeighbors[index++] = static_cast<uint32_t>(neighbor);
+				}
+			});
+		}
+	});
+}
+
+void CPUFluidSolver::StoreDensity(uint32_t slot, float density, float nearDensity)
+{
+	if (density == 0.0f)
+	{
+		density = 0.0000001f;
+	}
+	m_Particles[slot].Density = density;
+	m_Particles[slot].NearDensity = nearDensity;
+
+	// 圧力 状態方程式
+	float densityError = density - m_SimParam.RestDensity;
+	m_Particles[slot].Pressure = m_SimParam.Stiffness * densityError;
+}
+
+// FluidDensityCS.hlsl (近傍リスト版)
+void CPUFluidSolver::ComputeDensityNeighborList()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float mass = m_SimParam.Mass;
+	// 自分自身 (r = 0) の寄与
+	const float selfDensity = mass * kernels.Density.Value(0.0f);
+	const float selfNearDensity = mass * kernels.NearDensity.Value(0.0f);
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			Vector3D myPosition = m_Particles[id].Position;
+			float density = selfDensity;
+			float nearDensity = selfNearDensity;
+
+			// 距離は力のパスでも使うので保存しておく
+			uint32_t listEnd = m_NeighborStart[id + 1];
+			for (uint32_t pair = m_NeighborStart[id]; pair < listEnd; ++pair)
+			{
+				Vector3D diff = myPosition - m_Particles[m_NeighborSlots[pair]].Position;
+				float r = std::sqrt(diff.dot(diff));
+				m_NeighborDistance[pair] = r;
+				density += mass * kernels.Density.Value(r);
+				nearDensity += mass * kernels.NearDensity.Value(r);
+			}
+			StoreDensity(id, density, nearDensity);
+		}
+	});
+}
+
+// FluidForceCS.hlsl (近傍リスト版)
+void CPUFluidSolver::ComputeForceNeighborList()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float minR = std::sqrt(0.00001f);
+	const float mass = m_SimParam.Mass;
+	const float nearStiffness = m_SimParam.nearStiffness;
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			const Particle& me = m_Particles[id];
+			Vector3D pressureForce(0.0f);
+			Vector3D viscosityForce(0.0f);
+			float myNearPressure = nearStiffness * me.NearDensity;
+
+			uint32_t listEnd = m_NeighborStart[id + 1];
+			for (uint32_t pair = m_NeighborStart[id]; pair < listEnd; ++pair)
+			{
+				// 密度パスで求めた距離を使う (影響範囲外チェック)
+				// カーネルの値はペア毎に保存すると読み込みが 4 -> 16byte に増えて遅くなるので、ここで距離から求め直す
+				float r = m_NeighborDistance[pair];
+				if (r >= H || r < minR)
+				{
+					continue;
+				}
+				const Particle& other = m_Particles[m_NeighborSlots[pair]];
+				if (other.Density == 0.0f || other.NearDensity == 0.0f)
+				{
+					continue;
+				}
+				Vector3D dir = (me.Position - other.Position) * (1.0f / r);
+
+				// 圧力項
+				float sharedPressure = (me.Pressure + other.Pressure) / 2.0f;
+				pressureForce += dir * (-mass * sharedPressure * kernels.Pressure.Gradient(r) / other.Density);
+
+				// 粘性項
+				Vector3D relativeSpeed = other.Velocity - me.Velocity;
+				viscosityForce += relativeSpeed * (mass * kernels.Viscosity.Laplacian(r) / other.Density);
+
+				// 近傍圧力
+				float otherNearPressure = nearStiffness * other.NearDensity;
+				float sharedNearPressure = (myNearPressure + otherNearPressure) / 2.0f;
+				pressureForce += dir * (-mass * sharedNearPressure * kernels.NearPressure.Gradient(r) / other.NearDensity);
+			}
+
+			// 力の合成
+			Vector3D externalForce = Vector3D(0.0f, m_SimParam.Gravity, 0.0f) * me.Density;
+			viscosityForce *= m_SimParam.Viscosity;
+			m_Particles[id].Force = pressureForce + viscosityForce + externalForce;
+		}
+	});
+}
+
+// FluidDensityCS.hlsl (SoA版)
+void CPUFluidSolver::ComputeDensitySoA()
+{
+	const SPHBatchCoefficients coef = SPHBatchCoefficients::Create(m_SimParam);
+	const SPHBatchKernels& kernels = *m_pBatchKernels;
+
+	// 並べ替え後の位置・速度をSoAへ集める (速度は力のパスで使う)
+	m_pThreadPool->ParallelFor(0, GetParticleCount(), GroupSize * 16, [&](uint32_t begin, uint32_t end)
+	{
+		m_SoA.LoadFromAoS(m_Particles.data(), begin, end, ParticleSoA::FieldPosition | ParticleSoA::FieldVelocity);
+	});
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			float px = m_SoA.PositionX[id];
+			float py = m_SoA.PositionY[id];
+			float pz = m_SoA.PositionZ[id];
+			auto myGridPos = SPHCommon::GetGridPos(m_Particles[id].Position, m_SimParam.WallMin, m_GridCellSize);
+			float density = 0.0f;
+			float nearDensity = 0.0f;
+
+			ForEachNeighborRow(myGridPos, [&](uint32_t rowBegin, uint32_t rowEnd)
+			{
+				kernels.AccumulateDensity(m_SoA, rowBegin, rowEnd, px, py, pz, coef, density, nearDensity);
+			});
+			if (density == 0.0f)
+			{
+				density = 0.0000001f;
+			}
+			float pressure = m_SimParam.Stiffness * (density - m_SimParam.RestDensity);
+
+			// 力のパスはSoAを、積分とGPUへのアップロードはAoSを読む
+			m_SoA.Density[id] = density;
+			m_SoA.NearDensity[id] = nearDensity;
+			m_SoA.Pressure[id] = pressure;
+			m_Particles[id].Density = density;
+			m_Particles[id].NearDensity = nearDensity;
+			m_Particles[id].Pressure = pressure;
+		}
+	});
+}
+
+// FluidForceCS.hlsl (SoA版)
+void CPUFluidSolver::ComputeForceSoA()
+{
+	const SPHBatchCoefficients coef = SPHBatchCoefficients::Create(m_SimParam);
+	const SPHBatchKernels& kernels = *m_pBatchKernels;
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			Particle& me = m_Particles[id];
+			Vector3D pressureForce(0.0f);
+			Vector3D viscosityForce(0.0f);
+			auto myGridPos = SPHCommon::GetGridPos(me.Position, m_SimParam.WallMin, m_GridCellSize);
+
+			ForEachNeighborRow(myGridPos, [&](uint32_t rowBegin, uint32_t rowEnd)
+			{
+				kernels.AccumulateForce(m_SoA, rowBegin, rowEnd, id, coef, pressureForce, viscosityForce);
+			});
+
+			// 力の合成
+			Vector3D externalForce = Vector3D(0.0f, m_SimParam.Gravity, 0.0f) * me.Density;
+			viscosityForce *= m_SimParam.Viscosity;
+			me.Force = pressureForce + viscosityForce + externalForce;
+		}
+	});
+}
+
+void CPUFluidSolver::StoreCompactParticles()
+{
+	const uint32_t particleCount = GetParticleCount();
+	m_CompactCodec = CompactParticleCodec(m_SimParam.WallMin, m_GridCellSize);
+	m_CompactParticles.resize(particleCount);
+	m_CompactDensity.resize(particleCount);
+
+	// 自分の位置もfloatのまま使うと近傍から見た位置とずれるので、量子化した値に揃える
+	m_pThreadPool->ParallelFor(0, particleCount, GroupSize * 16, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& p = m_Particles[slot];
+			CompactParticle compact = m_CompactCodec.Encode(p.Position, p.Velocity);
+			m_CompactParticles[slot] = compact;
+			p.Position = m_CompactCodec.DecodePosition(compact);
+			p.Velocity = m_CompactCodec.DecodeVelocity(compact);
+		}
+	});
+}
+
+// FluidDensityCS.hlsl (量子化した粒子から近傍を読む版)
+void CPUFluidSolver::ComputeDensityCompact()
+{
+	StoreCompactParticles();
+
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float mass = m_SimParam.Mass;
+	const CompactParticleCodec& codec = m_CompactCodec;
+
+	ParallelForParticles([&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			const CompactParticleCodec::FixedPosition myPosition = codec.ToFixed(m_CompactParticles[slot]);
+			float density = 0.0f;
+			float nearDensity = 0.0f;
+			ForEachNeighbor(SPHCommon::GetGridPos(m_Particles[slot].Position, m_SimParam.WallMin, m_GridCellSize), [&](int neighborId)
+			{
+				Vector3D diff = codec.Difference(myPosition, m_CompactParticles[neighborId]);
+				float r = std::sqrt(diff.dot(diff));
+				density += mass * kernels.Density.Value(r);
+				nearDensity += mass * kernels.NearDensity.Value(r);
+			});
+			StoreDensity(slot, density, nearDensity);
+			m_CompactDensity[slot] = { m_Particles[slot].Density, nearDensity };
+		}
+	});
+}
+
+// FluidForceCS.hlsl (量子化した粒子から近傍を読む版)
+void CPUFluidSolver::ComputeForceCompact()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float h2 = H * H;
+	const float mass = m_SimParam.Mass;
+	const float nearStiffness = m_SimParam.nearStiffness;
+	const float stiffness = m_SimParam.Stiffness;
+	const float restDensity = m_SimParam.RestDensity;
+	const CompactParticleCodec& codec = m_CompactCodec;
+
+	ParallelForParticles([&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& me = m_Particles[slot];
+			Vector3D pressureForce(0.0f);
+			Vector3D viscosityForce(0.0f);
+			float myNearPressure = nearStiffness * me.NearDensity;
+			const CompactParticleCodec::FixedPosition myPosition = codec.ToFixed(m_CompactParticles[slot]);
+
+			ForEachNeighbor(SPHCommon::GetGridPos(me.Position, m_SimParam.WallMin, m_GridCellSize), [&](int neighborId)
+			{
+				if (static_cast<int>(slot) == neighborId)
+				{
+					return;
+				}
+				const CompactParticle& other = m_CompactParticles[neighborId];
+				Vector3D diff = codec.Difference(myPosition, other);
+				float r2 = diff.dot(diff);
+				// 影響範囲外チェック
+				if (r2 >= h2 || r2 < 0.00001f)
+				{
+					return;
+				}
+				const CompactDensity otherDensity = m_CompactDensity[neighborId];
+				if (otherDensity.Density == 0.0f || otherDensity.NearDensity == 0.0f)
+				{
+					return;
+				}
+				float r = std::sqrt(r2);
+				Vector3D dir = diff * (1.0f / r);
+
+				// 圧力項 (圧力は密度から求め直す)
+				float otherPressure = stiffness * (otherDensity.Density - restDensity);
+				float sharedPressure = (me.Pressure + otherPressure) / 2.0f;
+				pressureForce += dir * (-mass * sharedPressure * kernels.Pressure.Gradient(r) / otherDensity.Density);
+
+				// 粘性項
+				Vector3D relativeSpeed = codec.DecodeVelocity(other) - me.Velocity;
+				viscosityForce += relativeSpeed * (mass * kernels.Viscosity.Laplacian(r) / otherDensity.Density);
+
+				// 近傍圧力
+				float otherNearPressure = nearStiffness * otherDensity.NearDensity;
+				float sharedNearPressure = (myNearPressure + otherNearPressure) / 2.0f;
+				pressureForce += dir * (-mass * sharedNearPressure * kernels.NearPressure.Gradient(r) / otherDensity.NearDensity);
+			});
+
+			// 力の合成
+			Vector3D externalForce = Vector3D(0.0f, m_SimParam.Gravity, 0.0f) * me.Density;
+			viscosityForce *= m_SimParam.Viscosity;
+			me.Force = pressureForce + viscosityForce + externalForce;
+		}
+	});
+}
+
+float CPUFluidSolver::ComputeAdaptiveTimestep()
+{
+	const AdaptiveTimestepParam& param = m_AdaptiveTimestepParam;
+	const WallPenalty wall(m_SimParam, m_Colliders, m_BoundaryMode == BoundaryMode::Penalty, m_WallStiffness);
+
+	// |v|^2 と |a|^2 の最大値 (Integrate と同じく壁の反発も加速度に含める)
+	struct MaxValues
+	{
+		float Speed2;
+		float Acceleration2;
+	};
+	MaxValues maxValues = m_pThreadPool->ParallelReduce(GetParticleCount(), MaxValues{ 0.0f, 0.0f },
+		[&](uint32_t id)
+		{
+			const Particle& p = m_Particles[id];
+			if (p.Density == 0.0f)
+			{
+				return MaxValues{ 0.0f, 0.0f };
+			}
+			Vector3D acceleration = p.Force * (1.0f / p.Density) + wall.Acceleration(p.Position);
+			return MaxValues{ p.Velocity.dot(p.Velocity), acceleration.dot(acceleration) };
+		},
+		[](const MaxValues& a, const MaxValues& b)
+		{
+			return MaxValues{ std::max(a.Speed2, b.Speed2), std::max(a.Acceleration2, b.Acceleration2) };
+		});
+
+	const float H = m_SimParam.H;
+	float maxSpeed = std::sqrt(maxValues.Speed2);
+	float maxAcceleration = std::sqrt(maxValues.Acceleration2);
+	m_TimestepStats.MaxSpeed = maxSpeed;
+	m_TimestepStats.MaxAcceleration = maxAcceleration;
+
+	float deltaTime = param.MaxTimestep;
+	TimestepLimit limit = TimestepLimit::MaxTimestep;
+	auto applyLimit = [&](float candidate, TimestepLimit candidateLimit)
+	{
+		if (candidate < deltaTime)
+		{
+			deltaTime = candidate;
+			limit = candidateLimit;
+		}
+	};
+	if (maxSpeed > 0.0f)
+	{
+		applyLimit(param.CFLNumber * H / maxSpeed, TimestepLimit::CFL);
+	}
+	if (maxAcceleration > 0.0f)
+	{
+		applyLimit(param.ForceNumber * std::sqrt(H / maxAcceleration), TimestepLimit::Force);
+	}
+	float kinematicViscosity = m_SimParam.Viscosity / m_SimParam.RestDensity;
+	if (kinematicViscosity > 0.0f)
+	{
+		applyLimit(param.ViscosityNumber * H * H / kinematicViscosity, TimestepLimit::Viscosity);
+	}
+	if (deltaTime < param.MinTimestep)
+	{
+		deltaTime = param.MinTimestep;
+		limit = TimestepLimit::MinTimestep;
+	}
+
+	// フレームの終わりに合わせる (最後に極端に小さいステップが残らないよう、2ステップ以内なら等分する)
+	if (m_StepTimeLimit > 0.0f)
+	{
+		if (m_StepTimeLimit <= deltaTime)
+		{
+			deltaTime = m_StepTimeLimit;
+			limit = TimestepLimit::FrameEnd;
+		}
+		else if (m_StepTimeLimit < 2.0f * deltaTime)
+		{
+			deltaTime = m_StepTimeLimit * 0.5f;
+			limit = TimestepLimit::FrameEnd;
+		}
+	}
+	m_TimestepStats.Limit = limit;
+	return deltaTime;
+}
+
+// FluidSimCS.hlsl
+void CPUFluidSolver::Integrate(float deltaTime)
+{
+	const WallPenalty wall(m_SimParam, m_Colliders, m_BoundaryMode == BoundaryMode::Penalty, m_WallStiffness);
+	// 適応時間刻みではCFL条件で安定性を保つので、速度を切り捨てない
+	const bool clampSpeed = !m_UseAdaptiveTimestep;
+	const float maxSpeed = 10.0f;
+	// 境界粒子の圧力で押し返しきれなかった粒子は壁と障害物の表面に戻す
+	const bool projectToBoundary = m_BoundaryMode == BoundaryMode::Particles;
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			Particle& p = m_Particles[id];
+			if (p.Density == 0.0f)
+			{
+				continue;
+			}
+			Vector3D acceleration = p.Force * (1.0f / p.Density);
+			acceleration += wall.Acceleration(p.Position);
+
+			p.Velocity += acceleration * deltaTime;
+			float speed = p.Velocity.length();
+			if (clampSpeed && speed > maxSpeed)
+			{
+				p.Velocity *= maxSpeed / speed;
+			}
+			p.Position += p.Velocity * deltaTime;
+			if (projectToBoundary)
+			{
+				SPHCommon::ClampToWalls(p.Position, p.Velocity, m_SimParam.WallMin, m_SimParam.WallMax);
+				ProjectOutOfColliders(p.Position, &p.Velocity);
+			}
+		}
+	});
+}
+
+void CPUFluidSolver::ProjectOutOfColliders(Vector3D& position, Vector3D* pVelocity) const
+{
+	for (const SDFCollider& collider : m_Colliders)
+	{
+		float distance;
+		Vector3D normal;
+		if (!collider.Query(position, distance, normal) || distance >= 0.0f)
+		{
+			continue;
+		}
+		position -= normal * distance;
+		if (pVelocity != nullptr)
+		{
+			*pVelocity -= normal * std::min(pVelocity->dot(normal), 0.0f);
+		}
+	}
+}
+
+void CPUFluidSolver::UpdateBoundaryParticles()
+{
+	if (!m_BoundaryParticles.IsUpToDate(m_SimParam, m_Colliders, m_BoundaryParticleParam))
+	{
+		m_BoundaryParticles.Build(m_SimParam, m_Colliders, m_BoundaryParticleParam, *m_pThreadPool);
+	}
+}
+
+void CPUFluidSolver::AddBoundaryDensity(bool useSoA, bool useCompact)
+{
+	const SPHKernels::KernelEvaluator<Kernels> kernels(m_SimParam.H);
+	const std::vector<Vector3D>& boundaryPositions = m_BoundaryParticles.GetPositions();
+	const std::vector<float>& boundaryPsi = m_BoundaryParticles.GetPsi();
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			const Vector3D myPosition = m_Particles[id].Position;
+			float density = 0.0f;
+			float nearDensity = 0.0f;
+			// Ψ は流体粒子の質量の代わり
+			m_BoundaryParticles.ForEachNeighbor(myPosition, [&](uint32_t index)
+			{
+				Vector3D diff = myPosition - boundaryPositions[index];
+				float r = std::sqrt(diff.dot(diff));
+				density += boundaryPsi[index] * kernels.Density.Value(r);
+				nearDensity += boundaryPsi[index] * kernels.NearDensity.Value(r);
+			});
+			if (density == 0.0f && nearDensity == 0.0f)
+			{
+				continue;
+			}
+			StoreDensity(id, m_Particles[id].Density + density, m_Particles[id].NearDensity + nearDensity);
+			if (useSoA)
+			{
+				m_SoA.Density[id] = m_Particles[id].Density;
+				m_SoA.NearDensity[id] = m_Particles[id].NearDensity;
+				m_SoA.Pressure[id] = m_Particles[id].Pressure;
+			}
+			if (useCompact)
+			{
+				m_CompactDensity[id] = { m_Particles[id].Density, m_Particles[id].NearDensity };
+			}
+		}
+	});
+}
+
+void CPUFluidSolver::AddBoundaryForce()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::KernelEvaluator<Kernels> kernels(H);
+	const float h2 = H * H;
+	const float nearStiffness = m_SimParam.nearStiffness;
+	const std::vector<Vector3D>& boundaryPositions = m_BoundaryParticles.GetPositions();
+	const std::vector<float>& boundaryPsi = m_BoundaryParticles.GetPsi();
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t id = begin; id < end; ++id)
+		{
+			Particle& me = m_Particles[id];
+			if (me.Density == 0.0f || me.NearDensity == 0.0f)
+			{
+				continue;
+			}
+			// 境界粒子の圧力と密度は自分と同じとみなす (Akinci et al. 2012)
+			// 負の圧力で壁に吸い付かないよう、押し返す向きだけにする。境界粒子の速度は0とする
+			const float pressure = std::max(me.Pressure, 0.0f);
+			const float nearPressure = nearStiffness * me.NearDensity;
+			Vector3D pressureForce(0.0f);
+			Vector3D viscosityForce(0.0f);
+			m_BoundaryParticles.ForEachNeighbor(me.Position, [&](uint32_t index)
+			{
+				Vector3D diff = me.Position - boundaryPositions[index];
+				float r2 = diff.dot(diff);
+				// 影響範囲外チェック
+				if (r2 >= h2 || r2 < 0.00001f)
+				{
+					return;
+				}
+				float r = std::sqrt(r2);
+				Vector3D dir = diff * (1.0f / r);
+				pressureForce += dir * (-boundaryPsi[index] * pressure * kernels.Pressure.Gradient(r) / me.Density);
+				pressureForce += dir * (-boundaryPsi[index] * nearPressure * kernels.NearPressure.Gradient(r) / me.NearDensity);
+				// 止まっている境界粒子との粘性項 (壁に当たった粒子の勢いを落とす)
+				viscosityForce += me.Velocity * (-boundaryPsi[index] * kernels.Viscosity.Laplacian(r) / me.Density);
+			});
+			me.Force += pressureForce + viscosityForce * m_SimParam.Viscosity;
+		}
+	});
+}
@@ -0,0 +1,338 @@
+#include "Simulation/CPUFluidSolver.h"
+#include "Simulation/ThreadPool.h"
+
+// DFSPH (Divergence-Free SPH, Bender & Koschier 2015)
+// 密度は静止密度との比 (ρ/ρ0) で扱い、粒子の体積は V = Mass / RestDensity (全粒子同じ質量)
+// 反復は Jacobi 法: 各粒子は近傍のκを読んで自分の速度だけを書き換えるので、粒子毎に並列化できる
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// κの和がこれより小さいペアは速度を修正しない
+	const float KappaEpsilon = 1.0e-5f;
+}
+
+float CPUFluidSolver::StepDFSPH()
+{
+	m_Timings.NeighborList = 0.0;
+
+	auto start = Clock::now();
+	ClearGrid();
+	m_Timings.GridClear = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	BuildGrid();
+	m_Timings.GridBuild = ElapsedMilliseconds(start);
+
+	// 粒子IDで持っているウォームスタート用のκ (追加された粒子は0から)
+	const uint32_t idCount = static_cast<uint32_t>(m_IdToSlot.size());
+	m_DFSPHKappa.resize(idCount, 0.0f);
+	m_DFSPHKappaV.resize(idCount, 0.0f);
+
+	start = Clock::now();
+	BuildDFSPHNeighbors();
+	m_Timings.Density = ElapsedMilliseconds(start);
+
+	// 前のステップの速度で密度が変化しないようにする
+	start = Clock::now();
+	if (m_PrevDeltaTime <= 0.0f)
+	{
+		m_PrevDeltaTime = m_SimParam.DeltaTime;
+	}
+	m_DFSPHStats = {};
+	if (m_DFSPHParam.DivergenceSolve)
+	{
+		SolveDFSPH(m_PrevDeltaTime, true);
+	}
+	m_Timings.DivergenceSolve = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	ComputeDFSPHNonPressureForce();
+	m_Timings.Force = ElapsedMilliseconds(start);
+
+	// 圧力以外の力で速度を予測し、予測した位置で密度が ρ0 になるよう修正する
+	start = Clock::now();
+	float deltaTime = m_UseAdaptiveTimestep ? ComputeAdaptiveTimestep() : m_SimParam.DeltaTime;
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& p = m_Particles[slot];
+			if (p.Density > 0.0f)
+			{
+				p.Velocity += p.Force * (deltaTime / p.Density);
+			}
+		}
+	});
+	SolveDFSPH(deltaTime, false);
+	m_Timings.PressureSolve = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	IntegrateDFSPH(deltaTime);
+	m_Timings.Integrate = ElapsedMilliseconds(start);
+
+	m_PrevDeltaTime = deltaTime;
+	return deltaTime;
+}
+
+void CPUFluidSolver::BuildDFSPHNeighbors()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::Kernel<DFSPHKernel> kernel(H);
+	const float volume = m_SimParam.Mass / m_SimParam.RestDensity;
+	const float selfDensity = volume * kernel.Value(0.0f);
+	const uint32_t particleCount = GetParticleCount();
+
+	if (m_DFSPHWallTable.GetRadius() != H)
+	{
+		m_DFSPHWallTable = SPHKernels::WallIntegralTable<DFSPHKernel>(H);
+	}
+	const Vector3D wallMin = m_SimParam.WallMin;
+	const Vector3D wallMax = m_SimParam.WallMax;
+
+	BuildStepNeighborList();
+	m_DFSPHGradients.resize(m_StepNeighbors.size());
+	m_DFSPHDensity.resize(particleCount);
+	m_DFSPHFactor.resize(particleCount);
+	m_DensityAdv.resize(particleCount);
+	m_DFSPHStiffness.resize(particleCount);
+	m_DFSPHWallGradients.resize(particleCount);
+
+	// V∇W を求め、密度比と係数αを求める
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& me = m_Particles[slot];
+			const Vector3D position = me.Position;
+			float density = selfDensity;
+			Vector3D gradientSum(0.0f);
+			float gradientSquaredSum = 0.0f;
+			for (uint32_t k = m_StepNeighborStart[slot]; k < m_StepNeighborStart[slot + 1]; ++k)
+			{
+				Vector3D diff = position - m_Particles[m_StepNeighbors[k]].Position;
+				float r = diff.length();
+				Vector3D gradient(0.0f);
+				if (r > 1.0e-6f)
+				{
+					gradient = diff * (volume * kernel.Gradient(r) / r);
+				}
+				density += volume * kernel.Value(r);
+				gradientSum += gradient;
+				gradientSquaredSum += gradient.dot(gradient);
+				m_DFSPHGradients[k] = gradient;
+			}
+
+			// 壁は |Σ V∇W|^2 の項にだけ入る (壁の粒子の速度は変わらないので Σ |V∇W|^2 には含めない)
+			Vector3D wallGradient(0.0f);
+			m_DFSPHWallTable.AddBoxWalls(position, wallMin, wallMax, density, wallGradient);
+			m_DFSPHWallGradients[slot] = wallGradient;
+			gradientSum += wallGradient;
+
+			float denominator = gradientSum.dot(gradientSum) + gradientSquaredSum;
+			m_DFSPHFactor[slot] = (denominator > 1.0e-6f) ? -1.0f / denominator : 0.0f;
+			m_DFSPHDensity[slot] = density;
+			me.Density = density * m_SimParam.RestDensity;
+			me.NearDensity = density;
+		}
+	});
+}
+
+// 重力と粘性 (FluidForceCS と同じ粘性項)
+void CPUFluidSolver::ComputeDFSPHNonPressureForce()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::Kernel<Kernels::Viscosity> viscosityKernel(H);
+	const float mass = m_SimParam.Mass;
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& me = m_Particles[slot];
+			Vector3D viscosityForce(0.0f);
+			for (uint32_t k = m_StepNeighborStart[slot]; k < m_StepNeighborStart[slot + 1]; ++k)
+			{
+				const Particle& other = m_Particles[m_StepNeighbors[k]];
+				float r = (me.Position - other.Position).length();
+				Vector3D relativeSpeed = other.Velocity - me.Velocity;
+				viscosityForce += relativeSpeed * (mass * viscosityKernel.Laplacian(r) / other.Density);
+			}
+			Vector3D externalForce = Vector3D(0.0f, m_SimParam.Gravity, 0.0f) * me.Density;
+			me.Force = viscosityForce * m_SimParam.Viscosity + externalForce;
+			me.Pressure = 0.0f;
+		}
+	});
+}
+
+float CPUFluidSolver::ComputeDFSPHDensityAdvection(float deltaTime, bool divergence)
+{
+	const uint32_t minNeighbors = m_DFSPHParam.MinDivergenceNeighbors;
+	const uint32_t particleCount = GetParticleCount();
+	double errorSum = m_pThreadPool->ParallelReduce(particleCount, 0.0,
+		[&](uint32_t slot)
+		{
+			const Vector3D velocity = m_Particles[slot].Velocity;
+			uint32_t neighborBegin = m_StepNeighborStart[slot];
+			uint32_t neighborEnd = m_StepNeighborStart[slot + 1];
+			// Dρ/Dt / ρ0 = Σ V (v_i - v_j)・∇W
+			float densityChange = 0.0f;
+			for (uint32_t k = neighborBegin; k < neighborEnd; ++k)
+			{
+				densityChange += (velocity - m_Particles[m_StepNeighbors[k]].Velocity).dot(m_DFSPHGradients[k]);
+			}
+			// 壁は静止している
+			densityChange += velocity.dot(m_DFSPHWallGradients[slot]);
+
+			// 膨張 (負の圧力) は修正しない
+			float densityAdv = 0.0f;
+			float error = 0.0f;
+			if (divergence)
+			{
+				densityAdv = (neighborEnd - neighborBegin >= minNeighbors) ? std::max(densityChange, 0.0f) : 0.0f;
+				error = densityAdv;
+			}
+			else
+			{
+				densityAdv = std::max(m_DFSPHDensity[slot] + deltaTime * densityChange, 1.0f);
+				error = densityAdv - 1.0f;
+			}
+			m_DensityAdv[slot] = densityAdv;
+			return static_cast<double>(error);
+		},
+		[](double a, double b) { return a + b; });
+	return static_cast<float>(errorSum / std::max(1u, particleCount));
+}
+
+void CPUFluidSolver::ApplyDFSPHPressure(float deltaTime)
+{
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			const float kappa = m_DFSPHStiffness[slot];
+			Vector3D deltaVelocity(0.0f);
+			for (uint32_t k = m_StepNeighborStart[slot]; k < m_StepNeighborStart[slot + 1]; ++k)
+			{
+				float kappaSum = kappa + m_DFSPHStiffness[m_StepNeighbors[k]];
+				if (std::abs(kappaSum) > KappaEpsilon)
+				{
+					deltaVelocity += m_DFSPHGradients[k] * kappaSum;
+				}
+			}
+			// 壁は自分のκだけで押し返す
+			deltaVelocity += m_DFSPHWallGradients[slot] * kappa;
+			m_Particles[slot].Velocity += deltaVelocity * deltaTime;
+		}
+	});
+}
+
+void CPUFluidSolver::SolveDFSPH(float deltaTime, bool divergence)
+{
+	const DFSPHParam& param = m_DFSPHParam;
+	const uint32_t particleCount = GetParticleCount();
+	std::vector<float>& kappaById = divergence ? m_DFSPHKappaV : m_DFSPHKappa;
+	// κ = b * α / dt^2 (速度発散は b * α / dt)
+	const float invDeltaTime = 1.0f / deltaTime;
+	const float kappaScale = divergence ? invDeltaTime : invDeltaTime * invDeltaTime;
+
+	float error = ComputeDFSPHDensityAdvection(deltaTime, divergence);
+
+	// 前のステップのκの半分から始める (κは粒子IDで保存してある)
+	if (param.WarmStart)
+	{
+		ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t slot = begin; slot < end; ++slot)
+			{
+				float& kappa = kappaById[m_ParticleIds[slot]];
+				bool active = divergence ? (m_DensityAdv[slot] > 0.0f) : true;
+				kappa = active ? 0.5f * std::max(kappa, -0.5f) * kappaScale : 0.0f;
+				m_DFSPHStiffness[slot] = kappa;
+			}
+		});
+		ApplyDFSPHPressure(deltaTime);
+		error = ComputeDFSPHDensityAdvection(deltaTime, divergence);
+	}
+	else
+	{
+		ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t slot = begin; slot < end; ++slot)
+			{
+				kappaById[m_ParticleIds[slot]] = 0.0f;
+			}
+		});
+	}
+
+	const float tolerance = divergence ? param.DivergenceTolerance * invDeltaTime : param.DensityTolerance;
+	const uint32_t minIterations = divergence ? 1 : param.MinIterations;
+	const uint32_t maxIterations = divergence ? param.MaxDivergenceIterations : param.MaxIterations;
+	uint32_t iterations = 0;
+	while ((error > tolerance || iterations < minIterations) && iterations < maxIterations)
+	{
+		ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t slot = begin; slot < end; ++slot)
+			{
+				float residual = divergence ? m_DensityAdv[slot] : m_DensityAdv[slot] - 1.0f;
+				float kappa = residual * m_DFSPHFactor[slot] * kappaScale;
+				m_DFSPHStiffness[slot] = kappa;
+				kappaById[m_ParticleIds[slot]] += kappa;
+			}
+		});
+		ApplyDFSPHPressure(deltaTime);
+		error = ComputeDFSPHDensityAdvection(deltaTime, divergence);
+		++iterations;
+	}
+
+	// 次のステップで時間刻みが変わっても使えるよう、dtを掛けて保存する
+	const float storeScale = 1.0f / kappaScale;
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			float& kappa = kappaById[m_ParticleIds[slot]];
+			kappa *= storeScale;
+			if (!divergence)
+			{
+				// 表示用に圧力 (p / ρ0^2 = -κ) を入れておく
+				m_Particles[slot].Pressure = -kappa * kappaScale;
+			}
+		}
+	});
+
+	if (divergence)
+	{
+		m_DFSPHStats.DivergenceIterations = iterations;
+		m_DFSPHStats.DivergenceError = error * deltaTime;
+	}
+	else
+	{
+		m_DFSPHStats.DensityIterations = iterations;
+		m_DFSPHStats.DensityError = error;
+	}
+}
+
+// 位置を進め、壁の外に出た粒子や障害物に入った粒子は表面に戻して表面に向かう速度を消す
+void CPUFluidSolver::IntegrateDFSPH(float deltaTime)
+{
+	const Vector3D wallMin = m_SimParam.WallMin;
+	const Vector3D wallMax = m_SimParam.WallMax;
+
+	ParallelForSlots(GetParticleCount(), [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& p = m_Particles[slot];
+			p.Position += p.Velocity * deltaTime;
+			SPHCommon::ClampToWalls(p.Position, p.Velocity, wallMin, wallMax);
+			ProjectOutOfColliders(p.Position, &p.Velocity);
+		}
+	});
+}
@@ -0,0 +1,247 @@
+#include "Simulation/CPUFluidSolver.h"
+#include "Simulation/ThreadPool.h"
+
+// PBF (Position Based Fluids, Macklin & Muller 2013)
+// 密度の拘束 C = ρ/ρ0 - 1 を予測位置に対して Jacobi 反復で解き、位置の変化から速度を求める
+// 密度はPoly6、拘束の勾配はSpikyの勾配 (GPU版のWCSPHと同じ組み合わせ)
+// 拘束は圧縮側 (C > 0) だけに掛け、表面の粒子が引き寄せられて固まらないようにする
+// 壁はDFSPHと同じく外側が静止密度で詰まっているとみなして密度と ∇C に含める (含めないと壁際の粒子が壁に押し付けられて隅に固まる)
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+}
+
+float CPUFluidSolver::StepPBF()
+{
+	const uint32_t particleCount = GetParticleCount();
+	const Vector3D wallMin = m_SimParam.WallMin;
+	const Vector3D wallMax = m_SimParam.WallMax;
+
+	// AdvanceFrameの最後のステップはフレームの残り時間で止める
+	float deltaTime = m_SimParam.DeltaTime;
+	m_TimestepStats.Limit = TimestepLimit::Fixed;
+	if (m_StepTimeLimit > 0.0f && m_StepTimeLimit < deltaTime)
+	{
+		deltaTime = m_StepTimeLimit;
+		m_TimestepStats.Limit = TimestepLimit::FrameEnd;
+	}
+
+	m_Timings.Density = 0.0;
+	m_Timings.DivergenceSolve = 0.0;
+
+	// 外力で速度と位置を予測する (グリッドの構築で並べ替わるので元の位置は粒子ID毎に持つ)
+	auto start = Clock::now();
+	m_PBFPreviousPositions.resize(m_IdToSlot.size());
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& p = m_Particles[slot];
+			m_PBFPreviousPositions[m_ParticleIds[slot]] = p.Position;
+			p.Velocity.y += m_SimParam.Gravity * deltaTime;
+			p.Position += p.Velocity * deltaTime;
+			SPHCommon::ClampToWalls(p.Position, p.Velocity, wallMin, wallMax);
+			ProjectOutOfColliders(p.Position, &p.Velocity);
+		}
+	});
+	m_Timings.Integrate = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	ClearGrid();
+	m_Timings.GridClear = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	BuildGrid();
+	m_Timings.GridBuild = ElapsedMilliseconds(start);
+
+	// 反復中は予測位置での近傍を使い回す
+	start = Clock::now();
+	BuildStepNeighborList();
+	m_Timings.NeighborList = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	m_PBFLambda.resize(particleCount);
+	m_PBFDelta.resize(particleCount);
+	m_PBFWallGradients.resize(particleCount);
+	if (m_PBFWallTable.GetRadius() != m_SimParam.H)
+	{
+		m_PBFWallTable = SPHKernels::WallIntegralTable<Kernels::Density>(m_SimParam.H);
+	}
+	m_PBFStats = {};
+	for (uint32_t iteration = 0; iteration < m_PBFParam.Iterations; ++iteration)
+	{
+		m_PBFStats.DensityError = ComputePBFLambda();
+		ApplyPBFDelta();
+		++m_PBFStats.Iterations;
+	}
+	m_Timings.PressureSolve = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	UpdatePBFVelocity(deltaTime);
+	m_Timings.Force = ElapsedMilliseconds(start);
+
+	return deltaTime;
+}
+
+float CPUFluidSolver::ComputePBFLambda()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::Kernel<Kernels::Density> densityKernel(H);
+	const SPHKernels::Kernel<Kernels::Pressure> gradientKernel(H);
+	const float mass = m_SimParam.Mass;
+	const float restDensity = m_SimParam.RestDensity;
+	const float scale = mass / restDensity;
+	const float epsilon = m_PBFParam.Relaxation / (H * H);
+	const float selfDensity = mass * densityKernel.ValueSquared(0.0f);
+	const uint32_t particleCount = GetParticleCount();
+	const Vector3D wallMin = m_SimParam.WallMin;
+	const Vector3D wallMax = m_SimParam.WallMax;
+
+	double errorSum = m_pThreadPool->ParallelReduce(particleCount, 0.0,
+		[&](uint32_t slot)
+		{
+			Particle& me = m_Particles[slot];
+			const Vector3D position = me.Position;
+			float density = selfDensity;
+			Vector3D gradientSum(0.0f);
+			float gradientSquaredSum = 0.0f;
+			for (uint32_t k = m_StepNeighborStart[slot]; k < m_StepNeighborStart[slot + 1]; ++k)
+			{
+				Vector3D diff = position - m_Particles[m_StepNeighbors[k]].Position;
+				float r2 = diff.dot(diff);
+				density += mass * densityKernel.ValueSquared(r2);
+				float r = std::sqrt(r2);
+				if (r > 1.0e-6f)
+				{
+					// ∇_pj C = -(m/ρ0) ∇W(p_i - p_j)
+					Vector3D gradient = diff * (scale * gradientKernel.Gradient(r) / r);
+					gradientSum += gradient;
+					gradientSquaredSum += gradient.dot(gradient);
+				}
+			}
+
+			// 壁の密度は ρ0 ∫W dV、壁は動かないので |Σ∇C|^2 の項にだけ入る
+			float wallVolume = 0.0f;
+			Vector3D wallGradient(0.0f);
+			m_PBFWallTable.AddBoxWalls(position, wallMin, wallMax, wallVolume, wallGradient);
+			density += restDensity * wallVolume;
+			gradientSum += wallGradient;
+			m_PBFWallGradients[slot] = wallGradient;
+			me.Density = density;
+			me.Pressure = 0.0f;
+
+			float constraint = std::max(density / restDensity - 1.0f, 0.0f);
+			m_PBFLambda[slot] = -constraint / (gradientSum.dot(gradientSum) + gradientSquaredSum + epsilon);
+			return static_cast<double>(constraint);
+		},
+		[](double a, double b) { return a + b; });
+	return (particleCount > 0) ? static_cast<float>(errorSum / particleCount) : 0.0f;
+}
+
+void CPUFluidSolver::ApplyPBFDelta()
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::Kernel<Kernels::Density> densityKernel(H);
+	const SPHKernels::Kernel<Kernels::Pressure> gradientKernel(H);
+	const float scale = m_SimParam.Mass / m_SimParam.RestDensity;
+	const uint32_t particleCount = GetParticleCount();
+
+	// 人工圧力 s_corr = -k (W(r) / W(Δq))^n
+	// λ は 長さ^2 の次元を持つので、k を H^2 倍して H に依らない強さにする
+	const float tensileStrength = m_PBFParam.TensileStrength * H * H;
+	const float tensileExponent = m_PBFParam.TensileExponent;
+	const float deltaQ = m_PBFParam.TensileDeltaQ * H;
+	const float invTensileW = (tensileStrength > 0.0f) ? 1.0f / densityKernel.ValueSquared(deltaQ * deltaQ) : 0.0f;
+
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			const Vector3D position = m_Particles[slot].Position;
+			const float lambda = m_PBFLambda[slot];
+			Vector3D delta(0.0f);
+			for (uint32_t k = m_StepNeighborStart[slot]; k < m_StepNeighborStart[slot + 1]; ++k)
+			{
+				uint32_t neighbor = m_StepNeighbors[k];
+				Vector3D diff = position - m_Particles[neighbor].Position;
+				float r2 = diff.dot(diff);
+				float r = std::sqrt(r2);
+				if (r <= 1.0e-6f)
+				{
+					continue;
+				}
+				float correction = 0.0f;
+				if (tensileStrength > 0.0f)
+				{
+					correction = -tensileStrength * std::pow(densityKernel.ValueSquared(r2) * invTensileW, tensileExponent);
+				}
+				delta += diff * ((lambda + m_PBFLambda[neighbor] + correction) * gradientKernel.Gradient(r) / r);
+			}
+			// 壁は拘束を持たないので λi の分だけ押し返す
+			m_PBFDelta[slot] = delta * scale + m_PBFWallGradients[slot] * lambda;
+		}
+	});
+
+	// 全粒子のΔpを求めてから動かす (Jacobi)
+	const Vector3D wallMin = m_SimParam.WallMin;
+	const Vector3D wallMax = m_SimParam.WallMax;
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& p = m_Particles[slot];
+			p.Position = SPHCommon::ClampToWalls(p.Position + m_PBFDelta[slot], wallMin, wallMax);
+			ProjectOutOfColliders(p.Position, nullptr);
+		}
+	});
+}
+
+void CPUFluidSolver::UpdatePBFVelocity(float deltaTime)
+{
+	const float H = m_SimParam.H;
+	const SPHKernels::Kernel<Kernels::Density> densityKernel(H);
+	const float mass = m_SimParam.Mass;
+	const float viscosity = m_PBFParam.XSPHViscosity;
+	const float invDeltaTime = 1.0f / deltaTime;
+	const uint32_t particleCount = GetParticleCount();
+
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& p = m_Particles[slot];
+			p.Velocity = (p.Position - m_PBFPreviousPositions[m_ParticleIds[slot]]) * invDeltaTime;
+		}
+	});
+
+	// XSPH: 近傍の平均速度に寄せる (全粒子の速度が揃ってから計算するので結果は m_PBFDelta に置く)
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			const Particle& me = m_Particles[slot];
+			Vector3D velocityDelta(0.0f);
+			for (uint32_t k = m_StepNeighborStart[slot]; k < m_StepNeighborStart[slot + 1]; ++k)
+			{
+				const Particle& other = m_Particles[m_StepNeighbors[k]];
+				Vector3D diff = me.Position - other.Position;
+				velocityDelta += (other.Velocity - me.Velocity) * (mass / other.Density * densityKernel.ValueSquared(diff.dot(diff)));
+			}
+			m_PBFDelta[slot] = me.Velocity + velocityDelta * viscosity;
+		}
+	});
+	ParallelForSlots(particleCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t slot = begin; slot < end; ++slot)
+		{
+			Particle& p = m_Particles[slot];
+			p.Velocity = m_PBFDelta[slot];
+			p.Force = Vector3D(0.0f, m_SimParam.Gravity, 0.0f) * p.Density;
+		}
+	});
+}
@@ -0,0 +1,272 @@
+#include "Simulation/Checkpoint.h"
+#include "Simulation/CPUFluidSolver.h"
+
+#include <cstdio>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	uint64_t AlignToPage(uint64_t offset)
+	{
+		return (offset + CheckpointPageSize - 1) / CheckpointPageSize * CheckpointPageSize;
+	}
+
+	// offset まで0で埋めてから data を書く
+	bool WriteAt(std::FILE* pFile, uint64_t& position, uint64_t offset, const void* data, size_t size)
+	{
+		static const uint8_t zeros[CheckpointPageSize] = {};
+		while (position < offset)
+		{
+			size_t padding = static_cast<size_t>(std::min<uint64_t>(offset - position, CheckpointPageSize));
+			if (std::fwrite(zeros, 1, padding, pFile) != padding)
+			{
+				return false;
+			}
+			position += padding;
+		}
+		if (size > 0 && std::fwrite(data, 1, size, pFile) != size)
+		{
+			return false;
+		}
+		position += size;
+		return true;
+	}
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+	Wait();
+}
+
+bool CheckpointWriter::WriteAsync(const CPUFluidSolver& solver, const std::string& path)
+{
+	return WriteAsync([&](CheckpointSnapshot& snapshot) { solver.CaptureCheckpoint(snapshot); }, path);
+}
+
+bool CheckpointWriter::WriteAsync(const std::function<void(CheckpointSnapshot&)>& capture, const std::string& path)
+{
+	if (IsBusy())
+	{
+		return false;
+	}
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+
+	auto start = Clock::now();
+	capture(m_Snapshot);
+	m_CaptureMilliseconds = ElapsedMilliseconds(start);
+
+	m_Busy.store(true, std::memory_order_release);
+	m_Thread = std::thread([this, path]()
+	{
+		auto writeStart = Clock::now();
+		m_Result = Write(m_Snapshot, path);
+		m_WriteMilliseconds = ElapsedMilliseconds(writeStart);
+		m_Busy.store(false, std::memory_order_release);
+	});
+	return true;
+}
+
+bool CheckpointWriter::Wait()
+{
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+	return m_Result;
+}
+
+bool CheckpointWriter::Write(CheckpointSnapshot& snapshot, const std::string& path)
+{
+	// [ヘッダー][粒子][スロット -> ID][κ][κv] をそれぞれページ境界から置く
+	CheckpointHeader& header = snapshot.Header;
+	std::memcpy(header.Magic, CheckpointMagic, sizeof(header.Magic));
+	header.Version = CheckpointVersion;
+	header.HeaderSize = sizeof(CheckpointHeader);
+	header.ParticleSize = sizeof(Particle);
+	header.ParticleCount = static_cast<uint32_t>(snapshot.Particles.size());
+	header.KappaCount = static_cast<uint32_t>(snapshot.Kappa.size());
+	assert(snapshot.ParticleIds.size() == snapshot.Particles.size());
+	assert(snapshot.KappaV.size() == snapshot.Kappa.size());
+
+	const uint64_t particleBytes = sizeof(Particle) * static_cast<uint64_t>(header.ParticleCount);
+	const uint64_t idBytes = sizeof(uint32_t) * static_cast<uint64_t>(header.ParticleCount);
+	const uint64_t kappaBytes = sizeof(float) * static_cast<uint64_t>(header.KappaCount);
+	header.ParticleOffset = AlignToPage(sizeof(CheckpointHeader));
+	header.ParticleIdOffset = AlignToPage(header.ParticleOffset + particleBytes);
+	header.KappaOffset = AlignToPage(header.ParticleIdOffset + idBytes);
+	header.KappaVOffset = AlignToPage(header.KappaOffset + kappaBytes);
+	header.FileSize = header.KappaVOffset + kappaBytes;
+
+	const std::string tempPath = path + ".tmp";
+	std::FILE* pFile = std::fopen(tempPath.c_str(), "wb");
+	if (pFile == nullptr)
+	{
+		return false;
+	}
+	uint64_t position = 0;
+	bool succeeded = WriteAt(pFile, position, 0, &header, sizeof(header)) &&
+		WriteAt(pFile, position, header.ParticleOffset, snapshot.Particles.data(), particleBytes) &&
+		WriteAt(pFile, position, header.ParticleIdOffset, snapshot.ParticleIds.data(), idBytes) &&
+		WriteAt(pFile, position, header.KappaOffset, snapshot.Kappa.data(), kappaBytes) &&
+		WriteAt(pFile, position, header.KappaVOffset, snapshot.KappaV.data(), kappaBytes);
+	assert(!succeeded || position == header.FileSize);
+
+	// 置き換えた後に電源が落ちても中身が残るよう、ディスクに書き出してから名前を変える
+	succeeded = succeeded && std::fflush(pFile) == 0;
+#if defined(_WIN32)
+	succeeded = succeeded && _commit(_fileno(pFile)) == 0;
+#else
+	succeeded = succeeded && fsync(fileno(pFile)) == 0;
+#endif
+	succeeded = (std::fclose(pFile) == 0) && succeeded;
+	if (!succeeded)
+	{
+		std::remove(tempPath.c_str());
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	return !error;
+}
+
+bool CheckpointFile::Open(const std::string& path)
+{
+	Close();
+#if defined(_WIN32)
+	m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize = {};
+	if (GetFileSizeEx(m_File, &fileSize) && fileSize.QuadPart > 0)
+	{
+		m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+	if (m_Mapping != nullptr)
+	{
+		m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+		m_Size = static_cast<size_t>(fileSize.QuadPart);
+	}
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+	struct stat status = {};
+	if (fstat(fd, &status) == 0 && status.st_size > 0)
+	{
+		void* pData = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (pData != MAP_FAILED)
+		{
+			m_pData = static_cast<const uint8_t*>(pData);
+			m_Size = static_cast<size_t>(status.st_size);
+			// 復元はすぐに全体を読むので、先読みさせておく
+			madvise(pData, m_Size, MADV_WILLNEED);
+		}
+	}
+	// マップはファイルを閉じても残る
+	close(fd);
+#endif
+	if (m_pData == nullptr || !Validate())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void CheckpointFile::Close()
+{
+#if defined(_WIN32)
+	if (m_pData != nullptr)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (m_Mapping != nullptr)
+	{
+		CloseHandle(m_Mapping);
+		m_Mapping = nullptr;
+	}
+	if (m_File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_File);
+		m_File = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (m_pData != nullptr)
+	{
+		munmap(const_cast<uint8_t*>(m_pData), m_Size);
+	}
+#endif
+	m_pData = nullptr;
+	m_Size = 0;
+}
+
+bool CheckpointFile::Validate() const
+{
+	if (m_Size < sizeof(CheckpointHeader))
+	{
+		return false;
+	}
+	const CheckpointHeader& header = GetHeader();
+	if (std::memcmp(header.Magic, CheckpointMagic, sizeof(header.Magic)) != 0 ||
+		header.Version != CheckpointVersion ||
+		header.HeaderSize != sizeof(CheckpointHeader) ||
+		header.ParticleSize != sizeof(Particle) ||
+		header.FileSize != m_Size)
+	{
+		return false;
+	}
+	if (header.ParticleCount > header.IdCount || (header.KappaCount != 0 && header.KappaCount != header.IdCount))
+	{
+		return false;
+	}
+
+	// 配列がページ境界から始まり、ファイル内に収まっていること
+	auto isInside = [&](uint64_t offset, uint64_t bytes)
+	{
+		return offset % CheckpointPageSize == 0 && offset <= m_Size && bytes <= m_Size - offset;
+	};
+	if (!isInside(header.ParticleOffset, sizeof(Particle) * static_cast<uint64_t>(header.ParticleCount)) ||
+		!isInside(header.ParticleIdOffset, sizeof(uint32_t) * static_cast<uint64_t>(header.ParticleCount)) ||
+		!isInside(header.KappaOffset, sizeof(float) * static_cast<uint64_t>(header.KappaCount)) ||
+		!isInside(header.KappaVOffset, sizeof(float) * static_cast<uint64_t>(header.KappaCount)))
+	{
+		return false;
+	}
+
+	// 粒子のIDは IdCount 未満で重複しないこと (復元時に ID → スロットの表へそのまま書き込むので、壊れたファイルで範囲外に書かない)
+	const uint32_t* pParticleIds = GetParticleIds();
+	std::vector<bool> used(header.IdCount, false);
+	for (uint32_t slot = 0; slot < header.ParticleCount; ++slot)
+	{
+		const uint32_t id = pParticleIds[slot];
+		if (id >= header.IdCount || used[id])
+		{
+			return false;
+		}
+		used[id] = true;
+	}
+	return true;
+}
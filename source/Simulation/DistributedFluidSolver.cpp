@@ -0,0 +1,269 @@
+#include "Simulation/DistributedFluidSolver.h"
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	template<typename T>
+	void AppendBytes(std::vector<uint8_t>& buffer, const T* data, size_t count)
+	{
+		size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(T) * count);
+		if (count > 0)
+		{
+			std::memcpy(buffer.data() + offset, data, sizeof(T) * count);
+		}
+	}
+
+	// AppendBytes で書いたバッファを先頭から読む
+	class ByteReader
+	{
+	public:
+		explicit ByteReader(const std::vector<uint8_t>& buffer) : m_Buffer(buffer) {}
+
+		template<typename T>
+		void Read(T* data, size_t count)
+		{
+			assert(m_Offset + sizeof(T) * count <= m_Buffer.size());
+			if (count > 0)
+			{
+				std::memcpy(data, m_Buffer.data() + m_Offset, sizeof(T) * count);
+			}
+			m_Offset += sizeof(T) * count;
+		}
+
+	private:
+		const std::vector<uint8_t>& m_Buffer;
+		size_t m_Offset = 0;
+	};
+}
+
+DistributedFluidSolver::DistributedFluidSolver(HaloTransport& transport, uint32_t threadCount)
+	: m_Transport(transport), m_LocalSolver(threadCount)
+{
+	// 部分領域のソルバーも壁は全体の範囲なので、グリッドのメモリが箱全体ではなく粒子数に比例する空間ハッシュにする
+	m_LocalSolver.SetGridBuildMode(GridBuildMode::SpatialHash);
+}
+
+void DistributedFluidSolver::SetSimulationParam(const SimulationParam& param, DecompositionMode mode)
+{
+	m_SimParam = param;
+	m_LocalSolver.SetSimulationParam(param);
+	m_Decomposition = DomainDecomposition(param.WallMin, param.WallMax, GetRankCount(), mode);
+}
+
+void DistributedFluidSolver::SetParticles(const std::vector<Particle>& particles)
+{
+	const uint32_t rank = GetRank();
+	m_OwnedParticles.clear();
+	m_OwnedIds.clear();
+	for (uint32_t id = 0; id < static_cast<uint32_t>(particles.size()); ++id)
+	{
+		if (m_Decomposition.GetRank(particles[id].Position) == rank)
+		{
+			m_OwnedParticles.push_back(particles[id]);
+			m_OwnedIds.push_back(id);
+		}
+	}
+	m_GhostParticles.clear();
+	m_SimulatedTime = 0.0;
+}
+
+void DistributedFluidSolver::PackParticles()
+{
+	const uint32_t rank = GetRank();
+	const uint32_t rankCount = GetRankCount();
+	const float haloWidth = GetHaloWidth();
+	m_Outgoing.resize(rankCount);
+	for (OutgoingParticles& outgoing : m_Outgoing)
+	{
+		outgoing.MigrantIds.clear();
+		outgoing.Migrants.clear();
+		outgoing.Ghosts.clear();
+	}
+	m_GhostParticles.clear();
+	m_Timings.MigratedCount = 0;
+
+	// 残る粒子は前に詰める
+	size_t keepCount = 0;
+	for (size_t i = 0; i < m_OwnedParticles.size(); ++i)
+	{
+		const Particle particle = m_OwnedParticles[i];
+		const uint32_t id = m_OwnedIds[i];
+		uint32_t owner = m_Decomposition.GetRank(particle.Position);
+		if (owner == rank)
+		{
+			m_OwnedParticles[keepCount] = particle;
+			m_OwnedIds[keepCount] = id;
+			++keepCount;
+		}
+		else
+		{
+			m_Outgoing[owner].MigrantIds.push_back(id);
+			m_Outgoing[owner].Migrants.push_back(particle);
+			++m_Timings.MigratedCount;
+		}
+
+		// 新しい持ち主以外で、ハローに掛かる部分領域へゴーストを送る
+		// 出て行った粒子は持ち主からはまだ送られてこないので、自分の部分領域に掛かる場合は自分でゴーストとして残す
+		m_Decomposition.ForEachHaloRank(particle.Position, haloWidth, owner, [&](uint32_t haloRank)
+		{
+			if (haloRank == rank)
+			{
+				m_GhostParticles.push_back(particle);
+			}
+			else
+			{
+				m_Outgoing[haloRank].Ghosts.push_back(particle);
+			}
+		});
+	}
+	m_OwnedParticles.resize(keepCount);
+	m_OwnedIds.resize(keepCount);
+
+	// [移す粒子数][ゴースト数][移す粒子のID][移す粒子][ゴースト]
+	m_SendBuffers.resize(rankCount);
+	m_Timings.SentBytes = 0;
+	for (uint32_t destination = 0; destination < rankCount; ++destination)
+	{
+		std::vector<uint8_t>& buffer = m_SendBuffers[destination];
+		buffer.clear();
+		if (destination == rank)
+		{
+			continue;
+		}
+		const OutgoingParticles& outgoing = m_Outgoing[destination];
+		uint32_t counts[2] = { static_cast<uint32_t>(outgoing.Migrants.size()), static_cast<uint32_t>(outgoing.Ghosts.size()) };
+		AppendBytes(buffer, counts, 2);
+		AppendBytes(buffer, outgoing.MigrantIds.data(), outgoing.MigrantIds.size());
+		AppendBytes(buffer, outgoing.Migrants.data(), outgoing.Migrants.size());
+		AppendBytes(buffer, outgoing.Ghosts.data(), outgoing.Ghosts.size());
+		m_Timings.SentBytes += buffer.size();
+	}
+}
+
+void DistributedFluidSolver::UnpackParticles()
+{
+	const uint32_t rank = GetRank();
+	for (uint32_t source = 0; source < GetRankCount(); ++source)
+	{
+		if (source == rank || m_ReceiveBuffers[source].empty())
+		{
+			continue;
+		}
+		ByteReader reader(m_ReceiveBuffers[source]);
+		uint32_t counts[2];
+		reader.Read(counts, 2);
+		size_t ownedCount = m_OwnedParticles.size();
+		size_t ghostCount = m_GhostParticles.size();
+		m_OwnedIds.resize(ownedCount + counts[0]);
+		m_OwnedParticles.resize(ownedCount + counts[0]);
+		m_GhostParticles.resize(ghostCount + counts[1]);
+		reader.Read(m_OwnedIds.data() + ownedCount, counts[0]);
+		reader.Read(m_OwnedParticles.data() + ownedCount, counts[0]);
+		reader.Read(m_GhostParticles.data() + ghostCount, counts[1]);
+	}
+	m_Timings.GhostCount = static_cast<uint32_t>(m_GhostParticles.size());
+}
+
+bool DistributedFluidSolver::Step()
+{
+	auto start = Clock::now();
+	PackParticles();
+	m_Timings.Pack = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	if (!m_Transport.Exchange(m_SendBuffers, m_ReceiveBuffers))
+	{
+		return false;
+	}
+	m_Timings.Exchange = ElapsedMilliseconds(start);
+
+	start = Clock::now();
+	UnpackParticles();
+	m_Timings.Unpack = ElapsedMilliseconds(start);
+
+	// 自分の粒子を ID 0 .. ownedCount - 1、ゴーストをその後ろにしてソルバーに渡す
+	start = Clock::now();
+	const size_t ownedCount = m_OwnedParticles.size();
+	m_StepParticles.assign(m_OwnedParticles.begin(), m_OwnedParticles.end());
+	m_StepParticles.insert(m_StepParticles.end(), m_GhostParticles.begin(), m_GhostParticles.end());
+	m_LocalSolver.SetParticles(m_StepParticles);
+	m_LocalSolver.Step();
+	m_LocalSolver.CopyParticlesInIdOrder(m_StepParticles);
+	std::copy(m_StepParticles.begin(), m_StepParticles.begin() + ownedCount, m_OwnedParticles.begin());
+	m_Timings.Solve = ElapsedMilliseconds(start);
+
+	m_SimulatedTime += m_SimParam.DeltaTime;
+	return true;
+}
+
+bool DistributedFluidSolver::GatherParticles(std::vector<Particle>& dst)
+{
+	const uint32_t rankCount = GetRankCount();
+	std::vector<std::vector<uint8_t>> sendBuffers(rankCount);
+	uint32_t count = static_cast<uint32_t>(m_OwnedParticles.size());
+	AppendBytes(sendBuffers[0], &count, 1);
+	AppendBytes(sendBuffers[0], m_OwnedIds.data(), m_OwnedIds.size());
+	AppendBytes(sendBuffers[0], m_OwnedParticles.data(), m_OwnedParticles.size());
+
+	std::vector<std::vector<uint8_t>> receiveBuffers;
+	if (!m_Transport.Exchange(sendBuffers, receiveBuffers))
+	{
+		return false;
+	}
+	dst.clear();
+	if (GetRank() != 0)
+	{
+		return true;
+	}
+
+	// 粒子IDは SetParticles で渡した配列のインデックスなので、全rankの合計より小さい
+	std::vector<uint32_t> ids;
+	std::vector<Particle> particles;
+	for (const std::vector<uint8_t>& buffer : receiveBuffers)
+	{
+		ByteReader reader(buffer);
+		uint32_t sourceCount = 0;
+		reader.Read(&sourceCount, 1);
+		size_t offset = ids.size();
+		ids.resize(offset + sourceCount);
+		particles.resize(offset + sourceCount);
+		reader.Read(ids.data() + offset, sourceCount);
+		reader.Read(particles.data() + offset, sourceCount);
+	}
+	dst.resize(particles.size());
+	for (size_t i = 0; i < particles.size(); ++i)
+	{
+		assert(ids[i] < dst.size());
+		dst[ids[i]] = particles[i];
+	}
+	return true;
+}
+
+bool DistributedFluidSolver::AllGather(double value, std::vector<double>& values)
+{
+	const uint32_t rankCount = GetRankCount();
+	std::vector<std::vector<uint8_t>> sendBuffers(rankCount);
+	for (std::vector<uint8_t>& buffer : sendBuffers)
+	{
+		AppendBytes(buffer, &value, 1);
+	}
+	std::vector<std::vector<uint8_t>> receiveBuffers;
+	if (!m_Transport.Exchange(sendBuffers, receiveBuffers))
+	{
+		return false;
+	}
+	values.resize(rankCount);
+	for (uint32_t source = 0; source < rankCount; ++source)
+	{
+		ByteReader reader(receiveBuffers[source]);
+		reader.Read(&values[source], 1);
+	}
+	return true;
+}
@@ -0,0 +1,54 @@
+#include "Simulation/DomainDecomposition.h"
+
+DomainDecomposition::DomainDecomposition(const Vector3D& wallMin, const Vector3D& wallMax, uint32_t rankCount, DecompositionMode mode)
+	: m_WallMin(wallMin)
+{
+	rankCount = std::max(1u, rankCount);
+	Vector3D extent = wallMax - wallMin;
+	int count = static_cast<int>(rankCount);
+
+	if (mode == DecompositionMode::Slab)
+	{
+		if (extent.x >= extent.y && extent.x >= extent.z) m_Dims = { count, 1, 1 };
+		else if (extent.y >= extent.z) m_Dims = { 1, count, 1 };
+		else m_Dims = { 1, 1, count };
+	}
+	else
+	{
+		// 境界面の面積の合計 (= ゴースト粒子の数の目安) が最小になる約数の組を探す
+		float bestArea = -1.0f;
+		for (int x = 1; x <= count; ++x)
+		{
+			if (count % x != 0)
+			{
+				continue;
+			}
+			for (int y = 1; y <= count / x; ++y)
+			{
+				if ((count / x) % y != 0)
+				{
+					continue;
+				}
+				int z = count / (x * y);
+				float area = (x - 1) * extent.y * extent.z + (y - 1) * extent.x * extent.z + (z - 1) * extent.x * extent.y;
+				if (bestArea < 0.0f || area < bestArea)
+				{
+					bestArea = area;
+					m_Dims = { x, y, z };
+				}
+			}
+		}
+	}
+
+	m_SubdomainSize = Vector3D(extent.x / m_Dims.x, extent.y / m_Dims.y, extent.z / m_Dims.z);
+	m_InvSubdomainSize = Vector3D(1.0f / m_SubdomainSize.x, 1.0f / m_SubdomainSize.y, 1.0f / m_SubdomainSize.z);
+}
+
+void DomainDecomposition::GetBounds(uint32_t rank, Vector3D& boundsMin, Vector3D& boundsMax) const
+{
+	int x = static_cast<int>(rank) % m_Dims.x;
+	int y = (static_cast<int>(rank) / m_Dims.x) % m_Dims.y;
+	int z = static_cast<int>(rank) / (m_Dims.x * m_Dims.y);
+	boundsMin = m_WallMin + Vector3D(x * m_SubdomainSize.x, y * m_SubdomainSize.y, z * m_SubdomainSize.z);
+	boundsMax = boundsMin + m_SubdomainSize;
+}
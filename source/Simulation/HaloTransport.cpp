@@ -0,0 +1,401 @@
+#include "Simulation/HaloTransport.h"
+
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+LocalHaloGroup::LocalHaloGroup(uint32_t rankCount)
+	: m_RankCount(std::max(1u, rankCount))
+{
+	m_Mailboxes.resize(m_RankCount, std::vector<std::vector<uint8_t>>(m_RankCount));
+	for (uint32_t rank = 0; rank < m_RankCount; ++rank)
+	{
+		m_Transports.push_back(std::make_unique<LocalHaloTransport>(*this, rank));
+	}
+}
+
+LocalHaloGroup::~LocalHaloGroup() = default;
+
+HaloTransport& LocalHaloGroup::GetTransport(uint32_t rank)
+{
+	assert(rank < m_RankCount);
+	return *m_Transports[rank];
+}
+
+void LocalHaloGroup::Barrier()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	uint64_t generation = m_Generation;
+	if (++m_ArrivedCount == m_RankCount)
+	{
+		m_ArrivedCount = 0;
+		++m_Generation;
+		m_Condition.notify_all();
+		return;
+	}
+	m_Condition.wait(lock, [&] { return m_Generation != generation; });
+}
+
+bool LocalHaloTransport::Exchange(const std::vector<std::vector<uint8_t>>& sendBuffers,
+	std::vector<std::vector<uint8_t>>& receiveBuffers)
+{
+	const uint32_t rankCount = GetRankCount();
+	assert(sendBuffers.size() == rankCount);
+
+	// 自分の行に書き込み、全員が書き終わってから自分宛の列を読む
+	// 読み終わるまで次の Exchange で上書きされないよう、もう1回待つ
+	for (uint32_t rank = 0; rank < rankCount; ++rank)
+	{
+		m_Group.m_Mailboxes[m_Rank][rank] = sendBuffers[rank];
+	}
+	m_Group.Barrier();
+	receiveBuffers.resize(rankCount);
+	for (uint32_t rank = 0; rank < rankCount; ++rank)
+	{
+		receiveBuffers[rank].swap(m_Group.m_Mailboxes[rank][m_Rank]);
+	}
+	m_Group.Barrier();
+	return true;
+}
+
+#if defined(__linux__)
+namespace
+{
+	std::string GetRankSocketPath(const std::string& socketPath, uint32_t rank)
+	{
+		return socketPath + "." + std::to_string(rank);
+	}
+
+	bool MakeAddress(const std::string& path, sockaddr_un& address)
+	{
+		address = {};
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path))
+		{
+			return false;
+		}
+		std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+		return true;
+	}
+
+	// 接続時のrank番号のやり取り用 (ブロッキング)
+	bool SendAll(int socket, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		while (size > 0)
+		{
+			ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+			if (sent <= 0)
+			{
+				return false;
+			}
+			bytes += sent;
+			size -= static_cast<size_t>(sent);
+		}
+		return true;
+	}
+
+	bool ReceiveAll(int socket, void* data, size_t size)
+	{
+		uint8_t* bytes = static_cast<uint8_t*>(data);
+		while (size > 0)
+		{
+			ssize_t received = recv(socket, bytes, size, 0);
+			if (received <= 0)
+			{
+				return false;
+			}
+			bytes += received;
+			size -= static_cast<size_t>(received);
+		}
+		return true;
+	}
+}
+#endif
+
+SocketHaloTransport::SocketHaloTransport(uint32_t rank, uint32_t rankCount, const std::string& socketPath, double timeoutSeconds)
+	: m_Rank(rank), m_RankCount(std::max(1u, rankCount)), m_TimeoutSeconds(timeoutSeconds)
+{
+	m_PeerSockets.assign(m_RankCount, -1);
+#if defined(__linux__)
+	assert(rank < m_RankCount);
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeoutSeconds);
+
+	// 先に待ち受けを始めてから小さいrankへ接続する (大きいrankからの接続はlistenのキューで待たせる)
+	int listenSocket = -1;
+	std::string listenPath = GetRankSocketPath(socketPath, m_Rank);
+	if (m_Rank + 1 < m_RankCount)
+	{
+		sockaddr_un address;
+		if (!MakeAddress(listenPath, address))
+		{
+			return;
+		}
+		listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+		unlink(listenPath.c_str());
+		if (listenSocket < 0 ||
+			bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+			listen(listenSocket, static_cast<int>(m_RankCount)) != 0)
+		{
+			if (listenSocket >= 0)
+			{
+				close(listenSocket);
+			}
+			return;
+		}
+	}
+
+	bool succeeded = true;
+	for (uint32_t peer = 0; peer < m_Rank && succeeded; ++peer)
+	{
+		sockaddr_un address;
+		succeeded = MakeAddress(GetRankSocketPath(socketPath, peer), address);
+		// 相手がまだ待ち受けていなければ、期限まで繰り返す
+		while (succeeded)
+		{
+			int peerSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (peerSocket >= 0 && connect(peerSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+			{
+				m_PeerSockets[peer] = peerSocket;
+				succeeded = SendAll(peerSocket, &m_Rank, sizeof(m_Rank));
+				break;
+			}
+			if (peerSocket >= 0)
+			{
+				close(peerSocket);
+			}
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				succeeded = false;
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+
+	// 大きいrankからの接続を受け、最初に送られてくるrank番号で相手を区別する
+	for (uint32_t accepted = m_Rank + 1; accepted < m_RankCount && succeeded; ++accepted)
+	{
+		pollfd listenPoll = { listenSocket, POLLIN, 0 };
+		int remainingMs = static_cast<int>(std::chrono::duration<double, std::milli>(deadline - std::chrono::steady_clock::now()).count());
+		if (remainingMs <= 0 || poll(&listenPoll, 1, remainingMs) <= 0)
+		{
+			succeeded = false;
+			break;
+		}
+		int peerSocket = accept(listenSocket, nullptr, nullptr);
+		uint32_t peer = 0;
+		if (peerSocket < 0 || !ReceiveAll(peerSocket, &peer, sizeof(peer)) ||
+			peer <= m_Rank || peer >= m_RankCount || m_PeerSockets[peer] != -1)
+		{
+			if (peerSocket >= 0)
+			{
+				close(peerSocket);
+			}
+			succeeded = false;
+			break;
+		}
+		m_PeerSockets[peer] = peerSocket;
+	}
+
+	if (listenSocket >= 0)
+	{
+		close(listenSocket);
+		unlink(listenPath.c_str());
+	}
+	if (!succeeded)
+	{
+		CloseSockets();
+		return;
+	}
+	// Exchange では送受信を poll で進めるので、ブロックしないようにする
+	for (int peerSocket : m_PeerSockets)
+	{
+		if (peerSocket >= 0)
+		{
+			fcntl(peerSocket, F_SETFL, fcntl(peerSocket, F_GETFL, 0) | O_NONBLOCK);
+		}
+	}
+	m_IsConnected = true;
+#else
+	(void)socketPath;
+	m_IsConnected = (m_RankCount == 1);
+#endif
+}
+
+SocketHaloTransport::~SocketHaloTransport()
+{
+	CloseSockets();
+}
+
+void SocketHaloTransport::CloseSockets()
+{
+#if defined(__linux__)
+	for (int& peerSocket : m_PeerSockets)
+	{
+		if (peerSocket >= 0)
+		{
+			close(peerSocket);
+			peerSocket = -1;
+		}
+	}
+#endif
+	m_IsConnected = false;
+}
+
+bool SocketHaloTransport::Exchange(const std::vector<std::vector<uint8_t>>& sendBuffers,
+	std::vector<std::vector<uint8_t>>& receiveBuffers)
+{
+	assert(sendBuffers.size() == m_RankCount);
+	receiveBuffers.resize(m_RankCount);
+	receiveBuffers[m_Rank] = sendBuffers[m_Rank];
+	if (!m_IsConnected)
+	{
+		return m_RankCount == 1;
+	}
+#if defined(__linux__)
+	// 相手毎の進み具合 (先頭8byteはサイズ)
+	struct PeerProgress
+	{
+		uint64_t SendSize = 0;
+		size_t SentBytes = 0;
+		uint64_t ReceiveSize = 0;
+		size_t ReceivedBytes = 0;
+	};
+	const size_t headerSize = sizeof(uint64_t);
+	std::vector<PeerProgress> progress(m_RankCount);
+	uint32_t pendingCount = 0;
+	for (uint32_t peer = 0; peer < m_RankCount; ++peer)
+	{
+		if (peer != m_Rank)
+		{
+			progress[peer].SendSize = sendBuffers[peer].size();
+			receiveBuffers[peer].clear();
+			pendingCount += 2;
+		}
+	}
+
+	auto isSendDone = [&](uint32_t peer) { return progress[peer].SentBytes == headerSize + progress[peer].SendSize; };
+	auto isReceiveDone = [&](uint32_t peer)
+	{
+		return progress[peer].ReceivedBytes >= headerSize && progress[peer].ReceivedBytes == headerSize + progress[peer].ReceiveSize;
+	};
+
+	std::vector<pollfd> pollFds;
+	std::vector<uint32_t> pollPeers;
+	const int timeoutMs = static_cast<int>(m_TimeoutSeconds * 1000.0);
+	while (pendingCount > 0)
+	{
+		pollFds.clear();
+		pollPeers.clear();
+		for (uint32_t peer = 0; peer < m_RankCount; ++peer)
+		{
+			if (peer == m_Rank)
+			{
+				continue;
+			}
+			short events = 0;
+			if (!isSendDone(peer)) events |= POLLOUT;
+			if (!isReceiveDone(peer)) events |= POLLIN;
+			if (events != 0)
+			{
+				pollFds.push_back({ m_PeerSockets[peer], events, 0 });
+				pollPeers.push_back(peer);
+			}
+		}
+		if (poll(pollFds.data(), pollFds.size(), timeoutMs) <= 0)
+		{
+			CloseSockets();
+			return false;
+		}
+
+		for (size_t i = 0; i < pollFds.size(); ++i)
+		{
+			uint32_t peer = pollPeers[i];
+			PeerProgress& state = progress[peer];
+			int peerSocket = pollFds[i].fd;
+			short revents = pollFds[i].revents;
+			if ((revents & (POLLERR | POLLNVAL)) != 0)
+			{
+				CloseSockets();
+				return false;
+			}
+
+			if ((revents & POLLOUT) != 0 && !isSendDone(peer))
+			{
+				const uint8_t* data;
+				size_t size;
+				if (state.SentBytes < headerSize)
+				{
+					data = reinterpret_cast<const uint8_t*>(&state.SendSize) + state.SentBytes;
+					size = headerSize - state.SentBytes;
+				}
+				else
+				{
+					data = sendBuffers[peer].data() + (state.SentBytes - headerSize);
+					size = headerSize + state.SendSize - state.SentBytes;
+				}
+				ssize_t sent = send(peerSocket, data, size, MSG_NOSIGNAL);
+				if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+				{
+					CloseSockets();
+					return false;
+				}
+				if (sent > 0)
+				{
+					state.SentBytes += static_cast<size_t>(sent);
+					if (isSendDone(peer))
+					{
+						--pendingCount;
+					}
+				}
+			}
+
+			if ((revents & (POLLIN | POLLHUP)) != 0 && !isReceiveDone(peer))
+			{
+				uint8_t* data;
+				size_t size;
+				if (state.ReceivedBytes < headerSize)
+				{
+					data = reinterpret_cast<uint8_t*>(&state.ReceiveSize) + state.ReceivedBytes;
+					size = headerSize - state.ReceivedBytes;
+				}
+				else
+				{
+					data = receiveBuffers[peer].data() + (state.ReceivedBytes - headerSize);
+					size = headerSize + state.ReceiveSize - state.ReceivedBytes;
+				}
+				ssize_t received = recv(peerSocket, data, size, 0);
+				// 0 は相手が切断した
+				if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+				{
+					CloseSockets();
+					return false;
+				}
+				if (received > 0)
+				{
+					state.ReceivedBytes += static_cast<size_t>(received);
+					if (state.ReceivedBytes == headerSize)
+					{
+						receiveBuffers[peer].resize(state.ReceiveSize);
+					}
+					if (isReceiveDone(peer))
+					{
+						--pendingCount;
+					}
+				}
+			}
+		}
+	}
+	return true;
+#else
+	return false;
+#endif
+}
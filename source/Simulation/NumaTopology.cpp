@@ -0,0 +1,170 @@
+#include "Simulation/NumaTopology.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(__linux__)
+	// "0-3,8-11" 形式のCPUリストを読む
+	std::vector<uint32_t> ParseCpuList(const std::string& text)
+	{
+		std::vector<uint32_t> cpus;
+		size_t pos = 0;
+		while (pos < text.size())
+		{
+			size_t comma = text.find(',', pos);
+			if (comma == std::string::npos) comma = text.size();
+			std::string range = text.substr(pos, comma - pos);
+			size_t dash = range.find('-');
+			uint32_t first = static_cast<uint32_t>(std::strtoul(range.c_str(), nullptr, 10));
+			uint32_t last = (dash == std::string::npos) ? first : static_cast<uint32_t>(std::strtoul(range.c_str() + dash + 1, nullptr, 10));
+			if (!range.empty() && range[0] >= '0' && range[0] <= '9')
+			{
+				for (uint32_t cpu = first; cpu <= last; ++cpu)
+				{
+					cpus.push_back(cpu);
+				}
+			}
+			pos = comma + 1;
+		}
+		return cpus;
+	}
+#endif
+}
+
+NumaTopology NumaTopology::Detect()
+{
+	NumaTopology topology;
+#if defined(__linux__)
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	bool hasAffinity = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+	// ノード番号は連続しているとは限らない (オフラインのノードを飛ばす)
+	std::ifstream online("/sys/devices/system/node/online");
+	std::string onlineText;
+	if (online && std::getline(online, onlineText))
+	{
+		for (uint32_t node : ParseCpuList(onlineText))
+		{
+			std::ifstream cpuList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+			std::string cpuText;
+			std::vector<uint32_t> cpus;
+			if (cpuList && std::getline(cpuList, cpuText))
+			{
+				for (uint32_t cpu : ParseCpuList(cpuText))
+				{
+					if (!hasAffinity || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)))
+					{
+						cpus.push_back(cpu);
+					}
+				}
+			}
+			// メモリだけのノードや、使えるCPUのないノードにはスレッドを割り当てない
+			if (!cpus.empty())
+			{
+				topology.m_NodeCpus.push_back(cpus);
+				topology.m_NodeIds.push_back(node);
+			}
+		}
+	}
+	if (topology.m_NodeCpus.empty() && hasAffinity)
+	{
+		std::vector<uint32_t> cpus;
+		for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+		{
+			if (CPU_ISSET(cpu, &allowed))
+			{
+				cpus.push_back(cpu);
+			}
+		}
+		if (!cpus.empty())
+		{
+			topology.m_NodeCpus.push_back(cpus);
+			topology.m_NodeIds.push_back(0);
+		}
+	}
+#elif defined(_WIN32)
+	ULONG highestNode = 0;
+	if (GetNumaHighestNodeNumber(&highestNode))
+	{
+		for (USHORT node = 0; node <= highestNode; ++node)
+		{
+			// プロセッサグループをまたぐ場合 (64論理CPU超) は最初のグループだけを使う
+			GROUP_AFFINITY affinity = {};
+			if (!GetNumaNodeProcessorMaskEx(node, &affinity) || affinity.Group != 0)
+			{
+				continue;
+			}
+			std::vector<uint32_t> cpus;
+			for (uint32_t cpu = 0; cpu < 64; ++cpu)
+			{
+				if (affinity.Mask & (KAFFINITY(1) << cpu))
+				{
+					cpus.push_back(cpu);
+				}
+			}
+			if (!cpus.empty())
+			{
+				topology.m_NodeCpus.push_back(cpus);
+				topology.m_NodeIds.push_back(node);
+			}
+		}
+	}
+#endif
+	if (topology.m_NodeCpus.empty())
+	{
+		std::vector<uint32_t> cpus(std::max(1u, std::thread::hardware_concurrency()));
+		for (uint32_t cpu = 0; cpu < cpus.size(); ++cpu)
+		{
+			cpus[cpu] = cpu;
+		}
+		topology.m_NodeCpus.push_back(cpus);
+		topology.m_NodeIds.push_back(0);
+	}
+	return topology;
+}
+
+void NumaTopology::AssignThreads(uint32_t threadCount, std::vector<uint32_t>& threadCpus, std::vector<uint32_t>& threadNodes) const
+{
+	const uint32_t nodeCount = GetNodeCount();
+	threadCpus.resize(threadCount);
+	threadNodes.resize(threadCount);
+	std::vector<uint32_t> nodeThreadCount(nodeCount, 0);
+	for (uint32_t thread = 0; thread < threadCount; ++thread)
+	{
+		uint32_t node = static_cast<uint32_t>(static_cast<uint64_t>(thread) * nodeCount / threadCount);
+		const std::vector<uint32_t>& cpus = m_NodeCpus[node];
+		threadCpus[thread] = cpus[nodeThreadCount[node]++ % cpus.size()];
+		threadNodes[thread] = node;
+	}
+}
+
+void NumaTopology::QueryPageNodes(const void* const* pPages, size_t count, int* pNodes)
+{
+#if defined(__linux__) && defined(SYS_move_pages)
+	// nodes = nullptr の move_pages はページの現在のノードを status に返すだけ
+	std::vector<void*> pages(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		pages[i] = const_cast<void*>(pPages[i]);
+	}
+	if (count > 0 && syscall(SYS_move_pages, 0, count, pages.data(), nullptr, pNodes, 0) == 0)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			pNodes[i] = std::max(pNodes[i], -1); // 未割り当て (-ENOENT) などのエラー
+		}
+		return;
+	}
+#endif
+	std::fill(pNodes, pNodes + count, -1);
+}
@@ -0,0 +1,441 @@
+#include "Simulation/ParticleExporter.h"
+#include "Simulation/CPUFluidSolver.h"
+
+#include <charconv>
+#include <cstdio>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// 整形してからまとめて fwrite する粒子数
+	const size_t ExportBatchSize = 4096;
+
+	bool IsLittleEndianHost()
+	{
+		const uint16_t one = 1;
+		uint8_t firstByte;
+		std::memcpy(&firstByte, &one, 1);
+		return firstByte == 1;
+	}
+
+	// 4byteの値を指定したバイト順で書く (VTKはビッグエンディアン、PLYはリトルエンディアン)
+	template <class T>
+	uint8_t* Store(uint8_t* pDst, T value, bool bigEndian)
+	{
+		static_assert(sizeof(T) == 4, "only 4 byte values");
+		uint32_t bits;
+		std::memcpy(&bits, &value, 4);
+		if (bigEndian == IsLittleEndianHost())
+		{
+			bits = (bits >> 24) | ((bits >> 8) & 0xff00u) | ((bits << 8) & 0xff0000u) | (bits << 24);
+		}
+		std::memcpy(pDst, &bits, 4);
+		return pDst + 4;
+	}
+
+	class FileOutput
+	{
+	public:
+		explicit FileOutput(const std::string& path) : m_pFile(std::fopen(path.c_str(), "wb")) {}
+		~FileOutput()
+		{
+			if (m_pFile != nullptr)
+			{
+				std::fclose(m_pFile);
+			}
+		}
+
+		bool IsOpen() const { return m_pFile != nullptr; }
+		uint64_t GetBytes() const { return m_Bytes; }
+
+		bool Write(const void* data, size_t size)
+		{
+			m_Succeeded = m_Succeeded && (size == 0 || std::fwrite(data, 1, size, m_pFile) == size);
+			m_Bytes += size;
+			return m_Succeeded;
+		}
+		bool Write(const std::string& text) { return Write(text.data(), text.size()); }
+
+		/// <summary>
+		/// 粒子を ExportBatchSize 個ずつ store(particle, index, pDst) で bytesPerParticle バイトに整形して書きます
+		/// </summary>
+		template <class StoreFunc>
+		bool WriteParticles(const std::vector<Particle>& particles, size_t bytesPerParticle, StoreFunc store)
+		{
+			m_Scratch.resize(ExportBatchSize * bytesPerParticle);
+			for (size_t begin = 0; begin < particles.size() && m_Succeeded; begin += ExportBatchSize)
+			{
+				size_t end = std::min(particles.size(), begin + ExportBatchSize);
+				uint8_t* pDst = m_Scratch.data();
+				for (size_t i = begin; i < end; ++i)
+				{
+					pDst = store(particles[i], static_cast<uint32_t>(i), pDst);
+				}
+				Write(m_Scratch.data(), static_cast<size_t>(pDst - m_Scratch.data()));
+			}
+			return m_Succeeded;
+		}
+
+		bool Close()
+		{
+			bool succeeded = m_Succeeded && std::fclose(m_pFile) == 0;
+			m_pFile = nullptr;
+			return succeeded;
+		}
+
+	private:
+		std::FILE* m_pFile;
+		uint64_t m_Bytes = 0;
+		bool m_Succeeded = true;
+		std::vector<uint8_t> m_Scratch;
+	};
+
+	void WriteVTK(FileOutput& output, const std::vector<Particle>& particles, double time, const ExportParam& param)
+	{
+		const uint32_t count = static_cast<uint32_t>(particles.size());
+		char text[128];
+
+		// 経過時間は FIELD の TIME として書くと ParaView が時刻として扱う
+		output.Write("# vtk DataFile Version 3.0\nTinyFluidSimulation particles\nBINARY\nDATASET POLYDATA\n"
+			"FIELD FieldData 1\nTIME 1 1 double\n");
+		uint64_t timeBits;
+		std::memcpy(&timeBits, &time, 8);
+		uint8_t timeBytes[8];
+		Store(timeBytes, static_cast<uint32_t>(timeBits >> 32), true);
+		Store(timeBytes + 4, static_cast<uint32_t>(timeBits), true);
+		output.Write(timeBytes, 8);
+
+		std::snprintf(text, sizeof(text), "\nPOINTS %u float\n", count);
+		output.Write(text, std::strlen(text));
+		output.WriteParticles(particles, 12, [](const Particle& particle, uint32_t, uint8_t* pDst)
+		{
+			pDst = Store(pDst, particle.Position.x, true);
+			pDst = Store(pDst, particle.Position.y, true);
+			return Store(pDst, particle.Position.z, true);
+		});
+		if (count == 0)
+		{
+			output.Write("\n", 1);
+			return;
+		}
+
+		// 全粒子を1つの頂点セルにまとめる (セルがないと点として表示されないビューアがある)
+		std::snprintf(text, sizeof(text), "\nVERTICES 1 %u\n", count + 1);
+		output.Write(text, std::strlen(text));
+		uint8_t countBytes[4];
+		Store(countBytes, count, true);
+		output.Write(countBytes, 4);
+		output.WriteParticles(particles, 4, [](const Particle&, uint32_t index, uint8_t* pDst)
+		{
+			return Store(pDst, index, true);
+		});
+
+		std::snprintf(text, sizeof(text), "\nPOINT_DATA %u\n", count);
+		output.Write(text, std::strlen(text));
+		if (param.Density)
+		{
+			output.Write("SCALARS density float 1\nLOOKUP_TABLE default\n");
+			output.WriteParticles(particles, 4, [](const Particle& particle, uint32_t, uint8_t* pDst) { return Store(pDst, particle.Density, true); });
+			output.Write("\n", 1);
+		}
+		if (param.Pressure)
+		{
+			output.Write("SCALARS pressure float 1\nLOOKUP_TABLE default\n");
+			output.WriteParticles(particles, 4, [](const Particle& particle, uint32_t, uint8_t* pDst) { return Store(pDst, particle.Pressure, true); });
+			output.Write("\n", 1);
+		}
+		if (param.Velocity)
+		{
+			output.Write("VECTORS velocity float\n");
+			output.WriteParticles(particles, 12, [](const Particle& particle, uint32_t, uint8_t* pDst)
+			{
+				pDst = Store(pDst, particle.Velocity.x, true);
+				pDst = Store(pDst, particle.Velocity.y, true);
+				return Store(pDst, particle.Velocity.z, true);
+			});
+			output.Write("\n", 1);
+		}
+	}
+
+	void WritePLY(FileOutput& output, const std::vector<Particle>& particles, double time, const ExportParam& param)
+	{
+		char text[128];
+		std::snprintf(text, sizeof(text), "ply\nformat binary_little_endian 1.0\ncomment time %.17g\nelement vertex %zu\n", time, particles.size());
+		std::string header = text;
+		header += "property float x\nproperty float y\nproperty float z\n";
+		if (param.Velocity)
+		{
+			header += "property float vx\nproperty float vy\nproperty float vz\n";
+		}
+		if (param.Density)
+		{
+			header += "property float density\n";
+		}
+		if (param.Pressure)
+		{
+			header += "property float pressure\n";
+		}
+		header += "end_header\n";
+		output.Write(header);
+
+		// 属性は頂点毎に並べる
+		size_t bytesPerParticle = 12 + (param.Velocity ? 12 : 0) + (param.Density ? 4 : 0) + (param.Pressure ? 4 : 0);
+		output.WriteParticles(particles, bytesPerParticle, [&](const Particle& particle, uint32_t, uint8_t* pDst)
+		{
+			pDst = Store(pDst, particle.Position.x, false);
+			pDst = Store(pDst, particle.Position.y, false);
+			pDst = Store(pDst, particle.Position.z, false);
+			if (param.Velocity)
+			{
+				pDst = Store(pDst, particle.Velocity.x, false);
+				pDst = Store(pDst, particle.Velocity.y, false);
+				pDst = Store(pDst, particle.Velocity.z, false);
+			}
+			if (param.Density)
+			{
+				pDst = Store(pDst, particle.Density, false);
+			}
+			if (param.Pressure)
+			{
+				pDst = Store(pDst, particle.Pressure, false);
+			}
+			return pDst;
+		});
+	}
+
+	void WriteCSV(FileOutput& output, const std::vector<Particle>& particles, const ExportParam& param)
+	{
+		std::string header = "x,y,z";
+		if (param.Velocity)
+		{
+			header += ",vx,vy,vz";
+		}
+		if (param.Density)
+		{
+			header += ",density";
+		}
+		if (param.Pressure)
+		{
+			header += ",pressure";
+		}
+		header += "\n";
+		output.Write(header);
+
+		// float は最短で元の値に戻る桁数 (最大 15文字) で書く
+		const size_t MaxValueLength = 16;
+		size_t valuesPerParticle = 3 + (param.Velocity ? 3 : 0) + (param.Density ? 1 : 0) + (param.Pressure ? 1 : 0);
+		output.WriteParticles(particles, valuesPerParticle * MaxValueLength, [&](const Particle& particle, uint32_t, uint8_t* pDst)
+		{
+			char* pText = reinterpret_cast<char*>(pDst);
+			char* pEnd = pText + valuesPerParticle * MaxValueLength;
+			auto put = [&](float value, char separator)
+			{
+				pText = std::to_chars(pText, pEnd, value).ptr;
+				*pText++ = separator;
+			};
+			put(particle.Position.x, ',');
+			put(particle.Position.y, ',');
+			put(particle.Position.z, valuesPerParticle > 3 ? ',' : '\n');
+			if (param.Velocity)
+			{
+				put(particle.Velocity.x, ',');
+				put(particle.Velocity.y, ',');
+				put(particle.Velocity.z, (param.Density || param.Pressure) ? ',' : '\n');
+			}
+			if (param.Density)
+			{
+				put(particle.Density, param.Pressure ? ',' : '\n');
+			}
+			if (param.Pressure)
+			{
+				put(particle.Pressure, '\n');
+			}
+			return reinterpret_cast<uint8_t*>(pText);
+		});
+	}
+}
+
+ParticleExporter::~ParticleExporter()
+{
+	Close();
+}
+
+bool ParticleExporter::Open(const std::string& pathPrefix, const ExportParam& param)
+{
+	Close();
+	std::filesystem::path directory = std::filesystem::path(pathPrefix).parent_path();
+	std::error_code error;
+	if (!directory.empty() && !std::filesystem::exists(directory, error) && !std::filesystem::create_directories(directory, error))
+	{
+		return false;
+	}
+
+	m_Param = param;
+	m_Param.BufferCount = std::max(1u, param.BufferCount);
+	m_PathPrefix = pathPrefix;
+	m_Stats = ExportStats();
+	m_Frames.resize(m_Param.BufferCount);
+	m_FreeFrames.clear();
+	for (auto& pFrame : m_Frames)
+	{
+		pFrame = std::make_unique<Frame>();
+		m_FreeFrames.push_back(pFrame.get());
+	}
+	m_PendingFrames.clear();
+	m_Writing = false;
+	m_Stop = false;
+	m_Thread = std::thread(&ParticleExporter::WriterThread, this);
+	return true;
+}
+
+void ParticleExporter::Close()
+{
+	if (!IsOpen())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stop = true;
+	}
+	m_PendingCondition.notify_one();
+	m_Thread.join();
+	m_FreeFrames.clear();
+	m_Frames.clear();
+}
+
+bool ParticleExporter::Submit(const CPUFluidSolver& solver, uint64_t frame)
+{
+	return Submit([&](std::vector<Particle>& particles) { solver.CopyParticlesInIdOrder(particles); }, frame, solver.GetSimulatedTime());
+}
+
+bool ParticleExporter::Submit(const std::function<void(std::vector<Particle>&)>& capture, uint64_t frame, double time)
+{
+	if (!IsOpen())
+	{
+		return false;
+	}
+
+	Frame* pFrame = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		++m_Stats.SubmittedFrames;
+		if (!m_FreeFrames.empty())
+		{
+			pFrame = m_FreeFrames.back();
+			m_FreeFrames.pop_back();
+		}
+		else if (m_Param.DropPolicy == ExportDropPolicy::ReplaceOldest && !m_PendingFrames.empty())
+		{
+			pFrame = m_PendingFrames.front();
+			m_PendingFrames.pop_front();
+			++m_Stats.DroppedFrames;
+		}
+		else
+		{
+			// 書き込みを待つとステップが止まるので、このフレームは捨てる
+			++m_Stats.DroppedFrames;
+			return false;
+		}
+	}
+
+	// 書き込みのスレッドが持っていないバッファなので、ロックせずに写す
+	auto start = Clock::now();
+	capture(pFrame->Particles);
+	pFrame->Index = frame;
+	pFrame->Time = time;
+	double captureMilliseconds = ElapsedMilliseconds(start);
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		++m_Stats.CapturedFrames;
+		m_Stats.CaptureMilliseconds += captureMilliseconds;
+		m_PendingFrames.push_back(pFrame);
+	}
+	m_PendingCondition.notify_one();
+	return true;
+}
+
+void ParticleExporter::Flush()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_IdleCondition.wait(lock, [&]() { return m_PendingFrames.empty() && !m_Writing; });
+}
+
+ExportStats ParticleExporter::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Stats;
+}
+
+std::string ParticleExporter::GetFramePath(uint64_t frame) const
+{
+	static const char* const extensions[] = { "vtk", "ply", "csv" };
+	char suffix[64];
+	std::snprintf(suffix, sizeof(suffix), "_%06llu.%s", static_cast<unsigned long long>(frame), extensions[static_cast<int>(m_Param.Format)]);
+	return m_PathPrefix + suffix;
+}
+
+uint64_t ParticleExporter::WriteFile(const std::vector<Particle>& particles, double time, const std::string& path, const ExportParam& param)
+{
+	FileOutput output(path);
+	if (!output.IsOpen())
+	{
+		return 0;
+	}
+	switch (param.Format)
+	{
+	case ExportFormat::VTK:
+		WriteVTK(output, particles, time, param);
+		break;
+	case ExportFormat::PLY:
+		WritePLY(output, particles, time, param);
+		break;
+	case ExportFormat::CSV:
+		WriteCSV(output, particles, param);
+		break;
+	}
+	return output.Close() ? output.GetBytes() : 0;
+}
+
+void ParticleExporter::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true)
+	{
+		// 止める場合も、待っているフレームは書き終える
+		m_PendingCondition.wait(lock, [&]() { return m_Stop || !m_PendingFrames.empty(); });
+		if (m_PendingFrames.empty())
+		{
+			break;
+		}
+		Frame* pFrame = m_PendingFrames.front();
+		m_PendingFrames.pop_front();
+		m_Writing = true;
+		lock.unlock();
+
+		auto start = Clock::now();
+		uint64_t bytes = WriteFile(pFrame->Particles, pFrame->Time, GetFramePath(pFrame->Index), m_Param);
+		double writeMilliseconds = ElapsedMilliseconds(start);
+
+		lock.lock();
+		if (bytes > 0)
+		{
+			++m_Stats.WrittenFrames;
+			m_Stats.WrittenBytes += bytes;
+		}
+		else
+		{
+			++m_Stats.FailedFrames;
+		}
+		m_Stats.WriteMilliseconds += writeMilliseconds;
+		m_FreeFrames.push_back(pFrame);
+		m_Writing = false;
+		m_IdleCondition.notify_all();
+	}
+}
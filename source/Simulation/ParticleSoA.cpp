@@ -0,0 +1,76 @@
+#include "Simulation/ParticleSoA.h"
+
+void ParticleSoA::Resize(uint32_t count)
+{
+	for (auto* pArray : { &PositionX, &PositionY, &PositionZ,
+		&VelocityX, &VelocityY, &VelocityZ,
+		&ForceX, &ForceY, &ForceZ,
+		&Density, &NearDensity, &Pressure })
+	{
+		pArray->resize(count);
+	}
+}
+
+void ParticleSoA::LoadFromAoS(const Particle* pSrc, uint32_t begin, uint32_t end, uint32_t fields)
+{
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		const Particle& p = pSrc[i];
+		if (fields & FieldPosition)
+		{
+			PositionX[i] = p.Position.x;
+			PositionY[i] = p.Position.y;
+			PositionZ[i] = p.Position.z;
+		}
+		if (fields & FieldVelocity)
+		{
+			VelocityX[i] = p.Velocity.x;
+			VelocityY[i] = p.Velocity.y;
+			VelocityZ[i] = p.Velocity.z;
+		}
+		if (fields & FieldForce)
+		{
+			ForceX[i] = p.Force.x;
+			ForceY[i] = p.Force.y;
+			ForceZ[i] = p.Force.z;
+		}
+		if (fields & FieldDensity)
+		{
+			Density[i] = p.Density;
+			NearDensity[i] = p.NearDensity;
+		}
+		if (fields & FieldPressure)
+		{
+			Pressure[i] = p.Pressure;
+		}
+	}
+}
+
+void ParticleSoA::StoreToAoS(Particle* pDst, uint32_t begin, uint32_t end, uint32_t fields) const
+{
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		Particle& p = pDst[i];
+		if (fields & FieldPosition)
+		{
+			p.Position = Vector3D(PositionX[i], PositionY[i], PositionZ[i]);
+		}
+		if (fields & FieldVelocity)
+		{
+			p.Velocity = Vector3D(VelocityX[i], VelocityY[i], VelocityZ[i]);
+		}
+		if (fields & FieldForce)
+		{
+			p.Force = Vector3D(ForceX[i], ForceY[i], ForceZ[i]);
+		}
+		if (fields & FieldDensity)
+		{
+			p.Density = Density[i];
+			p.NearDensity = NearDensity[i];
+		}
+		if (fields & FieldPressure)
+		{
+			p.Pressure = Pressure[i];
+		}
+	}
+}
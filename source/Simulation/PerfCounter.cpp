@@ -0,0 +1,77 @@
+#include "Simulation/PerfCounter.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PerfCounter::PerfCounter(Event event)
+{
+#if defined(__linux__)
+	perf_event_attr attr = {};
+	attr.size = sizeof(attr);
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.inherit = 1;
+	switch (event)
+	{
+	case Event::CacheMisses:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		break;
+	case Event::CacheReferences:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_REFERENCES;
+		break;
+	case Event::L1DReadMisses:
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_L1D |
+			(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		break;
+	}
+	m_FileDescriptor = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+	(void)event;
+#endif
+}
+
+PerfCounter::~PerfCounter()
+{
+#if defined(__linux__)
+	if (m_FileDescriptor >= 0)
+	{
+		close(m_FileDescriptor);
+	}
+#endif
+}
+
+void PerfCounter::Start()
+{
+#if defined(__linux__)
+	if (m_FileDescriptor >= 0)
+	{
+		ioctl(m_FileDescriptor, PERF_EVENT_IOC_RESET, 0);
+		ioctl(m_FileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+	}
+#endif
+}
+
+uint64_t PerfCounter::Stop()
+{
+	uint64_t value = 0;
+#if defined(__linux__)
+	if (m_FileDescriptor >= 0)
+	{
+		ioctl(m_FileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(m_FileDescriptor, &value, sizeof(value)) != sizeof(value))
+		{
+			value = 0;
+		}
+	}
+#endif
+	return value;
+}
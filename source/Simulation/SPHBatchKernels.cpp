@@ -0,0 +1,232 @@
+#include "Simulation/SPHBatchKernels.h"
+#include "Simulation/SPHKernels.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SPH_BATCH_KERNELS_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SPH_BATCH_KERNELS_X86)
+const SPHBatchKernels& GetSPHBatchKernelsAVX2();
+const SPHBatchKernels& GetSPHBatchKernelsAVX512();
+#endif
+
+namespace
+{
+	void AccumulateDensityScalar(const ParticleSoA& soa, uint32_t begin, uint32_t end,
+		float px, float py, float pz, const SPHBatchCoefficients& coef,
+		float& density, float& nearDensity)
+	{
+		float sumW = 0.0f;
+		float sumNear = 0.0f;
+		for (uint32_t j = begin; j < end; ++j)
+		{
+			float dx = px - soa.PositionX[j];
+			float dy = py - soa.PositionY[j];
+			float dz = pz - soa.PositionZ[j];
+			float r2 = dx * dx + dy * dy + dz * dz;
+			float r = std::sqrt(r2);
+			if (r < coef.H)
+			{
+				float term = coef.H2 - r2;
+				float hr = coef.H - r;
+				sumW += term * term * term;
+				sumNear += hr * hr * hr;
+			}
+		}
+		density += coef.Mass * coef.Poly6 * sumW;
+		nearDensity += coef.Mass * coef.NearDensity * sumNear;
+	}
+
+	void AccumulateForceScalar(const ParticleSoA& soa, uint32_t begin, uint32_t end,
+		uint32_t self, const SPHBatchCoefficients& coef,
+		Vector3D& pressureForce, Vector3D& viscosityForce)
+	{
+		const float px = soa.PositionX[self];
+		const float py = soa.PositionY[self];
+		const float pz = soa.PositionZ[self];
+		const float vx = soa.VelocityX[self];
+		const float vy = soa.VelocityY[self];
+		const float vz = soa.VelocityZ[self];
+		const float myPressure = soa.Pressure[self];
+		const float myNearPressure = coef.NearStiffness * soa.NearDensity[self];
+
+		for (uint32_t j = begin; j < end; ++j)
+		{
+			float dx = px - soa.PositionX[j];
+			float dy = py - soa.PositionY[j];
+			float dz = pz - soa.PositionZ[j];
+			float r2 = dx * dx + dy * dy + dz * dz;
+			float otherDensity = soa.Density[j];
+			float otherNearDensity = soa.NearDensity[j];
+			if (r2 >= coef.H2 || r2 < 0.00001f || otherDensity == 0.0f || otherNearDensity == 0.0f)
+			{
+				continue;
+			}
+			float r = std::sqrt(r2);
+			float hr = coef.H - r;
+
+			// 圧力項 + 近傍圧力 (dir = diff / r)
+			float sharedPressure = (myPressure + soa.Pressure[j]) * 0.5f;
+			float sharedNearPressure = (myNearPressure + coef.NearStiffness * otherNearDensity) * 0.5f;
+			float scale = -coef.Mass * (sharedPressure * coef.Spiky * hr * hr / otherDensity +
+				sharedNearPressure * coef.NearSpiky * hr / otherNearDensity) / r;
+			pressureForce += Vector3D(dx, dy, dz) * scale;
+
+			// 粘性項
+			float viscosityWeight = coef.Mass * coef.ViscosityLaplacian * hr / otherDensity;
+			viscosityForce += Vector3D(soa.VelocityX[j] - vx, soa.VelocityY[j] - vy, soa.VelocityZ[j] - vz) * viscosityWeight;
+		}
+	}
+
+	void DecomposeSymmetric3x3Scalar(const float* const matrix[6], float* const eigenvalues[3], float* const eigenvectors[9], uint32_t count)
+	{
+		// (p, q) の回転で消す非対角成分と、残りの軸 r
+		const uint32_t Pairs[3][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 2, 0 } };
+		for (uint32_t n = 0; n < count; ++n)
+		{
+			float a[3][3] =
+			{
+				{ matrix[0][n], matrix[1][n], matrix[2][n] },
+				{ matrix[1][n], matrix[3][n], matrix[4][n] },
+				{ matrix[2][n], matrix[4][n], matrix[5][n] },
+			};
+			float v[3][3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+			for (uint32_t sweep = 0; sweep < JacobiSweepCount; ++sweep)
+			{
+				for (const auto& pair : Pairs)
+				{
+					const uint32_t p = pair[0];
+					const uint32_t q = pair[1];
+					const uint32_t r = pair[2];
+					const float apq = a[p][q];
+					if (apq == 0.0f)
+					{
+						continue;
+					}
+					// a'pq = 0 となる回転 (tan の小さい方の解)
+					const float theta = (a[q][q] - a[p][p]) / (2.0f * apq);
+					const float t = std::copysign(1.0f / (std::abs(theta) + std::sqrt(theta * theta + 1.0f)), theta);
+					const float c = 1.0f / std::sqrt(t * t + 1.0f);
+					const float s = t * c;
+					a[p][p] -= t * apq;
+					a[q][q] += t * apq;
+					a[p][q] = a[q][p] = 0.0f;
+					const float arp = a[r][p];
+					const float arq = a[r][q];
+					a[r][p] = a[p][r] = c * arp - s * arq;
+					a[r][q] = a[q][r] = s * arp + c * arq;
+					for (uint32_t k = 0; k < 3; ++k)
+					{
+						const float vkp = v[k][p];
+						const float vkq = v[k][q];
+						v[k][p] = c * vkp - s * vkq;
+						v[k][q] = s * vkp + c * vkq;
+					}
+				}
+			}
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				eigenvalues[k][n] = a[k][k];
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					eigenvectors[3 * k + c][n] = v[c][k];
+				}
+			}
+		}
+	}
+
+	const SPHBatchKernels ScalarKernels = { SIMDLevel::Scalar, AccumulateDensityScalar, AccumulateForceScalar, DecomposeSymmetric3x3Scalar };
+}
+
+const char* ToString(SIMDLevel level)
+{
+	switch (level)
+	{
+	case SIMDLevel::AVX2: return "AVX2";
+	case SIMDLevel::AVX512: return "AVX-512";
+	default: return "Scalar";
+	}
+}
+
+SPHBatchCoefficients SPHBatchCoefficients::Create(const SimulationParam& param)
+{
+	// 正規化係数はSPHKernelsのポリシーと共通
+	const float h = param.H;
+	SPHBatchCoefficients coef;
+	coef.H = h;
+	coef.H2 = h * h;
+	coef.Mass = param.Mass;
+	coef.NearStiffness = param.nearStiffness;
+	coef.Poly6 = SPHKernels::Poly6::Prepare(h).Value;
+	coef.NearDensity = SPHKernels::Spiky::Prepare(h).Value;
+	coef.Spiky = SPHKernels::Spiky::Prepare(h).Gradient;
+	coef.NearSpiky = SPHKernels::SpikyQuadratic::Prepare(h).Gradient;
+	coef.ViscosityLaplacian = SPHKernels::ViscosityLaplacian::Prepare(h).Laplacian;
+	return coef;
+}
+
+SIMDLevel DetectSIMDLevel()
+{
+#if defined(SPH_BATCH_KERNELS_X86)
+#if defined(_MSC_VER)
+	int info[4] = {};
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool fma = (info[2] & (1 << 12)) != 0;
+	if (!osxsave)
+	{
+		return SIMDLevel::Scalar;
+	}
+	// OSがYMM/ZMMレジスタを保存するか
+	unsigned long long xcr0 = _xgetbv(0);
+	bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+	bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;
+	__cpuidex(info, 7, 0);
+	bool avx2 = (info[1] & (1 << 5)) != 0;
+	bool avx512f = (info[1] & (1 << 16)) != 0;
+	if (avx512f && zmmEnabled)
+	{
+		return SIMDLevel::AVX512;
+	}
+	if (avx2 && fma && ymmEnabled)
+	{
+		return SIMDLevel::AVX2;
+	}
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return SIMDLevel::AVX512;
+	}
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		return SIMDLevel::AVX2;
+	}
+#endif
+#endif
+	return SIMDLevel::Scalar;
+}
+
+const SPHBatchKernels& GetSPHBatchKernels(SIMDLevel level)
+{
+	// CPUが対応していないレベルを要求された場合は使えるところまで下げる
+	SIMDLevel supported = DetectSIMDLevel();
+	if (static_cast<int>(level) > static_cast<int>(supported))
+	{
+		level = supported;
+	}
+#if defined(SPH_BATCH_KERNELS_X86)
+	if (level == SIMDLevel::AVX512)
+	{
+		return GetSPHBatchKernelsAVX512();
+	}
+	if (level == SIMDLevel::AVX2)
+	{
+		return GetSPHBatchKernelsAVX2();
+	}
+#endif
+	return ScalarKernels;
+}
@@ -0,0 +1,224 @@
+#include "Simulation/SPHBatchKernels.h"
+
+// このファイルはAVX2 + FMAを有効にしてコンパイルする (CMakeLists.txt参照)
+// 呼び出しはDetectSIMDLevelで対応を確認してから
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+
+namespace
+{
+	const int TailMaskTable[16] = { -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+	// 先頭count個のレーンだけ有効なマスク
+	inline __m256i TailMask(uint32_t count)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(TailMaskTable + 8 - count));
+	}
+
+	inline __m256 Load(const float* ptr, uint32_t count, __m256i mask)
+	{
+		return (count >= 8) ? _mm256_loadu_ps(ptr) : _mm256_maskload_ps(ptr, mask);
+	}
+
+	inline float HorizontalSum(__m256 v)
+	{
+		__m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+		return _mm_cvtss_f32(sum);
+	}
+
+	void AccumulateDensityAVX2(const ParticleSoA& soa, uint32_t begin, uint32_t end,
+		float px, float py, float pz, const SPHBatchCoefficients& coef,
+		float& density, float& nearDensity)
+	{
+		const __m256 vpx = _mm256_set1_ps(px);
+		const __m256 vpy = _mm256_set1_ps(py);
+		const __m256 vpz = _mm256_set1_ps(pz);
+		const __m256 h = _mm256_set1_ps(coef.H);
+		const __m256 h2 = _mm256_set1_ps(coef.H2);
+		__m256 sumW = _mm256_setzero_ps();
+		__m256 sumNear = _mm256_setzero_ps();
+
+		for (uint32_t j = begin; j < end; j += 8)
+		{
+			uint32_t count = std::min(8u, end - j);
+			__m256i mask = TailMask(count);
+			__m256 dx = _mm256_sub_ps(vpx, Load(&soa.PositionX[j], count, mask));
+			__m256 dy = _mm256_sub_ps(vpy, Load(&soa.PositionY[j], count, mask));
+			__m256 dz = _mm256_sub_ps(vpz, Load(&soa.PositionZ[j], count, mask));
+			__m256 r2 = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+			__m256 r = _mm256_sqrt_ps(r2);
+
+			// r < h かつ 有効なレーン
+			__m256 inRange = _mm256_and_ps(_mm256_cmp_ps(r, h, _CMP_LT_OQ), _mm256_castsi256_ps(mask));
+			__m256 term = _mm256_sub_ps(h2, r2);
+			__m256 hr = _mm256_sub_ps(h, r);
+			__m256 w = _mm256_mul_ps(_mm256_mul_ps(term, term), term);
+			__m256 nearW = _mm256_mul_ps(_mm256_mul_ps(hr, hr), hr);
+			sumW = _mm256_add_ps(sumW, _mm256_and_ps(inRange, w));
+			sumNear = _mm256_add_ps(sumNear, _mm256_and_ps(inRange, nearW));
+		}
+		density += coef.Mass * coef.Poly6 * HorizontalSum(sumW);
+		nearDensity += coef.Mass * coef.NearDensity * HorizontalSum(sumNear);
+	}
+
+	void AccumulateForceAVX2(const ParticleSoA& soa, uint32_t begin, uint32_t end,
+		uint32_t self, const SPHBatchCoefficients& coef,
+		Vector3D& pressureForce, Vector3D& viscosityForce)
+	{
+		const __m256 px = _mm256_set1_ps(soa.PositionX[self]);
+		const __m256 py = _mm256_set1_ps(soa.PositionY[self]);
+		const __m256 pz = _mm256_set1_ps(soa.PositionZ[self]);
+		const __m256 vx = _mm256_set1_ps(soa.VelocityX[self]);
+		const __m256 vy = _mm256_set1_ps(soa.VelocityY[self]);
+		const __m256 vz = _mm256_set1_ps(soa.VelocityZ[self]);
+		const __m256 myPressure = _mm256_set1_ps(soa.Pressure[self]);
+		const __m256 myNearPressure = _mm256_set1_ps(coef.NearStiffness * soa.NearDensity[self]);
+		const __m256 h = _mm256_set1_ps(coef.H);
+		const __m256 h2 = _mm256_set1_ps(coef.H2);
+		const __m256 minR2 = _mm256_set1_ps(0.00001f);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 nearStiffness = _mm256_set1_ps(coef.NearStiffness);
+		const __m256 negMassSpiky = _mm256_set1_ps(-coef.Mass * coef.Spiky);
+		const __m256 negMassNearSpiky = _mm256_set1_ps(-coef.Mass * coef.NearSpiky);
+		const __m256 massViscosity = _mm256_set1_ps(coef.Mass * coef.ViscosityLaplacian);
+
+		__m256 fx = zero, fy = zero, fz = zero;
+		__m256 visX = zero, visY = zero, visZ = zero;
+
+		for (uint32_t j = begin; j < end; j += 8)
+		{
+			uint32_t count = std::min(8u, end - j);
+			__m256i tail = TailMask(count);
+			__m256 dx = _mm256_sub_ps(px, Load(&soa.PositionX[j], count, tail));
+			__m256 dy = _mm256_sub_ps(py, Load(&soa.PositionY[j], count, tail));
+			__m256 dz = _mm256_sub_ps(pz, Load(&soa.PositionZ[j], count, tail));
+			__m256 r2 = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+			__m256 otherDensity = Load(&soa.Density[j], count, tail);
+			__m256 otherNearDensity = Load(&soa.NearDensity[j], count, tail);
+
+			// 影響範囲内・自分以外・密度0以外
+			__m256 mask = _mm256_castsi256_ps(tail);
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(r2, h2, _CMP_LT_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(r2, minR2, _CMP_GE_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(otherDensity, zero, _CMP_NEQ_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(otherNearDensity, zero, _CMP_NEQ_OQ));
+			if (_mm256_movemask_ps(mask) == 0)
+			{
+				continue;
+			}
+
+			__m256 r = _mm256_sqrt_ps(r2);
+			__m256 hr = _mm256_sub_ps(h, r);
+			__m256 invDensity = _mm256_div_ps(_mm256_set1_ps(1.0f), otherDensity);
+
+			// 圧力項 + 近傍圧力
+			__m256 sharedPressure = _mm256_mul_ps(_mm256_add_ps(myPressure, Load(&soa.Pressure[j], count, tail)), half);
+			__m256 sharedNearPressure = _mm256_mul_ps(_mm256_fmadd_ps(nearStiffness, otherNearDensity, myNearPressure), half);
+			__m256 pressureTerm = _mm256_mul_ps(_mm256_mul_ps(negMassSpiky, sharedPressure), _mm256_mul_ps(_mm256_mul_ps(hr, hr), invDensity));
+			__m256 nearTerm = _mm256_div_ps(_mm256_mul_ps(_mm256_mul_ps(negMassNearSpiky, sharedNearPressure), hr), otherNearDensity);
+			__m256 scale = _mm256_and_ps(mask, _mm256_div_ps(_mm256_add_ps(pressureTerm, nearTerm), r));
+			fx = _mm256_fmadd_ps(dx, scale, fx);
+			fy = _mm256_fmadd_ps(dy, scale, fy);
+			fz = _mm256_fmadd_ps(dz, scale, fz);
+
+			// 粘性項
+			__m256 viscosityWeight = _mm256_and_ps(mask, _mm256_mul_ps(_mm256_mul_ps(massViscosity, hr), invDensity));
+			visX = _mm256_fmadd_ps(_mm256_sub_ps(Load(&soa.VelocityX[j], count, tail), vx), viscosityWeight, visX);
+			visY = _mm256_fmadd_ps(_mm256_sub_ps(Load(&soa.VelocityY[j], count, tail), vy), viscosityWeight, visY);
+			visZ = _mm256_fmadd_ps(_mm256_sub_ps(Load(&soa.VelocityZ[j], count, tail), vz), viscosityWeight, visZ);
+		}
+
+		pressureForce += Vector3D(HorizontalSum(fx), HorizontalSum(fy), HorizontalSum(fz));
+		viscosityForce += Vector3D(HorizontalSum(visX), HorizontalSum(visY), HorizontalSum(visZ));
+	}
+
+	void DecomposeSymmetric3x3AVX2(const float* const matrix[6], float* const eigenvalues[3], float* const eigenvectors[9], uint32_t count)
+	{
+		// 対称行列の (行, 列) -> matrix の成分、(p, q) の回転で消す非対角成分と残りの軸 r
+		const uint32_t Element[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+		const uint32_t Pairs[3][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 2, 0 } };
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+		for (uint32_t n = 0; n < count; n += 8)
+		{
+			const uint32_t lanes = std::min(8u, count - n);
+			// 端数のレーンは単位行列で埋める
+			alignas(32) float tail[6][8];
+			__m256 a[6];
+			for (uint32_t e = 0; e < 6; ++e)
+			{
+				if (lanes == 8)
+				{
+					a[e] = _mm256_loadu_ps(matrix[e] + n);
+					continue;
+				}
+				for (uint32_t lane = 0; lane < 8; ++lane)
+				{
+					tail[e][lane] = (lane < lanes) ? matrix[e][n + lane] : ((e == 0 || e == 3 || e == 5) ? 1.0f : 0.0f);
+				}
+				a[e] = _mm256_load_ps(tail[e]);
+			}
+			__m256 v[9] = { one, zero, zero, zero, one, zero, zero, zero, one };
+
+			for (uint32_t sweep = 0; sweep < JacobiSweepCount; ++sweep)
+			{
+				for (const auto& pair : Pairs)
+				{
+					const uint32_t p = pair[0];
+					const uint32_t q = pair[1];
+					const uint32_t r = pair[2];
+					const __m256 apq = a[Element[p][q]];
+					// apq が0のレーンは回転しない (t = 0)
+					const __m256 isValid = _mm256_cmp_ps(apq, zero, _CMP_NEQ_OQ);
+					const __m256 theta = _mm256_div_ps(_mm256_mul_ps(_mm256_sub_ps(a[Element[q][q]], a[Element[p][p]]), half), _mm256_blendv_ps(one, apq, isValid));
+					const __m256 absTheta = _mm256_andnot_ps(signMask, theta);
+					__m256 t = _mm256_div_ps(one, _mm256_add_ps(absTheta, _mm256_sqrt_ps(_mm256_fmadd_ps(theta, theta, one))));
+					t = _mm256_and_ps(isValid, _mm256_or_ps(t, _mm256_and_ps(theta, signMask)));
+					const __m256 c = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_fmadd_ps(t, t, one)));
+					const __m256 s = _mm256_mul_ps(t, c);
+					const __m256 tapq = _mm256_mul_ps(t, apq);
+					a[Element[p][p]] = _mm256_sub_ps(a[Element[p][p]], tapq);
+					a[Element[q][q]] = _mm256_add_ps(a[Element[q][q]], tapq);
+					a[Element[p][q]] = _mm256_andnot_ps(isValid, apq);
+					const __m256 arp = a[Element[r][p]];
+					const __m256 arq = a[Element[r][q]];
+					a[Element[r][p]] = _mm256_fmsub_ps(c, arp, _mm256_mul_ps(s, arq));
+					a[Element[r][q]] = _mm256_fmadd_ps(s, arp, _mm256_mul_ps(c, arq));
+					for (uint32_t k = 0; k < 3; ++k)
+					{
+						const __m256 vkp = v[3 * k + p];
+						const __m256 vkq = v[3 * k + q];
+						v[3 * k + p] = _mm256_fmsub_ps(c, vkp, _mm256_mul_ps(s, vkq));
+						v[3 * k + q] = _mm256_fmadd_ps(s, vkp, _mm256_mul_ps(c, vkq));
+					}
+				}
+			}
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				alignas(32) float values[8];
+				_mm256_store_ps(values, a[Element[k][k]]);
+				std::copy(values, values + lanes, eigenvalues[k] + n);
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					_mm256_store_ps(values, v[3 * c + k]);
+					std::copy(values, values + lanes, eigenvectors[3 * k + c] + n);
+				}
+			}
+		}
+	}
+
+	const SPHBatchKernels AVX2Kernels = { SIMDLevel::AVX2, AccumulateDensityAVX2, AccumulateForceAVX2, DecomposeSymmetric3x3AVX2 };
+}
+
+const SPHBatchKernels& GetSPHBatchKernelsAVX2()
+{
+	return AVX2Kernels;
+}
+#endif
@@ -0,0 +1,190 @@
+#include "Simulation/SPHBatchKernels.h"
+
+// このファイルはAVX-512Fを有効にしてコンパイルする (CMakeLists.txt参照)
+// 呼び出しはDetectSIMDLevelで対応を確認してから
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+
+namespace
+{
+	// 先頭count個のレーンだけ有効なマスク
+	inline __mmask16 TailMask(uint32_t count)
+	{
+		return static_cast<__mmask16>((1u << count) - 1u);
+	}
+
+	void AccumulateDensityAVX512(const ParticleSoA& soa, uint32_t begin, uint32_t end,
+		float px, float py, float pz, const SPHBatchCoefficients& coef,
+		float& density, float& nearDensity)
+	{
+		const __m512 vpx = _mm512_set1_ps(px);
+		const __m512 vpy = _mm512_set1_ps(py);
+		const __m512 vpz = _mm512_set1_ps(pz);
+		const __m512 h = _mm512_set1_ps(coef.H);
+		const __m512 h2 = _mm512_set1_ps(coef.H2);
+		__m512 sumW = _mm512_setzero_ps();
+		__m512 sumNear = _mm512_setzero_ps();
+
+		for (uint32_t j = begin; j < end; j += 16)
+		{
+			__mmask16 tail = TailMask(std::min(16u, end - j));
+			__m512 dx = _mm512_sub_ps(vpx, _mm512_maskz_loadu_ps(tail, &soa.PositionX[j]));
+			__m512 dy = _mm512_sub_ps(vpy, _mm512_maskz_loadu_ps(tail, &soa.PositionY[j]));
+			__m512 dz = _mm512_sub_ps(vpz, _mm512_maskz_loadu_ps(tail, &soa.PositionZ[j]));
+			__m512 r2 = _mm512_fmadd_ps(dz, dz, _mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dx, dx)));
+			__m512 r = _mm512_sqrt_ps(r2);
+
+			// r < h かつ 有効なレーン
+			__mmask16 inRange = _mm512_mask_cmp_ps_mask(tail, r, h, _CMP_LT_OQ);
+			__m512 term = _mm512_sub_ps(h2, r2);
+			__m512 hr = _mm512_sub_ps(h, r);
+			sumW = _mm512_mask_add_ps(sumW, inRange, sumW, _mm512_mul_ps(_mm512_mul_ps(term, term), term));
+			sumNear = _mm512_mask_add_ps(sumNear, inRange, sumNear, _mm512_mul_ps(_mm512_mul_ps(hr, hr), hr));
+		}
+		density += coef.Mass * coef.Poly6 * _mm512_reduce_add_ps(sumW);
+		nearDensity += coef.Mass * coef.NearDensity * _mm512_reduce_add_ps(sumNear);
+	}
+
+	void AccumulateForceAVX512(const ParticleSoA& soa, uint32_t begin, uint32_t end,
+		uint32_t self, const SPHBatchCoefficients& coef,
+		Vector3D& pressureForce, Vector3D& viscosityForce)
+	{
+		const __m512 px = _mm512_set1_ps(soa.PositionX[self]);
+		const __m512 py = _mm512_set1_ps(soa.PositionY[self]);
+		const __m512 pz = _mm512_set1_ps(soa.PositionZ[self]);
+		const __m512 vx = _mm512_set1_ps(soa.VelocityX[self]);
+		const __m512 vy = _mm512_set1_ps(soa.VelocityY[self]);
+		const __m512 vz = _mm512_set1_ps(soa.VelocityZ[self]);
+		const __m512 myPressure = _mm512_set1_ps(soa.Pressure[self]);
+		const __m512 myNearPressure = _mm512_set1_ps(coef.NearStiffness * soa.NearDensity[self]);
+		const __m512 h = _mm512_set1_ps(coef.H);
+		const __m512 h2 = _mm512_set1_ps(coef.H2);
+		const __m512 minR2 = _mm512_set1_ps(0.00001f);
+		const __m512 zero = _mm512_setzero_ps();
+		const __m512 half = _mm512_set1_ps(0.5f);
+		const __m512 nearStiffness = _mm512_set1_ps(coef.NearStiffness);
+		const __m512 negMassSpiky = _mm512_set1_ps(-coef.Mass * coef.Spiky);
+		const __m512 negMassNearSpiky = _mm512_set1_ps(-coef.Mass * coef.NearSpiky);
+		const __m512 massViscosity = _mm512_set1_ps(coef.Mass * coef.ViscosityLaplacian);
+
+		__m512 fx = zero, fy = zero, fz = zero;
+		__m512 visX = zero, visY = zero, visZ = zero;
+
+		for (uint32_t j = begin; j < end; j += 16)
+		{
+			__mmask16 tail = TailMask(std::min(16u, end - j));
+			__m512 dx = _mm512_sub_ps(px, _mm512_maskz_loadu_ps(tail, &soa.PositionX[j]));
+			__m512 dy = _mm512_sub_ps(py, _mm512_maskz_loadu_ps(tail, &soa.PositionY[j]));
+			__m512 dz = _mm512_sub_ps(pz, _mm512_maskz_loadu_ps(tail, &soa.PositionZ[j]));
+			__m512 r2 = _mm512_fmadd_ps(dz, dz, _mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dx, dx)));
+			__m512 otherDensity = _mm512_maskz_loadu_ps(tail, &soa.Density[j]);
+			__m512 otherNearDensity = _mm512_maskz_loadu_ps(tail, &soa.NearDensity[j]);
+
+			// 影響範囲内・自分以外・密度0以外
+			__mmask16 mask = _mm512_mask_cmp_ps_mask(tail, r2, h2, _CMP_LT_OQ);
+			mask = _mm512_mask_cmp_ps_mask(mask, r2, minR2, _CMP_GE_OQ);
+			mask = _mm512_mask_cmp_ps_mask(mask, otherDensity, zero, _CMP_NEQ_OQ);
+			mask = _mm512_mask_cmp_ps_mask(mask, otherNearDensity, zero, _CMP_NEQ_OQ);
+			if (mask == 0)
+			{
+				continue;
+			}
+
+			__m512 r = _mm512_sqrt_ps(r2);
+			__m512 hr = _mm512_sub_ps(h, r);
+			__m512 invDensity = _mm512_maskz_div_ps(mask, _mm512_set1_ps(1.0f), otherDensity);
+
+			// 圧力項 + 近傍圧力
+			__m512 sharedPressure = _mm512_mul_ps(_mm512_add_ps(myPressure, _mm512_maskz_loadu_ps(tail, &soa.Pressure[j])), half);
+			__m512 sharedNearPressure = _mm512_mul_ps(_mm512_fmadd_ps(nearStiffness, otherNearDensity, myNearPressure), half);
+			__m512 pressureTerm = _mm512_mul_ps(_mm512_mul_ps(negMassSpiky, sharedPressure), _mm512_mul_ps(_mm512_mul_ps(hr, hr), invDensity));
+			__m512 nearTerm = _mm512_maskz_div_ps(mask, _mm512_mul_ps(_mm512_mul_ps(negMassNearSpiky, sharedNearPressure), hr), otherNearDensity);
+			__m512 scale = _mm512_maskz_div_ps(mask, _mm512_add_ps(pressureTerm, nearTerm), r);
+			fx = _mm512_fmadd_ps(dx, scale, fx);
+			fy = _mm512_fmadd_ps(dy, scale, fy);
+			fz = _mm512_fmadd_ps(dz, scale, fz);
+
+			// 粘性項
+			__m512 viscosityWeight = _mm512_mul_ps(_mm512_mul_ps(massViscosity, hr), invDensity);
+			visX = _mm512_fmadd_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(tail, &soa.VelocityX[j]), vx), viscosityWeight, visX);
+			visY = _mm512_fmadd_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(tail, &soa.VelocityY[j]), vy), viscosityWeight, visY);
+			visZ = _mm512_fmadd_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(tail, &soa.VelocityZ[j]), vz), viscosityWeight, visZ);
+		}
+
+		pressureForce += Vector3D(_mm512_reduce_add_ps(fx), _mm512_reduce_add_ps(fy), _mm512_reduce_add_ps(fz));
+		viscosityForce += Vector3D(_mm512_reduce_add_ps(visX), _mm512_reduce_add_ps(visY), _mm512_reduce_add_ps(visZ));
+	}
+
+	void DecomposeSymmetric3x3AVX512(const float* const matrix[6], float* const eigenvalues[3], float* const eigenvectors[9], uint32_t count)
+	{
+		// 対称行列の (行, 列) -> matrix の成分、(p, q) の回転で消す非対角成分と残りの軸 r
+		const uint32_t Element[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+		const uint32_t Pairs[3][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 2, 0 } };
+		const __m512 zero = _mm512_setzero_ps();
+		const __m512 one = _mm512_set1_ps(1.0f);
+		const __m512 half = _mm512_set1_ps(0.5f);
+
+		for (uint32_t n = 0; n < count; n += 16)
+		{
+			// 端数のレーンは単位行列で埋める
+			const __mmask16 tail = TailMask(std::min(16u, count - n));
+			__m512 a[6];
+			for (uint32_t e = 0; e < 6; ++e)
+			{
+				a[e] = _mm512_mask_loadu_ps((e == 0 || e == 3 || e == 5) ? one : zero, tail, matrix[e] + n);
+			}
+			__m512 v[9] = { one, zero, zero, zero, one, zero, zero, zero, one };
+
+			for (uint32_t sweep = 0; sweep < JacobiSweepCount; ++sweep)
+			{
+				for (const auto& pair : Pairs)
+				{
+					const uint32_t p = pair[0];
+					const uint32_t q = pair[1];
+					const uint32_t r = pair[2];
+					const __m512 apq = a[Element[p][q]];
+					// apq が0のレーンは回転しない (t = 0)
+					const __mmask16 isValid = _mm512_cmp_ps_mask(apq, zero, _CMP_NEQ_OQ);
+					const __m512 theta = _mm512_div_ps(_mm512_mul_ps(_mm512_sub_ps(a[Element[q][q]], a[Element[p][p]]), half), _mm512_mask_blend_ps(isValid, one, apq));
+					__m512 t = _mm512_div_ps(one, _mm512_add_ps(_mm512_abs_ps(theta), _mm512_sqrt_ps(_mm512_fmadd_ps(theta, theta, one))));
+					t = _mm512_maskz_mov_ps(isValid, _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(t),
+						_mm512_and_si512(_mm512_castps_si512(theta), _mm512_set1_epi32(static_cast<int>(0x80000000u))))));
+					const __m512 c = _mm512_div_ps(one, _mm512_sqrt_ps(_mm512_fmadd_ps(t, t, one)));
+					const __m512 s = _mm512_mul_ps(t, c);
+					const __m512 tapq = _mm512_mul_ps(t, apq);
+					a[Element[p][p]] = _mm512_sub_ps(a[Element[p][p]], tapq);
+					a[Element[q][q]] = _mm512_add_ps(a[Element[q][q]], tapq);
+					a[Element[p][q]] = _mm512_maskz_mov_ps(static_cast<__mmask16>(~isValid), apq);
+					const __m512 arp = a[Element[r][p]];
+					const __m512 arq = a[Element[r][q]];
+					a[Element[r][p]] = _mm512_fmsub_ps(c, arp, _mm512_mul_ps(s, arq));
+					a[Element[r][q]] = _mm512_fmadd_ps(s, arp, _mm512_mul_ps(c, arq));
+					for (uint32_t k = 0; k < 3; ++k)
+					{
+						const __m512 vkp = v[3 * k + p];
+						const __m512 vkq = v[3 * k + q];
+						v[3 * k + p] = _mm512_fmsub_ps(c, vkp, _mm512_mul_ps(s, vkq));
+						v[3 * k + q] = _mm512_fmadd_ps(s, vkp, _mm512_mul_ps(c, vkq));
+					}
+				}
+			}
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				_mm512_mask_storeu_ps(eigenvalues[k] + n, tail, a[Element[k][k]]);
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					_mm512_mask_storeu_ps(eigenvectors[3 * k + c] + n, tail, v[3 * c + k]);
+				}
+			}
+		}
+	}
+
+	const SPHBatchKernels AVX512Kernels = { SIMDLevel::AVX512, AccumulateDensityAVX512, AccumulateForceAVX512, DecomposeSymmetric3x3AVX512 };
+}
+
+const SPHBatchKernels& GetSPHBatchKernelsAVX512()
+{
+	return AVX512Kernels;
+}
+#endif
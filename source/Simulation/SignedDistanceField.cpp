@@ -0,0 +1,514 @@
+#include "Simulation/SignedDistanceField.h"
+#include "Simulation/ThreadPool.h"
+#include "Simulation/TriangleBVH.h"
+
+#include <cstdio>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// キャッシュファイルの先頭 (書いた環境と構造体のレイアウトが同じである必要がある)
+	struct SDFFileHeader
+	{
+		char Magic[8];
+		uint32_t Version;
+		uint32_t HeaderSize;  // sizeof(SDFFileHeader)
+		uint64_t Key;         // SignedDistanceField::MakeCacheKey
+		float Origin[3];
+		float CellSize;
+		uint32_t Dim[3];
+		float BandDistance;
+		uint64_t ValueCount;
+	};
+
+	const char SDFMagic[8] = { 'T', 'F', 'S', 'S', 'D', 'F', '\0', '\0' };
+	const uint32_t SDFVersion = 1;
+
+	const uint64_t FNVOffsetBasis = 14695981039346656037ull;
+	const uint64_t FNVPrime = 1099511628211ull;
+
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* pBytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ pBytes[i]) * FNVPrime;
+		}
+		return hash;
+	}
+
+	// 点 p から三角形 abc への距離の2乗
+	float PointTriangleDistance2(const Vector3D& p, const Vector3D& a, const Vector3D& b, const Vector3D& c)
+	{
+		const Vector3D diff = p - ClosestPointOnTriangle(p, a, b, c);
+		return diff.dot(diff);
+	}
+
+	// 原点から見た辺 (x1, y1) -> (x2, y2) の向き (面積が0の場合も座標の比較で必ず片側に決め、共有する辺上の点を2回数えない)
+	int Orientation(double x1, double y1, double x2, double y2, double& twiceSignedArea)
+	{
+		twiceSignedArea = y1 * x2 - x1 * y2;
+		if (twiceSignedArea > 0.0) return 1;
+		if (twiceSignedArea < 0.0) return -1;
+		if (y2 > y1) return 1;
+		if (y2 < y1) return -1;
+		if (x1 > x2) return 1;
+		if (x1 < x2) return -1;
+		return 0;
+	}
+
+	// 点 (x0, y0) が xy に投影した三角形の内側なら重心座標を返す
+	bool PointInTriangle2D(double x0, double y0, double x1, double y1, double x2, double y2, double x3, double y3,
+		double& a, double& b, double& c)
+	{
+		x1 -= x0; x2 -= x0; x3 -= x0;
+		y1 -= y0; y2 -= y0; y3 -= y0;
+		const int signA = Orientation(x2, y2, x3, y3, a);
+		if (signA == 0) return false;
+		const int signB = Orientation(x3, y3, x1, y1, b);
+		if (signB != signA) return false;
+		const int signC = Orientation(x1, y1, x2, y2, c);
+		if (signC != signA) return false;
+		const double sum = a + b + c;
+		if (sum == 0.0) return false;
+		a /= sum;
+		b /= sum;
+		c /= sum;
+		return true;
+	}
+
+	// 三角形を軸 axis の範囲 (bucketSize 格子毎のバケット) に振り分ける (CSR)
+	void BinTriangles(const std::vector<int32_t>& triangleMin, const std::vector<int32_t>& triangleMax, uint32_t bucketSize, uint32_t bucketCount,
+		std::vector<uint32_t>& bucketStart, std::vector<uint32_t>& bucketTriangles)
+	{
+		const uint32_t triangleCount = static_cast<uint32_t>(triangleMin.size());
+		bucketStart.assign(bucketCount + 1, 0);
+		for (uint32_t t = 0; t < triangleCount; ++t)
+		{
+			if (triangleMin[t] > triangleMax[t])
+			{
+				continue;
+			}
+			for (uint32_t bucket = triangleMin[t] / bucketSize; bucket <= triangleMax[t] / bucketSize; ++bucket)
+			{
+				++bucketStart[bucket + 1];
+			}
+		}
+		for (uint32_t bucket = 0; bucket < bucketCount; ++bucket)
+		{
+			bucketStart[bucket + 1] += bucketStart[bucket];
+		}
+		bucketTriangles.resize(bucketStart[bucketCount]);
+		std::vector<uint32_t> cursor(bucketStart.begin(), bucketStart.end() - 1);
+		for (uint32_t t = 0; t < triangleCount; ++t)
+		{
+			if (triangleMin[t] > triangleMax[t])
+			{
+				continue;
+			}
+			for (uint32_t bucket = triangleMin[t] / bucketSize; bucket <= triangleMax[t] / bucketSize; ++bucket)
+			{
+				bucketTriangles[cursor[bucket]++] = t;
+			}
+		}
+	}
+}
+
+bool SignedDistanceField::Bake(const std::vector<Vector3D>& positions, const std::vector<uint32_t>& indices, const SDFBakeParam& param, ThreadPool& threadPool)
+{
+	auto totalStart = Clock::now();
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (triangleCount == 0 || positions.empty() || param.CellSize <= 0.0f)
+	{
+		return false;
+	}
+
+	// 格子はメッシュの範囲を帯と余白の分だけ広げて覆う
+	Vector3D boundsMin = positions[indices[0]];
+	Vector3D boundsMax = boundsMin;
+	for (uint32_t index : indices)
+	{
+		assert(index < positions.size());
+		const Vector3D& p = positions[index];
+		boundsMin = Vector3D(std::min(boundsMin.x, p.x), std::min(boundsMin.y, p.y), std::min(boundsMin.z, p.z));
+		boundsMax = Vector3D(std::max(boundsMax.x, p.x), std::max(boundsMax.y, p.y), std::max(boundsMax.z, p.z));
+	}
+	const float cellSize = param.CellSize;
+	const float band = cellSize * std::max(1u, param.BandCells);
+	const float margin = band + cellSize * param.PaddingCells;
+	const Vector3D origin = boundsMin - Vector3D(margin, margin, margin);
+	const Vector3D extent = boundsMax - boundsMin + Vector3D(margin, margin, margin) * 2.0f;
+	uint32_t dim[3];
+	const float extents[3] = { extent.x, extent.y, extent.z };
+	uint64_t sampleCount = 1;
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		dim[axis] = static_cast<uint32_t>(std::ceil(extents[axis] / cellSize)) + 1;
+		sampleCount *= dim[axis];
+	}
+	if (sampleCount >= (1ull << 31))
+	{
+		return false;
+	}
+	m_Stats = SDFBakeStats();
+	m_Stats.TriangleCount = triangleCount;
+	m_Stats.SampleCount = sampleCount;
+	m_Origin = origin;
+	m_CellSize = cellSize;
+	m_BandDistance = band;
+	std::copy(dim, dim + 3, m_Dim);
+	const uint32_t strideY = dim[0];
+	const uint32_t strideZ = dim[0] * dim[1];
+	const float invCellSize = 1.0f / cellSize;
+	auto sampleIndexRange = [&](float minValue, float maxValue, float originValue, uint32_t axisDim, int32_t& first, int32_t& last)
+	{
+		first = std::max(0, static_cast<int32_t>(std::ceil((minValue - originValue) * invCellSize)));
+		last = std::min(static_cast<int32_t>(axisDim) - 1, static_cast<int32_t>(std::floor((maxValue - originValue) * invCellSize)));
+	};
+
+	// 帯の中の距離: 三角形を帯の幅だけ広げた箱に入る格子点で最小値を取る
+	// z の層を LayerBlock 枚ずつのバケットに分け、バケット毎に並列に処理する (同じ格子点に書くのは同じバケットだけ)
+	auto distanceStart = Clock::now();
+	const uint32_t LayerBlock = 4;
+	m_Values.assign(static_cast<size_t>(sampleCount), band * band);
+	std::vector<int32_t> triangleMin(triangleCount);
+	std::vector<int32_t> triangleMax(triangleCount);
+	for (uint32_t t = 0; t < triangleCount; ++t)
+	{
+		const float z0 = positions[indices[3 * t + 0]].z;
+		const float z1 = positions[indices[3 * t + 1]].z;
+		const float z2 = positions[indices[3 * t + 2]].z;
+		sampleIndexRange(std::min({ z0, z1, z2 }) - band, std::max({ z0, z1, z2 }) + band, origin.z, dim[2], triangleMin[t], triangleMax[t]);
+	}
+	std::vector<uint32_t> bucketStart;
+	std::vector<uint32_t> bucketTriangles;
+	const uint32_t layerBucketCount = (dim[2] + LayerBlock - 1) / LayerBlock;
+	BinTriangles(triangleMin, triangleMax, LayerBlock, layerBucketCount, bucketStart, bucketTriangles);
+	threadPool.ParallelFor(0, layerBucketCount, 1, [&](uint32_t beginBucket, uint32_t endBucket)
+	{
+		for (uint32_t bucket = beginBucket; bucket < endBucket; ++bucket)
+		{
+			const int32_t bucketFirstZ = bucket * LayerBlock;
+			const int32_t bucketLastZ = std::min(dim[2], (bucket + 1) * LayerBlock) - 1;
+			for (uint32_t n = bucketStart[bucket]; n < bucketStart[bucket + 1]; ++n)
+			{
+				const uint32_t t = bucketTriangles[n];
+				const Vector3D& a = positions[indices[3 * t + 0]];
+				const Vector3D& b = positions[indices[3 * t + 1]];
+				const Vector3D& c = positions[indices[3 * t + 2]];
+				int32_t firstX, lastX, firstY, lastY;
+				sampleIndexRange(std::min({ a.x, b.x, c.x }) - band, std::max({ a.x, b.x, c.x }) + band, origin.x, dim[0], firstX, lastX);
+				sampleIndexRange(std::min({ a.y, b.y, c.y }) - band, std::max({ a.y, b.y, c.y }) + band, origin.y, dim[1], firstY, lastY);
+				const int32_t firstZ = std::max(triangleMin[t], bucketFirstZ);
+				const int32_t lastZ = std::min(triangleMax[t], bucketLastZ);
+				// 行毎に、外接球を帯の幅だけ広げた球と、平面から帯の幅までの板の両方に入る x の範囲だけを調べる
+				const Vector3D center = (a + b + c) * (1.0f / 3.0f);
+				const float reach = std::sqrt(std::max({ (a - center).dot(a - center), (b - center).dot(b - center), (c - center).dot(c - center) })) + band;
+				const Vector3D normal = (b - a).cross(c - a).GetSafeNormal();
+				for (int32_t k = firstZ; k <= lastZ; ++k)
+				{
+					for (int32_t j = firstY; j <= lastY; ++j)
+					{
+						float* pRow = m_Values.data() + static_cast<size_t>(k) * strideZ + static_cast<size_t>(j) * strideY;
+						const Vector3D rowOrigin = origin + Vector3D(0.0f, j * cellSize, k * cellSize);
+						const float dy = rowOrigin.y - center.y;
+						const float dz = rowOrigin.z - center.z;
+						const float dx2 = reach * reach - dy * dy - dz * dz;
+						if (dx2 < 0.0f)
+						{
+							continue;
+						}
+						const float dx = std::sqrt(dx2);
+						float rowFirst = center.x - dx;
+						float rowLast = center.x + dx;
+						// 平面からの距離は x について線形 (x 軸に平行な面では行全体で一定)
+						const float planeDistance = normal.dot(rowOrigin - a);
+						if (std::abs(normal.x) > 1.0e-6f)
+						{
+							const float x0 = rowOrigin.x - (planeDistance - band) / normal.x;
+							const float x1 = rowOrigin.x - (planeDistance + band) / normal.x;
+							rowFirst = std::max(rowFirst, std::min(x0, x1));
+							rowLast = std::min(rowLast, std::max(x0, x1));
+						}
+						else if (std::abs(planeDistance) > band)
+						{
+							continue;
+						}
+						int32_t rowFirstX, rowLastX;
+						sampleIndexRange(rowFirst, rowLast, origin.x, dim[0], rowFirstX, rowLastX);
+						for (int32_t i = std::max(firstX, rowFirstX); i <= std::min(lastX, rowLastX); ++i)
+						{
+							const float distance2 = PointTriangleDistance2(rowOrigin + Vector3D(i * cellSize, 0.0f, 0.0f), a, b, c);
+							pRow[i] = std::min(pRow[i], distance2);
+						}
+					}
+				}
+			}
+		}
+	});
+	m_Stats.DistanceMilliseconds = ElapsedMilliseconds(distanceStart);
+
+	// 内外: 格子点の列毎に -z 側から来るレイが三角形を横切る回数を数え、奇数なら内側
+	// 交点の直上の格子点で偶奇を反転しておき、列を z の順に累積する。y の行を RowBlock 行ずつのバケットに分けて並列に処理する
+	auto signStart = Clock::now();
+	const uint32_t RowBlock = 4;
+	std::vector<uint8_t> crossings(static_cast<size_t>(sampleCount), 0);
+	for (uint32_t t = 0; t < triangleCount; ++t)
+	{
+		const float y0 = positions[indices[3 * t + 0]].y;
+		const float y1 = positions[indices[3 * t + 1]].y;
+		const float y2 = positions[indices[3 * t + 2]].y;
+		sampleIndexRange(std::min({ y0, y1, y2 }), std::max({ y0, y1, y2 }), origin.y, dim[1], triangleMin[t], triangleMax[t]);
+	}
+	const uint32_t rowBucketCount = (dim[1] + RowBlock - 1) / RowBlock;
+	BinTriangles(triangleMin, triangleMax, RowBlock, rowBucketCount, bucketStart, bucketTriangles);
+	std::vector<uint64_t> bandCounts(rowBucketCount, 0);
+	threadPool.ParallelFor(0, rowBucketCount, 1, [&](uint32_t beginBucket, uint32_t endBucket)
+	{
+		std::vector<uint8_t> inside(dim[0]);
+		for (uint32_t bucket = beginBucket; bucket < endBucket; ++bucket)
+		{
+			const int32_t bucketFirstY = bucket * RowBlock;
+			const int32_t bucketLastY = std::min(dim[1], (bucket + 1) * RowBlock) - 1;
+			for (uint32_t n = bucketStart[bucket]; n < bucketStart[bucket + 1]; ++n)
+			{
+				const uint32_t t = bucketTriangles[n];
+				const Vector3D& a = positions[indices[3 * t + 0]];
+				const Vector3D& b = positions[indices[3 * t + 1]];
+				const Vector3D& c = positions[indices[3 * t + 2]];
+				int32_t firstX, lastX;
+				sampleIndexRange(std::min({ a.x, b.x, c.x }), std::max({ a.x, b.x, c.x }), origin.x, dim[0], firstX, lastX);
+				const int32_t firstY = std::max(triangleMin[t], bucketFirstY);
+				const int32_t lastY = std::min(triangleMax[t], bucketLastY);
+				for (int32_t j = firstY; j <= lastY; ++j)
+				{
+					const double y = static_cast<double>(origin.y) + static_cast<double>(j) * cellSize;
+					for (int32_t i = firstX; i <= lastX; ++i)
+					{
+						const double x = static_cast<double>(origin.x) + static_cast<double>(i) * cellSize;
+						double wa, wb, wc;
+						if (!PointInTriangle2D(x, y, a.x, a.y, b.x, b.y, c.x, c.y, wa, wb, wc))
+						{
+							continue;
+						}
+						const double z = wa * a.z + wb * b.z + wc * c.z;
+						const int64_t k = static_cast<int64_t>(std::ceil((z - origin.z) / cellSize));
+						if (k < 0)
+						{
+							crossings[static_cast<size_t>(j) * strideY + i] ^= 1;
+						}
+						else if (k < dim[2])
+						{
+							crossings[static_cast<size_t>(k) * strideZ + static_cast<size_t>(j) * strideY + i] ^= 1;
+						}
+					}
+				}
+			}
+			// 列を累積して、距離に符号を付ける
+			for (int32_t j = bucketFirstY; j <= bucketLastY; ++j)
+			{
+				std::fill(inside.begin(), inside.end(), 0);
+				for (uint32_t k = 0; k < dim[2]; ++k)
+				{
+					const size_t rowOffset = static_cast<size_t>(k) * strideZ + static_cast<size_t>(j) * strideY;
+					float* pRow = m_Values.data() + rowOffset;
+					const uint8_t* pCrossings = crossings.data() + rowOffset;
+					for (uint32_t i = 0; i < dim[0]; ++i)
+					{
+						inside[i] ^= pCrossings[i];
+						const float distance = std::sqrt(pRow[i]);
+						bandCounts[bucket] += (distance < band) ? 1 : 0;
+						pRow[i] = inside[i] ? -std::min(distance, band) : std::min(distance, band);
+					}
+				}
+			}
+		}
+	});
+	for (uint64_t count : bandCounts)
+	{
+		m_Stats.BandSampleCount += count;
+	}
+	m_Stats.SignMilliseconds = ElapsedMilliseconds(signStart);
+	m_Stats.TotalMilliseconds = ElapsedMilliseconds(totalStart);
+	return true;
+}
+
+bool SignedDistanceField::BakeCached(const std::string& sourcePath, const std::string& cacheDirectory,
+	const std::vector<Vector3D>& positions, const std::vector<uint32_t>& indices, const SDFBakeParam& param, ThreadPool& threadPool)
+{
+	auto start = Clock::now();
+	const uint64_t key = MakeCacheKey(HashMesh(positions, indices), sourcePath, param);
+	char keyString[32];
+	std::snprintf(keyString, sizeof(keyString), "_%016llx.sdf", static_cast<unsigned long long>(key));
+	const std::filesystem::path cachePath = std::filesystem::path(cacheDirectory) / (std::filesystem::path(sourcePath).stem().string() + keyString);
+	if (Load(cachePath.string(), key))
+	{
+		m_Stats = SDFBakeStats();
+		m_Stats.TriangleCount = static_cast<uint32_t>(indices.size() / 3);
+		m_Stats.SampleCount = m_Values.size();
+		for (float value : m_Values)
+		{
+			m_Stats.BandSampleCount += (std::abs(value) < m_BandDistance) ? 1 : 0;
+		}
+		m_Stats.FromCache = true;
+		m_Stats.TotalMilliseconds = ElapsedMilliseconds(start);
+		return true;
+	}
+	if (!Bake(positions, indices, param, threadPool))
+	{
+		return false;
+	}
+	std::error_code error;
+	if (std::filesystem::exists(cacheDirectory, error) || std::filesystem::create_directories(cacheDirectory, error))
+	{
+		Save(cachePath.string(), key);
+	}
+	return true;
+}
+
+bool SignedDistanceField::Save(const std::string& path, uint64_t key) const
+{
+	SDFFileHeader header = {};
+	std::memcpy(header.Magic, SDFMagic, sizeof(header.Magic));
+	header.Version = SDFVersion;
+	header.HeaderSize = sizeof(SDFFileHeader);
+	header.Key = key;
+	header.Origin[0] = m_Origin.x;
+	header.Origin[1] = m_Origin.y;
+	header.Origin[2] = m_Origin.z;
+	header.CellSize = m_CellSize;
+	std::copy(m_Dim, m_Dim + 3, header.Dim);
+	header.BandDistance = m_BandDistance;
+	header.ValueCount = m_Values.size();
+
+	// 途中で落ちても壊れたキャッシュを読まないよう、書き終えてから名前を変える
+	const std::string tempPath = path + ".tmp";
+	std::FILE* pFile = std::fopen(tempPath.c_str(), "wb");
+	if (pFile == nullptr)
+	{
+		return false;
+	}
+	bool succeeded = std::fwrite(&header, sizeof(header), 1, pFile) == 1 &&
+		(m_Values.empty() || std::fwrite(m_Values.data(), sizeof(float), m_Values.size(), pFile) == m_Values.size());
+	succeeded = (std::fclose(pFile) == 0) && succeeded;
+	std::error_code error;
+	if (succeeded)
+	{
+		std::filesystem::rename(tempPath, path, error);
+		succeeded = !error;
+	}
+	if (!succeeded)
+	{
+		std::filesystem::remove(tempPath, error);
+	}
+	return succeeded;
+}
+
+bool SignedDistanceField::Load(const std::string& path, uint64_t key)
+{
+	std::FILE* pFile = std::fopen(path.c_str(), "rb");
+	if (pFile == nullptr)
+	{
+		return false;
+	}
+	SDFFileHeader header = {};
+	bool succeeded = std::fread(&header, sizeof(header), 1, pFile) == 1 &&
+		std::memcmp(header.Magic, SDFMagic, sizeof(header.Magic)) == 0 &&
+		header.Version == SDFVersion && header.HeaderSize == sizeof(SDFFileHeader) && header.Key == key &&
+		header.CellSize > 0.0f && header.Dim[0] >= 2 && header.Dim[1] >= 2 && header.Dim[2] >= 2 &&
+		header.ValueCount == static_cast<uint64_t>(header.Dim[0]) * header.Dim[1] * header.Dim[2] && header.ValueCount < (1ull << 31);
+	std::vector<float> values;
+	if (succeeded)
+	{
+		values.resize(static_cast<size_t>(header.ValueCount));
+		succeeded = std::fread(values.data(), sizeof(float), values.size(), pFile) == values.size();
+	}
+	std::fclose(pFile);
+	if (!succeeded)
+	{
+		return false;
+	}
+	m_Origin = Vector3D(header.Origin[0], header.Origin[1], header.Origin[2]);
+	m_CellSize = header.CellSize;
+	std::copy(header.Dim, header.Dim + 3, m_Dim);
+	m_BandDistance = header.BandDistance;
+	m_Values = std::move(values);
+	return true;
+}
+
+uint64_t SignedDistanceField::HashMesh(const std::vector<Vector3D>& positions, const std::vector<uint32_t>& indices)
+{
+	uint64_t hash = FNVOffsetBasis;
+	const uint64_t counts[2] = { positions.size(), indices.size() };
+	hash = HashBytes(hash, counts, sizeof(counts));
+	for (const Vector3D& position : positions)
+	{
+		const float values[3] = { position.x, position.y, position.z };
+		hash = HashBytes(hash, values, sizeof(values));
+	}
+	return indices.empty() ? hash : HashBytes(hash, indices.data(), indices.size() * sizeof(uint32_t));
+}
+
+uint64_t SignedDistanceField::MakeCacheKey(uint64_t meshHash, const std::string& sourcePath, const SDFBakeParam& param)
+{
+	std::error_code error;
+	std::filesystem::path absolutePath = std::filesystem::absolute(sourcePath, error);
+	const std::string pathString = (error ? std::filesystem::path(sourcePath) : absolutePath).lexically_normal().generic_string();
+	uint64_t hash = HashBytes(meshHash, pathString.data(), pathString.size());
+	hash = HashBytes(hash, &SDFVersion, sizeof(SDFVersion));
+	hash = HashBytes(hash, &param.CellSize, sizeof(param.CellSize));
+	hash = HashBytes(hash, &param.BandCells, sizeof(param.BandCells));
+	return HashBytes(hash, &param.PaddingCells, sizeof(param.PaddingCells));
+}
+
+float SignedDistanceField::Sample(const Vector3D& position, Vector3D* pGradient) const
+{
+	const float invCellSize = 1.0f / m_CellSize;
+	const float g[3] = { (position.x - m_Origin.x) * invCellSize, (position.y - m_Origin.y) * invCellSize, (position.z - m_Origin.z) * invCellSize };
+	uint32_t cell[3];
+	float f[3];
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		// 格子の外 (NaN を含む) は障害物から帯の幅以上離れている
+		if (!(g[axis] >= 0.0f && g[axis] <= static_cast<float>(m_Dim[axis] - 1)))
+		{
+			if (pGradient != nullptr)
+			{
+				*pGradient = Vector3D(0.0f, 0.0f, 0.0f);
+			}
+			return m_BandDistance;
+		}
+		cell[axis] = std::min(static_cast<uint32_t>(g[axis]), m_Dim[axis] - 2);
+		f[axis] = g[axis] - static_cast<float>(cell[axis]);
+	}
+	const size_t strideY = m_Dim[0];
+	const size_t strideZ = static_cast<size_t>(m_Dim[0]) * m_Dim[1];
+	const float* p = m_Values.data() + cell[2] * strideZ + cell[1] * strideY + cell[0];
+	const float v000 = p[0], v100 = p[1];
+	const float v010 = p[strideY], v110 = p[strideY + 1];
+	const float v001 = p[strideZ], v101 = p[strideZ + 1];
+	const float v011 = p[strideZ + strideY], v111 = p[strideZ + strideY + 1];
+	// x, y, z の順に補間する
+	const float v00 = v000 + (v100 - v000) * f[0];
+	const float v10 = v010 + (v110 - v010) * f[0];
+	const float v01 = v001 + (v101 - v001) * f[0];
+	const float v11 = v011 + (v111 - v011) * f[0];
+	const float v0 = v00 + (v10 - v00) * f[1];
+	const float v1 = v01 + (v11 - v01) * f[1];
+	if (pGradient != nullptr)
+	{
+		const float dx0 = (v100 - v000) + ((v110 - v010) - (v100 - v000)) * f[1];
+		const float dx1 = (v101 - v001) + ((v111 - v011) - (v101 - v001)) * f[1];
+		*pGradient = Vector3D(
+			(dx0 + (dx1 - dx0) * f[2]) * invCellSize,
+			((v10 - v00) + ((v11 - v01) - (v10 - v00)) * f[2]) * invCellSize,
+			(v1 - v0) * invCellSize);
+	}
+	return v0 + (v1 - v0) * f[2];
+}
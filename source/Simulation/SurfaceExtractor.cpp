@@ -0,0 +1,725 @@
+#include "Simulation/SurfaceExtractor.h"
+#include "Simulation/SPHKernels.h"
+#include "Simulation/ThreadPool.h"
+
+#include <cstdio>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// 粒子の範囲を覆うブロックの数の上限 (m_BlockTable の大きさ)
+	const uint64_t MaxBlockTableSize = 1ull << 27;
+
+	// 3x3x3 の隣のブロックの番号 (dx, dy, dz は -1 .. 1)
+	uint32_t NeighborIndex(int32_t dx, int32_t dy, int32_t dz)
+	{
+		return static_cast<uint32_t>((dx + 1) + 3 * (dy + 1) + 9 * (dz + 1));
+	}
+
+	// 立方体の角 c は (c & 1, (c >> 1) & 1, (c >> 2) & 1)
+	// 辺 e は軸 e / 4 の方向に伸び、始点の角の軸以外の2ビット (軸 + 1, 軸 + 2 の順) が e % 4
+	uint32_t EdgeIndex(uint32_t cornerA, uint32_t cornerB)
+	{
+		uint32_t axisBit = cornerA ^ cornerB;
+		uint32_t axis = (axisBit == 1) ? 0 : ((axisBit == 2) ? 1 : 2);
+		uint32_t origin = std::min(cornerA, cornerB);
+		uint32_t u = (origin >> ((axis + 1) % 3)) & 1;
+		uint32_t v = (origin >> ((axis + 2) % 3)) & 1;
+		return axis * 4 + u + 2 * v;
+	}
+
+	uint32_t EdgeOriginCorner(uint32_t edge)
+	{
+		uint32_t axis = edge / 4;
+		return (((edge & 1) << ((axis + 1) % 3)) | (((edge >> 1) & 1) << ((axis + 2) % 3)));
+	}
+
+	// 2本の辺が立方体の同じ面に乗っているか (辺は自分の軸以外の2軸の、始点の角の側の面に乗る)
+	bool EdgesShareFace(uint32_t edgeA, uint32_t edgeB)
+	{
+		uint32_t cornerA = EdgeOriginCorner(edgeA);
+		uint32_t cornerB = EdgeOriginCorner(edgeB);
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			if (axis != edgeA / 4 && axis != edgeB / 4 && ((cornerA >> axis) & 1) == ((cornerB >> axis) & 1))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// マーチングキューブの三角形の表
+	/// 手書きの表の代わりに、立方体の各面で内側の角を囲む線分を繋いだループを扇形に分割して作る
+	/// 内側の角が対角に2つある面は常に内側の角を分ける向きに繋ぐので、面を共有する隣の立方体とも同じ線分になり、穴が開かない
+	/// </summary>
+	struct MarchingCubesTable
+	{
+		static const uint32_t MaxTriangles = 12;
+		uint8_t TriangleCount[256];
+		uint8_t Edges[256][MaxTriangles * 3];
+
+		MarchingCubesTable()
+		{
+			for (uint32_t cubeCase = 0; cubeCase < 256; ++cubeCase)
+			{
+				// 面の角を外から見て反時計回りに辿り、外 -> 内 の辺から 内 -> 外 の辺へ線分を引く
+				// 隣の面とは共有する辺を逆向きに辿るので、線分は辺で繋がってループになる
+				int32_t next[12];
+				std::fill(next, next + 12, -1);
+				for (uint32_t axis = 0; axis < 3; ++axis)
+				{
+					uint32_t u = (axis + 1) % 3;
+					uint32_t v = (axis + 2) % 3;
+					for (uint32_t side = 0; side < 2; ++side)
+					{
+						uint32_t base = side << axis;
+						uint32_t corners[4] = { base, base | (1u << u), base | (1u << u) | (1u << v), base | (1u << v) };
+						if (side == 0)
+						{
+							std::swap(corners[1], corners[3]);
+						}
+						bool inside[4];
+						for (uint32_t m = 0; m < 4; ++m)
+						{
+							inside[m] = ((cubeCase >> corners[m]) & 1) != 0;
+						}
+						for (uint32_t m = 0; m < 4; ++m)
+						{
+							if (inside[m] || !inside[(m + 1) % 4])
+							{
+								continue;
+							}
+							uint32_t k = (m + 1) % 4;
+							while (inside[(k + 1) % 4])
+							{
+								k = (k + 1) % 4;
+							}
+							next[EdgeIndex(corners[m], corners[(m + 1) % 4])] = static_cast<int32_t>(EdgeIndex(corners[k], corners[(k + 1) % 4]));
+						}
+					}
+				}
+
+				uint32_t triangleCount = 0;
+				bool visited[12] = {};
+				for (uint32_t edge = 0; edge < 12; ++edge)
+				{
+					if (next[edge] < 0 || visited[edge])
+					{
+						continue;
+					}
+					uint32_t loop[12];
+					uint32_t loopSize = 0;
+					for (int32_t e = static_cast<int32_t>(edge); !visited[e]; e = next[e])
+					{
+						assert(e >= 0);
+						visited[e] = true;
+						loop[loopSize++] = static_cast<uint32_t>(e);
+					}
+					// 扇形の対角線が立方体の面の上に乗ると、隣の立方体も同じ対角線を使って4枚の三角形が1本の辺を共有するので、
+					// 対角線が面に乗らない頂点を扇の中心に選ぶ
+					uint32_t pivot = 0;
+					for (uint32_t candidate = 0; candidate < loopSize; ++candidate)
+					{
+						bool isOnFace = false;
+						for (uint32_t i = 2; i + 1 < loopSize && !isOnFace; ++i)
+						{
+							isOnFace = EdgesShareFace(loop[candidate], loop[(candidate + i) % loopSize]);
+						}
+						if (!isOnFace)
+						{
+							pivot = candidate;
+							break;
+						}
+					}
+					for (uint32_t i = 1; i + 1 < loopSize; ++i)
+					{
+						assert(triangleCount < MaxTriangles);
+						Edges[cubeCase][triangleCount * 3 + 0] = static_cast<uint8_t>(loop[pivot]);
+						Edges[cubeCase][triangleCount * 3 + 1] = static_cast<uint8_t>(loop[(pivot + i) % loopSize]);
+						Edges[cubeCase][triangleCount * 3 + 2] = static_cast<uint8_t>(loop[(pivot + i + 1) % loopSize]);
+						++triangleCount;
+					}
+				}
+				TriangleCount[cubeCase] = static_cast<uint8_t>(triangleCount);
+			}
+
+			// 角0だけが内側の場合で、三角形の法線 (v1 - v0) x (v2 - v0) が外側 (1, 1, 1) を向くように全体の向きを揃える
+			auto edgeMidpoint = [](uint32_t edge)
+			{
+				uint32_t corner = EdgeOriginCorner(edge);
+				Vector3D point(static_cast<float>(corner & 1), static_cast<float>((corner >> 1) & 1), static_cast<float>((corner >> 2) & 1));
+				const uint32_t axis = edge / 4;
+				(axis == 0 ? point.x : (axis == 1 ? point.y : point.z)) += 0.5f;
+				return point;
+			};
+			Vector3D p0 = edgeMidpoint(Edges[1][0]);
+			Vector3D normal = (edgeMidpoint(Edges[1][1]) - p0).cross(edgeMidpoint(Edges[1][2]) - p0);
+			if (normal.dot(Vector3D(1.0f, 1.0f, 1.0f)) < 0.0f)
+			{
+				for (uint32_t cubeCase = 0; cubeCase < 256; ++cubeCase)
+				{
+					for (uint32_t t = 0; t < TriangleCount[cubeCase]; ++t)
+					{
+						std::swap(Edges[cubeCase][t * 3 + 1], Edges[cubeCase][t * 3 + 2]);
+					}
+				}
+			}
+		}
+	};
+
+	const MarchingCubesTable& GetMarchingCubesTable()
+	{
+		static const MarchingCubesTable table;
+		return table;
+	}
+}
+
+SurfaceExtractor::SurfaceExtractor(uint32_t threadCount)
+	: m_pThreadPool(std::make_unique<ThreadPool>(threadCount))
+	, m_Anisotropy(*m_pThreadPool)
+{
+}
+
+SurfaceExtractor::~SurfaceExtractor() = default;
+
+bool SurfaceExtractor::Extract(const std::vector<Particle>& particles, const SimulationParam& simParam, SurfaceMesh& mesh)
+{
+	auto totalStart = Clock::now();
+	m_Stats = SurfaceStats();
+	m_Stats.ParticleCount = static_cast<uint32_t>(particles.size());
+	mesh.Vertices.clear();
+	mesh.Indices.clear();
+	const uint32_t particleCount = static_cast<uint32_t>(particles.size());
+	if (particleCount == 0)
+	{
+		return true;
+	}
+
+	// 楕円体のカーネルは平滑化した中心に置く
+	const bool isAnisotropic = m_Param.Anisotropic;
+	const float radius = simParam.H * m_Param.RadiusScale;
+	float supportRadius = radius;
+	if (isAnisotropic)
+	{
+		auto anisotropyStart = Clock::now();
+		m_Anisotropy.SetParam(m_Param.Anisotropy);
+		m_Anisotropy.Compute(particles, simParam, m_Kernels);
+		float maxRadius = 0.0f;
+		for (const EllipsoidKernel& kernel : m_Kernels)
+		{
+			maxRadius = std::max({ maxRadius, kernel.Radii[0], kernel.Radii[1], kernel.Radii[2] });
+		}
+		supportRadius = radius * maxRadius;
+		m_Stats.AnisotropyMilliseconds = ElapsedMilliseconds(anisotropyStart);
+	}
+	auto positionOf = [&](uint32_t i)
+	{
+		return isAnisotropic ? m_Kernels[i].Center : particles[i].Position;
+	};
+
+	// ブロックは格子点 [0, B)^3 を持つ。カーネルの半径をブロックの幅以下にして、格子点に届く粒子が隣のブロックまでに収まるようにする
+	const float cellSize = simParam.H * m_Param.CellScale;
+	const uint32_t B = std::max({ m_Param.BlockSize, 2u, static_cast<uint32_t>(std::ceil(supportRadius / cellSize)) });
+	const uint32_t B3 = B * B * B;
+	const float blockExtent = B * cellSize;
+	const float isoValue = m_Param.IsoValue;
+
+	auto binStart = Clock::now();
+	Vector3D boundsMin = positionOf(0);
+	Vector3D boundsMax = positionOf(0);
+	for (uint32_t i = 0; i < particleCount; ++i)
+	{
+		const Vector3D position = positionOf(i);
+		boundsMin = Vector3D(std::min(boundsMin.x, position.x), std::min(boundsMin.y, position.y), std::min(boundsMin.z, position.z));
+		boundsMax = Vector3D(std::max(boundsMax.x, position.x), std::max(boundsMax.y, position.y), std::max(boundsMax.z, position.z));
+	}
+	// 粒子のブロックの周りに1ブロック分の余白を取る (隣のブロックも確保するため)
+	const Vector3D origin = boundsMin - Vector3D(blockExtent);
+	const uint32_t dimX = static_cast<uint32_t>((boundsMax.x - origin.x) / blockExtent) + 2;
+	const uint32_t dimY = static_cast<uint32_t>((boundsMax.y - origin.y) / blockExtent) + 2;
+	const uint32_t dimZ = static_cast<uint32_t>((boundsMax.z - origin.z) / blockExtent) + 2;
+	const uint64_t tableSize = static_cast<uint64_t>(dimX) * dimY * dimZ;
+	if (!std::isfinite(boundsMin.x + boundsMin.y + boundsMin.z + boundsMax.x + boundsMax.y + boundsMax.z) || tableSize >= MaxBlockTableSize)
+	{
+		return false;
+	}
+	m_Stats.DenseSampleCount = tableSize * B3;
+
+	m_ParticleBlock.resize(particleCount);
+	m_pThreadPool->ParallelFor(0, particleCount, 4096, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			Vector3D relative = (positionOf(i) - origin) * (1.0f / blockExtent);
+			uint32_t x = std::min(static_cast<uint32_t>(relative.x), dimX - 2);
+			uint32_t y = std::min(static_cast<uint32_t>(relative.y), dimY - 2);
+			uint32_t z = std::min(static_cast<uint32_t>(relative.z), dimZ - 2);
+			m_ParticleBlock[i] = x + dimX * (y + dimY * z);
+		}
+	});
+
+	// 粒子のあるブロックとその隣を確保し、m_BlockTable の位置の順に番号を振る
+	m_BlockTable.assign(tableSize, -1);
+	m_BlockCoords.clear();
+	const int32_t Occupied = -2;
+	for (uint32_t i = 0; i < particleCount; ++i)
+	{
+		if (m_BlockTable[m_ParticleBlock[i]] == -1)
+		{
+			m_BlockTable[m_ParticleBlock[i]] = Occupied;
+			m_BlockCoords.push_back(m_ParticleBlock[i]);
+		}
+	}
+	const size_t occupiedCount = m_BlockCoords.size();
+	for (size_t i = 0; i < occupiedCount; ++i)
+	{
+		uint32_t coord = m_BlockCoords[i];
+		uint32_t x = coord % dimX;
+		uint32_t y = (coord / dimX) % dimY;
+		uint32_t z = coord / (dimX * dimY);
+		for (uint32_t nz = z - 1; nz <= z + 1; ++nz)
+		{
+			for (uint32_t ny = y - 1; ny <= y + 1; ++ny)
+			{
+				for (uint32_t nx = x - 1; nx <= x + 1; ++nx)
+				{
+					uint32_t neighbor = nx + dimX * (ny + dimY * nz);
+					if (m_BlockTable[neighbor] == -1)
+					{
+						m_BlockTable[neighbor] = Occupied;
+						m_BlockCoords.push_back(neighbor);
+					}
+				}
+			}
+		}
+	}
+	std::sort(m_BlockCoords.begin(), m_BlockCoords.end());
+	const uint32_t blockCount = static_cast<uint32_t>(m_BlockCoords.size());
+	for (uint32_t block = 0; block < blockCount; ++block)
+	{
+		m_BlockTable[m_BlockCoords[block]] = static_cast<int32_t>(block);
+	}
+	m_Stats.BlockCount = blockCount;
+	m_Stats.SampleCount = static_cast<uint64_t>(blockCount) * B3;
+
+	// 粒子をブロック順に並べる (カウンティングソート)
+	m_BlockStart.assign(blockCount + 1, 0);
+	for (uint32_t i = 0; i < particleCount; ++i)
+	{
+		++m_BlockStart[m_BlockTable[m_ParticleBlock[i]] + 1];
+	}
+	for (uint32_t block = 0; block < blockCount; ++block)
+	{
+		m_BlockStart[block + 1] += m_BlockStart[block];
+	}
+	m_SortedPositions.resize(particleCount);
+	m_SortedVolumes.resize(particleCount);
+	m_SortedShapes.resize(isAnisotropic ? particleCount : 0);
+	{
+		std::vector<uint32_t> cursor(m_BlockStart.begin(), m_BlockStart.end() - 1);
+		for (uint32_t i = 0; i < particleCount; ++i)
+		{
+			uint32_t slot = cursor[m_BlockTable[m_ParticleBlock[i]]]++;
+			m_SortedPositions[slot] = positionOf(i);
+			// 密度がまだない (初期配置) 粒子は基準密度の体積にする
+			float density = particles[i].Density > 0.0f ? particles[i].Density : simParam.RestDensity;
+			m_SortedVolumes[slot] = simParam.Mass / density;
+			if (!isAnisotropic)
+			{
+				continue;
+			}
+			// Shape = Σ a_k a_k^T / (radius * r_k)^2、箱は各軸で sqrt(Σ (radius * r_k * a_k)^2)。重みは半径の積で割って積分を等方なカーネルと揃える
+			const EllipsoidKernel& kernel = m_Kernels[i];
+			KernelShape& shape = m_SortedShapes[slot];
+			std::fill(shape.Shape, shape.Shape + 6, 0.0f);
+			Vector3D extent2(0.0f, 0.0f, 0.0f);
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				const Vector3D& a = kernel.Axes[k];
+				const float axisRadius = radius * kernel.Radii[k];
+				const float invR2 = 1.0f / (axisRadius * axisRadius);
+				shape.Shape[0] += a.x * a.x * invR2;
+				shape.Shape[1] += a.x * a.y * invR2;
+				shape.Shape[2] += a.x * a.z * invR2;
+				shape.Shape[3] += a.y * a.y * invR2;
+				shape.Shape[4] += a.y * a.z * invR2;
+				shape.Shape[5] += a.z * a.z * invR2;
+				extent2 += Vector3D(a.x * a.x, a.y * a.y, a.z * a.z) * (axisRadius * axisRadius);
+			}
+			shape.Extent = Vector3D(std::sqrt(extent2.x), std::sqrt(extent2.y), std::sqrt(extent2.z));
+			m_SortedVolumes[slot] /= kernel.Radii[0] * kernel.Radii[1] * kernel.Radii[2];
+		}
+	}
+
+	m_Neighbors.resize(static_cast<size_t>(blockCount) * 27);
+	for (uint32_t block = 0; block < blockCount; ++block)
+	{
+		uint32_t coord = m_BlockCoords[block];
+		int32_t x = static_cast<int32_t>(coord % dimX);
+		int32_t y = static_cast<int32_t>((coord / dimX) % dimY);
+		int32_t z = static_cast<int32_t>(coord / (dimX * dimY));
+		for (int32_t dz = -1; dz <= 1; ++dz)
+		{
+			for (int32_t dy = -1; dy <= 1; ++dy)
+			{
+				for (int32_t dx = -1; dx <= 1; ++dx)
+				{
+					int32_t nx = x + dx;
+					int32_t ny = y + dy;
+					int32_t nz = z + dz;
+					bool isInside = nx >= 0 && ny >= 0 && nz >= 0 && nx < static_cast<int32_t>(dimX) && ny < static_cast<int32_t>(dimY) && nz < static_cast<int32_t>(dimZ);
+					m_Neighbors[block * 27 + NeighborIndex(dx, dy, dz)] = isInside ? m_BlockTable[nx + dimX * (ny + dimY * nz)] : -1;
+				}
+			}
+		}
+	}
+	m_Stats.BinMilliseconds = ElapsedMilliseconds(binStart);
+
+	auto blockOrigin = [&](uint32_t block)
+	{
+		uint32_t coord = m_BlockCoords[block];
+		return origin + Vector3D(static_cast<float>(coord % dimX), static_cast<float>((coord / dimX) % dimY), static_cast<float>(coord / (dimX * dimY))) * blockExtent;
+	};
+
+	// 格子点の値: ブロック毎に、隣までのブロックの粒子から自分の格子点に届く分だけを集める
+	auto splatStart = Clock::now();
+	const SPHKernels::Coefficients kernel = SPHKernels::Poly6::Prepare(radius);
+	// 楕円体のカーネルは Shape で半径1に正規化した距離を、半径1の Poly6 に半径^3 を割って使う
+	const SPHKernels::Coefficients unitKernel = SPHKernels::Poly6::Prepare(1.0f);
+	const float unitScale = 1.0f / (radius * radius * radius);
+	const float radiusInCells = radius / cellSize;
+	m_Samples.resize(static_cast<size_t>(blockCount) * B3);
+	m_pThreadPool->ParallelFor(0, blockCount, 1, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t block = begin; block < end; ++block)
+		{
+			float* pSamples = &m_Samples[static_cast<size_t>(block) * B3];
+			std::fill(pSamples, pSamples + B3, 0.0f);
+			const Vector3D base = blockOrigin(block);
+			for (uint32_t n = 0; n < 27; ++n)
+			{
+				int32_t neighbor = m_Neighbors[block * 27 + n];
+				if (neighbor < 0)
+				{
+					continue;
+				}
+				for (uint32_t p = m_BlockStart[neighbor]; p < m_BlockStart[neighbor + 1]; ++p)
+				{
+					const Vector3D relative = m_SortedPositions[p] - base;
+					const float volume = m_SortedVolumes[p];
+					int32_t range[3][2];
+					const float coords[3] = { relative.x / cellSize, relative.y / cellSize, relative.z / cellSize };
+					float extents[3] = { radiusInCells, radiusInCells, radiusInCells };
+					if (isAnisotropic)
+					{
+						const Vector3D& extent = m_SortedShapes[p].Extent;
+						extents[0] = extent.x / cellSize;
+						extents[1] = extent.y / cellSize;
+						extents[2] = extent.z / cellSize;
+					}
+					bool isEmpty = false;
+					for (uint32_t axis = 0; axis < 3; ++axis)
+					{
+						range[axis][0] = std::max(0, static_cast<int32_t>(std::ceil(coords[axis] - extents[axis])));
+						range[axis][1] = std::min(static_cast<int32_t>(B) - 1, static_cast<int32_t>(std::floor(coords[axis] + extents[axis])));
+						isEmpty = isEmpty || range[axis][0] > range[axis][1];
+					}
+					if (isEmpty)
+					{
+						continue;
+					}
+					if (isAnisotropic)
+					{
+						// 行毎に dx の2次式 q^2 = s0 dx^2 + b dx + c を作り、q^2 < 1 となる dx の範囲だけを回る
+						const float* shape = m_SortedShapes[p].Shape;
+						const float weight = volume * unitScale;
+						for (int32_t k = range[2][0]; k <= range[2][1]; ++k)
+						{
+							float dz = k * cellSize - relative.z;
+							for (int32_t j = range[1][0]; j <= range[1][1]; ++j)
+							{
+								float dy = j * cellSize - relative.y;
+								float b = 2.0f * (shape[1] * dy + shape[2] * dz);
+								float c = shape[3] * dy * dy + 2.0f * shape[4] * dy * dz + shape[5] * dz * dz;
+								float discriminant = b * b - 4.0f * shape[0] * (c - 1.0f);
+								if (discriminant <= 0.0f)
+								{
+									continue;
+								}
+								float root = std::sqrt(discriminant);
+								float lower = (-b - root) / (2.0f * shape[0]);
+								float upper = (-b + root) / (2.0f * shape[0]);
+								int32_t iBegin = std::max(range[0][0], static_cast<int32_t>(std::ceil((relative.x + lower) / cellSize)));
+								int32_t iEnd = std::min(range[0][1], static_cast<int32_t>(std::floor((relative.x + upper) / cellSize)));
+								float* pRow = pSamples + B * (j + B * k);
+								for (int32_t i = iBegin; i <= iEnd; ++i)
+								{
+									float dx = i * cellSize - relative.x;
+									pRow[i] += weight * SPHKernels::Poly6::ValueSquared(unitKernel, (shape[0] * dx + b) * dx + c);
+								}
+							}
+						}
+						continue;
+					}
+					for (int32_t k = range[2][0]; k <= range[2][1]; ++k)
+					{
+						float dz = k * cellSize - relative.z;
+						for (int32_t j = range[1][0]; j <= range[1][1]; ++j)
+						{
+							float dy = j * cellSize - relative.y;
+							float dyz2 = dy * dy + dz * dz;
+							float* pRow = pSamples + B * (j + B * k);
+							for (int32_t i = range[0][0]; i <= range[0][1]; ++i)
+							{
+								float dx = i * cellSize - relative.x;
+								pRow[i] += volume * SPHKernels::Poly6::ValueSquared(kernel, dx * dx + dyz2);
+							}
+						}
+					}
+				}
+			}
+		}
+	});
+	m_Stats.SplatMilliseconds = ElapsedMilliseconds(splatStart);
+
+	// 格子点 [-1, B + 1]^3 を隣のブロックから集める (ないブロックの格子点は粒子が届かないので0)
+	const uint32_t P = B + 3;
+	m_PaddedSamples.resize(m_pThreadPool->GetThreadCount());
+	auto fillPadded = [&](uint32_t block, std::vector<float>& padded)
+	{
+		padded.resize(static_cast<size_t>(P) * P * P);
+		int32_t axisBlock[64];
+		uint32_t axisLocal[64];
+		assert(P <= 64);
+		for (uint32_t t = 0; t < P; ++t)
+		{
+			int32_t coord = static_cast<int32_t>(t) - 1;
+			axisBlock[t] = (coord < 0) ? -1 : (coord >= static_cast<int32_t>(B) ? 1 : 0);
+			axisLocal[t] = static_cast<uint32_t>(coord - axisBlock[t] * static_cast<int32_t>(B));
+		}
+		for (uint32_t k = 0; k < P; ++k)
+		{
+			for (uint32_t j = 0; j < P; ++j)
+			{
+				float* pDst = &padded[P * (j + P * k)];
+				for (uint32_t i = 0; i < P; ++i)
+				{
+					int32_t neighbor = m_Neighbors[block * 27 + NeighborIndex(axisBlock[i], axisBlock[j], axisBlock[k])];
+					pDst[i] = (neighbor < 0) ? 0.0f :
+						m_Samples[static_cast<size_t>(neighbor) * B3 + axisLocal[i] + B * (axisLocal[j] + B * axisLocal[k])];
+				}
+			}
+		}
+	};
+
+	// 頂点: ブロックの格子点 [0, B)^3 から +x, +y, +z に伸びる辺を持ち分にし、等値面と交わる辺に1つずつ作る
+	auto marchStart = Clock::now();
+	m_EdgeVertices.resize(static_cast<size_t>(blockCount) * B3 * 3);
+	m_BlockVertices.resize(blockCount);
+	m_BlockIndices.resize(blockCount);
+	const int32_t strides[3] = { 1, static_cast<int32_t>(P), static_cast<int32_t>(P * P) };
+	m_pThreadPool->ParallelForWithThreadIndex(0, blockCount, 1, [&](uint32_t threadIndex, uint32_t begin, uint32_t end)
+	{
+		std::vector<float>& padded = m_PaddedSamples[threadIndex];
+		for (uint32_t block = begin; block < end; ++block)
+		{
+			fillPadded(block, padded);
+			int32_t* pEdges = &m_EdgeVertices[static_cast<size_t>(block) * B3 * 3];
+			std::fill(pEdges, pEdges + B3 * 3, -1);
+			std::vector<Vertex>& vertices = m_BlockVertices[block];
+			vertices.clear();
+			const Vector3D base = blockOrigin(block);
+			auto gradient = [&](uint32_t index)
+			{
+				return Vector3D(padded[index + 1] - padded[index - 1],
+					padded[index + P] - padded[index - P],
+					padded[index + P * P] - padded[index - P * P]);
+			};
+			for (uint32_t k = 0; k < B; ++k)
+			{
+				for (uint32_t j = 0; j < B; ++j)
+				{
+					for (uint32_t i = 0; i < B; ++i)
+					{
+						uint32_t index0 = (i + 1) + P * ((j + 1) + P * (k + 1));
+						float value0 = padded[index0];
+						for (uint32_t axis = 0; axis < 3; ++axis)
+						{
+							uint32_t index1 = index0 + strides[axis];
+							float value1 = padded[index1];
+							if ((value0 >= isoValue) == (value1 >= isoValue))
+							{
+								continue;
+							}
+							float t = (isoValue - value0) / (value1 - value0);
+							Vertex vertex;
+							Vector3D offset(static_cast<float>(i), static_cast<float>(j), static_cast<float>(k));
+							(axis == 0 ? offset.x : (axis == 1 ? offset.y : offset.z)) += t;
+							vertex.m_Position = base + offset * cellSize;
+							// 密度の勾配の逆向きが外向きの法線
+							Vector3D gradient0 = gradient(index0);
+							Vector3D normal = (gradient0 + (gradient(index1) - gradient0) * t) * -1.0f;
+							vertex.m_Normal = normal.GetSafeNormal();
+							if (vertex.m_Normal.dot(vertex.m_Normal) == 0.0f)
+							{
+								vertex.m_Normal = Vector3D(0.0f, 1.0f, 0.0f);
+							}
+							Vector3D up = (std::abs(vertex.m_Normal.y) < 0.99f) ? Vector3D(0.0f, 1.0f, 0.0f) : Vector3D(1.0f, 0.0f, 0.0f);
+							vertex.m_Tangent = up.cross(vertex.m_Normal).GetSafeNormal();
+							vertex.m_TexCoord = Vector2D(0.0f, 0.0f);
+							pEdges[(i + B * (j + B * k)) * 3 + axis] = static_cast<int32_t>(vertices.size());
+							vertices.push_back(vertex);
+						}
+					}
+				}
+			}
+		}
+	});
+
+	m_VertexOffsets.resize(blockCount + 1);
+	m_VertexOffsets[0] = 0;
+	for (uint32_t block = 0; block < blockCount; ++block)
+	{
+		m_VertexOffsets[block + 1] = m_VertexOffsets[block] + static_cast<uint32_t>(m_BlockVertices[block].size());
+	}
+
+	// 三角形: 立方体の辺の始点が B に達した場合は隣のブロックの頂点を使う
+	const MarchingCubesTable& table = GetMarchingCubesTable();
+	uint32_t edgeOffsets[12][3];
+	for (uint32_t edge = 0; edge < 12; ++edge)
+	{
+		uint32_t corner = EdgeOriginCorner(edge);
+		edgeOffsets[edge][0] = corner & 1;
+		edgeOffsets[edge][1] = (corner >> 1) & 1;
+		edgeOffsets[edge][2] = (corner >> 2) & 1;
+	}
+	m_pThreadPool->ParallelForWithThreadIndex(0, blockCount, 1, [&](uint32_t threadIndex, uint32_t begin, uint32_t end)
+	{
+		std::vector<float>& padded = m_PaddedSamples[threadIndex];
+		for (uint32_t block = begin; block < end; ++block)
+		{
+			std::vector<uint32_t>& indices = m_BlockIndices[block];
+			indices.clear();
+			fillPadded(block, padded);
+			for (uint32_t k = 0; k < B; ++k)
+			{
+				for (uint32_t j = 0; j < B; ++j)
+				{
+					for (uint32_t i = 0; i < B; ++i)
+					{
+						uint32_t index0 = (i + 1) + P * ((j + 1) + P * (k + 1));
+						uint32_t cubeCase = 0;
+						for (uint32_t corner = 0; corner < 8; ++corner)
+						{
+							uint32_t index = index0 + (corner & 1) * strides[0] + ((corner >> 1) & 1) * strides[1] + ((corner >> 2) & 1) * strides[2];
+							cubeCase |= (padded[index] >= isoValue ? 1u : 0u) << corner;
+						}
+						const uint32_t triangleCount = table.TriangleCount[cubeCase];
+						for (uint32_t t = 0; t < triangleCount; ++t)
+						{
+							uint32_t triangle[3];
+							bool isValid = true;
+							for (uint32_t v = 0; v < 3 && isValid; ++v)
+							{
+								uint32_t edge = table.Edges[cubeCase][t * 3 + v];
+								uint32_t point[3] = { i + edgeOffsets[edge][0], j + edgeOffsets[edge][1], k + edgeOffsets[edge][2] };
+								int32_t offset[3];
+								for (uint32_t axis = 0; axis < 3; ++axis)
+								{
+									offset[axis] = (point[axis] >= B) ? 1 : 0;
+									point[axis] -= offset[axis] * B;
+								}
+								int32_t owner = m_Neighbors[block * 27 + NeighborIndex(offset[0], offset[1], offset[2])];
+								int32_t local = (owner < 0) ? -1 :
+									m_EdgeVertices[(static_cast<size_t>(owner) * B3 + point[0] + B * (point[1] + B * point[2])) * 3 + edge / 4];
+								isValid = local >= 0;
+								triangle[v] = isValid ? m_VertexOffsets[owner] + static_cast<uint32_t>(local) : 0;
+							}
+							if (isValid)
+							{
+								indices.insert(indices.end(), triangle, triangle + 3);
+							}
+						}
+					}
+				}
+			}
+		}
+	});
+
+	// ブロック毎の頂点と三角形を連結する
+	std::vector<uint32_t> indexOffsets(blockCount + 1, 0);
+	for (uint32_t block = 0; block < blockCount; ++block)
+	{
+		indexOffsets[block + 1] = indexOffsets[block] + static_cast<uint32_t>(m_BlockIndices[block].size());
+	}
+	mesh.Vertices.resize(m_VertexOffsets[blockCount]);
+	mesh.Indices.resize(indexOffsets[blockCount]);
+	m_pThreadPool->ParallelFor(0, blockCount, 16, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t block = begin; block < end; ++block)
+		{
+			std::copy(m_BlockVertices[block].begin(), m_BlockVertices[block].end(), mesh.Vertices.begin() + m_VertexOffsets[block]);
+			std::copy(m_BlockIndices[block].begin(), m_BlockIndices[block].end(), mesh.Indices.begin() + indexOffsets[block]);
+		}
+	});
+	m_Stats.MarchMilliseconds = ElapsedMilliseconds(marchStart);
+	m_Stats.VertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+	m_Stats.TriangleCount = static_cast<uint32_t>(mesh.Indices.size() / 3);
+	m_Stats.TotalMilliseconds = ElapsedMilliseconds(totalStart);
+	return true;
+}
+
+bool SurfaceExtractor::WritePLY(const SurfaceMesh& mesh, const std::string& path)
+{
+	std::FILE* pFile = std::fopen(path.c_str(), "wb");
+	if (pFile == nullptr)
+	{
+		return false;
+	}
+	const size_t triangleCount = mesh.Indices.size() / 3;
+	std::fprintf(pFile, "ply\nformat binary_little_endian 1.0\nelement vertex %zu\n"
+		"property float x\nproperty float y\nproperty float z\nproperty float nx\nproperty float ny\nproperty float nz\n"
+		"element face %zu\nproperty list uchar uint vertex_indices\nend_header\n", mesh.Vertices.size(), triangleCount);
+
+	// リトルエンディアンの環境を前提に、メモリ上の値をそのまま書く
+	std::vector<uint8_t> buffer;
+	bool succeeded = true;
+	const size_t BatchSize = 65536;
+	for (size_t begin = 0; begin < mesh.Vertices.size() && succeeded; begin += BatchSize)
+	{
+		size_t end = std::min(mesh.Vertices.size(), begin + BatchSize);
+		buffer.resize((end - begin) * 24);
+		uint8_t* pDst = buffer.data();
+		for (size_t i = begin; i < end; ++i)
+		{
+			const Vertex& vertex = mesh.Vertices[i];
+			const float values[6] = { vertex.m_Position.x, vertex.m_Position.y, vertex.m_Position.z, vertex.m_Normal.x, vertex.m_Normal.y, vertex.m_Normal.z };
+			std::memcpy(pDst, values, sizeof(values));
+			pDst += sizeof(values);
+		}
+		succeeded = std::fwrite(buffer.data(), 1, buffer.size(), pFile) == buffer.size();
+	}
+	for (size_t begin = 0; begin < triangleCount && succeeded; begin += BatchSize)
+	{
+		size_t end = std::min(triangleCount, begin + BatchSize);
+		buffer.resize((end - begin) * 13);
+		uint8_t* pDst = buffer.data();
+		for (size_t t = begin; t < end; ++t)
+		{
+			*pDst++ = 3;
+			std::memcpy(pDst, &mesh.Indices[t * 3], 12);
+			pDst += 12;
+		}
+		succeeded = std::fwrite(buffer.data(), 1, buffer.size(), pFile) == buffer.size();
+	}
+	succeeded = (std::fclose(pFile) == 0) && succeeded;
+	return succeeded;
+}
@@ -0,0 +1,196 @@
+#include "Simulation/ThreadPool.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	m_ThreadCount = threadCount;
+
+	// 呼び出しスレッドもスレッド0として働くので、ワーカーは1つ少なく作る
+	m_Workers.reserve(m_ThreadCount - 1);
+	for (uint32_t i = 1; i < m_ThreadCount; ++i)
+	{
+		m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsShutdown = true;
+	}
+	m_StartCondition.notify_all();
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::Dispatch(const std::function<void(uint32_t)>& func)
+{
+	if (m_Workers.empty())
+	{
+		func(0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_pJob = &func;
+		m_PendingWorkers = static_cast<uint32_t>(m_Workers.size());
+		++m_Generation;
+	}
+	m_StartCondition.notify_all();
+
+	func(0);
+
+	// 全ワーカーの完了待ち
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_FinishCondition.wait(lock, [this] { return m_PendingWorkers == 0; });
+	m_pJob = nullptr;
+}
+
+bool ThreadPool::PinThreads(const std::vector<uint32_t>& cpus)
+{
+	assert(cpus.empty() || cpus.size() >= m_ThreadCount);
+	std::atomic<uint32_t> pinnedCount(0);
+	Dispatch([&](uint32_t threadIndex)
+	{
+		// 各スレッドが自分自身の affinity を設定する
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (cpus.empty())
+		{
+			for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+			{
+				CPU_SET(cpu, &set);
+			}
+		}
+		else
+		{
+			CPU_SET(cpus[threadIndex], &set);
+		}
+		if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+		{
+			pinnedCount.fetch_add(1);
+		}
+#elif defined(_WIN32)
+		DWORD_PTR mask = 0;
+		if (cpus.empty())
+		{
+			DWORD_PTR systemMask = 0;
+			GetProcessAffinityMask(GetCurrentProcess(), &mask, &systemMask);
+		}
+		else if (cpus[threadIndex] < sizeof(DWORD_PTR) * 8)
+		{
+			mask = DWORD_PTR(1) << cpus[threadIndex];
+		}
+		if (mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0)
+		{
+			pinnedCount.fetch_add(1);
+		}
+#else
+		(void)threadIndex;
+#endif
+	});
+	return pinnedCount.load() == m_ThreadCount;
+}
+
+void ThreadPool::ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize,
+	const std::function<void(uint32_t, uint32_t)>& func)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+	grainSize = std::max(1u, grainSize);
+
+	// 1チャンクで終わる場合はスレッドを起こさない
+	if (end - begin <= grainSize || m_Workers.empty())
+	{
+		func(begin, end);
+		return;
+	}
+
+	std::atomic<uint32_t> nextChunk(begin);
+	Dispatch([&](uint32_t)
+	{
+		while (true)
+		{
+			uint32_t chunkBegin = nextChunk.fetch_add(grainSize);
+			if (chunkBegin >= end)
+			{
+				break;
+			}
+			uint32_t chunkEnd = std::min(end, chunkBegin + grainSize);
+			func(chunkBegin, chunkEnd);
+		}
+	});
+}
+
+void ThreadPool::ParallelForWithThreadIndex(uint32_t begin, uint32_t end, uint32_t grainSize,
+	const std::function<void(uint32_t, uint32_t, uint32_t)>& func)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+	grainSize = std::max(1u, grainSize);
+
+	if (end - begin <= grainSize || m_Workers.empty())
+	{
+		func(0, begin, end);
+		return;
+	}
+
+	std::atomic<uint32_t> nextChunk(begin);
+	Dispatch([&](uint32_t threadIndex)
+	{
+		while (true)
+		{
+			uint32_t chunkBegin = nextChunk.fetch_add(grainSize);
+			if (chunkBegin >= end)
+			{
+				break;
+			}
+			uint32_t chunkEnd = std::min(end, chunkBegin + grainSize);
+			func(threadIndex, chunkBegin, chunkEnd);
+		}
+	});
+}
+
+void ThreadPool::WorkerLoop(uint32_t threadIndex)
+{
+	uint64_t lastGeneration = 0;
+	while (true)
+	{
+		const std::function<void(uint32_t)>* pJob = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_StartCondition.wait(lock, [&] { return m_IsShutdown || m_Generation != lastGeneration; });
+			if (m_IsShutdown)
+			{
+				return;
+			}
+			lastGeneration = m_Generation;
+			pJob = m_pJob;
+		}
+
+		(*pJob)(threadIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			--m_PendingWorkers;
+		}
+		m_FinishCondition.notify_one();
+	}
+}
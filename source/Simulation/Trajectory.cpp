@@ -0,0 +1,727 @@
+#include "Simulation/Trajectory.h"
+#include "Simulation/ThreadPool.h"
+
+#include <atomic>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// 粒子1個当たりの成分数 (位置 xyz + 速度 xyz)
+	const uint32_t ComponentCount = 6;
+
+	// ファイルの先頭
+	struct TrajectoryFileHeader
+	{
+		char Magic[8];
+		uint32_t Version;
+		uint32_t HeaderSize;
+		uint32_t PositionBits;
+		uint32_t VelocityBits;
+		uint32_t KeyframeInterval;
+		uint32_t ChunkSize;
+		float VelocityRange;
+		float WallMin[3];
+		float WallMax[3];
+		float WallMargin;
+	};
+
+	// フレーム毎の先頭。続けて uint32_t のチャンク毎のバイト数と、チャンクを並べる (PayloadBytes はその合計)
+	struct FrameHeader
+	{
+		uint32_t Magic;
+		uint32_t Flags;
+		uint32_t ParticleCount;
+		uint32_t ChunkCount;
+		double Time;
+		uint64_t PayloadBytes;
+	};
+
+	// 末尾の索引の位置 (Close で書く)
+	struct Footer
+	{
+		uint64_t IndexOffset;
+		uint32_t FrameCount;
+		uint32_t Magic;
+	};
+
+	const char TrajectoryMagic[8] = { 'T', 'F', 'S', 'T', 'R', 'A', 'J', '\0' };
+	const uint32_t TrajectoryVersion = 1;
+	const uint32_t FrameMagic = 0x4d415246;  // "FRAM"
+	const uint32_t FooterMagic = 0x58444e49; // "INDX"
+	const uint32_t KeyframeFlag = 1;
+
+	int Seek(std::FILE* pFile, uint64_t offset, int origin)
+	{
+#if defined(_WIN32)
+		return _fseeki64(pFile, static_cast<int64_t>(offset), origin);
+#else
+		return fseeko(pFile, static_cast<off_t>(offset), origin);
+#endif
+	}
+
+	uint64_t Tell(std::FILE* pFile)
+	{
+#if defined(_WIN32)
+		return static_cast<uint64_t>(_ftelli64(pFile));
+#else
+		return static_cast<uint64_t>(ftello(pFile));
+#endif
+	}
+
+	// 量子化 (範囲外は端に丸め、NaNは0にする)
+	uint32_t Quantize(float value, float minValue, float scale, uint32_t maxCode)
+	{
+		float code = std::min(std::max(0.0f, (value - minValue) * scale), static_cast<float>(maxCode));
+		return static_cast<uint32_t>(code + 0.5f);
+	}
+
+	uint32_t ZigZag(uint32_t delta)
+	{
+		int32_t value = static_cast<int32_t>(delta);
+		return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+	}
+
+	uint32_t UnZigZag(uint32_t code)
+	{
+		return (code >> 1) ^ (0u - (code & 1));
+	}
+
+	// 位置・速度の量子化の範囲
+	struct Quantizer
+	{
+		float Min[ComponentCount];
+		float Scale[ComponentCount]; // 値 -> 符号
+		float Step[ComponentCount];  // 符号 -> 値
+		uint32_t MaxCode[ComponentCount];
+
+		Quantizer(const Vector3D& wallMin, const Vector3D& wallMax, const TrajectoryParam& param)
+		{
+			const float wallMinArray[3] = { wallMin.x, wallMin.y, wallMin.z };
+			const float wallMaxArray[3] = { wallMax.x, wallMax.y, wallMax.z };
+			for (uint32_t axis = 0; axis < 3; ++axis)
+			{
+				float margin = (wallMaxArray[axis] - wallMinArray[axis]) * param.WallMargin;
+				Set(axis, wallMinArray[axis] - margin, wallMaxArray[axis] + margin, param.PositionBits);
+				Set(axis + 3, -param.VelocityRange, param.VelocityRange, param.VelocityBits);
+			}
+		}
+
+		void Set(uint32_t component, float minValue, float maxValue, uint32_t bits)
+		{
+			MaxCode[component] = (1u << bits) - 1;
+			float range = std::max(maxValue - minValue, SMALL_NUMBER);
+			Min[component] = minValue;
+			Scale[component] = MaxCode[component] / range;
+			Step[component] = range / MaxCode[component];
+		}
+	};
+
+	// rANS (0次のバイト頻度、32bitの状態をバイト単位で正規化)
+	namespace Rans
+	{
+		const uint32_t ProbBits = 12;
+		const uint32_t ProbScale = 1u << ProbBits;
+		const uint32_t LowerBound = 1u << 23;
+
+		// チャンクの形式
+		const uint8_t ModeStored = 0; // 符号化すると大きくなる場合はそのまま
+		const uint8_t ModeRans = 1;
+
+		// 出現回数を合計 ProbScale の頻度にする (出現したバイトは最低1)
+		void NormalizeFrequencies(const uint32_t counts[256], size_t total, uint32_t freqs[256])
+		{
+			int32_t sum = 0;
+			uint32_t maxSymbol = 0;
+			for (uint32_t symbol = 0; symbol < 256; ++symbol)
+			{
+				freqs[symbol] = (counts[symbol] == 0) ? 0 :
+					std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(counts[symbol]) * ProbScale / total));
+				sum += static_cast<int32_t>(freqs[symbol]);
+				if (freqs[symbol] > freqs[maxSymbol])
+				{
+					maxSymbol = symbol;
+				}
+			}
+			int32_t diff = static_cast<int32_t>(ProbScale) - sum;
+			if (diff >= 0)
+			{
+				freqs[maxSymbol] += static_cast<uint32_t>(diff);
+				return;
+			}
+			// 最低1にした分だけ超えた場合は、頻度の大きいものから削る
+			while (diff < 0)
+			{
+				uint32_t largest = static_cast<uint32_t>(std::max_element(freqs, freqs + 256) - freqs);
+				uint32_t take = std::min(static_cast<uint32_t>(-diff), freqs[largest] - 1);
+				freqs[largest] -= take;
+				diff += static_cast<int32_t>(take);
+			}
+		}
+
+		/// <summary>
+		/// data を [Mode][RawSize][記号数][(記号, 頻度) ...][rANSの符号] として out の末尾に追加します
+		/// </summary>
+		void Encode(const std::vector<uint8_t>& data, std::vector<uint8_t>& out)
+		{
+			const uint32_t rawSize = static_cast<uint32_t>(data.size());
+			auto appendStored = [&]()
+			{
+				out.push_back(ModeStored);
+				out.insert(out.end(), reinterpret_cast<const uint8_t*>(&rawSize), reinterpret_cast<const uint8_t*>(&rawSize) + sizeof(rawSize));
+				out.insert(out.end(), data.begin(), data.end());
+			};
+			if (data.empty())
+			{
+				appendStored();
+				return;
+			}
+
+			uint32_t counts[256] = {};
+			for (uint8_t symbol : data)
+			{
+				++counts[symbol];
+			}
+			uint32_t freqs[256];
+			NormalizeFrequencies(counts, data.size(), freqs);
+			uint32_t starts[256];
+			uint32_t cumulative = 0;
+			uint16_t symbolCount = 0;
+			for (uint32_t symbol = 0; symbol < 256; ++symbol)
+			{
+				starts[symbol] = cumulative;
+				cumulative += freqs[symbol];
+				symbolCount += (freqs[symbol] > 0) ? 1 : 0;
+			}
+
+			// 後ろの記号から符号化し、バッファの末尾から前へ書く (復号は前から読む)
+			std::vector<uint8_t> encoded(data.size() + 8);
+			uint8_t* pBegin = encoded.data();
+			uint8_t* pEnd = pBegin + encoded.size();
+			uint8_t* pOut = pEnd;
+			uint32_t state = LowerBound;
+			bool overflow = false;
+			for (size_t i = data.size(); i-- > 0 && !overflow;)
+			{
+				uint32_t freq = freqs[data[i]];
+				uint32_t maxState = ((LowerBound >> ProbBits) << 8) * freq;
+				while (state >= maxState)
+				{
+					if (pOut == pBegin)
+					{
+						overflow = true;
+						break;
+					}
+					*--pOut = static_cast<uint8_t>(state & 0xff);
+					state >>= 8;
+				}
+				state = ((state / freq) << ProbBits) + (state % freq) + starts[data[i]];
+			}
+			const size_t tableBytes = sizeof(symbolCount) + symbolCount * 3;
+			if (overflow || pOut - pBegin < 4 || static_cast<size_t>(pEnd - pOut) + 4 + tableBytes >= data.size())
+			{
+				appendStored();
+				return;
+			}
+			pOut -= 4;
+			std::memcpy(pOut, &state, sizeof(state));
+
+			out.push_back(ModeRans);
+			out.insert(out.end(), reinterpret_cast<const uint8_t*>(&rawSize), reinterpret_cast<const uint8_t*>(&rawSize) + sizeof(rawSize));
+			out.insert(out.end(), reinterpret_cast<const uint8_t*>(&symbolCount), reinterpret_cast<const uint8_t*>(&symbolCount) + sizeof(symbolCount));
+			for (uint32_t symbol = 0; symbol < 256; ++symbol)
+			{
+				if (freqs[symbol] > 0)
+				{
+					uint16_t freq = static_cast<uint16_t>(freqs[symbol]);
+					out.push_back(static_cast<uint8_t>(symbol));
+					out.insert(out.end(), reinterpret_cast<const uint8_t*>(&freq), reinterpret_cast<const uint8_t*>(&freq) + sizeof(freq));
+				}
+			}
+			out.insert(out.end(), pOut, pEnd);
+		}
+
+		/// <summary>
+		/// Encode で書いたチャンク [pData, pData + size) を復号します
+		/// </summary>
+		/// <returns>形式が壊れている場合は false</returns>
+		bool Decode(const uint8_t* pData, size_t size, std::vector<uint8_t>& out)
+		{
+			const uint8_t* pEnd = pData + size;
+			uint32_t rawSize = 0;
+			if (size < 1 + sizeof(rawSize))
+			{
+				return false;
+			}
+			uint8_t mode = *pData++;
+			std::memcpy(&rawSize, pData, sizeof(rawSize));
+			pData += sizeof(rawSize);
+			out.resize(rawSize);
+			if (mode == ModeStored)
+			{
+				if (static_cast<size_t>(pEnd - pData) != rawSize)
+				{
+					return false;
+				}
+				std::copy(pData, pEnd, out.begin());
+				return true;
+			}
+
+			uint16_t symbolCount = 0;
+			if (mode != ModeRans || pEnd - pData < static_cast<ptrdiff_t>(sizeof(symbolCount)))
+			{
+				return false;
+			}
+			std::memcpy(&symbolCount, pData, sizeof(symbolCount));
+			pData += sizeof(symbolCount);
+			if (pEnd - pData < static_cast<ptrdiff_t>(symbolCount) * 3 + 4)
+			{
+				return false;
+			}
+			uint32_t freqs[256] = {};
+			uint32_t starts[256] = {};
+			std::vector<uint8_t> slotSymbols(ProbScale);
+			uint32_t cumulative = 0;
+			for (uint32_t i = 0; i < symbolCount; ++i)
+			{
+				uint8_t symbol = pData[0];
+				uint16_t freq = 0;
+				std::memcpy(&freq, pData + 1, sizeof(freq));
+				pData += 3;
+				if (freq == 0 || cumulative + freq > ProbScale)
+				{
+					return false;
+				}
+				freqs[symbol] = freq;
+				starts[symbol] = cumulative;
+				std::fill(slotSymbols.begin() + cumulative, slotSymbols.begin() + cumulative + freq, symbol);
+				cumulative += freq;
+			}
+			if (cumulative != ProbScale)
+			{
+				return false;
+			}
+
+			uint32_t state = 0;
+			std::memcpy(&state, pData, sizeof(state));
+			pData += sizeof(state);
+			for (uint32_t i = 0; i < rawSize; ++i)
+			{
+				uint32_t slot = state & (ProbScale - 1);
+				uint8_t symbol = slotSymbols[slot];
+				out[i] = symbol;
+				state = freqs[symbol] * (state >> ProbBits) + slot - starts[symbol];
+				while (state < LowerBound)
+				{
+					if (pData == pEnd)
+					{
+						return false;
+					}
+					state = (state << 8) | *pData++;
+				}
+			}
+			return true;
+		}
+	}
+
+	/// <summary>
+	/// 粒子 [begin, end) の量子化値と前のフレーム (prevCount 以降の粒子とキーフレームは0) との差分を、
+	/// 成分毎に zigzag + 可変長整数で並べてから rANS で符号化します
+	/// </summary>
+	void EncodeChunk(const uint32_t* pQuantized, const uint32_t* pPrevQuantized, uint32_t prevCount,
+		uint32_t begin, uint32_t end, std::vector<uint8_t>& out)
+	{
+		// 可変長整数は1個最大5byte
+		std::vector<uint8_t> bytes(static_cast<size_t>(end - begin) * ComponentCount * 5);
+		uint8_t* pOut = bytes.data();
+		for (uint32_t component = 0; component < ComponentCount; ++component)
+		{
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				uint32_t prev = (i < prevCount) ? pPrevQuantized[i * ComponentCount + component] : 0;
+				uint32_t code = ZigZag(pQuantized[i * ComponentCount + component] - prev);
+				while (code >= 0x80)
+				{
+					*pOut++ = static_cast<uint8_t>(code | 0x80);
+					code >>= 7;
+				}
+				*pOut++ = static_cast<uint8_t>(code);
+			}
+		}
+		bytes.resize(pOut - bytes.data());
+		out.clear();
+		Rans::Encode(bytes, out);
+	}
+
+	/// <summary>
+	/// EncodeChunk の逆。差分を pQuantized に足す (キーフレームでは置き換える)
+	/// </summary>
+	bool DecodeChunk(const uint8_t* pData, size_t size, bool keyframe, uint32_t begin, uint32_t end, uint32_t* pQuantized)
+	{
+		std::vector<uint8_t> bytes;
+		if (!Rans::Decode(pData, size, bytes))
+		{
+			return false;
+		}
+		size_t position = 0;
+		for (uint32_t component = 0; component < ComponentCount; ++component)
+		{
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				uint32_t code = 0;
+				for (uint32_t shift = 0;; shift += 7)
+				{
+					if (position == bytes.size() || shift > 28)
+					{
+						return false;
+					}
+					uint8_t byte = bytes[position++];
+					code |= static_cast<uint32_t>(byte & 0x7f) << shift;
+					if ((byte & 0x80) == 0)
+					{
+						break;
+					}
+				}
+				uint32_t& value = pQuantized[i * ComponentCount + component];
+				value = (keyframe ? 0 : value) + UnZigZag(code);
+			}
+		}
+		return position == bytes.size();
+	}
+}
+
+TrajectoryWriter::TrajectoryWriter(uint32_t threadCount)
+	: m_pThreadPool(std::make_unique<ThreadPool>(threadCount))
+{
+}
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+	Close();
+}
+
+bool TrajectoryWriter::Open(const std::string& path, const Vector3D& wallMin, const Vector3D& wallMax, const TrajectoryParam& param)
+{
+	Close();
+	assert(param.PositionBits >= 1 && param.PositionBits <= 24);
+	assert(param.VelocityBits >= 1 && param.VelocityBits <= 24);
+	m_pFile = std::fopen(path.c_str(), "wb");
+	if (m_pFile == nullptr)
+	{
+		return false;
+	}
+	m_Param = param;
+	m_Param.KeyframeInterval = std::max(1u, param.KeyframeInterval);
+	m_Param.ChunkSize = std::max(1u, param.ChunkSize);
+	m_WallMin = wallMin;
+	m_WallMax = wallMax;
+	m_PrevQuantized.clear();
+	m_Index.clear();
+	m_Stats = TrajectoryStats();
+
+	TrajectoryFileHeader header = {};
+	std::memcpy(header.Magic, TrajectoryMagic, sizeof(header.Magic));
+	header.Version = TrajectoryVersion;
+	header.HeaderSize = sizeof(TrajectoryFileHeader);
+	header.PositionBits = m_Param.PositionBits;
+	header.VelocityBits = m_Param.VelocityBits;
+	header.KeyframeInterval = m_Param.KeyframeInterval;
+	header.ChunkSize = m_Param.ChunkSize;
+	header.VelocityRange = m_Param.VelocityRange;
+	header.WallMargin = m_Param.WallMargin;
+	header.WallMin[0] = wallMin.x; header.WallMin[1] = wallMin.y; header.WallMin[2] = wallMin.z;
+	header.WallMax[0] = wallMax.x; header.WallMax[1] = wallMax.y; header.WallMax[2] = wallMax.z;
+	if (std::fwrite(&header, sizeof(header), 1, m_pFile) != 1)
+	{
+		std::fclose(m_pFile);
+		m_pFile = nullptr;
+		return false;
+	}
+	m_FileOffset = sizeof(header);
+	m_Stats.EncodedBytes = sizeof(header);
+	return true;
+}
+
+bool TrajectoryWriter::WriteFrame(const std::vector<Particle>& particles, double time)
+{
+	if (m_pFile == nullptr)
+	{
+		return false;
+	}
+	auto start = Clock::now();
+	const uint32_t count = static_cast<uint32_t>(particles.size());
+	const uint32_t prevCount = static_cast<uint32_t>(m_PrevQuantized.size() / ComponentCount);
+	// 粒子が減った場合はIDの詰め方が変わるので、前のフレームとの差分は取れない
+	const bool keyframe = (m_Stats.FrameCount % m_Param.KeyframeInterval == 0) || count < prevCount;
+	const uint32_t chunkCount = (count + m_Param.ChunkSize - 1) / m_Param.ChunkSize;
+	const Quantizer quantizer(m_WallMin, m_WallMax, m_Param);
+
+	m_Quantized.resize(static_cast<size_t>(count) * ComponentCount);
+	m_Chunks.resize(chunkCount);
+	m_pThreadPool->ParallelFor(0, chunkCount, 1, [&](uint32_t chunkBegin, uint32_t chunkEnd)
+	{
+		for (uint32_t chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+		{
+			uint32_t begin = chunk * m_Param.ChunkSize;
+			uint32_t end = std::min(count, begin + m_Param.ChunkSize);
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				const Particle& particle = particles[i];
+				const float values[ComponentCount] = { particle.Position.x, particle.Position.y, particle.Position.z,
+					particle.Velocity.x, particle.Velocity.y, particle.Velocity.z };
+				for (uint32_t component = 0; component < ComponentCount; ++component)
+				{
+					m_Quantized[i * ComponentCount + component] = Quantize(values[component],
+						quantizer.Min[component], quantizer.Scale[component], quantizer.MaxCode[component]);
+				}
+			}
+			EncodeChunk(m_Quantized.data(), m_PrevQuantized.data(), keyframe ? 0 : prevCount, begin, end, m_Chunks[chunk]);
+		}
+	});
+
+	FrameHeader frameHeader = {};
+	frameHeader.Magic = FrameMagic;
+	frameHeader.Flags = keyframe ? KeyframeFlag : 0;
+	frameHeader.ParticleCount = count;
+	frameHeader.ChunkCount = chunkCount;
+	frameHeader.Time = time;
+	std::vector<uint32_t> chunkBytes(chunkCount);
+	frameHeader.PayloadBytes = sizeof(uint32_t) * static_cast<uint64_t>(chunkCount);
+	for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+	{
+		chunkBytes[chunk] = static_cast<uint32_t>(m_Chunks[chunk].size());
+		frameHeader.PayloadBytes += chunkBytes[chunk];
+	}
+	m_Stats.EncodeMilliseconds += ElapsedMilliseconds(start);
+
+	bool succeeded = std::fwrite(&frameHeader, sizeof(frameHeader), 1, m_pFile) == 1 &&
+		(chunkCount == 0 || std::fwrite(chunkBytes.data(), sizeof(uint32_t), chunkCount, m_pFile) == chunkCount);
+	for (uint32_t chunk = 0; chunk < chunkCount && succeeded; ++chunk)
+	{
+		succeeded = std::fwrite(m_Chunks[chunk].data(), 1, m_Chunks[chunk].size(), m_pFile) == m_Chunks[chunk].size();
+	}
+	if (!succeeded)
+	{
+		return false;
+	}
+
+	m_Index.push_back({ m_FileOffset, frameHeader.Flags, count });
+	const uint64_t frameBytes = sizeof(frameHeader) + frameHeader.PayloadBytes;
+	m_FileOffset += frameBytes;
+	m_Quantized.swap(m_PrevQuantized);
+	++m_Stats.FrameCount;
+	m_Stats.KeyframeCount += keyframe ? 1 : 0;
+	m_Stats.RawBytes += sizeof(Particle) * static_cast<uint64_t>(count);
+	m_Stats.EncodedBytes += frameBytes;
+	return true;
+}
+
+bool TrajectoryWriter::Close()
+{
+	if (m_pFile == nullptr)
+	{
+		return true;
+	}
+	Footer footer = {};
+	footer.IndexOffset = m_FileOffset;
+	footer.FrameCount = static_cast<uint32_t>(m_Index.size());
+	footer.Magic = FooterMagic;
+	bool succeeded = (m_Index.empty() || std::fwrite(m_Index.data(), sizeof(IndexEntry), m_Index.size(), m_pFile) == m_Index.size()) &&
+		std::fwrite(&footer, sizeof(footer), 1, m_pFile) == 1;
+	m_Stats.EncodedBytes += sizeof(IndexEntry) * m_Index.size() + sizeof(footer);
+	succeeded = (std::fclose(m_pFile) == 0) && succeeded;
+	m_pFile = nullptr;
+	return succeeded;
+}
+
+TrajectoryReader::TrajectoryReader(uint32_t threadCount)
+	: m_pThreadPool(std::make_unique<ThreadPool>(threadCount))
+{
+}
+
+TrajectoryReader::~TrajectoryReader()
+{
+	Close();
+}
+
+bool TrajectoryReader::Open(const std::string& path)
+{
+	Close();
+	m_pFile = std::fopen(path.c_str(), "rb");
+	if (m_pFile == nullptr)
+	{
+		return false;
+	}
+	TrajectoryFileHeader header = {};
+	if (std::fread(&header, sizeof(header), 1, m_pFile) != 1 ||
+		std::memcmp(header.Magic, TrajectoryMagic, sizeof(header.Magic)) != 0 ||
+		header.Version != TrajectoryVersion || header.HeaderSize != sizeof(TrajectoryFileHeader) ||
+		header.PositionBits < 1 || header.PositionBits > 24 || header.VelocityBits < 1 || header.VelocityBits > 24 || header.ChunkSize == 0)
+	{
+		Close();
+		return false;
+	}
+	m_Param.PositionBits = header.PositionBits;
+	m_Param.VelocityBits = header.VelocityBits;
+	m_Param.VelocityRange = header.VelocityRange;
+	m_Param.WallMargin = header.WallMargin;
+	m_Param.KeyframeInterval = header.KeyframeInterval;
+	m_Param.ChunkSize = header.ChunkSize;
+	m_WallMin = Vector3D(header.WallMin[0], header.WallMin[1], header.WallMin[2]);
+	m_WallMax = Vector3D(header.WallMax[0], header.WallMax[1], header.WallMax[2]);
+
+	Seek(m_pFile, 0, SEEK_END);
+	const uint64_t fileSize = Tell(m_pFile);
+
+	// 末尾の索引を読む
+	Footer footer = {};
+	if (fileSize >= sizeof(header) + sizeof(footer) && Seek(m_pFile, fileSize - sizeof(footer), SEEK_SET) == 0 &&
+		std::fread(&footer, sizeof(footer), 1, m_pFile) == 1 && footer.Magic == FooterMagic &&
+		footer.IndexOffset + sizeof(IndexEntry) * static_cast<uint64_t>(footer.FrameCount) + sizeof(footer) == fileSize)
+	{
+		m_Index.resize(footer.FrameCount);
+		if (Seek(m_pFile, footer.IndexOffset, SEEK_SET) == 0 &&
+			(footer.FrameCount == 0 || std::fread(m_Index.data(), sizeof(IndexEntry), footer.FrameCount, m_pFile) == footer.FrameCount))
+		{
+			return true;
+		}
+		m_Index.clear();
+	}
+
+	// 索引がない (書き込み中に終了した) 場合は、フレームの先頭を辿る。途中で切れた最後のフレームは使わない
+	uint64_t offset = sizeof(header);
+	FrameHeader frameHeader = {};
+	while (offset + sizeof(frameHeader) <= fileSize && Seek(m_pFile, offset, SEEK_SET) == 0 &&
+		std::fread(&frameHeader, sizeof(frameHeader), 1, m_pFile) == 1 && frameHeader.Magic == FrameMagic &&
+		frameHeader.PayloadBytes <= fileSize - offset - sizeof(frameHeader))
+	{
+		m_Index.push_back({ offset, frameHeader.Flags, frameHeader.ParticleCount });
+		offset += sizeof(frameHeader) + frameHeader.PayloadBytes;
+	}
+	return true;
+}
+
+void TrajectoryReader::Close()
+{
+	if (m_pFile != nullptr)
+	{
+		std::fclose(m_pFile);
+		m_pFile = nullptr;
+	}
+	m_Index.clear();
+	m_Quantized.clear();
+	m_DecodedFrame = -1;
+}
+
+bool TrajectoryReader::IsKeyframe(uint32_t frameIndex) const
+{
+	return (m_Index[frameIndex].Flags & KeyframeFlag) != 0;
+}
+
+bool TrajectoryReader::ReadFrame(uint32_t frameIndex, TrajectoryFrame& frame)
+{
+	if (m_pFile == nullptr || frameIndex >= GetFrameCount())
+	{
+		return false;
+	}
+	// 直前のキーフレームから復号する (既に途中まで復号している場合はその続きから)
+	uint32_t keyframe = frameIndex;
+	while (keyframe > 0 && !IsKeyframe(keyframe))
+	{
+		--keyframe;
+	}
+	int64_t first = (m_DecodedFrame >= keyframe && m_DecodedFrame <= frameIndex) ? m_DecodedFrame + 1 : keyframe;
+	for (int64_t decodeFrame = first; decodeFrame <= frameIndex; ++decodeFrame)
+	{
+		if (!DecodeFrame(static_cast<uint32_t>(decodeFrame), m_DecodedTime))
+		{
+			m_DecodedFrame = -1;
+			return false;
+		}
+		m_DecodedFrame = decodeFrame;
+	}
+
+	const uint32_t count = static_cast<uint32_t>(m_Quantized.size() / ComponentCount);
+	const Quantizer quantizer(m_WallMin, m_WallMax, m_Param);
+	frame.Time = m_DecodedTime;
+	frame.Positions.resize(count);
+	frame.Velocities.resize(count);
+	m_pThreadPool->ParallelFor(0, count, m_Param.ChunkSize, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			float values[ComponentCount];
+			for (uint32_t component = 0; component < ComponentCount; ++component)
+			{
+				values[component] = quantizer.Min[component] + m_Quantized[i * ComponentCount + component] * quantizer.Step[component];
+			}
+			frame.Positions[i] = Vector3D(values[0], values[1], values[2]);
+			frame.Velocities[i] = Vector3D(values[3], values[4], values[5]);
+		}
+	});
+	return true;
+}
+
+bool TrajectoryReader::DecodeFrame(uint32_t frameIndex, double& time)
+{
+	FrameHeader frameHeader = {};
+	if (Seek(m_pFile, m_Index[frameIndex].Offset, SEEK_SET) != 0 ||
+		std::fread(&frameHeader, sizeof(frameHeader), 1, m_pFile) != 1 || frameHeader.Magic != FrameMagic ||
+		frameHeader.ChunkCount != (frameHeader.ParticleCount + m_Param.ChunkSize - 1) / m_Param.ChunkSize ||
+		frameHeader.PayloadBytes < sizeof(uint32_t) * static_cast<uint64_t>(frameHeader.ChunkCount))
+	{
+		return false;
+	}
+	m_Payload.resize(static_cast<size_t>(frameHeader.PayloadBytes));
+	if (!m_Payload.empty() && std::fread(m_Payload.data(), 1, m_Payload.size(), m_pFile) != m_Payload.size())
+	{
+		return false;
+	}
+
+	const bool keyframe = (frameHeader.Flags & KeyframeFlag) != 0;
+	const uint32_t count = frameHeader.ParticleCount;
+	const size_t prevSize = m_Quantized.size();
+	if (!keyframe && static_cast<size_t>(count) * ComponentCount < prevSize)
+	{
+		return false;
+	}
+	// 増えた粒子は0からの差分
+	m_Quantized.resize(static_cast<size_t>(count) * ComponentCount, 0);
+
+	// チャンクの開始位置
+	const uint32_t chunkCount = frameHeader.ChunkCount;
+	std::vector<uint64_t> chunkOffsets(chunkCount + 1);
+	chunkOffsets[0] = sizeof(uint32_t) * static_cast<uint64_t>(chunkCount);
+	for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+	{
+		uint32_t chunkBytes = 0;
+		std::memcpy(&chunkBytes, m_Payload.data() + sizeof(uint32_t) * chunk, sizeof(chunkBytes));
+		chunkOffsets[chunk + 1] = chunkOffsets[chunk] + chunkBytes;
+	}
+	if (chunkOffsets[chunkCount] != frameHeader.PayloadBytes)
+	{
+		return false;
+	}
+
+	std::atomic<bool> succeeded(true);
+	m_pThreadPool->ParallelFor(0, chunkCount, 1, [&](uint32_t chunkBegin, uint32_t chunkEnd)
+	{
+		for (uint32_t chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+		{
+			uint32_t begin = chunk * m_Param.ChunkSize;
+			uint32_t end = std::min(count, begin + m_Param.ChunkSize);
+			if (!DecodeChunk(m_Payload.data() + chunkOffsets[chunk], static_cast<size_t>(chunkOffsets[chunk + 1] - chunkOffsets[chunk]),
+				keyframe, begin, end, m_Quantized.data()))
+			{
+				succeeded.store(false, std::memory_order_relaxed);
+			}
+		}
+	});
+	time = frameHeader.Time;
+	return succeeded.load();
+}
@@ -0,0 +1,785 @@
+#include "Simulation/TriangleBVH.h"
+#include "Simulation/ThreadPool.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double ElapsedMilliseconds(const Clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	struct AABB
+	{
+		Vector3D Min = Vector3D(FLT_MAX, FLT_MAX, FLT_MAX);
+		Vector3D Max = Vector3D(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+		void Grow(const Vector3D& point)
+		{
+			Min = Vector3D(std::min(Min.x, point.x), std::min(Min.y, point.y), std::min(Min.z, point.z));
+			Max = Vector3D(std::max(Max.x, point.x), std::max(Max.y, point.y), std::max(Max.z, point.z));
+		}
+		void Grow(const AABB& box)
+		{
+			Min = Vector3D(std::min(Min.x, box.Min.x), std::min(Min.y, box.Min.y), std::min(Min.z, box.Min.z));
+			Max = Vector3D(std::max(Max.x, box.Max.x), std::max(Max.y, box.Max.y), std::max(Max.z, box.Max.z));
+		}
+		// 表面積の半分 (空の箱は0)
+		float HalfArea() const
+		{
+			if (Min.x > Max.x)
+			{
+				return 0.0f;
+			}
+			const Vector3D extent = Max - Min;
+			return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+		}
+	};
+
+	float Axis(const Vector3D& v, uint32_t axis)
+	{
+		return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+	}
+
+	struct Bin
+	{
+		AABB Bounds;
+		uint32_t Count = 0;
+	};
+
+	// 軸毎のビン (ノード毎に作ると初期化の方が重いので、使い回して使う分だけ Reset する)
+	struct BinSet
+	{
+		Bin Bins[3][BVHBuildParam::MaxBinCount];
+
+		void Reset(uint32_t binCount)
+		{
+			for (auto& axisBins : Bins)
+			{
+				std::fill(axisBins, axisBins + binCount, Bin());
+			}
+		}
+
+		void Merge(const BinSet& other, uint32_t binCount)
+		{
+			for (uint32_t axis = 0; axis < 3; ++axis)
+			{
+				for (uint32_t b = 0; b < binCount; ++b)
+				{
+					Bins[axis][b].Bounds.Grow(other.Bins[axis][b].Bounds);
+					Bins[axis][b].Count += other.Bins[axis][b].Count;
+				}
+			}
+		}
+	};
+
+	// 構築中の三角形の箱と重心 (order は葉の順に並べ替える三角形の番号)
+	struct BuildContext
+	{
+		const BVHBuildParam* pParam = nullptr;
+		std::vector<AABB> Bounds;
+		std::vector<Vector3D> Centroids;
+		std::vector<uint32_t> Order;
+	};
+
+	// 分割の結果
+	struct SplitResult
+	{
+		uint32_t LeftCount = 0;
+		AABB LeftBounds;
+		AABB RightBounds;
+	};
+
+	// 重心の範囲 [centroidMin, centroidMin + extent] を binCount 等分したビンの番号
+	inline uint32_t BinIndex(float centroid, float centroidMin, float binScale, uint32_t binCount)
+	{
+		const int32_t bin = static_cast<int32_t>((centroid - centroidMin) * binScale);
+		return static_cast<uint32_t>(std::min(std::max(bin, 0), static_cast<int32_t>(binCount) - 1));
+	}
+
+	void BinRange(const BuildContext& context, uint32_t begin, uint32_t end, const AABB& centroidBounds, const float* binScale, uint32_t binCount, BinSet& bins)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const uint32_t triangle = context.Order[i];
+			const Vector3D& centroid = context.Centroids[triangle];
+			for (uint32_t axis = 0; axis < 3; ++axis)
+			{
+				Bin& bin = bins.Bins[axis][BinIndex(Axis(centroid, axis), Axis(centroidBounds.Min, axis), binScale[axis], binCount)];
+				bin.Bounds.Grow(context.Bounds[triangle]);
+				++bin.Count;
+			}
+		}
+	}
+
+	// [first, first + count) の三角形を中央で2つに分ける (重心がすべて同じ場合や深すぎる場合)
+	void SplitMedian(BuildContext& context, uint32_t first, uint32_t count, const AABB& centroidBounds, SplitResult& result)
+	{
+		const Vector3D extent = centroidBounds.Max - centroidBounds.Min;
+		const uint32_t axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+		uint32_t* pOrder = context.Order.data() + first;
+		result.LeftCount = count / 2;
+		std::nth_element(pOrder, pOrder + result.LeftCount, pOrder + count, [&](uint32_t a, uint32_t b)
+		{
+			return Axis(context.Centroids[a], axis) < Axis(context.Centroids[b], axis);
+		});
+		result.LeftBounds = AABB();
+		result.RightBounds = AABB();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			(i < result.LeftCount ? result.LeftBounds : result.RightBounds).Grow(context.Bounds[pOrder[i]]);
+		}
+	}
+
+	/// <summary>
+	/// ノード (三角形 [first, first + count)、箱 nodeBounds) を SAH で分けます。pThreadPool を渡した場合は重心の範囲とビン分けを並列に行う
+	/// (bins は作業用。並列の場合はスレッド毎のビンも使う)
+	/// </summary>
+	/// <returns>葉にする方が安い場合は false</returns>
+	bool SplitNode(BuildContext& context, uint32_t first, uint32_t count, const AABB& nodeBounds, uint32_t depth, ThreadPool* pThreadPool,
+		BinSet& bins, SplitResult& result)
+	{
+		const BVHBuildParam& param = *context.pParam;
+		if (count <= 1)
+		{
+			return false;
+		}
+		AABB centroidBounds;
+		if (pThreadPool != nullptr)
+		{
+			centroidBounds = pThreadPool->ParallelReduce(count, AABB(),
+				[&](uint32_t i) { AABB box; box.Grow(context.Centroids[context.Order[first + i]]); return box; },
+				[](AABB a, const AABB& b) { a.Grow(b); return a; });
+		}
+		else
+		{
+			for (uint32_t i = first; i < first + count; ++i)
+			{
+				centroidBounds.Grow(context.Centroids[context.Order[i]]);
+			}
+		}
+		const Vector3D centroidExtent = centroidBounds.Max - centroidBounds.Min;
+		const bool degenerate = centroidExtent.x <= 0.0f && centroidExtent.y <= 0.0f && centroidExtent.z <= 0.0f;
+		// 辿る時のスタックに収まるよう、深いノードは中央で分けて残りの深さを log2(count) にする
+		if (degenerate || depth + 40 >= TriangleBVH::MaxStackDepth)
+		{
+			if (count <= param.MaxLeafSize)
+			{
+				return false;
+			}
+			SplitMedian(context, first, count, centroidBounds, result);
+			return true;
+		}
+
+		// 下の方の小さいノードは三角形の数よりビンを多くしても境界の候補は増えないので、ビンを減らして走査を軽くする
+		const uint32_t binCount = std::min(param.BinCount, std::max(count, 4u));
+		float binScale[3];
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			const float extent = Axis(centroidExtent, axis);
+			binScale[axis] = (extent > 0.0f) ? binCount / extent : 0.0f;
+		}
+		bins.Reset(binCount);
+		if (pThreadPool != nullptr)
+		{
+			std::vector<BinSet> threadBins(pThreadPool->GetThreadCount());
+			pThreadPool->ParallelForWithThreadIndex(first, first + count, 4096, [&](uint32_t threadIndex, uint32_t begin, uint32_t end)
+			{
+				BinRange(context, begin, end, centroidBounds, binScale, binCount, threadBins[threadIndex]);
+			});
+			for (const BinSet& threadBin : threadBins)
+			{
+				bins.Merge(threadBin, binCount);
+			}
+		}
+		else
+		{
+			BinRange(context, first, first + count, centroidBounds, binScale, binCount, bins);
+		}
+
+		// ビンの境界毎に、左右の箱の表面積 × 三角形数 を左右から累積して一番安い境界を選ぶ
+		float bestCost = FLT_MAX;
+		uint32_t bestAxis = 0;
+		uint32_t bestSplit = 0;
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			if (binScale[axis] <= 0.0f)
+			{
+				continue;
+			}
+			float rightCosts[BVHBuildParam::MaxBinCount];
+			AABB rightBounds;
+			uint32_t rightCount = 0;
+			for (uint32_t b = binCount - 1; b > 0; --b)
+			{
+				rightBounds.Grow(bins.Bins[axis][b].Bounds);
+				rightCount += bins.Bins[axis][b].Count;
+				rightCosts[b] = rightBounds.HalfArea() * rightCount;
+			}
+			AABB leftBounds;
+			uint32_t leftCount = 0;
+			for (uint32_t b = 1; b < binCount; ++b)
+			{
+				leftBounds.Grow(bins.Bins[axis][b - 1].Bounds);
+				leftCount += bins.Bins[axis][b - 1].Count;
+				const float cost = leftBounds.HalfArea() * leftCount + rightCosts[b];
+				if (leftCount > 0 && leftCount < count && cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b;
+				}
+			}
+		}
+		const float nodeArea = std::max(nodeBounds.HalfArea(), FLT_MIN);
+		const float splitCost = param.TraversalCost + bestCost / nodeArea;
+		if (bestCost == FLT_MAX || (count <= param.MaxLeafSize && splitCost >= static_cast<float>(count)))
+		{
+			if (count <= param.MaxLeafSize)
+			{
+				return false;
+			}
+			SplitMedian(context, first, count, centroidBounds, result);
+			return true;
+		}
+
+		const float centroidMin = Axis(centroidBounds.Min, bestAxis);
+		const float scale = binScale[bestAxis];
+		uint32_t* pOrder = context.Order.data() + first;
+		uint32_t* pMiddle = std::partition(pOrder, pOrder + count, [&](uint32_t triangle)
+		{
+			return BinIndex(Axis(context.Centroids[triangle], bestAxis), centroidMin, scale, binCount) < bestSplit;
+		});
+		result.LeftCount = static_cast<uint32_t>(pMiddle - pOrder);
+		result.LeftBounds = AABB();
+		result.RightBounds = AABB();
+		for (uint32_t b = 0; b < binCount; ++b)
+		{
+			(b < bestSplit ? result.LeftBounds : result.RightBounds).Grow(bins.Bins[bestAxis][b].Bounds);
+		}
+		return true;
+	}
+
+	void SetBounds(BVHNode& node, const AABB& bounds)
+	{
+		node.BoundsMin = bounds.Min;
+		node.BoundsMax = bounds.Max;
+	}
+
+	AABB GetBounds(const BVHNode& node)
+	{
+		AABB bounds;
+		bounds.Min = node.BoundsMin;
+		bounds.Max = node.BoundsMax;
+		return bounds;
+	}
+
+	// 分ける途中のノード
+	struct BuildTask
+	{
+		uint32_t Node;
+		uint32_t First;
+		uint32_t Count;
+		uint32_t Depth;
+	};
+
+	/// <summary>
+	/// task.Node の部分木を nodes に1スレッドで作ります (nodes[rootIndex] が部分木の根で、子は nodes の末尾に足す)
+	/// </summary>
+	void BuildSubtree(BuildContext& context, std::vector<BVHNode>& nodes, const BuildTask& root)
+	{
+		std::vector<BuildTask> stack = { root };
+		std::unique_ptr<BinSet> pBins = std::make_unique<BinSet>();
+		while (!stack.empty())
+		{
+			const BuildTask task = stack.back();
+			stack.pop_back();
+			SplitResult split;
+			if (!SplitNode(context, task.First, task.Count, GetBounds(nodes[task.Node]), task.Depth, nullptr, *pBins, split))
+			{
+				nodes[task.Node].LeftOrFirst = task.First;
+				nodes[task.Node].TriangleCount = task.Count;
+				continue;
+			}
+			const uint32_t left = static_cast<uint32_t>(nodes.size());
+			nodes[task.Node].LeftOrFirst = left;
+			nodes[task.Node].TriangleCount = 0;
+			nodes.resize(left + 2);
+			SetBounds(nodes[left], split.LeftBounds);
+			SetBounds(nodes[left + 1], split.RightBounds);
+			stack.push_back({ left, task.First, split.LeftCount, task.Depth + 1 });
+			stack.push_back({ left + 1, task.First + split.LeftCount, task.Count - split.LeftCount, task.Depth + 1 });
+		}
+	}
+
+	// 箱とレイの交差 (入る距離。交わらない・tMax より遠い場合は FLT_MAX)
+	inline float IntersectBox(const BVHNode& node, const Vector3D& origin, const Vector3D& invDirection, float tMax)
+	{
+		const float tx1 = (node.BoundsMin.x - origin.x) * invDirection.x;
+		const float tx2 = (node.BoundsMax.x - origin.x) * invDirection.x;
+		const float ty1 = (node.BoundsMin.y - origin.y) * invDirection.y;
+		const float ty2 = (node.BoundsMax.y - origin.y) * invDirection.y;
+		const float tz1 = (node.BoundsMin.z - origin.z) * invDirection.z;
+		const float tz2 = (node.BoundsMax.z - origin.z) * invDirection.z;
+		const float tEnter = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), 0.0f));
+		const float tExit = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::max(tz1, tz2));
+		return (tEnter <= tExit && tEnter < tMax) ? tEnter : FLT_MAX;
+	}
+
+	// 点と箱の距離の2乗
+	inline float BoxDistance2(const BVHNode& node, const Vector3D& p)
+	{
+		const float dx = std::max(std::max(node.BoundsMin.x - p.x, p.x - node.BoundsMax.x), 0.0f);
+		const float dy = std::max(std::max(node.BoundsMin.y - p.y, p.y - node.BoundsMax.y), 0.0f);
+		const float dz = std::max(std::max(node.BoundsMin.z - p.z, p.z - node.BoundsMax.z), 0.0f);
+		return dx * dx + dy * dy + dz * dz;
+	}
+}
+
+bool TriangleMesh::LoadOBJ(const std::string& path)
+{
+	std::FILE* pFile = std::fopen(path.c_str(), "r");
+	if (pFile == nullptr)
+	{
+		return false;
+	}
+	Positions.clear();
+	Indices.clear();
+	char line[1024];
+	std::vector<uint32_t> face;
+	bool succeeded = true;
+	while (succeeded && std::fgets(line, sizeof(line), pFile) != nullptr)
+	{
+		if (line[0] == 'v' && line[1] == ' ')
+		{
+			Vector3D position;
+			succeeded = std::sscanf(line + 2, "%f %f %f", &position.x, &position.y, &position.z) == 3;
+			Positions.push_back(position);
+		}
+		else if (line[0] == 'f' && line[1] == ' ')
+		{
+			// "f 1 2 3"、"f 1/1/1 2/2/2 3/3/3" など (負の番号は末尾からの相対)
+			face.clear();
+			char* pToken = line + 2;
+			char* pEnd = nullptr;
+			for (long index = std::strtol(pToken, &pEnd, 10); pEnd != pToken; index = std::strtol(pToken, &pEnd, 10))
+			{
+				const long resolved = (index < 0) ? static_cast<long>(Positions.size()) + index : index - 1;
+				succeeded = succeeded && resolved >= 0 && resolved < static_cast<long>(Positions.size());
+				face.push_back(static_cast<uint32_t>(resolved));
+				pToken = pEnd;
+				while (*pToken != '\0' && *pToken != ' ' && *pToken != '\t')
+				{
+					++pToken;
+				}
+			}
+			for (size_t corner = 2; corner < face.size(); ++corner)
+			{
+				Indices.insert(Indices.end(), { face[0], face[corner - 1], face[corner] });
+			}
+		}
+	}
+	std::fclose(pFile);
+	return succeeded && !Indices.empty();
+}
+
+Vector3D ClosestPointOnTriangle(const Vector3D& p, const Vector3D& a, const Vector3D& b, const Vector3D& c)
+{
+	const Vector3D ab = b - a;
+	const Vector3D ac = c - a;
+	const Vector3D ap = p - a;
+	const float d1 = ab.dot(ap);
+	const float d2 = ac.dot(ap);
+	if (d1 <= 0.0f && d2 <= 0.0f)
+	{
+		return a;
+	}
+	const Vector3D bp = p - b;
+	const float d3 = ab.dot(bp);
+	const float d4 = ac.dot(bp);
+	if (d3 >= 0.0f && d4 <= d3)
+	{
+		return b;
+	}
+	const float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+	{
+		return a + ab * (d1 / (d1 - d3));
+	}
+	const Vector3D cp = p - c;
+	const float d5 = ab.dot(cp);
+	const float d6 = ac.dot(cp);
+	if (d6 >= 0.0f && d5 <= d6)
+	{
+		return c;
+	}
+	const float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+	{
+		return a + ac * (d2 / (d2 - d6));
+	}
+	const float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+	{
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+	}
+	const float denom = 1.0f / (va + vb + vc);
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+bool TriangleBVH::Build(const std::vector<Vector3D>& positions, const std::vector<uint32_t>& indices, const BVHBuildParam& param, ThreadPool& threadPool)
+{
+	auto totalStart = Clock::now();
+	m_Nodes.clear();
+	m_Triangles.clear();
+	m_TriangleIds.clear();
+	m_Stats = BVHBuildStats();
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	const uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+	if (triangleCount == 0 || std::any_of(indices.begin(), indices.end(), [&](uint32_t index) { return index >= vertexCount; }))
+	{
+		return false;
+	}
+	BVHBuildParam clampedParam = param;
+	clampedParam.BinCount = std::max(param.BinCount, 2u);
+	if (clampedParam.BinCount > BVHBuildParam::MaxBinCount)
+	{
+		clampedParam.BinCount = BVHBuildParam::MaxBinCount;
+	}
+	clampedParam.MaxLeafSize = std::max(param.MaxLeafSize, 1u);
+
+	BuildContext context;
+	context.pParam = &clampedParam;
+	context.Bounds.resize(triangleCount);
+	context.Centroids.resize(triangleCount);
+	context.Order.resize(triangleCount);
+	threadPool.ParallelFor(0, triangleCount, 4096, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t t = begin; t < end; ++t)
+		{
+			AABB bounds;
+			bounds.Grow(positions[indices[3 * t + 0]]);
+			bounds.Grow(positions[indices[3 * t + 1]]);
+			bounds.Grow(positions[indices[3 * t + 2]]);
+			context.Bounds[t] = bounds;
+			context.Centroids[t] = (bounds.Min + bounds.Max) * 0.5f;
+			context.Order[t] = t;
+		}
+	});
+
+	// 上の方のノードは1つずつビン分けを並列に行い、ParallelThreshold 以下になった部分木を集める
+	m_Nodes.reserve(2 * triangleCount);
+	m_Nodes.emplace_back();
+	SetBounds(m_Nodes[0], threadPool.ParallelReduce(triangleCount, AABB(),
+		[&](uint32_t t) { return context.Bounds[t]; },
+		[](AABB a, const AABB& b) { a.Grow(b); return a; }));
+	std::vector<BuildTask> largeTasks = { { 0, 0, triangleCount, 0 } };
+	std::vector<BuildTask> smallTasks;
+	std::unique_ptr<BinSet> pBins = std::make_unique<BinSet>();
+	while (!largeTasks.empty())
+	{
+		const BuildTask task = largeTasks.back();
+		largeTasks.pop_back();
+		if (task.Count <= clampedParam.ParallelThreshold)
+		{
+			smallTasks.push_back(task);
+			continue;
+		}
+		SplitResult split;
+		if (!SplitNode(context, task.First, task.Count, GetBounds(m_Nodes[task.Node]), task.Depth, &threadPool, *pBins, split))
+		{
+			m_Nodes[task.Node].LeftOrFirst = task.First;
+			m_Nodes[task.Node].TriangleCount = task.Count;
+			continue;
+		}
+		const uint32_t left = static_cast<uint32_t>(m_Nodes.size());
+		m_Nodes[task.Node].LeftOrFirst = left;
+		m_Nodes[task.Node].TriangleCount = 0;
+		m_Nodes.resize(left + 2);
+		SetBounds(m_Nodes[left], split.LeftBounds);
+		SetBounds(m_Nodes[left + 1], split.RightBounds);
+		largeTasks.push_back({ left, task.First, split.LeftCount, task.Depth + 1 });
+		largeTasks.push_back({ left + 1, task.First + split.LeftCount, task.Count - split.LeftCount, task.Depth + 1 });
+	}
+
+	// 部分木は三角形の範囲が重ならないので、大きいものから空いたスレッドが1つずつ取って別々の配列に作り、最後に繋げる
+	std::sort(smallTasks.begin(), smallTasks.end(), [](const BuildTask& a, const BuildTask& b) { return a.Count > b.Count; });
+	std::vector<std::vector<BVHNode>> subtrees(smallTasks.size());
+	threadPool.ParallelFor(0, static_cast<uint32_t>(smallTasks.size()), 1, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t s = begin; s < end; ++s)
+		{
+			std::vector<BVHNode>& nodes = subtrees[s];
+			nodes.reserve(2 * smallTasks[s].Count / clampedParam.MaxLeafSize + 1);
+			nodes.push_back(m_Nodes[smallTasks[s].Node]);
+			BuildTask root = smallTasks[s];
+			root.Node = 0;
+			BuildSubtree(context, nodes, root);
+		}
+	});
+	for (size_t s = 0; s < smallTasks.size(); ++s)
+	{
+		// 部分木の番号 i (>= 1) は m_Nodes の base + i - 1 に置く
+		const uint32_t base = static_cast<uint32_t>(m_Nodes.size());
+		std::vector<BVHNode>& nodes = subtrees[s];
+		for (BVHNode& node : nodes)
+		{
+			if (!node.IsLeaf())
+			{
+				node.LeftOrFirst = base + node.LeftOrFirst - 1;
+			}
+		}
+		m_Nodes[smallTasks[s].Node] = nodes[0];
+		m_Nodes.insert(m_Nodes.end(), nodes.begin() + 1, nodes.end());
+		std::vector<BVHNode>().swap(nodes);
+	}
+	m_Nodes.shrink_to_fit();
+
+	// 三角形を葉の順に並べ替える
+	m_TriangleIds = std::move(context.Order);
+	m_Triangles.resize(triangleCount);
+	threadPool.ParallelFor(0, triangleCount, 4096, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const uint32_t t = m_TriangleIds[i];
+			const Vector3D& v0 = positions[indices[3 * t + 0]];
+			m_Triangles[i].V0 = v0;
+			m_Triangles[i].Edge1 = positions[indices[3 * t + 1]] - v0;
+			m_Triangles[i].Edge2 = positions[indices[3 * t + 2]] - v0;
+		}
+	});
+
+	// 統計 (深さと、根の表面積に対する SAH のコスト)
+	m_Stats.TriangleCount = triangleCount;
+	m_Stats.NodeCount = static_cast<uint32_t>(m_Nodes.size());
+	const float rootArea = std::max(GetBounds(m_Nodes[0]).HalfArea(), FLT_MIN);
+	double cost = 0.0;
+	std::vector<std::pair<uint32_t, uint32_t>> stack = { { 0u, 0u } };
+	while (!stack.empty())
+	{
+		const auto [nodeIndex, depth] = stack.back();
+		stack.pop_back();
+		const BVHNode& node = m_Nodes[nodeIndex];
+		const double area = GetBounds(node).HalfArea() / rootArea;
+		m_Stats.MaxDepth = std::max(m_Stats.MaxDepth, depth);
+		if (node.IsLeaf())
+		{
+			++m_Stats.LeafCount;
+			cost += area * node.TriangleCount;
+			continue;
+		}
+		cost += area * clampedParam.TraversalCost;
+		stack.push_back({ node.LeftOrFirst, depth + 1 });
+		stack.push_back({ node.LeftOrFirst + 1, depth + 1 });
+	}
+	assert(m_Stats.MaxDepth < MaxStackDepth);
+	m_Stats.SAHCost = static_cast<float>(cost);
+	m_Stats.BuildMilliseconds = ElapsedMilliseconds(totalStart);
+	return true;
+}
+
+bool TriangleBVH::Raycast(const BVHRay& ray, BVHRayHit& hit) const
+{
+	hit = BVHRayHit();
+	if (m_Nodes.empty())
+	{
+		return false;
+	}
+	const Vector3D& origin = ray.Origin;
+	const Vector3D& direction = ray.Direction;
+	// 0 の成分は ±無限大になり、その軸の箱の判定は常に通る (原点が面上の場合を除く)
+	const Vector3D invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+	float tMax = ray.MaxDistance;
+	uint32_t hitIndex = UINT32_MAX;
+
+	uint32_t stack[MaxStackDepth];
+	uint32_t stackSize = 0;
+	uint32_t nodeIndex = 0;
+	if (IntersectBox(m_Nodes[0], origin, invDirection, tMax) == FLT_MAX)
+	{
+		return false;
+	}
+	for (;;)
+	{
+		const BVHNode& node = m_Nodes[nodeIndex];
+		if (node.IsLeaf())
+		{
+			// Moller-Trumbore (裏面も当たる)
+			for (uint32_t i = node.LeftOrFirst; i < node.LeftOrFirst + node.TriangleCount; ++i)
+			{
+				const Triangle& triangle = m_Triangles[i];
+				const Vector3D pvec = direction.cross(triangle.Edge2);
+				const float det = triangle.Edge1.dot(pvec);
+				if (std::abs(det) < 1e-12f)
+				{
+					continue;
+				}
+				const float invDet = 1.0f / det;
+				const Vector3D tvec = origin - triangle.V0;
+				const float u = tvec.dot(pvec) * invDet;
+				if (u < 0.0f || u > 1.0f)
+				{
+					continue;
+				}
+				const Vector3D qvec = tvec.cross(triangle.Edge1);
+				const float v = direction.dot(qvec) * invDet;
+				if (v < 0.0f || u + v > 1.0f)
+				{
+					continue;
+				}
+				const float t = triangle.Edge2.dot(qvec) * invDet;
+				if (t >= 0.0f && t < tMax)
+				{
+					tMax = t;
+					hitIndex = i;
+					hit.U = u;
+					hit.V = v;
+				}
+			}
+		}
+		else
+		{
+			// 近い方の子から辿り、遠い方は積んでおく
+			uint32_t nearChild = node.LeftOrFirst;
+			uint32_t farChild = node.LeftOrFirst + 1;
+			float nearDistance = IntersectBox(m_Nodes[nearChild], origin, invDirection, tMax);
+			float farDistance = IntersectBox(m_Nodes[farChild], origin, invDirection, tMax);
+			if (farDistance < nearDistance)
+			{
+				std::swap(nearChild, farChild);
+				std::swap(nearDistance, farDistance);
+			}
+			if (nearDistance != FLT_MAX)
+			{
+				if (farDistance != FLT_MAX)
+				{
+					stack[stackSize++] = farChild;
+				}
+				nodeIndex = nearChild;
+				continue;
+			}
+		}
+		// 積んだノードのうち、今の交点より手前で箱に入るものを取り出す
+		bool found = false;
+		while (stackSize > 0 && !found)
+		{
+			nodeIndex = stack[--stackSize];
+			found = IntersectBox(m_Nodes[nodeIndex], origin, invDirection, tMax) != FLT_MAX;
+		}
+		if (!found)
+		{
+			break;
+		}
+	}
+	if (hitIndex == UINT32_MAX)
+	{
+		return false;
+	}
+	hit.Distance = tMax;
+	hit.Triangle = m_TriangleIds[hitIndex];
+	return true;
+}
+
+bool TriangleBVH::FindClosestPoint(const Vector3D& position, float maxDistance, BVHClosestHit& hit) const
+{
+	hit = BVHClosestHit();
+	if (m_Nodes.empty())
+	{
+		return false;
+	}
+	float bestDistance2 = (maxDistance < FLT_MAX) ? maxDistance * maxDistance : FLT_MAX;
+	uint32_t hitIndex = UINT32_MAX;
+
+	uint32_t stack[MaxStackDepth];
+	uint32_t stackSize = 0;
+	uint32_t nodeIndex = 0;
+	if (BoxDistance2(m_Nodes[0], position) > bestDistance2)
+	{
+		return false;
+	}
+	for (;;)
+	{
+		const BVHNode& node = m_Nodes[nodeIndex];
+		if (node.IsLeaf())
+		{
+			for (uint32_t i = node.LeftOrFirst; i < node.LeftOrFirst + node.TriangleCount; ++i)
+			{
+				const Triangle& triangle = m_Triangles[i];
+				const Vector3D closest = ClosestPointOnTriangle(position, triangle.V0, triangle.V0 + triangle.Edge1, triangle.V0 + triangle.Edge2);
+				const Vector3D diff = position - closest;
+				const float distance2 = diff.dot(diff);
+				if (distance2 <= bestDistance2)
+				{
+					bestDistance2 = distance2;
+					hitIndex = i;
+					hit.Position = closest;
+				}
+			}
+		}
+		else
+		{
+			uint32_t nearChild = node.LeftOrFirst;
+			uint32_t farChild = node.LeftOrFirst + 1;
+			float nearDistance2 = BoxDistance2(m_Nodes[nearChild], position);
+			float farDistance2 = BoxDistance2(m_Nodes[farChild], position);
+			if (farDistance2 < nearDistance2)
+			{
+				std::swap(nearChild, farChild);
+				std::swap(nearDistance2, farDistance2);
+			}
+			if (nearDistance2 <= bestDistance2)
+			{
+				if (farDistance2 <= bestDistance2)
+				{
+					stack[stackSize++] = farChild;
+				}
+				nodeIndex = nearChild;
+				continue;
+			}
+		}
+		bool found = false;
+		while (stackSize > 0 && !found)
+		{
+			nodeIndex = stack[--stackSize];
+			found = BoxDistance2(m_Nodes[nodeIndex], position) <= bestDistance2;
+		}
+		if (!found)
+		{
+			break;
+		}
+	}
+	if (hitIndex == UINT32_MAX)
+	{
+		return false;
+	}
+	hit.Distance = std::sqrt(bestDistance2);
+	hit.Triangle = m_TriangleIds[hitIndex];
+	return true;
+}
+
+void TriangleBVH::RaycastBatch(const BVHRay* pRays, uint32_t count, BVHRayHit* pHits, ThreadPool& threadPool) const
+{
+	threadPool.ParallelFor(0, count, 256, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			Raycast(pRays[i], pHits[i]);
+		}
+	});
+}
+
+void TriangleBVH::FindClosestPointBatch(const Vector3D* pPositions, uint32_t count, float maxDistance, BVHClosestHit* pHits, ThreadPool& threadPool) const
+{
+	threadPool.ParallelFor(0, count, 256, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			FindClosestPoint(pPositions[i], maxDistance, pHits[i]);
+		}
+	});
+}
@@ -0,0 +1,1352 @@
+#include "pch.h"
+#include "Simulation/CPUFluidSolver.h"
+#include "Simulation/FluidScenario.h"
+#include "Simulation/Checkpoint.h"
+#include "Simulation/DistributedFluidSolver.h"
+#include "Simulation/ParticleExporter.h"
+#include "Simulation/Trajectory.h"
+#include "Simulation/TriangleBVH.h"
+#include "Simulation/SignedDistanceField.h"
+#include "Simulation/Anisotropy.h"
+#include "Simulation/SurfaceExtractor.h"
+#include "Simulation/ThreadPool.h"
+
+#include <array>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <thread>
+
+// CPUソルバーのテスト (ctest から名前を指定して1つずつ実行する)
+// 使い方: FluidTests <test>
+// 失敗した条件を出力し、1つでも失敗したら終了コード 1 を返す
+namespace TestInternal
+{
+	uint32_t g_FailureCount = 0;
+
+	// condition が false なら printf 形式のメッセージを出力して失敗を数える
+	bool Expect(bool condition, const char* format, ...)
+	{
+		if (!condition)
+		{
+			std::va_list args;
+			va_start(args, format);
+			std::printf("FAILED: ");
+			std::vprintf(format, args);
+			std::printf("\n");
+			va_end(args);
+			++g_FailureCount;
+		}
+		return condition;
+	}
+
+	// ダムブレイクの初期配置を steps ステップ進め、粒子をID順に取り出す
+	std::vector<Particle> RunDamBreak(CPUFluidSolver& solver, uint32_t particleCount, uint32_t steps)
+	{
+		SimulationParam param = FluidScenario::MakeDamBreakParam(particleCount);
+		solver.SetSimulationParam(param);
+		solver.SetParticles(FluidScenario::MakeDamBreakParticles(param, particleCount));
+		for (uint32_t step = 0; step < steps; ++step)
+		{
+			solver.Step();
+		}
+		std::vector<Particle> particles;
+		solver.CopyParticlesInIdOrder(particles);
+		return particles;
+	}
+
+	// 密度と力の差の最大値 (密度は静止密度、力は最大の力に対する比)
+	void CompareDensityAndForce(const std::vector<Particle>& expected, const std::vector<Particle>& actual, float restDensity,
+		double& densityError, double& forceError)
+	{
+		double maxForce = 0.0;
+		for (const Particle& p : expected)
+		{
+			maxForce = std::max(maxForce, static_cast<double>(p.Force.length()));
+		}
+		densityError = 0.0;
+		forceError = 0.0;
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			densityError = std::max(densityError, static_cast<double>(std::abs(expected[i].Density - actual[i].Density)) / restDensity);
+			forceError = std::max(forceError, static_cast<double>((expected[i].Force - actual[i].Force).length()) / std::max(maxForce, 1.0e-12));
+		}
+	}
+
+	// カウンティングソートと空間ハッシュのグリッドが、リンクリストと同じ近傍から同じ密度と力を求めること
+	// (総和の順番が違うので、丸め誤差の範囲で比べる)
+	void TestGridModes()
+	{
+		const uint32_t particleCount = 4000;
+		CPUFluidSolver reference(2);
+		reference.SetGridBuildMode(GridBuildMode::LinkedList);
+		std::vector<Particle> expected = RunDamBreak(reference, particleCount, 1);
+		const float restDensity = reference.GetSimulationParam().RestDensity;
+
+		const struct
+		{
+			const char* Name;
+			GridBuildMode Mode;
+		} modes[] =
+		{
+			{ "counting sort", GridBuildMode::CountingSort },
+			{ "spatial hash", GridBuildMode::SpatialHash },
+		};
+		for (const auto& mode : modes)
+		{
+			CPUFluidSolver solver(2);
+			solver.SetGridBuildMode(mode.Mode);
+			std::vector<Particle> actual = RunDamBreak(solver, particleCount, 1);
+			if (!Expect(actual.size() == expected.size(), "%s: %zu particles, expected %zu", mode.Name, actual.size(), expected.size()))
+			{
+				continue;
+			}
+			double densityError = 0.0;
+			double forceError = 0.0;
+			CompareDensityAndForce(expected, actual, restDensity, densityError, forceError);
+			Expect(densityError < 1.0e-5, "%s: density differs from the linked list by %g of rest density", mode.Name, densityError);
+			Expect(forceError < 1.0e-4, "%s: force differs from the linked list by %g of the largest force", mode.Name, forceError);
+		}
+	}
+
+	// カウンティングソートが必要な設定は、リンクリストのグリッドと組み合わせると設定の関数が false を返し、
+	// グリッドをカウンティングソートにすると使えるようになること
+	void TestGridCompatibility()
+	{
+		const struct
+		{
+			const char* Name;
+			std::function<bool(CPUFluidSolver&)> Enable;
+		} settings[] =
+		{
+			{ "SoA kernels", [](CPUFluidSolver& solver) { return solver.SetSoAKernelsEnabled(true); } },
+			{ "symmetric force", [](CPUFluidSolver& solver) { return solver.SetSymmetricForceEnabled(true); } },
+			{ "morton schedule", [](CPUFluidSolver& solver) { return solver.SetWorkSchedule(WorkSchedule::MortonPartition); } },
+			{ "NUMA placement", [](CPUFluidSolver& solver) { return solver.SetNumaPlacementEnabled(true); } },
+		};
+		for (const auto& setting : settings)
+		{
+			CPUFluidSolver solver(1);
+			solver.SetGridBuildMode(GridBuildMode::LinkedList);
+			Expect(!setting.Enable(solver), "%s: accepted with the linked list grid", setting.Name);
+			Expect(solver.GetGridBuildModeConflict() != nullptr, "%s: no conflict reported for the linked list grid", setting.Name);
+			Expect(!solver.SetGridBuildMode(GridBuildMode::SpatialHash), "%s: accepted with the spatial hash grid", setting.Name);
+			Expect(solver.SetGridBuildMode(GridBuildMode::CountingSort), "%s: rejected with the counting sort grid: %s", setting.Name,
+				solver.GetGridBuildModeConflict());
+		}
+	}
+
+	// SoAカーネル (スカラー / AVX2 / AVX-512) の密度と力が、AoSのスカラー走査と丸め誤差の範囲で一致すること
+	// CPUが対応していない命令セットは飛ばす
+	void TestSoAKernels()
+	{
+		const uint32_t particleCount = 4000;
+		CPUFluidSolver reference(2);
+		reference.SetGridBuildMode(GridBuildMode::CountingSort);
+		std::vector<Particle> expected = RunDamBreak(reference, particleCount, 1);
+		const float restDensity = reference.GetSimulationParam().RestDensity;
+
+		for (SIMDLevel level : { SIMDLevel::Scalar, SIMDLevel::AVX2, SIMDLevel::AVX512 })
+		{
+			CPUFluidSolver solver(2);
+			solver.SetGridBuildMode(GridBuildMode::CountingSort);
+			solver.SetSoAKernelsEnabled(true);
+			solver.SetSIMDLevel(level);
+			if (solver.GetSIMDLevel() != level)
+			{
+				std::printf("%s: not supported by this CPU, skipped\n", ToString(level));
+				continue;
+			}
+			std::vector<Particle> actual = RunDamBreak(solver, particleCount, 1);
+			if (!Expect(actual.size() == expected.size(), "%s: %zu particles, expected %zu", ToString(level), actual.size(), expected.size()))
+			{
+				continue;
+			}
+			double densityError = 0.0;
+			double forceError = 0.0;
+			CompareDensityAndForce(expected, actual, restDensity, densityError, forceError);
+			Expect(densityError < 1.0e-5, "%s: density differs from the AoS kernels by %g of rest density", ToString(level), densityError);
+			Expect(forceError < 1.0e-4, "%s: force differs from the AoS kernels by %g of the largest force", ToString(level), forceError);
+		}
+	}
+
+	// 対称な力の計算 (ペアを一度だけ評価して両方の粒子に書く) が、スレッド数に関係なく
+	// 全ての近傍を走査する通常の力の計算と丸め誤差の範囲で一致すること
+	void TestSymmetricForce()
+	{
+		const uint32_t particleCount = 4000;
+		CPUFluidSolver reference(2);
+		reference.SetGridBuildMode(GridBuildMode::CountingSort);
+		std::vector<Particle> expected = RunDamBreak(reference, particleCount, 1);
+		const float restDensity = reference.GetSimulationParam().RestDensity;
+
+		for (uint32_t threadCount : { 1u, 2u, 3u, 4u })
+		{
+			CPUFluidSolver solver(threadCount);
+			solver.SetGridBuildMode(GridBuildMode::CountingSort);
+			solver.SetSymmetricForceEnabled(true);
+			std::vector<Particle> actual = RunDamBreak(solver, particleCount, 1);
+			if (!Expect(actual.size() == expected.size(), "%u threads: %zu particles, expected %zu", threadCount, actual.size(), expected.size()))
+			{
+				continue;
+			}
+			double densityError = 0.0;
+			double forceError = 0.0;
+			CompareDensityAndForce(expected, actual, restDensity, densityError, forceError);
+			Expect(densityError < 1.0e-5, "%u threads: density differs from the full force pass by %g of rest density", threadCount, densityError);
+			Expect(forceError < 1.0e-4, "%u threads: symmetric force differs from the full force pass by %g of the largest force", threadCount, forceError);
+		}
+	}
+
+	// 適応時間刻みの dt が、ステップの最初の |v|max・|a|max から求めた CFL・力・粘性の条件と上下限をすべて満たし、
+	// 最も厳しい条件に一致すること。AdvanceFrame はフレームの時間を丁度進めること
+	void TestAdaptiveTimestep()
+	{
+		const uint32_t particleCount = 4000;
+		CPUFluidSolver solver(2);
+		SimulationParam param = FluidScenario::MakeDamBreakParam(particleCount);
+		solver.SetSimulationParam(param);
+		solver.SetParticles(FluidScenario::MakeDamBreakParticles(param, particleCount));
+		solver.SetAdaptiveTimestepEnabled(true);
+		const AdaptiveTimestepParam& timestepParam = solver.GetAdaptiveTimestepParam();
+		const float H = param.H;
+		const float tolerance = 1.0e-5f;
+
+		uint32_t limitCounts[static_cast<int>(TimestepLimit::Count)] = {};
+		for (uint32_t step = 0; step < 200; ++step)
+		{
+			solver.Step();
+			const TimestepStats& stats = solver.GetTimestepStats();
+			const float dt = stats.DeltaTime;
+			++limitCounts[static_cast<int>(stats.Limit)];
+			if (!Expect(std::isfinite(dt) && dt >= timestepParam.MinTimestep && dt <= timestepParam.MaxTimestep,
+				"step %u: dt %g outside [%g, %g]", step, dt, timestepParam.MinTimestep, timestepParam.MaxTimestep))
+			{
+				return;
+			}
+			// 条件の中で最も小さい値 (MinTimestep で下から抑えた場合はどの条件も破ってよい)
+			float bound = timestepParam.MaxTimestep;
+			if (stats.MaxSpeed > 0.0f)
+			{
+				bound = std::min(bound, timestepParam.CFLNumber * H / stats.MaxSpeed);
+			}
+			if (stats.MaxAcceleration > 0.0f)
+			{
+				bound = std::min(bound, timestepParam.ForceNumber * std::sqrt(H / stats.MaxAcceleration));
+			}
+			bound = std::min(bound, timestepParam.ViscosityNumber * H * H * param.RestDensity / param.Viscosity);
+			if (stats.Limit != TimestepLimit::MinTimestep)
+			{
+				Expect(dt <= bound * (1.0f + tolerance), "step %u: dt %g exceeds the CFL/force/viscosity bound %g", step, dt, bound);
+				Expect(dt >= bound * (1.0f - tolerance), "step %u: dt %g is smaller than the tightest bound %g", step, dt, bound);
+			}
+		}
+		// ダムブレイクでは崩れる途中に速度の条件が効く
+		Expect(limitCounts[static_cast<int>(TimestepLimit::CFL)] + limitCounts[static_cast<int>(TimestepLimit::Force)] > 0,
+			"no step was limited by the CFL or force condition");
+
+		const float frameTime = 1.0f / 60.0f;
+		for (uint32_t frame = 0; frame < 10; ++frame)
+		{
+			const double start = solver.GetSimulatedTime();
+			uint32_t substeps = solver.AdvanceFrame(frameTime);
+			const TimestepStats& stats = solver.GetTimestepStats();
+			Expect(substeps < timestepParam.MaxSubsteps, "frame %u: hit the substep limit", frame);
+			Expect(std::abs(stats.SimulatedTime - frameTime) <= frameTime * 1.0e-4f, "frame %u: advanced %g s, expected %g s", frame, stats.SimulatedTime, frameTime);
+			Expect(std::abs(solver.GetSimulatedTime() - start - frameTime) <= frameTime * 1.0e-4, "frame %u: simulated time advanced %g s", frame,
+				solver.GetSimulatedTime() - start);
+		}
+	}
+
+	// LocalHaloGroup のスレッドを rank にして領域分割したソルバーが、分割しない1つのソルバーと同じ粒子を同じ位置まで進めること
+	// (ゴーストの近傍の順番が違うので丸め誤差の範囲で比べる)
+	void TestDecomposition()
+	{
+		const uint32_t particleCount = 4000;
+		const uint32_t steps = 20;
+		// ダムブレイクは角に寄っていて粒子の無い rank ができるので、壁の範囲全体に並べた初期配置を使う
+		SimulationParam param = FluidScenario::MakeScaledParam(particleCount);
+		std::vector<Particle> particles;
+		{
+			CPUFluidSolver generator(1);
+			generator.SetSimulationParam(param);
+			generator.InitializeParticles(particleCount, 1);
+			generator.CopyParticlesInIdOrder(particles);
+		}
+		CPUFluidSolver reference(1);
+		reference.SetGridBuildMode(GridBuildMode::SpatialHash);
+		reference.SetSimulationParam(param);
+		reference.SetParticles(particles);
+		for (uint32_t step = 0; step < steps; ++step)
+		{
+			reference.Step();
+		}
+		std::vector<Particle> expected;
+		reference.CopyParticlesInIdOrder(expected);
+
+		const struct
+		{
+			uint32_t RankCount;
+			DecompositionMode Mode;
+			const char* Name;
+		} cases[] =
+		{
+			{ 2, DecompositionMode::Slab, "2 ranks, slab" },
+			{ 4, DecompositionMode::Brick, "4 ranks, brick" },
+		};
+		for (const auto& testCase : cases)
+		{
+			LocalHaloGroup group(testCase.RankCount);
+			std::vector<Particle> gathered;
+			std::vector<uint32_t> ownedCounts(testCase.RankCount, 0);
+			std::vector<uint32_t> ghostCounts(testCase.RankCount, 0);
+			std::vector<uint8_t> succeeded(testCase.RankCount, 1);
+			std::vector<std::thread> threads;
+			for (uint32_t rank = 0; rank < testCase.RankCount; ++rank)
+			{
+				threads.emplace_back([&, rank]()
+				{
+					DistributedFluidSolver solver(group.GetTransport(rank), 1);
+					solver.SetSimulationParam(param, testCase.Mode);
+					solver.SetParticles(particles);
+					for (uint32_t step = 0; step < steps; ++step)
+					{
+						if (!solver.Step())
+						{
+							succeeded[rank] = 0;
+						}
+						ghostCounts[rank] = std::max(ghostCounts[rank], solver.GetTimings().GhostCount);
+					}
+					ownedCounts[rank] = static_cast<uint32_t>(solver.GetOwnedParticles().size());
+					std::vector<Particle> result;
+					if (!solver.GatherParticles(result))
+					{
+						succeeded[rank] = 0;
+					}
+					if (rank == 0)
+					{
+						gathered = std::move(result);
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+			bool allSucceeded = true;
+			for (uint32_t rank = 0; rank < testCase.RankCount; ++rank)
+			{
+				allSucceeded &= Expect(succeeded[rank] != 0, "%s: rank %u failed to exchange", testCase.Name, rank);
+				Expect(ownedCounts[rank] > 0, "%s: rank %u owns no particles", testCase.Name, rank);
+				Expect(ghostCounts[rank] > 0, "%s: rank %u received no ghosts", testCase.Name, rank);
+			}
+			if (!allSucceeded || !Expect(gathered.size() == expected.size(), "%s: gathered %zu particles, expected %zu",
+				testCase.Name, gathered.size(), expected.size()))
+			{
+				continue;
+			}
+			double maxDifference = 0.0;
+			for (size_t i = 0; i < expected.size(); ++i)
+			{
+				maxDifference = std::max(maxDifference, static_cast<double>((gathered[i].Position - expected[i].Position).length()));
+			}
+			Expect(maxDifference < 1.0e-4 * param.H, "%s: positions differ from a single solver by %g H", testCase.Name, maxDifference / param.H);
+		}
+	}
+
+	// 決定的モードでは、グリッド (カウンティングソート / 空間ハッシュ)・スレッド数・割り当て方を変えても状態のハッシュが一致すること
+	void TestDeterminism()
+	{
+		const uint32_t particleCount = 4000;
+		const uint32_t steps = 20;
+		const struct
+		{
+			const char* Name;
+			GridBuildMode Mode;
+			WorkSchedule Schedule;
+		} configs[] =
+		{
+			{ "sorted dynamic", GridBuildMode::CountingSort, WorkSchedule::Dynamic },
+			{ "sorted static", GridBuildMode::CountingSort, WorkSchedule::Static },
+			{ "sorted morton", GridBuildMode::CountingSort, WorkSchedule::MortonPartition },
+			{ "hash dynamic", GridBuildMode::SpatialHash, WorkSchedule::Dynamic },
+		};
+		uint64_t expected = 0;
+		bool first = true;
+		for (const auto& config : configs)
+		{
+			for (uint32_t threadCount : { 1u, 2u, 3u })
+			{
+				CPUFluidSolver solver(threadCount);
+				solver.SetGridBuildMode(config.Mode);
+				solver.SetWorkSchedule(config.Schedule);
+				solver.SetDeterministicEnabled(true);
+				Expect(solver.IsGridBuildModeCompatible(), "%s: not compatible with deterministic mode", config.Name);
+				RunDamBreak(solver, particleCount, steps);
+				uint64_t hash = solver.ComputeStateHash();
+				if (first)
+				{
+					expected = hash;
+					first = false;
+				}
+				Expect(hash == expected, "%s, %u threads: state hash %016llx, expected %016llx", config.Name, threadCount,
+					static_cast<unsigned long long>(hash), static_cast<unsigned long long>(expected));
+			}
+		}
+
+		// グリッドを指定しない (既定のリンクリストの) 場合も、決定的モードにするとカウンティングソートになって一致すること
+		for (uint32_t threadCount : { 1u, 2u, 3u })
+		{
+			CPUFluidSolver solver(threadCount);
+			Expect(solver.SetDeterministicEnabled(true), "default grid: not compatible with deterministic mode: %s", solver.GetGridBuildModeConflict());
+			Expect(solver.GetGridBuildMode() == GridBuildMode::CountingSort, "default grid: deterministic mode kept the linked list");
+			RunDamBreak(solver, particleCount, steps);
+			uint64_t hash = solver.ComputeStateHash();
+			Expect(hash == expected, "default grid, %u threads: state hash %016llx, expected %016llx", threadCount,
+				static_cast<unsigned long long>(hash), static_cast<unsigned long long>(expected));
+		}
+		// NUMA配置 (セルの持ち分をスロットの持ち分に合わせる) でも一致すること
+		for (uint32_t threadCount : { 2u, 3u })
+		{
+			CPUFluidSolver solver(threadCount);
+			solver.SetGridBuildMode(GridBuildMode::CountingSort);
+			solver.SetNumaPlacementEnabled(true);
+			solver.SetDeterministicEnabled(true);
+			RunDamBreak(solver, particleCount, steps);
+			uint64_t hash = solver.ComputeStateHash();
+			Expect(hash == expected, "NUMA placement, %u threads: state hash %016llx, expected %016llx", threadCount,
+				static_cast<unsigned long long>(hash), static_cast<unsigned long long>(expected));
+		}
+		// 決定的モードの後からリンクリストを指定すると組み合わせられないと返すこと
+		CPUFluidSolver solver(1);
+		solver.SetDeterministicEnabled(true);
+		Expect(!solver.SetGridBuildMode(GridBuildMode::LinkedList), "linked list grid accepted in deterministic mode");
+	}
+
+	// テスト用の一時ファイルのパス
+	std::string TemporaryPath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	std::vector<char> ReadFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void WriteFile(const std::string& path, const std::vector<char>& bytes)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	// チェックポイントから再開すると、書き込んだ時点の状態と、そのまま進めた場合と同じ状態になること (決定的モード)
+	// IDが範囲外・重複しているファイルや途中で切れたファイルは開けないこと
+	void TestCheckpoint()
+	{
+		const uint32_t particleCount = 4000;
+		const std::string path = TemporaryPath("FluidTests_checkpoint.ckpt");
+
+		CPUFluidSolver original(2);
+		original.SetGridBuildMode(GridBuildMode::CountingSort);
+		original.SetDeterministicEnabled(true);
+		RunDamBreak(original, particleCount, 10);
+		const uint64_t savedHash = original.ComputeStateHash();
+		CheckpointSnapshot snapshot;
+		original.CaptureCheckpoint(snapshot);
+		if (!Expect(CheckpointWriter::Write(snapshot, path), "failed to write %s", path.c_str()))
+		{
+			return;
+		}
+		for (uint32_t step = 0; step < 10; ++step)
+		{
+			original.Step();
+		}
+		const uint64_t continuedHash = original.ComputeStateHash();
+
+		{
+			CheckpointFile file;
+			if (!Expect(file.Open(path), "failed to open %s", path.c_str()))
+			{
+				return;
+			}
+			// スレッド数を変えて再開する
+			CPUFluidSolver restored(3);
+			restored.SetGridBuildMode(GridBuildMode::CountingSort);
+			restored.SetDeterministicEnabled(true);
+			restored.RestoreCheckpoint(file);
+			Expect(restored.ComputeStateHash() == savedHash, "restored state hash %016llx, saved %016llx",
+				static_cast<unsigned long long>(restored.ComputeStateHash()), static_cast<unsigned long long>(savedHash));
+			for (uint32_t step = 0; step < 10; ++step)
+			{
+				restored.Step();
+			}
+			Expect(restored.ComputeStateHash() == continuedHash, "state hash after restart %016llx, without restart %016llx",
+				static_cast<unsigned long long>(restored.ComputeStateHash()), static_cast<unsigned long long>(continuedHash));
+		}
+
+		// 壊したファイルは Open で弾く
+		const std::vector<char> bytes = ReadFile(path);
+		CheckpointHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		const std::string corruptPath = TemporaryPath("FluidTests_corrupt.ckpt");
+		auto expectRejected = [&](const char* name, const std::vector<char>& corrupt)
+		{
+			WriteFile(corruptPath, corrupt);
+			CheckpointFile file;
+			Expect(!file.Open(corruptPath), "%s: checkpoint was accepted", name);
+		};
+		std::vector<char> corrupt = bytes;
+		uint32_t* pIds = reinterpret_cast<uint32_t*>(corrupt.data() + header.ParticleIdOffset);
+		pIds[5] = header.IdCount;
+		expectRejected("out-of-range ID", corrupt);
+		corrupt = bytes;
+		pIds = reinterpret_cast<uint32_t*>(corrupt.data() + header.ParticleIdOffset);
+		pIds[5] = pIds[6];
+		expectRejected("duplicate ID", corrupt);
+		expectRejected("truncated file", std::vector<char>(bytes.begin(), bytes.begin() + bytes.size() / 2));
+
+		std::filesystem::remove(path);
+		std::filesystem::remove(corruptPath);
+	}
+
+	// 軌跡ファイルに書いて読み戻した位置・速度が、量子化の刻みの半分以内に収まること
+	// キーフレームの間のフレームを順番と逆順に読み、差分を重ねても誤差が増えないことも確かめる
+	void TestTrajectory()
+	{
+		const uint32_t particleCount = 4000;
+		const uint32_t frameCount = 40;
+		const std::string path = TemporaryPath("FluidTests_trajectory.traj");
+		TrajectoryParam param;
+		param.KeyframeInterval = 8;
+		param.ChunkSize = 1000; // 複数のチャンクに分ける
+
+		CPUFluidSolver solver(2);
+		SimulationParam simParam = FluidScenario::MakeDamBreakParam(particleCount);
+		solver.SetSimulationParam(simParam);
+		solver.SetParticles(FluidScenario::MakeDamBreakParticles(simParam, particleCount));
+		std::vector<std::vector<Particle>> frames(frameCount);
+		{
+			TrajectoryWriter writer(2);
+			if (!Expect(writer.Open(path, simParam.WallMin, simParam.WallMax, param), "failed to open %s", path.c_str()))
+			{
+				return;
+			}
+			for (uint32_t frame = 0; frame < frameCount; ++frame)
+			{
+				solver.Step();
+				solver.CopyParticlesInIdOrder(frames[frame]);
+				Expect(writer.WriteFrame(frames[frame], solver.GetSimulatedTime()), "failed to write frame %u", frame);
+			}
+			Expect(writer.Close(), "failed to close %s", path.c_str());
+		}
+
+		// 刻みの半分 (float の丸めの分だけ余裕を持たせる)
+		const Vector3D extent = simParam.WallMax - simParam.WallMin;
+		const float positionScale = (1.0f + 2.0f * param.WallMargin) / static_cast<float>((1u << param.PositionBits) - 1);
+		const Vector3D positionBound = extent * (0.5f * positionScale * 1.001f) + Vector3D(1.0e-6f);
+		const float velocityBound = param.VelocityRange / static_cast<float>((1u << param.VelocityBits) - 1) * 1.001f + 1.0e-6f;
+
+		TrajectoryReader reader(2);
+		if (!Expect(reader.Open(path), "failed to open %s for reading", path.c_str()))
+		{
+			return;
+		}
+		Expect(reader.GetFrameCount() == frameCount, "%u frames, expected %u", reader.GetFrameCount(), frameCount);
+		std::vector<uint32_t> order;
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			order.push_back(frame);
+		}
+		for (uint32_t frame = frameCount; frame-- > 0;)
+		{
+			order.push_back(frame);
+		}
+		for (uint32_t frameIndex : order)
+		{
+			TrajectoryFrame frame;
+			if (!Expect(reader.ReadFrame(frameIndex, frame), "failed to read frame %u", frameIndex) ||
+				!Expect(frame.Positions.size() == frames[frameIndex].size(), "frame %u: %zu particles", frameIndex, frame.Positions.size()))
+			{
+				continue;
+			}
+			Vector3D positionError(0.0f);
+			float velocityError = 0.0f;
+			for (size_t i = 0; i < frame.Positions.size(); ++i)
+			{
+				const Particle& p = frames[frameIndex][i];
+				Vector3D d = frame.Positions[i] - p.Position;
+				positionError = Vector3D(std::max(positionError.x, std::abs(d.x)), std::max(positionError.y, std::abs(d.y)), std::max(positionError.z, std::abs(d.z)));
+				Vector3D v = frame.Velocities[i] - p.Velocity;
+				velocityError = std::max({ velocityError, std::abs(v.x), std::abs(v.y), std::abs(v.z) });
+			}
+			Expect(positionError.x <= positionBound.x && positionError.y <= positionBound.y && positionError.z <= positionBound.z,
+				"frame %u: position error (%g, %g, %g) exceeds (%g, %g, %g)", frameIndex,
+				positionError.x, positionError.y, positionError.z, positionBound.x, positionBound.y, positionBound.z);
+			Expect(velocityError <= velocityBound, "frame %u: velocity error %g exceeds %g", frameIndex, velocityError, velocityBound);
+		}
+		reader.Close();
+		std::filesystem::remove(path);
+	}
+
+	// 半径 1、管の半径 0.35 のトーラスを segments x sides の四角形 (三角形2つずつ) で作る (FluidBenchmark の bvh と同じ形)
+	TriangleMesh MakeTorusMesh(uint32_t segments, uint32_t sides)
+	{
+		const float twoPi = 6.28318530718f;
+		TriangleMesh mesh;
+		for (uint32_t i = 0; i < segments; ++i)
+		{
+			const float u = twoPi * i / segments;
+			for (uint32_t j = 0; j < sides; ++j)
+			{
+				const float v = twoPi * j / sides;
+				mesh.Positions.push_back(Vector3D((1.0f + 0.35f * std::cos(v)) * std::cos(u), 0.35f * std::sin(v), (1.0f + 0.35f * std::cos(v)) * std::sin(u)));
+			}
+		}
+		for (uint32_t i = 0; i < segments; ++i)
+		{
+			for (uint32_t j = 0; j < sides; ++j)
+			{
+				const uint32_t a = i * sides + j;
+				const uint32_t b = ((i + 1) % segments) * sides + j;
+				const uint32_t c = ((i + 1) % segments) * sides + (j + 1) % sides;
+				const uint32_t d = i * sides + (j + 1) % sides;
+				mesh.Indices.insert(mesh.Indices.end(), { a, b, c, a, c, d });
+			}
+		}
+		return mesh;
+	}
+
+	// 全ての三角形とのレイの交差 (Moller-Trumbore) の最も近い距離 (当たらない場合は FLT_MAX)
+	float RaycastBruteForce(const TriangleMesh& mesh, const BVHRay& ray)
+	{
+		float closest = FLT_MAX;
+		for (uint32_t triangle = 0; triangle < mesh.GetTriangleCount(); ++triangle)
+		{
+			const Vector3D& a = mesh.Positions[mesh.Indices[triangle * 3]];
+			Vector3D edge1 = mesh.Positions[mesh.Indices[triangle * 3 + 1]] - a;
+			Vector3D edge2 = mesh.Positions[mesh.Indices[triangle * 3 + 2]] - a;
+			Vector3D p = ray.Direction.cross(edge2);
+			float det = edge1.dot(p);
+			if (std::abs(det) < 1.0e-12f)
+			{
+				continue;
+			}
+			float invDet = 1.0f / det;
+			Vector3D t = ray.Origin - a;
+			float u = t.dot(p) * invDet;
+			Vector3D q = t.cross(edge1);
+			float v = ray.Direction.dot(q) * invDet;
+			float distance = edge2.dot(q) * invDet;
+			if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && distance >= 0.0f && distance <= ray.MaxDistance)
+			{
+				closest = std::min(closest, distance);
+			}
+		}
+		return closest;
+	}
+
+	// 全ての三角形の最近点までの最も近い距離
+	float ClosestDistanceBruteForce(const TriangleMesh& mesh, const Vector3D& position)
+	{
+		float closest = FLT_MAX;
+		for (uint32_t triangle = 0; triangle < mesh.GetTriangleCount(); ++triangle)
+		{
+			Vector3D point = ClosestPointOnTriangle(position, mesh.Positions[mesh.Indices[triangle * 3]],
+				mesh.Positions[mesh.Indices[triangle * 3 + 1]], mesh.Positions[mesh.Indices[triangle * 3 + 2]]);
+			closest = std::min(closest, (position - point).length());
+		}
+		return closest;
+	}
+
+	// 4byteの値を指定したバイト順で読む (ParticleExporter の書き方の逆)
+	float LoadFloat(const char* pSrc, bool bigEndian)
+	{
+		const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pSrc);
+		uint32_t bits = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			bits = (bits << 8) | pBytes[bigEndian ? i : 3 - i];
+		}
+		float value;
+		std::memcpy(&value, &bits, 4);
+		return value;
+	}
+
+	// 書き出したファイルを読み戻した粒子の属性 (位置・速度・密度・圧力の順に8つ)
+	using ExportedValues = std::vector<std::array<float, 8>>;
+
+	// レガシーVTK (ビッグエンディアン) の POINTS と POINT_DATA を読む
+	bool ReadExportedVTK(const std::string& text, uint32_t count, ExportedValues& values)
+	{
+		char header[64];
+		std::snprintf(header, sizeof(header), "\nPOINTS %u float\n", count);
+		size_t points = text.find(header);
+		size_t density = text.find("SCALARS density float 1\nLOOKUP_TABLE default\n");
+		size_t pressure = text.find("SCALARS pressure float 1\nLOOKUP_TABLE default\n");
+		size_t velocity = text.find("VECTORS velocity float\n");
+		if (points == std::string::npos || density == std::string::npos || pressure == std::string::npos || velocity == std::string::npos)
+		{
+			return false;
+		}
+		points += std::strlen(header);
+		density += std::strlen("SCALARS density float 1\nLOOKUP_TABLE default\n");
+		pressure += std::strlen("SCALARS pressure float 1\nLOOKUP_TABLE default\n");
+		velocity += std::strlen("VECTORS velocity float\n");
+		if (std::max({ points + 12 * count, density + 4 * count, pressure + 4 * count, velocity + 12 * count }) > text.size())
+		{
+			return false;
+		}
+		values.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				values[i][axis] = LoadFloat(&text[points + 12 * i + 4 * axis], true);
+				values[i][3 + axis] = LoadFloat(&text[velocity + 12 * i + 4 * axis], true);
+			}
+			values[i][6] = LoadFloat(&text[density + 4 * i], true);
+			values[i][7] = LoadFloat(&text[pressure + 4 * i], true);
+		}
+		return true;
+	}
+
+	// バイナリPLY (リトルエンディアン、頂点毎に x y z vx vy vz density pressure) を読む
+	bool ReadExportedPLY(const std::string& text, uint32_t count, ExportedValues& values)
+	{
+		char element[64];
+		std::snprintf(element, sizeof(element), "element vertex %u\n", count);
+		size_t body = text.find("end_header\n");
+		if (text.find(element) == std::string::npos || body == std::string::npos)
+		{
+			return false;
+		}
+		body += std::strlen("end_header\n");
+		if (body + 32 * static_cast<size_t>(count) != text.size())
+		{
+			return false;
+		}
+		values.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			for (int value = 0; value < 8; ++value)
+			{
+				values[i][value] = LoadFloat(&text[body + 32 * i + 4 * value], false);
+			}
+		}
+		return true;
+	}
+
+	// CSV (見出し行 + 1行1粒子) を読む
+	bool ReadExportedCSV(const std::string& text, uint32_t count, ExportedValues& values)
+	{
+		std::istringstream stream(text);
+		std::string line;
+		if (!std::getline(stream, line) || line != "x,y,z,vx,vy,vz,density,pressure")
+		{
+			return false;
+		}
+		values.clear();
+		while (std::getline(stream, line))
+		{
+			std::array<float, 8> row;
+			const char* pText = line.c_str();
+			for (int value = 0; value < 8; ++value)
+			{
+				char* pEnd = nullptr;
+				row[value] = std::strtof(pText, &pEnd);
+				if (pEnd == pText || *pEnd != (value < 7 ? ',' : '\0'))
+				{
+					return false;
+				}
+				pText = pEnd + 1;
+			}
+			values.push_back(row);
+		}
+		return values.size() == count;
+	}
+
+	// 3つの形式で書き出したファイルを読み戻すと、ID順の粒子の位置・速度・密度・圧力と同じ値になること
+	// (バイナリはビット単位、CSVは最短で元に戻る桁数なので読み戻した float が一致する)
+	void TestExporter()
+	{
+		CPUFluidSolver solver(2);
+		std::vector<Particle> particles = RunDamBreak(solver, 3000, 5);
+		const uint32_t particleCount = static_cast<uint32_t>(particles.size());
+		const std::string prefix = TemporaryPath("FluidTestsExport/frame");
+
+		const struct
+		{
+			ExportFormat Format;
+			const char* Name;
+			bool (*Read)(const std::string&, uint32_t, ExportedValues&);
+		} formats[] =
+		{
+			{ ExportFormat::VTK, "VTK", ReadExportedVTK },
+			{ ExportFormat::PLY, "PLY", ReadExportedPLY },
+			{ ExportFormat::CSV, "CSV", ReadExportedCSV },
+		};
+		for (const auto& format : formats)
+		{
+			ExportParam param;
+			param.Format = format.Format;
+			ParticleExporter exporter;
+			if (!Expect(exporter.Open(prefix, param), "%s: failed to open %s", format.Name, prefix.c_str()))
+			{
+				continue;
+			}
+			const uint64_t frame = 7;
+			Expect(exporter.Submit(solver, frame), "%s: frame dropped with a free buffer", format.Name);
+			exporter.Flush();
+			ExportStats stats = exporter.GetStats();
+			const std::string path = exporter.GetFramePath(frame);
+			exporter.Close();
+			Expect(stats.WrittenFrames == 1 && stats.FailedFrames == 0, "%s: %u frames written, %u failed", format.Name, stats.WrittenFrames, stats.FailedFrames);
+
+			const std::vector<char> bytes = ReadFile(path);
+			Expect(bytes.size() == stats.WrittenBytes, "%s: file has %zu bytes, %llu reported", format.Name, bytes.size(),
+				static_cast<unsigned long long>(stats.WrittenBytes));
+			ExportedValues values;
+			if (!Expect(format.Read(std::string(bytes.begin(), bytes.end()), particleCount, values), "%s: could not read %s back", format.Name, path.c_str()))
+			{
+				continue;
+			}
+			uint32_t mismatchCount = 0;
+			for (uint32_t i = 0; i < particleCount; ++i)
+			{
+				const Particle& p = particles[i];
+				const float expected[8] = { p.Position.x, p.Position.y, p.Position.z, p.Velocity.x, p.Velocity.y, p.Velocity.z, p.Density, p.Pressure };
+				mismatchCount += std::memcmp(expected, values[i].data(), sizeof(expected)) != 0 ? 1 : 0;
+			}
+			Expect(mismatchCount == 0, "%s: %u of %u particles read back with different values", format.Name, mismatchCount, particleCount);
+		}
+		std::error_code error;
+		std::filesystem::remove_all(std::filesystem::path(prefix).parent_path(), error);
+	}
+
+	// BVH のレイと最近点の問い合わせ (1つずつとまとめて) が、全ての三角形を調べた場合と同じ距離を返すこと
+	// 上の方のノードの並列なビン分けも通るよう、並列化の閾値を下げて作る
+	void TestBVH()
+	{
+		const TriangleMesh mesh = MakeTorusMesh(64, 32);
+		ThreadPool threadPool(2);
+		BVHBuildParam param;
+		param.ParallelThreshold = 512;
+		TriangleBVH bvh;
+		if (!Expect(bvh.Build(mesh, param, threadPool), "failed to build the BVH"))
+		{
+			return;
+		}
+
+		const uint32_t queryCount = 500;
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> distribution(-1.5f, 1.5f);
+		std::vector<BVHRay> rays(queryCount);
+		std::vector<Vector3D> positions(queryCount);
+		for (uint32_t i = 0; i < queryCount; ++i)
+		{
+			rays[i].Origin = Vector3D(distribution(random), distribution(random), distribution(random));
+			rays[i].Direction = Vector3D(distribution(random), distribution(random), distribution(random));
+			// 半分のレイは距離を限る
+			if (i % 2 == 1)
+			{
+				rays[i].MaxDistance = 0.5f;
+			}
+			positions[i] = Vector3D(distribution(random), distribution(random), distribution(random));
+		}
+		std::vector<BVHRayHit> rayHits(queryCount);
+		bvh.RaycastBatch(rays.data(), queryCount, rayHits.data(), threadPool);
+		// 範囲を限った最近点は、約半分の点が範囲内に三角形を持つ距離にする
+		const float maxDistance = 0.25f;
+		std::vector<BVHClosestHit> closestHits(queryCount);
+		bvh.FindClosestPointBatch(positions.data(), queryCount, maxDistance, closestHits.data(), threadPool);
+
+		uint32_t rayHitCount = 0;
+		uint32_t closestHitCount = 0;
+		for (uint32_t i = 0; i < queryCount; ++i)
+		{
+			const float expectedRay = RaycastBruteForce(mesh, rays[i]);
+			BVHRayHit hit;
+			bvh.Raycast(rays[i], hit);
+			if (Expect(hit.IsHit() == (expectedRay != FLT_MAX), "ray %u: hit %d, brute force %d", i, hit.IsHit(), expectedRay != FLT_MAX) && hit.IsHit())
+			{
+				++rayHitCount;
+				Expect(std::abs(hit.Distance - expectedRay) <= 1.0e-4f * std::max(1.0f, expectedRay), "ray %u: distance %g, brute force %g", i, hit.Distance, expectedRay);
+			}
+			Expect(rayHits[i].Triangle == hit.Triangle && rayHits[i].Distance == hit.Distance, "ray %u: batch result differs", i);
+
+			const float expectedDistance = ClosestDistanceBruteForce(mesh, positions[i]);
+			BVHClosestHit closest;
+			bvh.FindClosestPoint(positions[i], FLT_MAX, closest);
+			Expect(std::abs(closest.Distance - expectedDistance) <= 1.0e-5f, "point %u: closest distance %g, brute force %g", i, closest.Distance, expectedDistance);
+			Expect(std::abs((positions[i] - closest.Position).length() - closest.Distance) <= 1.0e-5f, "point %u: closest point is not at the reported distance", i);
+			// 範囲の境界ちょうどの点は丸めでどちらにもなるので比べない
+			if (std::abs(expectedDistance - maxDistance) > 1.0e-5f)
+			{
+				bool expectedHit = expectedDistance < maxDistance;
+				if (Expect(closestHits[i].IsHit() == expectedHit, "point %u: hit within %g is %d, brute force distance %g", i, maxDistance, closestHits[i].IsHit(), expectedDistance) && expectedHit)
+				{
+					++closestHitCount;
+					Expect(std::abs(closestHits[i].Distance - expectedDistance) <= 1.0e-5f, "point %u: batch closest distance %g, brute force %g", i, closestHits[i].Distance, expectedDistance);
+				}
+			}
+		}
+		// 当たる場合と当たらない場合の両方を調べていること
+		Expect(rayHitCount > queryCount / 10 && rayHitCount < queryCount * 9 / 10, "only %u of %u rays hit", rayHitCount, queryCount);
+		Expect(closestHitCount > queryCount / 10 && closestHitCount < queryCount * 9 / 10, "only %u of %u points are within %g", closestHitCount, queryCount, maxDistance);
+	}
+
+	// 中心が原点、y軸周りの半径 1、管の半径 0.35 のトーラスの符号付き距離
+	float TorusDistance(const Vector3D& p)
+	{
+		const float ring = std::sqrt(p.x * p.x + p.z * p.z) - 1.0f;
+		return std::sqrt(ring * ring + p.y * p.y) - 0.35f;
+	}
+
+	// トーラスのメッシュから焼き込んだ SDF が、帯の中では解析的な距離に近く、帯の外でも内外の符号が合うこと
+	// キャッシュはメッシュ・パスが同じ場合だけ読み込み、頂点を変えた場合と別のディレクトリのモデルは焼き直すこと
+	void TestSDF()
+	{
+		TriangleMesh mesh = MakeTorusMesh(64, 32);
+		ThreadPool threadPool(2);
+		SDFBakeParam param;
+		param.CellSize = 0.05f;
+		SignedDistanceField field;
+		if (!Expect(field.Bake(mesh.Positions, mesh.Indices, param, threadPool), "failed to bake the torus"))
+		{
+			return;
+		}
+		const float band = field.GetBandDistance();
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> distribution(-1.5f, 1.5f);
+		uint32_t bandCount = 0;
+		for (uint32_t i = 0; i < 2000; ++i)
+		{
+			const Vector3D position(distribution(random), distribution(random) * 0.4f, distribution(random));
+			const float expected = TorusDistance(position);
+			const float actual = field.Sample(position);
+			if (std::abs(expected) < band - param.CellSize)
+			{
+				// メッシュの折れ線の近似と3重線形補間の誤差
+				Expect(std::abs(actual - expected) < 0.01f, "(%g, %g, %g): distance %g, expected %g", position.x, position.y, position.z, actual, expected);
+				++bandCount;
+			}
+			else if (std::abs(expected) > band + param.CellSize)
+			{
+				Expect((actual < 0.0f) == (expected < 0.0f), "(%g, %g, %g): sign of %g does not match %g", position.x, position.y, position.z, actual, expected);
+			}
+		}
+		Expect(bandCount > 100, "only %u samples in the band", bandCount);
+
+		const std::filesystem::path cacheDirectory = TemporaryPath("FluidTestsSDFCache");
+		std::error_code error;
+		std::filesystem::remove_all(cacheDirectory, error);
+		const std::string pathA = (std::filesystem::path("modelsA") / "torus.gltf").string();
+		const std::string pathB = (std::filesystem::path("modelsB") / "torus.gltf").string();
+		auto bakeCached = [&](const std::string& sourcePath, const TriangleMesh& source)
+		{
+			SignedDistanceField cached;
+			Expect(cached.BakeCached(sourcePath, cacheDirectory.string(), source.Positions, source.Indices, param, threadPool), "%s: failed to bake", sourcePath.c_str());
+			return cached.GetStats().FromCache;
+		};
+		Expect(!bakeCached(pathA, mesh), "first bake was read from an empty cache");
+		Expect(bakeCached(pathA, mesh), "second bake of the same mesh was not read from the cache");
+		Expect(!bakeCached(pathB, mesh), "a model in another directory shared the cache");
+		// .gltf の .bin だけを変えた場合と同じく、パスが同じでも頂点が変われば焼き直す
+		TriangleMesh moved = mesh;
+		moved.Positions[0].y += 0.01f;
+		Expect(!bakeCached(pathA, moved), "an edited mesh was read from the stale cache");
+		std::filesystem::remove_all(cacheDirectory, error);
+	}
+
+	// 境界粒子 (Akinci) の壁では、床に接する粒子の密度がペナルティの壁のように欠けないこと
+	// 縮小して置いたトーラスの障害物にダムブレイクを流すと、粒子が壁の範囲と障害物の中に入らず、床の層の密度が静止密度付近に落ち着くこと
+	void TestBoundaryParticles()
+	{
+		const uint32_t particleCount = 4000;
+		const SimulationParam initialParam = FluidScenario::MakeDamBreakParam(particleCount);
+		const float spacing = initialParam.H * 0.5f;
+		const std::vector<Particle> initial = FluidScenario::MakeDamBreakParticles(initialParam, particleCount);
+		Vector3D columnMax = initialParam.WallMin;
+		for (const Particle& particle : initial)
+		{
+			columnMax = Vector3D(std::max(columnMax.x, particle.Position.x), std::max(columnMax.y, particle.Position.y), std::max(columnMax.z, particle.Position.z));
+		}
+
+		// 1ステップ目の密度 (積分の前の初期位置から求める) を、水柱の床の層と内部で比べる (水柱の自由表面から H 以上離れた粒子だけを使う)
+		double bottomRatio[2] = {};
+		for (BoundaryMode mode : { BoundaryMode::Penalty, BoundaryMode::Particles })
+		{
+			CPUFluidSolver solver(2);
+			solver.SetBoundaryMode(mode);
+			std::vector<Particle> particles = RunDamBreak(solver, particleCount, 1);
+			const SimulationParam& param = solver.GetSimulationParam();
+			double bottomSum = 0.0;
+			double interiorSum = 0.0;
+			uint32_t bottomCount = 0;
+			uint32_t interiorCount = 0;
+			for (size_t i = 0; i < particles.size(); ++i)
+			{
+				const Vector3D& position = initial[i].Position;
+				if (position.x > columnMax.x - param.H || position.y > columnMax.y - param.H || position.z > columnMax.z - param.H)
+				{
+					continue;
+				}
+				if (position.y < param.WallMin.y + spacing)
+				{
+					bottomSum += particles[i].Density;
+					++bottomCount;
+				}
+				else if (position.x > param.WallMin.x + param.H && position.y > param.WallMin.y + param.H && position.z > param.WallMin.z + param.H)
+				{
+					interiorSum += particles[i].Density;
+					++interiorCount;
+				}
+			}
+			if (!Expect(bottomCount > 0 && interiorCount > 0, "no bottom (%u) or interior (%u) particles", bottomCount, interiorCount))
+			{
+				return;
+			}
+			bottomRatio[static_cast<int>(mode)] = (bottomSum / bottomCount) / (interiorSum / interiorCount);
+		}
+		// 1層の境界粒子の Ψ = ρ0 / ΣW は、H / 2 の間隔の Poly6 では欠けた半分の流体より約12%多く足す (平面の格子の総和から見積もった値)
+		// ペナルティの壁は約20%欠ける
+		const double particlesRatio = bottomRatio[static_cast<int>(BoundaryMode::Particles)];
+		const double penaltyRatio = bottomRatio[static_cast<int>(BoundaryMode::Penalty)];
+		Expect(particlesRatio > 1.0 && particlesRatio < 1.2, "boundary particles: floor density is %g of the interior", particlesRatio);
+		Expect(penaltyRatio < 0.9, "penalty walls: floor density is %g of the interior, expected the kernel to be cut off", penaltyRatio);
+
+		// 半径 0.4・管の半径 0.14 に縮小したトーラスを、水柱の外の床の近くに寝かせて置く
+		TriangleMesh mesh = MakeTorusMesh(64, 32);
+		ThreadPool threadPool(2);
+		SDFBakeParam bakeParam;
+		bakeParam.CellSize = 0.05f;
+		SignedDistanceField field;
+		if (!Expect(field.Bake(mesh.Positions, mesh.Indices, bakeParam, threadPool), "failed to bake the torus"))
+		{
+			return;
+		}
+		const float scale = 0.4f;
+		const Vector3D torusCenter(0.5f, 0.3f, 0.3f);
+		CPUFluidSolver solver(2);
+		solver.SetBoundaryMode(BoundaryMode::Particles);
+		solver.SetColliders({ SDFCollider(&field, Matrix4x4::ScalingToMatrix(Vector3D(scale)) * Matrix4x4::TransitionToMatrix(torusCenter)) });
+		std::vector<Particle> particles = RunDamBreak(solver, particleCount, 300);
+		const SimulationParam& param = solver.GetSimulationParam();
+		const BoundaryParticleStats& stats = solver.GetBoundaryParticles().GetStats();
+		Expect(stats.WallParticleCount > 0 && stats.ColliderParticleCount > 0, "%u wall and %u collider boundary particles",
+			stats.WallParticleCount, stats.ColliderParticleCount);
+		Expect(stats.MinPsi > 0.0f && stats.MaxPsi < param.RestDensity * std::pow(stats.Spacing, 3.0f) * 4.0f, "boundary Psi %g..%g", stats.MinPsi, stats.MaxPsi);
+
+		uint32_t outsideCount = 0;
+		uint32_t insideColliderCount = 0;
+		float maxDensity = 0.0f;
+		float minTorusDistance = std::numeric_limits<float>::max();
+		double floorSum = 0.0;
+		uint32_t floorCount = 0;
+		for (const Particle& particle : particles)
+		{
+			const Vector3D& position = particle.Position;
+			const bool insideWalls = std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z) &&
+				position.x >= param.WallMin.x && position.y >= param.WallMin.y && position.z >= param.WallMin.z &&
+				position.x <= param.WallMax.x && position.y <= param.WallMax.y && position.z <= param.WallMax.z;
+			outsideCount += insideWalls ? 0 : 1;
+			const float torusDistance = TorusDistance((position - torusCenter) * (1.0f / scale)) * scale;
+			minTorusDistance = std::min(minTorusDistance, torusDistance);
+			insideColliderCount += torusDistance < 0.0f ? 1 : 0;
+			maxDensity = std::max(maxDensity, particle.Density);
+			if (position.y < param.WallMin.y + spacing)
+			{
+				floorSum += particle.Density;
+				++floorCount;
+			}
+		}
+		Expect(outsideCount == 0, "%u particles left the walls", outsideCount);
+		Expect(insideColliderCount == 0, "%u particles inside the torus (deepest %g)", insideColliderCount, -minTorusDistance);
+		Expect(minTorusDistance < param.H, "no particle reached the torus, closest at %g", minTorusDistance);
+		// 流れが落ち着いた後の床の層は、境界粒子の分の密度を圧力で押し返して静止密度付近になる (積み重ならない)
+		if (Expect(floorCount > 0, "no particles on the floor"))
+		{
+			const double floorDensity = floorSum / floorCount / param.RestDensity;
+			Expect(std::abs(floorDensity - 1.0) < 0.1, "floor layer density is %g of rest density", floorDensity);
+		}
+		Expect(maxDensity < 1.1f * param.RestDensity, "densest particle at %g of rest density", maxDensity / param.RestDensity);
+	}
+
+	// center を中心とする半径 radius の球の中に、ダムブレイクと同じ間隔 H / 2 の格子状に静止密度の粒子を並べる
+	std::vector<Particle> MakeBallParticles(const SimulationParam& param, const Vector3D& center, float radius)
+	{
+		const float spacing = param.H * 0.5f;
+		const int count = static_cast<int>(radius / spacing);
+		std::vector<Particle> particles;
+		for (int z = -count; z <= count; ++z)
+		{
+			for (int y = -count; y <= count; ++y)
+			{
+				for (int x = -count; x <= count; ++x)
+				{
+					Vector3D offset = Vector3D(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) * spacing;
+					if (offset.length() <= radius)
+					{
+						Particle particle = {};
+						particle.Position = center + offset;
+						particle.Density = param.RestDensity;
+						particles.push_back(particle);
+					}
+				}
+			}
+		}
+		return particles;
+	}
+
+	// 球状に並べた粒子から抽出した表面が、穴も重なりもない閉じた向き付け可能な面 (全ての辺を逆向きの2つの三角形が共有する) で、
+	// オイラー標数が2 (球面と同じ) になり、頂点が球の表面付近にあって外向きに囲むこと。ブロックの境界をまたぐよう、球は複数のブロックに掛ける
+	void TestSurfaceExtraction()
+	{
+		SimulationParam param = FluidScenario::MakeDamBreakParam(20000);
+		const Vector3D center(0.1f, 1.3f, -0.2f);
+		const float radius = 8.0f * param.H * 0.5f;
+		std::vector<Particle> particles = MakeBallParticles(param, center, radius);
+
+		for (uint32_t threadCount : { 1u, 4u })
+		{
+			SurfaceExtractor extractor(threadCount);
+			SurfaceMesh mesh;
+			if (!Expect(extractor.Extract(particles, param, mesh), "%u threads: extraction failed", threadCount))
+			{
+				continue;
+			}
+			const SurfaceStats& stats = extractor.GetStats();
+			const uint32_t vertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+			const uint32_t triangleCount = static_cast<uint32_t>(mesh.Indices.size() / 3);
+			if (!Expect(triangleCount > 0 && mesh.Indices.size() % 3 == 0, "%u threads: %zu indices", threadCount, mesh.Indices.size()) ||
+				!Expect(stats.VertexCount == vertexCount && stats.TriangleCount == triangleCount, "%u threads: stats report %u vertices, %u triangles",
+					threadCount, stats.VertexCount, stats.TriangleCount))
+			{
+				continue;
+			}
+
+			// 向きの付いた辺 (始点 << 32 | 終点) 毎の使われた回数
+			std::unordered_map<uint64_t, uint32_t> edgeCounts;
+			uint32_t degenerateCount = 0;
+			double signedVolume = 0.0;
+			for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+			{
+				const uint32_t* pIndices = &mesh.Indices[triangle * 3];
+				if (pIndices[0] == pIndices[1] || pIndices[1] == pIndices[2] || pIndices[2] == pIndices[0] ||
+					std::max({ pIndices[0], pIndices[1], pIndices[2] }) >= vertexCount)
+				{
+					++degenerateCount;
+					continue;
+				}
+				for (int corner = 0; corner < 3; ++corner)
+				{
+					++edgeCounts[(static_cast<uint64_t>(pIndices[corner]) << 32) | pIndices[(corner + 1) % 3]];
+				}
+				const Vector3D p0 = mesh.Vertices[pIndices[0]].m_Position - center;
+				const Vector3D p1 = mesh.Vertices[pIndices[1]].m_Position - center;
+				const Vector3D p2 = mesh.Vertices[pIndices[2]].m_Position - center;
+				signedVolume += p0.dot(p1.cross(p2)) / 6.0;
+			}
+			Expect(degenerateCount == 0, "%u threads: %u triangles repeat a vertex or index out of range", threadCount, degenerateCount);
+
+			uint32_t openEdgeCount = 0;
+			for (const auto& edge : edgeCounts)
+			{
+				const uint64_t reverse = (edge.first << 32) | (edge.first >> 32);
+				auto found = edgeCounts.find(reverse);
+				if (edge.second != 1 || found == edgeCounts.end() || found->second != 1)
+				{
+					++openEdgeCount;
+				}
+			}
+			Expect(openEdgeCount == 0, "%u threads: %u of %zu directed edges are not shared by exactly one opposite triangle",
+				threadCount, openEdgeCount, edgeCounts.size());
+			const int64_t eulerCharacteristic = static_cast<int64_t>(vertexCount) - static_cast<int64_t>(edgeCounts.size() / 2) + triangleCount;
+			Expect(eulerCharacteristic == 2, "%u threads: Euler characteristic %lld, expected 2 for a sphere", threadCount,
+				static_cast<long long>(eulerCharacteristic));
+
+			// 等値面は一番外の粒子の付近 (粒子間隔 H / 2 の範囲) を通る
+			float minDistance = std::numeric_limits<float>::max();
+			float maxDistance = 0.0f;
+			for (const Vertex& vertex : mesh.Vertices)
+			{
+				const float distance = (vertex.m_Position - center).length();
+				minDistance = std::min(minDistance, distance);
+				maxDistance = std::max(maxDistance, distance);
+			}
+			Expect(minDistance > radius - 0.5f * param.H && maxDistance < radius + 0.5f * param.H, "%u threads: vertices at %g..%g from the center, ball radius %g",
+				threadCount, minDistance, maxDistance, radius);
+			const double ballVolume = 4.0 / 3.0 * 3.14159265358979 * std::pow(radius, 3.0);
+			Expect(signedVolume > 0.8 * ballVolume && signedVolume < 1.2 * ballVolume, "%u threads: enclosed volume %g (ball %g), wrong winding or size",
+				threadCount, signedVolume, ballVolume);
+		}
+	}
+
+	// 静止した直方体の水の粒子の楕円体のカーネルが、内部ではほぼ等方、上の水面では法線 (y) 方向に薄く面に沿って広くなり、
+	// 離れた1粒子は IsolatedScale の等方になること。主軸は正規直交で、半径の比は MaxStretch まで、積は1に正規化される
+	// 固有分解の命令セットを変えても半径は丸め誤差の範囲で一致する (CPUが対応していない命令セットはより狭い実装になる)
+	void TestAnisotropy()
+	{
+		SimulationParam param = FluidScenario::MakeDamBreakParam(20000);
+		const float spacing = param.H * 0.5f;
+		const uint32_t countX = 24;
+		const uint32_t countY = 10;
+		const uint32_t countZ = 24;
+		const Vector3D origin(-1.0f, 0.5f, -1.0f);
+		std::vector<Particle> particles;
+		for (uint32_t z = 0; z < countZ; ++z)
+		{
+			for (uint32_t y = 0; y < countY; ++y)
+			{
+				for (uint32_t x = 0; x < countX; ++x)
+				{
+					Particle particle = {};
+					particle.Position = origin + Vector3D(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) * spacing;
+					particle.Density = param.RestDensity;
+					particles.push_back(particle);
+				}
+			}
+		}
+		auto indexOf = [&](uint32_t x, uint32_t y, uint32_t z) { return (z * countY + y) * countX + x; };
+		const uint32_t interior = indexOf(countX / 2, countY / 2, countZ / 2);
+		const uint32_t surface = indexOf(countX / 2, countY - 1, countZ / 2);
+		const uint32_t isolated = static_cast<uint32_t>(particles.size());
+		Particle splash = {};
+		splash.Position = origin + Vector3D(0.0f, countY * spacing + 5.0f * param.H, 0.0f);
+		splash.Density = param.RestDensity;
+		particles.push_back(splash);
+
+		AnisotropyEstimator estimator(2);
+		const AnisotropyParam& anisotropyParam = estimator.GetParam();
+		std::vector<EllipsoidKernel> kernels;
+		estimator.Compute(particles, param, kernels);
+		if (!Expect(kernels.size() == particles.size(), "%zu kernels for %zu particles", kernels.size(), particles.size()))
+		{
+			return;
+		}
+
+		auto minAxis = [](const EllipsoidKernel& kernel)
+		{
+			return static_cast<int>(std::min_element(kernel.Radii, kernel.Radii + 3) - kernel.Radii);
+		};
+		auto stretch = [](const EllipsoidKernel& kernel)
+		{
+			return *std::max_element(kernel.Radii, kernel.Radii + 3) / *std::min_element(kernel.Radii, kernel.Radii + 3);
+		};
+		uint32_t badAxesCount = 0;
+		uint32_t badRadiiCount = 0;
+		for (uint32_t i = 0; i < isolated; ++i)
+		{
+			const EllipsoidKernel& kernel = kernels[i];
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int b = 0; b < 3; ++b)
+				{
+					badAxesCount += std::abs(kernel.Axes[a].dot(kernel.Axes[b]) - (a == b ? 1.0f : 0.0f)) > 1.0e-3f ? 1 : 0;
+				}
+			}
+			const float volume = kernel.Radii[0] * kernel.Radii[1] * kernel.Radii[2];
+			badRadiiCount += (stretch(kernel) > anisotropyParam.MaxStretch * 1.001f || std::abs(volume - 1.0f) > 1.0e-3f) ? 1 : 0;
+		}
+		Expect(badAxesCount == 0, "%u axis pairs are not orthonormal", badAxesCount);
+		Expect(badRadiiCount == 0, "%u kernels stretch beyond %g or do not keep unit volume", badRadiiCount, anisotropyParam.MaxStretch);
+
+		Expect(stretch(kernels[interior]) < 1.2f, "interior kernel stretched %g", stretch(kernels[interior]));
+		Expect((kernels[interior].Center - particles[interior].Position).length() < 1.0e-3f * param.H, "interior kernel center moved by %g H",
+			(kernels[interior].Center - particles[interior].Position).length() / param.H);
+		const EllipsoidKernel& top = kernels[surface];
+		Expect(stretch(top) > 1.5f, "surface kernel stretched only %g", stretch(top));
+		Expect(std::abs(top.Axes[minAxis(top)].y) > 0.95f, "surface kernel is thinnest along (%g, %g, %g), not the normal",
+			top.Axes[minAxis(top)].x, top.Axes[minAxis(top)].y, top.Axes[minAxis(top)].z);
+		Expect(top.Center.y < particles[surface].Position.y, "surface kernel center not pulled into the fluid");
+		Expect(kernels[isolated].Radii[0] == anisotropyParam.IsolatedScale && kernels[isolated].Radii[1] == anisotropyParam.IsolatedScale &&
+			kernels[isolated].Radii[2] == anisotropyParam.IsolatedScale, "isolated kernel radii %g %g %g, expected %g",
+			kernels[isolated].Radii[0], kernels[isolated].Radii[1], kernels[isolated].Radii[2], anisotropyParam.IsolatedScale);
+		Expect(estimator.GetStats().IsolatedCount >= 1, "no particle counted as isolated");
+
+		for (SIMDLevel level : { SIMDLevel::Scalar, SIMDLevel::AVX2 })
+		{
+			AnisotropyParam levelParam = anisotropyParam;
+			levelParam.SIMD = level;
+			estimator.SetParam(levelParam);
+			std::vector<EllipsoidKernel> levelKernels;
+			estimator.Compute(particles, param, levelKernels);
+			float maxDifference = 0.0f;
+			for (size_t i = 0; i < kernels.size(); ++i)
+			{
+				float expected[3] = { kernels[i].Radii[0], kernels[i].Radii[1], kernels[i].Radii[2] };
+				float actual[3] = { levelKernels[i].Radii[0], levelKernels[i].Radii[1], levelKernels[i].Radii[2] };
+				std::sort(expected, expected + 3);
+				std::sort(actual, actual + 3);
+				for (int k = 0; k < 3; ++k)
+				{
+					maxDifference = std::max(maxDifference, std::abs(expected[k] - actual[k]));
+				}
+			}
+			Expect(maxDifference < 1.0e-3f, "%s: kernel radii differ from the default decomposition by %g", ToString(level), maxDifference);
+		}
+	}
+
+	struct Test
+	{
+		const char* Name;
+		void (*Run)();
+	};
+
+	const Test Tests[] =
+	{
+		{ "grid", TestGridModes },
+		{ "simd", TestSoAKernels },
+		{ "compatibility", TestGridCompatibility },
+		{ "symmetric", TestSymmetricForce },
+		{ "timestep", TestAdaptiveTimestep },
+		{ "decomposition", TestDecomposition },
+		{ "determinism", TestDeterminism },
+		{ "checkpoint", TestCheckpoint },
+		{ "trajectory", TestTrajectory },
+		{ "exporter", TestExporter },
+		{ "bvh", TestBVH },
+		{ "sdf", TestSDF },
+		{ "boundary", TestBoundaryParticles },
+		{ "surface", TestSurfaceExtraction },
+		{ "anisotropy", TestAnisotropy },
+	};
+}
+using namespace TestInternal;
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		std::fprintf(stderr, "usage: FluidTests <test>\ntests:");
+		for (const Test& test : Tests)
+		{
+			std::fprintf(stderr, " %s", test.Name);
+		}
+		std::fprintf(stderr, "\n");
+		return 1;
+	}
+	for (const Test& test : Tests)
+	{
+		if (std::string(argv[1]) == test.Name)
+		{
+			test.Run();
+			if (g_FailureCount != 0)
+			{
+				std::printf("%s: %u check(s) failed\n", test.Name, g_FailureCount);
+				return 1;
+			}
+			std::printf("%s: passed\n", test.Name);
+			return 0;
+		}
+	}
+	std::fprintf(stderr, "unknown test %s\n", argv[1]);
+	return 1;
+}
@@ -3,14 +3,14 @@
 
 
 /// <summary>
-/// Gg[|CgłD
+/// エントリーポイントです．
 /// </summary>
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR pCmdLine, int nCmdShow)
 {
 #if defined(DEBUG) || defined(_DEBUG)
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
-	// EBhẼTCYw
+	// ウィンドウのサイズを指定
 	Engine engine(960, 540);
 	engine.Run();
 